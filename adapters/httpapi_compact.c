@@ -19,6 +19,10 @@
 #include "azure_c_shared_utility/shared_util_options.h"
 #include "azure_c_shared_utility/http_proxy_io.h"
 #include "azure_c_shared_utility/safe_math.h"
+#ifdef USE_SOCKETIO_REACTOR
+#include "azure_c_shared_utility/socketio.h"
+#include "azure_c_shared_utility/tickcounter.h"
+#endif
 
 #ifdef _MSC_VER
 #define snprintf _snprintf
@@ -32,15 +36,21 @@
 #define MAX_HOSTNAME     64
 #define TEMP_BUFFER_SIZE 1024
 
+/*The request line, the headers and the content of a request are gathered in a buffer of the connection and written
+  to the transport at once, anything that does not fit in it is written as it comes.*/
+#ifndef HTTPAPI_COMPACT_REQUEST_BUFFER_SIZE
+#define HTTPAPI_COMPACT_REQUEST_BUFFER_SIZE 1024
+#endif
+
 /*Codes_SRS_HTTPAPI_COMPACT_21_077: [ The HTTPAPI_ExecuteRequest shall wait, at least, 10 seconds for the SSL open process. ]*/
-#define MAX_OPEN_RETRY   100
+#define OPEN_TIMEOUT_IN_MS   10000
 /*Codes_SRS_HTTPAPI_COMPACT_21_084: [ The HTTPAPI_CloseConnection shall wait, at least, 10 seconds for the SSL close process. ]*/
-#define MAX_CLOSE_RETRY   100
+#define CLOSE_TIMEOUT_IN_MS   10000
 /*Codes_SRS_HTTPAPI_COMPACT_21_079: [ The HTTPAPI_ExecuteRequest shall wait, at least, 20 seconds to send a buffer using the SSL connection. ]*/
-#define MAX_SEND_RETRY   200
+#define SEND_TIMEOUT_IN_MS   20000
 /*Codes_SRS_HTTPAPI_COMPACT_21_081: [ The HTTPAPI_ExecuteRequest shall try to read the message with the response up to 20 seconds. ]*/
-#define MAX_RECEIVE_RETRY   200
-/*Codes_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
+#define RECEIVE_TIMEOUT_IN_MS   20000
+/*the longest a retry waits for the transport*/
 #define RETRY_INTERVAL_IN_MS  100
 
 MU_DEFINE_ENUM_STRINGS(HTTPAPI_RESULT, HTTPAPI_RESULT_VALUES)
@@ -58,8 +68,26 @@ typedef struct HTTP_HANDLE_DATA_TAG
     unsigned int    is_connected : 1;
     unsigned int    send_completed : 1;
     bool            tls_renegotiation;
+    size_t          request_buffer_length;
+    unsigned char   request_buffer[HTTPAPI_COMPACT_REQUEST_BUFFER_SIZE];
+#ifdef USE_SOCKETIO_REACTOR
+    SOCKETIO_REACTOR_HANDLE reactor;
+    TICK_COUNTER_HANDLE tick_counter;
+#endif
 } HTTP_HANDLE_DATA;
 
+/*the time given to one step of the request (open, send, receive or close), counted from the start of the step*/
+typedef struct IO_DEADLINE_TAG
+{
+    unsigned int timeout_ms;
+    unsigned int elapsed_ms;
+#ifdef USE_SOCKETIO_REACTOR
+    /*on the reactor elapsed_ms is read from the tick counter, otherwise it adds up the sleeps*/
+    bool is_on_reactor;
+    tickcounter_ms_t start_ms;
+#endif
+} IO_DEADLINE;
+
 /*the following function does the same as sscanf(pos2, "%d", &sec)*/
 /*this function only exists because some of platforms do not have sscanf. */
 static int ParseStringToDecimal(const char *src, int* dst)
@@ -178,6 +206,100 @@ static int  ParseHttpResponse(const char* src, int* dst)
     return result;
 }
 
+#ifdef USE_SOCKETIO_REACTOR
+static void destroy_reactor(HTTP_HANDLE_DATA* http_instance)
+{
+    if (http_instance->reactor != NULL)
+    {
+        socketio_reactor_destroy(http_instance->reactor);
+        http_instance->reactor = NULL;
+        tickcounter_destroy(http_instance->tick_counter);
+        http_instance->tick_counter = NULL;
+    }
+}
+
+/*the reactor reaches the socket through the tlsio, which passes the options it does not know to its underlying IO*/
+static void attach_reactor(HTTP_HANDLE_DATA* http_instance)
+{
+    if ((http_instance->reactor != NULL) &&
+        (xio_setoption(http_instance->xio_handle, OPTION_SOCKETIO_REACTOR, http_instance->reactor) != 0))
+    {
+        LogInfo("The transport does not take a socketio reactor, the retries will sleep");
+        destroy_reactor(http_instance);
+    }
+}
+
+static void create_reactor(HTTP_HANDLE_DATA* http_instance)
+{
+    http_instance->tick_counter = NULL;
+    if ((http_instance->reactor = socketio_reactor_create()) == NULL)
+    {
+        LogInfo("Could not create a socketio reactor, the retries will sleep");
+    }
+    else if ((http_instance->tick_counter = tickcounter_create()) == NULL)
+    {
+        LogError("Could not create the tick counter for the socketio reactor, the retries will sleep");
+        socketio_reactor_destroy(http_instance->reactor);
+        http_instance->reactor = NULL;
+    }
+    else
+    {
+        attach_reactor(http_instance);
+    }
+}
+#endif
+
+/*Codes_SRS_HTTPAPI_COMPACT_04_003: [ The open, send, receive and close timeouts shall be counted from the start of the step, waits that end early on a ready transport shall not extend them. ]*/
+static void start_io_deadline(HTTP_HANDLE_DATA* http_instance, IO_DEADLINE* deadline, unsigned int timeout_ms)
+{
+    deadline->timeout_ms = timeout_ms;
+    deadline->elapsed_ms = 0;
+#ifdef USE_SOCKETIO_REACTOR
+    deadline->is_on_reactor = (http_instance->reactor != NULL) &&
+        (tickcounter_get_current_ms(http_instance->tick_counter, &deadline->start_ms) == 0);
+#else
+    (void)http_instance;
+#endif
+}
+
+static bool is_io_deadline_expired(const IO_DEADLINE* deadline)
+{
+    return deadline->elapsed_ms >= deadline->timeout_ms;
+}
+
+/*waits for the transport until it is ready, for up to RETRY_INTERVAL_IN_MS, and updates the time gone by for the deadline*/
+static void wait_for_io(HTTP_HANDLE_DATA* http_instance, IO_DEADLINE* deadline)
+{
+#ifdef USE_SOCKETIO_REACTOR
+    if (deadline->is_on_reactor)
+    {
+        unsigned int remaining_ms = is_io_deadline_expired(deadline) ? 0 : deadline->timeout_ms - deadline->elapsed_ms;
+        tickcounter_ms_t now_ms;
+
+        if ((socketio_reactor_dowork(http_instance->reactor, (int)((remaining_ms < RETRY_INTERVAL_IN_MS) ? remaining_ms : RETRY_INTERVAL_IN_MS)) != 0) ||
+            (tickcounter_get_current_ms(http_instance->tick_counter, &now_ms) != 0))
+        {
+            LogError("Waiting on the socketio reactor failed, the retries will sleep");
+            deadline->is_on_reactor = false;
+        }
+        else
+        {
+            deadline->elapsed_ms = (unsigned int)(now_ms - deadline->start_ms);
+        }
+    }
+
+    if (!deadline->is_on_reactor)
+    {
+        ThreadAPI_Sleep(RETRY_INTERVAL_IN_MS);
+        deadline->elapsed_ms += RETRY_INTERVAL_IN_MS;
+    }
+#else
+    (void)http_instance;
+    ThreadAPI_Sleep(RETRY_INTERVAL_IN_MS);
+    deadline->elapsed_ms += RETRY_INTERVAL_IN_MS;
+#endif
+}
+
 HTTPAPI_RESULT HTTPAPI_Init(void)
 {
 /*Codes_SRS_HTTPAPI_COMPACT_21_004: [ The HTTPAPI_Init shall allocate all memory to control the http protocol. ]*/
@@ -257,6 +379,10 @@ HTTP_HANDLE HTTPAPI_CreateConnection(const char* hostName)
                 http_instance->x509ClientCertificate = NULL;
                 http_instance->x509ClientPrivateKey = NULL;
                 http_instance->tls_renegotiation = false;
+                http_instance->request_buffer_length = 0;
+#ifdef USE_SOCKETIO_REACTOR
+                create_reactor(http_instance);
+#endif
             }
         }
     }
@@ -296,11 +422,12 @@ void HTTPAPI_CloseConnection(HTTP_HANDLE handle)
             else
             {
                 /*Codes_SRS_HTTPAPI_COMPACT_21_084: [ The HTTPAPI_CloseConnection shall wait, at least, 10 seconds for the SSL close process. ]*/
-                int countRetry = MAX_CLOSE_RETRY;
+                IO_DEADLINE deadline;
+                start_io_deadline(http_instance, &deadline, CLOSE_TIMEOUT_IN_MS);
                 while (http_instance->is_connected == 1)
                 {
                     xio_dowork(http_instance->xio_handle);
-                    if ((countRetry--) < 0)
+                    if (is_io_deadline_expired(&deadline))
                     {
                         /*Codes_SRS_HTTPAPI_COMPACT_21_085: [ If the HTTPAPI_CloseConnection retries 10 seconds to close the connection without success, it shall destroy the connection anyway. ]*/
                         LogError("Close timeout. The SSL didn't close the connection");
@@ -314,8 +441,8 @@ void HTTPAPI_CloseConnection(HTTP_HANDLE handle)
                     else if (http_instance->is_connected == 1)
                     {
                         LogInfo("Waiting for TLS close connection");
-                        /*Codes_SRS_HTTPAPI_COMPACT_21_086: [ The HTTPAPI_CloseConnection shall wait, at least, 100 milliseconds between retries. ]*/
-                        ThreadAPI_Sleep(RETRY_INTERVAL_IN_MS);
+                        /*Codes_SRS_HTTPAPI_COMPACT_04_002: [ Between retries, the HTTPAPI_CloseConnection shall wait for the transport for up to 100 milliseconds: on the socketio reactor of the connection until its socket is ready, or by sleeping when the transport does not take a socketio reactor. ]*/
+                        wait_for_io(http_instance, &deadline);
                     }
                 }
             }
@@ -323,6 +450,10 @@ void HTTPAPI_CloseConnection(HTTP_HANDLE handle)
             xio_destroy(http_instance->xio_handle);
         }
 
+#ifdef USE_SOCKETIO_REACTOR
+        destroy_reactor(http_instance);
+#endif
+
 #ifndef DO_NOT_COPY_TRUSTED_CERTS_STRING
         /*Codes_SRS_HTTPAPI_COMPACT_21_018: [ If there is a certificate associated to this connection, the HTTPAPI_CloseConnection shall free all allocated memory for the certificate. ]*/
         if (http_instance->certificate)
@@ -487,6 +618,8 @@ static int conn_receive(HTTP_HANDLE_DATA* http_instance, char* buffer, int count
     }
     else
     {
+        IO_DEADLINE deadline;
+        start_io_deadline(http_instance, &deadline, RECEIVE_TIMEOUT_IN_MS);
         result = 0;
         while (result < count)
         {
@@ -518,8 +651,16 @@ static int conn_receive(HTTP_HANDLE_DATA* http_instance, char* buffer, int count
                 break;
             }
 
-            /*Codes_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
-            ThreadAPI_Sleep(RETRY_INTERVAL_IN_MS);
+            if (is_io_deadline_expired(&deadline))
+            {
+                /*Codes_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
+                LogError("Receive timeout. The HTTP request is incomplete");
+                result = -1;
+                break;
+            }
+
+            /*Codes_SRS_HTTPAPI_COMPACT_04_001: [ Between retries, the HTTPAPI_ExecuteRequest shall wait for the transport for up to 100 milliseconds: on the socketio reactor of the connection until its socket is ready, or by sleeping when the transport does not take a socketio reactor. ]*/
+            wait_for_io(http_instance, &deadline);
         }
     }
 
@@ -552,8 +693,9 @@ static int readLine(HTTP_HANDLE_DATA* http_instance, char* buf, const size_t max
     {
         char* destByte = buf;
         /*Codes_SRS_HTTPAPI_COMPACT_21_081: [ The HTTPAPI_ExecuteRequest shall try to read the message with the response up to 20 seconds. ]*/
-        int countRetry = MAX_RECEIVE_RETRY;
+        IO_DEADLINE deadline;
         bool endOfSearch = false;
+        start_io_deadline(http_instance, &deadline, RECEIVE_TIMEOUT_IN_MS);
         resultLineSize = -1;
         while (!endOfSearch)
         {
@@ -611,10 +753,10 @@ static int readLine(HTTP_HANDLE_DATA* http_instance, char* buf, const size_t max
 
             if (!endOfSearch)
             {
-                if ((countRetry--) > 0)
+                if (!is_io_deadline_expired(&deadline))
                 {
-                    /*Codes_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
-                    ThreadAPI_Sleep(RETRY_INTERVAL_IN_MS);
+                    /*Codes_SRS_HTTPAPI_COMPACT_04_001: [ Between retries, the HTTPAPI_ExecuteRequest shall wait for the transport for up to 100 milliseconds: on the socketio reactor of the connection until its socket is ready, or by sleeping when the transport does not take a socketio reactor. ]*/
+                    wait_for_io(http_instance, &deadline);
                 }
                 else
                 {
@@ -676,7 +818,8 @@ static int skipN(HTTP_HANDLE_DATA* http_instance, size_t n)
     else
     {
         /*Codes_SRS_HTTPAPI_COMPACT_21_081: [ The HTTPAPI_ExecuteRequest shall try to read the message with the response up to 20 seconds. ]*/
-        int countRetry = MAX_RECEIVE_RETRY;
+        IO_DEADLINE deadline;
+        start_io_deadline(http_instance, &deadline, RECEIVE_TIMEOUT_IN_MS);
         result = (int)n;
         while (n > 0)
         {
@@ -705,10 +848,10 @@ static int skipN(HTTP_HANDLE_DATA* http_instance, size_t n)
 
                 if (n > 0)
                 {
-                    if ((countRetry--) > 0)
+                    if (!is_io_deadline_expired(&deadline))
                     {
-                        /*Codes_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
-                        ThreadAPI_Sleep(RETRY_INTERVAL_IN_MS);
+                        /*Codes_SRS_HTTPAPI_COMPACT_04_001: [ Between retries, the HTTPAPI_ExecuteRequest shall wait for the transport for up to 100 milliseconds: on the socketio reactor of the connection until its socket is ready, or by sleeping when the transport does not take a socketio reactor. ]*/
+                        wait_for_io(http_instance, &deadline);
                     }
                     else
                     {
@@ -780,17 +923,17 @@ static HTTPAPI_RESULT OpenXIOConnection(HTTP_HANDLE_DATA* http_instance)
             }
             else
             {
-                int countRetry;
+                IO_DEADLINE deadline;
                 /*Codes_SRS_HTTPAPI_COMPACT_21_033: [ If the whole process succeed, the HTTPAPI_ExecuteRequest shall retur HTTPAPI_OK. ]*/
                 result = HTTPAPI_OK;
                 /*Codes_SRS_HTTPAPI_COMPACT_21_077: [ The HTTPAPI_ExecuteRequest shall wait, at least, 10 seconds for the SSL open process. ]*/
-                countRetry = MAX_OPEN_RETRY;
+                start_io_deadline(http_instance, &deadline, OPEN_TIMEOUT_IN_MS);
                 while ((http_instance->is_connected == 0) &&
                     (http_instance->is_io_error == 0))
                 {
                     xio_dowork(http_instance->xio_handle);
                     LogInfo("Waiting for TLS connection");
-                    if ((countRetry--) < 0)
+                    if (is_io_deadline_expired(&deadline))
                     {
                         /*Codes_SRS_HTTPAPI_COMPACT_21_078: [ If the HTTPAPI_ExecuteRequest cannot open the connection in 10 seconds, it shall fail and return HTTPAPI_OPEN_REQUEST_FAILED. ]*/
                         LogError("Open timeout. The HTTP request is incomplete");
@@ -799,8 +942,8 @@ static HTTPAPI_RESULT OpenXIOConnection(HTTP_HANDLE_DATA* http_instance)
                     }
                     else
                     {
-                        /*Codes_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
-                        ThreadAPI_Sleep(RETRY_INTERVAL_IN_MS);
+                        /*Codes_SRS_HTTPAPI_COMPACT_04_001: [ Between retries, the HTTPAPI_ExecuteRequest shall wait for the transport for up to 100 milliseconds: on the socketio reactor of the connection until its socket is ready, or by sleeping when the transport does not take a socketio reactor. ]*/
+                        wait_for_io(http_instance, &deadline);
                     }
                 }
             }
@@ -830,7 +973,8 @@ static HTTPAPI_RESULT conn_send_all(HTTP_HANDLE_DATA* http_instance, const unsig
     else
     {
         /*Codes_SRS_HTTPAPI_COMPACT_21_079: [ The HTTPAPI_ExecuteRequest shall wait, at least, 20 seconds to send a buffer using the SSL connection. ]*/
-        int countRetry = MAX_SEND_RETRY;
+        IO_DEADLINE deadline;
+        start_io_deadline(http_instance, &deadline, SEND_TIMEOUT_IN_MS);
         /*Codes_SRS_HTTPAPI_COMPACT_21_033: [ If the whole process succeed, the HTTPAPI_ExecuteRequest shall retur HTTPAPI_OK. ]*/
         result = HTTPAPI_OK;
         while ((http_instance->send_completed == 0) && (result == HTTPAPI_OK))
@@ -841,7 +985,7 @@ static HTTPAPI_RESULT conn_send_all(HTTP_HANDLE_DATA* http_instance, const unsig
                 /*Codes_SRS_HTTPAPI_COMPACT_21_028: [ If the HTTPAPI_ExecuteRequest cannot send the request header, it shall return HTTPAPI_HTTP_HEADERS_FAILED. ]*/
                 result = HTTPAPI_SEND_REQUEST_FAILED;
             }
-            else if ((countRetry--) <= 0)
+            else if (is_io_deadline_expired(&deadline))
             {
                 /*Codes_SRS_HTTPAPI_COMPACT_21_080: [ If the HTTPAPI_ExecuteRequest retries to send the message for 20 seconds without success, it shall fail and return HTTPAPI_SEND_REQUEST_FAILED. ]*/
                 LogError("Send timeout. The HTTP request is incomplete");
@@ -850,8 +994,8 @@ static HTTPAPI_RESULT conn_send_all(HTTP_HANDLE_DATA* http_instance, const unsig
             }
             else
             {
-                /*Codes_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
-                ThreadAPI_Sleep(RETRY_INTERVAL_IN_MS);
+                /*Codes_SRS_HTTPAPI_COMPACT_04_001: [ Between retries, the HTTPAPI_ExecuteRequest shall wait for the transport for up to 100 milliseconds: on the socketio reactor of the connection until its socket is ready, or by sleeping when the transport does not take a socketio reactor. ]*/
+                wait_for_io(http_instance, &deadline);
             }
         }
     }
@@ -866,6 +1010,52 @@ const char* get_request_type(HTTPAPI_REQUEST_TYPE requestType)
     return (const char*)httpapiRequestString[requestType - HTTPAPI_REQUEST_GET];
 }
 
+static HTTPAPI_RESULT flush_request_buffer(HTTP_HANDLE_DATA* http_instance)
+{
+    HTTPAPI_RESULT result;
+
+    if (http_instance->request_buffer_length == 0)
+    {
+        result = HTTPAPI_OK;
+    }
+    else
+    {
+        result = conn_send_all(http_instance, http_instance->request_buffer, http_instance->request_buffer_length);
+        http_instance->request_buffer_length = 0;
+    }
+
+    return result;
+}
+
+/*appends bytes to the request buffer, sending what is already there first if they do not fit, and sending them on
+  their own if they are larger than the whole buffer*/
+static HTTPAPI_RESULT write_request(HTTP_HANDLE_DATA* http_instance, const unsigned char* bytes, size_t length)
+{
+    HTTPAPI_RESULT result;
+
+    if (length > (HTTPAPI_COMPACT_REQUEST_BUFFER_SIZE - http_instance->request_buffer_length))
+    {
+        if (((result = flush_request_buffer(http_instance)) == HTTPAPI_OK) &&
+            (length > HTTPAPI_COMPACT_REQUEST_BUFFER_SIZE))
+        {
+            result = conn_send_all(http_instance, bytes, length);
+            length = 0;
+        }
+    }
+    else
+    {
+        result = HTTPAPI_OK;
+    }
+
+    if ((result == HTTPAPI_OK) && (length > 0))
+    {
+        (void)memcpy(http_instance->request_buffer + http_instance->request_buffer_length, bytes, length);
+        http_instance->request_buffer_length += length;
+    }
+
+    return result;
+}
+
 /*Codes_SRS_HTTPAPI_COMPACT_21_026: [ If the open process succeed, the HTTPAPI_ExecuteRequest shall send the request message to the host. ]*/
 static HTTPAPI_RESULT SendHeadsToXIO(HTTP_HANDLE_DATA* http_instance, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath, HTTP_HEADERS_HANDLE httpHeadersHandle, size_t headersCount)
 {
@@ -873,6 +1063,9 @@ static HTTPAPI_RESULT SendHeadsToXIO(HTTP_HANDLE_DATA* http_instance, HTTPAPI_RE
     char    buf[TEMP_BUFFER_SIZE];
     int     ret;
 
+    /*anything left over by a request that failed half way is never sent*/
+    http_instance->request_buffer_length = 0;
+
     //Send request
     /*Codes_SRS_HTTPAPI_COMPACT_21_038: [ The HTTPAPI_ExecuteRequest shall execute the resquest for the path in relativePath parameter. ]*/
     /*Codes_SRS_HTTPAPI_COMPACT_21_036: [ The request type shall be provided in the parameter requestType. ]*/
@@ -883,33 +1076,29 @@ static HTTPAPI_RESULT SendHeadsToXIO(HTTP_HANDLE_DATA* http_instance, HTTPAPI_RE
         result = HTTPAPI_STRING_PROCESSING_ERROR;
     }
         /*Codes_SRS_HTTPAPI_COMPACT_21_028: [ If the HTTPAPI_ExecuteRequest cannot send the request header, it shall return HTTPAPI_HTTP_HEADERS_FAILED. ]*/
-    else if ((result = conn_send_all(http_instance, (const unsigned char*)buf, strlen(buf))) == HTTPAPI_OK)
+    else if ((result = write_request(http_instance, (const unsigned char*)buf, (size_t)ret)) == HTTPAPI_OK)
     {
         size_t i;
         //Send default headers
         /*Codes_SRS_HTTPAPI_COMPACT_21_033: [ If the whole process succeed, the HTTPAPI_ExecuteRequest shall retur HTTPAPI_OK. ]*/
         for (i = 0; ((i < headersCount) && (result == HTTPAPI_OK)); i++)
         {
-            char* header;
-            if (HTTPHeaders_GetHeader(httpHeadersHandle, i, &header) != HTTP_HEADERS_OK)
+            HTTP_HEADER_VIEW header;
+            if (HTTPHeaders_GetHeaderView(httpHeadersHandle, i, &header) != HTTP_HEADERS_OK)
             {
                 /*Codes_SRS_HTTPAPI_COMPACT_21_027: [ If the HTTPAPI_ExecuteRequest cannot create a buffer to send the request, it shall not send any request and return HTTPAPI_STRING_PROCESSING_ERROR. ]*/
                 result = HTTPAPI_STRING_PROCESSING_ERROR;
             }
-            else
+            else if ((result = write_request(http_instance, (const unsigned char*)header.line, header.line_length)) == HTTPAPI_OK)
             {
-                if ((result = conn_send_all(http_instance, (const unsigned char*)header, strlen(header))) == HTTPAPI_OK)
-                {
-                    result = conn_send_all(http_instance, (const unsigned char*)"\r\n", (size_t)2);
-                }
-                free(header);
+                result = write_request(http_instance, (const unsigned char*)"\r\n", (size_t)2);
             }
         }
 
         //Close headers
         if (result == HTTPAPI_OK)
         {
-            result = conn_send_all(http_instance, (const unsigned char*)"\r\n", (size_t)2);
+            result = write_request(http_instance, (const unsigned char*)"\r\n", (size_t)2);
         }
     }
     return result;
@@ -925,13 +1114,25 @@ static HTTPAPI_RESULT SendContentToXIO(HTTP_HANDLE_DATA* http_instance, const un
     if (content && contentLength > 0)
     {
         /*Codes_SRS_HTTPAPI_COMPACT_21_044: [ If the content is not NULL, the number of bytes in the content shall be provided in contentLength parameter. ]*/
-        result = conn_send_all(http_instance, content, contentLength);
+        if (contentLength <= (HTTPAPI_COMPACT_REQUEST_BUFFER_SIZE - http_instance->request_buffer_length))
+        {
+            /*a small content goes in the same write as the heads*/
+            if ((result = write_request(http_instance, content, contentLength)) == HTTPAPI_OK)
+            {
+                result = flush_request_buffer(http_instance);
+            }
+        }
+        else if ((result = flush_request_buffer(http_instance)) == HTTPAPI_OK)
+        {
+            /*a larger one is not copied*/
+            result = conn_send_all(http_instance, content, contentLength);
+        }
     }
     else
     {
         /*Codes_SRS_HTTPAPI_COMPACT_21_043: [ If the content is NULL, the HTTPAPI_ExecuteRequest shall send the request without content. ]*/
         /*Codes_SRS_HTTPAPI_COMPACT_21_033: [ If the whole process succeed, the HTTPAPI_ExecuteRequest shall retur HTTPAPI_OK. ]*/
-        result = HTTPAPI_OK;
+        result = flush_request_buffer(http_instance);
     }
     return result;
 }
@@ -1474,6 +1675,9 @@ HTTPAPI_RESULT HTTPAPI_SetOption(HTTP_HANDLE handle, const char* optionName, con
                     }
                     else
                     {
+#ifdef USE_SOCKETIO_REACTOR
+                        attach_reactor(http_instance);
+#endif
                         result = HTTPAPI_OK;
                     }
                 }
@@ -6,12 +6,16 @@
 #include <string.h>
 #include <stddef.h>
 #include <ctype.h>
+#include <stdbool.h>
 
 #include "macro_utils/macro_utils.h"
 #include "azure_c_shared_utility/strings.h"
 #include "azure_c_shared_utility/httpapi.h"
 #include "azure_c_shared_utility/httpheaders.h"
+#include "azure_c_shared_utility/httpapi_async.h"
 #include "azure_c_shared_utility/crt_abstractions.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/threadapi.h"
 #include "curl/curl.h"
 #include "azure_c_shared_utility/xlogging.h"
 #ifdef USE_OPENSSL
@@ -33,6 +37,10 @@
 #include "azure_c_shared_utility/safe_math.h"
 
 #define TEMP_BUFFER_SIZE 1024
+/*how long the httpapi_async thread waits for its transfers when curl cannot be woken up by new requests*/
+#define HTTPAPI_ASYNC_POLL_TIMEOUT_MS 10
+/*upper bound of a wait for the transfers, curl usually asks for less*/
+#define HTTPAPI_ASYNC_WAIT_TIMEOUT_MS 1000
 
 MU_DEFINE_ENUM_STRINGS(HTTPAPI_RESULT, HTTPAPI_RESULT_VALUES);
 
@@ -70,6 +78,10 @@ typedef struct HTTP_RESPONSE_CONTENT_BUFFER_TAG
 } HTTP_RESPONSE_CONTENT_BUFFER;
 
 static size_t nUsersOfHTTPAPI = 0; /*used for reference counting (a weak one)*/
+/*guards the httpapi_async instances destroyed from their own thread, see httpapi_async_destroy*/
+static LOCK_HANDLE finishedHttpapiAsyncsLock = NULL;
+
+static void releaseFinishedHttpapiAsyncs(void);
 
 HTTPAPI_RESULT HTTPAPI_Init(void)
 {
@@ -81,6 +93,12 @@ HTTPAPI_RESULT HTTPAPI_Init(void)
             result = HTTPAPI_INIT_FAILED;
             LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
         }
+        else if ((finishedHttpapiAsyncsLock = Lock_Init()) == NULL)
+        {
+            curl_global_cleanup();
+            result = HTTPAPI_INIT_FAILED;
+            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+        }
         else
         {
             nUsersOfHTTPAPI++;
@@ -103,6 +121,9 @@ void HTTPAPI_Deinit(void)
         nUsersOfHTTPAPI--;
         if (nUsersOfHTTPAPI == 0)
         {
+            releaseFinishedHttpapiAsyncs();
+            (void)Lock_Deinit(finishedHttpapiAsyncsLock);
+            finishedHttpapiAsyncsLock = NULL;
             curl_global_cleanup();
         }
     }
@@ -496,6 +517,240 @@ static CURLcode ssl_ctx_callback(CURL *curl, void *ssl_ctx, void *userptr)
     return result;
 }
 
+/*the options of the connection that apply to each of its requests*/
+static HTTPAPI_RESULT setTransferOptions(CURL* curl, const HTTP_HANDLE_DATA* httpHandleData)
+{
+    HTTPAPI_RESULT result;
+
+    if (curl_easy_setopt(curl, CURLOPT_VERBOSE, httpHandleData->verbose) != CURLE_OK)
+    {
+        result = HTTPAPI_SET_OPTION_FAILED;
+        LogError("failed to set CURLOPT_VERBOSE (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+    }
+    else if (curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, httpHandleData->timeout) != CURLE_OK)
+    {
+        result = HTTPAPI_SET_OPTION_FAILED;
+        LogError("failed to set CURLOPT_TIMEOUT_MS (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+    }
+    else if (curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, httpHandleData->lowSpeedLimit) != CURLE_OK)
+    {
+        result = HTTPAPI_SET_OPTION_FAILED;
+        LogError("failed to set CURLOPT_LOW_SPEED_LIMIT (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+    }
+    else if (curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, httpHandleData->lowSpeedTime) != CURLE_OK)
+    {
+        result = HTTPAPI_SET_OPTION_FAILED;
+        LogError("failed to set CURLOPT_LOW_SPEED_TIME (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+    }
+    else if (curl_easy_setopt(curl, CURLOPT_FRESH_CONNECT, httpHandleData->freshConnect) != CURLE_OK)
+    {
+        result = HTTPAPI_SET_OPTION_FAILED;
+        LogError("failed to set CURLOPT_FRESH_CONNECT (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+    }
+    else if (curl_easy_setopt(curl, CURLOPT_FORBID_REUSE, httpHandleData->forbidReuse) != CURLE_OK)
+    {
+        result = HTTPAPI_SET_OPTION_FAILED;
+        LogError("failed to set CURLOPT_FORBID_REUSE (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+    }
+    else if (curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1) != CURLE_OK)
+    {
+        result = HTTPAPI_SET_OPTION_FAILED;
+        LogError("failed to set CURLOPT_HTTP_VERSION (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+    }
+    else
+    {
+        result = HTTPAPI_OK;
+    }
+
+    return result;
+}
+
+static HTTPAPI_RESULT setRequestType(CURL* curl, HTTPAPI_REQUEST_TYPE requestType)
+{
+    HTTPAPI_RESULT result = HTTPAPI_OK;
+
+    switch (requestType)
+    {
+    default:
+        result = HTTPAPI_INVALID_ARG;
+        LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+        break;
+
+    case HTTPAPI_REQUEST_GET:
+        if (curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L) != CURLE_OK)
+        {
+            result = HTTPAPI_SET_OPTION_FAILED;
+            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+        }
+        else
+        {
+            if (curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, NULL) != CURLE_OK)
+            {
+                result = HTTPAPI_SET_OPTION_FAILED;
+                LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+            }
+        }
+
+        break;
+
+    case HTTPAPI_REQUEST_HEAD:
+        if (curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L) != CURLE_OK)
+        {
+            result = HTTPAPI_SET_OPTION_FAILED;
+            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+        }
+        else if (curl_easy_setopt(curl, CURLOPT_NOBODY, 1L) != CURLE_OK)
+        {
+            result = HTTPAPI_SET_OPTION_FAILED;
+            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+        }
+        else if (curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, NULL) != CURLE_OK)
+        {
+            result = HTTPAPI_SET_OPTION_FAILED;
+            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+        }
+
+        break;
+
+    case HTTPAPI_REQUEST_POST:
+        if (curl_easy_setopt(curl, CURLOPT_POST, 1L) != CURLE_OK)
+        {
+            result = HTTPAPI_SET_OPTION_FAILED;
+            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+        }
+        else
+        {
+            if (curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, NULL) != CURLE_OK)
+            {
+                result = HTTPAPI_SET_OPTION_FAILED;
+                LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+            }
+        }
+
+        break;
+
+    case HTTPAPI_REQUEST_PUT:
+        if (curl_easy_setopt(curl, CURLOPT_POST, 1L))
+        {
+            result = HTTPAPI_SET_OPTION_FAILED;
+            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+        }
+        else
+        {
+            if (curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PUT") != CURLE_OK)
+            {
+                result = HTTPAPI_SET_OPTION_FAILED;
+                LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+            }
+        }
+        break;
+
+    case HTTPAPI_REQUEST_DELETE:
+        if (curl_easy_setopt(curl, CURLOPT_POST, 1L) != CURLE_OK)
+        {
+            result = HTTPAPI_SET_OPTION_FAILED;
+            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+        }
+        else
+        {
+            if (curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE") != CURLE_OK)
+            {
+                result = HTTPAPI_SET_OPTION_FAILED;
+                LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+            }
+        }
+        break;
+
+    case HTTPAPI_REQUEST_PATCH:
+        if (curl_easy_setopt(curl, CURLOPT_POST, 1L) != CURLE_OK)
+        {
+            result = HTTPAPI_SET_OPTION_FAILED;
+            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+        }
+        else
+        {
+            if (curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PATCH") != CURLE_OK)
+            {
+                result = HTTPAPI_SET_OPTION_FAILED;
+                LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+            }
+        }
+
+        break;
+    }
+
+    return result;
+}
+
+static HTTPAPI_RESULT buildRequestHeaders(HTTP_HEADERS_HANDLE httpHeadersHandle, size_t headersCount, struct curl_slist** headers)
+{
+    HTTPAPI_RESULT result = HTTPAPI_OK;
+    size_t i;
+
+    for (i = 0; i < headersCount; i++)
+    {
+        HTTP_HEADER_VIEW header;
+        if (HTTPHeaders_GetHeaderView(httpHeadersHandle, i, &header) != HTTP_HEADERS_OK)
+        {
+            /* error */
+            result = HTTPAPI_HTTP_HEADERS_FAILED;
+            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+            break;
+        }
+        else
+        {
+            /*curl_slist_append copies the line*/
+            struct curl_slist* newHeaders = curl_slist_append(*headers, header.line);
+            if (newHeaders == NULL)
+            {
+                result = HTTPAPI_ALLOC_FAILED;
+                LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+                break;
+            }
+            else
+            {
+                *headers = newHeaders;
+            }
+        }
+    }
+
+    return result;
+}
+
+static HTTPAPI_RESULT setRequestContent(CURL* curl, HTTPAPI_REQUEST_TYPE requestType, const unsigned char* content, size_t contentLength)
+{
+    HTTPAPI_RESULT result = HTTPAPI_OK;
+
+    if ((content != NULL) &&
+        (contentLength > 0))
+    {
+        if ((curl_easy_setopt(curl, CURLOPT_POSTFIELDS, (void*)content) != CURLE_OK) ||
+            (curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)contentLength) != CURLE_OK))
+        {
+            result = HTTPAPI_SET_OPTION_FAILED;
+            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+        }
+    }
+    else
+    {
+        if (requestType != HTTPAPI_REQUEST_GET)
+        {
+            if ((curl_easy_setopt(curl, CURLOPT_POSTFIELDS, (void*)NULL) != CURLE_OK) ||
+                (curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, 0L) != CURLE_OK))
+            {
+                result = HTTPAPI_SET_OPTION_FAILED;
+                LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+            }
+        }
+        else
+        {
+            /*GET request cannot POST, so "do nothing*/
+        }
+    }
+
+    return result;
+}
+
 HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath,
                                       HTTP_HEADERS_HANDLE httpHeadersHandle, const unsigned char* content,
                                       size_t contentLength, unsigned int* statusCode,
@@ -542,12 +797,7 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE r
         }
         else
         {
-            if (curl_easy_setopt(httpHandleData->curl, CURLOPT_VERBOSE, httpHandleData->verbose) != CURLE_OK)
-            {
-                result = HTTPAPI_SET_OPTION_FAILED;
-                LogError("failed to set CURLOPT_VERBOSE (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-            }
-            else if ((strcpy_s(tempHostURL, tempHostURL_size, httpHandleData->hostURL) != 0) ||
+            if ((strcpy_s(tempHostURL, tempHostURL_size, httpHandleData->hostURL) != 0) ||
                 (strcat_s(tempHostURL, tempHostURL_size, relativePath) != 0))
             {
                 result = HTTPAPI_STRING_PROCESSING_ERROR;
@@ -559,183 +809,19 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE r
                 result = HTTPAPI_SET_OPTION_FAILED;
                 LogError("failed to set CURLOPT_URL (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
             }
-            else if (curl_easy_setopt(httpHandleData->curl, CURLOPT_TIMEOUT_MS, httpHandleData->timeout) != CURLE_OK)
-            {
-                result = HTTPAPI_SET_OPTION_FAILED;
-                LogError("failed to set CURLOPT_TIMEOUT_MS (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-            }
-            else if (curl_easy_setopt(httpHandleData->curl, CURLOPT_LOW_SPEED_LIMIT, httpHandleData->lowSpeedLimit) != CURLE_OK)
-            {
-                result = HTTPAPI_SET_OPTION_FAILED;
-                LogError("failed to set CURLOPT_LOW_SPEED_LIMIT (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-            }
-            else if (curl_easy_setopt(httpHandleData->curl, CURLOPT_LOW_SPEED_TIME, httpHandleData->lowSpeedTime) != CURLE_OK)
-            {
-                result = HTTPAPI_SET_OPTION_FAILED;
-                LogError("failed to set CURLOPT_LOW_SPEED_TIME (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-            }
-            else if (curl_easy_setopt(httpHandleData->curl, CURLOPT_FRESH_CONNECT, httpHandleData->freshConnect) != CURLE_OK)
-            {
-                result = HTTPAPI_SET_OPTION_FAILED;
-                LogError("failed to set CURLOPT_FRESH_CONNECT (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-            }
-            else if (curl_easy_setopt(httpHandleData->curl, CURLOPT_FORBID_REUSE, httpHandleData->forbidReuse) != CURLE_OK)
+            else if ((result = setTransferOptions(httpHandleData->curl, httpHandleData)) != HTTPAPI_OK)
             {
-                result = HTTPAPI_SET_OPTION_FAILED;
-                LogError("failed to set CURLOPT_FORBID_REUSE (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-            }
-            else if (curl_easy_setopt(httpHandleData->curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1) != CURLE_OK)
-            {
-                result = HTTPAPI_SET_OPTION_FAILED;
-                LogError("failed to set CURLOPT_HTTP_VERSION (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
+                LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
             }
             else
             {
-                result = HTTPAPI_OK;
-
-                switch (requestType)
-                {
-                default:
-                    result = HTTPAPI_INVALID_ARG;
-                    LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                    break;
-
-                case HTTPAPI_REQUEST_GET:
-                    if (curl_easy_setopt(httpHandleData->curl, CURLOPT_HTTPGET, 1L) != CURLE_OK)
-                    {
-                        result = HTTPAPI_SET_OPTION_FAILED;
-                        LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                    }
-                    else
-                    {
-                        if (curl_easy_setopt(httpHandleData->curl, CURLOPT_CUSTOMREQUEST, NULL) != CURLE_OK)
-                        {
-                            result = HTTPAPI_SET_OPTION_FAILED;
-                            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                        }
-                    }
-
-                    break;
-
-                case HTTPAPI_REQUEST_HEAD:
-                    if (curl_easy_setopt(httpHandleData->curl, CURLOPT_HTTPGET, 1L) != CURLE_OK)
-                    {
-                        result = HTTPAPI_SET_OPTION_FAILED;
-                        LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                    }
-                    else if (curl_easy_setopt(httpHandleData->curl, CURLOPT_NOBODY, 1L) != CURLE_OK)
-                    {
-                        result = HTTPAPI_SET_OPTION_FAILED;
-                        LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                    }
-                    else if (curl_easy_setopt(httpHandleData->curl, CURLOPT_CUSTOMREQUEST, NULL) != CURLE_OK)
-                    {
-                        result = HTTPAPI_SET_OPTION_FAILED;
-                        LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                    }
-
-                    break;
-
-                case HTTPAPI_REQUEST_POST:
-                    if (curl_easy_setopt(httpHandleData->curl, CURLOPT_POST, 1L) != CURLE_OK)
-                    {
-                        result = HTTPAPI_SET_OPTION_FAILED;
-                        LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                    }
-                    else
-                    {
-                        if (curl_easy_setopt(httpHandleData->curl, CURLOPT_CUSTOMREQUEST, NULL) != CURLE_OK)
-                        {
-                            result = HTTPAPI_SET_OPTION_FAILED;
-                            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                        }
-                    }
-
-                    break;
-
-                case HTTPAPI_REQUEST_PUT:
-                    if (curl_easy_setopt(httpHandleData->curl, CURLOPT_POST, 1L))
-                    {
-                        result = HTTPAPI_SET_OPTION_FAILED;
-                        LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                    }
-                    else
-                    {
-                        if (curl_easy_setopt(httpHandleData->curl, CURLOPT_CUSTOMREQUEST, "PUT") != CURLE_OK)
-                        {
-                            result = HTTPAPI_SET_OPTION_FAILED;
-                            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                        }
-                    }
-                    break;
-
-                case HTTPAPI_REQUEST_DELETE:
-                    if (curl_easy_setopt(httpHandleData->curl, CURLOPT_POST, 1L) != CURLE_OK)
-                    {
-                        result = HTTPAPI_SET_OPTION_FAILED;
-                        LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                    }
-                    else
-                    {
-                        if (curl_easy_setopt(httpHandleData->curl, CURLOPT_CUSTOMREQUEST, "DELETE") != CURLE_OK)
-                        {
-                            result = HTTPAPI_SET_OPTION_FAILED;
-                            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                        }
-                    }
-                    break;
-
-                case HTTPAPI_REQUEST_PATCH:
-                    if (curl_easy_setopt(httpHandleData->curl, CURLOPT_POST, 1L) != CURLE_OK)
-                    {
-                        result = HTTPAPI_SET_OPTION_FAILED;
-                        LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                    }
-                    else
-                    {
-                        if (curl_easy_setopt(httpHandleData->curl, CURLOPT_CUSTOMREQUEST, "PATCH") != CURLE_OK)
-                        {
-                            result = HTTPAPI_SET_OPTION_FAILED;
-                            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                        }
-                    }
-
-                    break;
-                }
+                result = setRequestType(httpHandleData->curl, requestType);
 
                 if (result == HTTPAPI_OK)
                 {
                     /* add headers */
                     struct curl_slist* headers = NULL;
-                    size_t i;
-
-                    for (i = 0; i < headersCount; i++)
-                    {
-                        char *tempBuffer;
-                        if (HTTPHeaders_GetHeader(httpHeadersHandle, i, &tempBuffer) != HTTP_HEADERS_OK)
-                        {
-                            /* error */
-                            result = HTTPAPI_HTTP_HEADERS_FAILED;
-                            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                            break;
-                        }
-                        else
-                        {
-                            struct curl_slist* newHeaders = curl_slist_append(headers, tempBuffer);
-                            if (newHeaders == NULL)
-                            {
-                                result = HTTPAPI_ALLOC_FAILED;
-                                LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                                free(tempBuffer);
-                                break;
-                            }
-                            else
-                            {
-                                free(tempBuffer);
-                                headers = newHeaders;
-                            }
-                        }
-                    }
+                    result = buildRequestHeaders(httpHeadersHandle, headersCount, &headers);
 
                     if (result == HTTPAPI_OK)
                     {
@@ -747,34 +833,9 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE r
                         else
                         {
                             /* add content */
-                            if ((content != NULL) &&
-                                (contentLength > 0))
-                            {
-                                if ((curl_easy_setopt(httpHandleData->curl, CURLOPT_POSTFIELDS, (void*)content) != CURLE_OK) ||
-                                    (curl_easy_setopt(httpHandleData->curl, CURLOPT_POSTFIELDSIZE, contentLength) != CURLE_OK))
-                                {
-                                    result = HTTPAPI_SET_OPTION_FAILED;
-                                    LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                                }
-                            }
-                            else
-                            {
-                                if (requestType != HTTPAPI_REQUEST_GET)
-                                {
-                                    if ((curl_easy_setopt(httpHandleData->curl, CURLOPT_POSTFIELDS, (void*)NULL) != CURLE_OK) ||
-                                        (curl_easy_setopt(httpHandleData->curl, CURLOPT_POSTFIELDSIZE, 0) != CURLE_OK))
-                                    {
-                                        result = HTTPAPI_SET_OPTION_FAILED;
-                                        LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(HTTPAPI_RESULT, result));
-                                    }
-                                }
-                                else
-                                {
-                                    /*GET request cannot POST, so "do nothing*/
-                                }
-                            }
-
-                            if (result == HTTPAPI_OK)
+                            result = setRequestContent(httpHandleData->curl, requestType, content, contentLength);
+
+                            if (result == HTTPAPI_OK)
                             {
                                 if ((curl_easy_setopt(httpHandleData->curl, CURLOPT_WRITEHEADER, NULL) != CURLE_OK) ||
                                     (curl_easy_setopt(httpHandleData->curl, CURLOPT_HEADERFUNCTION, NULL) != CURLE_OK) ||
@@ -1321,3 +1382,616 @@ HTTPAPI_RESULT HTTPAPI_CloneOption(const char* optionName, const void* value, co
     }
     return result;
 }
+
+typedef struct HTTPAPI_ASYNC_TRANSFER_TAG
+{
+    CURL* curl;
+    struct curl_slist* requestHeaders;
+    HTTP_HEADERS_HANDLE responseHeaders;
+    BUFFER_HANDLE responseContent;
+    bool hasResponseError;
+    ON_HTTPAPI_ASYNC_REQUEST_COMPLETE onRequestComplete;
+    void* onRequestCompleteContext;
+    struct HTTPAPI_ASYNC_TRANSFER_TAG* previous;
+    struct HTTPAPI_ASYNC_TRANSFER_TAG* next;
+} HTTPAPI_ASYNC_TRANSFER;
+
+typedef struct HTTPAPI_ASYNC_TAG
+{
+    CURLM* multi;
+    LOCK_HANDLE lock;
+    THREAD_HANDLE thread;
+    /*submitted and not yet given to curl, oldest first, guarded by lock*/
+    HTTPAPI_ASYNC_TRANSFER* submittedHead;
+    HTTPAPI_ASYNC_TRANSFER* submittedTail;
+    bool isStopping;
+    /*httpapi_async_destroy was called from on_request_complete, the thread tears httpapi_async down itself*/
+    bool isDestroyedByItsThread;
+    /*given to curl, only used by the thread*/
+    HTTPAPI_ASYNC_TRANSFER* inFlight;
+    /*in finishedHttpapiAsyncs once its thread is done with it*/
+    struct HTTPAPI_ASYNC_TAG* nextFinished;
+} HTTPAPI_ASYNC;
+
+/*destroyed from their own thread, which cannot join itself: joined and freed by the next httpapi_async_create,
+httpapi_async_destroy or HTTPAPI_Deinit. Guarded by finishedHttpapiAsyncsLock*/
+static HTTPAPI_ASYNC* finishedHttpapiAsyncs = NULL;
+
+#ifdef _MSC_VER
+#define HTTPAPI_ASYNC_THREAD_LOCAL __declspec(thread)
+#else
+#define HTTPAPI_ASYNC_THREAD_LOCAL __thread
+#endif
+
+/*the httpapi_async whose thread this is, so that httpapi_async_destroy called from on_request_complete does not join its own thread*/
+static HTTPAPI_ASYNC_THREAD_LOCAL HTTPAPI_ASYNC* currentThreadHttpapiAsync;
+
+/*curl gives one header line at a time, not zero terminated and with its CRLF*/
+static size_t asyncHeaderCallback(char* buffer, size_t size, size_t nitems, void* userdata)
+{
+    HTTPAPI_ASYNC_TRANSFER* transfer = (HTTPAPI_ASYNC_TRANSFER*)userdata;
+    size_t length = size * nitems;
+    const char* whereIsColon = memchr(buffer, ':', length);
+
+    if (whereIsColon != NULL)
+    {
+        char stackLine[TEMP_BUFFER_SIZE];
+        char* line = (length < sizeof(stackLine)) ? stackLine : (char*)malloc(length + 1);
+        if (line == NULL)
+        {
+            LogError("unable to malloc a header line of %lu bytes", (unsigned long)length);
+            transfer->hasResponseError = true;
+        }
+        else
+        {
+            size_t nameLength = (size_t)(whereIsColon - buffer);
+            size_t lineLength = length;
+            while ((lineLength > nameLength) && ((buffer[lineLength - 1] == '\r') || (buffer[lineLength - 1] == '\n')))
+            {
+                lineLength--;
+            }
+            (void)memcpy(line, buffer, lineLength);
+            line[lineLength] = '\0';
+            line[nameLength] = '\0';
+
+            /*as HeadersWriteFunction does, the value is everything after the colon*/
+            if (HTTPHeaders_AddHeaderNameValuePair(transfer->responseHeaders, line, line + nameLength + 1) != HTTP_HEADERS_OK)
+            {
+                LogError("unable to add the response header %s", line);
+                transfer->hasResponseError = true;
+            }
+
+            if (line != stackLine)
+            {
+                free(line);
+            }
+        }
+    }
+    else
+    {
+        /*not a header, maybe a status-line*/
+    }
+
+    return length;
+}
+
+static size_t asyncContentCallback(char* buffer, size_t size, size_t nmemb, void* userdata)
+{
+    HTTPAPI_ASYNC_TRANSFER* transfer = (HTTPAPI_ASYNC_TRANSFER*)userdata;
+    size_t length = size * nmemb;
+
+    if ((length > 0) &&
+        (BUFFER_append_build(transfer->responseContent, (const unsigned char*)buffer, length) != 0))
+    {
+        LogError("unable to append %lu bytes to the response content", (unsigned long)length);
+        transfer->hasResponseError = true;
+    }
+
+    return length;
+}
+
+static void destroyTransfer(HTTPAPI_ASYNC_TRANSFER* transfer)
+{
+    if (transfer->curl != NULL)
+    {
+        curl_easy_cleanup(transfer->curl);
+    }
+    curl_slist_free_all(transfer->requestHeaders);
+    if (transfer->responseHeaders != NULL)
+    {
+        HTTPHeaders_Free(transfer->responseHeaders);
+    }
+    if (transfer->responseContent != NULL)
+    {
+        BUFFER_delete(transfer->responseContent);
+    }
+    free(transfer);
+}
+
+static void completeTransfer(HTTPAPI_ASYNC_TRANSFER* transfer, HTTPAPI_RESULT result, unsigned int statusCode)
+{
+    transfer->onRequestComplete(transfer->onRequestCompleteContext, result, statusCode, transfer->responseHeaders, transfer->responseContent);
+    destroyTransfer(transfer);
+}
+
+/*a transfer is a copy of the curl handle of the connection (so it has its proxy and TLS options) set up for one request*/
+static HTTPAPI_ASYNC_TRANSFER* createTransfer(HTTP_HANDLE_DATA* httpHandleData, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath,
+    HTTP_HEADERS_HANDLE requestHeaders, BUFFER_HANDLE requestContent)
+{
+    HTTPAPI_ASYNC_TRANSFER* result = (HTTPAPI_ASYNC_TRANSFER*)calloc(1, sizeof(HTTPAPI_ASYNC_TRANSFER));
+    if (result == NULL)
+    {
+        LogError("unable to allocate a transfer");
+    }
+    else
+    {
+        size_t headersCount;
+        char* url;
+        size_t url_size = safe_add_size_t(strlen(httpHandleData->hostURL), strlen(relativePath));
+        url_size = safe_add_size_t(url_size, 1);
+
+        if (url_size == SIZE_MAX)
+        {
+            LogError("invalid malloc size");
+            url = NULL;
+        }
+        else
+        {
+            url = (char*)malloc(url_size);
+        }
+
+        if (url == NULL)
+        {
+            LogError("unable to malloc the URL");
+            destroyTransfer(result);
+            result = NULL;
+        }
+        else
+        {
+            const unsigned char* content = (requestContent == NULL) ? NULL : BUFFER_u_char(requestContent);
+            size_t contentLength = (requestContent == NULL) ? 0 : BUFFER_length(requestContent);
+
+            if ((strcpy_s(url, url_size, httpHandleData->hostURL) != 0) ||
+                (strcat_s(url, url_size, relativePath) != 0))
+            {
+                LogError("unable to build the URL");
+                destroyTransfer(result);
+                result = NULL;
+            }
+            else if (HTTPHeaders_GetHeaderCount(requestHeaders, &headersCount) != HTTP_HEADERS_OK)
+            {
+                LogError("unable to get the request header count");
+                destroyTransfer(result);
+                result = NULL;
+            }
+            else if (
+                ((result->responseHeaders = HTTPHeaders_Alloc()) == NULL) ||
+                ((result->responseContent = BUFFER_new()) == NULL)
+                )
+            {
+                LogError("unable to allocate the response headers and content");
+                destroyTransfer(result);
+                result = NULL;
+            }
+            else if ((result->curl = curl_easy_duphandle(httpHandleData->curl)) == NULL)
+            {
+                LogError("unable to curl_easy_duphandle");
+                destroyTransfer(result);
+                result = NULL;
+            }
+            else if (
+                (curl_easy_setopt(result->curl, CURLOPT_URL, url) != CURLE_OK) ||
+                (setTransferOptions(result->curl, httpHandleData) != HTTPAPI_OK) ||
+                (setRequestType(result->curl, requestType) != HTTPAPI_OK) ||
+                (buildRequestHeaders(requestHeaders, headersCount, &result->requestHeaders) != HTTPAPI_OK) ||
+                (curl_easy_setopt(result->curl, CURLOPT_HTTPHEADER, result->requestHeaders) != CURLE_OK) ||
+                (setRequestContent(result->curl, requestType, content, contentLength) != HTTPAPI_OK) ||
+                (curl_easy_setopt(result->curl, CURLOPT_HEADERFUNCTION, asyncHeaderCallback) != CURLE_OK) ||
+                (curl_easy_setopt(result->curl, CURLOPT_HEADERDATA, result) != CURLE_OK) ||
+                (curl_easy_setopt(result->curl, CURLOPT_WRITEFUNCTION, asyncContentCallback) != CURLE_OK) ||
+                (curl_easy_setopt(result->curl, CURLOPT_WRITEDATA, result) != CURLE_OK) ||
+                (curl_easy_setopt(result->curl, CURLOPT_PRIVATE, result) != CURLE_OK)
+                )
+            {
+                LogError("unable to set up the transfer");
+                destroyTransfer(result);
+                result = NULL;
+            }
+            else
+            {
+                /*all nice*/
+            }
+
+            free(url);
+        }
+    }
+
+    return result;
+}
+
+static void removeInFlight(HTTPAPI_ASYNC* httpapiAsync, HTTPAPI_ASYNC_TRANSFER* transfer)
+{
+    (void)curl_multi_remove_handle(httpapiAsync->multi, transfer->curl);
+    if (transfer->previous == NULL)
+    {
+        httpapiAsync->inFlight = transfer->next;
+    }
+    else
+    {
+        transfer->previous->next = transfer->next;
+    }
+    if (transfer->next != NULL)
+    {
+        transfer->next->previous = transfer->previous;
+    }
+}
+
+/*gives the submitted transfers to curl. Returns false when httpapi_async_destroy was called*/
+static bool startSubmittedTransfers(HTTPAPI_ASYNC* httpapiAsync)
+{
+    bool result;
+    HTTPAPI_ASYNC_TRANSFER* submitted;
+
+    if (Lock(httpapiAsync->lock) != LOCK_OK)
+    {
+        LogError("unable to Lock");
+        submitted = NULL;
+        result = true;
+    }
+    else
+    {
+        submitted = httpapiAsync->submittedHead;
+        httpapiAsync->submittedHead = NULL;
+        httpapiAsync->submittedTail = NULL;
+        result = !httpapiAsync->isStopping;
+        (void)Unlock(httpapiAsync->lock);
+    }
+
+    while (submitted != NULL)
+    {
+        HTTPAPI_ASYNC_TRANSFER* transfer = submitted;
+        submitted = submitted->next;
+
+        if (!result)
+        {
+            completeTransfer(transfer, HTTPAPI_ERROR, 0);
+        }
+        else if (curl_multi_add_handle(httpapiAsync->multi, transfer->curl) != CURLM_OK)
+        {
+            LogError("unable to curl_multi_add_handle");
+            completeTransfer(transfer, HTTPAPI_OPEN_REQUEST_FAILED, 0);
+        }
+        else
+        {
+            transfer->previous = NULL;
+            transfer->next = httpapiAsync->inFlight;
+            if (httpapiAsync->inFlight != NULL)
+            {
+                httpapiAsync->inFlight->previous = transfer;
+            }
+            httpapiAsync->inFlight = transfer;
+        }
+    }
+
+    return result;
+}
+
+static void completeDoneTransfers(HTTPAPI_ASYNC* httpapiAsync)
+{
+    CURLMsg* message;
+    int messagesLeft;
+
+    while ((message = curl_multi_info_read(httpapiAsync->multi, &messagesLeft)) != NULL)
+    {
+        if (message->msg == CURLMSG_DONE)
+        {
+            HTTPAPI_ASYNC_TRANSFER* transfer;
+            CURLcode curlResult = message->data.result;
+
+            if (curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, (char**)&transfer) != CURLE_OK)
+            {
+                LogError("unable to get the transfer of a done curl handle");
+            }
+            else
+            {
+                long httpCode;
+
+                /*message is not valid anymore once its handle is removed*/
+                removeInFlight(httpapiAsync, transfer);
+
+                if (curlResult != CURLE_OK)
+                {
+                    LogError("transfer failed: %s", curl_easy_strerror(curlResult));
+                    completeTransfer(transfer, HTTPAPI_OPEN_REQUEST_FAILED, 0);
+                }
+                else if (curl_easy_getinfo(transfer->curl, CURLINFO_RESPONSE_CODE, &httpCode) != CURLE_OK)
+                {
+                    LogError("unable to get the response code");
+                    completeTransfer(transfer, HTTPAPI_QUERY_HEADERS_FAILED, 0);
+                }
+                else if (transfer->hasResponseError)
+                {
+                    completeTransfer(transfer, HTTPAPI_READ_DATA_FAILED, 0);
+                }
+                else
+                {
+                    completeTransfer(transfer, HTTPAPI_OK, (unsigned int)httpCode);
+                }
+            }
+        }
+    }
+}
+
+static void releaseFinishedHttpapiAsyncs(void)
+{
+    HTTPAPI_ASYNC* finished;
+
+    if (finishedHttpapiAsyncsLock == NULL)
+    {
+        finished = NULL;
+    }
+    else if (Lock(finishedHttpapiAsyncsLock) != LOCK_OK)
+    {
+        LogError("unable to Lock");
+        finished = NULL;
+    }
+    else
+    {
+        finished = finishedHttpapiAsyncs;
+        finishedHttpapiAsyncs = NULL;
+        (void)Unlock(finishedHttpapiAsyncsLock);
+    }
+
+    while (finished != NULL)
+    {
+        HTTPAPI_ASYNC* httpapiAsync = finished;
+        int threadResult;
+        finished = finished->nextFinished;
+
+        /*the thread added httpapiAsync to the list on its way out*/
+        if (ThreadAPI_Join(httpapiAsync->thread, &threadResult) != THREADAPI_OK)
+        {
+            LogError("unable to ThreadAPI_Join");
+        }
+        free(httpapiAsync);
+    }
+}
+
+/*the end of httpapi_async_destroy, for an httpapi_async destroyed from on_request_complete*/
+static void finishDestroyByItsThread(HTTPAPI_ASYNC* httpapiAsync)
+{
+    (void)Lock_Deinit(httpapiAsync->lock);
+    (void)curl_multi_cleanup(httpapiAsync->multi);
+
+    if (finishedHttpapiAsyncsLock == NULL)
+    {
+        LogError("HTTPAPI_Init was not called, httpapi_async=%p and its thread are not released", httpapiAsync);
+    }
+    else if (Lock(finishedHttpapiAsyncsLock) != LOCK_OK)
+    {
+        LogError("unable to Lock, httpapi_async=%p and its thread are not released", httpapiAsync);
+    }
+    else
+    {
+        httpapiAsync->nextFinished = finishedHttpapiAsyncs;
+        finishedHttpapiAsyncs = httpapiAsync;
+        (void)Unlock(finishedHttpapiAsyncsLock);
+    }
+}
+
+static int httpapiAsyncThread(void* context)
+{
+    HTTPAPI_ASYNC* httpapiAsync = (HTTPAPI_ASYNC*)context;
+
+    currentThreadHttpapiAsync = httpapiAsync;
+
+    while (startSubmittedTransfers(httpapiAsync))
+    {
+        int runningTransfers;
+
+        if (curl_multi_perform(httpapiAsync->multi, &runningTransfers) != CURLM_OK)
+        {
+            LogError("curl_multi_perform failed");
+        }
+
+        completeDoneTransfers(httpapiAsync);
+
+#if LIBCURL_VERSION_NUM >= 0x074400
+        /*httpapi_async_execute_request and httpapi_async_destroy wake this up*/
+        if (curl_multi_poll(httpapiAsync->multi, NULL, 0, HTTPAPI_ASYNC_WAIT_TIMEOUT_MS, NULL) != CURLM_OK)
+#else
+        /*without curl_multi_wakeup, new requests are only seen after a short wait*/
+        if (curl_multi_wait(httpapiAsync->multi, NULL, 0, HTTPAPI_ASYNC_POLL_TIMEOUT_MS, NULL) != CURLM_OK)
+#endif
+        {
+            LogError("unable to wait for the transfers");
+        }
+    }
+
+    while (httpapiAsync->inFlight != NULL)
+    {
+        HTTPAPI_ASYNC_TRANSFER* transfer = httpapiAsync->inFlight;
+        removeInFlight(httpapiAsync, transfer);
+        completeTransfer(transfer, HTTPAPI_ERROR, 0);
+    }
+
+    currentThreadHttpapiAsync = NULL;
+
+    /*nothing calls on_request_complete anymore, so isDestroyedByItsThread does not change*/
+    if (httpapiAsync->isDestroyedByItsThread)
+    {
+        finishDestroyByItsThread(httpapiAsync);
+    }
+
+    return 0;
+}
+
+HTTPAPI_ASYNC_HANDLE httpapi_async_create(void)
+{
+    HTTPAPI_ASYNC* result;
+
+    releaseFinishedHttpapiAsyncs();
+
+    result = (HTTPAPI_ASYNC*)calloc(1, sizeof(HTTPAPI_ASYNC));
+    if (result == NULL)
+    {
+        LogError("unable to allocate httpapi_async");
+    }
+    else if ((result->multi = curl_multi_init()) == NULL)
+    {
+        LogError("unable to curl_multi_init");
+        free(result);
+        result = NULL;
+    }
+    else if ((result->lock = Lock_Init()) == NULL)
+    {
+        LogError("unable to Lock_Init");
+        (void)curl_multi_cleanup(result->multi);
+        free(result);
+        result = NULL;
+    }
+    else if (ThreadAPI_Create(&result->thread, httpapiAsyncThread, result) != THREADAPI_OK)
+    {
+        LogError("unable to ThreadAPI_Create");
+        (void)Lock_Deinit(result->lock);
+        (void)curl_multi_cleanup(result->multi);
+        free(result);
+        result = NULL;
+    }
+    else
+    {
+        /*all nice*/
+    }
+
+    return result;
+}
+
+void httpapi_async_destroy(HTTPAPI_ASYNC_HANDLE httpapi_async)
+{
+    if (httpapi_async == NULL)
+    {
+        LogError("invalid arg HTTPAPI_ASYNC_HANDLE httpapi_async=%p", httpapi_async);
+    }
+    else if (currentThreadHttpapiAsync == httpapi_async)
+    {
+        /*the thread cannot join itself: it completes the other requests and tears httpapi_async down once on_request_complete returns*/
+        if (httpapi_async->isDestroyedByItsThread)
+        {
+            LogError("httpapi_async=%p is already destroyed", httpapi_async);
+        }
+        else
+        {
+            httpapi_async->isDestroyedByItsThread = true;
+
+            if (Lock(httpapi_async->lock) != LOCK_OK)
+            {
+                LogError("unable to Lock");
+                httpapi_async->isStopping = true;
+            }
+            else
+            {
+                httpapi_async->isStopping = true;
+                (void)Unlock(httpapi_async->lock);
+            }
+
+#if LIBCURL_VERSION_NUM >= 0x074400
+            /*so that the thread does not wait for the transfers after on_request_complete returns*/
+            (void)curl_multi_wakeup(httpapi_async->multi);
+#endif
+        }
+    }
+    else
+    {
+        int threadResult;
+
+        releaseFinishedHttpapiAsyncs();
+
+        if (Lock(httpapi_async->lock) != LOCK_OK)
+        {
+            LogError("unable to Lock");
+            httpapi_async->isStopping = true;
+        }
+        else
+        {
+            httpapi_async->isStopping = true;
+            (void)Unlock(httpapi_async->lock);
+        }
+
+#if LIBCURL_VERSION_NUM >= 0x074400
+        (void)curl_multi_wakeup(httpapi_async->multi);
+#endif
+        /*the thread completes the requests in flight with HTTPAPI_ERROR before it ends*/
+        if (ThreadAPI_Join(httpapi_async->thread, &threadResult) != THREADAPI_OK)
+        {
+            LogError("unable to ThreadAPI_Join");
+        }
+
+        (void)Lock_Deinit(httpapi_async->lock);
+        (void)curl_multi_cleanup(httpapi_async->multi);
+        free(httpapi_async);
+    }
+}
+
+int httpapi_async_execute_request(HTTPAPI_ASYNC_HANDLE httpapi_async, HTTP_HANDLE http_handle, HTTPAPI_REQUEST_TYPE request_type, const char* relative_path,
+    HTTP_HEADERS_HANDLE request_headers, BUFFER_HANDLE request_content, ON_HTTPAPI_ASYNC_REQUEST_COMPLETE on_request_complete, void* on_request_complete_context)
+{
+    int result;
+
+    if ((httpapi_async == NULL) ||
+        (http_handle == NULL) ||
+        (relative_path == NULL) ||
+        (request_headers == NULL) ||
+        (on_request_complete == NULL))
+    {
+        LogError("invalid arg HTTPAPI_ASYNC_HANDLE httpapi_async=%p, HTTP_HANDLE http_handle=%p, const char* relative_path=%p, HTTP_HEADERS_HANDLE request_headers=%p, ON_HTTPAPI_ASYNC_REQUEST_COMPLETE on_request_complete=%p",
+            httpapi_async, http_handle, relative_path, request_headers, on_request_complete);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        HTTPAPI_ASYNC_TRANSFER* transfer = createTransfer((HTTP_HANDLE_DATA*)http_handle, request_type, relative_path, request_headers, request_content);
+        if (transfer == NULL)
+        {
+            LogError("unable to create the transfer");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            transfer->onRequestComplete = on_request_complete;
+            transfer->onRequestCompleteContext = on_request_complete_context;
+
+            if (Lock(httpapi_async->lock) != LOCK_OK)
+            {
+                LogError("unable to Lock");
+                destroyTransfer(transfer);
+                result = MU_FAILURE;
+            }
+            else if (httpapi_async->isStopping)
+            {
+                (void)Unlock(httpapi_async->lock);
+                LogError("httpapi_async is being destroyed");
+                destroyTransfer(transfer);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                if (httpapi_async->submittedTail == NULL)
+                {
+                    httpapi_async->submittedHead = transfer;
+                }
+                else
+                {
+                    httpapi_async->submittedTail->next = transfer;
+                }
+                httpapi_async->submittedTail = transfer;
+                (void)Unlock(httpapi_async->lock);
+#if LIBCURL_VERSION_NUM >= 0x074400
+                (void)curl_multi_wakeup(httpapi_async->multi);
+#endif
+                result = 0;
+            }
+        }
+    }
+
+    return result;
+}
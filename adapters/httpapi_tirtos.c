@@ -136,20 +136,14 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle,
 
     /* Send the request headers */
     while (cnt--) {
-        ret = HTTPHeaders_GetHeader(httpHeadersHandle, cnt, &hname);
+        HTTP_HEADER_VIEW header;
+        ret = HTTPHeaders_GetHeaderView(httpHeadersHandle, cnt, &header);
         if (ret != HTTP_HEADERS_OK) {
             LogError("Cannot get request header %d", cnt);
             return (HTTPAPI_QUERY_HEADERS_FAILED);
         }
 
-        ret = splitHeader(hname, &hvalue);
-
-        if (ret == 0) {
-            ret = HTTPCli_sendField(cli, hname, hvalue, false);
-        }
-
-        free(hname);
-        hname = NULL;
+        ret = HTTPCli_sendField(cli, header.name, header.value, false);
 
         if (ret < 0) {
             LogError("HTTP send field failed, ret=%d", ret);
@@ -76,17 +76,16 @@ static char* ConcatHttpHeaders(HTTP_HEADERS_HANDLE httpHeadersHandle, size_t toA
         result[0] = '\0';
         for (i = 0; i < headersCount; i++)
         {
-            char* temp;
-            if (HTTPHeaders_GetHeader(httpHeadersHandle, i, &temp) != HTTP_HEADERS_OK)
+            HTTP_HEADER_VIEW header;
+            if (HTTPHeaders_GetHeaderView(httpHeadersHandle, i, &header) != HTTP_HEADERS_OK)
             {
-                LogError("unable to HTTPHeaders_GetHeader");
+                LogError("unable to HTTPHeaders_GetHeaderView");
                 break;
             }
             else
             {
-                (void)strcat(result, temp);
+                (void)strcat(result, header.line);
                 (void)strcat(result, "\r\n");
-                free(temp);
             }
         }
     
@@ -123,16 +122,15 @@ static HTTPAPI_RESULT ConstructHeadersString(HTTP_HEADERS_HANDLE httpHeadersHand
         size_t toAlloc = 0;
         for (i = 0; i < headersCount; i++)
         {
-            char *temp;
-            if (HTTPHeaders_GetHeader(httpHeadersHandle, i, &temp) == HTTP_HEADERS_OK)
+            HTTP_HEADER_VIEW header;
+            if (HTTPHeaders_GetHeaderView(httpHeadersHandle, i, &header) == HTTP_HEADERS_OK)
             {
-                toAlloc += strlen(temp);
+                toAlloc += header.line_length;
                 toAlloc += 2;
-                free(temp);
             }
             else
             {
-                LogError("HTTPHeaders_GetHeader failed");
+                LogError("HTTPHeaders_GetHeaderView failed");
                 break;
             }
         }
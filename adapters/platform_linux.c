@@ -51,6 +51,11 @@ int platform_init(void)
     {
         result = tlsio_wolfssl_init();
     }
+#elif USE_MBEDTLS
+    if (result == 0)
+    {
+        result = tlsio_mbedtls_init();
+    }
 #endif
     return result;
 }
@@ -105,5 +110,7 @@ void platform_deinit(void)
     tlsio_openssl_deinit();
 #elif USE_WOLFSSL
     tlsio_wolfssl_deinit();
+#elif USE_MBEDTLS
+    tlsio_mbedtls_deinit();
 #endif
 }
@@ -57,6 +57,11 @@ int platform_init(void)
         {
             result = tlsio_openssl_init();
         }
+#elif USE_MBEDTLS
+        if (result == 0)
+        {
+            result = tlsio_mbedtls_init();
+        }
 #endif
     }
     return result;
@@ -239,5 +244,7 @@ void platform_deinit(void)
 
 #ifdef USE_OPENSSL
     tlsio_openssl_deinit();
+#elif USE_MBEDTLS
+    tlsio_mbedtls_deinit();
 #endif
 }
@@ -22,6 +22,7 @@
 #include <signal.h>
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
@@ -38,7 +39,15 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <limits.h>
+#include <sys/uio.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#define SOCKETIO_REACTOR_EPOLL
+#endif
 #include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/constbuffer.h"
+#include "azure_c_shared_utility/constbuffer_array.h"
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/gbnetwork.h"
 #include "azure_c_shared_utility/optimize_size.h"
@@ -65,6 +74,16 @@
 // connect timeout in seconds
 #define CONNECT_TIMEOUT         10
 
+// events handled by one socketio_reactor_dowork call, the others are left for the next call
+#define SOCKETIO_REACTOR_MAX_EVENTS     256
+
+// pending IOs gathered in one sendmsg call
+#if defined(IOV_MAX) && (IOV_MAX < 64)
+#define SOCKETIO_MAX_IOV                IOV_MAX
+#else
+#define SOCKETIO_MAX_IOV                64
+#endif
+
 typedef enum IO_STATE_TAG
 {
     IO_STATE_CLOSED,
@@ -76,11 +95,20 @@ typedef enum IO_STATE_TAG
 
 typedef struct PENDING_SOCKET_IO_TAG
 {
-    unsigned char* bytes;
+    const unsigned char* bytes;
     size_t size;
+    /* bytes already sent, a partial send moves it instead of the bytes */
+    size_t offset;
     ON_SEND_COMPLETE on_send_complete;
     void* callback_context;
     SINGLYLINKEDLIST_HANDLE pending_io_list;
+    /* holds the bytes when they were queued without a copy, otherwise NULL and the bytes follow this structure */
+    CONSTBUFFER_HANDLE constbuffer;
+    /* set when the IO is the buffers of a CONSTBUFFER_ARRAY_HANDLE: bytes, size and offset are then those of the buffer being sent
+    and the buffers from next_buffer on are still to be sent after it */
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    uint32_t next_buffer;
+    uint32_t buffer_count;
 } PENDING_SOCKET_IO;
 
 typedef struct SOCKET_IO_INSTANCE_TAG
@@ -100,8 +128,26 @@ typedef struct SOCKET_IO_INSTANCE_TAG
     SINGLYLINKEDLIST_HANDLE pending_io_list;
     unsigned char recv_bytes[XIO_RECEIVE_BUFFER_SIZE];
     DNSRESOLVER_HANDLE dns_resolver;
+    SOCKETIO_REACTOR_HANDLE reactor;
+    int reactor_attached;
+    /* the other socket IOs set to use the same reactor */
+    struct SOCKET_IO_INSTANCE_TAG* reactor_previous;
+    struct SOCKET_IO_INSTANCE_TAG* reactor_next;
 } SOCKET_IO_INSTANCE;
 
+typedef struct SOCKETIO_REACTOR_TAG
+{
+    int epoll_fd;
+    size_t instance_count;
+    /* the socket IOs set to use the reactor, so that destroying the reactor can let go of them */
+    SOCKET_IO_INSTANCE* instances;
+#ifdef SOCKETIO_REACTOR_EPOLL
+    /* the events being dispatched by socketio_reactor_dowork, an instance that leaves the reactor clears its entry */
+    struct epoll_event events[SOCKETIO_REACTOR_MAX_EVENTS];
+#endif
+    int event_count;
+} SOCKETIO_REACTOR;
+
 typedef struct NETWORK_INTERFACE_DESCRIPTION_TAG
 {
     char* name;
@@ -143,6 +189,11 @@ static void* socketio_CloneOption(const char* name, const void* value)
                 }
             }
         }
+        else if (strcmp(name, OPTION_SOCKETIO_REACTOR) == 0)
+        {
+            /* the reactor is not owned by the option, it is shared */
+            result = (void*)value;
+        }
         else
         {
             LogError("Cannot clone option %s (not suppported)", name);
@@ -192,6 +243,13 @@ static OPTIONHANDLER_HANDLE socketio_retrieveoptions(CONCRETE_IO_HANDLE handle)
             OptionHandler_Destroy(result);
             result = NULL;
         }
+        else if (socket_io_instance->reactor != NULL &&
+            OptionHandler_AddOption(result, OPTION_SOCKETIO_REACTOR, socket_io_instance->reactor) != OPTIONHANDLER_OK)
+        {
+            LogError("failed retrieving options (failed adding socketio_reactor)");
+            OptionHandler_Destroy(result);
+            result = NULL;
+        }
     }
 
     return result;
@@ -206,7 +264,8 @@ static const IO_INTERFACE_DESCRIPTION socket_io_interface_description =
     socketio_close,
     socketio_send,
     socketio_dowork,
-    socketio_setoption
+    socketio_setoption,
+    socketio_send_array
 };
 
 static void indicate_error(SOCKET_IO_INSTANCE* socket_io_instance)
@@ -218,45 +277,394 @@ static void indicate_error(SOCKET_IO_INSTANCE* socket_io_instance)
     }
 }
 
-static int add_pending_io(SOCKET_IO_INSTANCE* socket_io_instance, const unsigned char* buffer, size_t size, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+/* the bytes are copied, unless constbuffer holds them in which case a reference to it is kept until they are sent */
+static int add_pending_io(SOCKET_IO_INSTANCE* socket_io_instance, const unsigned char* buffer, size_t size, CONSTBUFFER_HANDLE constbuffer, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    int result;
+    size_t malloc_size = (constbuffer != NULL) ? sizeof(PENDING_SOCKET_IO) : safe_add_size_t(sizeof(PENDING_SOCKET_IO), size);
+    PENDING_SOCKET_IO* pending_socket_io;
+
+    if (malloc_size == SIZE_MAX)
+    {
+        LogError("invalid malloc size");
+        result = MU_FAILURE;
+    }
+    else if ((pending_socket_io = (PENDING_SOCKET_IO*)malloc(malloc_size)) == NULL)
+    {
+        LogError("Allocation Failure: Unable to allocate pending list.");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        if (constbuffer != NULL)
+        {
+            CONSTBUFFER_IncRef(constbuffer);
+            pending_socket_io->bytes = buffer;
+        }
+        else
+        {
+            (void)memcpy(pending_socket_io + 1, buffer, size);
+            pending_socket_io->bytes = (const unsigned char*)(pending_socket_io + 1);
+        }
+        pending_socket_io->size = size;
+        pending_socket_io->offset = 0;
+        pending_socket_io->on_send_complete = on_send_complete;
+        pending_socket_io->callback_context = callback_context;
+        pending_socket_io->pending_io_list = socket_io_instance->pending_io_list;
+        pending_socket_io->constbuffer = constbuffer;
+        pending_socket_io->constbuffer_array = NULL;
+        pending_socket_io->next_buffer = 0;
+        pending_socket_io->buffer_count = 0;
+
+        if (singlylinkedlist_add(socket_io_instance->pending_io_list, pending_socket_io) == NULL)
+        {
+            LogError("Failure: Unable to add socket to pending list.");
+            if (constbuffer != NULL)
+            {
+                CONSTBUFFER_DecRef(constbuffer);
+            }
+            free(pending_socket_io);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            result = 0;
+        }
+    }
+    return result;
+}
+
+/* queues what is left to send of the buffers of an array, keeping a reference to the array until they are sent */
+static int add_pending_array_io(SOCKET_IO_INSTANCE* socket_io_instance, const PENDING_SOCKET_IO* position)
 {
     int result;
     PENDING_SOCKET_IO* pending_socket_io = (PENDING_SOCKET_IO*)malloc(sizeof(PENDING_SOCKET_IO));
+
     if (pending_socket_io == NULL)
     {
+        LogError("Allocation Failure: Unable to allocate pending list.");
         result = MU_FAILURE;
     }
     else
     {
-        pending_socket_io->bytes = (unsigned char*)malloc(size);
-        if (pending_socket_io->bytes == NULL)
+        *pending_socket_io = *position;
+        pending_socket_io->pending_io_list = socket_io_instance->pending_io_list;
+        constbuffer_array_inc_ref(pending_socket_io->constbuffer_array);
+
+        if (singlylinkedlist_add(socket_io_instance->pending_io_list, pending_socket_io) == NULL)
         {
-            LogError("Allocation Failure: Unable to allocate pending list.");
+            LogError("Failure: Unable to add socket to pending list.");
+            constbuffer_array_dec_ref(pending_socket_io->constbuffer_array);
             free(pending_socket_io);
             result = MU_FAILURE;
         }
         else
         {
-            pending_socket_io->size = size;
-            pending_socket_io->on_send_complete = on_send_complete;
-            pending_socket_io->callback_context = callback_context;
-            pending_socket_io->pending_io_list = socket_io_instance->pending_io_list;
-            (void)memcpy(pending_socket_io->bytes, buffer, size);
+            result = 0;
+        }
+    }
+    return result;
+}
+
+static void free_pending_io(PENDING_SOCKET_IO* pending_socket_io)
+{
+    if (pending_socket_io->constbuffer != NULL)
+    {
+        CONSTBUFFER_DecRef(pending_socket_io->constbuffer);
+    }
+    if (pending_socket_io->constbuffer_array != NULL)
+    {
+        constbuffer_array_dec_ref(pending_socket_io->constbuffer_array);
+    }
+    free(pending_socket_io);
+}
+
+/* adds to iov the bytes of the pending IO that are not sent yet, as many entries as fit in iov_available, and returns how many it used */
+static size_t fill_pending_io_iov(const PENDING_SOCKET_IO* pending_socket_io, struct iovec* iov, size_t iov_available, size_t* total_size)
+{
+    size_t result = 0;
 
-            if (singlylinkedlist_add(socket_io_instance->pending_io_list, pending_socket_io) == NULL)
+    if (iov_available > 0)
+    {
+        iov[0].iov_base = (void*)(pending_socket_io->bytes + pending_socket_io->offset);
+        iov[0].iov_len = pending_socket_io->size - pending_socket_io->offset;
+        *total_size += iov[0].iov_len;
+        result = 1;
+
+        if (pending_socket_io->constbuffer_array != NULL)
+        {
+            uint32_t i;
+            for (i = pending_socket_io->next_buffer; (i < pending_socket_io->buffer_count) && (result < iov_available); i++)
             {
-                LogError("Failure: Unable to add socket to pending list.");
-                free(pending_socket_io->bytes);
-                free(pending_socket_io);
-                result = MU_FAILURE;
+                const CONSTBUFFER* content = constbuffer_array_get_buffer_content(pending_socket_io->constbuffer_array, i);
+                iov[result].iov_base = (void*)content->buffer;
+                iov[result].iov_len = content->size;
+                *total_size += content->size;
+                result++;
+            }
+        }
+    }
+
+    return result;
+}
+
+/* moves the pending IO past the bytes that were sent, taking them out of sent, and returns whether all its bytes are sent */
+static bool consume_pending_io(PENDING_SOCKET_IO* pending_socket_io, size_t* sent)
+{
+    bool result;
+
+    for (;;)
+    {
+        size_t remaining = pending_socket_io->size - pending_socket_io->offset;
+        if (*sent < remaining)
+        {
+            pending_socket_io->offset += *sent;
+            *sent = 0;
+            result = false;
+            break;
+        }
+
+        *sent -= remaining;
+        if ((pending_socket_io->constbuffer_array == NULL) ||
+            (pending_socket_io->next_buffer == pending_socket_io->buffer_count))
+        {
+            pending_socket_io->offset = pending_socket_io->size;
+            result = true;
+            break;
+        }
+        else
+        {
+            const CONSTBUFFER* content = constbuffer_array_get_buffer_content(pending_socket_io->constbuffer_array, pending_socket_io->next_buffer);
+            pending_socket_io->bytes = content->buffer;
+            pending_socket_io->size = content->size;
+            pending_socket_io->offset = 0;
+            pending_socket_io->next_buffer++;
+        }
+    }
+
+    return result;
+}
+
+static void reactor_add_instance(SOCKETIO_REACTOR* reactor, SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    socket_io_instance->reactor = reactor;
+    socket_io_instance->reactor_previous = NULL;
+    socket_io_instance->reactor_next = reactor->instances;
+    if (reactor->instances != NULL)
+    {
+        reactor->instances->reactor_previous = socket_io_instance;
+    }
+    reactor->instances = socket_io_instance;
+}
+
+static void reactor_remove_instance(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    if (socket_io_instance->reactor != NULL)
+    {
+        if (socket_io_instance->reactor_previous != NULL)
+        {
+            socket_io_instance->reactor_previous->reactor_next = socket_io_instance->reactor_next;
+        }
+        else
+        {
+            socket_io_instance->reactor->instances = socket_io_instance->reactor_next;
+        }
+
+        if (socket_io_instance->reactor_next != NULL)
+        {
+            socket_io_instance->reactor_next->reactor_previous = socket_io_instance->reactor_previous;
+        }
+
+        socket_io_instance->reactor = NULL;
+        socket_io_instance->reactor_previous = NULL;
+        socket_io_instance->reactor_next = NULL;
+    }
+}
+
+/* registers the connected socket with the reactor of the instance, if it has one */
+static int reactor_attach(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    int result;
+
+    if ((socket_io_instance->reactor == NULL) || socket_io_instance->reactor_attached)
+    {
+        result = 0;
+    }
+    else
+    {
+#ifdef SOCKETIO_REACTOR_EPOLL
+        struct epoll_event event;
+
+        /* edge triggered: sends and receives go on until EAGAIN, so one wake up per change of readiness is enough and there is no epoll_ctl per send */
+        event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        event.data.ptr = socket_io_instance;
+        if (epoll_ctl(socket_io_instance->reactor->epoll_fd, EPOLL_CTL_ADD, socket_io_instance->socket, &event) != 0)
+        {
+            LogError("Failure: epoll_ctl add failed. errno=%d (%s).", errno, strerror(errno));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            socket_io_instance->reactor_attached = 1;
+            socket_io_instance->reactor->instance_count++;
+            result = 0;
+        }
+#else
+        LogError("Failure: socketio reactor is not supported on this platform.");
+        result = MU_FAILURE;
+#endif
+    }
+
+    return result;
+}
+
+/* has to be called before the socket is closed */
+static void reactor_detach(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    if (socket_io_instance->reactor_attached)
+    {
+#ifdef SOCKETIO_REACTOR_EPOLL
+        SOCKETIO_REACTOR* reactor = socket_io_instance->reactor;
+        struct epoll_event event = { 0 };
+        int i;
+
+        if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_DEL, socket_io_instance->socket, &event) != 0)
+        {
+            LogError("Failure: epoll_ctl delete failed. errno=%d (%s).", errno, strerror(errno));
+        }
+
+        /* this can be called from a callback of socketio_reactor_dowork, the events not dispatched yet must not point to the instance anymore */
+        for (i = 0; i < reactor->event_count; i++)
+        {
+            if (reactor->events[i].data.ptr == socket_io_instance)
+            {
+                reactor->events[i].data.ptr = NULL;
+            }
+        }
+
+        reactor->instance_count--;
+#endif
+        socket_io_instance->reactor_attached = 0;
+    }
+}
+
+/* sends the pending IOs until they are all sent or the socket cannot take more.
+The head of the queue goes out in one sendmsg, so small frames do not cost a system call each */
+static void send_pending_io(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    LIST_ITEM_HANDLE first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
+    while (first_pending_io != NULL)
+    {
+        struct iovec iov[SOCKETIO_MAX_IOV];
+        struct msghdr message;
+        size_t iov_count = 0;
+        size_t total_size = 0;
+        LIST_ITEM_HANDLE pending_io = first_pending_io;
+        PENDING_SOCKET_IO* pending_socket_io;
+        ssize_t send_result;
+
+        /* an IO that does not fit entirely fills the iovs, so the bytes of the next one never go out before its own */
+        while ((pending_io != NULL) && (iov_count < SOCKETIO_MAX_IOV) &&
+            ((pending_socket_io = (PENDING_SOCKET_IO*)singlylinkedlist_item_get_value(pending_io)) != NULL))
+        {
+            iov_count += fill_pending_io_iov(pending_socket_io, &iov[iov_count], SOCKETIO_MAX_IOV - iov_count, &total_size);
+            pending_io = singlylinkedlist_get_next_item(pending_io);
+        }
+
+        if (iov_count == 0)
+        {
+            indicate_error(socket_io_instance);
+            LogError("Failure: retrieving socket from list");
+            break;
+        }
+
+        (void)memset(&message, 0, sizeof(message));
+        message.msg_iov = iov;
+        message.msg_iovlen = iov_count;
+        send_result = sendmsg(socket_io_instance->socket, &message, MSG_NOSIGNAL);
+        if (send_result < 0)
+        {
+            if (errno == EAGAIN  || errno == ENOBUFS) /*send says "come back later" with EAGAIN, ENOBUFS - likely the socket buffer cannot accept more data*/
+            {
+                /*do nothing until next dowork */
+                break;
             }
             else
             {
-                result = 0;
+                free_pending_io((PENDING_SOCKET_IO*)singlylinkedlist_item_get_value(first_pending_io));
+                (void)singlylinkedlist_remove(socket_io_instance->pending_io_list, first_pending_io);
+
+                LogError("Failure: sending Socket information. errno=%d (%s).", errno, strerror(errno));
+                indicate_error(socket_io_instance);
             }
         }
+        else
+        {
+            /* completes the IOs that were sent entirely, the first one that was not keeps an offset.
+            An array whose last buffers are empty is complete once the bytes before them are sent, even if sent is 0 by then */
+            size_t sent = (size_t)send_result;
+            while (first_pending_io != NULL)
+            {
+                pending_socket_io = (PENDING_SOCKET_IO*)singlylinkedlist_item_get_value(first_pending_io);
+                if (!consume_pending_io(pending_socket_io, &sent))
+                {
+                    break;
+                }
+                else
+                {
+                    if (pending_socket_io->on_send_complete != NULL)
+                    {
+                        pending_socket_io->on_send_complete(pending_socket_io->callback_context, IO_SEND_OK);
+                    }
+
+                    free_pending_io(pending_socket_io);
+                    if (singlylinkedlist_remove(socket_io_instance->pending_io_list, first_pending_io) != 0)
+                    {
+                        indicate_error(socket_io_instance);
+                        LogError("Failure: unable to remove socket from list");
+                    }
+                    first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
+                }
+            }
+
+            if ((size_t)send_result < total_size)
+            {
+                /* simply wait until next dowork */
+                break;
+            }
+        }
+
+        first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
     }
-    return result;
+}
+
+/* receives until the socket has no more bytes */
+static void receive_bytes(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    ssize_t received = 0;
+    do
+    {
+        received = recv(socket_io_instance->socket, socket_io_instance->recv_bytes, XIO_RECEIVE_BUFFER_SIZE, MSG_NOSIGNAL);
+        if (received > 0)
+        {
+            if (socket_io_instance->on_bytes_received != NULL)
+            {
+                /* Explicitly ignoring here the result of the callback */
+                (void)socket_io_instance->on_bytes_received(socket_io_instance->on_bytes_received_context, socket_io_instance->recv_bytes, received);
+            }
+        }
+        else if (received == 0)
+        {
+            // Do not log error here due to this is probably the socket being closed on the other end
+            indicate_error(socket_io_instance);
+        }
+        else if (received < 0 && errno != EAGAIN)
+        {
+            LogError("Socketio_Failure: Receiving data from endpoint: errno=%d.", errno);
+            indicate_error(socket_io_instance);
+        }
+
+    } while (received > 0 && socket_io_instance->io_state == IO_STATE_OPEN);
 }
 
 static STATIC_VAR_UNUSED void signal_callback(int signum)
@@ -719,6 +1127,8 @@ static int wait_for_socket_connection(SOCKET_IO_INSTANCE* socket_io_instance)
 
 static void destroy_socket_io_instance(SOCKET_IO_INSTANCE* instance)
 {
+    reactor_remove_instance(instance);
+
     if (instance->dns_resolver != NULL)
     {
         dns_resolver_destroy(instance->dns_resolver);
@@ -824,6 +1234,7 @@ void socketio_destroy(CONCRETE_IO_HANDLE socket_io)
         /* we cannot do much if the close fails, so just ignore the result */
         if (socket_io_instance->socket != INVALID_SOCKET)
         {
+            reactor_detach(socket_io_instance);
             close(socket_io_instance->socket);
         }
 
@@ -834,8 +1245,7 @@ void socketio_destroy(CONCRETE_IO_HANDLE socket_io)
             PENDING_SOCKET_IO* pending_socket_io = (PENDING_SOCKET_IO*)singlylinkedlist_item_get_value(first_pending_io);
             if (pending_socket_io != NULL)
             {
-                free(pending_socket_io->bytes);
-                free(pending_socket_io);
+                free_pending_io(pending_socket_io);
             }
 
             (void)singlylinkedlist_remove(socket_io_instance->pending_io_list, first_pending_io);
@@ -866,14 +1276,22 @@ int socketio_open(CONCRETE_IO_HANDLE socket_io, ON_IO_OPEN_COMPLETE on_io_open_c
         else if (socket_io_instance->socket != INVALID_SOCKET)
         {
             // Opening an accepted socket
-            socket_io_instance->on_bytes_received_context = on_bytes_received_context;
-            socket_io_instance->on_bytes_received = on_bytes_received;
-            socket_io_instance->on_io_error = on_io_error;
-            socket_io_instance->on_io_error_context = on_io_error_context;
+            if (reactor_attach(socket_io_instance) != 0)
+            {
+                LogError("reactor_attach failed");
+                result = MU_FAILURE;
+            }
+            else
+            {
+                socket_io_instance->on_bytes_received_context = on_bytes_received_context;
+                socket_io_instance->on_bytes_received = on_bytes_received;
+                socket_io_instance->on_io_error = on_io_error;
+                socket_io_instance->on_io_error_context = on_io_error_context;
 
-            socket_io_instance->io_state = IO_STATE_OPEN;
+                socket_io_instance->io_state = IO_STATE_OPEN;
 
-            result = 0;
+                result = 0;
+            }
         }
         else
         {
@@ -885,6 +1303,14 @@ int socketio_open(CONCRETE_IO_HANDLE socket_io, ON_IO_OPEN_COMPLETE on_io_open_c
             {
                 LogError("wait_for_socket_connection failed");
             } 
+            else if ((socket_io_instance->io_state == IO_STATE_OPEN) && (result = reactor_attach(socket_io_instance)) != 0)
+            {
+                LogError("reactor_attach failed");
+                (void)shutdown(socket_io_instance->socket, SHUT_RDWR);
+                close(socket_io_instance->socket);
+                socket_io_instance->socket = INVALID_SOCKET;
+                socket_io_instance->io_state = IO_STATE_CLOSED;
+            }
             else
             {
                 socket_io_instance->on_bytes_received = on_bytes_received;
@@ -924,6 +1350,7 @@ int socketio_close(CONCRETE_IO_HANDLE socket_io, ON_IO_CLOSE_COMPLETE on_io_clos
         if ((socket_io_instance->io_state != IO_STATE_CLOSED) && (socket_io_instance->io_state != IO_STATE_CLOSING))
         {
             // Only close if the socket isn't already in the closed or closing state
+            reactor_detach(socket_io_instance);
             (void)shutdown(socket_io_instance->socket, SHUT_RDWR);
             close(socket_io_instance->socket);
             socket_io_instance->socket = INVALID_SOCKET;
@@ -941,79 +1368,68 @@ int socketio_close(CONCRETE_IO_HANDLE socket_io, ON_IO_CLOSE_COMPLETE on_io_clos
     return result;
 }
 
-int socketio_send(CONCRETE_IO_HANDLE socket_io, const void* buffer, size_t size, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+/* sends right away when nothing is queued, and queues what the socket did not take */
+static int send_or_queue(SOCKET_IO_INSTANCE* socket_io_instance, const unsigned char* buffer, size_t size, CONSTBUFFER_HANDLE constbuffer, ON_SEND_COMPLETE on_send_complete, void* callback_context)
 {
     int result;
 
-    if ((socket_io == NULL) ||
-        (buffer == NULL) ||
-        (size == 0))
+    if (socket_io_instance->io_state != IO_STATE_OPEN)
     {
-        /* Invalid arguments */
-        LogError("Invalid argument: send given invalid parameter");
+        LogError("Failure: socket state is not opened.");
         result = MU_FAILURE;
     }
     else
     {
-        SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)socket_io;
-        if (socket_io_instance->io_state != IO_STATE_OPEN)
+        LIST_ITEM_HANDLE first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
+        if (first_pending_io != NULL)
         {
-            LogError("Failure: socket state is not opened.");
-            result = MU_FAILURE;
+            if (add_pending_io(socket_io_instance, buffer, size, constbuffer, on_send_complete, callback_context) != 0)
+            {
+                LogError("Failure: add_pending_io failed.");
+                result = MU_FAILURE;
+            }
+            else
+            {
+                result = 0;
+            }
         }
         else
         {
-            LIST_ITEM_HANDLE first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
-            if (first_pending_io != NULL)
+            signal(SIGPIPE, SIG_IGN);
+
+            ssize_t send_result = send(socket_io_instance->socket, buffer, size, MSG_NOSIGNAL);
+            if ((size_t)send_result != size)
             {
-                if (add_pending_io(socket_io_instance, buffer, size, on_send_complete, callback_context) != 0)
+                if (send_result == SOCKET_SEND_FAILURE && errno != EAGAIN && errno != ENOBUFS)
                 {
-                    LogError("Failure: add_pending_io failed.");
+                    LogError("Failure: sending socket failed. errno=%d (%s).", errno, strerror(errno));
                     result = MU_FAILURE;
                 }
                 else
                 {
-                    result = 0;
-                }
-            }
-            else
-            {
-                signal(SIGPIPE, SIG_IGN);
+                    /*send says "come back later" with EAGAIN, ENOBUFS - likely the socket buffer cannot accept more data*/
+                    /* queue data */
+                    size_t bytes_sent = (send_result < 0 ? 0 : send_result);
 
-                ssize_t send_result = send(socket_io_instance->socket, buffer, size, MSG_NOSIGNAL);
-                if ((size_t)send_result != size)
-                {
-                    if (send_result == SOCKET_SEND_FAILURE && errno != EAGAIN && errno != ENOBUFS)
+                    if (add_pending_io(socket_io_instance, buffer + bytes_sent, size - bytes_sent, constbuffer, on_send_complete, callback_context) != 0)
                     {
-                        LogError("Failure: sending socket failed. errno=%d (%s).", errno, strerror(errno));
+                        LogError("Failure: add_pending_io failed.");
                         result = MU_FAILURE;
                     }
                     else
                     {
-                        /*send says "come back later" with EAGAIN, ENOBUFS - likely the socket buffer cannot accept more data*/
-                        /* queue data */
-                        size_t bytes_sent = (send_result < 0 ? 0 : send_result);
-
-                        if (add_pending_io(socket_io_instance, (const unsigned char*)buffer + bytes_sent, size - bytes_sent, on_send_complete, callback_context) != 0)
-                        {
-                            LogError("Failure: add_pending_io failed.");
-                            result = MU_FAILURE;
-                        }
-                        else
-                        {
-                            result = 0;
-                        }
+                        result = 0;
                     }
                 }
-                else
+            }
+            else
+            {
+                if (on_send_complete != NULL)
                 {
-                    if (on_send_complete != NULL)
-                    {
-                        on_send_complete(callback_context, IO_SEND_OK);
-                    }
-
-                    result = 0;
+                    on_send_complete(callback_context, IO_SEND_OK);
                 }
+
+                result = 0;
             }
         }
     }
@@ -1021,101 +1437,175 @@ int socketio_send(CONCRETE_IO_HANDLE socket_io, const void* buffer, size_t size,
     return result;
 }
 
-void socketio_dowork(CONCRETE_IO_HANDLE socket_io)
+int socketio_send(CONCRETE_IO_HANDLE socket_io, const void* buffer, size_t size, ON_SEND_COMPLETE on_send_complete, void* callback_context)
 {
-    if (socket_io != NULL)
+    int result;
+
+    if ((socket_io == NULL) ||
+        (buffer == NULL) ||
+        (size == 0))
     {
-        SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)socket_io;
-        signal(SIGPIPE, SIG_IGN);
+        /* Invalid arguments */
+        LogError("Invalid argument: send given invalid parameter");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        result = send_or_queue((SOCKET_IO_INSTANCE*)socket_io, (const unsigned char*)buffer, size, NULL, on_send_complete, callback_context);
+    }
 
-        if (socket_io_instance->io_state == IO_STATE_OPEN)
+    return result;
+}
+
+int socketio_send_constbuffer(CONCRETE_IO_HANDLE socket_io, CONSTBUFFER_HANDLE buffer, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    int result;
+    const CONSTBUFFER* content;
+
+    if ((socket_io == NULL) ||
+        (buffer == NULL) ||
+        ((content = CONSTBUFFER_GetContent(buffer))->size == 0))
+    {
+        /* Invalid arguments */
+        LogError("Invalid argument: send given invalid parameter");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        result = send_or_queue((SOCKET_IO_INSTANCE*)socket_io, content->buffer, content->size, buffer, on_send_complete, callback_context);
+    }
+
+    return result;
+}
+
+/* the buffers go out in sendmsg iovs where they are, a reference to the array is kept for what the socket does not take right away */
+int socketio_send_array(CONCRETE_IO_HANDLE socket_io, CONSTBUFFER_ARRAY_HANDLE buffers, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    int result;
+    uint32_t buffer_count;
+    uint32_t all_buffers_size;
+
+    if ((socket_io == NULL) ||
+        (buffers == NULL) ||
+        (constbuffer_array_get_buffer_count(buffers, &buffer_count) != 0) ||
+        (constbuffer_array_get_all_buffers_size(buffers, &all_buffers_size) != 0) ||
+        (all_buffers_size == 0))
+    {
+        /* Invalid arguments */
+        LogError("Invalid argument: send given invalid parameter");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)socket_io;
+        if (socket_io_instance->io_state != IO_STATE_OPEN)
         {
-            LIST_ITEM_HANDLE first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
-            while (first_pending_io != NULL)
+            LogError("Failure: socket state is not opened.");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            const CONSTBUFFER* first_content = constbuffer_array_get_buffer_content(buffers, 0);
+            PENDING_SOCKET_IO position;
+            bool sent_all = false;
+
+            position.bytes = first_content->buffer;
+            position.size = first_content->size;
+            position.offset = 0;
+            position.on_send_complete = on_send_complete;
+            position.callback_context = callback_context;
+            position.pending_io_list = NULL;
+            position.constbuffer = NULL;
+            position.constbuffer_array = buffers;
+            position.next_buffer = 1;
+            position.buffer_count = buffer_count;
+
+            result = 0;
+
+            /* nothing queued: send right away, as much as the socket takes */
+            if (singlylinkedlist_get_head_item(socket_io_instance->pending_io_list) == NULL)
             {
-                PENDING_SOCKET_IO* pending_socket_io = (PENDING_SOCKET_IO*)singlylinkedlist_item_get_value(first_pending_io);
-                if (pending_socket_io == NULL)
-                {
-                    indicate_error(socket_io_instance);
-                    LogError("Failure: retrieving socket from list");
-                    break;
-                }
+                signal(SIGPIPE, SIG_IGN);
 
-                ssize_t send_result = send(socket_io_instance->socket, pending_socket_io->bytes, pending_socket_io->size, MSG_NOSIGNAL);
-                if ((send_result < 0) || ((size_t)send_result != pending_socket_io->size))
+                while (!sent_all)
                 {
-                    if (send_result == INVALID_SOCKET)
+                    struct iovec iov[SOCKETIO_MAX_IOV];
+                    struct msghdr message;
+                    size_t total_size = 0;
+                    size_t iov_count = fill_pending_io_iov(&position, iov, SOCKETIO_MAX_IOV, &total_size);
+                    ssize_t send_result;
+                    size_t sent;
+
+                    (void)memset(&message, 0, sizeof(message));
+                    message.msg_iov = iov;
+                    message.msg_iovlen = iov_count;
+                    send_result = sendmsg(socket_io_instance->socket, &message, MSG_NOSIGNAL);
+                    if (send_result < 0)
                     {
-                        if (errno == EAGAIN  || errno == ENOBUFS) /*send says "come back later" with EAGAIN, ENOBUFS - likely the socket buffer cannot accept more data*/
-                        {
-                            /*do nothing until next dowork */
-                            break;
-                        }
-                        else
+                        if (errno != EAGAIN && errno != ENOBUFS)
                         {
-                            free(pending_socket_io->bytes);
-                            free(pending_socket_io);
-                            pending_socket_io = NULL;
-                            (void)singlylinkedlist_remove(socket_io_instance->pending_io_list, first_pending_io);
-
-                            LogError("Failure: sending Socket information. errno=%d (%s).", errno, strerror(errno));
-                            indicate_error(socket_io_instance);
+                            LogError("Failure: sending socket failed. errno=%d (%s).", errno, strerror(errno));
+                            result = MU_FAILURE;
                         }
-                    }
-                    else
-                    {
-                        /* simply wait until next dowork */
-                        (void)memmove(pending_socket_io->bytes, pending_socket_io->bytes + send_result, pending_socket_io->size - send_result);
-                        pending_socket_io->size -= send_result;
+                        /*send says "come back later" with EAGAIN, ENOBUFS - the rest is queued*/
                         break;
                     }
-                }
-                else
-                {
-                    if (pending_socket_io->on_send_complete != NULL)
-                    {
-                        pending_socket_io->on_send_complete(pending_socket_io->callback_context, IO_SEND_OK);
-                    }
 
-                    free(pending_socket_io->bytes);
-                    free(pending_socket_io);
-                    pending_socket_io = NULL;
-                    if (singlylinkedlist_remove(socket_io_instance->pending_io_list, first_pending_io) != 0)
+                    sent = (size_t)send_result;
+                    sent_all = consume_pending_io(&position, &sent);
+                    if ((size_t)send_result < total_size)
                     {
-                        indicate_error(socket_io_instance);
-                        LogError("Failure: unable to remove socket from list");
+                        break;
                     }
                 }
-
-                first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
             }
 
-             if (socket_io_instance->io_state == IO_STATE_OPEN)
+            if (result != 0)
             {
-                ssize_t received = 0;
-                do
+                /* error already logged */
+            }
+            else if (sent_all)
+            {
+                if (on_send_complete != NULL)
                 {
-                    received = recv(socket_io_instance->socket, socket_io_instance->recv_bytes, XIO_RECEIVE_BUFFER_SIZE, MSG_NOSIGNAL);
-                    if (received > 0)
-                    {
-                        if (socket_io_instance->on_bytes_received != NULL)
-                        {
-                            /* Explicitly ignoring here the result of the callback */
-                            (void)socket_io_instance->on_bytes_received(socket_io_instance->on_bytes_received_context, socket_io_instance->recv_bytes, received);
-                        }
-                    }
-                    else if (received == 0)
-                    {
-                        // Do not log error here due to this is probably the socket being closed on the other end
-                        indicate_error(socket_io_instance);
-                    }
-                    else if (received < 0 && errno != EAGAIN)
-                    {
-                        LogError("Socketio_Failure: Receiving data from endpoint: errno=%d.", errno);
-                        indicate_error(socket_io_instance);
-                    }
+                    on_send_complete(callback_context, IO_SEND_OK);
+                }
+            }
+            else if (add_pending_array_io(socket_io_instance, &position) != 0)
+            {
+                LogError("Failure: add_pending_array_io failed.");
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /* sent by socketio_dowork */
+            }
+        }
+    }
+
+    return result;
+}
+
+void socketio_dowork(CONCRETE_IO_HANDLE socket_io)
+{
+    if (socket_io != NULL)
+    {
+        SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)socket_io;
+
+        if (socket_io_instance->io_state == IO_STATE_OPEN)
+        {
+            /* the sockets of a reactor are only sent to and received from when socketio_reactor_dowork reports them ready,
+            so an idle one costs no system call here */
+            if (!socket_io_instance->reactor_attached)
+            {
+                signal(SIGPIPE, SIG_IGN);
 
-                } while (received > 0 && socket_io_instance->io_state == IO_STATE_OPEN);
+                send_pending_io(socket_io_instance);
+
+                if (socket_io_instance->io_state == IO_STATE_OPEN)
+                {
+                    receive_bytes(socket_io_instance);
+                }
             }
         }
         else
@@ -1141,6 +1631,11 @@ void socketio_dowork(CONCRETE_IO_HANDLE socket_io)
                             LogError("Socketio_Failure: wait_for_socket_connection failed");
                             indicate_error(socket_io_instance);
                         }
+                        else if (reactor_attach(socket_io_instance) != 0)
+                        {
+                            LogError("Socketio_Failure: reactor_attach failed");
+                            indicate_error(socket_io_instance);
+                        }
                     }
                 }
 
@@ -1267,6 +1762,23 @@ int socketio_setoption(CONCRETE_IO_HANDLE socket_io, const char* optionName, con
         {
             result = socketio_setaddresstype_option(socket_io_instance, (const char*)value);
         }
+        else if (strcmp(optionName, OPTION_SOCKETIO_REACTOR) == 0)
+        {
+            if (socket_io_instance->io_state != IO_STATE_CLOSED)
+            {
+                LogError("The reactor can only be set in state 'IO_STATE_CLOSED'.  Current state=%d", socket_io_instance->io_state);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                reactor_remove_instance(socket_io_instance);
+                if (value != NULL)
+                {
+                    reactor_add_instance((SOCKETIO_REACTOR_HANDLE)value, socket_io_instance);
+                }
+                result = 0;
+            }
+        }
         else
         {
             result = MU_FAILURE;
@@ -1281,3 +1793,117 @@ const IO_INTERFACE_DESCRIPTION* socketio_get_interface_description(void)
     return &socket_io_interface_description;
 }
 
+SOCKETIO_REACTOR_HANDLE socketio_reactor_create(void)
+{
+    SOCKETIO_REACTOR* result;
+
+#ifdef SOCKETIO_REACTOR_EPOLL
+    result = (SOCKETIO_REACTOR*)malloc(sizeof(SOCKETIO_REACTOR));
+    if (result == NULL)
+    {
+        LogError("Allocation Failure: SOCKETIO_REACTOR");
+    }
+    else if ((result->epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0)
+    {
+        LogError("Failure: epoll_create1 failed. errno=%d (%s).", errno, strerror(errno));
+        free(result);
+        result = NULL;
+    }
+    else
+    {
+        result->instance_count = 0;
+        result->instances = NULL;
+        result->event_count = 0;
+    }
+#else
+    LogError("Failure: socketio reactor is not supported on this platform.");
+    result = NULL;
+#endif
+
+    return result;
+}
+
+void socketio_reactor_destroy(SOCKETIO_REACTOR_HANDLE reactor)
+{
+    if (reactor != NULL)
+    {
+        if (reactor->instance_count != 0)
+        {
+            LogError("The reactor is destroyed with %lu socket IOs still open in it, socketio_dowork polls them from now on.", (unsigned long)reactor->instance_count);
+        }
+
+        /* closing the epoll fd drops the registrations, the socket IOs go back to being polled by socketio_dowork */
+        while (reactor->instances != NULL)
+        {
+            SOCKET_IO_INSTANCE* socket_io_instance = reactor->instances;
+            socket_io_instance->reactor_attached = 0;
+            reactor_remove_instance(socket_io_instance);
+        }
+
+        close(reactor->epoll_fd);
+        free(reactor);
+    }
+}
+
+int socketio_reactor_dowork(SOCKETIO_REACTOR_HANDLE reactor, int timeout_ms)
+{
+    int result;
+
+    if (reactor == NULL)
+    {
+        LogError("Invalid argument: reactor is NULL");
+        result = MU_FAILURE;
+    }
+    else
+    {
+#ifdef SOCKETIO_REACTOR_EPOLL
+        int event_count = epoll_wait(reactor->epoll_fd, reactor->events, SOCKETIO_REACTOR_MAX_EVENTS, timeout_ms);
+        if (event_count < 0)
+        {
+            if (errno == EINTR)
+            {
+                result = 0;
+            }
+            else
+            {
+                LogError("Failure: epoll_wait failed. errno=%d (%s).", errno, strerror(errno));
+                result = MU_FAILURE;
+            }
+        }
+        else
+        {
+            int i;
+
+            reactor->event_count = event_count;
+            for (i = 0; i < event_count; i++)
+            {
+                SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)reactor->events[i].data.ptr;
+                uint32_t events = reactor->events[i].events;
+
+                if ((socket_io_instance != NULL) && (socket_io_instance->io_state == IO_STATE_OPEN) &&
+                    ((events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) != 0))
+                {
+                    send_pending_io(socket_io_instance);
+                }
+
+                /* a send complete callback may have destroyed the instance, in which case its entry was cleared */
+                socket_io_instance = (SOCKET_IO_INSTANCE*)reactor->events[i].data.ptr;
+                if ((socket_io_instance != NULL) && (socket_io_instance->io_state == IO_STATE_OPEN) &&
+                    ((events & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP)) != 0))
+                {
+                    receive_bytes(socket_io_instance);
+                }
+            }
+            reactor->event_count = 0;
+
+            result = 0;
+        }
+#else
+        (void)timeout_ms;
+        LogError("Failure: socketio reactor is not supported on this platform.");
+        result = MU_FAILURE;
+#endif
+    }
+
+    return result;
+}
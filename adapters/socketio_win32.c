@@ -3,6 +3,8 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
 #include <winsock2.h>
 #include <ws2tcpip.h>
 #include <windows.h>
@@ -12,6 +14,7 @@
 #endif
 #include "azure_c_shared_utility/socketio.h"
 #include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/constbuffer_array.h"
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/gbnetwork.h"
 #include "azure_c_shared_utility/optimize_size.h"
@@ -98,7 +101,8 @@ static const IO_INTERFACE_DESCRIPTION socket_io_interface_description =
     socketio_close,
     socketio_send,
     socketio_dowork,
-    socketio_setoption
+    socketio_setoption,
+    socketio_send_array
 };
 
 static void indicate_error(SOCKET_IO_INSTANCE* socket_io_instance)
@@ -618,6 +622,69 @@ int socketio_send(CONCRETE_IO_HANDLE socket_io, const void* buffer, size_t size,
     return result;
 }
 
+int socketio_send_constbuffer(CONCRETE_IO_HANDLE socket_io, CONSTBUFFER_HANDLE buffer, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    int result;
+
+    if (buffer == NULL)
+    {
+        LogError("Invalid argument: buffer is NULL");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* the pending IOs of this implementation are copies, so the buffer goes through socketio_send */
+        const CONSTBUFFER* content = CONSTBUFFER_GetContent(buffer);
+        result = socketio_send(socket_io, content->buffer, content->size, on_send_complete, callback_context);
+    }
+
+    return result;
+}
+
+int socketio_send_array(CONCRETE_IO_HANDLE socket_io, CONSTBUFFER_ARRAY_HANDLE buffers, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    int result;
+    uint32_t buffer_count;
+    uint32_t all_buffers_size;
+
+    if ((buffers == NULL) ||
+        (constbuffer_array_get_buffer_count(buffers, &buffer_count) != 0) ||
+        (constbuffer_array_get_all_buffers_size(buffers, &all_buffers_size) != 0))
+    {
+        LogError("Invalid argument: buffers=%p", buffers);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* the pending IOs of this implementation are copies, so the buffers are copied once, one after the other, and go through socketio_send */
+        unsigned char* bytes = (unsigned char*)malloc(all_buffers_size == 0 ? 1 : all_buffers_size);
+        if (bytes == NULL)
+        {
+            LogError("Failure allocating %" PRIu32 " bytes", all_buffers_size);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            uint32_t i;
+            size_t position = 0;
+            for (i = 0; i < buffer_count; i++)
+            {
+                const CONSTBUFFER* content = constbuffer_array_get_buffer_content(buffers, i);
+                if (content->size > 0)
+                {
+                    (void)memcpy(bytes + position, content->buffer, content->size);
+                    position += content->size;
+                }
+            }
+
+            result = socketio_send(socket_io, bytes, all_buffers_size, on_send_complete, callback_context);
+            free(bytes);
+        }
+    }
+
+    return result;
+}
+
 void socketio_dowork(CONCRETE_IO_HANDLE socket_io)
 {
     if (socket_io != NULL)
@@ -0,0 +1,350 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "azure_c_shared_utility/xlogging.h"
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/crt_abstractions.h"
+
+#include "azure_c_shared_utility/srw_lock.h"
+
+/*
+vocabulary (same as the Windows srw_lock, so that the statistics read the same):
+blaBlaCount = values of counter for event blabla
+blablaCounts = sum of individual blablaCountEnd-blablaCountBegin (always a sum of durations of Counts)
+time = blablaCounts/freq
+
+here a count is a nanosecond of CLOCK_MONOTONIC, so freq is 1000000000
+*/
+
+#define TIME_BETWEEN_STATISTICS_LOG 600 /*in seconds, so every 10 minutes*/
+#define SRW_LOCK_FREQ INT64_C(1000000000)
+
+#define ATOMIC_ADD64(var, value) __sync_add_and_fetch(&(var), (int64_t)(value))
+#define ATOMIC_READ64(var) __sync_add_and_fetch(&(var), 0)
+#define ATOMIC_EXCHANGE64(var, value) (void)__sync_lock_test_and_set(&(var), (int64_t)(value))
+
+typedef struct SRW_LOCK_HANDLE_DATA_TAG
+{
+    pthread_rwlock_t lock;
+
+    volatile int64_t nCalls_AcquireSRWLockExclusive; /*number of calls to pthread_rwlock_wrlock*/
+    volatile int64_t totalCounts_AcquireSRWLockExclusive; /*how many counts were spent taking the lock (that is, just before and after pthread_rwlock_wrlock call*/
+    volatile int64_t totalCounts_ReleaseSRWLockExclusive; /*how many counts were spent releasing the exclusive lock that is, just before and after pthread_rwlock_unlock call*/
+    volatile int64_t lastCount_AcquireSRWLockExclusive; /*last time the lock was taken exclusively*/
+    volatile int64_t totalCountsBetween_AcquireSRWLockExclusive_and_ReleaseSRWLockExclusive; /*how much time the lock was taken in total in exclusive mode*/
+
+    volatile int64_t nCalls_AcquireSRWLockShared; /*number of calls to pthread_rwlock_rdlock*/
+    volatile int64_t totalCounts_AcquireSRWLockShared; /*how many counts were spent taking the lock (that is, just before and after pthread_rwlock_rdlock */
+    volatile int64_t totalCounts_ReleaseSRWLockShared; /*how many counts were spent releasing the shared lock that is, just before and after pthread_rwlock_unlock call*/
+    volatile int64_t nSharedReaders; /*if lock_shared is granted, then there are 1 more readers... when readers gets to 0, the shared "locked" count can be updated*/
+    volatile int64_t firstCount_AcquireSRWLockShared; /*first time the lock was taken in shared mode*/
+    volatile int64_t totalCountsBetween_AcquireSRWLockShared_and_ReleaseSRWLockShared; /*how much time the lock was taken from the first granted shared access to the last released shared access*/
+
+    int64_t handleCreateCount; /*when the handle was created*/
+    volatile int64_t lastStatisticsCount; /*when the statistics were last logged*/
+
+    char* lockName;
+    bool doStatistics;
+
+}SRW_LOCK_HANDLE_DATA;
+
+static int64_t get_count(void)
+{
+    struct timespec now;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((int64_t)now.tv_sec * SRW_LOCK_FREQ) + now.tv_nsec;
+}
+
+static void LogStatistics(SRW_LOCK_HANDLE handle, const char* reason)
+{
+    int64_t now = get_count();
+
+    /*print statistics*/
+
+LogInfo("srw_lock_statistics reason:%s SRW_LOCK_HANDLE handle %p lock_name=%s\n"
+"freq=%" PRId64 ",\n"
+"nCalls_AcquireSRWLockExclusive=%" PRId64 ",\n"
+"totalCounts_AcquireSRWLockExclusive=%" PRId64 ",\n"
+"totalCounts_ReleaseSRWLockExclusive=%" PRId64 ",\n"
+"totalCountsBetween_AcquireSRWLockExclusive_and_ReleaseSRWLockExclusive=%" PRId64 ",\n"
+"nCalls_AcquireSRWLockShared=%" PRId64 ",\n"
+"totalCounts_AcquireSRWLockShared=%" PRId64 ",\n"
+"totalCounts_ReleaseSRWLockShared=%" PRId64 ",\n"
+"totalCountsBetween_AcquireSRWLockShared_and_ReleaseSRWLockShared=%" PRId64 ",\n"
+"totalCountsBetween_Create_and_Now=%" PRId64 ",\n"
+"totalTimeBetween_Create_and_Now[s]=%.2f, \n"
+"totalTimeBetween_AcquireSRWLockExclusive_and_ReleaseSRWLockExclusive[s]=%.2f, \n"
+"totalTimeBetween_AcquireSRWLockExclusive_and_ReleaseSRWLockExclusive[%%]=%.2f, \n"
+"averageTimeBetween_AcquireSRWLockExclusive_and_ReleaseSRWLockExclusive[us]=%.2f, \n"
+"totalTimeBetween_AcquireSRWLockShared_and_ReleaseSRWLockShared[s]=%.2f, \n"
+"totalTimeBetween_AcquireSRWLockShared_and_ReleaseSRWLockShared[%%]=%.2f",
+
+reason,
+(void*)handle,
+handle->lockName,
+SRW_LOCK_FREQ,
+ATOMIC_READ64(handle->nCalls_AcquireSRWLockExclusive),
+ATOMIC_READ64(handle->totalCounts_AcquireSRWLockExclusive),
+ATOMIC_READ64(handle->totalCounts_ReleaseSRWLockExclusive),
+ATOMIC_READ64(handle->totalCountsBetween_AcquireSRWLockExclusive_and_ReleaseSRWLockExclusive),
+ATOMIC_READ64(handle->nCalls_AcquireSRWLockShared),
+ATOMIC_READ64(handle->totalCounts_AcquireSRWLockShared),
+ATOMIC_READ64(handle->totalCounts_ReleaseSRWLockShared),
+ATOMIC_READ64(handle->totalCountsBetween_AcquireSRWLockShared_and_ReleaseSRWLockShared),
+/*"totalTimeBetween_Create_and_Now[s]*/
+now - handle->handleCreateCount,
+(double)(now - handle->handleCreateCount) / (double)SRW_LOCK_FREQ,
+(double)ATOMIC_READ64(handle->totalCountsBetween_AcquireSRWLockExclusive_and_ReleaseSRWLockExclusive) / (double)SRW_LOCK_FREQ,
+(double)ATOMIC_READ64(handle->totalCountsBetween_AcquireSRWLockExclusive_and_ReleaseSRWLockExclusive) / (double)(now - handle->handleCreateCount) * 100,
+(ATOMIC_READ64(handle->nCalls_AcquireSRWLockExclusive) > 0 ? (double)ATOMIC_READ64(handle->totalCountsBetween_AcquireSRWLockExclusive_and_ReleaseSRWLockExclusive) * 1000000 / (double)SRW_LOCK_FREQ / (double)ATOMIC_READ64(handle->nCalls_AcquireSRWLockExclusive) : -1),
+(double)ATOMIC_READ64(handle->totalCountsBetween_AcquireSRWLockShared_and_ReleaseSRWLockShared) / (double)SRW_LOCK_FREQ,
+(double)ATOMIC_READ64(handle->totalCountsBetween_AcquireSRWLockShared_and_ReleaseSRWLockShared) / (double)(now - handle->handleCreateCount) * 100
+);
+
+}
+
+/*piggyback on the lock calls to print the statistics "until now", only one of the threads that find the period elapsed logs*/
+static void log_statistics_if_period_elapsed(SRW_LOCK_HANDLE handle, int64_t now)
+{
+    int64_t last = ATOMIC_READ64(handle->lastStatisticsCount);
+    if ((now - last >= TIME_BETWEEN_STATISTICS_LOG * SRW_LOCK_FREQ) &&
+        __sync_bool_compare_and_swap(&handle->lastStatisticsCount, last, now))
+    {
+        LogStatistics(handle, "periodic logging almost every " MU_TOSTRING(TIME_BETWEEN_STATISTICS_LOG) " seconds");
+    }
+}
+
+static int init_rwlock(pthread_rwlock_t* lock)
+{
+    int result;
+#if defined(__GLIBC__)
+    /*glibc lets a steady flow of readers starve the writers by default, SRWLOCK does not*/
+    pthread_rwlockattr_t attr;
+    if ((result = pthread_rwlockattr_init(&attr)) != 0)
+    {
+        LogError("failure in pthread_rwlockattr_init, result=%d", result);
+    }
+    else
+    {
+        (void)pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+        result = pthread_rwlock_init(lock, &attr);
+        (void)pthread_rwlockattr_destroy(&attr);
+    }
+#else
+    result = pthread_rwlock_init(lock, NULL);
+#endif
+    return result;
+}
+
+SRW_LOCK_HANDLE srw_lock_create(bool do_statistics, const char* lock_name)
+{
+    SRW_LOCK_HANDLE result;
+    /*Codes_SRS_SRW_LOCK_02_001: [ srw_lock_create shall allocate memory for SRW_LOCK_HANDLE. ]*/
+    result = calloc(1, sizeof(SRW_LOCK_HANDLE_DATA));
+    if (result == NULL)
+    {
+        /*return as is*/
+        LogError("failure in malloc(sizeof(SRW_LOCK_HANDLE_DATA)=%zu)", sizeof(SRW_LOCK_HANDLE_DATA));
+    }
+    else
+    {
+        int init_result;
+
+        /*Codes_SRS_SRW_LOCK_02_023: [ If do_statistics is true then srw_lock_create shall copy lock_name. ]*/
+        if (do_statistics &&
+            (mallocAndStrcpy_s(&result->lockName, MU_P_OR_NULL(lock_name)) != 0)
+            )
+        {
+            LogError("failure in mallocAndStrcpy_s(lock_name=%s)", MU_P_OR_NULL(lock_name));
+        }
+        /*Codes_SRS_SRW_LOCK_01_001: [ srw_lock_create shall call pthread_rwlock_init. ]*/
+        else if ((init_result = init_rwlock(&result->lock)) != 0)
+        {
+            LogError("failure in pthread_rwlock_init, result=%d", init_result);
+            free(result->lockName);
+        }
+        else
+        {
+            result->doStatistics = do_statistics;
+            result->handleCreateCount = get_count();
+            /*Codes_SRS_SRW_LOCK_01_002: [ If do_statistics is true then srw_lock_create shall start counting TIME_BETWEEN_STATISTICS_LOG seconds from the creation of the lock. ]*/
+            result->lastStatisticsCount = result->handleCreateCount;
+
+            if (do_statistics)
+            {
+                LogInfo("srw_lock_create returns %p for lock_name=%s", (void*)result, MU_P_OR_NULL(lock_name));
+            }
+            /*Codes_SRS_SRW_LOCK_02_003: [ srw_lock_create shall succeed and return a non-NULL value. ]*/
+            goto allOk;
+        }
+        /*Codes_SRS_SRW_LOCK_02_004: [ If there are any failures then srw_lock_create shall fail and return NULL. ]*/
+        free(result);
+        result = NULL;
+    }
+allOk:;
+    return result;
+}
+
+void srw_lock_acquire_exclusive(SRW_LOCK_HANDLE handle)
+{
+    /*Codes_SRS_SRW_LOCK_02_022: [ If handle is NULL then srw_lock_acquire_exclusive shall return. ]*/
+    if (handle == NULL)
+    {
+        LogError("invalid argument SRW_LOCK_HANDLE handle=%p", (void*)handle);
+    }
+    else
+    {
+        if (!handle->doStatistics)
+        {
+            /*Codes_SRS_SRW_LOCK_01_003: [ srw_lock_acquire_exclusive shall call pthread_rwlock_wrlock. ]*/
+            (void)pthread_rwlock_wrlock(&handle->lock);
+        }
+        else
+        {
+            int64_t start, stop;
+            start = get_count();
+            /*Codes_SRS_SRW_LOCK_01_003: [ srw_lock_acquire_exclusive shall call pthread_rwlock_wrlock. ]*/
+            (void)pthread_rwlock_wrlock(&handle->lock);
+            stop = get_count(); /*measure acquire time*/
+
+            (void)ATOMIC_ADD64(handle->nCalls_AcquireSRWLockExclusive, 1);
+            (void)ATOMIC_ADD64(handle->totalCounts_AcquireSRWLockExclusive, stop - start);
+
+            /*Codes_SRS_SRW_LOCK_02_025: [ If do_statistics is true and if the timer created has recorded more than TIME_BETWEEN_STATISTICS_LOG seconds then statistics will be logged and the timer shall be started again. ]*/
+            log_statistics_if_period_elapsed(handle, stop);
+
+            ATOMIC_EXCHANGE64(handle->lastCount_AcquireSRWLockExclusive, stop);
+        }
+    }
+}
+
+void srw_lock_release_exclusive(SRW_LOCK_HANDLE handle)
+{
+    /*Codes_SRS_SRW_LOCK_02_009: [ If handle is NULL then srw_lock_release_exclusive shall return. ]*/
+    if (handle == NULL)
+    {
+        LogError("invalid argument SRW_LOCK_HANDLE handle=%p", (void*)handle);
+    }
+    else
+    {
+        if (!handle->doStatistics)
+        {
+            /*Codes_SRS_SRW_LOCK_01_004: [ srw_lock_release_exclusive shall call pthread_rwlock_unlock. ]*/
+            (void)pthread_rwlock_unlock(&handle->lock);
+        }
+        else
+        {
+            int64_t start, stop;
+            int64_t lastAcquireCount_exclusive_copy = ATOMIC_READ64(handle->lastCount_AcquireSRWLockExclusive);
+
+            start = get_count();
+            /*Codes_SRS_SRW_LOCK_01_004: [ srw_lock_release_exclusive shall call pthread_rwlock_unlock. ]*/
+            (void)pthread_rwlock_unlock(&handle->lock);
+            stop = get_count(); /*measure release time*/
+
+            (void)ATOMIC_ADD64(handle->totalCounts_ReleaseSRWLockExclusive, stop - start);
+            (void)ATOMIC_ADD64(handle->totalCountsBetween_AcquireSRWLockExclusive_and_ReleaseSRWLockExclusive, stop - lastAcquireCount_exclusive_copy);
+        }
+    }
+}
+
+void srw_lock_acquire_shared(SRW_LOCK_HANDLE handle)
+{
+    /*Codes_SRS_SRW_LOCK_02_017: [ If handle is NULL then srw_lock_acquire_shared shall return. ]*/
+    if (handle == NULL)
+    {
+        LogError("invalid argument SRW_LOCK_HANDLE handle=%p", (void*)handle);
+    }
+    else
+    {
+        if (!handle->doStatistics)
+        {
+            /*Codes_SRS_SRW_LOCK_01_005: [ srw_lock_acquire_shared shall call pthread_rwlock_rdlock. ]*/
+            (void)pthread_rwlock_rdlock(&handle->lock);
+        }
+        else
+        {
+            int64_t start, stop;
+
+            start = get_count();
+            /*Codes_SRS_SRW_LOCK_01_005: [ srw_lock_acquire_shared shall call pthread_rwlock_rdlock. ]*/
+            (void)pthread_rwlock_rdlock(&handle->lock);
+            stop = get_count(); /*measure acquire time*/
+
+            /*there is one more shared reader*/
+            /*is this the first reader?*/
+            if (ATOMIC_ADD64(handle->nSharedReaders, 1) == 1)
+            {
+                ATOMIC_EXCHANGE64(handle->firstCount_AcquireSRWLockShared, stop);
+            }
+
+            (void)ATOMIC_ADD64(handle->nCalls_AcquireSRWLockShared, 1);
+            (void)ATOMIC_ADD64(handle->totalCounts_AcquireSRWLockShared, stop - start);
+
+            /*Codes_SRS_SRW_LOCK_02_026: [ If do_statistics is true and the timer created has recorded more than TIME_BETWEEN_STATISTICS_LOG seconds then statistics will be logged and the timer shall be started again. ]*/
+            log_statistics_if_period_elapsed(handle, stop);
+        }
+    }
+}
+
+void srw_lock_release_shared(SRW_LOCK_HANDLE handle)
+{
+    /*Codes_SRS_SRW_LOCK_02_020: [ If handle is NULL then srw_lock_release_shared shall return. ]*/
+    if (handle == NULL)
+    {
+        LogError("invalid argument SRW_LOCK_HANDLE handle=%p", (void*)handle);
+    }
+    else
+    {
+        if (!handle->doStatistics)
+        {
+            /*Codes_SRS_SRW_LOCK_01_006: [ srw_lock_release_shared shall call pthread_rwlock_unlock. ]*/
+            (void)pthread_rwlock_unlock(&handle->lock);
+        }
+        else
+        {
+            int64_t start, stop;
+            int64_t firstCount_AcquireSRWLockShared_copy = ATOMIC_READ64(handle->firstCount_AcquireSRWLockShared);
+
+            start = get_count();
+            /*Codes_SRS_SRW_LOCK_01_006: [ srw_lock_release_shared shall call pthread_rwlock_unlock. ]*/
+            (void)pthread_rwlock_unlock(&handle->lock);
+            stop = get_count(); /*measure release time*/
+
+            if (ATOMIC_ADD64(handle->nSharedReaders, -1) == 0)
+            {
+                (void)ATOMIC_ADD64(handle->totalCountsBetween_AcquireSRWLockShared_and_ReleaseSRWLockShared, stop - firstCount_AcquireSRWLockShared_copy);
+            }
+
+            (void)ATOMIC_ADD64(handle->totalCounts_ReleaseSRWLockShared, stop - start);
+        }
+    }
+}
+
+void srw_lock_destroy(SRW_LOCK_HANDLE handle)
+{
+    /*Codes_SRS_SRW_LOCK_02_011: [ If handle is NULL then srw_lock_destroy shall return. ]*/
+    if (handle == NULL)
+    {
+        LogError("invalid arguments SRW_LOCK_HANDLE handle=%p", (void*)handle);
+    }
+    else
+    {
+        if (handle->doStatistics)
+        {
+            LogStatistics(handle, "srw_lock_destroy was called");
+            free(handle->lockName);
+        }
+
+        /*Codes_SRS_SRW_LOCK_02_012: [ srw_lock_destroy shall free all used resources. ]*/
+        /*Codes_SRS_SRW_LOCK_01_007: [ srw_lock_destroy shall call pthread_rwlock_destroy. ]*/
+        (void)pthread_rwlock_destroy(&handle->lock);
+        free(handle);
+    }
+}
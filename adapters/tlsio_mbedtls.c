@@ -6,6 +6,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <time.h>
 
 #define TLSIO_MBEDTLS_VERSION_2_16_0   0x02160000
 #define TLSIO_MBEDTLS_VERSION_3_0_0    0x03000000
@@ -31,11 +32,15 @@
 #include "azure_c_shared_utility/shared_util_options.h"
 #include "azure_c_shared_utility/threadapi.h"
 #include "azure_c_shared_utility/safe_math.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/tickcounter.h"
 
 static const char *const OPTION_UNDERLYING_IO_OPTIONS = "underlying_io_options";
 
 #define HANDSHAKE_TIMEOUT_MS 5000
 #define HANDSHAKE_WAIT_INTERVAL_MS 10
+// the hosts a session is kept for, the least recently saved is dropped first
+#define TLSIO_MBEDTLS_SESSION_CACHE_SIZE 16
 
 typedef enum TLSIO_STATE_ENUM_TAG
 {
@@ -88,8 +93,32 @@ typedef struct TLS_IO_INSTANCE_TAG
     char* x509_private_key;
 
     int tls_status;
+
+    int port;
+    bool is_session_cache_enabled;
+    bool is_session_offered;
+    bool is_certificate_verified;
 } TLS_IO_INSTANCE;
 
+// The last session of the connections to a host, resumed by the next one (OPTION_TLS_SESSION_CACHE).
+// A session is only resumed by a connection with the same certificates as the one it was made by.
+typedef struct SSL_SESSION_CACHE_ENTRY_TAG
+{
+    struct SSL_SESSION_CACHE_ENTRY_TAG* next;
+    char* hostname;
+    int port;
+    char* trusted_certificates;
+    char* x509_certificate;
+    mbedtls_ssl_session session;
+} SSL_SESSION_CACHE_ENTRY;
+
+// guards the session cache and the handshake statistics
+static LOCK_HANDLE tlsio_mbedtls_lock = NULL;
+static SSL_SESSION_CACHE_ENTRY* ssl_session_cache = NULL;
+static size_t ssl_session_cache_count = 0;
+static TICK_COUNTER_HANDLE handshake_tick_counter = NULL;
+static TLSIO_HANDSHAKE_STATISTICS handshake_statistics;
+
 typedef enum TLS_STATE_TAG
 {
     TLS_STATE_NOT_INITIALIZED,
@@ -117,6 +146,211 @@ static void indicate_open_complete(TLS_IO_INSTANCE *tls_io_instance, IO_OPEN_RES
     }
 }
 
+static bool are_equal_session_keys(const char* left, const char* right)
+{
+    return (left == NULL) ? (right == NULL) : ((right != NULL) && (strcmp(left, right) == 0));
+}
+
+// called with tlsio_mbedtls_lock held
+static SSL_SESSION_CACHE_ENTRY** find_session(const TLS_IO_INSTANCE* tls_io_instance)
+{
+    SSL_SESSION_CACHE_ENTRY** result;
+
+    for (result = &ssl_session_cache; *result != NULL; result = &(*result)->next)
+    {
+        if (((*result)->port == tls_io_instance->port) &&
+            (strcmp((*result)->hostname, tls_io_instance->hostname) == 0) &&
+            are_equal_session_keys((*result)->trusted_certificates, tls_io_instance->trusted_certificates) &&
+            are_equal_session_keys((*result)->x509_certificate, tls_io_instance->x509_certificate))
+        {
+            break;
+        }
+    }
+
+    return result;
+}
+
+static void destroy_session(SSL_SESSION_CACHE_ENTRY* entry)
+{
+    mbedtls_ssl_session_free(&entry->session);
+    free(entry->hostname);
+    free(entry->trusted_certificates);
+    free(entry->x509_certificate);
+    free(entry);
+}
+
+static void clear_session_cache(void)
+{
+    while (ssl_session_cache != NULL)
+    {
+        SSL_SESSION_CACHE_ENTRY* entry = ssl_session_cache;
+        ssl_session_cache = entry->next;
+        destroy_session(entry);
+    }
+    ssl_session_cache_count = 0;
+}
+
+// sets the saved session of the host on the SSL context of a new connection, the server decides whether it resumes it
+static void offer_session(TLS_IO_INSTANCE* tls_io_instance)
+{
+    tls_io_instance->is_session_offered = false;
+    tls_io_instance->is_certificate_verified = false;
+
+    if (!tls_io_instance->is_session_cache_enabled)
+    {
+        // full handshake
+    }
+    else if (Lock(tlsio_mbedtls_lock) != LOCK_OK)
+    {
+        LogError("Failed to lock the session cache.");
+    }
+    else
+    {
+        SSL_SESSION_CACHE_ENTRY** entry = find_session(tls_io_instance);
+
+        if (*entry == NULL)
+        {
+            // first connection to the host
+        }
+        else if (mbedtls_ssl_set_session(&tls_io_instance->ssl, &(*entry)->session) != 0)
+        {
+            LogError("Failed setting the saved session.");
+        }
+        else
+        {
+            tls_io_instance->is_session_offered = true;
+        }
+
+        (void)Unlock(tlsio_mbedtls_lock);
+    }
+}
+
+// keeps the session of a connection that just completed its handshake for the next connection to the host
+static void save_session(TLS_IO_INSTANCE* tls_io_instance)
+{
+    SSL_SESSION_CACHE_ENTRY* new_entry = (SSL_SESSION_CACHE_ENTRY*)calloc(1, sizeof(SSL_SESSION_CACHE_ENTRY));
+
+    if (new_entry == NULL)
+    {
+        LogError("Failed allocating the session cache entry.");
+    }
+    else
+    {
+        // the session is copied before taking the lock, this allocates
+        mbedtls_ssl_session_init(&new_entry->session);
+
+        if (mbedtls_ssl_get_session(&tls_io_instance->ssl, &new_entry->session) != 0)
+        {
+            LogInfo("The server gave no session to save.");
+            destroy_session(new_entry);
+        }
+        else if (Lock(tlsio_mbedtls_lock) != LOCK_OK)
+        {
+            LogError("Failed to lock the session cache.");
+            destroy_session(new_entry);
+        }
+        else
+        {
+            SSL_SESSION_CACHE_ENTRY** existing_entry = find_session(tls_io_instance);
+
+            if (*existing_entry != NULL)
+            {
+                SSL_SESSION_CACHE_ENTRY* entry = *existing_entry;
+
+                // the newest session replaces the one of the previous connection, and the host goes first
+                mbedtls_ssl_session_free(&entry->session);
+                entry->session = new_entry->session;
+                mbedtls_ssl_session_init(&new_entry->session);
+                *existing_entry = entry->next;
+                entry->next = ssl_session_cache;
+                ssl_session_cache = entry;
+                destroy_session(new_entry);
+            }
+            else if ((mallocAndStrcpy_s(&new_entry->hostname, tls_io_instance->hostname) != 0) ||
+                ((tls_io_instance->trusted_certificates != NULL) && (mallocAndStrcpy_s(&new_entry->trusted_certificates, tls_io_instance->trusted_certificates) != 0)) ||
+                ((tls_io_instance->x509_certificate != NULL) && (mallocAndStrcpy_s(&new_entry->x509_certificate, tls_io_instance->x509_certificate) != 0)))
+            {
+                LogError("Failed copying the host and certificates of the session.");
+                destroy_session(new_entry);
+            }
+            else
+            {
+                new_entry->port = tls_io_instance->port;
+                new_entry->next = ssl_session_cache;
+                ssl_session_cache = new_entry;
+                ssl_session_cache_count++;
+
+                if (ssl_session_cache_count > TLSIO_MBEDTLS_SESSION_CACHE_SIZE)
+                {
+                    SSL_SESSION_CACHE_ENTRY** oldest_entry = &ssl_session_cache;
+                    while ((*oldest_entry)->next != NULL)
+                    {
+                        oldest_entry = &(*oldest_entry)->next;
+                    }
+                    destroy_session(*oldest_entry);
+                    *oldest_entry = NULL;
+                    ssl_session_cache_count--;
+                }
+            }
+
+            (void)Unlock(tlsio_mbedtls_lock);
+        }
+    }
+}
+
+// mbedTLS only verifies the server certificate in a full handshake, a resumed one has none
+static int on_verify_certificate(void* context, mbedtls_x509_crt* certificate, int depth, uint32_t* flags)
+{
+    TLS_IO_INSTANCE* tls_io_instance = (TLS_IO_INSTANCE*)context;
+    (void)certificate;
+    (void)depth;
+    (void)flags;
+    tls_io_instance->is_certificate_verified = true;
+    return 0;
+}
+
+static void add_handshake_statistics(TLS_IO_INSTANCE* tls_io_instance, tickcounter_ms_t start_ms, clock_t cpu_time)
+{
+    if (tlsio_mbedtls_lock != NULL)
+    {
+        uint64_t time_ms;
+        uint64_t cpu_time_us = (uint64_t)cpu_time * 1000000 / CLOCKS_PER_SEC;
+        tickcounter_ms_t now_ms;
+
+        if ((handshake_tick_counter == NULL) ||
+            (tickcounter_get_current_ms(handshake_tick_counter, &now_ms) != 0))
+        {
+            time_ms = 0;
+        }
+        else
+        {
+            time_ms = (uint64_t)(now_ms - start_ms);
+        }
+
+        if (Lock(tlsio_mbedtls_lock) != LOCK_OK)
+        {
+            LogError("Failed to lock the handshake statistics.");
+        }
+        else
+        {
+            handshake_statistics.handshake_count++;
+            handshake_statistics.handshake_time_ms += time_ms;
+            handshake_statistics.handshake_cpu_time_us += cpu_time_us;
+            if (tls_io_instance->is_session_offered)
+            {
+                handshake_statistics.session_offer_count++;
+                if (!tls_io_instance->is_certificate_verified)
+                {
+                    handshake_statistics.resumed_handshake_count++;
+                    handshake_statistics.resumed_handshake_time_ms += time_ms;
+                    handshake_statistics.resumed_handshake_cpu_time_us += cpu_time_us;
+                }
+            }
+            (void)Unlock(tlsio_mbedtls_lock);
+        }
+    }
+}
+
 static int decode_ssl_received_bytes(TLS_IO_INSTANCE *tls_io_instance)
 {
     int result = 0;
@@ -183,6 +417,14 @@ static void on_underlying_io_open_complete(void *context, IO_OPEN_RESULT open_re
         }
         else
         {
+            tickcounter_ms_t handshake_start_ms = 0;
+            clock_t handshake_cpu_time_start = clock();
+
+            if (handshake_tick_counter != NULL)
+            {
+                (void)tickcounter_get_current_ms(handshake_tick_counter, &handshake_start_ms);
+            }
+
             tls_io_instance->tlsio_state = TLSIO_STATE_IN_HANDSHAKE;
 
             do
@@ -192,6 +434,12 @@ static void on_underlying_io_open_complete(void *context, IO_OPEN_RESULT open_re
 
             if (result == 0)
             {
+                // the handshake runs here to completion, its CPU time includes waiting for the server in on_io_recv
+                add_handshake_statistics(tls_io_instance, handshake_start_ms, clock() - handshake_cpu_time_start);
+                if (tls_io_instance->is_session_cache_enabled)
+                {
+                    save_session(tls_io_instance);
+                }
                 tls_io_instance->tlsio_state = TLSIO_STATE_OPEN;
                 indicate_open_complete(tls_io_instance, IO_OPEN_OK);
             }
@@ -533,6 +781,77 @@ static void mbedtls_init(TLS_IO_INSTANCE *tls_io_instance)
     }
 }
 
+int tlsio_mbedtls_init(void)
+{
+    int result;
+
+    if (tlsio_mbedtls_lock != NULL)
+    {
+        // already initialized
+        result = 0;
+    }
+    else if ((tlsio_mbedtls_lock = Lock_Init()) == NULL)
+    {
+        LogError("Failed creating the tlsio_mbedtls lock.");
+        result = MU_FAILURE;
+    }
+    else if ((handshake_tick_counter = tickcounter_create()) == NULL)
+    {
+        LogError("Failed creating the handshake tick counter.");
+        (void)Lock_Deinit(tlsio_mbedtls_lock);
+        tlsio_mbedtls_lock = NULL;
+        result = MU_FAILURE;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+void tlsio_mbedtls_deinit(void)
+{
+    if (tlsio_mbedtls_lock != NULL)
+    {
+        clear_session_cache();
+        tickcounter_destroy(handshake_tick_counter);
+        handshake_tick_counter = NULL;
+        (void)Lock_Deinit(tlsio_mbedtls_lock);
+        tlsio_mbedtls_lock = NULL;
+        (void)memset(&handshake_statistics, 0, sizeof(handshake_statistics));
+    }
+}
+
+int tlsio_mbedtls_get_handshake_statistics(TLSIO_HANDSHAKE_STATISTICS* statistics)
+{
+    int result;
+
+    if (statistics == NULL)
+    {
+        LogError("Invalid parameter specified statistics: NULL");
+        result = MU_FAILURE;
+    }
+    else if (tlsio_mbedtls_lock == NULL)
+    {
+        LogError("tlsio_mbedtls_init was not called");
+        result = MU_FAILURE;
+    }
+    else if (Lock(tlsio_mbedtls_lock) != LOCK_OK)
+    {
+        LogError("Failed to lock the handshake statistics.");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        *statistics = handshake_statistics;
+        (void)Unlock(tlsio_mbedtls_lock);
+        result = 0;
+    }
+
+    return result;
+}
+
 CONCRETE_IO_HANDLE tlsio_mbedtls_create(void *io_create_parameters)
 {
     TLSIO_CONFIG *tls_io_config = (TLSIO_CONFIG *)io_create_parameters;
@@ -594,6 +913,7 @@ CONCRETE_IO_HANDLE tlsio_mbedtls_create(void *io_create_parameters)
                     mbedtls_init((void*)result);
                     result->tlsio_state = TLSIO_STATE_NOT_OPEN;
                     result->invoke_on_send_complete_callback_for_fragments = tls_io_config->invoke_on_send_complete_callback_for_fragments;
+                    result->port = tls_io_config->port;
                 }
             }
         }
@@ -676,6 +996,7 @@ int tlsio_mbedtls_open(CONCRETE_IO_HANDLE tls_io, ON_IO_OPEN_COMPLETE on_io_open
             tls_io_instance->tlsio_state = TLSIO_STATE_OPENING_UNDERLYING_IO;
 
             mbedtls_ssl_session_reset(&tls_io_instance->ssl);
+            offer_session(tls_io_instance);
 
             if (xio_open(tls_io_instance->socket_io, on_underlying_io_open_complete, tls_io_instance, on_underlying_io_bytes_received, tls_io_instance, on_underlying_io_error, tls_io_instance) != 0)
             {
@@ -890,6 +1211,17 @@ static void *tlsio_mbedtls_CloneOption(const char *name, const void *value)
                 /*return as is*/
             }
         }
+        else if (strcmp(name, OPTION_TLS_SESSION_CACHE) == 0)
+        {
+            if ((result = malloc(sizeof(bool))) == NULL)
+            {
+                LogError("unable to malloc tls_session_cache value");
+            }
+            else
+            {
+                *(bool*)result = *(const bool*)value;
+            }
+        }
         else
         {
             LogError("not handled option : %s", name);
@@ -914,7 +1246,8 @@ static void tlsio_mbedtls_DestroyOption(const char *name, const void *value)
             (strcmp(name, SU_OPTION_X509_CERT) == 0) ||
             (strcmp(name, SU_OPTION_X509_PRIVATE_KEY) == 0) ||
             (strcmp(name, OPTION_X509_ECC_CERT) == 0) ||
-            (strcmp(name, OPTION_X509_ECC_KEY) == 0)
+            (strcmp(name, OPTION_X509_ECC_KEY) == 0) ||
+            (strcmp(name, OPTION_TLS_SESSION_CACHE) == 0)
             )
         {
             free((void*)value);
@@ -1099,6 +1432,29 @@ int tlsio_mbedtls_setoption(CONCRETE_IO_HANDLE tls_io, const char *optionName, c
                 result = 0;
             }
         }
+        else if (strcmp(optionName, OPTION_TLS_SESSION_CACHE) == 0)
+        {
+            if (value == NULL)
+            {
+                LogError("Invalid value set for tls session cache");
+                result = MU_FAILURE;
+            }
+            else if (tlsio_mbedtls_lock == NULL)
+            {
+                LogError("tlsio_mbedtls_init was not called, there is no session cache");
+                result = MU_FAILURE;
+            }
+            else
+            {
+                tls_io_instance->is_session_cache_enabled = *((bool*)(value));
+                if (tls_io_instance->is_session_cache_enabled)
+                {
+                    // tells a resumed handshake from a full one, the certificate is still verified by mbedTLS
+                    mbedtls_ssl_conf_verify(&tls_io_instance->config, on_verify_certificate, tls_io_instance);
+                }
+                result = 0;
+            }
+        }
         else
         {
             // tls_io_instance->socket_io is never NULL
@@ -1165,6 +1521,13 @@ OPTIONHANDLER_HANDLE tlsio_mbedtls_retrieveoptions(CONCRETE_IO_HANDLE handle)
                     OptionHandler_Destroy(result);
                     result = NULL;
                 }
+                else if (tls_io_instance->is_session_cache_enabled &&
+                         OptionHandler_AddOption(result, OPTION_TLS_SESSION_CACHE, &tls_io_instance->is_session_cache_enabled) != OPTIONHANDLER_OK)
+                {
+                    LogError("unable to save tls_session_cache option");
+                    OptionHandler_Destroy(result);
+                    result = NULL;
+                }
                 else
                 {
                     // all is fine, all interesting options have been saved
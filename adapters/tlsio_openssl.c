@@ -8,8 +8,11 @@
 #include "openssl/opensslv.h"
 #include "openssl/engine.h"
 #include <stdio.h>
+#include <string.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <limits.h>
+#include <time.h>
 #include "azure_c_shared_utility/lock.h"
 #include "azure_c_shared_utility/tlsio.h"
 #include "azure_c_shared_utility/tlsio_openssl.h"
@@ -22,6 +25,13 @@
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/const_defines.h"
 #include "azure_c_shared_utility/safe_math.h"
+#include "azure_c_shared_utility/tickcounter.h"
+#include "azure_c_shared_utility/refcount.h"
+
+#if (OPENSSL_VERSION_NUMBER >= 0x10100000L)
+/* OpenSSL writes the records straight to the underlying IO, see underlying_io_bio_write */
+#define TLSIO_OPENSSL_SEND_FROM_BIO
+#endif
 
 typedef enum TLSIO_STATE_TAG
 {
@@ -81,8 +91,74 @@ typedef struct TLS_IO_INSTANCE_TAG
     bool ignore_host_name_check;
     ENGINE* engine;
     OPTION_OPENSSL_KEY_TYPE x509_private_key_type;
+    unsigned char* receive_buffer;
+    size_t receive_buffer_size;
+    /* gathers the small buffers of tlsio_openssl_send_array, TLSIO_OPENSSL_SEND_ARRAY_RECORD_SIZE bytes allocated on its first use */
+    unsigned char* send_array_buffer;
+    struct SSL_CONTEXT_CACHE_ENTRY_TAG* ssl_context_entry;
+    int port;
+    bool is_session_cache_enabled;
+    bool is_session_offered;
+    tickcounter_ms_t handshake_start_ms;
+    clock_t handshake_cpu_time;
+#ifdef TLSIO_OPENSSL_SEND_FROM_BIO
+    /* false when the out BIO is a memory BIO, see create_openssl_instance */
+    bool is_sending_from_bio;
+    /* the records written by the out BIO and how many of them the underlying IO completed, see write_outgoing_bytes */
+    uint64_t sent_record_count;
+    uint64_t completed_record_count;
+    IO_SEND_RESULT record_send_result;
+    struct PENDING_SEND_COMPLETE_TAG* pending_send_completes;
+    struct PENDING_SEND_COMPLETE_TAG* last_pending_send_complete;
+#endif
 } TLS_IO_INSTANCE;
 
+#ifdef TLSIO_OPENSSL_SEND_FROM_BIO
+/* the on_send_complete of a tlsio_openssl_send whose records the underlying IO has not completed yet */
+typedef struct PENDING_SEND_COMPLETE_TAG
+{
+    struct PENDING_SEND_COMPLETE_TAG* next;
+    uint64_t record_count;
+    ON_SEND_COMPLETE on_send_complete;
+    void* callback_context;
+} PENDING_SEND_COMPLETE;
+#endif
+
+/* An SSL_CTX shared by the instances opened with the same options, see acquire_ssl_context */
+typedef struct SSL_CONTEXT_CACHE_ENTRY_TAG
+{
+    struct SSL_CONTEXT_CACHE_ENTRY_TAG* next;
+    SSL_CTX* ssl_context;
+    ENGINE* engine;
+    /* atomic, the contexts left by tlsio_openssl_deinit are released without the lock */
+    COUNT_TYPE ref_count;
+    bool is_cached;
+    /* the options the context was created with */
+    TLSIO_VERSION tls_version;
+    char* certificate;
+    char* cipher_list;
+    char* x509_certificate;
+    char* x509_private_key;
+    char* engine_id;
+    OPTION_OPENSSL_KEY_TYPE x509_private_key_type;
+    TLS_CERTIFICATE_VALIDATION_CALLBACK tls_validation_callback;
+    void* tls_validation_callback_data;
+} SSL_CONTEXT_CACHE_ENTRY;
+
+/* The last session of the connections to a host, resumed by the next one (OPTION_TLS_SESSION_CACHE).
+A session is only resumed with the SSL_CTX it was made with, which the entry keeps a reference to.
+OpenSSL does not verify the server again when it resumes a session, so a session made without the host name check
+(and without verifying the peer, see enable_domain_check) is only resumed by connections that skip the check too. */
+typedef struct SSL_SESSION_CACHE_ENTRY_TAG
+{
+    struct SSL_SESSION_CACHE_ENTRY_TAG* next;
+    SSL_CONTEXT_CACHE_ENTRY* ssl_context_entry;
+    char* hostname;
+    int port;
+    bool ignore_host_name_check;
+    SSL_SESSION* session;
+} SSL_SESSION_CACHE_ENTRY;
+
 struct CRYPTO_dynlock_value
 {
     LOCK_HANDLE lock;
@@ -90,6 +166,12 @@ struct CRYPTO_dynlock_value
 
 static const char* const OPTION_UNDERLYING_IO_OPTIONS = "underlying_io_options";
 #define SSL_DO_HANDSHAKE_SUCCESS 1
+/* the largest TLS record payload, so that a record is decrypted and indicated in one go */
+#define TLSIO_OPENSSL_DEFAULT_RECEIVE_BUFFER_SIZE (16 * 1024)
+/* the hosts a session is kept for, the least recently saved is dropped first */
+#define TLSIO_OPENSSL_SESSION_CACHE_SIZE 64
+/* the buffers of tlsio_openssl_send_array smaller than this are gathered into records of up to this size instead of one record each */
+#define TLSIO_OPENSSL_SEND_ARRAY_RECORD_SIZE (16 * 1024)
 
 
 /*this function will clone an option given by name and value*/
@@ -242,6 +324,36 @@ static void* tlsio_openssl_CloneOption(const char* name, const void* value)
                 /*return as is*/
             }
         }
+        else if (strcmp(name, OPTION_TLS_RECEIVE_BUFFER_SIZE) == 0)
+        {
+            size_t* value_clone;
+
+            if ((value_clone = (size_t*)malloc(sizeof(size_t))) == NULL)
+            {
+                LogError("Failed cloning tls_receive_buffer_size option");
+            }
+            else
+            {
+                *value_clone = *(const size_t*)value;
+            }
+
+            result = value_clone;
+        }
+        else if (strcmp(name, OPTION_TLS_SESSION_CACHE) == 0)
+        {
+            bool* value_clone;
+
+            if ((value_clone = (bool*)malloc(sizeof(bool))) == NULL)
+            {
+                LogError("Failed cloning tls_session_cache option");
+            }
+            else
+            {
+                *value_clone = *(const bool*)value;
+            }
+
+            result = value_clone;
+        }
         else if (strcmp(name, OPTION_OPENSSL_PRIVATE_KEY_TYPE) == 0)
         {
             OPTION_OPENSSL_KEY_TYPE key_type_value = *((OPTION_OPENSSL_KEY_TYPE*)value);
@@ -288,7 +400,9 @@ static void tlsio_openssl_DestroyOption(const char* name, const void* value)
             (strcmp(name, OPTION_X509_ECC_KEY) == 0) ||
             (strcmp(name, OPTION_TLS_VERSION) == 0) || 
             (strcmp(name, OPTION_OPENSSL_ENGINE) == 0) || 
-            (strcmp(name, OPTION_OPENSSL_PRIVATE_KEY_TYPE) == 0)
+            (strcmp(name, OPTION_OPENSSL_PRIVATE_KEY_TYPE) == 0) ||
+            (strcmp(name, OPTION_TLS_RECEIVE_BUFFER_SIZE) == 0) ||
+            (strcmp(name, OPTION_TLS_SESSION_CACHE) == 0)
            )
         {
             free((void*)value);
@@ -401,6 +515,24 @@ static OPTIONHANDLER_HANDLE tlsio_openssl_retrieveoptions(CONCRETE_IO_HANDLE han
                     OptionHandler_Destroy(result);
                     result = NULL;
                 }
+                else if (
+                    (tls_io_instance->receive_buffer_size != TLSIO_OPENSSL_DEFAULT_RECEIVE_BUFFER_SIZE) &&
+                    (OptionHandler_AddOption(result, OPTION_TLS_RECEIVE_BUFFER_SIZE, &tls_io_instance->receive_buffer_size) != OPTIONHANDLER_OK)
+                    )
+                {
+                    LogError("unable to save tls_receive_buffer_size option");
+                    OptionHandler_Destroy(result);
+                    result = NULL;
+                }
+                else if (
+                    (tls_io_instance->is_session_cache_enabled) &&
+                    (OptionHandler_AddOption(result, OPTION_TLS_SESSION_CACHE, &tls_io_instance->is_session_cache_enabled) != OPTIONHANDLER_OK)
+                    )
+                {
+                    LogError("unable to save tls_session_cache option");
+                    OptionHandler_Destroy(result);
+                    result = NULL;
+                }
                 else if (tls_io_instance->tls_validation_callback != NULL)
                 {
 #ifdef WIN32
@@ -448,10 +580,21 @@ static const IO_INTERFACE_DESCRIPTION tlsio_openssl_interface_description =
     tlsio_openssl_close,
     tlsio_openssl_send,
     tlsio_openssl_dowork,
-    tlsio_openssl_setoption
+    tlsio_openssl_setoption,
+    tlsio_openssl_send_array
 };
 
 static LOCK_HANDLE * openssl_locks = NULL;
+/* guards the SSL context cache, the session cache and the handshake statistics */
+static LOCK_HANDLE tlsio_openssl_lock = NULL;
+static SSL_CONTEXT_CACHE_ENTRY* ssl_context_cache = NULL;
+static SSL_SESSION_CACHE_ENTRY* ssl_session_cache = NULL;
+static size_t ssl_session_cache_count = 0;
+static TICK_COUNTER_HANDLE handshake_tick_counter = NULL;
+static TLSIO_HANDSHAKE_STATISTICS handshake_statistics;
+#ifdef TLSIO_OPENSSL_SEND_FROM_BIO
+static BIO_METHOD* underlying_io_bio_method = NULL;
+#endif
 
 
 static void openssl_lock_unlock_helper(LOCK_HANDLE lock, int lock_mode, const char* file, int line)
@@ -672,7 +815,8 @@ static void indicate_open_complete(TLS_IO_INSTANCE* tls_io_instance, IO_OPEN_RES
     }
 }
 
-static int write_outgoing_bytes(TLS_IO_INSTANCE* tls_io_instance, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+/* reads what OpenSSL encrypted into the memory out BIO and sends a copy of it */
+static int copy_outgoing_bytes(TLS_IO_INSTANCE* tls_io_instance, ON_SEND_COMPLETE on_send_complete, void* callback_context)
 {
     int result;
 
@@ -717,15 +861,196 @@ static int write_outgoing_bytes(TLS_IO_INSTANCE* tls_io_instance, ON_SEND_COMPLE
     return result;
 }
 
+#ifdef TLSIO_OPENSSL_SEND_FROM_BIO
+static void on_underlying_io_send_complete(void* context, IO_SEND_RESULT send_result)
+{
+    TLS_IO_INSTANCE* tls_io_instance = (TLS_IO_INSTANCE*)context;
+
+    tls_io_instance->completed_record_count++;
+    if ((send_result != IO_SEND_OK) && (tls_io_instance->record_send_result == IO_SEND_OK))
+    {
+        tls_io_instance->record_send_result = send_result;
+    }
+
+    /* the underlying IO completes the records in the order they were sent */
+    while ((tls_io_instance->pending_send_completes != NULL) &&
+        (tls_io_instance->pending_send_completes->record_count <= tls_io_instance->completed_record_count))
+    {
+        PENDING_SEND_COMPLETE* pending_send_complete = tls_io_instance->pending_send_completes;
+        IO_SEND_RESULT result = tls_io_instance->record_send_result;
+
+        tls_io_instance->pending_send_completes = pending_send_complete->next;
+        tls_io_instance->record_send_result = IO_SEND_OK;
+        pending_send_complete->on_send_complete(pending_send_complete->callback_context, result);
+        free(pending_send_complete);
+    }
+}
+
+static void cancel_pending_send_completes(TLS_IO_INSTANCE* tls_io_instance)
+{
+    while (tls_io_instance->pending_send_completes != NULL)
+    {
+        PENDING_SEND_COMPLETE* pending_send_complete = tls_io_instance->pending_send_completes;
+
+        tls_io_instance->pending_send_completes = pending_send_complete->next;
+        pending_send_complete->on_send_complete(pending_send_complete->callback_context, IO_SEND_CANCELLED);
+        free(pending_send_complete);
+    }
+}
+
+/* OpenSSL calls this with each record it encrypted, in its own write buffer: the record is handed to the underlying IO
+as is, which only copies what it cannot send right away */
+static int underlying_io_bio_write(BIO* bio, const char* data, int size)
+{
+    TLS_IO_INSTANCE* tls_io_instance = (TLS_IO_INSTANCE*)BIO_get_data(bio);
+    int result;
+
+    BIO_clear_retry_flags(bio);
+    if (size <= 0)
+    {
+        result = 0;
+    }
+    else
+    {
+        /* counted first, the underlying IO can complete the send before xio_send returns */
+        tls_io_instance->sent_record_count++;
+        if (xio_send(tls_io_instance->underlying_io, data, (size_t)size, on_underlying_io_send_complete, tls_io_instance) != 0)
+        {
+            LogError("Error in xio_send.");
+            tls_io_instance->sent_record_count--;
+            result = -1;
+        }
+        else
+        {
+            result = size;
+        }
+    }
+
+    return result;
+}
+
+static long underlying_io_bio_ctrl(BIO* bio, int cmd, long num, void* ptr)
+{
+    (void)bio;
+    (void)num;
+    (void)ptr;
+
+    /* nothing is kept in the BIO, so there is nothing to flush */
+    return (cmd == BIO_CTRL_FLUSH) ? 1 : 0;
+}
+
+/* the records are already with the underlying IO, this calls on_send_complete once it has completed all of them */
+static int write_outgoing_bytes(TLS_IO_INSTANCE* tls_io_instance, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    int result;
+
+    if (!tls_io_instance->is_sending_from_bio)
+    {
+        result = copy_outgoing_bytes(tls_io_instance, on_send_complete, callback_context);
+    }
+    else if (on_send_complete == NULL)
+    {
+        result = 0;
+    }
+    else if ((tls_io_instance->pending_send_completes == NULL) &&
+        (tls_io_instance->completed_record_count == tls_io_instance->sent_record_count))
+    {
+        IO_SEND_RESULT send_result = tls_io_instance->record_send_result;
+
+        tls_io_instance->record_send_result = IO_SEND_OK;
+        on_send_complete(callback_context, send_result);
+        result = 0;
+    }
+    else
+    {
+        PENDING_SEND_COMPLETE* pending_send_complete = (PENDING_SEND_COMPLETE*)malloc(sizeof(PENDING_SEND_COMPLETE));
+        if (pending_send_complete == NULL)
+        {
+            LogError("Failed allocating the pending send complete.");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            pending_send_complete->next = NULL;
+            pending_send_complete->record_count = tls_io_instance->sent_record_count;
+            pending_send_complete->on_send_complete = on_send_complete;
+            pending_send_complete->callback_context = callback_context;
+            if (tls_io_instance->pending_send_completes == NULL)
+            {
+                tls_io_instance->pending_send_completes = pending_send_complete;
+            }
+            else
+            {
+                tls_io_instance->last_pending_send_complete->next = pending_send_complete;
+            }
+            tls_io_instance->last_pending_send_complete = pending_send_complete;
+            result = 0;
+        }
+    }
+
+    return result;
+}
+#else
+static int write_outgoing_bytes(TLS_IO_INSTANCE* tls_io_instance, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    return copy_outgoing_bytes(tls_io_instance, on_send_complete, callback_context);
+}
+#endif
+
+static void add_handshake_statistics(TLS_IO_INSTANCE* tls_io_instance)
+{
+    if (tlsio_openssl_lock != NULL)
+    {
+        uint64_t time_ms;
+        uint64_t cpu_time_us = (uint64_t)tls_io_instance->handshake_cpu_time * 1000000 / CLOCKS_PER_SEC;
+        tickcounter_ms_t now_ms;
+
+        if ((handshake_tick_counter == NULL) ||
+            (tickcounter_get_current_ms(handshake_tick_counter, &now_ms) != 0))
+        {
+            time_ms = 0;
+        }
+        else
+        {
+            time_ms = (uint64_t)(now_ms - tls_io_instance->handshake_start_ms);
+        }
+
+        if (Lock(tlsio_openssl_lock) != LOCK_OK)
+        {
+            LogError("Failed to lock the handshake statistics.");
+        }
+        else
+        {
+            handshake_statistics.handshake_count++;
+            handshake_statistics.handshake_time_ms += time_ms;
+            handshake_statistics.handshake_cpu_time_us += cpu_time_us;
+            if (tls_io_instance->is_session_offered)
+            {
+                handshake_statistics.session_offer_count++;
+                if (SSL_session_reused(tls_io_instance->ssl))
+                {
+                    handshake_statistics.resumed_handshake_count++;
+                    handshake_statistics.resumed_handshake_time_ms += time_ms;
+                    handshake_statistics.resumed_handshake_cpu_time_us += cpu_time_us;
+                }
+            }
+            (void)Unlock(tlsio_openssl_lock);
+        }
+    }
+}
+
 // Non-NULL tls_io_instance is guaranteed by callers.
 // We are in TLSIO_STATE_IN_HANDSHAKE when entering this method.
 static void send_handshake_bytes(TLS_IO_INSTANCE* tls_io_instance)
 {
     int hsret;
+    clock_t cpu_time_start;
     // ERR_clear_error must be called before any call that might set an
     // SSL_get_error result
     ERR_clear_error();
+    cpu_time_start = clock();
     hsret = SSL_do_handshake(tls_io_instance->ssl);
+    tls_io_instance->handshake_cpu_time += clock() - cpu_time_start;
     if (hsret != SSL_DO_HANDSHAKE_SUCCESS)
     {
         int ssl_err = SSL_get_error(tls_io_instance->ssl, hsret);
@@ -752,6 +1077,7 @@ static void send_handshake_bytes(TLS_IO_INSTANCE* tls_io_instance)
     }
     else
     {
+        add_handshake_statistics(tls_io_instance);
         tls_io_instance->tlsio_state = TLSIO_STATE_OPEN;
         indicate_open_complete(tls_io_instance, IO_OPEN_OK);
     }
@@ -789,18 +1115,94 @@ int engine_load(TLS_IO_INSTANCE* tls)
 }
 #endif // OPENSSL_NO_ENGINE
 
+static void destroy_ssl_context(SSL_CONTEXT_CACHE_ENTRY* entry)
+{
+    if (entry->ssl_context != NULL)
+    {
+        SSL_CTX_free(entry->ssl_context);
+    }
+#ifndef OPENSSL_NO_ENGINE
+    if (entry->engine != NULL)
+    {
+        ENGINE_free(entry->engine);
+    }
+#endif // OPENSSL_NO_ENGINE
+    free(entry->certificate);
+    free(entry->cipher_list);
+    free(entry->x509_certificate);
+    free(entry->x509_private_key);
+    free(entry->engine_id);
+    free(entry);
+}
+
+static void unlink_ssl_context(SSL_CONTEXT_CACHE_ENTRY* entry)
+{
+    SSL_CONTEXT_CACHE_ENTRY** current;
+
+    for (current = &ssl_context_cache; *current != NULL; current = &(*current)->next)
+    {
+        if (*current == entry)
+        {
+            *current = entry->next;
+            break;
+        }
+    }
+
+    entry->is_cached = false;
+}
+
+static void release_ssl_context(TLS_IO_INSTANCE* tlsInstance)
+{
+    SSL_CONTEXT_CACHE_ENTRY* entry = tlsInstance->ssl_context_entry;
+
+    if (entry != NULL)
+    {
+        bool is_last_reference;
+
+        if (!entry->is_cached)
+        {
+            /* not in the cache: only this instance has it, or tlsio_openssl_deinit took it out */
+            is_last_reference = (DEC_REF_VAR(entry->ref_count) == DEC_RETURN_ZERO);
+        }
+        else if (Lock(tlsio_openssl_lock) != LOCK_OK)
+        {
+            LogError("Failed to lock the SSL context cache, the SSL context is leaked.");
+            is_last_reference = false;
+        }
+        else
+        {
+            is_last_reference = (DEC_REF_VAR(entry->ref_count) == DEC_RETURN_ZERO);
+            if (is_last_reference)
+            {
+                unlink_ssl_context(entry);
+            }
+            (void)Unlock(tlsio_openssl_lock);
+        }
+
+        if (is_last_reference)
+        {
+            destroy_ssl_context(entry);
+        }
+
+        tlsInstance->ssl_context_entry = NULL;
+        tlsInstance->ssl_context = NULL;
+    }
+}
+
 static void close_openssl_instance(TLS_IO_INSTANCE* tls_io_instance)
 {
     if (tls_io_instance->ssl != NULL)
     {
+        if (tls_io_instance->is_session_cache_enabled)
+        {
+            /* no close_notify is sent, without this SSL_free marks the saved session as not resumable.
+            OpenSSL already did that if the connection failed with a fatal alert. */
+            SSL_set_shutdown(tls_io_instance->ssl, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+        }
         SSL_free(tls_io_instance->ssl);
         tls_io_instance->ssl = NULL;
     }
-    if (tls_io_instance->ssl_context != NULL)
-    {
-        SSL_CTX_free(tls_io_instance->ssl_context);
-        tls_io_instance->ssl_context = NULL;
-    }
+    release_ssl_context(tls_io_instance);
 }
 
 static void on_underlying_io_close_complete(void* context)
@@ -844,6 +1246,12 @@ static void on_underlying_io_open_complete(void* context, IO_OPEN_RESULT open_re
         if (open_result == IO_OPEN_OK)
         {
             tls_io_instance->tlsio_state = TLSIO_STATE_IN_HANDSHAKE;
+            tls_io_instance->handshake_cpu_time = 0;
+            if ((handshake_tick_counter == NULL) ||
+                (tickcounter_get_current_ms(handshake_tick_counter, &tls_io_instance->handshake_start_ms) != 0))
+            {
+                tls_io_instance->handshake_start_ms = 0;
+            }
 
             // Begin the handshake process here. It continues in on_underlying_io_bytes_received
             send_handshake_bytes(tls_io_instance);
@@ -882,34 +1290,67 @@ static void on_underlying_io_error(void* context)
     }
 }
 
+static void indicate_received_bytes(TLS_IO_INSTANCE* tls_io_instance, size_t size)
+{
+    if (tls_io_instance->on_bytes_received == NULL)
+    {
+        LogError("NULL on_bytes_received.");
+    }
+    else
+    {
+        tls_io_instance->on_bytes_received(tls_io_instance->on_bytes_received_context, tls_io_instance->receive_buffer, size);
+    }
+}
+
+/* Reads all the decrypted bytes available into receive_buffer and indicates them once it is full or SSL_read has no more,
+so a whole TLS record (or several small ones) costs one on_bytes_received call. The buffer is kept for the next reads. */
 static int decode_ssl_received_bytes(TLS_IO_INSTANCE* tls_io_instance)
 {
     int result = 0;
-    unsigned char buffer[64];
-
+    size_t received_size = 0;
     int rcv_bytes = 1;
 
-    while (rcv_bytes > 0)
+    if ((tls_io_instance->receive_buffer == NULL) &&
+        ((tls_io_instance->receive_buffer = (unsigned char*)malloc(tls_io_instance->receive_buffer_size)) == NULL))
+    {
+        LogError("Failed allocating %zu bytes for the received bytes.", tls_io_instance->receive_buffer_size);
+        result = MU_FAILURE;
+    }
+    else
     {
-        if (tls_io_instance->ssl == NULL)
+        while (rcv_bytes > 0)
         {
-            LogError("SSL channel closed in decode_ssl_received_bytes.");
-            result = MU_FAILURE;
-            return result;
-        }
+            size_t read_size;
 
-        rcv_bytes = SSL_read(tls_io_instance->ssl, buffer, sizeof(buffer));
-        if (rcv_bytes > 0)
-        {
-            if (tls_io_instance->on_bytes_received == NULL)
+            if (tls_io_instance->ssl == NULL)
+            {
+                LogError("SSL channel closed in decode_ssl_received_bytes.");
+                result = MU_FAILURE;
+                return result;
+            }
+
+            read_size = tls_io_instance->receive_buffer_size - received_size;
+            if (read_size > INT_MAX)
             {
-                LogError("NULL on_bytes_received.");
+                read_size = INT_MAX;
             }
-            else
+
+            rcv_bytes = SSL_read(tls_io_instance->ssl, tls_io_instance->receive_buffer + received_size, (int)read_size);
+            if (rcv_bytes > 0)
             {
-                tls_io_instance->on_bytes_received(tls_io_instance->on_bytes_received_context, buffer, rcv_bytes);
+                received_size += (size_t)rcv_bytes;
+                if (received_size == tls_io_instance->receive_buffer_size)
+                {
+                    received_size = 0;
+                    indicate_received_bytes(tls_io_instance, tls_io_instance->receive_buffer_size);
+                }
             }
         }
+
+        if (received_size > 0)
+        {
+            indicate_received_bytes(tls_io_instance, received_size);
+        }
     }
 
     return result;
@@ -949,13 +1390,13 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
     }
 }
 
-static int add_certificate_to_store(TLS_IO_INSTANCE* tls_io_instance, const char* certValue)
+static int add_certificate_to_store(SSL_CTX* ssl_context, const char* certValue)
 {
     int result = 0;
 
     if (certValue != NULL)
     {
-        X509_STORE* cert_store = SSL_CTX_get_cert_store(tls_io_instance->ssl_context);
+        X509_STORE* cert_store = SSL_CTX_get_cert_store(ssl_context);
         if (cert_store == NULL)
         {
             log_ERR_get_error("failure in SSL_CTX_get_cert_store.");
@@ -1056,143 +1497,521 @@ static int enable_domain_check(TLS_IO_INSTANCE* tlsInstance)
     return result;
 }
 
-static int create_openssl_instance(TLS_IO_INSTANCE* tlsInstance)
+static int clone_cache_key(char** destination, const char* source)
 {
     int result;
 
-    const SSL_METHOD* method = NULL;
-
-#if (OPENSSL_VERSION_NUMBER < 0x10100000L) || defined(LIBRESSL_VERSION_NUMBER)
-    if (tlsInstance->tls_version == VERSION_1_2)
+    if (source == NULL)
     {
-        method = TLSv1_2_method();
+        *destination = NULL;
+        result = 0;
     }
-    else if (tlsInstance->tls_version == VERSION_1_1)
+    else if (mallocAndStrcpy_s(destination, source) != 0)
     {
-        method = TLSv1_1_method();
+        LogError("Failed copying the SSL context options.");
+        result = MU_FAILURE;
     }
     else
     {
-        method = TLSv1_method();
-    }
-#else
-    {
-        method = TLS_method();
+        result = 0;
     }
-#endif
 
-    tlsInstance->ssl_context = SSL_CTX_new(method);
-    if (tlsInstance->ssl_context == NULL)
+    return result;
+}
+
+static bool are_equal_cache_keys(const char* left, const char* right)
+{
+    return (left == right) || ((left != NULL) && (right != NULL) && (strcmp(left, right) == 0));
+}
+
+/* all the options an SSL_CTX is built from, see create_ssl_context */
+static bool is_ssl_context_for(const SSL_CONTEXT_CACHE_ENTRY* entry, const TLS_IO_INSTANCE* tlsInstance)
+{
+    return (entry->tls_version == tlsInstance->tls_version) &&
+        (entry->x509_private_key_type == tlsInstance->x509_private_key_type) &&
+        (entry->tls_validation_callback == tlsInstance->tls_validation_callback) &&
+        (entry->tls_validation_callback_data == tlsInstance->tls_validation_callback_data) &&
+        are_equal_cache_keys(entry->cipher_list, tlsInstance->cipher_list) &&
+        are_equal_cache_keys(entry->engine_id, tlsInstance->engine_id) &&
+        are_equal_cache_keys(entry->certificate, tlsInstance->certificate) &&
+        are_equal_cache_keys(entry->x509_certificate, tlsInstance->x509_certificate) &&
+        are_equal_cache_keys(entry->x509_private_key, tlsInstance->x509_private_key);
+}
+
+/* called with tlsio_openssl_lock held */
+static SSL_SESSION_CACHE_ENTRY** find_session(const TLS_IO_INSTANCE* tls_io_instance)
+{
+    SSL_SESSION_CACHE_ENTRY** result;
+
+    for (result = &ssl_session_cache; *result != NULL; result = &(*result)->next)
     {
-        log_ERR_get_error("Failed allocating OpenSSL context.");
-        result = MU_FAILURE;
+        if (((*result)->ssl_context_entry == tls_io_instance->ssl_context_entry) &&
+            ((*result)->port == tls_io_instance->port) &&
+            ((*result)->ignore_host_name_check == tls_io_instance->ignore_host_name_check) &&
+            (strcmp((*result)->hostname, tls_io_instance->hostname) == 0))
+        {
+            break;
+        }
     }
-    #ifndef OPENSSL_NO_ENGINE
-    else if ((tlsInstance->engine_id != NULL) &&
-             (engine_load(tlsInstance) != 0))
+
+    return result;
+}
+
+/* called with tlsio_openssl_lock held */
+static void remove_session(SSL_SESSION_CACHE_ENTRY** session_entry)
+{
+    SSL_SESSION_CACHE_ENTRY* entry = *session_entry;
+
+    *session_entry = entry->next;
+    ssl_session_cache_count--;
+
+    if (DEC_REF_VAR(entry->ssl_context_entry->ref_count) == DEC_RETURN_ZERO)
     {
-        SSL_CTX_free(tlsInstance->ssl_context);
-        tlsInstance->ssl_context = NULL;
-        result = MU_FAILURE;
+        unlink_ssl_context(entry->ssl_context_entry);
+        destroy_ssl_context(entry->ssl_context_entry);
+    }
+    SSL_SESSION_free(entry->session);
+    free(entry->hostname);
+    free(entry);
+}
+
+/* OpenSSL calls this when the server gives a session, during the handshake or after it for TLS 1.3 session tickets.
+Returning 1 keeps the reference to session. */
+static int on_new_session(SSL* ssl, SSL_SESSION* session)
+{
+    TLS_IO_INSTANCE* tls_io_instance = (TLS_IO_INSTANCE*)SSL_get_app_data(ssl);
+    int result = 0;
+
+    if ((tls_io_instance == NULL) ||
+        (!tls_io_instance->is_session_cache_enabled))
+    {
+        /* the session is not saved */
     }
-    #endif // OPENSSL_NO_ENGINE
-    else if ((tlsInstance->cipher_list != NULL) &&
-             (SSL_CTX_set_cipher_list(tlsInstance->ssl_context, tlsInstance->cipher_list)) != 1)
+    else if (Lock(tlsio_openssl_lock) != LOCK_OK)
     {
-        engine_destroy(tlsInstance);
-        SSL_CTX_free(tlsInstance->ssl_context);
-        tlsInstance->ssl_context = NULL;
-        log_ERR_get_error("unable to set cipher list.");
-        result = MU_FAILURE;
+        LogError("Failed to lock the session cache.");
     }
-    else if (add_certificate_to_store(tlsInstance, tlsInstance->certificate) != 0)
+    else
     {
-        engine_destroy(tlsInstance);
-        SSL_CTX_free(tlsInstance->ssl_context);
-        tlsInstance->ssl_context = NULL;
-        log_ERR_get_error("unable to add_certificate_to_store.");
-        result = MU_FAILURE;
+        SSL_SESSION_CACHE_ENTRY** existing_entry = find_session(tls_io_instance);
+
+        if (*existing_entry != NULL)
+        {
+            SSL_SESSION_CACHE_ENTRY* entry = *existing_entry;
+
+            /* the newest session replaces the one of the previous connection, and the host goes first */
+            SSL_SESSION_free(entry->session);
+            entry->session = session;
+            *existing_entry = entry->next;
+            entry->next = ssl_session_cache;
+            ssl_session_cache = entry;
+            result = 1;
+        }
+        else if (!tls_io_instance->ssl_context_entry->is_cached)
+        {
+            /* nothing else uses this SSL_CTX */
+        }
+        else
+        {
+            SSL_SESSION_CACHE_ENTRY* entry = (SSL_SESSION_CACHE_ENTRY*)malloc(sizeof(SSL_SESSION_CACHE_ENTRY));
+            if (entry == NULL)
+            {
+                LogError("Failed allocating the session cache entry.");
+            }
+            else if (mallocAndStrcpy_s(&entry->hostname, tls_io_instance->hostname) != 0)
+            {
+                LogError("Failed copying the hostname of the session.");
+                free(entry);
+            }
+            else
+            {
+                entry->ssl_context_entry = tls_io_instance->ssl_context_entry;
+                (void)INC_REF_VAR(entry->ssl_context_entry->ref_count);
+                entry->port = tls_io_instance->port;
+                entry->ignore_host_name_check = tls_io_instance->ignore_host_name_check;
+                entry->session = session;
+                entry->next = ssl_session_cache;
+                ssl_session_cache = entry;
+                ssl_session_cache_count++;
+                result = 1;
+
+                if (ssl_session_cache_count > TLSIO_OPENSSL_SESSION_CACHE_SIZE)
+                {
+                    SSL_SESSION_CACHE_ENTRY** oldest_entry = &ssl_session_cache;
+                    while ((*oldest_entry)->next != NULL)
+                    {
+                        oldest_entry = &(*oldest_entry)->next;
+                    }
+                    remove_session(oldest_entry);
+                }
+            }
+        }
+
+        (void)Unlock(tlsio_openssl_lock);
+    }
+
+    return result;
+}
+
+/* sets the saved session of the host on the SSL object of a new connection, if there is one that has not expired */
+static void offer_session(TLS_IO_INSTANCE* tls_io_instance)
+{
+    tls_io_instance->is_session_offered = false;
+
+    if (!tls_io_instance->is_session_cache_enabled)
+    {
+        /* full handshake */
+    }
+    else if (Lock(tlsio_openssl_lock) != LOCK_OK)
+    {
+        LogError("Failed to lock the session cache.");
+    }
+    else
+    {
+        SSL_SESSION_CACHE_ENTRY** entry = find_session(tls_io_instance);
+
+        if (*entry == NULL)
+        {
+            /* first connection to the host */
+        }
+        else if ((long)time(NULL) > SSL_SESSION_get_time((*entry)->session) + SSL_SESSION_get_timeout((*entry)->session))
+        {
+            remove_session(entry);
+        }
+        else if (SSL_set_session(tls_io_instance->ssl, (*entry)->session) != 1)
+        {
+            log_ERR_get_error("Failed setting the saved session.");
+        }
+        else
+        {
+            tls_io_instance->is_session_offered = true;
+        }
+
+        (void)Unlock(tlsio_openssl_lock);
+    }
+}
+
+static void clear_session_cache(void)
+{
+    while (ssl_session_cache != NULL)
+    {
+        remove_session(&ssl_session_cache);
+    }
+}
+
+/* builds the SSL_CTX for the options of tlsInstance: this parses the trusted certificates and the x509 credentials
+and loads the default CA locations, which is most of the cost of opening a connection */
+static SSL_CONTEXT_CACHE_ENTRY* create_ssl_context(TLS_IO_INSTANCE* tlsInstance)
+{
+    SSL_CONTEXT_CACHE_ENTRY* result;
+
+    const SSL_METHOD* method = NULL;
+
+#if (OPENSSL_VERSION_NUMBER < 0x10100000L) || defined(LIBRESSL_VERSION_NUMBER)
+    if (tlsInstance->tls_version == VERSION_1_2)
+    {
+        method = TLSv1_2_method();
+    }
+    else if (tlsInstance->tls_version == VERSION_1_1)
+    {
+        method = TLSv1_1_method();
+    }
+    else
+    {
+        method = TLSv1_method();
+    }
+#else
+    {
+        method = TLS_method();
+    }
+#endif
+
+    if ((result = (SSL_CONTEXT_CACHE_ENTRY*)calloc(1, sizeof(SSL_CONTEXT_CACHE_ENTRY))) == NULL)
+    {
+        LogError("Failed allocating the SSL context cache entry.");
     }
-    /*x509 authentication can only be build before underlying connection is realized*/
     else if (
-        (tlsInstance->x509_certificate != NULL) &&
-        (tlsInstance->x509_private_key != NULL) &&
-        (x509_openssl_add_credentials(
-            tlsInstance->ssl_context, 
-            tlsInstance->x509_certificate, 
-            tlsInstance->x509_private_key,
-    #ifndef OPENSSL_NO_ENGINE
-            tlsInstance->x509_private_key_type,
-            tlsInstance->engine) != 0)
-    #else // OPENSSL_NO_ENGINE
-            tlsInstance->x509_private_key_type) != 0)
-    #endif // OPENSSL_NO_ENGINE
+        (clone_cache_key(&result->certificate, tlsInstance->certificate) != 0) ||
+        (clone_cache_key(&result->cipher_list, tlsInstance->cipher_list) != 0) ||
+        (clone_cache_key(&result->x509_certificate, tlsInstance->x509_certificate) != 0) ||
+        (clone_cache_key(&result->x509_private_key, tlsInstance->x509_private_key) != 0) ||
+        (clone_cache_key(&result->engine_id, tlsInstance->engine_id) != 0)
         )
     {
-        engine_destroy(tlsInstance);
-        SSL_CTX_free(tlsInstance->ssl_context);
-        tlsInstance->ssl_context = NULL;
-        log_ERR_get_error("unable to use x509 authentication");
+        destroy_ssl_context(result);
+        result = NULL;
+    }
+    else
+    {
+        INIT_REF_VAR(result->ref_count);
+        result->tls_version = tlsInstance->tls_version;
+        result->x509_private_key_type = tlsInstance->x509_private_key_type;
+        result->tls_validation_callback = tlsInstance->tls_validation_callback;
+        result->tls_validation_callback_data = tlsInstance->tls_validation_callback_data;
+
+        result->ssl_context = SSL_CTX_new(method);
+        if (result->ssl_context == NULL)
+        {
+            log_ERR_get_error("Failed allocating OpenSSL context.");
+            destroy_ssl_context(result);
+            result = NULL;
+        }
+        #ifndef OPENSSL_NO_ENGINE
+        else if ((tlsInstance->engine_id != NULL) &&
+                 (engine_load(tlsInstance) != 0))
+        {
+            destroy_ssl_context(result);
+            result = NULL;
+        }
+        #endif // OPENSSL_NO_ENGINE
+        else if ((tlsInstance->cipher_list != NULL) &&
+                 (SSL_CTX_set_cipher_list(result->ssl_context, tlsInstance->cipher_list)) != 1)
+        {
+            engine_destroy(tlsInstance);
+            destroy_ssl_context(result);
+            result = NULL;
+            log_ERR_get_error("unable to set cipher list.");
+        }
+        else if (add_certificate_to_store(result->ssl_context, tlsInstance->certificate) != 0)
+        {
+            engine_destroy(tlsInstance);
+            destroy_ssl_context(result);
+            result = NULL;
+            log_ERR_get_error("unable to add_certificate_to_store.");
+        }
+        /*x509 authentication can only be build before underlying connection is realized*/
+        else if (
+            (tlsInstance->x509_certificate != NULL) &&
+            (tlsInstance->x509_private_key != NULL) &&
+            (x509_openssl_add_credentials(
+                result->ssl_context, 
+                tlsInstance->x509_certificate, 
+                tlsInstance->x509_private_key,
+        #ifndef OPENSSL_NO_ENGINE
+                tlsInstance->x509_private_key_type,
+                tlsInstance->engine) != 0)
+        #else // OPENSSL_NO_ENGINE
+                tlsInstance->x509_private_key_type) != 0)
+        #endif // OPENSSL_NO_ENGINE
+            )
+        {
+            engine_destroy(tlsInstance);
+            destroy_ssl_context(result);
+            result = NULL;
+            log_ERR_get_error("unable to use x509 authentication");
+        }
+        else
+        {
+            /* the engine is released with the context */
+            result->engine = tlsInstance->engine;
+            tlsInstance->engine = NULL;
+
+            SSL_CTX_set_cert_verify_callback(result->ssl_context, tlsInstance->tls_validation_callback, tlsInstance->tls_validation_callback_data);
+            SSL_CTX_set_verify(result->ssl_context, SSL_VERIFY_PEER, NULL);
+
+            /* the sessions are given to on_new_session, which saves them for the connections with OPTION_TLS_SESSION_CACHE */
+            (void)SSL_CTX_set_session_cache_mode(result->ssl_context, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+            SSL_CTX_sess_set_new_cb(result->ssl_context, on_new_session);
+
+            // Specifies that the default locations for which CA certificates are loaded should be used.
+            if (SSL_CTX_set_default_verify_paths(result->ssl_context) != 1)
+            {
+                // This is only a warning to the user. They can still specify the certificate via SetOption.
+                LogInfo("WARNING: Unable to specify the default location for CA certificates on this platform.");
+            }
+        }
+    }
+
+    return result;
+}
+
+/* called with tlsio_openssl_lock held */
+static SSL_CONTEXT_CACHE_ENTRY* find_ssl_context(const TLS_IO_INSTANCE* tlsInstance)
+{
+    SSL_CONTEXT_CACHE_ENTRY* result;
+
+    for (result = ssl_context_cache; result != NULL; result = result->next)
+    {
+        if (is_ssl_context_for(result, tlsInstance))
+        {
+            (void)INC_REF_VAR(result->ref_count);
+            break;
+        }
+    }
+
+    return result;
+}
+
+/* Returns the SSL_CTX of the instances opened with the same options as tlsInstance, creating it for the first one.
+The context is created without holding the cache lock, so opens with other options are not blocked while it is built.
+Connections opened together with the same options can each build one, the first inserted is kept. */
+static int acquire_ssl_context(TLS_IO_INSTANCE* tlsInstance)
+{
+    int result;
+    SSL_CONTEXT_CACHE_ENTRY* entry;
+
+    if (tlsio_openssl_lock == NULL)
+    {
+        /* tlsio_openssl_init was not called, every instance gets its own context */
+        entry = create_ssl_context(tlsInstance);
+    }
+    else if (Lock(tlsio_openssl_lock) != LOCK_OK)
+    {
+        LogError("Failed to lock the SSL context cache.");
+        entry = NULL;
+    }
+    else
+    {
+        entry = find_ssl_context(tlsInstance);
+        (void)Unlock(tlsio_openssl_lock);
+
+        if (entry == NULL)
+        {
+            SSL_CONTEXT_CACHE_ENTRY* new_entry = create_ssl_context(tlsInstance);
+            if (new_entry == NULL)
+            {
+                /* error already logged */
+            }
+            else if (Lock(tlsio_openssl_lock) != LOCK_OK)
+            {
+                LogError("Failed to lock the SSL context cache, the SSL context is not shared.");
+                entry = new_entry;
+            }
+            else
+            {
+                if ((entry = find_ssl_context(tlsInstance)) == NULL)
+                {
+                    new_entry->is_cached = true;
+                    new_entry->next = ssl_context_cache;
+                    ssl_context_cache = new_entry;
+                    entry = new_entry;
+                    new_entry = NULL;
+                }
+                (void)Unlock(tlsio_openssl_lock);
+
+                if (new_entry != NULL)
+                {
+                    /* another open with the same options inserted its context first */
+                    destroy_ssl_context(new_entry);
+                }
+            }
+        }
+    }
+
+    if (entry == NULL)
+    {
+        result = MU_FAILURE;
+    }
+    else
+    {
+        tlsInstance->ssl_context_entry = entry;
+        tlsInstance->ssl_context = entry->ssl_context;
+        result = 0;
+    }
+
+    return result;
+}
+
+/* An option set while open changes the SSL_CTX of the connection. That is only done when no other instance uses it,
+the context is then taken out of the cache since it no longer matches the options it was created with. */
+static int own_ssl_context(TLS_IO_INSTANCE* tlsInstance)
+{
+    int result;
+    SSL_CONTEXT_CACHE_ENTRY* entry = tlsInstance->ssl_context_entry;
+
+    if (!entry->is_cached)
+    {
+        result = 0;
+    }
+    else if (Lock(tlsio_openssl_lock) != LOCK_OK)
+    {
+        LogError("Failed to lock the SSL context cache.");
         result = MU_FAILURE;
     }
     else
     {
-        SSL_CTX_set_cert_verify_callback(tlsInstance->ssl_context, tlsInstance->tls_validation_callback, tlsInstance->tls_validation_callback_data);
+        if (entry->ref_count == 1)
+        {
+            unlink_ssl_context(entry);
+            result = 0;
+        }
+        else
+        {
+            result = MU_FAILURE;
+        }
+        (void)Unlock(tlsio_openssl_lock);
+    }
 
+    return result;
+}
+
+static int create_openssl_instance(TLS_IO_INSTANCE* tlsInstance)
+{
+    int result;
+
+    if (acquire_ssl_context(tlsInstance) != 0)
+    {
+        LogError("Failed getting the OpenSSL context.");
+        result = MU_FAILURE;
+    }
+    else
+    {
         tlsInstance->in_bio = BIO_new(BIO_s_mem());
         if (tlsInstance->in_bio == NULL)
         {
-            engine_destroy(tlsInstance);
-            SSL_CTX_free(tlsInstance->ssl_context);
-            tlsInstance->ssl_context = NULL;
+            release_ssl_context(tlsInstance);
             log_ERR_get_error("Failed BIO_new for in BIO.");
             result = MU_FAILURE;
         }
         else
         {
+#ifdef TLSIO_OPENSSL_SEND_FROM_BIO
+            /* the BIO method is created by tlsio_openssl_init, without it the records are copied out of a memory BIO */
+            tlsInstance->is_sending_from_bio = (underlying_io_bio_method != NULL);
+            if (!tlsInstance->is_sending_from_bio)
+            {
+                tlsInstance->out_bio = BIO_new(BIO_s_mem());
+            }
+            else if ((tlsInstance->out_bio = BIO_new(underlying_io_bio_method)) != NULL)
+            {
+                BIO_set_data(tlsInstance->out_bio, tlsInstance);
+                BIO_set_init(tlsInstance->out_bio, 1);
+            }
+#else
             tlsInstance->out_bio = BIO_new(BIO_s_mem());
+#endif
             if (tlsInstance->out_bio == NULL)
             {
                 (void)BIO_free(tlsInstance->in_bio);
-                engine_destroy(tlsInstance);
-                SSL_CTX_free(tlsInstance->ssl_context);
-                tlsInstance->ssl_context = NULL;
+                release_ssl_context(tlsInstance);
                 log_ERR_get_error("Failed BIO_new for out BIO.");
                 result = MU_FAILURE;
             }
             else
             {
                 if ((BIO_set_mem_eof_return(tlsInstance->in_bio, -1) <= 0) ||
-                    (BIO_set_mem_eof_return(tlsInstance->out_bio, -1) <= 0))
+#ifdef TLSIO_OPENSSL_SEND_FROM_BIO
+                    (!tlsInstance->is_sending_from_bio && (BIO_set_mem_eof_return(tlsInstance->out_bio, -1) <= 0))
+#else
+                    (BIO_set_mem_eof_return(tlsInstance->out_bio, -1) <= 0)
+#endif
+                    )
                 {
                     (void)BIO_free(tlsInstance->in_bio);
                     (void)BIO_free(tlsInstance->out_bio);
-                    engine_destroy(tlsInstance);
-                    SSL_CTX_free(tlsInstance->ssl_context);
-                    tlsInstance->ssl_context = NULL;
+                    release_ssl_context(tlsInstance);
                     LogError("Failed BIO_set_mem_eof_return.");
                     result = MU_FAILURE;
                 }
                 else
                 {
-                    SSL_CTX_set_verify(tlsInstance->ssl_context, SSL_VERIFY_PEER, NULL);
-
-                    // Specifies that the default locations for which CA certificates are loaded should be used.
-                    if (SSL_CTX_set_default_verify_paths(tlsInstance->ssl_context) != 1)
-                    {
-                        // This is only a warning to the user. They can still specify the certificate via SetOption.
-                        LogInfo("WARNING: Unable to specify the default location for CA certificates on this platform.");
-                    }
-
                     tlsInstance->ssl = SSL_new(tlsInstance->ssl_context);
 
                     if (tlsInstance->ssl == NULL)
                     {
                         (void)BIO_free(tlsInstance->in_bio);
                         (void)BIO_free(tlsInstance->out_bio);
-                        engine_destroy(tlsInstance);
-                        SSL_CTX_free(tlsInstance->ssl_context);
-                        tlsInstance->ssl_context = NULL;
+                        release_ssl_context(tlsInstance);
                         log_ERR_get_error("Failed creating OpenSSL instance.");
                         result = MU_FAILURE;
                     }
@@ -1202,9 +2021,7 @@ static int create_openssl_instance(TLS_IO_INSTANCE* tlsInstance)
                         tlsInstance->ssl = NULL;
                         (void)BIO_free(tlsInstance->in_bio);
                         (void)BIO_free(tlsInstance->out_bio);
-                        engine_destroy(tlsInstance);
-                        SSL_CTX_free(tlsInstance->ssl_context);
-                        tlsInstance->ssl_context = NULL;
+                        release_ssl_context(tlsInstance);
                         log_ERR_get_error("Failed setting SNI hostname hint.");
                         result = MU_FAILURE;
                     }
@@ -1214,13 +2031,14 @@ static int create_openssl_instance(TLS_IO_INSTANCE* tlsInstance)
                         tlsInstance->ssl = NULL;
                         (void)BIO_free(tlsInstance->in_bio);
                         (void)BIO_free(tlsInstance->out_bio);
-                        SSL_CTX_free(tlsInstance->ssl_context);
-                        tlsInstance->ssl_context = NULL;
+                        release_ssl_context(tlsInstance);
                         log_ERR_get_error("Failed to configure domain name verification.");
                         result = MU_FAILURE;
                     }
                     else
                     {
+                        (void)SSL_set_app_data(tlsInstance->ssl, tlsInstance);
+                        offer_session(tlsInstance);
                         SSL_set_bio(tlsInstance->ssl, tlsInstance->in_bio, tlsInstance->out_bio);
                         SSL_set_connect_state(tlsInstance->ssl);
                         result = 0;
@@ -1247,11 +2065,64 @@ int tlsio_openssl_init(void)
     }
 
     openssl_dynamic_locks_install();
+
+#ifdef TLSIO_OPENSSL_SEND_FROM_BIO
+    if (underlying_io_bio_method == NULL)
+    {
+        if (((underlying_io_bio_method = BIO_meth_new(BIO_get_new_index() | BIO_TYPE_SOURCE_SINK, "tlsio_openssl underlying io")) == NULL) ||
+            (BIO_meth_set_write(underlying_io_bio_method, underlying_io_bio_write) != 1) ||
+            (BIO_meth_set_ctrl(underlying_io_bio_method, underlying_io_bio_ctrl) != 1))
+        {
+            log_ERR_get_error("Failed creating the BIO method of the underlying IO, the records are copied out of a memory BIO.");
+            BIO_meth_free(underlying_io_bio_method);
+            underlying_io_bio_method = NULL;
+        }
+    }
+#endif
+
+    if ((tlsio_openssl_lock == NULL) &&
+        ((tlsio_openssl_lock = Lock_Init()) == NULL))
+    {
+        LogInfo("Failed to create the SSL context cache lock, every connection creates its own SSL context.");
+    }
+    else if ((handshake_tick_counter == NULL) &&
+        ((handshake_tick_counter = tickcounter_create()) == NULL))
+    {
+        LogInfo("Failed to create the tick counter, the handshake times are not measured.");
+    }
+
     return 0;
 }
 
 void tlsio_openssl_deinit(void)
 {
+    if (tlsio_openssl_lock != NULL)
+    {
+        clear_session_cache();
+        if (ssl_context_cache != NULL)
+        {
+            LogError("SSL contexts are still in use by open connections, they are freed when the connections are closed.");
+            /* release_ssl_context does not need the lock for a context that is not in the cache */
+            while (ssl_context_cache != NULL)
+            {
+                unlink_ssl_context(ssl_context_cache);
+            }
+        }
+        (void)Lock_Deinit(tlsio_openssl_lock);
+        tlsio_openssl_lock = NULL;
+        (void)memset(&handshake_statistics, 0, sizeof(handshake_statistics));
+    }
+    if (handshake_tick_counter != NULL)
+    {
+        tickcounter_destroy(handshake_tick_counter);
+        handshake_tick_counter = NULL;
+    }
+
+#ifdef TLSIO_OPENSSL_SEND_FROM_BIO
+    BIO_meth_free(underlying_io_bio_method);
+    underlying_io_bio_method = NULL;
+#endif
+
     openssl_dynamic_locks_uninstall();
     openssl_static_locks_uninstall();
 #if  (OPENSSL_VERSION_NUMBER >= 0x00907000L) && (FIPS_mode_set)
@@ -1273,6 +2144,35 @@ void tlsio_openssl_deinit(void)
     CRYPTO_cleanup_all_ex_data();
 }
 
+int tlsio_openssl_get_handshake_statistics(TLSIO_HANDSHAKE_STATISTICS* statistics)
+{
+    int result;
+
+    if (statistics == NULL)
+    {
+        LogError("NULL statistics.");
+        result = MU_FAILURE;
+    }
+    else if (tlsio_openssl_lock == NULL)
+    {
+        LogError("tlsio_openssl_init was not called.");
+        result = MU_FAILURE;
+    }
+    else if (Lock(tlsio_openssl_lock) != LOCK_OK)
+    {
+        LogError("Failed to lock the handshake statistics.");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        *statistics = handshake_statistics;
+        (void)Unlock(tlsio_openssl_lock);
+        result = 0;
+    }
+
+    return result;
+}
+
 CONCRETE_IO_HANDLE tlsio_openssl_create(void* io_create_parameters)
 {
     TLSIO_CONFIG* tls_io_config = io_create_parameters;
@@ -1348,6 +2248,21 @@ CONCRETE_IO_HANDLE tlsio_openssl_create(void* io_create_parameters)
                 result->engine_id = NULL;
                 result->engine = NULL;
                 result->x509_private_key_type = KEY_TYPE_DEFAULT;
+                result->receive_buffer = NULL;
+                result->receive_buffer_size = TLSIO_OPENSSL_DEFAULT_RECEIVE_BUFFER_SIZE;
+                result->send_array_buffer = NULL;
+                result->ssl_context_entry = NULL;
+                result->port = tls_io_config->port;
+                result->is_session_cache_enabled = false;
+                result->is_session_offered = false;
+#ifdef TLSIO_OPENSSL_SEND_FROM_BIO
+                result->is_sending_from_bio = false;
+                result->sent_record_count = 0;
+                result->completed_record_count = 0;
+                result->record_send_result = IO_SEND_OK;
+                result->pending_send_completes = NULL;
+                result->last_pending_send_complete = NULL;
+#endif
 
                 result->tls_version = VERSION_1_2;
 
@@ -1401,6 +2316,10 @@ void tlsio_openssl_destroy(CONCRETE_IO_HANDLE tls_io)
             xio_destroy(tls_io_instance->underlying_io);
             tls_io_instance->underlying_io = NULL;
         }
+#ifdef TLSIO_OPENSSL_SEND_FROM_BIO
+        /* what the underlying IO did not complete when it was destroyed */
+        cancel_pending_send_completes(tls_io_instance);
+#endif
         free(tls_io_instance->hostname);
         tls_io_instance->hostname = NULL;
         if (tls_io_instance->engine_id != NULL)
@@ -1408,6 +2327,8 @@ void tlsio_openssl_destroy(CONCRETE_IO_HANDLE tls_io)
             free(tls_io_instance->engine_id);
             tls_io_instance->engine_id = NULL;
         }
+        free(tls_io_instance->receive_buffer);
+        free(tls_io_instance->send_array_buffer);
 
         free(tls_io);
     }
@@ -1442,6 +2363,13 @@ int tlsio_openssl_open(CONCRETE_IO_HANDLE tls_io, ON_IO_OPEN_COMPLETE on_io_open
             tls_io_instance->on_io_error = on_io_error;
             tls_io_instance->on_io_error_context = on_io_error_context;
 
+#ifdef TLSIO_OPENSSL_SEND_FROM_BIO
+            /* the records of a previous connection were completed or cancelled when it was closed */
+            tls_io_instance->sent_record_count = 0;
+            tls_io_instance->completed_record_count = 0;
+            tls_io_instance->record_send_result = IO_SEND_OK;
+#endif
+
             tls_io_instance->tlsio_state = TLSIO_STATE_OPENING_UNDERLYING_IO;
 
             if (create_openssl_instance(tls_io_instance) != 0)
@@ -1524,6 +2452,12 @@ int tlsio_openssl_close(CONCRETE_IO_HANDLE tls_io, ON_IO_CLOSE_COMPLETE on_io_cl
             tls_io_instance->tlsio_state = TLSIO_STATE_NOT_OPEN;
         }
 
+#ifdef TLSIO_OPENSSL_SEND_FROM_BIO
+        /* Codes_SRS_TLSIO_30_009: [ The phrase "enter TLSIO_STATE_EXT_CLOSING" means the adapter shall iterate through any unsent messages in the queue and shall delete each message after calling its on_send_complete with the associated callback_context and IO_SEND_CANCELLED. ]*/
+        /* what the underlying IO did not complete when it was closed */
+        cancel_pending_send_completes(tls_io_instance);
+#endif
+
         result = 0;
     }
     /* Codes_SRS_TLSIO_30_054: [ On failure, the adapter shall not call on_io_close_complete. ]*/
@@ -1583,6 +2517,144 @@ int tlsio_openssl_send(CONCRETE_IO_HANDLE tls_io, const void* buffer, size_t siz
     return result;
 }
 
+static int ssl_write_all(TLS_IO_INSTANCE* tls_io_instance, const unsigned char* buffer, size_t size)
+{
+    int result;
+
+    if (SSL_write(tls_io_instance->ssl, buffer, (int)size) != (int)size)
+    {
+        log_ERR_get_error("SSL_write error.");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+int tlsio_openssl_send_array(CONCRETE_IO_HANDLE tls_io, CONSTBUFFER_ARRAY_HANDLE buffers, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    int result;
+    uint32_t buffer_count;
+
+    if ((tls_io == NULL) ||
+        (buffers == NULL) ||
+        (constbuffer_array_get_buffer_count(buffers, &buffer_count) != 0))
+    {
+        LogError("Invalid arguments: tls_io=%p, buffers=%p", tls_io, buffers);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        TLS_IO_INSTANCE* tls_io_instance = (TLS_IO_INSTANCE*)tls_io;
+        uint32_t i;
+
+        /* SSL_write takes an int, checked before anything is written */
+        for (i = 0; i < buffer_count; i++)
+        {
+            if (constbuffer_array_get_buffer_content(buffers, i)->size > INT_MAX)
+            {
+                break;
+            }
+        }
+
+        if (tls_io_instance->tlsio_state != TLSIO_STATE_OPEN)
+        {
+            LogError("Invalid tlsio_state. Expected state is TLSIO_STATE_OPEN.");
+            result = MU_FAILURE;
+        }
+        else if (tls_io_instance->ssl == NULL)
+        {
+            LogError("SSL channel closed in tlsio_openssl_send_array.");
+            result = MU_FAILURE;
+        }
+        else if (i < buffer_count)
+        {
+            LogError("Buffer %lu of %zu bytes is larger than SSL_write takes.", (unsigned long)i, constbuffer_array_get_buffer_content(buffers, i)->size);
+            result = MU_FAILURE;
+        }
+        else if ((tls_io_instance->send_array_buffer == NULL) &&
+            ((tls_io_instance->send_array_buffer = (unsigned char*)malloc(TLSIO_OPENSSL_SEND_ARRAY_RECORD_SIZE)) == NULL))
+        {
+            LogError("Failed allocating %d bytes to gather the buffers.", TLSIO_OPENSSL_SEND_ARRAY_RECORD_SIZE);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* SSL_write encrypts into the out BIO anyway, so small buffers are gathered here first to not pay a record for each */
+            unsigned char* record = tls_io_instance->send_array_buffer;
+            size_t record_size = 0;
+            /* once SSL_write took some of the buffers, they are part of the TLS stream and cannot be taken back */
+            bool is_partly_written = false;
+
+            result = 0;
+            for (i = 0; (i < buffer_count) && (result == 0); i++)
+            {
+                const CONSTBUFFER* content = constbuffer_array_get_buffer_content(buffers, i);
+
+                if (record_size + content->size > TLSIO_OPENSSL_SEND_ARRAY_RECORD_SIZE)
+                {
+                    if (record_size > 0)
+                    {
+                        result = ssl_write_all(tls_io_instance, record, record_size);
+                        is_partly_written = is_partly_written || (result == 0);
+                    }
+                    record_size = 0;
+                }
+
+                if (result != 0)
+                {
+                    /* error already logged */
+                }
+                else if (content->size >= TLSIO_OPENSSL_SEND_ARRAY_RECORD_SIZE)
+                {
+                    result = ssl_write_all(tls_io_instance, content->buffer, content->size);
+                    is_partly_written = is_partly_written || (result == 0);
+                }
+                else if (content->size > 0)
+                {
+                    (void)memcpy(record + record_size, content->buffer, content->size);
+                    record_size += content->size;
+                }
+            }
+
+            if ((result == 0) &&
+                (record_size > 0))
+            {
+                result = ssl_write_all(tls_io_instance, record, record_size);
+            }
+
+            if (result != 0)
+            {
+                if (is_partly_written)
+                {
+                    /* the peer would get the start of the buffers without the rest: the connection cannot be used anymore */
+                    LogError("Error writing the buffers to the SSL channel after a part of them was written.");
+                    tls_io_instance->tlsio_state = TLSIO_STATE_ERROR;
+                    indicate_error(tls_io_instance);
+                }
+                else
+                {
+                    LogError("Error writing the buffers to the SSL channel.");
+                }
+            }
+            else if (write_outgoing_bytes(tls_io_instance, on_send_complete, callback_context) != 0)
+            {
+                LogError("Error in write_outgoing_bytes.");
+                result = MU_FAILURE;
+            }
+            else
+            {
+                result = 0;
+            }
+        }
+    }
+
+    return result;
+}
+
 void tlsio_openssl_dowork(CONCRETE_IO_HANDLE tls_io)
 {
     if (tls_io == NULL)
@@ -1650,32 +2722,41 @@ int tlsio_openssl_setoption(CONCRETE_IO_HANDLE tls_io, const char* optionName, c
             const char* cert = (const char*)value;
             size_t len;
 
-            if (tls_io_instance->certificate != NULL)
+            if ((tls_io_instance->ssl_context != NULL) &&
+                (own_ssl_context(tls_io_instance) != 0))
             {
-                // Free the memory if it has been previously allocated
-                free(tls_io_instance->certificate);
-                tls_io_instance->certificate = NULL;
-            }
-
-            // Store the certificate
-            len = strlen(cert);
-            size_t malloc_size = safe_add_size_t(len, 1);
-            if (malloc_size == SIZE_MAX ||
-                (tls_io_instance->certificate = malloc(malloc_size)) == NULL)
-            {
-                LogError("malloc failure, size:%zu", malloc_size);
+                LogError("The SSL context is shared with other connections, the certificate cannot be changed while open.");
                 result = MU_FAILURE;
             }
             else
             {
-                strcpy(tls_io_instance->certificate, cert);
-                result = 0;
-            }
+                if (tls_io_instance->certificate != NULL)
+                {
+                    // Free the memory if it has been previously allocated
+                    free(tls_io_instance->certificate);
+                    tls_io_instance->certificate = NULL;
+                }
 
-            // If we're previously connected then add the cert to the context
-            if (tls_io_instance->ssl_context != NULL)
-            {
-                result = add_certificate_to_store(tls_io_instance, cert);
+                // Store the certificate
+                len = strlen(cert);
+                size_t malloc_size = safe_add_size_t(len, 1);
+                if (malloc_size == SIZE_MAX ||
+                    (tls_io_instance->certificate = malloc(malloc_size)) == NULL)
+                {
+                    LogError("malloc failure, size:%zu", malloc_size);
+                    result = MU_FAILURE;
+                }
+                else
+                {
+                    strcpy(tls_io_instance->certificate, cert);
+                    result = 0;
+                }
+
+                // If we're previously connected then add the cert to the context
+                if (tls_io_instance->ssl_context != NULL)
+                {
+                    result = add_certificate_to_store(tls_io_instance->ssl_context, cert);
+                }
             }
         }
         else if (strcmp(OPTION_OPENSSL_CIPHER_SUITE, optionName) == 0)
@@ -1774,32 +2855,50 @@ int tlsio_openssl_setoption(CONCRETE_IO_HANDLE tls_io, const char* optionName, c
         }
         else if (strcmp("tls_validation_callback", optionName) == 0)
         {
+            if ((tls_io_instance->ssl_context != NULL) &&
+                (own_ssl_context(tls_io_instance) != 0))
+            {
+                LogError("The SSL context is shared with other connections, the validation callback cannot be changed while open.");
+                result = MU_FAILURE;
+            }
+            else
+            {
 #ifdef WIN32
 #pragma warning(push)
 #pragma warning(disable:4055)
 #endif // WIN32
-            tls_io_instance->tls_validation_callback = (TLS_CERTIFICATE_VALIDATION_CALLBACK)value;
+                tls_io_instance->tls_validation_callback = (TLS_CERTIFICATE_VALIDATION_CALLBACK)value;
 #ifdef WIN32
 #pragma warning(pop)
 #endif // WIN32
 
-            if (tls_io_instance->ssl_context != NULL)
-            {
-                SSL_CTX_set_cert_verify_callback(tls_io_instance->ssl_context, tls_io_instance->tls_validation_callback, tls_io_instance->tls_validation_callback_data);
-            }
+                if (tls_io_instance->ssl_context != NULL)
+                {
+                    SSL_CTX_set_cert_verify_callback(tls_io_instance->ssl_context, tls_io_instance->tls_validation_callback, tls_io_instance->tls_validation_callback_data);
+                }
 
-            result = 0;
+                result = 0;
+            }
         }
         else if (strcmp("tls_validation_callback_data", optionName) == 0)
         {
-            tls_io_instance->tls_validation_callback_data = (void*)value;
-
-            if (tls_io_instance->ssl_context != NULL)
+            if ((tls_io_instance->ssl_context != NULL) &&
+                (own_ssl_context(tls_io_instance) != 0))
             {
-                SSL_CTX_set_cert_verify_callback(tls_io_instance->ssl_context, tls_io_instance->tls_validation_callback, tls_io_instance->tls_validation_callback_data);
+                LogError("The SSL context is shared with other connections, the validation callback cannot be changed while open.");
+                result = MU_FAILURE;
             }
+            else
+            {
+                tls_io_instance->tls_validation_callback_data = (void*)value;
 
-            result = 0;
+                if (tls_io_instance->ssl_context != NULL)
+                {
+                    SSL_CTX_set_cert_verify_callback(tls_io_instance->ssl_context, tls_io_instance->tls_validation_callback, tls_io_instance->tls_validation_callback_data);
+                }
+
+                result = 0;
+            }
         }
         else if (strcmp(OPTION_TLS_VERSION, optionName) == 0)
         {
@@ -1854,6 +2953,41 @@ int tlsio_openssl_setoption(CONCRETE_IO_HANDLE tls_io, const char* optionName, c
             tls_io_instance->ignore_host_name_check = *server_name_check;
             result = 0;
         }
+        else if (strcmp(OPTION_TLS_SESSION_CACHE, optionName) == 0)
+        {
+            if (tlsio_openssl_lock == NULL)
+            {
+                LogError("The session cache needs tlsio_openssl_init to be called");
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /* used from the next open */
+                tls_io_instance->is_session_cache_enabled = *(const bool*)value;
+                result = 0;
+            }
+        }
+        else if (strcmp(OPTION_TLS_RECEIVE_BUFFER_SIZE, optionName) == 0)
+        {
+            if (tls_io_instance->tlsio_state != TLSIO_STATE_NOT_OPEN)
+            {
+                LogError("Unable to set the receive buffer size while the tls connection is open");
+                result = MU_FAILURE;
+            }
+            else if (*(const size_t*)value == 0)
+            {
+                LogError("Invalid receive buffer size 0");
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /* allocated with the new size by the next read */
+                free(tls_io_instance->receive_buffer);
+                tls_io_instance->receive_buffer = NULL;
+                tls_io_instance->receive_buffer_size = *(const size_t*)value;
+                result = 0;
+            }
+        }
         else
         {
             if (tls_io_instance->underlying_io == NULL)
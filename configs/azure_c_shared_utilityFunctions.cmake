@@ -237,7 +237,8 @@ function(build_test_artifacts whatIsBuilding use_gballoc)
         if(
             (("${whatIsBuilding}" MATCHES ".*ut.*") AND ${run_unittests}) OR
             (("${whatIsBuilding}" MATCHES ".*e2e.*") AND ${run_e2e_tests}) OR
-            (("${whatIsBuilding}" MATCHES ".*int.*") AND ${run_int_tests})
+            (("${whatIsBuilding}" MATCHES ".*int.*") AND ${run_int_tests}) OR
+            (("${whatIsBuilding}" MATCHES ".*perf.*") AND ${run_perf_tests})
         )
                 windows_unittests_add_exe(${whatIsBuilding} ${ARGN})
                 if (${use_cppunittest})
@@ -256,7 +257,8 @@ function(build_test_artifacts whatIsBuilding use_gballoc)
         if(
             (("${whatIsBuilding}" MATCHES ".*ut.*") AND ${run_unittests}) OR
             (("${whatIsBuilding}" MATCHES ".*e2e.*") AND ${run_e2e_tests}) OR
-            (("${whatIsBuilding}" MATCHES ".*int.*") AND ${run_int_tests})
+            (("${whatIsBuilding}" MATCHES ".*int.*") AND ${run_int_tests}) OR
+            (("${whatIsBuilding}" MATCHES ".*perf.*") AND ${run_perf_tests})
         )
             linux_unittests_add_exe(${whatIsBuilding} ${ARGN})
         endif()
@@ -521,7 +523,8 @@ function(build_c_test_artifacts whatIsBuilding use_gballoc folder)
         if(
             (("${whatIsBuilding}" MATCHES ".*ut.*") AND ${run_unittests}) OR
             (("${whatIsBuilding}" MATCHES ".*e2e.*") AND ${run_e2e_tests}) OR
-            (("${whatIsBuilding}" MATCHES ".*int.*") AND ${run_int_tests})
+            (("${whatIsBuilding}" MATCHES ".*int.*") AND ${run_int_tests}) OR
+            (("${whatIsBuilding}" MATCHES ".*perf.*") AND ${run_perf_tests})
         )
             if (${use_cppunittest})
                 c_windows_unittests_add_dll(${whatIsBuilding} ${folder} ${ARGN})
@@ -540,7 +543,8 @@ function(build_c_test_artifacts whatIsBuilding use_gballoc folder)
         if(
             (("${whatIsBuilding}" MATCHES ".*ut.*") AND ${run_unittests}) OR
             (("${whatIsBuilding}" MATCHES ".*e2e.*") AND ${run_e2e_tests}) OR
-            (("${whatIsBuilding}" MATCHES ".*int.*") AND ${run_int_tests})
+            (("${whatIsBuilding}" MATCHES ".*int.*") AND ${run_int_tests}) OR
+            (("${whatIsBuilding}" MATCHES ".*perf.*") AND ${run_perf_tests})
         )
             c_linux_unittests_add_exe(${whatIsBuilding} ${folder} ${ARGN})
         endif()
@@ -553,7 +557,8 @@ function(compile_c_test_artifacts_as whatIsBuilding compileAsWhat)
         if(
             (("${whatIsBuilding}" MATCHES ".*ut.*") AND ${run_unittests}) OR
             (("${whatIsBuilding}" MATCHES ".*e2e.*") AND ${run_e2e_tests}) OR
-            (("${whatIsBuilding}" MATCHES ".*int.*") AND ${run_int_tests})
+            (("${whatIsBuilding}" MATCHES ".*int.*") AND ${run_int_tests}) OR
+            (("${whatIsBuilding}" MATCHES ".*perf.*") AND ${run_perf_tests})
         )
             if (${use_cppunittest})
                 if(${compileAsWhat} STREQUAL "C99")
@@ -589,7 +594,8 @@ function(compile_c_test_artifacts_as whatIsBuilding compileAsWhat)
         if(
             (("${whatIsBuilding}" MATCHES ".*ut.*") AND ${run_unittests}) OR
             (("${whatIsBuilding}" MATCHES ".*e2e.*") AND ${run_e2e_tests}) OR
-            (("${whatIsBuilding}" MATCHES ".*int.*") AND ${run_int_tests})
+            (("${whatIsBuilding}" MATCHES ".*int.*") AND ${run_int_tests}) OR
+            (("${whatIsBuilding}" MATCHES ".*perf.*") AND ${run_perf_tests})
         )
             if(${compileAsWhat} STREQUAL "C99")
                 compileTargetAsC99(${whatIsBuilding}_exe)
@@ -740,6 +746,7 @@ function(set_platform_files c_shared_dir)
             set(HTTP_C_FILE ${c_shared_dir}/adapters/httpapi_curl.c PARENT_SCOPE)
         endif()
         set(LOCK_C_FILE ${c_shared_dir}/adapters/lock_pthreads.c PARENT_SCOPE)
+        set(SRW_LOCK_C_FILE ${c_shared_dir}/adapters/srw_lock_pthreads.c PARENT_SCOPE)
         if (use_applessl)
             set(PLATFORM_C_FILE ${c_shared_dir}/pal/ios-osx/platform_appleios.c PARENT_SCOPE)
         else()
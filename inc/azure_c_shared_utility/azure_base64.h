@@ -71,13 +71,69 @@ MOCKABLE_FUNCTION(, STRING_HANDLE, Azure_Base64_Encode_Bytes, const unsigned cha
  *             @c Azure_Base64_Decode returns NULL. If the string pointed to by @p source is zero
  *             length then the handle returned refers to a zero length buffer. If there is any
  *             memory allocation failure during the decode or if the source string has an invalid
- *             length for a base 64 encoded string then @c Azure_Base64_Decode returns @c NULL.
+ *             length or content for a base 64 encoded string then @c Azure_Base64_Decode returns @c NULL.
  *
  * @return    A @c BUFFER_HANDLE pointing to a buffer containing the result of base64 decoding @p
  *             source.
  */
 MOCKABLE_FUNCTION(, BUFFER_HANDLE, Azure_Base64_Decode, const char*, source);
 
+/**
+ * @brief    Returns the number of characters in the base64 encoding of @p size bytes.
+ *
+ * @param    size    The number of bytes to encode.
+ *
+ * @return    The length of the encoding, not counting a terminating @c '\0', or @c SIZE_MAX if it does not fit in a @c size_t.
+ */
+MOCKABLE_FUNCTION(, size_t, Azure_Base64_Encoded_Length, size_t, size);
+
+/**
+ * @brief    Base64 encodes the buffer pointed to by @p source into the memory pointed to by @p destination.
+ *
+ * @param    source              The buffer that needs to be base64 encoded.
+ * @param    size                The size of @p source.
+ * @param    destination         Where the encoding is written, followed by a terminating @c '\0'.
+ * @param    destination_size    The size of @p destination, at least @c Azure_Base64_Encoded_Length(size) + 1.
+ *
+ *             Unlike @c Azure_Base64_Encode_Bytes, this function does not allocate memory. If @p source
+ *             or @p destination is @c NULL or if @p destination_size is too small, @c Azure_Base64_Encode_Bytes_Into
+ *             fails and leaves @p destination unchanged.
+ *
+ * @return    0 on success, a non-zero value otherwise.
+ */
+MOCKABLE_FUNCTION(, int, Azure_Base64_Encode_Bytes_Into, const unsigned char*, source, size_t, size, char*, destination, size_t, destination_size);
+
+/**
+ * @brief    Returns the number of bytes in the decoding of the @p length characters pointed to by @p source.
+ *
+ * @param    source    A base64 encoded string, not necessarily @c '\0' terminated.
+ * @param    length    The number of characters in @p source.
+ *
+ *             Only the length and the padding of @p source are looked at. If @p source is @c NULL or
+ *             @p length is not a multiple of 4, @c Azure_Base64_Decoded_Length returns 0.
+ *
+ * @return    The number of bytes that @c Azure_Base64_Decode_Into writes for @p source.
+ */
+MOCKABLE_FUNCTION(, size_t, Azure_Base64_Decoded_Length, const char*, source, size_t, length);
+
+/**
+ * @brief    Base64 decodes the @p length characters pointed to by @p source into the memory pointed to by @p destination.
+ *
+ * @param    source              A base64 encoded string, not necessarily @c '\0' terminated.
+ * @param    length              The number of characters in @p source.
+ * @param    destination         Where the decoded bytes are written.
+ * @param    destination_size    The size of @p destination, at least @c Azure_Base64_Decoded_Length(source, length).
+ * @param    decoded_size        Receives the number of bytes written to @p destination.
+ *
+ *             Unlike @c Azure_Base64_Decode, this function does not allocate memory. It fails if any argument
+ *             is @c NULL, if @p length is not a multiple of 4, if @p destination_size is too small or if
+ *             @p source contains a character that is not in the base64 alphabet or misplaced padding.
+ *             On failure the content of @p destination is undefined.
+ *
+ * @return    0 on success, a non-zero value otherwise.
+ */
+MOCKABLE_FUNCTION(, int, Azure_Base64_Decode_Into, const char*, source, size_t, length, unsigned char*, destination, size_t, destination_size, size_t*, decoded_size);
+
 #ifdef __cplusplus
 }
 #endif
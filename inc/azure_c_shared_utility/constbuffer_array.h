@@ -19,6 +19,7 @@ extern "C" {
 #endif
 
 typedef struct CONSTBUFFER_ARRAY_HANDLE_DATA_TAG* CONSTBUFFER_ARRAY_HANDLE;
+typedef struct CONSTBUFFER_ARRAY_CURSOR_HANDLE_DATA_TAG* CONSTBUFFER_ARRAY_CURSOR_HANDLE;
 
 /*create*/
 MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create, const CONSTBUFFER_HANDLE*, buffers, uint32_t, buffer_count);
@@ -26,6 +27,10 @@ MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create_with_move
 MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create_empty);
 MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create_from_array_array, const CONSTBUFFER_ARRAY_HANDLE*, buffer_arrays, uint32_t, buffer_array_count);
 
+/*slice, sharing the buffers*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create_from_buffer_index_and_count, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, uint32_t, start_buffer_index, uint32_t, buffer_count);
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create_from_offset_and_size, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, uint32_t, offset, uint32_t, size);
+
 MOCKABLE_FUNCTION(, void, constbuffer_array_inc_ref, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle);
 MOCKABLE_FUNCTION(, void, constbuffer_array_dec_ref, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle);
 
@@ -45,6 +50,14 @@ MOCKABLE_FUNCTION(, const CONSTBUFFER_HANDLE*, constbuffer_array_get_const_buffe
 /*compare*/
 MOCKABLE_FUNCTION(, bool, CONSTBUFFER_ARRAY_HANDLE_contain_same, CONSTBUFFER_ARRAY_HANDLE, left, CONSTBUFFER_ARRAY_HANDLE, right);
 
+/*cursor*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_CURSOR_HANDLE, constbuffer_array_cursor_create, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle);
+MOCKABLE_FUNCTION(, void, constbuffer_array_cursor_destroy, CONSTBUFFER_ARRAY_CURSOR_HANDLE, cursor);
+MOCKABLE_FUNCTION(, int, constbuffer_array_cursor_get_remaining_size, CONSTBUFFER_ARRAY_CURSOR_HANDLE, cursor, uint32_t*, remaining_size);
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_cursor_consume, CONSTBUFFER_ARRAY_CURSOR_HANDLE, cursor, uint32_t, size);
+MOCKABLE_FUNCTION(, int, constbuffer_array_cursor_read, CONSTBUFFER_ARRAY_CURSOR_HANDLE, cursor, unsigned char*, destination, uint32_t, size);
+MOCKABLE_FUNCTION(, int, constbuffer_array_cursor_skip, CONSTBUFFER_ARRAY_CURSOR_HANDLE, cursor, uint32_t, size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -16,9 +16,20 @@
 extern "C" {
 #endif
 
+typedef struct CONSTBUFFER_ARRAY_BATCHER_HANDLE_DATA_TAG* CONSTBUFFER_ARRAY_BATCHER_HANDLE;
+
+/*batch is only valid for the duration of the callback, call constbuffer_array_inc_ref to keep it*/
+typedef void(*ON_CONSTBUFFER_ARRAY_BATCH_COMPLETE)(void* context, CONSTBUFFER_ARRAY_HANDLE batch);
+
 MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_batcher_batch, CONSTBUFFER_ARRAY_HANDLE*, payloads, uint32_t, count);
 MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE*, constbuffer_array_batcher_unbatch, CONSTBUFFER_ARRAY_HANDLE, batch, uint32_t*, payload_count);
 
+/*incremental batching, batches are produced as soon as they reach max_payload_count payloads or max_batch_size bytes*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_BATCHER_HANDLE, constbuffer_array_batcher_create, uint32_t, max_payload_count, uint32_t, max_batch_size, ON_CONSTBUFFER_ARRAY_BATCH_COMPLETE, on_batch_complete, void*, on_batch_complete_context);
+MOCKABLE_FUNCTION(, void, constbuffer_array_batcher_destroy, CONSTBUFFER_ARRAY_BATCHER_HANDLE, batcher);
+MOCKABLE_FUNCTION(, int, constbuffer_array_batcher_append, CONSTBUFFER_ARRAY_BATCHER_HANDLE, batcher, CONSTBUFFER_ARRAY_HANDLE, payload);
+MOCKABLE_FUNCTION(, int, constbuffer_array_batcher_finish, CONSTBUFFER_ARRAY_BATCHER_HANDLE, batcher);
+
 #ifdef __cplusplus
 }
 #endif
@@ -47,6 +47,12 @@ MOCKABLE_FUNCTION(, size_t, gballoc_getCurrentMemoryUsed);
 MOCKABLE_FUNCTION(, size_t, gballoc_getAllocationCount);
 MOCKABLE_FUNCTION(, void, gballoc_resetMetrics);
 
+/* counters of the size class pool (GB_USE_POOL), they are 0 when gballoc is built without the pool and SIZE_MAX (like the other metrics) without GB_DEBUG_ALLOC */
+MOCKABLE_FUNCTION(, size_t, gballoc_getPoolHitCount);
+MOCKABLE_FUNCTION(, size_t, gballoc_getPoolMissCount);
+MOCKABLE_FUNCTION(, size_t, gballoc_getPoolReservedMemory);
+MOCKABLE_FUNCTION(, size_t, gballoc_getPoolWastedMemory);
+
 /* if GB_MEASURE_MEMORY_FOR_THIS is defined then we want to redirect memory allocation functions to gballoc_xxx functions */
 #ifdef GB_MEASURE_MEMORY_FOR_THIS
 /* Unfortunately this is still needed here for things to still compile when using _CRTDBG_MAP_ALLOC.
@@ -78,6 +84,11 @@ That is because there is a rogue component (most likely CppUnitTest) including c
 #define gballoc_getAllocationCount() SIZE_MAX
 #define gballoc_resetMetrics() ((void)0)
 
+#define gballoc_getPoolHitCount() SIZE_MAX
+#define gballoc_getPoolMissCount() SIZE_MAX
+#define gballoc_getPoolReservedMemory() SIZE_MAX
+#define gballoc_getPoolWastedMemory() SIZE_MAX
+
 #endif /* GB_DEBUG_ALLOC */
 
 #ifdef __cplusplus
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/** @file httpapi_async.h
+ *    @brief   Runs many HTTP requests at once on one thread (httpapi_curl only).
+ *
+ *    @details httpapi_async_create starts a thread that drives all the requests given to
+ *             httpapi_async_execute_request with one curl multi handle, so that the requests
+ *             share the connections to their hosts and none of them blocks the thread that
+ *             submitted it. HTTPAPI_Init shall be called before httpapi_async_create.
+ *
+ *             A request is sent with the host and options (certificates, proxy, timeouts...) of
+ *             the HTTP_HANDLE it is given. The HTTP_HANDLE shall not be closed, nor used with
+ *             HTTPAPI_ExecuteRequest or HTTPAPI_SetOption, while it has requests in flight.
+ */
+
+#ifndef HTTPAPI_ASYNC_H
+#define HTTPAPI_ASYNC_H
+
+#include "azure_c_shared_utility/httpapi.h"
+#include "azure_c_shared_utility/httpheaders.h"
+#include "azure_c_shared_utility/buffer_.h"
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct HTTPAPI_ASYNC_TAG* HTTPAPI_ASYNC_HANDLE;
+
+/* called on the thread of the httpapi_async instance once the request is done. The status code, headers and content
+are only meaningful when result is HTTPAPI_OK, the headers and content are owned by httpapi_async and are only valid
+for the duration of the call. Requests still in flight when httpapi_async_destroy is called complete with HTTPAPI_ERROR. */
+typedef void(*ON_HTTPAPI_ASYNC_REQUEST_COMPLETE)(void* context, HTTPAPI_RESULT result, unsigned int status_code, HTTP_HEADERS_HANDLE response_headers, BUFFER_HANDLE response_content);
+
+MOCKABLE_FUNCTION(, HTTPAPI_ASYNC_HANDLE, httpapi_async_create);
+/* waits for the thread of httpapi_async to end. Called from on_request_complete, it returns at once and the thread tears
+httpapi_async down after on_request_complete returns: the other requests in flight complete with HTTPAPI_ERROR there and
+httpapi_async shall not be used anymore. That thread is joined by the next httpapi_async_create or httpapi_async_destroy,
+or at the latest by HTTPAPI_Deinit. */
+MOCKABLE_FUNCTION(, void, httpapi_async_destroy, HTTPAPI_ASYNC_HANDLE, httpapi_async);
+
+/* the request headers are copied, request_content (can be NULL) is sent as is and shall not change nor be deleted
+until on_request_complete is called. Can be called from any thread, also from on_request_complete. */
+MOCKABLE_FUNCTION(, int, httpapi_async_execute_request, HTTPAPI_ASYNC_HANDLE, httpapi_async, HTTP_HANDLE, http_handle, HTTPAPI_REQUEST_TYPE, request_type, const char*, relative_path,
+    HTTP_HEADERS_HANDLE, request_headers, BUFFER_HANDLE, request_content, ON_HTTPAPI_ASYNC_REQUEST_COMPLETE, on_request_complete, void*, on_request_complete_context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HTTPAPI_ASYNC_H */
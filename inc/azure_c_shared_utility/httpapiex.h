@@ -18,8 +18,10 @@
 
 #ifdef __cplusplus
 #include <cstddef>
+#include <cstdint>
 #else
 #include <stddef.h>
+#include <stdint.h>
 #endif
 
 #include "macro_utils/macro_utils.h"
@@ -43,6 +45,36 @@ typedef struct HTTPAPIEX_HANDLE_DATA_TAG* HTTPAPIEX_HANDLE;
 */
 MU_DEFINE_ENUM(HTTPAPIEX_RESULT, HTTPAPIEX_RESULT_VALUES);
 
+/** @brief Configuration of the connection pool of an HTTPAPIEX handle, set with the
+*          OPTION_HTTPAPIEX_CONNECTION_POOL option.
+*
+*   With a connection pool the connections of the handle stay open between requests
+*   and @c HTTPAPIEX_ExecuteRequest can be called on the handle from several threads
+*   at once, each request leasing one of the connections. @c HTTPAPIEX_SetOption and
+*   @c HTTPAPIEX_Destroy shall not be called while requests are running. The pool
+*   needs @c HTTPAPIEX_Init to have been called.
+*/
+typedef struct HTTPAPIEX_CONNECTION_POOL_CONFIG_TAG
+{
+    /*connections to the host, leased and idle, requests wait for a connection once all of them are leased*/
+    size_t max_connections;
+    /*connections kept open between requests, the others are closed when their request completes*/
+    size_t max_idle_connections;
+    /*idle connections older than this are closed instead of being leased, 0 keeps them open*/
+    uint32_t idle_timeout_ms;
+} HTTPAPIEX_CONNECTION_POOL_CONFIG;
+
+typedef struct HTTPAPIEX_CONNECTION_POOL_STATISTICS_TAG
+{
+    uint64_t connections_created;
+    uint64_t connections_reused;
+    /*idle connections closed because they were too old or the pool had enough idle connections*/
+    uint64_t connections_evicted;
+    /*requests that failed and were sent again on a new connection*/
+    uint64_t requests_retried;
+    size_t idle_connections;
+} HTTPAPIEX_CONNECTION_POOL_STATISTICS;
+
 /**
  * @brief    Initialize the HTTPAPIEX.
  *
@@ -121,6 +153,17 @@ MOCKABLE_FUNCTION(, void, HTTPAPIEX_Destroy, HTTPAPIEX_HANDLE, handle);
  */
 MOCKABLE_FUNCTION(, HTTPAPIEX_RESULT, HTTPAPIEX_SetOption, HTTPAPIEX_HANDLE, handle, const char*, optionName, const void*, value);
 
+/**
+ * @brief    Gets the statistics of the connection pool of the handle.
+ *
+ * @param    handle        The @c HTTPAPIEX_HANDLE with a connection pool.
+ * @param    statistics    Receives the counters since the pool was created.
+ *
+ * @return    @c HTTPAPIEX_INVALID_ARG if an argument is @c NULL or the handle has no connection pool,
+ *            @c HTTPAPIEX_OK otherwise.
+ */
+MOCKABLE_FUNCTION(, HTTPAPIEX_RESULT, HTTPAPIEX_GetConnectionPoolStatistics, HTTPAPIEX_HANDLE, handle, HTTPAPIEX_CONNECTION_POOL_STATISTICS*, statistics);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,14 @@
 *                  of all the headers
 *                - ::HTTPHeaders_GetHeader - when the application needs to retrieve the
 *                  <code>name + ": " + value</code> string based on an index.
+*                - ::HTTPHeaders_GetHeaderView - when the application walks the headers
+*                  to send them, it gets the name, value and <code>name + ": " + value</code>
+*                  string of the header at an index without any allocation.
+*
+*             Header names are case-insensitive (RFC 7230, section 3.2): adding "Content-Type"
+*             after "content-type" appends to the existing header, which keeps the name it was
+*             first added with. The names are hashed, finding or changing a header does not
+*             depend on how many headers there are.
 */
 
 #ifndef HTTPHEADERS_H
@@ -47,6 +55,18 @@ HTTP_HEADERS_ERROR                \
 MU_DEFINE_ENUM(HTTP_HEADERS_RESULT, HTTP_HEADERS_RESULT_VALUES);
 typedef struct HTTP_HEADERS_HANDLE_DATA_TAG* HTTP_HEADERS_HANDLE;
 
+/** @brief A header as stored in the collection. The strings belong to the collection and are
+*          valid until the header is changed or the collection is freed.
+*/
+typedef struct HTTP_HEADER_VIEW_TAG
+{
+    const char* name;
+    const char* value;
+    /** @brief The header rendered as <code>name + ": " + value</code>, as ::HTTPHeaders_GetHeader produces it. */
+    const char* line;
+    size_t line_length;
+} HTTP_HEADER_VIEW;
+
 /**
  * @brief    Produces a @c HTTP_HANDLE that can later be used in subsequent calls to the module.
  *
@@ -141,6 +161,22 @@ MOCKABLE_FUNCTION(, HTTP_HEADERS_RESULT, HTTPHeaders_GetHeaderCount, HTTP_HEADER
  */
 MOCKABLE_FUNCTION(, HTTP_HEADERS_RESULT, HTTPHeaders_GetHeader, HTTP_HEADERS_HANDLE, handle, size_t, index, char**, destination);
 
+/**
+ * @brief    This API retrieves the header element at the given @p index
+ *             without copying it.
+ *
+ * @param    handle            A valid @c HTTP_HEADERS_HANDLE value.
+ * @param    index            Zero-based index of the item in the
+ *                             headers collection.
+ * @param   header            Receives pointers to the name, the value and the
+ *                             name+": "+value string of the header, they are
+ *                             owned by @p handle.
+ *
+ * @return    Returns @c HTTP_HEADERS_OK when execution is successful or
+ *             @c HTTP_HEADERS_INVALID_ARG when an argument is invalid.
+ */
+MOCKABLE_FUNCTION(, HTTP_HEADERS_RESULT, HTTPHeaders_GetHeaderView, HTTP_HEADERS_HANDLE, handle, size_t, index, HTTP_HEADER_VIEW*, header);
+
 /**
  * @brief    This API produces a clone of the @p handle parameter.
  *
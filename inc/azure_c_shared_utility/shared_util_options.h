@@ -62,6 +62,17 @@ extern "C"
     static STATIC_VAR_UNUSED const char* const OPTION_ADDRESS_TYPE_DOMAIN_SOCKET = "DOMAIN_SOCKET";
     static STATIC_VAR_UNUSED const char* const OPTION_ADDRESS_TYPE_IP_SOCKET = "IP_SOCKET";
 
+    // value is a SOCKETIO_REACTOR_HANDLE (see socketio.h)
+    static STATIC_VAR_UNUSED const char* const OPTION_SOCKETIO_REACTOR = "socketio_reactor";
+
+    // value is a size_t*, the size of the buffer the decrypted bytes are read into and handed to on_bytes_received in (tlsio_openssl only)
+    static STATIC_VAR_UNUSED const char* const OPTION_TLS_RECEIVE_BUFFER_SIZE = "tls_receive_buffer_size";
+    // value is a bool*, true to save the TLS sessions of this connection and resume them on the next connections to the same host and port, with the same host name check (tlsio_openssl and tlsio_mbedtls only)
+    static STATIC_VAR_UNUSED const char* const OPTION_TLS_SESSION_CACHE = "tls_session_cache";
+
+    // value is a const HTTPAPIEX_CONNECTION_POOL_CONFIG* (see httpapiex.h), keeps the connections of an HTTPAPIEX handle open between requests and shares them between threads (httpapiex only)
+    static STATIC_VAR_UNUSED const char* const OPTION_HTTPAPIEX_CONNECTION_POOL = "httpapiex_connection_pool";
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,6 +11,7 @@
 #endif /* __cplusplus */
 
 #include "azure_c_shared_utility/xio.h"
+#include "azure_c_shared_utility/constbuffer.h"
 #include "azure_c_shared_utility/xlogging.h"
 #include "umock_c/umock_c_prod.h"
 
@@ -35,6 +36,13 @@ typedef enum SOCKETIO_ADDRESS_TYPE_TAG
 #define XIO_RECEIVE_BUFFER_SIZE     64
 #endif
 
+/* An epoll based reactor for many socket IOs (Linux, socketio_berkeley only).
+Socket IOs attached with the OPTION_SOCKETIO_REACTOR option are not polled by socketio_dowork once open:
+socketio_reactor_dowork waits for up to timeout_ms and does the sends and receives of the sockets that are ready.
+socketio_dowork still has to be called for them while they open. The reactor and its socket IOs shall be used from one thread.
+Destroying the reactor lets go of the socket IOs still set to use it: they are polled by socketio_dowork again. */
+typedef struct SOCKETIO_REACTOR_TAG* SOCKETIO_REACTOR_HANDLE;
+
 MOCKABLE_FUNCTION(, CONCRETE_IO_HANDLE, socketio_create, void*, io_create_parameters);
 MOCKABLE_FUNCTION(, void, socketio_destroy, CONCRETE_IO_HANDLE, socket_io);
 MOCKABLE_FUNCTION(, int, socketio_open, CONCRETE_IO_HANDLE, socket_io, ON_IO_OPEN_COMPLETE, on_io_open_complete, void*, on_io_open_complete_context, ON_BYTES_RECEIVED, on_bytes_received, void*, on_bytes_received_context, ON_IO_ERROR, on_io_error, void*, on_io_error_context);
@@ -45,6 +53,15 @@ MOCKABLE_FUNCTION(, int, socketio_setoption, CONCRETE_IO_HANDLE, socket_io, cons
 
 MOCKABLE_FUNCTION(, const IO_INTERFACE_DESCRIPTION*, socketio_get_interface_description);
 
+/* like socketio_send, but what the socket cannot take right away is queued as a reference to buffer instead of a copy */
+MOCKABLE_FUNCTION(, int, socketio_send_constbuffer, CONCRETE_IO_HANDLE, socket_io, CONSTBUFFER_HANDLE, buffer, ON_SEND_COMPLETE, on_send_complete, void*, callback_context);
+/* sends the bytes of all the buffers as one send: socketio_berkeley gathers them in sendmsg iovs and keeps a reference to buffers for what the socket does not take right away */
+MOCKABLE_FUNCTION(, int, socketio_send_array, CONCRETE_IO_HANDLE, socket_io, CONSTBUFFER_ARRAY_HANDLE, buffers, ON_SEND_COMPLETE, on_send_complete, void*, callback_context);
+
+MOCKABLE_FUNCTION(, SOCKETIO_REACTOR_HANDLE, socketio_reactor_create);
+MOCKABLE_FUNCTION(, void, socketio_reactor_destroy, SOCKETIO_REACTOR_HANDLE, reactor);
+MOCKABLE_FUNCTION(, int, socketio_reactor_dowork, SOCKETIO_REACTOR_HANDLE, reactor, int, timeout_ms);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
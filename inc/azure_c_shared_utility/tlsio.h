@@ -5,6 +5,7 @@
 #define TLSIO_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "xio.h"
 
 #ifdef __cplusplus
@@ -20,6 +21,21 @@ typedef struct TLSIO_CONFIG_TAG
     bool invoke_on_send_complete_callback_for_fragments;
 } TLSIO_CONFIG;
 
+/* handshakes completed by the connections of a TLS adapter since its init */
+typedef struct TLSIO_HANDSHAKE_STATISTICS_TAG
+{
+    uint64_t handshake_count;
+    /* handshakes started with a saved session (OPTION_TLS_SESSION_CACHE), and those the server resumed it in */
+    uint64_t session_offer_count;
+    uint64_t resumed_handshake_count;
+    /* the time from the start to the end of the handshakes, all of them and the resumed ones */
+    uint64_t handshake_time_ms;
+    uint64_t resumed_handshake_time_ms;
+    /* the processor time used by the process while the TLS library ran the handshakes */
+    uint64_t handshake_cpu_time_us;
+    uint64_t resumed_handshake_cpu_time_us;
+} TLSIO_HANDSHAKE_STATISTICS;
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
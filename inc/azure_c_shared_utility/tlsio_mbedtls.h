@@ -5,6 +5,7 @@
 #define TLSIO_MBEDTLS_H
 
 #include "azure_c_shared_utility/xio.h"
+#include "azure_c_shared_utility/tlsio.h"
 #include "umock_c/umock_c_prod.h"
 
 #ifdef __cplusplus
@@ -16,6 +17,10 @@ extern "C" {
 
 extern const IO_INTERFACE_DESCRIPTION* tlsio_mbedtls_get_interface_description(void);
 
+MOCKABLE_FUNCTION(, int, tlsio_mbedtls_init);
+MOCKABLE_FUNCTION(, void, tlsio_mbedtls_deinit);
+MOCKABLE_FUNCTION(, int, tlsio_mbedtls_get_handshake_statistics, TLSIO_HANDSHAKE_STATISTICS*, statistics);
+
 MOCKABLE_FUNCTION(, CONCRETE_IO_HANDLE, tlsio_mbedtls_create, void*, io_create_parameters);
 MOCKABLE_FUNCTION(, void, tlsio_mbedtls_destroy, CONCRETE_IO_HANDLE, tls_io);
 MOCKABLE_FUNCTION(, int, tlsio_mbedtls_open, CONCRETE_IO_HANDLE, tls_io, ON_IO_OPEN_COMPLETE, on_io_open_complete, void*, on_io_open_complete_context, ON_BYTES_RECEIVED, on_bytes_received, void*, on_bytes_received_context, ON_IO_ERROR, on_io_error, void*, on_io_error_context);
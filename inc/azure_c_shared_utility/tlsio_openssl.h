@@ -5,6 +5,7 @@
 #define TLSIO_OPENSSL_H
 
 #include "azure_c_shared_utility/xio.h"
+#include "azure_c_shared_utility/tlsio.h"
 #include "umock_c/umock_c_prod.h"
 
 #ifdef __cplusplus
@@ -24,9 +25,17 @@ MOCKABLE_FUNCTION(, int, tlsio_openssl_close, CONCRETE_IO_HANDLE, tls_io, ON_IO_
 MOCKABLE_FUNCTION(, int, tlsio_openssl_send, CONCRETE_IO_HANDLE, tls_io, const void*, buffer, size_t, size, ON_SEND_COMPLETE, on_send_complete, void*, callback_context);
 MOCKABLE_FUNCTION(, void, tlsio_openssl_dowork, CONCRETE_IO_HANDLE, tls_io);
 MOCKABLE_FUNCTION(, int, tlsio_openssl_setoption, CONCRETE_IO_HANDLE, tls_io, const char*, optionName, const void*, value);
+/* sends the buffers as one send: on_send_complete is called once for all of them. On failure on_send_complete is not called.
+If it fails before any of the buffers was written to the TLS stream (not open, a buffer larger than INT_MAX bytes, ...), nothing is sent
+and the tlsio can still be used. If it fails after a part of them was written, the peer would get that part without the rest: the tlsio
+indicates an error with on_io_error and shall be closed. */
+MOCKABLE_FUNCTION(, int, tlsio_openssl_send_array, CONCRETE_IO_HANDLE, tls_io, CONSTBUFFER_ARRAY_HANDLE, buffers, ON_SEND_COMPLETE, on_send_complete, void*, callback_context);
 
 MOCKABLE_FUNCTION(, const IO_INTERFACE_DESCRIPTION*, tlsio_openssl_get_interface_description);
 
+/* copies the handshake counters of all the tlsio_openssl connections, tlsio_openssl_init shall have been called */
+MOCKABLE_FUNCTION(, int, tlsio_openssl_get_handshake_statistics, TLSIO_HANDSHAKE_STATISTICS*, statistics);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -45,6 +45,17 @@ MU_DEFINE_ENUM_WITHOUT_INVALID(WS_FRAME_TYPE, WS_FRAME_TYPE_VALUES);
 
 MOCKABLE_FUNCTION(, BUFFER_HANDLE, uws_frame_encoder_encode, WS_FRAME_TYPE, opcode, const unsigned char*, payload, size_t, length, bool, is_masked, bool, is_final, unsigned char, reserved);
 
+/* the size of the header (masking key included) of a frame carrying length bytes of payload */
+MOCKABLE_FUNCTION(, size_t, uws_frame_encoder_get_header_size, size_t, length, bool, is_masked);
+/* writes only the header of a frame in the memory given by the caller. The payload can then be masked with the last 4 bytes
+of a masked header as the masking key and sent after the header, without building the frame in one buffer */
+MOCKABLE_FUNCTION(, int, uws_frame_encoder_encode_header, unsigned char*, header, size_t, header_size, WS_FRAME_TYPE, opcode, size_t, length, bool, is_masked, bool, is_final, unsigned char, reserved);
+/* like uws_frame_encoder_encode, but the frame is written in the memory given by the caller, which needs
+uws_frame_encoder_get_header_size(length, is_masked) + length bytes */
+MOCKABLE_FUNCTION(, int, uws_frame_encoder_encode_into, unsigned char*, destination, size_t, destination_size, WS_FRAME_TYPE, opcode, const unsigned char*, payload, size_t, length, bool, is_masked, bool, is_final, unsigned char, reserved);
+/* XORs length bytes of source with the 4 byte masking key into destination, which can be source itself */
+MOCKABLE_FUNCTION(, void, uws_frame_encoder_mask, unsigned char*, destination, const unsigned char*, source, size_t, length, const unsigned char*, masking_key);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -11,6 +11,7 @@
 #endif /* __cplusplus */
 
 #include "azure_c_shared_utility/optionhandler.h"
+#include "azure_c_shared_utility/constbuffer_array.h"
 
 #include "umock_c/umock_c_prod.h"
 #include "macro_utils/macro_utils.h"
@@ -50,6 +51,7 @@ typedef int(*IO_CLOSE)(CONCRETE_IO_HANDLE concrete_io, ON_IO_CLOSE_COMPLETE on_i
 typedef int(*IO_SEND)(CONCRETE_IO_HANDLE concrete_io, const void* buffer, size_t size, ON_SEND_COMPLETE on_send_complete, void* callback_context);
 typedef void(*IO_DOWORK)(CONCRETE_IO_HANDLE concrete_io);
 typedef int(*IO_SETOPTION)(CONCRETE_IO_HANDLE concrete_io, const char* optionName, const void* value);
+typedef int(*IO_SEND_ARRAY)(CONCRETE_IO_HANDLE concrete_io, CONSTBUFFER_ARRAY_HANDLE buffers, ON_SEND_COMPLETE on_send_complete, void* callback_context);
 
 
 typedef struct IO_INTERFACE_DESCRIPTION_TAG
@@ -62,6 +64,9 @@ typedef struct IO_INTERFACE_DESCRIPTION_TAG
     IO_SEND concrete_io_send;
     IO_DOWORK concrete_io_dowork;
     IO_SETOPTION concrete_io_setoption;
+    /* optional, last so that descriptions which do not set it leave it NULL: xio_send_array then sends the buffers copied one after the other with concrete_io_send.
+    Adding it changed the size of IO_INTERFACE_DESCRIPTION: concrete IOs compiled against an older xio.h have to be rebuilt, xio_send_array would read past the end of their description */
+    IO_SEND_ARRAY concrete_io_send_array;
 } IO_INTERFACE_DESCRIPTION;
 
 MOCKABLE_FUNCTION(, XIO_HANDLE, xio_create, const IO_INTERFACE_DESCRIPTION*, io_interface_description, const void*, io_create_parameters);
@@ -69,6 +74,7 @@ MOCKABLE_FUNCTION(, void, xio_destroy, XIO_HANDLE, xio);
 MOCKABLE_FUNCTION(, int, xio_open, XIO_HANDLE, xio, ON_IO_OPEN_COMPLETE, on_io_open_complete, void*, on_io_open_complete_context, ON_BYTES_RECEIVED, on_bytes_received, void*, on_bytes_received_context, ON_IO_ERROR, on_io_error, void*, on_io_error_context);
 MOCKABLE_FUNCTION(, int, xio_close, XIO_HANDLE, xio, ON_IO_CLOSE_COMPLETE, on_io_close_complete, void*, callback_context);
 MOCKABLE_FUNCTION(, int, xio_send, XIO_HANDLE, xio, const void*, buffer, size_t, size, ON_SEND_COMPLETE, on_send_complete, void*, callback_context);
+MOCKABLE_FUNCTION(, int, xio_send_array, XIO_HANDLE, xio, CONSTBUFFER_ARRAY_HANDLE, buffers, ON_SEND_COMPLETE, on_send_complete, void*, callback_context);
 MOCKABLE_FUNCTION(, void, xio_dowork, XIO_HANDLE, xio);
 MOCKABLE_FUNCTION(, int, xio_setoption, XIO_HANDLE, xio, const char*, optionName, const void*, value);
 MOCKABLE_FUNCTION(, OPTIONHANDLER_HANDLE, xio_retrieveoptions, XIO_HANDLE, xio);
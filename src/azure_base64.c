@@ -3,185 +3,465 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/azure_base64.h"
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/safe_math.h"
 
+/*on x86 and x64 blocks of 12 (SSSE3) or 24 (AVX2) bytes are encoded, and blocks of 16 or 32 characters are decoded, with vector instructions.
+The instruction set is picked at run time, the table driven code below handles the rest of the data and the other architectures.*/
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) && (defined(__GNUC__) || defined(_MSC_VER))
+#define BASE64_SIMD
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define BASE64_TARGET(instruction_set)
+#else
+#define BASE64_TARGET(instruction_set) __attribute__((target(instruction_set)))
+#endif
+#endif
 
-#define splitInt(intVal, bytePos)   (char)((intVal >> (bytePos << 3)) & 0xFF)
-#define joinChars(a, b, c, d) (uint32_t)((uint32_t)a + ((uint32_t)b << 8) + ((uint32_t)c << 16) + ((uint32_t)d << 24))
+#define BASE64_INVALID 0xFF
 
-static char base64char(unsigned char val)
+static const char base64_alphabet[64] =
 {
-    char result;
+    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+    'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+    'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+    'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'
+};
 
-    if (val < 26)
-    {
-        result = 'A' + (char)val;
-    }
-    else if (val < 52)
-    {
-        result = 'a' + ((char)val - 26);
-    }
-    else if (val < 62)
-    {
-        result = '0' + ((char)val - 52);
-    }
-    else if (val == 62)
+/*the 6 bit value of each character, BASE64_INVALID for the characters not in the alphabet (so that OR-ing the values of a quantum tells if one of them is invalid)*/
+static const unsigned char base64_values[256] =
+{
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,   62, 0xFF, 0xFF, 0xFF,   63,
+      52,   53,   54,   55,   56,   57,   58,   59,   60,   61, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF,    0,    1,    2,    3,    4,    5,    6,    7,    8,    9,   10,   11,   12,   13,   14,
+      15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   25, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF,   26,   27,   28,   29,   30,   31,   32,   33,   34,   35,   36,   37,   38,   39,   40,
+      41,   42,   43,   44,   45,   46,   47,   48,   49,   50,   51, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+#ifdef BASE64_SIMD
+
+#define BASE64_CPU_NOT_DETECTED -1
+#define BASE64_CPU_SCALAR 0
+#define BASE64_CPU_SSSE3 1
+#define BASE64_CPU_AVX2 2
+
+/*detected once, racing threads all write the same value*/
+static int g_cpu_instruction_set = BASE64_CPU_NOT_DETECTED;
+
+static int get_cpu_instruction_set(void)
+{
+    if (g_cpu_instruction_set == BASE64_CPU_NOT_DETECTED)
     {
-        result = '+';
+        int result = BASE64_CPU_SCALAR;
+#ifdef _MSC_VER
+        int cpu_info[4];
+        int max_leaf;
+        __cpuid(cpu_info, 0);
+        max_leaf = cpu_info[0];
+        __cpuid(cpu_info, 1);
+        if ((cpu_info[2] & (1 << 9)) != 0)
+        {
+            /*AVX2 also needs the OS to save the YMM registers (OSXSAVE, AVX and XCR0 bits 1 and 2)*/
+            bool os_saves_ymm = ((cpu_info[2] & (1 << 27)) != 0) && ((cpu_info[2] & (1 << 28)) != 0) && ((_xgetbv(0) & 6) == 6);
+            result = BASE64_CPU_SSSE3;
+            if ((max_leaf >= 7) && os_saves_ymm)
+            {
+                __cpuidex(cpu_info, 7, 0);
+                if ((cpu_info[1] & (1 << 5)) != 0)
+                {
+                    result = BASE64_CPU_AVX2;
+                }
+            }
+        }
+#else
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            result = BASE64_CPU_AVX2;
+        }
+        else if (__builtin_cpu_supports("ssse3"))
+        {
+            result = BASE64_CPU_SSSE3;
+        }
+#endif
+        g_cpu_instruction_set = result;
     }
-    else
+    return g_cpu_instruction_set;
+}
+
+/*spreads the 3 bytes of each 4 byte group (in the order 1 0 2 1) into 4 bytes of 6 bits*/
+BASE64_TARGET("ssse3")
+static __m128i encode_reshuffle_ssse3(__m128i input)
+{
+    __m128i in = _mm_shuffle_epi8(input, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+/*adds to each 6 bit value the offset of its range in the alphabet: A-Z, a-z, 0-9, + and /*/
+BASE64_TARGET("ssse3")
+static __m128i encode_translate_ssse3(__m128i values)
+{
+    const __m128i offsets = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+    __m128i range = _mm_subs_epu8(values, _mm_set1_epi8(51));
+    range = _mm_sub_epi8(range, _mm_cmpgt_epi8(values, _mm_set1_epi8(25)));
+    return _mm_add_epi8(values, _mm_shuffle_epi8(offsets, range));
+}
+
+/*returns how many bytes were encoded, 16 bytes are read for every 12 encoded*/
+BASE64_TARGET("ssse3")
+static size_t encode_blocks_ssse3(const unsigned char* source, size_t size, char* destination)
+{
+    size_t position = 0;
+    while (size - position >= 16)
     {
-        result = '/';
+        __m128i input = _mm_loadu_si128((const __m128i*)(source + position));
+        _mm_storeu_si128((__m128i*)destination, encode_translate_ssse3(encode_reshuffle_ssse3(input)));
+        position += 12;
+        destination += 16;
     }
+    return position;
+}
 
-    return result;
+BASE64_TARGET("avx2")
+static __m256i encode_reshuffle_avx2(__m256i input)
+{
+    __m256i in = _mm256_shuffle_epi8(input, _mm256_set_epi8(
+        10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+        10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    return _mm256_or_si256(t1, t3);
 }
 
-static char base64b16(unsigned char val)
+BASE64_TARGET("avx2")
+static __m256i encode_translate_avx2(__m256i values)
 {
-    const uint32_t base64b16values[4] = {
-        joinChars('A', 'E', 'I', 'M'),
-        joinChars('Q', 'U', 'Y', 'c'),
-        joinChars('g', 'k', 'o', 's'),
-        joinChars('w', '0', '4', '8')
-    };
-    return splitInt(base64b16values[val >> 2], (val & 0x03));
+    const __m256i offsets = _mm256_setr_epi8(
+        65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+        65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+    __m256i range = _mm256_subs_epu8(values, _mm256_set1_epi8(51));
+    range = _mm256_sub_epi8(range, _mm256_cmpgt_epi8(values, _mm256_set1_epi8(25)));
+    return _mm256_add_epi8(values, _mm256_shuffle_epi8(offsets, range));
 }
 
-static char base64b8(unsigned char val)
+/*returns how many bytes were encoded, each lane encodes 12 bytes so 28 bytes are read for every 24 encoded*/
+BASE64_TARGET("avx2")
+static size_t encode_blocks_avx2(const unsigned char* source, size_t size, char* destination)
 {
-    const uint32_t base64b8values = joinChars('A', 'Q', 'g', 'w');
-    return splitInt(base64b8values, val);
+    size_t position = 0;
+    while (size - position >= 28)
+    {
+        __m256i input = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(source + position))),
+            _mm_loadu_si128((const __m128i*)(source + position + 12)), 1);
+        _mm256_storeu_si256((__m256i*)destination, encode_translate_avx2(encode_reshuffle_avx2(input)));
+        position += 24;
+        destination += 32;
+    }
+    return position;
 }
 
-static int base64toValue(char base64character, unsigned char* value)
+/*returns how many characters were decoded, stops before the first block that has a character not in the alphabet.
+16 bytes are written for every 12 decoded, length leaves room for them (see decode_body)*/
+BASE64_TARGET("ssse3")
+static size_t decode_blocks_ssse3(const char* source, size_t length, unsigned char* destination)
 {
-    int result = 0;
-    if (('A' <= base64character) && (base64character <= 'Z'))
+    /*a character is in the alphabet when the bits picked by its low nibble and by its high nibble do not intersect*/
+    const __m128i valid_low = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i valid_high = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    /*offset from the character to its value, by high nibble ('/' uses the slot before the one of '+')*/
+    const __m128i offsets = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+    size_t position = 0;
+    while (length - position >= 20)
     {
-        *value = base64character - 'A';
+        __m128i input = _mm_loadu_si128((const __m128i*)(source + position));
+        __m128i high_nibbles = _mm_and_si128(_mm_srli_epi32(input, 4), nibble_mask);
+        __m128i low_nibbles = _mm_and_si128(input, nibble_mask);
+        __m128i invalid = _mm_and_si128(_mm_shuffle_epi8(valid_low, low_nibbles), _mm_shuffle_epi8(valid_high, high_nibbles));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(invalid, _mm_setzero_si128())) != 0xFFFF)
+        {
+            break;
+        }
+        else
+        {
+            __m128i is_slash = _mm_cmpeq_epi8(input, _mm_set1_epi8('/'));
+            __m128i values = _mm_add_epi8(input, _mm_shuffle_epi8(offsets, _mm_add_epi8(is_slash, high_nibbles)));
+            /*joins 4 values of 6 bits into 3 bytes, then puts the bytes in memory order*/
+            __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+            __m128i quantums = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+            __m128i output = _mm_shuffle_epi8(quantums, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+            _mm_storeu_si128((__m128i*)destination, output);
+            position += 16;
+            destination += 12;
+        }
     }
-    else if (('a' <= base64character) && (base64character <= 'z'))
+    return position;
+}
+
+/*32 bytes are written for every 24 decoded, length leaves room for them (see decode_body)*/
+BASE64_TARGET("avx2")
+static size_t decode_blocks_avx2(const char* source, size_t length, unsigned char* destination)
+{
+    const __m256i valid_low = _mm256_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i valid_high = _mm256_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i offsets = _mm256_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+    size_t position = 0;
+    while (length - position >= 44)
     {
-        *value = ('Z' - 'A') + 1 + (base64character - 'a');
+        __m256i input = _mm256_loadu_si256((const __m256i*)(source + position));
+        __m256i high_nibbles = _mm256_and_si256(_mm256_srli_epi32(input, 4), nibble_mask);
+        __m256i low_nibbles = _mm256_and_si256(input, nibble_mask);
+        __m256i invalid = _mm256_and_si256(_mm256_shuffle_epi8(valid_low, low_nibbles), _mm256_shuffle_epi8(valid_high, high_nibbles));
+        if (!_mm256_testz_si256(invalid, invalid))
+        {
+            break;
+        }
+        else
+        {
+            __m256i is_slash = _mm256_cmpeq_epi8(input, _mm256_set1_epi8('/'));
+            __m256i values = _mm256_add_epi8(input, _mm256_shuffle_epi8(offsets, _mm256_add_epi8(is_slash, high_nibbles)));
+            __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+            __m256i quantums = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+            __m256i output = _mm256_shuffle_epi8(quantums, _mm256_setr_epi8(
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+            /*each lane has 12 bytes, make them contiguous*/
+            output = _mm256_permutevar8x32_epi32(output, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+            _mm256_storeu_si256((__m256i*)destination, output);
+            position += 32;
+            destination += 24;
+        }
     }
-    else if (('0' <= base64character) && (base64character <= '9'))
+    return position;
+}
+
+#endif
+
+/*encodes size bytes, a multiple of 3*/
+static void encode_body(const unsigned char* source, size_t size, char* destination)
+{
+    size_t position = 0;
+
+#ifdef BASE64_SIMD
+    switch (get_cpu_instruction_set())
     {
-        *value = ('Z' - 'A') + 1 + ('z' - 'a') + 1 + (base64character - '0');
+        case BASE64_CPU_AVX2:
+            position = encode_blocks_avx2(source, size, destination);
+            break;
+        case BASE64_CPU_SSSE3:
+            position = encode_blocks_ssse3(source, size, destination);
+            break;
+        default:
+            break;
     }
-    else if ('+' == base64character)
+    destination += position / 3 * 4;
+#endif
+
+    /*b0            b1(+1)          b2(+2)
+    7 6 5 4 3 2 1 0 7 6 5 4 3 2 1 0 7 6 5 4 3 2 1 0
+    |----c1---| |----c2---| |----c3---| |----c4---|
+    */
+    while (position < size)
     {
-        *value = 62;
+        uint32_t bits = ((uint32_t)source[position] << 16) | ((uint32_t)source[position + 1] << 8) | (uint32_t)source[position + 2];
+        destination[0] = base64_alphabet[bits >> 18];
+        destination[1] = base64_alphabet[(bits >> 12) & 0x3F];
+        destination[2] = base64_alphabet[(bits >> 6) & 0x3F];
+        destination[3] = base64_alphabet[bits & 0x3F];
+        position += 3;
+        destination += 4;
     }
-    else if ('/' == base64character)
+}
+
+/*decodes length characters, a multiple of 4 without any padding. destination has room for at least one byte after the decoded ones.
+Returns 0 on success, a non-zero value if a character is not in the alphabet*/
+static int decode_body(const char* source, size_t length, unsigned char* destination)
+{
+    int result = 0;
+    size_t position = 0;
+
+#ifdef BASE64_SIMD
+    switch (get_cpu_instruction_set())
     {
-        *value = 63;
+        case BASE64_CPU_AVX2:
+            position = decode_blocks_avx2(source, length, destination);
+            break;
+        case BASE64_CPU_SSSE3:
+            position = decode_blocks_ssse3(source, length, destination);
+            break;
+        default:
+            break;
     }
-    else
+    destination += position / 4 * 3;
+#endif
+
+    while (position < length)
     {
-        *value = 0;
-        result = -1;
+        unsigned char c1 = base64_values[(unsigned char)source[position]];
+        unsigned char c2 = base64_values[(unsigned char)source[position + 1]];
+        unsigned char c3 = base64_values[(unsigned char)source[position + 2]];
+        unsigned char c4 = base64_values[(unsigned char)source[position + 3]];
+        if (((c1 | c2 | c3 | c4) & 0x80) != 0)
+        {
+            result = MU_FAILURE;
+            break;
+        }
+        destination[0] = (unsigned char)((c1 << 2) | (c2 >> 4));
+        destination[1] = (unsigned char)((c2 << 4) | (c3 >> 2));
+        destination[2] = (unsigned char)((c3 << 6) | c4);
+        position += 4;
+        destination += 3;
     }
     return result;
 }
 
-static size_t numberOfBase64Characters(const char* encodedString)
+/*encodes size bytes into Azure_Base64_Encoded_Length(size) characters followed by '\0'*/
+static void encode(const unsigned char* source, size_t size, char* destination)
 {
-    size_t length = 0;
-    unsigned char junkChar;
-    while (base64toValue(encodedString[length],&junkChar) != -1)
+    size_t body_size = size / 3 * 3;
+    encode_body(source, body_size, destination);
+    destination += body_size / 3 * 4;
+
+    if (size - body_size == 2)
+    {
+        destination[0] = base64_alphabet[source[body_size] >> 2];
+        destination[1] = base64_alphabet[((source[body_size] & 0x03) << 4) | (source[body_size + 1] >> 4)];
+        destination[2] = base64_alphabet[(source[body_size + 1] & 0x0F) << 2];
+        destination[3] = '=';
+        destination += 4;
+    }
+    else if (size - body_size == 1)
     {
-        length++;
+        destination[0] = base64_alphabet[source[body_size] >> 2];
+        destination[1] = base64_alphabet[(source[body_size] & 0x03) << 4];
+        destination[2] = '=';
+        destination[3] = '=';
+        destination += 4;
     }
-    return length;
+
+    /*null terminating the string*/
+    destination[0] = '\0';
 }
 
-/*returns the count of original bytes before being base64 encoded*/
-/*notice NO validation of the content of encodedString. Its length is validated to be a multiple of 4.*/
-static size_t Base64decode_len(const char *encodedString)
+/*decodes length characters, a non-zero multiple of 4, into Azure_Base64_Decoded_Length(source, length) bytes*/
+static int decode(const char* source, size_t length, unsigned char* destination)
 {
-    size_t result;
-    size_t sourceLength = strlen(encodedString);
+    int result;
+    /*the last quantum is the only one that can have padding*/
+    size_t body_length = length - 4;
+    const char* last = source + body_length;
 
-    if (sourceLength == 0)
+    if (decode_body(source, body_length, destination) != 0)
     {
-        result = 0;
+        result = MU_FAILURE;
     }
     else
     {
-        result = sourceLength / 4 * 3;
-        if (encodedString[sourceLength - 1] == '=')
+        unsigned char c1 = base64_values[(unsigned char)last[0]];
+        unsigned char c2 = base64_values[(unsigned char)last[1]];
+        destination += body_length / 4 * 3;
+
+        if (((c1 | c2) & 0x80) != 0)
+        {
+            result = MU_FAILURE;
+        }
+        else if (last[2] == '=')
         {
-            if (encodedString[sourceLength - 2] == '=')
+            if (last[3] != '=')
             {
-                result --;
+                result = MU_FAILURE;
+            }
+            else
+            {
+                destination[0] = (unsigned char)((c1 << 2) | (c2 >> 4));
+                result = 0;
+            }
+        }
+        else
+        {
+            unsigned char c3 = base64_values[(unsigned char)last[2]];
+            if ((c3 & 0x80) != 0)
+            {
+                result = MU_FAILURE;
+            }
+            else if (last[3] == '=')
+            {
+                destination[0] = (unsigned char)((c1 << 2) | (c2 >> 4));
+                destination[1] = (unsigned char)((c2 << 4) | (c3 >> 2));
+                result = 0;
+            }
+            else
+            {
+                unsigned char c4 = base64_values[(unsigned char)last[3]];
+                if ((c4 & 0x80) != 0)
+                {
+                    result = MU_FAILURE;
+                }
+                else
+                {
+                    destination[0] = (unsigned char)((c1 << 2) | (c2 >> 4));
+                    destination[1] = (unsigned char)((c2 << 4) | (c3 >> 2));
+                    destination[2] = (unsigned char)((c3 << 6) | c4);
+                    result = 0;
+                }
             }
-            result--;
         }
     }
     return result;
 }
 
-static void Base64decode(unsigned char *decodedString, const char *base64String)
+/*returns the count of original bytes before being base64 encoded*/
+/*notice NO validation of the content of source. Its length is expected to be a multiple of 4.*/
+static size_t get_decoded_length(const char* source, size_t length)
 {
-
-    size_t numberOfEncodedChars;
-    size_t indexOfFirstEncodedChar;
-    size_t decodedIndex;
-
-    //
-    // We can only operate on individual bytes.  If we attempt to work
-    // on anything larger we could get an alignment fault on some
-    // architectures
-    //
-
-    numberOfEncodedChars = numberOfBase64Characters(base64String);
-    indexOfFirstEncodedChar = 0;
-    decodedIndex = 0;
-    while (numberOfEncodedChars >= 4)
-    {
-        unsigned char c1;
-        unsigned char c2;
-        unsigned char c3;
-        unsigned char c4;
-        (void)base64toValue(base64String[indexOfFirstEncodedChar], &c1);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 1], &c2);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 2], &c3);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 3], &c4);
-        decodedString[decodedIndex] = (c1 << 2) | (c2 >> 4);
-        decodedIndex++;
-        decodedString[decodedIndex] = ((c2 & 0x0f) << 4) | (c3 >> 2);
-        decodedIndex++;
-        decodedString[decodedIndex] = ((c3 & 0x03) << 6) | c4;
-        decodedIndex++;
-        numberOfEncodedChars -= 4;
-        indexOfFirstEncodedChar += 4;
-
-    }
-
-    if (numberOfEncodedChars == 2)
-    {
-        unsigned char c1;
-        unsigned char c2;
-        (void)base64toValue(base64String[indexOfFirstEncodedChar], &c1);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 1], &c2);
-        decodedString[decodedIndex] = (c1 << 2) | (c2 >> 4);
-    }
-    else if (numberOfEncodedChars == 3)
-    {
-        unsigned char c1;
-        unsigned char c2;
-        unsigned char c3;
-        (void)base64toValue(base64String[indexOfFirstEncodedChar], &c1);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 1], &c2);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 2], &c3);
-        decodedString[decodedIndex] = (c1 << 2) | (c2 >> 4);
-        decodedIndex++;
-        decodedString[decodedIndex] = ((c2 & 0x0f) << 4) | (c3 >> 2);
+    size_t result;
+    if (length == 0)
+    {
+        result = 0;
+    }
+    else
+    {
+        result = length / 4 * 3;
+        if (source[length - 1] == '=')
+        {
+            if (source[length - 2] == '=')
+            {
+                result--;
+            }
+            result--;
+        }
     }
+    return result;
 }
 
 BUFFER_HANDLE Azure_Base64_Decode(const char* source)
@@ -195,7 +475,8 @@ BUFFER_HANDLE Azure_Base64_Decode(const char* source)
     }
     else
     {
-        if ((strlen(source) % 4) != 0)
+        size_t length = strlen(source);
+        if ((length % 4) != 0)
         {
             /*Codes_SRS_BASE64_06_011: [If the source string has an invalid length for a base 64 encoded string then Azure_Base64_Decode shall return NULL.]*/
             LogError("Invalid length Base64 string!");
@@ -210,7 +491,7 @@ BUFFER_HANDLE Azure_Base64_Decode(const char* source)
             }
             else
             {
-                size_t sizeOfOutputBuffer = Base64decode_len(source);
+                size_t sizeOfOutputBuffer = get_decoded_length(source, length);
                 /*Codes_SRS_BASE64_06_009: [If the string pointed to by source is zero length then the handle returned shall refer to a zero length buffer.]*/
                 if (sizeOfOutputBuffer > 0)
                 {
@@ -221,9 +502,12 @@ BUFFER_HANDLE Azure_Base64_Decode(const char* source)
                         BUFFER_delete(result);
                         result = NULL;
                     }
-                    else
+                    else if (decode(source, length, BUFFER_u_char(result)) != 0)
                     {
-                        Base64decode(BUFFER_u_char(result), source);
+                        /*Codes_SRS_BASE64_04_001: [If the source string has a character that is not in the base64 alphabet or misplaced padding then Azure_Base64_Decode shall return NULL.]*/
+                        LogError("Invalid Base64 string content");
+                        BUFFER_delete(result);
+                        result = NULL;
                     }
                 }
             }
@@ -232,18 +516,13 @@ BUFFER_HANDLE Azure_Base64_Decode(const char* source)
     return result;
 }
 
-
 static STRING_HANDLE Base64_Encode_Internal(const unsigned char* source, size_t size)
 {
     STRING_HANDLE result;
-    size_t neededSize = 0;
-    bool isBufferOverflow = false;
     char* encoded;
-    size_t currentPosition = 0;
-    neededSize = safe_add_size_t(neededSize, (size == 0) ? (0) : safe_multiply_size_t(safe_add_size_t(((safe_subtract_size_t(size, 1)) / 3), 1), 4));
-    neededSize = safe_add_size_t(neededSize, 1);  /*+1 because \0 at the end of the string*/
+    size_t neededSize = safe_add_size_t(Azure_Base64_Encoded_Length(size), 1);  /*+1 because \0 at the end of the string*/
 
-    if (neededSize == 0 || neededSize == SIZE_MAX)
+    if (neededSize == SIZE_MAX)
     {
         result = NULL;
         LogError("Azure_Base64_Encode:: Invalid size parameter, neededSize:%zu.", neededSize);
@@ -256,108 +535,14 @@ static STRING_HANDLE Base64_Encode_Internal(const unsigned char* source, size_t
     }
     else
     {
-        /*b0            b1(+1)          b2(+2)
-        7 6 5 4 3 2 1 0 7 6 5 4 3 2 1 0 7 6 5 4 3 2 1 0
-        |----c1---| |----c2---| |----c3---| |----c4---|
-        */
-
-        size_t destinationPosition = 0;
-        while (size - currentPosition >= 3)
-        {
-            char c1 = base64char(source[currentPosition] >> 2);
-            char c2 = base64char(
-                ((source[currentPosition] & 3) << 4) |
-                    (source[currentPosition + 1] >> 4)
-            );
-            char c3 = base64char(
-                ((source[currentPosition + 1] & 0x0F) << 2) |
-                    ((source[currentPosition + 2] >> 6) & 3)
-            );
-            char c4 = base64char(
-                source[currentPosition + 2] & 0x3F
-            );
-            currentPosition += 3;
-
-            if ((destinationPosition + 4) > neededSize)
-            {
-                LogError("Azure_Base64_Encode:: Invalid buffer size.");
-                isBufferOverflow = true;
-                break;
-            }
-            encoded[destinationPosition++] = c1;
-            encoded[destinationPosition++] = c2;
-            encoded[destinationPosition++] = c3;
-            encoded[destinationPosition++] = c4;
-
-        }
-
-        if (!isBufferOverflow && size - currentPosition == 2)
-        {
-            if ((destinationPosition + 4) > neededSize)
-            {
-                LogError("Azure_Base64_Encode:: Invalid buffer size.");
-                isBufferOverflow = true;
-            }
-            else
-            {
-                char c1 = base64char(source[currentPosition] >> 2);
-                char c2 = base64char(
-                    ((source[currentPosition] & 0x03) << 4) |
-                    (source[currentPosition + 1] >> 4)
-                );
-                char c3 = base64b16(source[currentPosition + 1] & 0x0F);
-                encoded[destinationPosition++] = c1;
-                encoded[destinationPosition++] = c2;
-                encoded[destinationPosition++] = c3;
-                encoded[destinationPosition++] = '=';
-            }
-        }
-        else if (!isBufferOverflow && size - currentPosition == 1)
-        {
-            if ((destinationPosition + 4) > neededSize)
-            {
-                LogError("Azure_Base64_Encode:: Invalid buffer size.");
-                isBufferOverflow = true;
-            }
-            else
-            {
-                char c1 = base64char(source[currentPosition] >> 2);
-                char c2 = base64b8(source[currentPosition] & 0x03);
-                encoded[destinationPosition++] = c1;
-                encoded[destinationPosition++] = c2;
-                encoded[destinationPosition++] = '=';
-                encoded[destinationPosition++] = '=';
-            }
-        }
+        encode(source, size, encoded);
 
-        /*null terminating the string*/
-        if (!isBufferOverflow)
-        {
-            if ((destinationPosition + 1) > neededSize)
-            {
-                LogError("Azure_Base64_Encode:: Invalid buffer size.");
-                isBufferOverflow = true;
-            }
-            else
-            {
-                encoded[destinationPosition] = '\0';
-            }
-        }
-
-        if (isBufferOverflow)
+        /*Codes_SRS_BASE64_06_007: [Otherwise Azure_Base64_Encode shall return a pointer to STRING, that string contains the base 64 encoding of input.]*/
+        result = STRING_new_with_memory(encoded);
+        if (result == NULL)
         {
             free(encoded);
-            result = NULL;
-        }
-        else
-        {
-            /*Codes_SRS_BASE64_06_007: [Otherwise Azure_Base64_Encode shall return a pointer to STRING, that string contains the base 64 encoding of input.]*/
-            result = STRING_new_with_memory(encoded);
-            if (result == NULL)
-            {
-                free(encoded);
-                LogError("Azure_Base64_Encode:: Allocation failed for return value.");
-            }
+            LogError("Azure_Base64_Encode:: Allocation failed for return value.");
         }
     }
     return result;
@@ -416,3 +601,107 @@ STRING_HANDLE Azure_Base64_Encode(BUFFER_HANDLE input)
     }
     return result;
 }
+
+size_t Azure_Base64_Encoded_Length(size_t size)
+{
+    /*Codes_SRS_BASE64_04_002: [Azure_Base64_Encoded_Length shall return 4 characters for every started group of 3 bytes in size, or SIZE_MAX if that does not fit in a size_t.]*/
+    return (size == 0) ? 0 : safe_multiply_size_t(size / 3 + ((size % 3 == 0) ? 0 : 1), 4);
+}
+
+int Azure_Base64_Encode_Bytes_Into(const unsigned char* source, size_t size, char* destination, size_t destination_size)
+{
+    int result;
+    size_t encoded_length = Azure_Base64_Encoded_Length(size);
+
+    if (
+        /*Codes_SRS_BASE64_04_003: [If source is NULL then Azure_Base64_Encode_Bytes_Into shall fail and return a non-zero value.]*/
+        (source == NULL) ||
+        /*Codes_SRS_BASE64_04_004: [If destination is NULL then Azure_Base64_Encode_Bytes_Into shall fail and return a non-zero value.]*/
+        (destination == NULL)
+        )
+    {
+        LogError("Invalid arguments: const unsigned char* source=%p, size_t size=%zu, char* destination=%p, size_t destination_size=%zu",
+            source, size, destination, destination_size);
+        result = MU_FAILURE;
+    }
+    /*Codes_SRS_BASE64_04_005: [If destination_size is less than Azure_Base64_Encoded_Length(size) + 1 then Azure_Base64_Encode_Bytes_Into shall fail and return a non-zero value.]*/
+    else if ((encoded_length == SIZE_MAX) || (destination_size <= encoded_length))
+    {
+        LogError("destination too small: destination_size=%zu, encoded length=%zu", destination_size, encoded_length);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_BASE64_04_006: [Otherwise Azure_Base64_Encode_Bytes_Into shall write the base64 encoding of source followed by a terminating '\0' to destination and return 0.]*/
+        encode(source, size, destination);
+        result = 0;
+    }
+    return result;
+}
+
+size_t Azure_Base64_Decoded_Length(const char* source, size_t length)
+{
+    size_t result;
+    /*Codes_SRS_BASE64_04_007: [If source is NULL or length is not a multiple of 4 then Azure_Base64_Decoded_Length shall return 0.]*/
+    if ((source == NULL) || (length % 4 != 0))
+    {
+        LogError("Invalid arguments: const char* source=%p, size_t length=%zu", source, length);
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_BASE64_04_008: [Otherwise Azure_Base64_Decoded_Length shall return 3 bytes for every 4 characters in source, minus 1 for each padding character at its end.]*/
+        result = get_decoded_length(source, length);
+    }
+    return result;
+}
+
+int Azure_Base64_Decode_Into(const char* source, size_t length, unsigned char* destination, size_t destination_size, size_t* decoded_size)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_BASE64_04_009: [If source is NULL then Azure_Base64_Decode_Into shall fail and return a non-zero value.]*/
+        (source == NULL) ||
+        /*Codes_SRS_BASE64_04_010: [If destination is NULL then Azure_Base64_Decode_Into shall fail and return a non-zero value.]*/
+        (destination == NULL) ||
+        /*Codes_SRS_BASE64_04_011: [If decoded_size is NULL then Azure_Base64_Decode_Into shall fail and return a non-zero value.]*/
+        (decoded_size == NULL) ||
+        /*Codes_SRS_BASE64_04_012: [If length is not a multiple of 4 then Azure_Base64_Decode_Into shall fail and return a non-zero value.]*/
+        (length % 4 != 0)
+        )
+    {
+        LogError("Invalid arguments: const char* source=%p, size_t length=%zu, unsigned char* destination=%p, size_t destination_size=%zu, size_t* decoded_size=%p",
+            source, length, destination, destination_size, decoded_size);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        size_t decoded_length = get_decoded_length(source, length);
+        if (destination_size < decoded_length)
+        {
+            /*Codes_SRS_BASE64_04_013: [If destination_size is less than Azure_Base64_Decoded_Length(source, length) then Azure_Base64_Decode_Into shall fail and return a non-zero value.]*/
+            LogError("destination too small: destination_size=%zu, decoded length=%zu", destination_size, decoded_length);
+            result = MU_FAILURE;
+        }
+        else if (length == 0)
+        {
+            /*Codes_SRS_BASE64_04_014: [If length is 0 then Azure_Base64_Decode_Into shall set decoded_size to 0 and return 0.]*/
+            *decoded_size = 0;
+            result = 0;
+        }
+        else if (decode(source, length, destination) != 0)
+        {
+            /*Codes_SRS_BASE64_04_015: [If source has a character that is not in the base64 alphabet or misplaced padding then Azure_Base64_Decode_Into shall fail and return a non-zero value.]*/
+            LogError("Invalid Base64 string content");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_BASE64_04_016: [Otherwise Azure_Base64_Decode_Into shall write the decoded bytes to destination, set decoded_size to their count and return 0.]*/
+            *decoded_size = decoded_length;
+            result = 0;
+        }
+    }
+    return result;
+}
@@ -14,6 +14,7 @@ typedef struct BUFFER_TAG
 {
     unsigned char* buffer;
     size_t size;
+    size_t capacity; /*number of bytes allocated for buffer, always >= size*/
 } BUFFER;
 
 /* Codes_SRS_BUFFER_07_001: [BUFFER_new shall allocate a BUFFER_HANDLE that will contain a NULL unsigned char*.] */
@@ -25,6 +26,7 @@ BUFFER_HANDLE BUFFER_new(void)
     {
         temp->buffer = NULL;
         temp->size = 0;
+        temp->capacity = 0;
     }
     return (BUFFER_HANDLE)temp;
 }
@@ -48,11 +50,45 @@ static int BUFFER_safemalloc(BUFFER* handleptr, size_t size)
     {
         // we still consider the real buffer size is 0
         handleptr->size = size;
+        handleptr->capacity = sizetomalloc;
         result = 0;
     }
     return result;
 }
 
+/*makes sure handleptr->buffer can hold size bytes. When it cannot, the capacity is at least doubled so that appending in a loop only reallocates O(log n) times*/
+static int BUFFER_grow(BUFFER* handleptr, size_t size)
+{
+    int result;
+    if (size <= handleptr->capacity)
+    {
+        result = 0;
+    }
+    else
+    {
+        unsigned char* temp;
+        size_t new_capacity = (handleptr->capacity > SIZE_MAX / 2) ? SIZE_MAX - 1 : handleptr->capacity * 2;
+        if (new_capacity < size)
+        {
+            new_capacity = size;
+        }
+
+        if (size == SIZE_MAX ||
+            (temp = (unsigned char*)realloc(handleptr->buffer, new_capacity)) == NULL)
+        {
+            LogError("Failure reallocating buffer, size:%zu", new_capacity);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            handleptr->buffer = temp;
+            handleptr->capacity = new_capacity;
+            result = 0;
+        }
+    }
+    return result;
+}
+
 BUFFER_HANDLE BUFFER_create(const unsigned char* source, size_t size)
 {
     BUFFER* result;
@@ -108,6 +144,7 @@ BUFFER_HANDLE BUFFER_create_with_size(size_t buff_size)
         {
             // Codes_SRS_BUFFER_07_031: [ BUFFER_create_with_size shall allocate a buffer of buff_size. ]
             result->size = buff_size;
+            result->capacity = buff_size;
             if ((result->buffer = (unsigned char*)malloc(result->size)) == NULL)
             {
                 // Codes_SRS_BUFFER_07_032: [ If allocating memory fails, then BUFFER_create_with_size shall return NULL. ]
@@ -161,6 +198,7 @@ int BUFFER_build(BUFFER_HANDLE handle, const unsigned char* source, size_t size)
         free(b->buffer);
         b->buffer = NULL;
         b->size = 0;
+        b->capacity = 0;
 
         result = 0;
     }
@@ -186,6 +224,7 @@ int BUFFER_build(BUFFER_HANDLE handle, const unsigned char* source, size_t size)
             {
                 b->buffer = newBuffer;
                 b->size = size;
+                b->capacity = size;
                 /* Codes_SRS_BUFFER_01_002: [The size argument can be zero, in which case nothing shall be copied from source.] */
                 (void)memcpy(b->buffer, source, size);
 
@@ -228,19 +267,17 @@ int BUFFER_append_build(BUFFER_HANDLE handle, const unsigned char* source, size_
         else
         {
             /* Codes_SRS_BUFFER_07_032: [ if handle->buffer is not NULL BUFFER_append_build shall realloc the buffer to be the handle->size + size ] */
-            unsigned char* temp;
+            /* Codes_SRS_BUFFER_07_044: [ BUFFER_append_build and BUFFER_enlarge shall not reallocate when the capacity of the buffer is already enough and shall at least double the capacity when it is not. ] */
             size_t malloc_size = safe_add_size_t(handle->size, size);
-            if (malloc_size == SIZE_MAX || 
-                (temp = (unsigned char*)realloc(handle->buffer, malloc_size)) == NULL)
+            if (BUFFER_grow(handle, malloc_size) != 0)
             {
                 /* Codes_SRS_BUFFER_07_035: [ If any error is encountered BUFFER_append_build shall return a non-null value. ] */
-                LogError("Failure reallocating temporary buffer, size:%zu", malloc_size);
+                LogError("Failure growing buffer, size:%zu", malloc_size);
                 result = MU_FAILURE;
             }
             else
             {
                 /* Codes_SRS_BUFFER_07_033: [ ... and copy the contents of source to the end of the buffer. ] */
-                handle->buffer = temp;
                 // Append the BUFFER
                 (void)memcpy(&handle->buffer[handle->size], source, size);
                 handle->size += size;
@@ -288,6 +325,7 @@ int BUFFER_pre_build(BUFFER_HANDLE handle, size_t size)
             else
             {
                 b->size = size;
+                b->capacity = size;
                 result = 0;
             }
         }
@@ -332,7 +370,7 @@ extern int BUFFER_unbuild(BUFFER_HANDLE handle)
             free(b->buffer);
             b->buffer = NULL;
             b->size = 0;
-        
+            b->capacity = 0;
         }
 
         /* Codes_SRS_BUFFER_07_015: [BUFFER_unbuild shall always return success if the unsigned char* referenced by BUFFER_HANDLE is NULL.] */
@@ -359,11 +397,10 @@ int BUFFER_enlarge(BUFFER_HANDLE handle, size_t enlargeSize)
     }
     else
     {
-        unsigned char* temp;
         BUFFER* b = (BUFFER*)handle;
         size_t malloc_size = safe_add_size_t(b->size, enlargeSize);
-        if (malloc_size == SIZE_MAX ||
-            (temp = (unsigned char*)realloc(b->buffer, malloc_size)) == NULL)
+        /* Codes_SRS_BUFFER_07_044: [ BUFFER_append_build and BUFFER_enlarge shall not reallocate when the capacity of the buffer is already enough and shall at least double the capacity when it is not. ] */
+        if (BUFFER_grow(b, malloc_size) != 0)
         {
             /* Codes_SRS_BUFFER_07_018: [BUFFER_enlarge shall return a nonzero result if any error is encountered.] */
             LogError("Failure: allocating temp buffer, size:%zu", malloc_size);
@@ -371,7 +408,6 @@ int BUFFER_enlarge(BUFFER_HANDLE handle, size_t enlargeSize)
         }
         else
         {
-            b->buffer = temp;
             b->size += enlargeSize;
             result = 0;
         }
@@ -410,6 +446,7 @@ int BUFFER_shrink(BUFFER_HANDLE handle, size_t decreaseSize, bool fromEnd)
             free(handle->buffer);
             handle->buffer = NULL;
             handle->size = 0;
+            handle->capacity = 0;
             result = 0;
         }
         else
@@ -430,6 +467,7 @@ int BUFFER_shrink(BUFFER_HANDLE handle, size_t decreaseSize, bool fromEnd)
                     free(handle->buffer);
                     handle->buffer = tmp;
                     handle->size = alloc_size;
+                    handle->capacity = alloc_size;
                     result = 0;
                 }
                 else
@@ -439,6 +477,7 @@ int BUFFER_shrink(BUFFER_HANDLE handle, size_t decreaseSize, bool fromEnd)
                     free(handle->buffer);
                     handle->buffer = tmp;
                     handle->size = alloc_size;
+                    handle->capacity = alloc_size;
                     result = 0;
                 }
             }
@@ -498,10 +537,8 @@ int BUFFER_append(BUFFER_HANDLE handle1, BUFFER_HANDLE handle2)
             else
             {
                 // b2->size != 0, whatever b1->size is
-                unsigned char* temp;
                 size_t malloc_size = safe_add_size_t(b1->size, b2->size);
-                if (malloc_size == SIZE_MAX || 
-                    (temp = (unsigned char*)realloc(b1->buffer, malloc_size)) == NULL)
+                if (BUFFER_grow(b1, malloc_size) != 0)
                 {
                     /* Codes_SRS_BUFFER_07_023: [BUFFER_append shall return a nonzero upon any error that is encountered.] */
                     LogError("Failure: allocating temp buffer.");
@@ -510,7 +547,6 @@ int BUFFER_append(BUFFER_HANDLE handle1, BUFFER_HANDLE handle2)
                 else
                 {
                     /* Codes_SRS_BUFFER_07_024: [BUFFER_append concatenates b2 onto b1 without modifying b2 and shall return zero on success.]*/
-                    b1->buffer = temp;
                     // Append the BUFFER
                     (void)memcpy(&b1->buffer[b1->size], b2->buffer, b2->size);
                     b1->size += b2->size;
@@ -584,6 +620,7 @@ int BUFFER_prepend(BUFFER_HANDLE handle1, BUFFER_HANDLE handle2)
                     free(b1->buffer);
                     b1->buffer = temp;
                     b1->size += b2->size;
+                    b1->capacity = malloc_size;
                     result = 0;
                 }
             }
@@ -684,3 +721,73 @@ BUFFER_HANDLE BUFFER_clone(BUFFER_HANDLE handle)
     }
     return result;
 }
+
+int BUFFER_reserve(BUFFER_HANDLE handle, size_t capacity)
+{
+    int result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_BUFFER_07_045: [ If handle is NULL BUFFER_reserve shall return a non-zero value. ] */
+        LogError("Invalid parameter specified, handle == NULL.");
+        result = MU_FAILURE;
+    }
+    else if (capacity <= handle->capacity)
+    {
+        /* Codes_SRS_BUFFER_07_046: [ If the buffer can already hold capacity bytes BUFFER_reserve shall not allocate and shall return zero. ] */
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_BUFFER_07_047: [ Otherwise BUFFER_reserve shall reallocate the buffer to exactly capacity bytes, preserving its content and its size. ] */
+        unsigned char* temp = (unsigned char*)realloc(handle->buffer, capacity);
+        if (temp == NULL)
+        {
+            /* Codes_SRS_BUFFER_07_048: [ If any error is encountered BUFFER_reserve shall leave the buffer unchanged and return a non-zero value. ] */
+            LogError("Failure reallocating buffer, size:%zu", capacity);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            handle->buffer = temp;
+            handle->capacity = capacity;
+            /* Codes_SRS_BUFFER_07_049: [ On success BUFFER_reserve shall return zero. ] */
+            result = 0;
+        }
+    }
+    return result;
+}
+
+int BUFFER_shrink_to_fit(BUFFER_HANDLE handle)
+{
+    int result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_BUFFER_07_050: [ If handle is NULL BUFFER_shrink_to_fit shall return a non-zero value. ] */
+        LogError("Invalid parameter specified, handle == NULL.");
+        result = MU_FAILURE;
+    }
+    else if (handle->size == 0 || handle->size == handle->capacity)
+    {
+        /* Codes_SRS_BUFFER_07_051: [ If the size of the buffer is 0 or equal to its capacity BUFFER_shrink_to_fit shall not allocate and shall return zero. ] */
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_BUFFER_07_052: [ Otherwise BUFFER_shrink_to_fit shall reallocate the buffer to its size. ] */
+        unsigned char* temp = (unsigned char*)realloc(handle->buffer, handle->size);
+        if (temp == NULL)
+        {
+            /* Codes_SRS_BUFFER_07_053: [ If any error is encountered BUFFER_shrink_to_fit shall leave the buffer unchanged and return a non-zero value. ] */
+            LogError("Failure reallocating buffer, size:%zu", handle->size);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            handle->buffer = temp;
+            handle->capacity = handle->size;
+            /* Codes_SRS_BUFFER_07_054: [ On success BUFFER_shrink_to_fit shall return zero. ] */
+            result = 0;
+        }
+    }
+    return result;
+}
@@ -229,6 +229,13 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateFromOffsetAn
             result->alias.buffer = handle->alias.buffer+offset;
             result->alias.size = size;
 
+            /*Codes_SRS_CONSTBUFFER_04_001: [ If handle was itself created by CONSTBUFFER_CreateFromOffsetAndSize then CONSTBUFFER_CreateFromOffsetAndSize shall use the handle that handle was created from instead of handle. ]*/
+            /*a view of a view holds the memory directly, so that slicing slices does not build a chain that CONSTBUFFER_DecRef walks*/
+            if (handle->buffer_type == CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE)
+            {
+                handle = handle->originalHandle;
+            }
+
             /*Codes_SRS_CONSTBUFFER_02_030: [ CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle. ]*/
             INC_REF_VAR(handle->count);
             result->originalHandle = handle;
@@ -2,6 +2,7 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #include <inttypes.h>
 
 #include "azure_c_shared_utility/gballoc.h"
@@ -12,20 +13,305 @@
 #include "azure_c_shared_utility/constbuffer_array.h"
 #include "azure_c_shared_utility/refcount.h"
 
+/*the CONSTBUFFER_HANDLEs are kept in a storage that several CONSTBUFFER_ARRAY_HANDLEs share. Each CONSTBUFFER_ARRAY_HANDLE sees a
+contiguous range of the storage: constbuffer_array_remove_front gives the range that starts one handle later,
+constbuffer_array_create_from_buffer_index_and_count gives any range inside it and constbuffer_array_add_front writes the new handle in the
+free slot just before the range, so none of them copies the handles. A storage is allocated together with the CONSTBUFFER_ARRAY_HANDLE that created it (its owner) and lives until the last
+CONSTBUFFER_ARRAY_HANDLE using it is gone.*/
+typedef struct CONSTBUFFER_ARRAY_STORAGE_TAG
+{
+    COUNT_TYPE count; /*how many CONSTBUFFER_ARRAY_HANDLEs use the storage*/
+    struct CONSTBUFFER_ARRAY_HANDLE_DATA_TAG* owner;
+    uint32_t capacity;
+    uint32_t first_used; /*handles[first_used] to handles[capacity - 1] are stored, each with a reference*/
+    bool created_with_moved_memory;
+    CONSTBUFFER_HANDLE* handles;
+} CONSTBUFFER_ARRAY_STORAGE;
+
 typedef struct CONSTBUFFER_ARRAY_HANDLE_DATA_TAG
 {
     uint32_t nBuffers;
-    bool created_with_moved_memory;
     CONSTBUFFER_HANDLE* buffers;
+    CONSTBUFFER_ARRAY_STORAGE* storage;
+    /*1 while the free slot before buffers can be taken by constbuffer_array_add_front on this array. Only the array that was at the front of
+    the storage when it was made gets it, so only add_front calls on the same array race for the slot and the one bringing it to 0 wins*/
+    COUNT_TYPE add_front_token;
+    uint32_t all_buffers_size;
+    bool all_buffers_size_overflows;
 #ifdef _MSC_VER
     /*warning C4200: nonstandard extension used: zero-sized array in struct/union : looks very standard in C99 and it is called flexible array. Documentation-wise is a flexible array, but called "unsized" in Microsoft's docs*/ /*https://msdn.microsoft.com/library/b6fae073.aspx*/
 #pragma warning(disable:4200)
 #endif
-    CONSTBUFFER_HANDLE buffers_memory[];
+    CONSTBUFFER_ARRAY_STORAGE storage_memory[]; /*only used by the owner of a storage, the handles follow it*/
 } CONSTBUFFER_ARRAY_HANDLE_DATA;
 
 DEFINE_REFCOUNT_TYPE(CONSTBUFFER_ARRAY_HANDLE_DATA);
 
+typedef struct CONSTBUFFER_ARRAY_CURSOR_HANDLE_DATA_TAG
+{
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle;
+    uint32_t buffer_index; /*the buffer the cursor is in, nBuffers when the cursor is at the end*/
+    uint32_t buffer_offset; /*where the cursor is in buffers[buffer_index]*/
+    uint32_t remaining_size;
+} CONSTBUFFER_ARRAY_CURSOR_HANDLE_DATA;
+
+/*free handles in front of the existing ones when constbuffer_array_add_front has to copy them, so that the next adds do not copy*/
+#define ADD_FRONT_HEADROOM(buffer_count) (buffer_count)
+
+/*creates a CONSTBUFFER_ARRAY_HANDLE that owns a new storage for capacity handles, with no handle in its range*/
+static CONSTBUFFER_ARRAY_HANDLE create_with_storage(uint32_t capacity)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+    size_t handles_size = (size_t)capacity * sizeof(CONSTBUFFER_HANDLE);
+
+    if (
+        (handles_size / sizeof(CONSTBUFFER_HANDLE) != capacity) ||
+        (handles_size > SIZE_MAX - sizeof(CONSTBUFFER_ARRAY_STORAGE))
+        )
+    {
+        LogError("capacity=%" PRIu32 " handles is too large", capacity);
+        result = NULL;
+    }
+    else
+    {
+        result = REFCOUNT_TYPE_CREATE_WITH_EXTRA_SIZE(CONSTBUFFER_ARRAY_HANDLE_DATA, sizeof(CONSTBUFFER_ARRAY_STORAGE) + handles_size);
+        if (result == NULL)
+        {
+            LogError("failure in malloc");
+            /*return as is*/
+        }
+        else
+        {
+            CONSTBUFFER_ARRAY_STORAGE* storage = &result->storage_memory[0];
+
+            INIT_REF_VAR(storage->count);
+            storage->owner = result;
+            storage->capacity = capacity;
+            storage->first_used = capacity;
+            storage->created_with_moved_memory = false;
+            storage->handles = (CONSTBUFFER_HANDLE*)&result->storage_memory[1];
+
+            result->storage = storage;
+            result->nBuffers = 0;
+            result->buffers = storage->handles + capacity;
+            result->add_front_token = 0;
+            result->all_buffers_size = 0;
+            result->all_buffers_size_overflows = false;
+        }
+    }
+
+    return result;
+}
+
+static void add_buffer_size(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_HANDLE buffer)
+{
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(buffer);
+    if (content != NULL)
+    {
+        if (
+#if SIZE_MAX > UINT32_MAX
+            (content->size > UINT32_MAX) ||
+#endif
+            (constbuffer_array_handle->all_buffers_size + (uint32_t)content->size < constbuffer_array_handle->all_buffers_size)
+            )
+        {
+            constbuffer_array_handle->all_buffers_size_overflows = true;
+        }
+        else
+        {
+            constbuffer_array_handle->all_buffers_size += (uint32_t)content->size;
+        }
+    }
+}
+
+/*sums the sizes of the buffers in the range once, when the array is made, so that constbuffer_array_get_all_buffers_size does not have to*/
+static void compute_all_buffers_size(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle)
+{
+    uint32_t i;
+
+    constbuffer_array_handle->all_buffers_size = 0;
+    constbuffer_array_handle->all_buffers_size_overflows = false;
+    for (i = 0; (i < constbuffer_array_handle->nBuffers) && !constbuffer_array_handle->all_buffers_size_overflows; i++)
+    {
+        add_buffer_size(constbuffer_array_handle, constbuffer_array_handle->buffers[i]);
+    }
+}
+
+static void storage_dec_ref(CONSTBUFFER_ARRAY_STORAGE* storage)
+{
+    if (DEC_REF_VAR(storage->count) == DEC_RETURN_ZERO)
+    {
+        uint32_t i;
+
+        for (i = storage->first_used; i < storage->capacity; i++)
+        {
+            CONSTBUFFER_DecRef(storage->handles[i]);
+        }
+
+        if (storage->created_with_moved_memory)
+        {
+            free(storage->handles);
+            storage->handles = NULL;
+        }
+
+        /*the storage is in the owner's memory*/
+        REFCOUNT_TYPE_DESTROY(CONSTBUFFER_ARRAY_HANDLE_DATA, storage->owner);
+    }
+}
+
+/*the size of a buffer of an array whose total size does not overflow, so it fits in uint32_t*/
+static uint32_t get_buffer_size(CONSTBUFFER_HANDLE buffer)
+{
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(buffer);
+    return (content == NULL) ? 0 : (uint32_t)content->size;
+}
+
+/*moves the position given by buffer_index and buffer_offset size bytes further and past the buffers that end there, so that
+buffer_offset is inside buffers[buffer_index] unless the position is at the end of the array*/
+static void skip_bytes(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint32_t* buffer_index, uint32_t* buffer_offset, uint32_t size)
+{
+    uint32_t index = *buffer_index;
+    uint32_t offset = *buffer_offset + size;
+
+    while (index < constbuffer_array_handle->nBuffers)
+    {
+        uint32_t buffer_size = get_buffer_size(constbuffer_array_handle->buffers[index]);
+        if (offset < buffer_size)
+        {
+            break;
+        }
+        offset -= buffer_size;
+        index++;
+    }
+
+    *buffer_index = index;
+    *buffer_offset = offset;
+}
+
+/*creates a CONSTBUFFER_ARRAY_HANDLE that shares the storage of constbuffer_array_handle and sees buffer_count of its buffers*/
+static CONSTBUFFER_ARRAY_HANDLE create_view(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint32_t start_buffer_index, uint32_t buffer_count)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    if ((start_buffer_index == 0) && (buffer_count == constbuffer_array_handle->nBuffers))
+    {
+        INC_REF(CONSTBUFFER_ARRAY_HANDLE_DATA, constbuffer_array_handle);
+        result = constbuffer_array_handle;
+    }
+    else
+    {
+        result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA); /*explicit 0*/
+        if (result == NULL)
+        {
+            LogError("failure in malloc");
+            /*return as is*/
+        }
+        else
+        {
+            (void)INC_REF_VAR(constbuffer_array_handle->storage->count);
+            result->storage = constbuffer_array_handle->storage;
+            result->buffers = constbuffer_array_handle->buffers + start_buffer_index;
+            result->nBuffers = buffer_count;
+            /*the slot before the view is used by constbuffer_array_handle*/
+            result->add_front_token = 0;
+            compute_all_buffers_size(result);
+        }
+    }
+
+    return result;
+}
+
+/*creates a CONSTBUFFER_ARRAY_HANDLE with the size bytes (size > 0) that start at buffer_offset in the buffer_index-th buffer. buffer_offset is
+inside that buffer and the bytes are in the array. Whole buffers are shared, only the buffers cut by the slice get a CONSTBUFFER_HANDLE
+of their own*/
+static CONSTBUFFER_ARRAY_HANDLE create_slice(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint32_t buffer_index, uint32_t buffer_offset, uint32_t size)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+    uint32_t end_index = buffer_index;
+    uint32_t end_size = buffer_offset + size; /*how many bytes of the last buffer are in the slice*/
+    uint32_t end_buffer_size = get_buffer_size(constbuffer_array_handle->buffers[end_index]);
+    uint32_t buffer_count;
+
+    while (end_size > end_buffer_size)
+    {
+        end_size -= end_buffer_size;
+        end_index++;
+        end_buffer_size = get_buffer_size(constbuffer_array_handle->buffers[end_index]);
+    }
+    buffer_count = end_index - buffer_index + 1;
+
+    if ((buffer_offset == 0) && (end_size == end_buffer_size))
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_014: [ If the slice starts and ends at buffer boundaries, constbuffer_array_create_from_offset_and_size shall share the storage of constbuffer_array_handle like constbuffer_array_create_from_buffer_index_and_count does. ]*/
+        result = create_view(constbuffer_array_handle, buffer_index, buffer_count);
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_04_018: [ If there are any failures then constbuffer_array_create_from_offset_and_size shall fail and return NULL. ]*/
+            LogError("failure in create_view");
+            /*return as is*/
+        }
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_015: [ Otherwise constbuffer_array_create_from_offset_and_size shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that can hold the buffers in the slice. ]*/
+        result = create_with_storage(buffer_count);
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_04_018: [ If there are any failures then constbuffer_array_create_from_offset_and_size shall fail and return NULL. ]*/
+            LogError("failure in malloc");
+            /*return as is*/
+        }
+        else
+        {
+            uint32_t i;
+
+            for (i = 0; i < buffer_count; i++)
+            {
+                CONSTBUFFER_HANDLE buffer = constbuffer_array_handle->buffers[buffer_index + i];
+                uint32_t start = (i == 0) ? buffer_offset : 0;
+                uint32_t end = (i == buffer_count - 1) ? end_size : get_buffer_size(buffer);
+
+                /*Codes_SRS_CONSTBUFFER_ARRAY_04_016: [ constbuffer_array_create_from_offset_and_size shall inc_ref the buffers that are entirely in the slice and shall call CONSTBUFFER_CreateFromOffsetAndSize for the first and the last buffer when only a part of them is in the slice. ]*/
+                if ((start == 0) && (end == get_buffer_size(buffer)))
+                {
+                    CONSTBUFFER_IncRef(buffer);
+                    result->storage->handles[i] = buffer;
+                }
+                else
+                {
+                    result->storage->handles[i] = CONSTBUFFER_CreateFromOffsetAndSize(buffer, start, end - start);
+                    if (result->storage->handles[i] == NULL)
+                    {
+                        /*Codes_SRS_CONSTBUFFER_ARRAY_04_018: [ If there are any failures then constbuffer_array_create_from_offset_and_size shall fail and return NULL. ]*/
+                        LogError("failure in CONSTBUFFER_CreateFromOffsetAndSize(buffer=%p, offset=%" PRIu32 ", size=%" PRIu32 ")", buffer, start, end - start);
+                        break;
+                    }
+                }
+            }
+
+            if (i < buffer_count)
+            {
+                uint32_t j;
+                for (j = 0; j < i; j++)
+                {
+                    CONSTBUFFER_DecRef(result->storage->handles[j]);
+                }
+                REFCOUNT_TYPE_DESTROY(CONSTBUFFER_ARRAY_HANDLE_DATA, result);
+                result = NULL;
+            }
+            else
+            {
+                result->storage->first_used = 0;
+                result->buffers = result->storage->handles;
+                result->nBuffers = buffer_count;
+                result->all_buffers_size = size;
+            }
+        }
+    }
+
+    return result;
+}
+
 IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create, const CONSTBUFFER_HANDLE*, buffers, uint32_t, buffer_count)
 {
     CONSTBUFFER_ARRAY_HANDLE result;
@@ -41,7 +327,7 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
     else
     {
         /* Codes_SRS_CONSTBUFFER_ARRAY_01_009: [ constbuffer_array_create shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that can hold buffer_count buffers. ]*/
-        result = REFCOUNT_TYPE_CREATE_WITH_EXTRA_SIZE(CONSTBUFFER_ARRAY_HANDLE_DATA, buffer_count * sizeof(CONSTBUFFER_HANDLE));
+        result = create_with_storage(buffer_count);
         if (result == NULL)
         {
             /* Codes_SRS_CONSTBUFFER_ARRAY_01_014: [ If any error occurs, constbuffer_array_create shall fail and return NULL. ]*/
@@ -51,9 +337,9 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
         {
             uint32_t i;
 
-            result->buffers = result->buffers_memory;
+            result->storage->first_used = 0;
+            result->buffers = result->storage->handles;
             result->nBuffers = buffer_count;
-            result->created_with_moved_memory = false;
 
             for (i = 0; i < buffer_count; i++)
             {
@@ -62,6 +348,9 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
                 result->buffers[i] = buffers[i];
             }
 
+            /* Codes_SRS_CONSTBUFFER_ARRAY_01_032: [ constbuffer_array_create shall compute the total size of the buffers by calling CONSTBUFFER_GetContent for each buffer. ]*/
+            compute_all_buffers_size(result);
+
             /* Codes_SRS_CONSTBUFFER_ARRAY_01_011: [ On success constbuffer_array_create shall return a non-NULL handle. ]*/
             goto all_ok;
         }
@@ -78,7 +367,7 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
     CONSTBUFFER_ARRAY_HANDLE result;
 
     /*Codes_SRS_CONSTBUFFER_ARRAY_02_004: [ constbuffer_array_create_empty shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE. ]*/
-    result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA); /*explicit 0*/
+    result = create_with_storage(0);
     if (result == NULL)
     {
         /*Codes_SRS_CONSTBUFFER_ARRAY_02_001: [ If are any failure is encountered, constbuffer_array_create_empty shall fail and return NULL. ]*/
@@ -88,9 +377,6 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
     else
     {
         /*Codes_SRS_CONSTBUFFER_ARRAY_02_041: [ constbuffer_array_create_empty shall succeed and return a non-NULL value. ]*/
-        result->created_with_moved_memory = false;
-        result->nBuffers = 0;
-        result->buffers = result->buffers_memory;
     }
     return result;
 }
@@ -108,7 +394,8 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
     }
     else
     {
-        result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA); /*explicit 0*/
+        /* Codes_SRS_CONSTBUFFER_ARRAY_01_029: [ Otherwise, constbuffer_array_create_with_move_buffers shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that holds the const buffers in buffers. ]*/
+        result = create_with_storage(0);
         if (result == NULL)
         {
             /* Codes_SRS_CONSTBUFFER_ARRAY_01_030: [ If any error occurs, constbuffer_array_create_with_move_buffers shall fail and return NULL. ]*/
@@ -117,9 +404,17 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
         }
         else
         {
-            result->created_with_moved_memory = true;
+            result->storage->created_with_moved_memory = true;
+            result->storage->handles = buffers;
+            result->storage->capacity = buffer_count;
+            result->storage->first_used = 0;
             result->buffers = buffers;
             result->nBuffers = buffer_count;
+
+            /* Codes_SRS_CONSTBUFFER_ARRAY_01_033: [ constbuffer_array_create_with_move_buffers shall compute the total size of the buffers by calling CONSTBUFFER_GetContent for each buffer. ]*/
+            compute_all_buffers_size(result);
+
+            /* Codes_SRS_CONSTBUFFER_ARRAY_01_031: [ On success constbuffer_array_create_with_move_buffers shall return a non-NULL handle. ]*/
         }
     }
 
@@ -184,7 +479,7 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
             else
             {
                 /*Codes_SRS_CONSTBUFFER_ARRAY_42_003: [ constbuffer_array_create_from_array_array shall allocate memory to hold all of the CONSTBUFFER_HANDLES from buffer_arrays. ]*/
-                result = REFCOUNT_TYPE_CREATE_WITH_EXTRA_SIZE(CONSTBUFFER_ARRAY_HANDLE_DATA, (total_buffer_count) * sizeof(CONSTBUFFER_HANDLE));
+                result = create_with_storage(total_buffer_count);
                 if (result == NULL)
                 {
                     /*Codes_SRS_CONSTBUFFER_ARRAY_42_008: [ If there are any failures then constbuffer_array_create_from_array_array shall fail and return NULL. ]*/
@@ -196,9 +491,9 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
                     uint32_t array_idx;
                     uint32_t source_idx;
 
+                    result->storage->first_used = 0;
                     result->nBuffers = total_buffer_count;
-                    result->created_with_moved_memory = false;
-                    result->buffers = result->buffers_memory;
+                    result->buffers = result->storage->handles;
 
                     for (dest_idx = 0, array_idx = 0; array_idx < buffer_array_count; ++array_idx)
                     {
@@ -208,6 +503,19 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
                             CONSTBUFFER_IncRef(buffer_arrays[array_idx]->buffers[source_idx]);
                             result->buffers[dest_idx] = buffer_arrays[array_idx]->buffers[source_idx];
                         }
+
+                        /*Codes_SRS_CONSTBUFFER_ARRAY_01_034: [ constbuffer_array_create_from_array_array shall compute the total size of the buffers from the total sizes of the arrays in buffer_arrays. ]*/
+                        if (
+                            buffer_arrays[array_idx]->all_buffers_size_overflows ||
+                            (result->all_buffers_size + buffer_arrays[array_idx]->all_buffers_size < result->all_buffers_size)
+                            )
+                        {
+                            result->all_buffers_size_overflows = true;
+                        }
+                        else
+                        {
+                            result->all_buffers_size += buffer_arrays[array_idx]->all_buffers_size;
+                        }
                     }
 
                     /*Codes_SRS_CONSTBUFFER_ARRAY_42_007: [ constbuffer_array_create_from_array_array shall succeed and return a non-NULL value. ]*/
@@ -221,6 +529,97 @@ allOk:;
     return result;
 }
 
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create_from_buffer_index_and_count, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, uint32_t, start_buffer_index, uint32_t, buffer_count)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_001: [ If constbuffer_array_handle is NULL then constbuffer_array_create_from_buffer_index_and_count shall fail and return NULL. ]*/
+        (constbuffer_array_handle == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_002: [ If start_buffer_index is greater than the number of buffers in constbuffer_array_handle then constbuffer_array_create_from_buffer_index_and_count shall fail and return NULL. ]*/
+        (start_buffer_index > constbuffer_array_handle->nBuffers) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_003: [ If start_buffer_index + buffer_count is greater than the number of buffers in constbuffer_array_handle then constbuffer_array_create_from_buffer_index_and_count shall fail and return NULL. ]*/
+        (buffer_count > constbuffer_array_handle->nBuffers - start_buffer_index)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, uint32_t start_buffer_index=%" PRIu32 ", uint32_t buffer_count=%" PRIu32,
+            constbuffer_array_handle, start_buffer_index, buffer_count);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_004: [ If the range is all the buffers of constbuffer_array_handle then constbuffer_array_create_from_buffer_index_and_count shall inc_ref constbuffer_array_handle and return it. ]*/
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_005: [ Otherwise constbuffer_array_create_from_buffer_index_and_count shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE. ]*/
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_006: [ constbuffer_array_create_from_buffer_index_and_count shall share the storage of constbuffer_array_handle, the new CONSTBUFFER_ARRAY_HANDLE holding buffer_count CONSTBUFFER_HANDLEs starting at start_buffer_index, without copying nor inc_ref-ing them. ]*/
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_007: [ constbuffer_array_create_from_buffer_index_and_count shall compute the total size of the buffers by calling CONSTBUFFER_GetContent for each buffer in the range. ]*/
+        result = create_view(constbuffer_array_handle, start_buffer_index, buffer_count);
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_04_008: [ If there are any failures then constbuffer_array_create_from_buffer_index_and_count shall fail and return NULL. ]*/
+            LogError("failure in create_view");
+            /*return as is*/
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_04_009: [ constbuffer_array_create_from_buffer_index_and_count shall succeed and return a non-NULL value. ]*/
+        }
+    }
+
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create_from_offset_and_size, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, uint32_t, offset, uint32_t, size)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_010: [ If constbuffer_array_handle is NULL then constbuffer_array_create_from_offset_and_size shall fail and return NULL. ]*/
+        (constbuffer_array_handle == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_011: [ If the total size of the buffers in constbuffer_array_handle overflows uint32_t then constbuffer_array_create_from_offset_and_size shall fail and return NULL. ]*/
+        (constbuffer_array_handle->all_buffers_size_overflows) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_012: [ If offset + size is greater than the total size of the buffers in constbuffer_array_handle then constbuffer_array_create_from_offset_and_size shall fail and return NULL. ]*/
+        (offset > constbuffer_array_handle->all_buffers_size) ||
+        (size > constbuffer_array_handle->all_buffers_size - offset)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, uint32_t offset=%" PRIu32 ", uint32_t size=%" PRIu32,
+            constbuffer_array_handle, offset, size);
+        result = NULL;
+    }
+    else if (size == 0)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_013: [ If size is 0 then constbuffer_array_create_from_offset_and_size shall create a new, empty CONSTBUFFER_ARRAY_HANDLE. ]*/
+        result = constbuffer_array_create_empty();
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_04_018: [ If there are any failures then constbuffer_array_create_from_offset_and_size shall fail and return NULL. ]*/
+            LogError("failure in constbuffer_array_create_empty");
+            /*return as is*/
+        }
+    }
+    else
+    {
+        uint32_t buffer_index = 0;
+        uint32_t buffer_offset = 0;
+
+        skip_bytes(constbuffer_array_handle, &buffer_index, &buffer_offset, offset);
+
+        result = create_slice(constbuffer_array_handle, buffer_index, buffer_offset, size);
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_04_018: [ If there are any failures then constbuffer_array_create_from_offset_and_size shall fail and return NULL. ]*/
+            LogError("failure in create_slice");
+            /*return as is*/
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_04_017: [ constbuffer_array_create_from_offset_and_size shall succeed and return a non-NULL value holding the size bytes that start offset bytes into constbuffer_array_handle. ]*/
+        }
+    }
+
+    return result;
+}
+
 IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_add_front, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, CONSTBUFFER_HANDLE, constbuffer_handle)
 {
     CONSTBUFFER_ARRAY_HANDLE result;
@@ -235,33 +634,100 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_add_fr
     }
     else
     {
-        /*Codes_SRS_CONSTBUFFER_ARRAY_02_042: [ constbuffer_array_add_front shall allocate enough memory to hold all of constbuffer_array_handle existing CONSTBUFFER_HANDLE and constbuffer_handle. ]*/
-        result = REFCOUNT_TYPE_CREATE_WITH_EXTRA_SIZE(CONSTBUFFER_ARRAY_HANDLE_DATA, ((size_t)constbuffer_array_handle->nBuffers + 1) * sizeof(CONSTBUFFER_HANDLE));
-        if (result == NULL)
+        CONSTBUFFER_ARRAY_STORAGE* storage = constbuffer_array_handle->storage;
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_01_035: [ If there is a free slot in the storage just before the CONSTBUFFER_HANDLEs of constbuffer_array_handle and constbuffer_array_add_front was not already called on constbuffer_array_handle, constbuffer_array_add_front shall share the storage of constbuffer_array_handle: ]*/
+        if (
+            (constbuffer_array_handle->buffers != storage->handles) &&
+            (constbuffer_array_handle->add_front_token == 1) &&
+            (DEC_REF_VAR(constbuffer_array_handle->add_front_token) == DEC_RETURN_ZERO)
+            )
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_01_036: [ constbuffer_array_add_front shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE. ]*/
+            result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA); /*explicit 0*/
+            if (result == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_02_011: [ If there any failures constbuffer_array_add_front shall fail and return NULL. ]*/
+                LogError("failure in malloc");
+                /*the free slot is still there for the next call*/
+                INIT_REF_VAR(constbuffer_array_handle->add_front_token);
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_01_037: [ constbuffer_array_add_front shall inc_ref constbuffer_handle and write it in the free slot. ]*/
+                CONSTBUFFER_IncRef(constbuffer_handle);
+                constbuffer_array_handle->buffers[-1] = constbuffer_handle;
+                storage->first_used--;
+                (void)INC_REF_VAR(storage->count);
+
+                result->storage = storage;
+                result->buffers = constbuffer_array_handle->buffers - 1;
+                result->nBuffers = constbuffer_array_handle->nBuffers + 1;
+                INIT_REF_VAR(result->add_front_token);
+
+                /*Codes_SRS_CONSTBUFFER_ARRAY_01_038: [ constbuffer_array_add_front shall compute the total size of the buffers from the total size of constbuffer_array_handle and the size of constbuffer_handle obtained by calling CONSTBUFFER_GetContent. ]*/
+                result->all_buffers_size = constbuffer_array_handle->all_buffers_size;
+                result->all_buffers_size_overflows = constbuffer_array_handle->all_buffers_size_overflows;
+                if (!result->all_buffers_size_overflows)
+                {
+                    add_buffer_size(result, constbuffer_handle);
+                }
+
+                /*Codes_SRS_CONSTBUFFER_ARRAY_02_010: [ constbuffer_array_add_front shall succeed and return a non-NULL value. ]*/
+                goto allOk;
+            }
+        }
+        else if (constbuffer_array_handle->nBuffers == UINT32_MAX)
         {
             /*Codes_SRS_CONSTBUFFER_ARRAY_02_011: [ If there any failures constbuffer_array_add_front shall fail and return NULL. ]*/
-            LogError("failure in malloc");
-            /*return as is*/
+            LogError("cannot add to an array of %" PRIu32 " buffers", constbuffer_array_handle->nBuffers);
         }
         else
         {
-            uint32_t i;
+            uint32_t buffer_count = constbuffer_array_handle->nBuffers + 1;
+            uint32_t capacity = buffer_count + ADD_FRONT_HEADROOM(buffer_count);
+            if (capacity < buffer_count)
+            {
+                capacity = buffer_count;
+            }
 
-            /*Codes_SRS_CONSTBUFFER_ARRAY_02_043: [ constbuffer_array_add_front shall copy constbuffer_handle and all of constbuffer_array_handle existing CONSTBUFFER_HANDLE. ]*/
-            /*Codes_SRS_CONSTBUFFER_ARRAY_02_044: [ constbuffer_array_add_front shall inc_ref all the CONSTBUFFER_HANDLE it had copied. ]*/
-            result->nBuffers = constbuffer_array_handle->nBuffers + 1;
-            result->created_with_moved_memory = false;
-            result->buffers = result->buffers_memory;
-            CONSTBUFFER_IncRef(constbuffer_handle);
-            result->buffers_memory[0] = constbuffer_handle;
-            for (i = 1; i < result->nBuffers; i++)
+            /*Codes_SRS_CONSTBUFFER_ARRAY_02_042: [ Otherwise constbuffer_array_add_front shall allocate enough memory to hold all of constbuffer_array_handle existing CONSTBUFFER_HANDLE and constbuffer_handle, and as many free slots in front of them. ]*/
+            result = create_with_storage(capacity);
+            if (result == NULL)
             {
-                CONSTBUFFER_IncRef(constbuffer_array_handle->buffers[i - 1]);
-                result->buffers[i] = constbuffer_array_handle->buffers[i - 1];
+                /*Codes_SRS_CONSTBUFFER_ARRAY_02_011: [ If there any failures constbuffer_array_add_front shall fail and return NULL. ]*/
+                LogError("failure in malloc");
+                /*return as is*/
             }
+            else
+            {
+                uint32_t i;
+
+                /*Codes_SRS_CONSTBUFFER_ARRAY_02_043: [ constbuffer_array_add_front shall copy constbuffer_handle and all of constbuffer_array_handle existing CONSTBUFFER_HANDLE. ]*/
+                /*Codes_SRS_CONSTBUFFER_ARRAY_02_044: [ constbuffer_array_add_front shall inc_ref all the CONSTBUFFER_HANDLE it had copied. ]*/
+                result->storage->first_used = capacity - buffer_count;
+                result->nBuffers = buffer_count;
+                result->buffers = result->storage->handles + result->storage->first_used;
+                CONSTBUFFER_IncRef(constbuffer_handle);
+                result->buffers[0] = constbuffer_handle;
+                for (i = 1; i < result->nBuffers; i++)
+                {
+                    CONSTBUFFER_IncRef(constbuffer_array_handle->buffers[i - 1]);
+                    result->buffers[i] = constbuffer_array_handle->buffers[i - 1];
+                }
+                INIT_REF_VAR(result->add_front_token);
 
-            /*Codes_SRS_CONSTBUFFER_ARRAY_02_010: [ constbuffer_array_add_front shall succeed and return a non-NULL value. ]*/
-            goto allOk;
+                /*Codes_SRS_CONSTBUFFER_ARRAY_01_038: [ constbuffer_array_add_front shall compute the total size of the buffers from the total size of constbuffer_array_handle and the size of constbuffer_handle obtained by calling CONSTBUFFER_GetContent. ]*/
+                result->all_buffers_size = constbuffer_array_handle->all_buffers_size;
+                result->all_buffers_size_overflows = constbuffer_array_handle->all_buffers_size_overflows;
+                if (!result->all_buffers_size_overflows)
+                {
+                    add_buffer_size(result, constbuffer_handle);
+                }
+
+                /*Codes_SRS_CONSTBUFFER_ARRAY_02_010: [ constbuffer_array_add_front shall succeed and return a non-NULL value. ]*/
+                goto allOk;
+            }
         }
     }
     /*Codes_SRS_CONSTBUFFER_ARRAY_02_011: [ If there any failures constbuffer_array_add_front shall fail and return NULL. ]*/
@@ -294,8 +760,8 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_remove
         }
         else
         {
-            /*Codes_SRS_CONSTBUFFER_ARRAY_02_046: [ constbuffer_array_remove_front shall allocate memory to hold all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the front one. ]*/
-            result = REFCOUNT_TYPE_CREATE_WITH_EXTRA_SIZE(CONSTBUFFER_ARRAY_HANDLE_DATA, (constbuffer_array_handle->nBuffers - 1) * sizeof(CONSTBUFFER_HANDLE));
+            /*Codes_SRS_CONSTBUFFER_ARRAY_02_046: [ constbuffer_array_remove_front shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE. ]*/
+            result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA); /*explicit 0*/
             if (result == NULL)
             {
                 /*Codes_SRS_CONSTBUFFER_ARRAY_02_036: [ If there are any failures then constbuffer_array_remove_front shall fail and return NULL. ]*/
@@ -304,20 +770,28 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_remove
             }
             else
             {
-                uint32_t i;
-
                 /* Codes_SRS_CONSTBUFFER_ARRAY_01_001: [ constbuffer_array_remove_front shall inc_ref the removed buffer. ]*/
                 CONSTBUFFER_IncRef(constbuffer_array_handle->buffers[0]);
+
+                /*Codes_SRS_CONSTBUFFER_ARRAY_02_047: [ constbuffer_array_remove_front shall share the storage of constbuffer_array_handle, the new CONSTBUFFER_ARRAY_HANDLE holding all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the front one. ]*/
+                /*Codes_SRS_CONSTBUFFER_ARRAY_02_048: [ constbuffer_array_remove_front shall not copy nor inc_ref the CONSTBUFFER_HANDLEs it holds. ]*/
+                (void)INC_REF_VAR(constbuffer_array_handle->storage->count);
+                result->storage = constbuffer_array_handle->storage;
+                result->buffers = constbuffer_array_handle->buffers + 1;
                 result->nBuffers = constbuffer_array_handle->nBuffers - 1;
-                result->created_with_moved_memory = false;
-                result->buffers = result->buffers_memory;
+                result->add_front_token = 0;
 
-                /*Codes_SRS_CONSTBUFFER_ARRAY_02_047: [ constbuffer_array_remove_front shall copy all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the front one. ]*/
-                /*Codes_SRS_CONSTBUFFER_ARRAY_02_048: [ constbuffer_array_remove_front shall inc_ref all the copied CONSTBUFFER_HANDLEs. ]*/
-                for (i = 1; i < constbuffer_array_handle->nBuffers; i++)
+                /*Codes_SRS_CONSTBUFFER_ARRAY_01_039: [ constbuffer_array_remove_front shall compute the total size of the buffers by subtracting the size of the removed buffer obtained by calling CONSTBUFFER_GetContent from the total size of constbuffer_array_handle. ]*/
+                if (constbuffer_array_handle->all_buffers_size_overflows)
                 {
-                    CONSTBUFFER_IncRef(constbuffer_array_handle->buffers[i]);
-                    result->buffers[i - 1] = constbuffer_array_handle->buffers[i];
+                    /*the size of the rest might fit now*/
+                    compute_all_buffers_size(result);
+                }
+                else
+                {
+                    const CONSTBUFFER* content = CONSTBUFFER_GetContent(constbuffer_array_handle->buffers[0]);
+                    result->all_buffers_size = constbuffer_array_handle->all_buffers_size - ((content == NULL) ? 0 : (uint32_t)content->size);
+                    result->all_buffers_size_overflows = false;
                 }
 
                 /*Codes_SRS_CONSTBUFFER_ARRAY_02_049: [ constbuffer_array_remove_front shall succeed, write in constbuffer_handle the front handle and return a non-NULL value. ]*/
@@ -437,21 +911,16 @@ IMPLEMENT_MOCKABLE_FUNCTION(, void, constbuffer_array_dec_ref, CONSTBUFFER_ARRAY
         /* Codes_SRS_CONSTBUFFER_ARRAY_01_016: [ Otherwise constbuffer_array_dec_ref shall decrement the reference count for constbuffer_array_handle. ]*/
         if (DEC_REF(CONSTBUFFER_ARRAY_HANDLE_DATA, constbuffer_array_handle) == DEC_RETURN_ZERO)
         {
-            uint32_t i;
+            CONSTBUFFER_ARRAY_STORAGE* storage = constbuffer_array_handle->storage;
 
             /*Codes_SRS_CONSTBUFFER_ARRAY_02_038: [ If the reference count reaches 0, constbuffer_array_dec_ref shall free all used resources. ]*/
-            for (i = 0; i < constbuffer_array_handle->nBuffers; i++)
-            {
-                CONSTBUFFER_DecRef(constbuffer_array_handle->buffers[i]);
-            }
-
-            if (constbuffer_array_handle->created_with_moved_memory)
+            if (storage->owner != constbuffer_array_handle)
             {
-                free(constbuffer_array_handle->buffers);
-                constbuffer_array_handle->buffers = NULL;
+                REFCOUNT_TYPE_DESTROY(CONSTBUFFER_ARRAY_HANDLE_DATA, constbuffer_array_handle);
             }
 
-            REFCOUNT_TYPE_DESTROY(CONSTBUFFER_ARRAY_HANDLE_DATA, constbuffer_array_handle);
+            /*Codes_SRS_CONSTBUFFER_ARRAY_01_040: [ When the last CONSTBUFFER_ARRAY_HANDLE sharing a storage is freed, constbuffer_array_dec_ref shall dec_ref all the CONSTBUFFER_HANDLEs in the storage and free it. ]*/
+            storage_dec_ref(storage);
         }
     }
 }
@@ -473,30 +942,7 @@ IMPLEMENT_MOCKABLE_FUNCTION(, int, constbuffer_array_get_all_buffers_size, CONST
     }
     else
     {
-        uint32_t i;
-        uint32_t total_size = 0;
-
-        for (i = 0; i < constbuffer_array_handle->nBuffers; i++)
-        {
-            const CONSTBUFFER* content = CONSTBUFFER_GetContent(constbuffer_array_handle->buffers[i]);
-            if (content != NULL)
-            {
-#if SIZE_MAX > UINT32_MAX
-                if (content->size > UINT32_MAX)
-                {
-                    break;
-                }
-#endif
-                if (total_size + (uint32_t)content->size < total_size)
-                {
-                    break;
-                }
-
-                total_size += (uint32_t)content->size;
-            }
-        }
-
-        if (i < constbuffer_array_handle->nBuffers)
+        if (constbuffer_array_handle->all_buffers_size_overflows)
         {
             /* Codes_SRS_CONSTBUFFER_ARRAY_01_021: [ If summing up the sizes results in an uint32_t overflow, shall fail and return a non-zero value. ]*/
             LogError("Overflow in computing all buffers size");
@@ -505,7 +951,8 @@ IMPLEMENT_MOCKABLE_FUNCTION(, int, constbuffer_array_get_all_buffers_size, CONST
         else
         {
             /* Codes_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
-            *all_buffers_size = total_size;
+            /* Codes_SRS_CONSTBUFFER_ARRAY_01_041: [ constbuffer_array_get_all_buffers_size shall not call CONSTBUFFER_GetContent, the total size is computed when the array is created. ]*/
+            *all_buffers_size = constbuffer_array_handle->all_buffers_size;
             result = 0;
         }
     }
@@ -590,3 +1037,194 @@ IMPLEMENT_MOCKABLE_FUNCTION(, bool, CONSTBUFFER_ARRAY_HANDLE_contain_same, CONST
     }
     return result;
 }
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_CURSOR_HANDLE, constbuffer_array_cursor_create, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle)
+{
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_019: [ If constbuffer_array_handle is NULL then constbuffer_array_cursor_create shall fail and return NULL. ]*/
+        (constbuffer_array_handle == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_020: [ If the total size of the buffers in constbuffer_array_handle overflows uint32_t then constbuffer_array_cursor_create shall fail and return NULL. ]*/
+        (constbuffer_array_handle->all_buffers_size_overflows)
+        )
+    {
+        LogError("invalid argument CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p", constbuffer_array_handle);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_021: [ constbuffer_array_cursor_create shall allocate memory for a new CONSTBUFFER_ARRAY_CURSOR_HANDLE. ]*/
+        result = malloc(sizeof(CONSTBUFFER_ARRAY_CURSOR_HANDLE_DATA));
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_04_022: [ If there are any failures then constbuffer_array_cursor_create shall fail and return NULL. ]*/
+            LogError("failure in malloc");
+            /*return as is*/
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_04_023: [ constbuffer_array_cursor_create shall inc_ref constbuffer_array_handle. ]*/
+            INC_REF(CONSTBUFFER_ARRAY_HANDLE_DATA, constbuffer_array_handle);
+            result->constbuffer_array_handle = constbuffer_array_handle;
+            result->buffer_index = 0;
+            result->buffer_offset = 0;
+            result->remaining_size = constbuffer_array_handle->all_buffers_size;
+
+            /*the cursor starts past the empty buffers*/
+            skip_bytes(constbuffer_array_handle, &result->buffer_index, &result->buffer_offset, 0);
+
+            /*Codes_SRS_CONSTBUFFER_ARRAY_04_024: [ constbuffer_array_cursor_create shall succeed and return a non-NULL value positioned at the first byte of constbuffer_array_handle. ]*/
+        }
+    }
+
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, void, constbuffer_array_cursor_destroy, CONSTBUFFER_ARRAY_CURSOR_HANDLE, cursor)
+{
+    if (cursor == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_025: [ If cursor is NULL then constbuffer_array_cursor_destroy shall return. ]*/
+        LogError("invalid argument CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor=%p", cursor);
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_026: [ Otherwise constbuffer_array_cursor_destroy shall dec_ref the CONSTBUFFER_ARRAY_HANDLE of the cursor and free the cursor. ]*/
+        constbuffer_array_dec_ref(cursor->constbuffer_array_handle);
+        free(cursor);
+    }
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, constbuffer_array_cursor_get_remaining_size, CONSTBUFFER_ARRAY_CURSOR_HANDLE, cursor, uint32_t*, remaining_size)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_027: [ If cursor is NULL then constbuffer_array_cursor_get_remaining_size shall fail and return a non-zero value. ]*/
+        (cursor == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_028: [ If remaining_size is NULL then constbuffer_array_cursor_get_remaining_size shall fail and return a non-zero value. ]*/
+        (remaining_size == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor=%p, uint32_t* remaining_size=%p", cursor, remaining_size);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_029: [ Otherwise constbuffer_array_cursor_get_remaining_size shall write in remaining_size the number of bytes after the cursor and return 0. ]*/
+        *remaining_size = cursor->remaining_size;
+        result = 0;
+    }
+
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_cursor_consume, CONSTBUFFER_ARRAY_CURSOR_HANDLE, cursor, uint32_t, size)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_030: [ If cursor is NULL then constbuffer_array_cursor_consume shall fail and return NULL. ]*/
+        (cursor == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_031: [ If size is greater than the number of bytes after the cursor then constbuffer_array_cursor_consume shall fail and return NULL. ]*/
+        (size > cursor->remaining_size)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor=%p, uint32_t size=%" PRIu32, cursor, size);
+        result = NULL;
+    }
+    else
+    {
+        if (size == 0)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_04_032: [ If size is 0 then constbuffer_array_cursor_consume shall create a new, empty CONSTBUFFER_ARRAY_HANDLE. ]*/
+            result = constbuffer_array_create_empty();
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_04_033: [ Otherwise constbuffer_array_cursor_consume shall create a CONSTBUFFER_ARRAY_HANDLE with the size bytes after the cursor in the same way constbuffer_array_create_from_offset_and_size does. ]*/
+            result = create_slice(cursor->constbuffer_array_handle, cursor->buffer_index, cursor->buffer_offset, size);
+        }
+
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_04_034: [ If there are any failures then constbuffer_array_cursor_consume shall fail, return NULL and leave the cursor where it was. ]*/
+            LogError("failure in creating the consumed CONSTBUFFER_ARRAY_HANDLE");
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_04_035: [ constbuffer_array_cursor_consume shall move the cursor size bytes further, succeed and return the new CONSTBUFFER_ARRAY_HANDLE. ]*/
+            skip_bytes(cursor->constbuffer_array_handle, &cursor->buffer_index, &cursor->buffer_offset, size);
+            cursor->remaining_size -= size;
+        }
+    }
+
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, constbuffer_array_cursor_read, CONSTBUFFER_ARRAY_CURSOR_HANDLE, cursor, unsigned char*, destination, uint32_t, size)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_036: [ If cursor is NULL then constbuffer_array_cursor_read shall fail and return a non-zero value. ]*/
+        (cursor == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_037: [ If destination is NULL and size is not 0 then constbuffer_array_cursor_read shall fail and return a non-zero value. ]*/
+        ((destination == NULL) && (size != 0)) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_038: [ If size is greater than the number of bytes after the cursor then constbuffer_array_cursor_read shall fail and return a non-zero value. ]*/
+        (size > cursor->remaining_size)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor=%p, unsigned char* destination=%p, uint32_t size=%" PRIu32, cursor, destination, size);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        uint32_t copied = 0;
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_039: [ constbuffer_array_cursor_read shall copy the size bytes after the cursor in destination, calling CONSTBUFFER_GetContent for each buffer it copies from. ]*/
+        while (copied < size)
+        {
+            const CONSTBUFFER* content = CONSTBUFFER_GetContent(cursor->constbuffer_array_handle->buffers[cursor->buffer_index]);
+            uint32_t available = (uint32_t)content->size - cursor->buffer_offset;
+            uint32_t to_copy = (size - copied < available) ? size - copied : available;
+
+            (void)memcpy(destination + copied, content->buffer + cursor->buffer_offset, to_copy);
+            copied += to_copy;
+
+            /*Codes_SRS_CONSTBUFFER_ARRAY_04_040: [ constbuffer_array_cursor_read shall move the cursor size bytes further and return 0. ]*/
+            skip_bytes(cursor->constbuffer_array_handle, &cursor->buffer_index, &cursor->buffer_offset, to_copy);
+        }
+
+        cursor->remaining_size -= size;
+        result = 0;
+    }
+
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, constbuffer_array_cursor_skip, CONSTBUFFER_ARRAY_CURSOR_HANDLE, cursor, uint32_t, size)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_041: [ If cursor is NULL then constbuffer_array_cursor_skip shall fail and return a non-zero value. ]*/
+        (cursor == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_042: [ If size is greater than the number of bytes after the cursor then constbuffer_array_cursor_skip shall fail and return a non-zero value. ]*/
+        (size > cursor->remaining_size)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor=%p, uint32_t size=%" PRIu32, cursor, size);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_04_043: [ Otherwise constbuffer_array_cursor_skip shall move the cursor size bytes further and return 0. ]*/
+        skip_bytes(cursor->constbuffer_array_handle, &cursor->buffer_index, &cursor->buffer_offset, size);
+        cursor->remaining_size -= size;
+        result = 0;
+    }
+
+    return result;
+}
@@ -8,6 +8,32 @@
 #include "azure_c_shared_utility/memory_data.h"
 #include "azure_c_shared_utility/safe_math.h"
 
+/*the handles and the header of the batch being built grow by doubling, these are the capacities of the first batch*/
+#define INITIAL_PAYLOAD_CAPACITY 16
+#define INITIAL_BUFFER_CAPACITY 16
+
+typedef struct CONSTBUFFER_ARRAY_BATCHER_HANDLE_DATA_TAG
+{
+    uint32_t max_payload_count;
+    uint32_t max_batch_size;
+    ON_CONSTBUFFER_ARRAY_BATCH_COMPLETE on_batch_complete;
+    void* on_batch_complete_context;
+
+    /*header of the batch being built: the payload count followed by the buffer count of each payload*/
+    uint32_t* header;
+    uint32_t header_capacity;
+    uint32_t payload_count;
+
+    /*buffers of the batch being built, the first one is reserved for the header buffer. The array is moved into the batch when the batch
+    is produced, buffer_capacity is then kept so that the next batch starts with the size that the previous one needed*/
+    CONSTBUFFER_HANDLE* buffers;
+    uint32_t buffer_capacity;
+    uint32_t buffer_count;
+
+    /*bytes in the batch being built, header included*/
+    uint64_t batch_size;
+} CONSTBUFFER_ARRAY_BATCHER_HANDLE_DATA;
+
 CONSTBUFFER_ARRAY_HANDLE constbuffer_array_batcher_batch(CONSTBUFFER_ARRAY_HANDLE* payloads, uint32_t count)
 {
     CONSTBUFFER_ARRAY_HANDLE result;
@@ -247,12 +273,11 @@ CONSTBUFFER_ARRAY_HANDLE* constbuffer_array_batcher_unbatch(CONSTBUFFER_ARRAY_HA
                         for (i = 0; i < batch_payload_count; i++)
                         {
                             uint32_t buffer_count;
-                            uint32_t j;
 
                             /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_01_016: [ constbuffer_array_batcher_unbatch shall extract the number of buffers in each of the batched payloads reading the uint32_t values encoded in the rest of the first (header) buffer. ]*/
                             read_uint32_t((void*)&header_buffer_memory[i + 1], &buffer_count);
 
-                            if (buffer_index + buffer_count > batch_buffer_count)
+                            if (buffer_count > batch_buffer_count - buffer_index)
                             {
                                 /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_01_021: [ If there are not enough buffers in batch to properly create all the payloads, constbuffer_array_batcher_unbatch shall fail and return NULL. ]*/
                                 LogError("Not enough buffers in batch");
@@ -266,29 +291,9 @@ CONSTBUFFER_ARRAY_HANDLE* constbuffer_array_batcher_unbatch(CONSTBUFFER_ARRAY_HA
                                 }
                                 else
                                 {
-                                    CONSTBUFFER_HANDLE* payload_buffers;
-                                    size_t buffer_count_size_t = (size_t)buffer_count;  // handle -Werror=type-limits
-                                    malloc_size = safe_multiply_size_t(sizeof(CONSTBUFFER_HANDLE), buffer_count_size_t);
-                                    if (malloc_size == SIZE_MAX || 
-                                        (payload_buffers = malloc(malloc_size)) == NULL)
-                                    {
-                                        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_01_022: [ If any error occurs, constbuffer_array_batcher_unbatch shall fail and return NULL. ]*/
-                                        LogError("malloc failed, size:%zu", malloc_size);
-                                        break;
-                                    }
-
-                                    for (j = 0; j < buffer_count; j++)
-                                    {
-                                        payload_buffers[j] = constbuffer_array_get_buffer(batch, buffer_index++);
-                                    }
-
-                                    /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_01_018: [ constbuffer_array_batcher_unbatch shall create a const buffer array for each of the payloads in the batch. ]*/
-                                    result[i] = constbuffer_array_create(payload_buffers, buffer_count);
-                                    for (j = 0; j < buffer_count; j++)
-                                    {
-                                        CONSTBUFFER_DecRef(payload_buffers[j]);
-                                    }
-                                    free(payload_buffers);
+                                    /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_01_018: [ constbuffer_array_batcher_unbatch shall create a const buffer array for each of the payloads in the batch by calling constbuffer_array_create_from_buffer_index_and_count, so that the payloads share the buffers of batch. ]*/
+                                    result[i] = constbuffer_array_create_from_buffer_index_and_count(batch, buffer_index, buffer_count);
+                                    buffer_index += buffer_count;
                                 }
 
                                 if (result[i] == NULL)
@@ -330,3 +335,304 @@ CONSTBUFFER_ARRAY_HANDLE* constbuffer_array_batcher_unbatch(CONSTBUFFER_ARRAY_HA
 all_ok:
     return result;
 }
+
+/*makes sure *array can hold needed elements. When it cannot, the capacity is at least doubled so that appending in a loop only reallocates O(log n) times*/
+static int grow_array(void** array, uint32_t* capacity, uint32_t needed, size_t element_size)
+{
+    int result;
+    if ((*array != NULL) && (needed <= *capacity))
+    {
+        result = 0;
+    }
+    else
+    {
+        void* temp;
+        uint32_t new_capacity;
+        size_t realloc_size;
+
+        if (*array == NULL)
+        {
+            new_capacity = *capacity;
+        }
+        else
+        {
+            new_capacity = (*capacity > UINT32_MAX / 2) ? UINT32_MAX : *capacity * 2;
+        }
+        if (new_capacity < needed)
+        {
+            new_capacity = needed;
+        }
+
+        realloc_size = safe_multiply_size_t(element_size, (size_t)new_capacity);
+        if (realloc_size == SIZE_MAX ||
+            (temp = realloc(*array, realloc_size)) == NULL)
+        {
+            LogError("failure reallocating, size:%zu", realloc_size);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            *array = temp;
+            *capacity = new_capacity;
+            result = 0;
+        }
+    }
+    return result;
+}
+
+static void reset_batch(CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher)
+{
+    batcher->payload_count = 0;
+    batcher->buffer_count = 1;
+    batcher->batch_size = sizeof(uint32_t);
+}
+
+/*produces the batch from the payloads appended so far and hands it to on_batch_complete*/
+static int complete_batch(CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher)
+{
+    int result;
+    CONSTBUFFER_HANDLE header_buffer;
+
+    /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_019: [ To produce a batch, the payload count shall be written as the first uint32_t in the header and a header buffer shall be created by calling CONSTBUFFER_Create. ]*/
+    write_uint32_t((void*)&batcher->header[0], batcher->payload_count);
+    header_buffer = CONSTBUFFER_Create((const unsigned char*)batcher->header, ((size_t)batcher->payload_count + 1) * sizeof(uint32_t));
+    if (header_buffer == NULL)
+    {
+        LogError("CONSTBUFFER_Create failed");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        CONSTBUFFER_ARRAY_HANDLE batch;
+
+        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_020: [ The header buffer followed by the buffers of the payloads shall be moved into the batch by calling constbuffer_array_create_with_move_buffers. ]*/
+        batcher->buffers[0] = header_buffer;
+        batch = constbuffer_array_create_with_move_buffers(batcher->buffers, batcher->buffer_count);
+        if (batch == NULL)
+        {
+            LogError("constbuffer_array_create_with_move_buffers failed");
+            CONSTBUFFER_DecRef(header_buffer);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            batcher->buffers = NULL;
+            reset_batch(batcher);
+
+            /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_021: [ The batch shall be passed to on_batch_complete and released by calling constbuffer_array_dec_ref once on_batch_complete returns. ]*/
+            batcher->on_batch_complete(batcher->on_batch_complete_context, batch);
+            constbuffer_array_dec_ref(batch);
+
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+CONSTBUFFER_ARRAY_BATCHER_HANDLE constbuffer_array_batcher_create(uint32_t max_payload_count, uint32_t max_batch_size, ON_CONSTBUFFER_ARRAY_BATCH_COMPLETE on_batch_complete, void* on_batch_complete_context)
+{
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE result;
+
+    if (
+        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_001: [ If max_payload_count is 0, constbuffer_array_batcher_create shall fail and return NULL. ]*/
+        (max_payload_count == 0) ||
+        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_002: [ If max_batch_size is 0, constbuffer_array_batcher_create shall fail and return NULL. ]*/
+        (max_batch_size == 0) ||
+        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_003: [ If on_batch_complete is NULL, constbuffer_array_batcher_create shall fail and return NULL. ]*/
+        (on_batch_complete == NULL)
+        )
+    {
+        LogError("Invalid arguments: uint32_t max_payload_count=%" PRIu32 ", uint32_t max_batch_size=%" PRIu32 ", ON_CONSTBUFFER_ARRAY_BATCH_COMPLETE on_batch_complete=%p, void* on_batch_complete_context=%p",
+            max_payload_count, max_batch_size, on_batch_complete, on_batch_complete_context);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_004: [ Otherwise constbuffer_array_batcher_create shall allocate memory for a new batcher. ]*/
+        result = malloc(sizeof(CONSTBUFFER_ARRAY_BATCHER_HANDLE_DATA));
+        if (result == NULL)
+        {
+            /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_005: [ If any error occurs, constbuffer_array_batcher_create shall fail and return NULL. ]*/
+            LogError("malloc failed");
+        }
+        else
+        {
+            /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_006: [ The memory for the header and for the buffer handles of the batch being built shall only be allocated when the first payload is appended. ]*/
+            result->max_payload_count = max_payload_count;
+            result->max_batch_size = max_batch_size;
+            result->on_batch_complete = on_batch_complete;
+            result->on_batch_complete_context = on_batch_complete_context;
+            result->header = NULL;
+            result->header_capacity = (max_payload_count < INITIAL_PAYLOAD_CAPACITY) ? max_payload_count + 1 : INITIAL_PAYLOAD_CAPACITY + 1;
+            result->buffers = NULL;
+            result->buffer_capacity = INITIAL_BUFFER_CAPACITY;
+            reset_batch(result);
+
+            /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_007: [ On success constbuffer_array_batcher_create shall return a non-NULL handle. ]*/
+        }
+    }
+
+    return result;
+}
+
+void constbuffer_array_batcher_destroy(CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher)
+{
+    if (batcher == NULL)
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_008: [ If batcher is NULL, constbuffer_array_batcher_destroy shall return. ]*/
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher=%p", batcher);
+    }
+    else
+    {
+        uint32_t i;
+
+        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_009: [ constbuffer_array_batcher_destroy shall release the buffers of the payloads that were appended but not yet batched, without producing a batch. ]*/
+        for (i = 1; i < batcher->buffer_count; i++)
+        {
+            CONSTBUFFER_DecRef(batcher->buffers[i]);
+        }
+
+        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_010: [ constbuffer_array_batcher_destroy shall free the memory used by batcher. ]*/
+        if (batcher->buffers != NULL)
+        {
+            free(batcher->buffers);
+        }
+        if (batcher->header != NULL)
+        {
+            free(batcher->header);
+        }
+        free(batcher);
+    }
+}
+
+int constbuffer_array_batcher_append(CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher, CONSTBUFFER_ARRAY_HANDLE payload)
+{
+    int result;
+
+    if (
+        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_011: [ If batcher is NULL, constbuffer_array_batcher_append shall fail and return a non-zero value. ]*/
+        (batcher == NULL) ||
+        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_012: [ If payload is NULL, constbuffer_array_batcher_append shall fail and return a non-zero value. ]*/
+        (payload == NULL)
+        )
+    {
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher=%p, CONSTBUFFER_ARRAY_HANDLE payload=%p",
+            batcher, payload);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        uint32_t payload_buffer_count;
+        uint32_t payload_size;
+
+        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_013: [ constbuffer_array_batcher_append shall obtain the number of buffers and the size of payload. ]*/
+        if (constbuffer_array_get_buffer_count(payload, &payload_buffer_count) != 0)
+        {
+            /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_028: [ If getting the number of buffers or the size of payload fails, constbuffer_array_batcher_append shall fail and return a non-zero value. ]*/
+            LogError("constbuffer_array_get_buffer_count failed");
+            result = MU_FAILURE;
+        }
+        else if (constbuffer_array_get_all_buffers_size(payload, &payload_size) != 0)
+        {
+            /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_028: [ If getting the number of buffers or the size of payload fails, constbuffer_array_batcher_append shall fail and return a non-zero value. ]*/
+            LogError("constbuffer_array_get_all_buffers_size failed, the payload is larger than UINT32_MAX bytes");
+            result = MU_FAILURE;
+        }
+        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_014: [ If the batch being built is not empty and adding payload would make it larger than max_batch_size bytes (header included), constbuffer_array_batcher_append shall first produce the batch being built. ]*/
+        else if ((batcher->payload_count > 0) &&
+            (batcher->batch_size + sizeof(uint32_t) + payload_size > batcher->max_batch_size) &&
+            (complete_batch(batcher) != 0))
+        {
+            /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_018: [ If any error occurs, constbuffer_array_batcher_append shall fail, leave the payloads appended before unchanged and return a non-zero value. ]*/
+            LogError("producing the batch failed");
+            result = MU_FAILURE;
+        }
+        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_015: [ constbuffer_array_batcher_append shall make room for one more header entry and for the buffers of payload, at least doubling the memory it needs to grow. ]*/
+        else if (payload_buffer_count > UINT32_MAX - batcher->buffer_count)
+        {
+            LogError("too many buffers in the batch: %" PRIu32 " + %" PRIu32, batcher->buffer_count, payload_buffer_count);
+            result = MU_FAILURE;
+        }
+        else if (grow_array((void**)&batcher->header, &batcher->header_capacity, batcher->payload_count + 2, sizeof(uint32_t)) != 0)
+        {
+            LogError("growing the header failed");
+            result = MU_FAILURE;
+        }
+        else if (grow_array((void**)&batcher->buffers, &batcher->buffer_capacity, batcher->buffer_count + payload_buffer_count, sizeof(CONSTBUFFER_HANDLE)) != 0)
+        {
+            LogError("growing the buffers failed");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            const CONSTBUFFER_HANDLE* payload_buffers = constbuffer_array_get_const_buffer_handle_array(payload);
+            uint32_t i;
+
+            /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_016: [ constbuffer_array_batcher_append shall add the buffer count of payload to the header and a reference to each of its buffers to the batch being built. ]*/
+            write_uint32_t((void*)&batcher->header[batcher->payload_count + 1], payload_buffer_count);
+            for (i = 0; i < payload_buffer_count; i++)
+            {
+                CONSTBUFFER_IncRef(payload_buffers[i]);
+                batcher->buffers[batcher->buffer_count + i] = payload_buffers[i];
+            }
+            batcher->payload_count++;
+            batcher->buffer_count += payload_buffer_count;
+            batcher->batch_size += sizeof(uint32_t) + payload_size;
+
+            /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_017: [ If the batch being built has max_payload_count payloads or at least max_batch_size bytes, constbuffer_array_batcher_append shall produce it. ]*/
+            if (((batcher->payload_count == batcher->max_payload_count) || (batcher->batch_size >= batcher->max_batch_size)) &&
+                (complete_batch(batcher) != 0))
+            {
+                /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_018: [ If any error occurs, constbuffer_array_batcher_append shall fail, leave the payloads appended before unchanged and return a non-zero value. ]*/
+                LogError("producing the batch failed");
+                batcher->payload_count--;
+                batcher->buffer_count -= payload_buffer_count;
+                batcher->batch_size -= sizeof(uint32_t) + payload_size;
+                for (i = 0; i < payload_buffer_count; i++)
+                {
+                    CONSTBUFFER_DecRef(payload_buffers[i]);
+                }
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_022: [ On success constbuffer_array_batcher_append shall return 0. ]*/
+                result = 0;
+            }
+        }
+    }
+
+    return result;
+}
+
+int constbuffer_array_batcher_finish(CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher)
+{
+    int result;
+
+    if (batcher == NULL)
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_023: [ If batcher is NULL, constbuffer_array_batcher_finish shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher=%p", batcher);
+        result = MU_FAILURE;
+    }
+    else if (batcher->payload_count == 0)
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_024: [ If no payload was appended since the last batch was produced, constbuffer_array_batcher_finish shall return 0 without producing a batch. ]*/
+        result = 0;
+    }
+    /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_025: [ Otherwise constbuffer_array_batcher_finish shall produce the batch from the payloads appended since the last batch was produced. ]*/
+    else if (complete_batch(batcher) != 0)
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_026: [ If any error occurs, constbuffer_array_batcher_finish shall fail and return a non-zero value, the appended payloads are kept. ]*/
+        LogError("producing the batch failed");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_04_027: [ On success constbuffer_array_batcher_finish shall return 0. ]*/
+        result = 0;
+    }
+
+    return result;
+}
@@ -3,7 +3,10 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
+#include <time.h>
 #include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/threadapi.h"
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/safe_math.h"
@@ -14,6 +17,855 @@
 #define SIZE_MAX ((size_t)~(size_t)0)
 #endif
 
+typedef enum GBALLOC_STATE_TAG
+{
+    GBALLOC_STATE_INIT,
+    GBALLOC_STATE_NOT_INIT
+} GBALLOC_STATE;
+
+/* the pool finds the size class of a block from the size kept in its header */
+#if defined(GB_USE_POOL) && !defined(GB_TRACK_IN_HEADER)
+#define GB_TRACK_IN_HEADER
+#endif
+
+#if defined(GB_TRACK_IN_HEADER)
+
+/* GB_TRACK_IN_HEADER keeps the size of every allocation in a header placed in front of the memory returned to the caller
+and keeps the counters with atomic operations. There is no lock and no list of allocations, so gballoc_free is O(1) and
+allocating threads do not serialize on gballoc.
+The header is always added (also when gballoc is not initialized) so that any pointer handed out by gballoc can be passed back to it.
+Unlike the default mode, pointers that were not allocated by gballoc cannot be passed to gballoc_realloc/gballoc_free: there is no
+list to look them up in, only a check word in the header. It mixes a random secret of the process with the address of the header,
+the size and the generation, so a pointer that was not allocated by gballoc (or a copy of a header at another address) is rejected
+unless the size_t in front of it happens to match, and a second free of the same pointer is rejected as long as the memory was not reused. */
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#if defined(_WIN64)
+#define GBALLOC_ATOMIC_ADD(var, value) ((size_t)_InterlockedExchangeAdd64((volatile __int64*)&(var), (__int64)(value)))
+#define GBALLOC_ATOMIC_EXCHANGE(var, value) ((size_t)_InterlockedExchange64((volatile __int64*)&(var), (__int64)(value)))
+#define GBALLOC_ATOMIC_CAS(var, expected, desired) ((size_t)_InterlockedCompareExchange64((volatile __int64*)&(var), (__int64)(desired), (__int64)(expected)) == (size_t)(expected))
+#else
+#define GBALLOC_ATOMIC_ADD(var, value) ((size_t)_InterlockedExchangeAdd((volatile long*)&(var), (long)(value)))
+#define GBALLOC_ATOMIC_EXCHANGE(var, value) ((size_t)_InterlockedExchange((volatile long*)&(var), (long)(value)))
+#define GBALLOC_ATOMIC_CAS(var, expected, desired) ((size_t)_InterlockedCompareExchange((volatile long*)&(var), (long)(desired), (long)(expected)) == (size_t)(expected))
+#endif
+#elif defined(__GNUC__)
+#define GBALLOC_ATOMIC_ADD(var, value) __sync_fetch_and_add(&(var), (size_t)(value))
+#if defined(__ATOMIC_SEQ_CST)
+#define GBALLOC_ATOMIC_EXCHANGE(var, value) __atomic_exchange_n(&(var), (size_t)(value), __ATOMIC_SEQ_CST)
+#else
+/* an acquire barrier only, enough for the counters */
+#define GBALLOC_ATOMIC_EXCHANGE(var, value) __sync_lock_test_and_set(&(var), (size_t)(value))
+#endif
+#define GBALLOC_ATOMIC_CAS(var, expected, desired) __sync_bool_compare_and_swap(&(var), (size_t)(expected), (size_t)(desired))
+#else
+#error GB_TRACK_IN_HEADER needs atomic operations, they are not defined for this compiler
+#endif
+
+#if defined(_MSC_VER)
+#define GBALLOC_ATOMIC_LOAD(var) GBALLOC_ATOMIC_ADD(var, 0)
+#elif defined(__ATOMIC_SEQ_CST)
+#define GBALLOC_ATOMIC_LOAD(var) __atomic_load_n(&(var), __ATOMIC_SEQ_CST)
+#else
+#define GBALLOC_ATOMIC_LOAD(var) __sync_fetch_and_add(&(var), (size_t)0)
+#endif
+
+typedef union GBALLOC_HEADER_TAG
+{
+    struct
+    {
+        size_t size;
+        /* the generation of the metrics the allocation is counted in, 0 means the allocation is not counted */
+        size_t generation;
+        /* see compute_check, 0 once the block is freed */
+        size_t check;
+    } info;
+    /* the members below only make the header (and so the memory after it) as aligned as what malloc returns */
+    long double align_long_double;
+    double align_double;
+    uint64_t align_uint64;
+    void* align_pointer;
+} GBALLOC_HEADER;
+
+static volatile size_t totalSize = 0;
+static volatile size_t maxSize = 0;
+static volatile size_t g_allocations = 0;
+/* incremented by gballoc_init and gballoc_resetMetrics, so that memory counted before that is not subtracted when freed */
+static volatile size_t g_generation = 0;
+/* random for every process, 0 until the first allocation picks it */
+static volatile size_t g_header_secret = 0;
+static GBALLOC_STATE gballocState = GBALLOC_STATE_NOT_INIT;
+
+static void reset_counters(void)
+{
+    size_t generation;
+    size_t next_generation;
+
+    do
+    {
+        generation = GBALLOC_ATOMIC_LOAD(g_generation);
+        next_generation = generation + 1;
+        if (next_generation == 0)
+        {
+            next_generation = 1;
+        }
+    } while (!GBALLOC_ATOMIC_CAS(g_generation, generation, next_generation));
+
+    (void)GBALLOC_ATOMIC_EXCHANGE(totalSize, 0);
+    (void)GBALLOC_ATOMIC_EXCHANGE(maxSize, 0);
+    (void)GBALLOC_ATOMIC_EXCHANGE(g_allocations, 0);
+}
+
+static size_t get_header_secret(void)
+{
+    size_t result = GBALLOC_ATOMIC_LOAD(g_header_secret);
+    if (result == 0)
+    {
+        /* the addresses differ between processes with ASLR, the time and the clock otherwise. Mixed with splitmix64 */
+        uint64_t seed = (uint64_t)time(NULL) ^ ((uint64_t)clock() << 32) ^ (uint64_t)(uintptr_t)&result ^ ((uint64_t)(uintptr_t)&g_header_secret << 20);
+        size_t candidate;
+        seed += 0x9E3779B97F4A7C15ULL;
+        seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+        seed ^= seed >> 31;
+        candidate = (size_t)(seed ^ (seed >> 32));
+        if (candidate == 0)
+        {
+            candidate = 1;
+        }
+        /* threads racing here agree on the first value written */
+        (void)GBALLOC_ATOMIC_CAS(g_header_secret, 0, candidate);
+        result = GBALLOC_ATOMIC_LOAD(g_header_secret);
+    }
+    return result;
+}
+
+static size_t compute_check(const GBALLOC_HEADER* header)
+{
+    size_t result = get_header_secret() ^ (size_t)(uintptr_t)header ^ header->info.size ^ (header->info.generation * (size_t)0x9E3779B9);
+    /* 0 marks a freed block */
+    return (result == 0) ? 1 : result;
+}
+
+static void count_allocated(size_t size)
+{
+    size_t newTotal = GBALLOC_ATOMIC_ADD(totalSize, size) + size;
+    size_t currentMax = GBALLOC_ATOMIC_LOAD(maxSize);
+
+    /* Codes_SRS_GBALLOC_01_011: [The maximum total memory used shall be the maximum of the total memory used at any point.] */
+    while ((currentMax < newTotal) && !GBALLOC_ATOMIC_CAS(maxSize, currentMax, newTotal))
+    {
+        currentMax = GBALLOC_ATOMIC_LOAD(maxSize);
+    }
+}
+
+/* stamps a header and returns the memory after it, counting it when gballoc is initialized */
+static void* track_header(GBALLOC_HEADER* header, size_t size)
+{
+    size_t generation = 0;
+
+    if (gballocState == GBALLOC_STATE_INIT)
+    {
+        generation = GBALLOC_ATOMIC_LOAD(g_generation);
+        (void)GBALLOC_ATOMIC_ADD(g_allocations, 1);
+        count_allocated(size);
+    }
+
+    header->info.size = size;
+    header->info.generation = generation;
+    header->info.check = compute_check(header);
+    return header + 1;
+}
+
+/* returns the header of a pointer handed out by gballoc or NULL if ptr does not look like one */
+static GBALLOC_HEADER* get_header(void* ptr)
+{
+    GBALLOC_HEADER* result = (GBALLOC_HEADER*)ptr - 1;
+    if (result->info.check != compute_check(result))
+    {
+        result = NULL;
+    }
+    return result;
+}
+
+/* true when the allocation described by header is part of the current metrics */
+static int is_counted(const GBALLOC_HEADER* header)
+{
+    size_t generation = header->info.generation;
+    return (gballocState == GBALLOC_STATE_INIT) && (generation != 0) && (generation == GBALLOC_ATOMIC_LOAD(g_generation));
+}
+
+#if defined(GB_USE_POOL)
+
+/* GB_USE_POOL serves the small allocations from size classes carved out of slabs instead of going to malloc every time.
+Every thread keeps a cache of free blocks per class and only takes the (spin) lock of the shared depot to exchange
+POOL_BATCH blocks at once or to carve a new slab. Slabs are never given back to the system.
+When a thread exits, the blocks and the counters of its cache go back to the depot (a pthread key destructor, or a fiber local
+storage callback on Windows). */
+
+#if defined(_MSC_VER)
+#define POOL_THREAD_LOCAL __declspec(thread)
+#else
+#define POOL_THREAD_LOCAL __thread
+#endif
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/* only the thread owning a cache (or the holder of the lock for pool_shared_cache) updates its counters, the atomic load and store
+only keep the readers summing them from seeing torn values, without the cost of a locked instruction */
+#if defined(__ATOMIC_RELAXED)
+#define POOL_COUNTER_LOAD(var) __atomic_load_n(&(var), __ATOMIC_RELAXED)
+#define POOL_COUNTER_ADD(var, value) __atomic_store_n(&(var), __atomic_load_n(&(var), __ATOMIC_RELAXED) + (size_t)(value), __ATOMIC_RELAXED)
+#else
+#define POOL_COUNTER_LOAD(var) GBALLOC_ATOMIC_LOAD(var)
+#define POOL_COUNTER_ADD(var, value) (void)GBALLOC_ATOMIC_ADD(var, value)
+#endif
+
+/* block sizes, header included. Bigger allocations go to malloc */
+static const size_t POOL_CLASS_SIZES[] = { 32, 48, 64, 96, 128, 192, 256, 384, 512 };
+#define POOL_CLASS_COUNT (sizeof(POOL_CLASS_SIZES) / sizeof(POOL_CLASS_SIZES[0]))
+#define POOL_SLAB_SIZE 16384
+#define POOL_THREAD_CACHE_MAX 64
+#define POOL_BATCH 32
+#define POOL_SPINS_BEFORE_YIELD 100
+
+typedef struct POOL_BLOCK_TAG
+{
+    struct POOL_BLOCK_TAG* next;
+} POOL_BLOCK;
+
+typedef struct POOL_THREAD_CACHE_TAG
+{
+    POOL_BLOCK* blocks[POOL_CLASS_COUNT];
+    size_t block_count[POOL_CLASS_COUNT];
+    volatile size_t hits;
+    volatile size_t misses;
+    /* a block can be freed by another thread than the one that allocated it, so this wraps: only the sum over all caches is meaningful */
+    volatile size_t requested_bytes;
+    struct POOL_THREAD_CACHE_TAG* next;
+} POOL_THREAD_CACHE;
+
+static volatile size_t pool_spin_lock = 0;
+static POOL_BLOCK* pool_depot[POOL_CLASS_COUNT];
+/* slabs are linked through their first bytes */
+static void* pool_slabs = NULL;
+static size_t pool_reserved_bytes = 0;
+static POOL_THREAD_CACHE* pool_thread_caches = NULL;
+/* used (under the lock) by threads for which no cache could be allocated */
+static POOL_THREAD_CACHE pool_shared_cache;
+static POOL_THREAD_LOCAL POOL_THREAD_CACHE* pool_thread_cache = NULL;
+/* 0 until the first thread cache is created, then 1 when the thread exit notification could be set up, 2 when it could not */
+static int pool_thread_exit_state = 0;
+#if defined(_WIN32)
+static DWORD pool_thread_exit_index;
+#else
+static pthread_key_t pool_thread_exit_key;
+#endif
+
+static void pool_lock(void)
+{
+    unsigned int spins = 0;
+    while (!GBALLOC_ATOMIC_CAS(pool_spin_lock, 0, 1))
+    {
+        /* the lock is only held for a few list operations, if it is still taken the owner is likely not running */
+        if (++spins == POOL_SPINS_BEFORE_YIELD)
+        {
+            spins = 0;
+            ThreadAPI_Sleep(0);
+        }
+    }
+}
+
+static void pool_unlock(void)
+{
+    (void)GBALLOC_ATOMIC_CAS(pool_spin_lock, 1, 0);
+}
+
+/* the class of an allocation, indexed by its size in 16 bytes units (rounded up) */
+static const unsigned char POOL_CLASS_OF_UNITS[] =
+{
+    0, 0, 0, 1, 2, 3, 3, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6,
+    7, 7, 7, 7, 7, 7, 7, 7, 8, 8, 8, 8, 8, 8, 8, 8
+};
+
+/* returns POOL_CLASS_COUNT when allocationSize is too big for the pool */
+static size_t pool_class_of(size_t allocationSize)
+{
+    size_t units = (allocationSize / 16) + (((allocationSize % 16) != 0) ? 1 : 0);
+    return (units < sizeof(POOL_CLASS_OF_UNITS)) ? POOL_CLASS_OF_UNITS[units] : POOL_CLASS_COUNT;
+}
+
+/* gives the blocks of an exiting thread back to the depot and keeps its counters in pool_shared_cache */
+static void pool_flush_thread_cache(void* value)
+{
+    POOL_THREAD_CACHE* cache = (POOL_THREAD_CACHE*)value;
+    if (cache != NULL)
+    {
+        POOL_THREAD_CACHE** link;
+        size_t i;
+
+        pool_lock();
+        for (i = 0; i < POOL_CLASS_COUNT; i++)
+        {
+            while (cache->blocks[i] != NULL)
+            {
+                POOL_BLOCK* block = cache->blocks[i];
+                cache->blocks[i] = block->next;
+                block->next = pool_depot[i];
+                pool_depot[i] = block;
+            }
+        }
+        POOL_COUNTER_ADD(pool_shared_cache.hits, POOL_COUNTER_LOAD(cache->hits));
+        POOL_COUNTER_ADD(pool_shared_cache.misses, POOL_COUNTER_LOAD(cache->misses));
+        POOL_COUNTER_ADD(pool_shared_cache.requested_bytes, POOL_COUNTER_LOAD(cache->requested_bytes));
+        for (link = &pool_thread_caches; *link != NULL; link = &(*link)->next)
+        {
+            if (*link == cache)
+            {
+                *link = cache->next;
+                break;
+            }
+        }
+        pool_unlock();
+
+        if (pool_thread_cache == cache)
+        {
+            pool_thread_cache = NULL;
+        }
+        free(cache);
+    }
+}
+
+#if defined(_WIN32)
+static VOID WINAPI pool_on_thread_exit(PVOID value)
+{
+    pool_flush_thread_cache(value);
+}
+#endif
+
+/* sets the cache to flush when the calling thread exits, cache can be NULL */
+static void pool_set_thread_exit_cache(POOL_THREAD_CACHE* cache)
+{
+    if (pool_thread_exit_state == 1)
+    {
+#if defined(_WIN32)
+        (void)FlsSetValue(pool_thread_exit_index, cache);
+#else
+        (void)pthread_setspecific(pool_thread_exit_key, cache);
+#endif
+    }
+}
+
+/* called under the lock. When it fails, the blocks of exiting threads stay in their caches */
+static void pool_create_thread_exit_notification(void)
+{
+    if (pool_thread_exit_state == 0)
+    {
+#if defined(_WIN32)
+        pool_thread_exit_index = FlsAlloc(pool_on_thread_exit);
+        pool_thread_exit_state = (pool_thread_exit_index == FLS_OUT_OF_INDEXES) ? 2 : 1;
+#else
+        pool_thread_exit_state = (pthread_key_create(&pool_thread_exit_key, pool_flush_thread_cache) != 0) ? 2 : 1;
+#endif
+    }
+}
+
+static POOL_THREAD_CACHE* pool_get_thread_cache(void)
+{
+    if (pool_thread_cache == NULL)
+    {
+        POOL_THREAD_CACHE* cache = (POOL_THREAD_CACHE*)calloc(1, sizeof(POOL_THREAD_CACHE));
+        if (cache != NULL)
+        {
+            pool_lock();
+            pool_create_thread_exit_notification();
+            cache->next = pool_thread_caches;
+            pool_thread_caches = cache;
+            pool_unlock();
+            pool_thread_cache = cache;
+            /* Codes_SRS_GBALLOC_07_021: [ When a thread exits, the free blocks of its cache shall be given back to the pool and its counters shall be kept. ]*/
+            pool_set_thread_exit_cache(cache);
+        }
+    }
+    return pool_thread_cache;
+}
+
+/* moves up to POOL_BATCH blocks of the class from the depot to the cache, carving a new slab if the depot is empty. Called under the lock */
+static int pool_refill(POOL_THREAD_CACHE* cache, size_t class_index, int* carved)
+{
+    int result;
+
+    *carved = 0;
+    if (pool_depot[class_index] == NULL)
+    {
+        unsigned char* slab = (unsigned char*)malloc(POOL_SLAB_SIZE);
+        if (slab == NULL)
+        {
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* the first header sized chunk links the slab, the blocks after it keep the alignment of the header */
+            size_t offset;
+            *(void**)slab = pool_slabs;
+            pool_slabs = slab;
+            pool_reserved_bytes += POOL_SLAB_SIZE;
+            for (offset = sizeof(GBALLOC_HEADER); offset + POOL_CLASS_SIZES[class_index] <= POOL_SLAB_SIZE; offset += POOL_CLASS_SIZES[class_index])
+            {
+                POOL_BLOCK* block = (POOL_BLOCK*)(slab + offset);
+                block->next = pool_depot[class_index];
+                pool_depot[class_index] = block;
+            }
+            *carved = 1;
+            result = 0;
+        }
+    }
+    else
+    {
+        result = 0;
+    }
+
+    if (result == 0)
+    {
+        size_t i;
+        for (i = 0; (i < POOL_BATCH) && (pool_depot[class_index] != NULL); i++)
+        {
+            POOL_BLOCK* block = pool_depot[class_index];
+            pool_depot[class_index] = block->next;
+            block->next = cache->blocks[class_index];
+            cache->blocks[class_index] = block;
+            cache->block_count[class_index]++;
+        }
+    }
+
+    return result;
+}
+
+/* gives POOL_BATCH blocks of the class back to the depot. Called under the lock */
+static void pool_trim(POOL_THREAD_CACHE* cache, size_t class_index)
+{
+    size_t i;
+    for (i = 0; (i < POOL_BATCH) && (cache->blocks[class_index] != NULL); i++)
+    {
+        POOL_BLOCK* block = cache->blocks[class_index];
+        cache->blocks[class_index] = block->next;
+        cache->block_count[class_index]--;
+        block->next = pool_depot[class_index];
+        pool_depot[class_index] = block;
+    }
+}
+
+static GBALLOC_HEADER* pool_pop(POOL_THREAD_CACHE* cache, size_t class_index, size_t size)
+{
+    POOL_BLOCK* block = cache->blocks[class_index];
+    cache->blocks[class_index] = block->next;
+    cache->block_count[class_index]--;
+    POOL_COUNTER_ADD(cache->requested_bytes, size);
+    return (GBALLOC_HEADER*)block;
+}
+
+static GBALLOC_HEADER* pool_allocate(size_t class_index, size_t size)
+{
+    GBALLOC_HEADER* result;
+    POOL_THREAD_CACHE* cache = pool_get_thread_cache();
+
+    if ((cache != NULL) && (cache->blocks[class_index] != NULL))
+    {
+        /* Codes_SRS_GBALLOC_07_014: [ When built with GB_USE_POOL, blocks shall be taken from a per-thread cache without taking a lock when the cache has one. ]*/
+        POOL_COUNTER_ADD(cache->hits, 1);
+        result = pool_pop(cache, class_index, size);
+    }
+    else
+    {
+        int carved = 0;
+        POOL_THREAD_CACHE* target = (cache != NULL) ? cache : &pool_shared_cache;
+
+        pool_lock();
+        if ((target->blocks[class_index] == NULL) &&
+            (pool_refill(target, class_index, &carved) != 0))
+        {
+            result = NULL;
+        }
+        else
+        {
+            /* Codes_SRS_GBALLOC_07_015: [ An allocation served without calling malloc shall be counted as a pool hit, an allocation that needed a new slab shall be counted as a pool miss. ]*/
+            if (carved)
+            {
+                POOL_COUNTER_ADD(target->misses, 1);
+            }
+            else
+            {
+                POOL_COUNTER_ADD(target->hits, 1);
+            }
+            result = pool_pop(target, class_index, size);
+        }
+        pool_unlock();
+    }
+
+    return result;
+}
+
+static void pool_release(GBALLOC_HEADER* header, size_t class_index, size_t size)
+{
+    POOL_BLOCK* block = (POOL_BLOCK*)header;
+    POOL_THREAD_CACHE* cache = pool_get_thread_cache();
+
+    if (cache == NULL)
+    {
+        pool_lock();
+        block->next = pool_shared_cache.blocks[class_index];
+        pool_shared_cache.blocks[class_index] = block;
+        pool_shared_cache.block_count[class_index]++;
+        POOL_COUNTER_ADD(pool_shared_cache.requested_bytes, (size_t)0 - size);
+        if (pool_shared_cache.block_count[class_index] > POOL_THREAD_CACHE_MAX)
+        {
+            pool_trim(&pool_shared_cache, class_index);
+        }
+        pool_unlock();
+    }
+    else
+    {
+        block->next = cache->blocks[class_index];
+        cache->blocks[class_index] = block;
+        cache->block_count[class_index]++;
+        POOL_COUNTER_ADD(cache->requested_bytes, (size_t)0 - size);
+        if (cache->block_count[class_index] > POOL_THREAD_CACHE_MAX)
+        {
+            pool_lock();
+            pool_trim(cache, class_index);
+            pool_unlock();
+        }
+    }
+}
+
+#endif /* GB_USE_POOL */
+
+/* the memory for a header and size bytes after it, from the pool when the size fits a class */
+static GBALLOC_HEADER* allocate_block(size_t allocationSize, size_t size, int zeroed)
+{
+    GBALLOC_HEADER* result;
+#if defined(GB_USE_POOL)
+    size_t class_index = pool_class_of(allocationSize);
+    if (class_index < POOL_CLASS_COUNT)
+    {
+        /* Codes_SRS_GBALLOC_07_013: [ When built with GB_USE_POOL, allocations that fit in a size class shall be served from the pool instead of malloc. ]*/
+        result = pool_allocate(class_index, size);
+        if ((result != NULL) && zeroed)
+        {
+            (void)memset(result, 0, allocationSize);
+        }
+    }
+    else
+#else
+    (void)size;
+#endif
+    if (zeroed)
+    {
+        result = (GBALLOC_HEADER*)calloc(1, allocationSize);
+    }
+    else
+    {
+        result = (GBALLOC_HEADER*)malloc(allocationSize);
+    }
+    return result;
+}
+
+static void release_block(GBALLOC_HEADER* header)
+{
+#if defined(GB_USE_POOL)
+    size_t class_index = pool_class_of(header->info.size + sizeof(GBALLOC_HEADER));
+    if (class_index < POOL_CLASS_COUNT)
+    {
+        pool_release(header, class_index, header->info.size);
+    }
+    else
+#endif
+    {
+        free(header);
+    }
+}
+
+/* header can be NULL. On failure the old block is left untouched */
+static GBALLOC_HEADER* reallocate_block(GBALLOC_HEADER* header, size_t allocationSize, size_t size)
+{
+    GBALLOC_HEADER* result;
+#if defined(GB_USE_POOL)
+    size_t old_class_index = (header == NULL) ? POOL_CLASS_COUNT : pool_class_of(header->info.size + sizeof(GBALLOC_HEADER));
+    size_t new_class_index = pool_class_of(allocationSize);
+
+    if (old_class_index != new_class_index)
+    {
+        /* moving between the pool and malloc or between classes */
+        if ((result = allocate_block(allocationSize, size, 0)) != NULL)
+        {
+            if (header != NULL)
+            {
+                (void)memcpy(result, header, sizeof(GBALLOC_HEADER) + ((header->info.size < size) ? header->info.size : size));
+                header->info.check = 0;
+                release_block(header);
+            }
+        }
+    }
+    else if (new_class_index < POOL_CLASS_COUNT)
+    {
+        /* the block is big enough already */
+        POOL_THREAD_CACHE* cache = pool_get_thread_cache();
+        if (cache == NULL)
+        {
+            pool_lock();
+            POOL_COUNTER_ADD(pool_shared_cache.requested_bytes, size - header->info.size);
+            pool_unlock();
+        }
+        else
+        {
+            POOL_COUNTER_ADD(cache->requested_bytes, size - header->info.size);
+        }
+        result = header;
+    }
+    else
+#else
+    (void)size;
+#endif
+    {
+        result = (GBALLOC_HEADER*)realloc(header, allocationSize);
+    }
+    return result;
+}
+
+int gballoc_init(void)
+{
+    int result;
+
+    if (gballocState != GBALLOC_STATE_NOT_INIT)
+    {
+        /* Codes_SRS_GBALLOC_01_025: [Init after Init shall fail and return a non-zero value.] */
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_GBALLOC_07_009: [ When built with GB_TRACK_IN_HEADER, gballoc_init shall not create a lock. ]*/
+        /* Codes_ SRS_GBALLOC_01_002: [Upon initialization the total memory used and maximum total memory used tracked by the module shall be set to 0.] */
+        reset_counters();
+        gballocState = GBALLOC_STATE_INIT;
+
+        /* Codes_SRS_GBALLOC_01_024: [gballoc_init shall initialize the gballoc module and return 0 upon success.] */
+        result = 0;
+    }
+
+    return result;
+}
+
+void gballoc_deinit(void)
+{
+    gballocState = GBALLOC_STATE_NOT_INIT;
+}
+
+void* gballoc_malloc(size_t size)
+{
+    void* result;
+    /* Codes_SRS_GBALLOC_07_010: [ When built with GB_TRACK_IN_HEADER, gballoc_malloc, gballoc_calloc and gballoc_realloc shall allocate a header in front of the returned memory to hold the size, also when gballoc is not initialized. ]*/
+    size_t allocationSize = safe_add_size_t(size, sizeof(GBALLOC_HEADER));
+    GBALLOC_HEADER* header;
+
+    if ((allocationSize == SIZE_MAX) ||
+        /* Codes_SRS_GBALLOC_01_003: [gb_malloc shall call the C99 malloc function and return its result.] */
+        ((header = allocate_block(allocationSize, size, 0)) == NULL))
+    {
+        /* Codes_SRS_GBALLOC_01_012: [When the underlying malloc call fails, gballoc_malloc shall return NULL and size should not be counted towards total memory used.] */
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_GBALLOC_01_004: [If the underlying malloc call is successful, gb_malloc shall increment the total memory used with the amount indicated by size.] */
+        /* Codes_SRS_GBALLOC_07_011: [ When built with GB_TRACK_IN_HEADER, the counters shall be updated with atomic operations and without taking a lock. ]*/
+        result = track_header(header, size);
+    }
+
+    return result;
+}
+
+void* gballoc_calloc(size_t nmemb, size_t size)
+{
+    void* result;
+    size_t userSize = safe_multiply_size_t(nmemb, size);
+    size_t allocationSize = safe_add_size_t(userSize, sizeof(GBALLOC_HEADER));
+    GBALLOC_HEADER* header;
+
+    if ((userSize == SIZE_MAX) ||
+        (allocationSize == SIZE_MAX) ||
+        /* Codes_SRS_GBALLOC_01_020: [gballoc_calloc shall call the C99 calloc function and return its result.] */
+        ((header = allocate_block(allocationSize, userSize, 1)) == NULL))
+    {
+        /* Codes_SRS_GBALLOC_01_022: [When the underlying calloc call fails, gballoc_calloc shall return NULL and size should not be counted towards total memory used.] */
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_GBALLOC_01_021: [If the underlying calloc call is successful, gballoc_calloc shall increment the total memory used with nmemb*size.] */
+        result = track_header(header, userSize);
+    }
+
+    return result;
+}
+
+void* gballoc_realloc(void* ptr, size_t size)
+{
+    void* result;
+    size_t allocationSize = safe_add_size_t(size, sizeof(GBALLOC_HEADER));
+    GBALLOC_HEADER* header;
+
+    if (allocationSize == SIZE_MAX)
+    {
+        result = NULL;
+    }
+    else if (ptr == NULL)
+    {
+        /* Codes_SRS_GBALLOC_01_017: [When ptr is NULL, gballoc_realloc shall call the underlying realloc with ptr being NULL and the realloc result shall be tracked by gballoc.] */
+        if ((header = reallocate_block(NULL, allocationSize, size)) == NULL)
+        {
+            /* Codes_SRS_GBALLOC_01_014: [When the underlying realloc call fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
+            result = NULL;
+        }
+        else
+        {
+            result = track_header(header, size);
+        }
+    }
+    else if ((header = get_header(ptr)) == NULL)
+    {
+        /* Codes_SRS_GBALLOC_01_016: [When the ptr pointer cannot be found in the pointers tracked by gballoc, gballoc_realloc shall return NULL and the underlying realloc shall not be called.] */
+        LogError("Could not realloc allocation for address %p (not allocated by gballoc)", ptr);
+        result = NULL;
+    }
+    else
+    {
+        size_t oldSize = header->info.size;
+        int wasCounted = is_counted(header);
+        GBALLOC_HEADER* newHeader = reallocate_block(header, allocationSize, size);
+        if (newHeader == NULL)
+        {
+            /* Codes_SRS_GBALLOC_01_014: [When the underlying realloc call fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
+            result = NULL;
+        }
+        else
+        {
+            /* Codes_SRS_GBALLOC_01_006: [If the underlying realloc call is successful, gballoc_realloc shall look up the size associated with the pointer ptr and decrease the total memory used with that size.] */
+            if (wasCounted)
+            {
+                (void)GBALLOC_ATOMIC_ADD(totalSize, (size_t)0 - oldSize);
+            }
+            /* Codes_SRS_GBALLOC_01_007: [If realloc is successful, gballoc_realloc shall also increment the total memory used value tracked by this module.] */
+            result = track_header(newHeader, size);
+        }
+    }
+
+    return result;
+}
+
+void gballoc_free(void* ptr)
+{
+    if (ptr != NULL)
+    {
+        GBALLOC_HEADER* header = get_header(ptr);
+        if (header == NULL)
+        {
+            /* Codes_SRS_GBALLOC_01_019: [When the ptr pointer cannot be found in the pointers tracked by gballoc, gballoc_free shall not free any memory.] */
+            LogError("Could not free allocation for address %p (not allocated by gballoc)", ptr);
+        }
+        else
+        {
+            /* Codes_SRS_GBALLOC_01_009: [gballoc_free shall also look up the size associated with the ptr pointer and decrease the total memory used with the associated size amount.] */
+            if (is_counted(header))
+            {
+                (void)GBALLOC_ATOMIC_ADD(totalSize, (size_t)0 - header->info.size);
+            }
+            /* a second free of the same pointer is reported instead of corrupting the heap (as long as the memory was not reused) */
+            header->info.check = 0;
+            /* Codes_SRS_GBALLOC_01_008: [gballoc_free shall call the C99 free function.] */
+            release_block(header);
+        }
+    }
+}
+
+size_t gballoc_getMaximumMemoryUsed(void)
+{
+    size_t result;
+
+    /* Codes_SRS_GBALLOC_01_038: [If gballoc was not initialized gballoc_getMaximumMemoryUsed shall return MAX_INT_SIZE.] */
+    if (gballocState != GBALLOC_STATE_INIT)
+    {
+        LogError("gballoc is not initialized.");
+        result = SIZE_MAX;
+    }
+    else
+    {
+        /* Codes_SRS_GBALLOC_01_010: [gballoc_getMaximumMemoryUsed shall return the maximum amount of total memory used recorded since the module initialization.] */
+        result = GBALLOC_ATOMIC_LOAD(maxSize);
+    }
+
+    return result;
+}
+
+size_t gballoc_getCurrentMemoryUsed(void)
+{
+    size_t result;
+
+    /* Codes_SRS_GBALLOC_01_044: [If gballoc was not initialized gballoc_getCurrentMemoryUsed shall return SIZE_MAX.] */
+    if (gballocState != GBALLOC_STATE_INIT)
+    {
+        LogError("gballoc is not initialized.");
+        result = SIZE_MAX;
+    }
+    else
+    {
+        /*Codes_SRS_GBALLOC_02_001: [gballoc_getCurrentMemoryUsed shall return the currently used memory size.] */
+        result = GBALLOC_ATOMIC_LOAD(totalSize);
+    }
+
+    return result;
+}
+
+size_t gballoc_getAllocationCount(void)
+{
+    size_t result;
+
+    /* Codes_SRS_GBALLOC_07_001: [ If gballoc was not initialized gballoc_getAllocationCount shall return 0. ] */
+    if (gballocState != GBALLOC_STATE_INIT)
+    {
+        LogError("gballoc is not initialized.");
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_GBALLOC_07_004: [ gballoc_getAllocationCount shall return the currently number of allocations. ] */
+        result = GBALLOC_ATOMIC_LOAD(g_allocations);
+    }
+
+    return result;
+}
+
+void gballoc_resetMetrics(void)
+{
+    /* Codes_SRS_GBALLOC_07_005: [ If gballoc was not initialized gballoc_reset Metrics shall do nothing.] */
+    if (gballocState != GBALLOC_STATE_INIT)
+    {
+        LogError("gballoc is not initialized.");
+    }
+    else
+    {
+        /* Codes_SRS_GBALLOC_07_008: [ gballoc_resetMetrics shall reset the total allocation size, max allocation size and number of allocation to zero. ] */
+        /* Codes_SRS_GBALLOC_07_012: [ When built with GB_TRACK_IN_HEADER, memory allocated before gballoc_resetMetrics shall not be subtracted from the total memory used when it is freed. ]*/
+        reset_counters();
+    }
+}
+
+#else /* GB_TRACK_IN_HEADER */
+
 typedef struct ALLOCATION_TAG
 {
     size_t size;
@@ -21,12 +873,6 @@ typedef struct ALLOCATION_TAG
     void* next;
 } ALLOCATION;
 
-typedef enum GBALLOC_STATE_TAG
-{
-    GBALLOC_STATE_INIT,
-    GBALLOC_STATE_NOT_INIT
-} GBALLOC_STATE;
-
 static ALLOCATION* head = NULL;
 static size_t totalSize = 0;
 static size_t maxSize = 0;
@@ -286,7 +1132,7 @@ void* gballoc_realloc(void* ptr, size_t size)
 
 void gballoc_free(void* ptr)
 {
-    ALLOCATION* curr = head;
+    ALLOCATION* curr;
     ALLOCATION* prev = NULL;
 
     if (gballocState != GBALLOC_STATE_INIT)
@@ -303,6 +1149,8 @@ void gballoc_free(void* ptr)
     else
     {
         /* Codes_SRS_GBALLOC_01_009: [gballoc_free shall also look up the size associated with the ptr pointer and decrease the total memory used with the associated size amount.] */
+        /* the list is only read under the lock, another thread might have changed head in the meantime */
+        curr = head;
         while (curr != NULL)
         {
             if (curr->ptr == ptr)
@@ -448,4 +1296,87 @@ void gballoc_resetMetrics(void)
     }
 }
 
+#endif /* GB_TRACK_IN_HEADER */
+
+#if defined(GB_USE_POOL)
+
+/* sums a counter over all the thread caches, called under the lock */
+#define POOL_SUM(field, result) \
+    do \
+    { \
+        POOL_THREAD_CACHE* cache; \
+        result = POOL_COUNTER_LOAD(pool_shared_cache.field); \
+        for (cache = pool_thread_caches; cache != NULL; cache = cache->next) \
+        { \
+            result += POOL_COUNTER_LOAD(cache->field); \
+        } \
+    } while ((void)0, 0)
+
+size_t gballoc_getPoolHitCount(void)
+{
+    size_t result;
+    /* Codes_SRS_GBALLOC_07_016: [ gballoc_getPoolHitCount shall return the number of allocations served by the pool without calling malloc. ]*/
+    pool_lock();
+    POOL_SUM(hits, result);
+    pool_unlock();
+    return result;
+}
+
+size_t gballoc_getPoolMissCount(void)
+{
+    size_t result;
+    /* Codes_SRS_GBALLOC_07_017: [ gballoc_getPoolMissCount shall return the number of allocations for which the pool had to allocate a new slab. ]*/
+    pool_lock();
+    POOL_SUM(misses, result);
+    pool_unlock();
+    return result;
+}
+
+size_t gballoc_getPoolReservedMemory(void)
+{
+    size_t result;
+    /* Codes_SRS_GBALLOC_07_018: [ gballoc_getPoolReservedMemory shall return the memory allocated by the pool for its slabs. ]*/
+    pool_lock();
+    result = pool_reserved_bytes;
+    pool_unlock();
+    return result;
+}
+
+size_t gballoc_getPoolWastedMemory(void)
+{
+    size_t requested;
+    size_t result;
+    /* Codes_SRS_GBALLOC_07_019: [ gballoc_getPoolWastedMemory shall return the memory reserved by the pool that is not holding requested bytes: free blocks, headers and the unused end of blocks. ]*/
+    pool_lock();
+    POOL_SUM(requested_bytes, requested);
+    result = pool_reserved_bytes - requested;
+    pool_unlock();
+    return result;
+}
+
+#else /* GB_USE_POOL */
+
+/* Codes_SRS_GBALLOC_07_020: [ When not built with GB_USE_POOL, gballoc_getPoolHitCount, gballoc_getPoolMissCount, gballoc_getPoolReservedMemory and gballoc_getPoolWastedMemory shall return 0. ]*/
+size_t gballoc_getPoolHitCount(void)
+{
+    return 0;
+}
+
+size_t gballoc_getPoolMissCount(void)
+{
+    return 0;
+}
+
+size_t gballoc_getPoolReservedMemory(void)
+{
+    return 0;
+}
+
+size_t gballoc_getPoolWastedMemory(void)
+{
+    return 0;
+}
+
+#endif /* GB_USE_POOL */
+
 #endif // GB_USE_CUSTOM_HEAP
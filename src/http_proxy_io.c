@@ -888,6 +888,48 @@ static int http_proxy_io_send(CONCRETE_IO_HANDLE http_proxy_io, const void* buff
     return result;
 }
 
+static int http_proxy_io_send_array(CONCRETE_IO_HANDLE http_proxy_io, CONSTBUFFER_ARRAY_HANDLE buffers, ON_SEND_COMPLETE on_send_complete, void* on_send_complete_context)
+{
+    int result;
+
+    /* Codes_SRS_HTTP_PROXY_IO_04_001: [ If any of the arguments http_proxy_io or buffers is NULL, http_proxy_io_send_array shall fail and return a non-zero value. ]*/
+    if ((http_proxy_io == NULL) ||
+        (buffers == NULL))
+    {
+        result = __LINE__;
+        LogError("Bad arguments: http_proxy_io = %p, buffers = %p.",
+            http_proxy_io, buffers);
+    }
+    else
+    {
+        HTTP_PROXY_IO_INSTANCE* http_proxy_io_instance = (HTTP_PROXY_IO_INSTANCE*)http_proxy_io;
+
+        /* Codes_SRS_HTTP_PROXY_IO_04_002: [ If http_proxy_io_send_array is called when the IO is not open or is in an error state, http_proxy_io_send_array shall fail and return a non-zero value. ]*/
+        if (http_proxy_io_instance->http_proxy_io_state != HTTP_PROXY_IO_STATE_OPEN)
+        {
+            result = __LINE__;
+            LogError("Invalid HTTP proxy IO state. Expected state is HTTP_PROXY_IO_STATE_OPEN.");
+        }
+        else
+        {
+            /* Codes_SRS_HTTP_PROXY_IO_04_003: [ http_proxy_io_send_array shall send the buffers by calling xio_send_array on the underlying IO created in http_proxy_io_create and passing buffers, on_send_complete and on_send_complete_context as arguments. ]*/
+            if (xio_send_array(http_proxy_io_instance->underlying_io, buffers, on_send_complete, on_send_complete_context) != 0)
+            {
+                /* Codes_SRS_HTTP_PROXY_IO_04_004: [ If xio_send_array fails, http_proxy_io_send_array shall fail and return a non-zero value. ]*/
+                result = __LINE__;
+                LogError("Underlying xio_send_array failed.");
+            }
+            else
+            {
+                /* Codes_SRS_HTTP_PROXY_IO_04_005: [ On success http_proxy_io_send_array shall return 0. ]*/
+                result = 0;
+            }
+        }
+    }
+
+    return result;
+}
+
 static void http_proxy_io_dowork(CONCRETE_IO_HANDLE http_proxy_io)
 {
     if (http_proxy_io == NULL)
@@ -1067,11 +1109,12 @@ static const IO_INTERFACE_DESCRIPTION http_proxy_io_interface_description =
     http_proxy_io_close,
     http_proxy_io_send,
     http_proxy_io_dowork,
-    http_proxy_io_set_option
+    http_proxy_io_set_option,
+    http_proxy_io_send_array
 };
 
 const IO_INTERFACE_DESCRIPTION* http_proxy_io_get_interface_description(void)
 {
-    /* Codes_SRS_HTTP_PROXY_IO_01_049: [ http_proxy_io_get_interface_description shall return a pointer to an IO_INTERFACE_DESCRIPTION structure that contains pointers to the functions: http_proxy_io_retrieve_options, http_proxy_io_retrieve_create, http_proxy_io_destroy, http_proxy_io_open, http_proxy_io_close, http_proxy_io_send and http_proxy_io_dowork. ]*/
+    /* Codes_SRS_HTTP_PROXY_IO_01_049: [ http_proxy_io_get_interface_description shall return a pointer to an IO_INTERFACE_DESCRIPTION structure that contains pointers to the functions: http_proxy_io_retrieve_options, http_proxy_io_retrieve_create, http_proxy_io_destroy, http_proxy_io_open, http_proxy_io_close, http_proxy_io_send, http_proxy_io_dowork and http_proxy_io_send_array. ]*/
     return &http_proxy_io_interface_description;
 }
@@ -11,6 +11,10 @@
 #include "azure_c_shared_utility/strings.h"
 #include "azure_c_shared_utility/crt_abstractions.h"
 #include "azure_c_shared_utility/vector.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/condition.h"
+#include "azure_c_shared_utility/tickcounter.h"
+#include "azure_c_shared_utility/shared_util_options.h"
 
 typedef struct HTTPAPIEX_SAVED_OPTION_TAG
 {
@@ -18,12 +22,33 @@ typedef struct HTTPAPIEX_SAVED_OPTION_TAG
     const void* value;
 }HTTPAPIEX_SAVED_OPTION;
 
+typedef struct POOLED_CONNECTION_TAG
+{
+    HTTP_HANDLE httpHandle;
+    tickcounter_ms_t idleSinceMs;
+    struct POOLED_CONNECTION_TAG* next;
+}POOLED_CONNECTION;
+
+typedef struct CONNECTION_POOL_TAG
+{
+    LOCK_HANDLE lock;
+    COND_HANDLE connectionReleased;
+    TICK_COUNTER_HANDLE tickCounter;
+    HTTPAPIEX_CONNECTION_POOL_CONFIG config;
+    /*most recently used first*/
+    POOLED_CONNECTION* idleConnections;
+    /*leased and idle*/
+    size_t connectionCount;
+    HTTPAPIEX_CONNECTION_POOL_STATISTICS statistics;
+}CONNECTION_POOL;
+
 typedef struct HTTPAPIEX_HANDLE_DATA_TAG
 {
     STRING_HANDLE hostName;
     int k;
     HTTP_HANDLE httpHandle;
     VECTOR_HANDLE savedOptions;
+    CONNECTION_POOL* connectionPool;
 }HTTPAPIEX_HANDLE_DATA;
 
 MU_DEFINE_ENUM_STRINGS(HTTPAPIEX_RESULT, HTTPAPIEX_RESULT_VALUES);
@@ -340,6 +365,285 @@ static int buildAllRequests(HTTPAPIEX_HANDLE_DATA* handle, HTTPAPI_REQUEST_TYPE
     return result;
 }
 
+static HTTP_HANDLE createConnection(HTTPAPIEX_HANDLE_DATA* handleData)
+{
+    HTTP_HANDLE result = HTTPAPI_CreateConnection(STRING_c_str(handleData->hostName));
+    if (result != NULL)
+    {
+        size_t i;
+        size_t vectorSize = VECTOR_size(handleData->savedOptions);
+        for (i = 0; i < vectorSize; i++)
+        {
+            /*Codes_SRS_HTTPAPIEX_02_035: [HTTPAPIEX_ExecuteRequest shall pass all the saved options (see HTTPAPIEX_SetOption) to the newly create HTTPAPI_HANDLE in step 2 by calling HTTPAPI_SetOption.]*/
+            /*Codes_SRS_HTTPAPIEX_02_036: [If setting the option fails, then the failure shall be ignored.] */
+            HTTPAPIEX_SAVED_OPTION* option = (HTTPAPIEX_SAVED_OPTION*)VECTOR_element(handleData->savedOptions, i);
+            if (HTTPAPI_SetOption(result, option->optionName, option->value) != HTTPAPI_OK)
+            {
+                LogError("HTTPAPI_SetOption failed when called for option %s", option->optionName);
+            }
+        }
+    }
+    return result;
+}
+
+static void closeConnections(POOLED_CONNECTION* connections)
+{
+    while (connections != NULL)
+    {
+        POOLED_CONNECTION* next = connections->next;
+        if (connections->httpHandle != NULL)
+        {
+            HTTPAPI_CloseConnection(connections->httpHandle);
+        }
+        free(connections);
+        connections = next;
+    }
+}
+
+/*takes out of the pool the idle connections that are too old or beyond max_idle_connections, called with the lock held*/
+static POOLED_CONNECTION* takeEvictedConnections(CONNECTION_POOL* pool)
+{
+    POOLED_CONNECTION* result;
+    POOLED_CONNECTION* connection;
+    POOLED_CONNECTION** link = &pool->idleConnections;
+    tickcounter_ms_t nowMs = 0;
+    size_t kept = 0;
+    bool checkAge = (pool->config.idle_timeout_ms != 0);
+
+    if (checkAge && (tickcounter_get_current_ms(pool->tickCounter, &nowMs) != 0))
+    {
+        LogError("unable to get the current time, idle connections are not checked for age");
+        checkAge = false;
+    }
+
+    /*the list is most recently used first, so once a connection is evicted all the ones after it are too*/
+    while ((*link != NULL) &&
+        (kept < pool->config.max_idle_connections) &&
+        (!checkAge || ((nowMs - (*link)->idleSinceMs) <= pool->config.idle_timeout_ms)))
+    {
+        kept++;
+        link = &((*link)->next);
+    }
+
+    result = *link;
+    *link = NULL;
+    for (connection = result; connection != NULL; connection = connection->next)
+    {
+        pool->connectionCount--;
+        pool->statistics.idle_connections--;
+        pool->statistics.connections_evicted++;
+    }
+
+    return result;
+}
+
+static void appendConnections(POOLED_CONNECTION** connections, POOLED_CONNECTION* more)
+{
+    while (*connections != NULL)
+    {
+        connections = &((*connections)->next);
+    }
+    *connections = more;
+}
+
+/*gives back the place of a connection that is not in the pool anymore*/
+static void releaseConnectionSlot(CONNECTION_POOL* pool)
+{
+    if (Lock(pool->lock) != LOCK_OK)
+    {
+        LogError("unable to Lock");
+    }
+    else
+    {
+        pool->connectionCount--;
+        (void)Condition_Post(pool->connectionReleased);
+        (void)Unlock(pool->lock);
+    }
+}
+
+/*leases the most recently used idle connection, or creates one if the pool is not full, or waits for one to be released*/
+static POOLED_CONNECTION* leaseConnection(HTTPAPIEX_HANDLE_DATA* handleData)
+{
+    POOLED_CONNECTION* result = NULL;
+    POOLED_CONNECTION* evicted = NULL;
+    CONNECTION_POOL* pool = handleData->connectionPool;
+    bool mustCreate = false;
+
+    if (Lock(pool->lock) != LOCK_OK)
+    {
+        LogError("unable to Lock");
+    }
+    else
+    {
+        bool isError = false;
+        while ((result == NULL) && !mustCreate && !isError)
+        {
+            appendConnections(&evicted, takeEvictedConnections(pool));
+            if (pool->idleConnections != NULL)
+            {
+                result = pool->idleConnections;
+                pool->idleConnections = result->next;
+                result->next = NULL;
+                pool->statistics.idle_connections--;
+                pool->statistics.connections_reused++;
+            }
+            else if (pool->connectionCount < pool->config.max_connections)
+            {
+                pool->connectionCount++;
+                mustCreate = true;
+            }
+            else if (Condition_Wait(pool->connectionReleased, pool->lock, 0) != COND_OK)
+            {
+                LogError("unable to wait for a connection to be released");
+                isError = true;
+            }
+        }
+        (void)Unlock(pool->lock);
+    }
+
+    closeConnections(evicted);
+
+    if (mustCreate)
+    {
+        result = (POOLED_CONNECTION*)calloc(1, sizeof(POOLED_CONNECTION));
+        if (result == NULL)
+        {
+            LogError("unable to allocate a pooled connection");
+            releaseConnectionSlot(pool);
+        }
+        else if ((result->httpHandle = createConnection(handleData)) == NULL)
+        {
+            LogError("unable to create a connection");
+            free(result);
+            result = NULL;
+            releaseConnectionSlot(pool);
+        }
+        else if (Lock(pool->lock) == LOCK_OK)
+        {
+            pool->statistics.connections_created++;
+            (void)Unlock(pool->lock);
+        }
+    }
+
+    return result;
+}
+
+/*keeps the connection for the next request, unless the pool has enough idle connections*/
+static void releaseConnection(CONNECTION_POOL* pool, POOLED_CONNECTION* connection)
+{
+    if (Lock(pool->lock) != LOCK_OK)
+    {
+        LogError("unable to Lock");
+    }
+    else
+    {
+        if ((pool->statistics.idle_connections < pool->config.max_idle_connections) &&
+            (tickcounter_get_current_ms(pool->tickCounter, &connection->idleSinceMs) == 0))
+        {
+            connection->next = pool->idleConnections;
+            pool->idleConnections = connection;
+            pool->statistics.idle_connections++;
+            connection = NULL;
+        }
+        else
+        {
+            pool->connectionCount--;
+            pool->statistics.connections_evicted++;
+        }
+        (void)Condition_Post(pool->connectionReleased);
+        (void)Unlock(pool->lock);
+    }
+
+    closeConnections(connection);
+}
+
+static void discardConnection(CONNECTION_POOL* pool, POOLED_CONNECTION* connection)
+{
+    closeConnections(connection);
+    releaseConnectionSlot(pool);
+}
+
+static void closeIdleConnections(CONNECTION_POOL* pool)
+{
+    POOLED_CONNECTION* idleConnections = NULL;
+    if (Lock(pool->lock) != LOCK_OK)
+    {
+        LogError("unable to Lock");
+    }
+    else
+    {
+        POOLED_CONNECTION* connection;
+        idleConnections = pool->idleConnections;
+        pool->idleConnections = NULL;
+        for (connection = idleConnections; connection != NULL; connection = connection->next)
+        {
+            pool->connectionCount--;
+            pool->statistics.idle_connections--;
+        }
+        (void)Condition_Post(pool->connectionReleased);
+        (void)Unlock(pool->lock);
+    }
+
+    closeConnections(idleConnections);
+}
+
+static HTTPAPIEX_RESULT executePooledRequest(HTTPAPIEX_HANDLE_DATA* handleData, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath,
+    HTTP_HEADERS_HANDLE requestHttpHeadersHandle, BUFFER_HANDLE requestContent, unsigned int* statusCode,
+    HTTP_HEADERS_HANDLE responseHttpHeadersHandle, BUFFER_HANDLE responseContent)
+{
+    HTTPAPIEX_RESULT result;
+    CONNECTION_POOL* pool = handleData->connectionPool;
+    POOLED_CONNECTION* connection = leaseConnection(handleData);
+
+    if (connection == NULL)
+    {
+        result = HTTPAPIEX_ERROR;
+        LOG_HTTAPIEX_ERROR();
+    }
+    else
+    {
+        size_t length = BUFFER_length(requestContent);
+        unsigned char* buffer = BUFFER_u_char(requestContent);
+        HTTPAPI_RESULT httpResult = HTTPAPI_ExecuteRequest(connection->httpHandle, requestType, relativePath, requestHttpHeadersHandle, buffer, length, statusCode, responseHttpHeadersHandle, responseContent);
+
+        if (httpResult != HTTPAPI_OK)
+        {
+            /*Codes_SRS_HTTPAPIEX_02_026: [A step shall be retried at most once.]*/
+            /*the host may have closed the connection while it was idle, the request is sent once more on a new connection*/
+            HTTPAPI_CloseConnection(connection->httpHandle);
+            connection->httpHandle = createConnection(handleData);
+            if (Lock(pool->lock) == LOCK_OK)
+            {
+                pool->statistics.requests_retried++;
+                if (connection->httpHandle != NULL)
+                {
+                    pool->statistics.connections_created++;
+                }
+                (void)Unlock(pool->lock);
+            }
+
+            if (connection->httpHandle != NULL)
+            {
+                httpResult = HTTPAPI_ExecuteRequest(connection->httpHandle, requestType, relativePath, requestHttpHeadersHandle, buffer, length, statusCode, responseHttpHeadersHandle, responseContent);
+            }
+        }
+
+        if (httpResult == HTTPAPI_OK)
+        {
+            releaseConnection(pool, connection);
+            result = HTTPAPIEX_OK;
+        }
+        else
+        {
+            discardConnection(pool, connection);
+            result = HTTPAPIEX_RECOVERYFAILED;
+            LogError("unable to execute the request on a pooled connection");
+        }
+    }
+
+    return result;
+}
+
 static bool validRequestType(HTTPAPI_REQUEST_TYPE requestType)
 {
     bool result;
@@ -412,6 +716,15 @@ HTTPAPIEX_RESULT HTTPAPIEX_ExecuteRequest(HTTPAPIEX_HANDLE handle, HTTPAPI_REQUE
                 /*Codes_SRS_HTTPAPIEX_02_026: [A step shall be retried at most once.]*/
                 /*Codes_SRS_HTTPAPIEX_02_027: [If a step has been retried then all subsequent steps shall be retried too.]*/
                 bool st[3] = { false, false, false }; /*the three levels of possible failure in resilient send: HTTAPI_Init, HTTPAPI_CreateConnection, HTTPAPI_ExecuteRequest*/
+                if (handleData->connectionPool != NULL)
+                {
+                    /*requests run concurrently on a pooled handle, they do not share the dummy status code*/
+                    unsigned int pooledStatusCode;
+                    result = executePooledRequest(handleData, requestType, toBeUsedRelativePath, toBeUsedRequestHttpHeadersHandle, toBeUsedRequestContent,
+                        (toBeUsedStatusCode == &dummyStatusCode) ? &pooledStatusCode : toBeUsedStatusCode, toBeUsedResponseHttpHeadersHandle, toBeUsedResponseContent);
+                    goto out;
+                }
+
                 if (handleData->k == -1)
                 {
                     handleData->k = 0;
@@ -454,24 +767,12 @@ HTTPAPIEX_RESULT HTTPAPIEX_ExecuteRequest(HTTPAPIEX_HANDLE handle, HTTPAPI_REQUE
                         }
                         case 1:
                         {
-                            if ((handleData->httpHandle = HTTPAPI_CreateConnection(STRING_c_str(handleData->hostName))) == NULL)
+                            if ((handleData->httpHandle = createConnection(handleData)) == NULL)
                             {
                                 goOn = false;
                             }
                             else
                             {
-                                size_t i;
-                                size_t vectorSize = VECTOR_size(handleData->savedOptions);
-                                for (i = 0; i < vectorSize; i++)
-                                {
-                                    /*Codes_SRS_HTTPAPIEX_02_035: [HTTPAPIEX_ExecuteRequest shall pass all the saved options (see HTTPAPIEX_SetOption) to the newly create HTTPAPI_HANDLE in step 2 by calling HTTPAPI_SetOption.]*/
-                                    /*Codes_SRS_HTTPAPIEX_02_036: [If setting the option fails, then the failure shall be ignored.] */
-                                    HTTPAPIEX_SAVED_OPTION* option = (HTTPAPIEX_SAVED_OPTION*)VECTOR_element(handleData->savedOptions, i);
-                                    if (HTTPAPI_SetOption(handleData->httpHandle, option->optionName, option->value) != HTTPAPI_OK)
-                                    {
-                                        LogError("HTTPAPI_SetOption failed when called for option %s", option->optionName);
-                                    }
-                                }
                                 goOn = true;
                             }
                             break;
@@ -596,6 +897,14 @@ void HTTPAPIEX_Destroy(HTTPAPIEX_HANDLE handle)
                 HTTPAPI_Deinit();
             }
         }
+        if (handleData->connectionPool != NULL)
+        {
+            closeConnections(handleData->connectionPool->idleConnections);
+            tickcounter_destroy(handleData->connectionPool->tickCounter);
+            Condition_Deinit(handleData->connectionPool->connectionReleased);
+            Lock_Deinit(handleData->connectionPool->lock);
+            free(handleData->connectionPool);
+        }
         STRING_delete(handleData->hostName);
 
         vectorSize = VECTOR_size(handleData->savedOptions);
@@ -665,6 +974,86 @@ static int createOrUpdateOption(HTTPAPIEX_HANDLE_DATA* handleData, const char* o
     return result;
 }
 
+static HTTPAPIEX_RESULT setConnectionPool(HTTPAPIEX_HANDLE_DATA* handleData, const HTTPAPIEX_CONNECTION_POOL_CONFIG* config)
+{
+    HTTPAPIEX_RESULT result;
+
+    if ((config->max_connections == 0) ||
+        (config->max_idle_connections > config->max_connections))
+    {
+        result = HTTPAPIEX_INVALID_ARG;
+        LogError("invalid connection pool configuration, max_connections=%lu, max_idle_connections=%lu",
+            (unsigned long)config->max_connections, (unsigned long)config->max_idle_connections);
+    }
+    else if (useGlobalInitialization == 0)
+    {
+        /*pooled connections outlive the requests, HTTPAPI cannot be initialized per request*/
+        result = HTTPAPIEX_ERROR;
+        LogError("the connection pool needs HTTPAPIEX_Init");
+    }
+    else if (handleData->connectionPool != NULL)
+    {
+        if (Lock(handleData->connectionPool->lock) != LOCK_OK)
+        {
+            result = HTTPAPIEX_ERROR;
+            LogError("unable to Lock");
+        }
+        else
+        {
+            POOLED_CONNECTION* evicted;
+            handleData->connectionPool->config = *config;
+            evicted = takeEvictedConnections(handleData->connectionPool);
+            (void)Condition_Post(handleData->connectionPool->connectionReleased);
+            (void)Unlock(handleData->connectionPool->lock);
+            closeConnections(evicted);
+            result = HTTPAPIEX_OK;
+        }
+    }
+    else if (handleData->httpHandle != NULL)
+    {
+        result = HTTPAPIEX_ERROR;
+        LogError("the connection pool shall be set before the first request");
+    }
+    else
+    {
+        CONNECTION_POOL* pool = (CONNECTION_POOL*)calloc(1, sizeof(CONNECTION_POOL));
+        if (pool == NULL)
+        {
+            result = HTTPAPIEX_ERROR;
+            LogError("unable to allocate the connection pool");
+        }
+        else if ((pool->lock = Lock_Init()) == NULL)
+        {
+            free(pool);
+            result = HTTPAPIEX_ERROR;
+            LogError("unable to Lock_Init");
+        }
+        else if ((pool->connectionReleased = Condition_Init()) == NULL)
+        {
+            Lock_Deinit(pool->lock);
+            free(pool);
+            result = HTTPAPIEX_ERROR;
+            LogError("unable to Condition_Init");
+        }
+        else if ((pool->tickCounter = tickcounter_create()) == NULL)
+        {
+            Condition_Deinit(pool->connectionReleased);
+            Lock_Deinit(pool->lock);
+            free(pool);
+            result = HTTPAPIEX_ERROR;
+            LogError("unable to tickcounter_create");
+        }
+        else
+        {
+            pool->config = *config;
+            handleData->connectionPool = pool;
+            result = HTTPAPIEX_OK;
+        }
+    }
+
+    return result;
+}
+
 HTTPAPIEX_RESULT HTTPAPIEX_SetOption(HTTPAPIEX_HANDLE handle, const char* optionName, const void* value)
 {
     HTTPAPIEX_RESULT result;
@@ -680,6 +1069,10 @@ HTTPAPIEX_RESULT HTTPAPIEX_SetOption(HTTPAPIEX_HANDLE handle, const char* option
         result = HTTPAPIEX_INVALID_ARG;
         LOG_HTTAPIEX_ERROR();
     }
+    else if (strcmp(optionName, OPTION_HTTPAPIEX_CONNECTION_POOL) == 0)
+    {
+        result = setConnectionPool((HTTPAPIEX_HANDLE_DATA*)handle, (const HTTPAPIEX_CONNECTION_POOL_CONFIG*)value);
+    }
     else
     {
         const void* savedOption;
@@ -734,6 +1127,11 @@ HTTPAPIEX_RESULT HTTPAPIEX_SetOption(HTTPAPIEX_HANDLE handle, const char* option
                 }
                 else
                 {
+                    if (handleData->connectionPool != NULL)
+                    {
+                        /*the pooled connections are created again with the new option*/
+                        closeIdleConnections(handleData->connectionPool);
+                    }
                     result = HTTPAPIEX_OK;
                 }
             }
@@ -741,3 +1139,27 @@ HTTPAPIEX_RESULT HTTPAPIEX_SetOption(HTTPAPIEX_HANDLE handle, const char* option
     }
     return result;
 }
+
+HTTPAPIEX_RESULT HTTPAPIEX_GetConnectionPoolStatistics(HTTPAPIEX_HANDLE handle, HTTPAPIEX_CONNECTION_POOL_STATISTICS* statistics)
+{
+    HTTPAPIEX_RESULT result;
+
+    if ((handle == NULL) || (statistics == NULL) || (handle->connectionPool == NULL))
+    {
+        result = HTTPAPIEX_INVALID_ARG;
+        LOG_HTTAPIEX_ERROR();
+    }
+    else if (Lock(handle->connectionPool->lock) != LOCK_OK)
+    {
+        result = HTTPAPIEX_ERROR;
+        LOG_HTTAPIEX_ERROR();
+    }
+    else
+    {
+        *statistics = handle->connectionPool->statistics;
+        (void)Unlock(handle->connectionPool->lock);
+        result = HTTPAPIEX_OK;
+    }
+
+    return result;
+}
@@ -3,9 +3,10 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include "macro_utils/macro_utils.h"
 #include "azure_c_shared_utility/gballoc.h"
-#include "azure_c_shared_utility/map.h"
 #include "azure_c_shared_utility/httpheaders.h"
 #include "azure_c_shared_utility/crt_abstractions.h"
 #include "azure_c_shared_utility/xlogging.h"
@@ -13,11 +14,207 @@
 
 MU_DEFINE_ENUM_STRINGS(HTTP_HEADERS_RESULT, HTTP_HEADERS_RESULT_VALUES);
 
+/*a collection starts with room for that many headers, and doubles when it is full*/
+#define HTTP_HEADERS_INITIAL_CAPACITY 8
+
+typedef struct HTTP_HEADER_TAG
+{
+    /*one allocation with the header rendered as name + ": " + value, then the name on its own*/
+    char* line;
+    size_t line_length;
+    size_t name_length;
+    uint32_t hash;
+} HTTP_HEADER;
+
 typedef struct HTTP_HEADERS_HANDLE_DATA_TAG
 {
-    MAP_HANDLE headers;
+    /*in the order they were added*/
+    HTTP_HEADER* headers;
+    size_t count;
+    size_t capacity;
+    /*open addressing index of the headers by the hash of their lowercase name, each slot is 0 or the
+      index of a header + 1. It has twice as many slots as the capacity, so it is never more than half full*/
+    size_t* slots;
 } HTTP_HEADERS_HANDLE_DATA;
 
+#define TO_LOWER(c) ((((c) >= 'A') && ((c) <= 'Z')) ? (char)((c) - 'A' + 'a') : (c))
+
+/*FNV-1a of the lowercase name*/
+static uint32_t hash_name(const char* name, size_t* name_length)
+{
+    uint32_t hash = 2166136261u;
+    size_t i;
+
+    for (i = 0; name[i] != '\0'; i++)
+    {
+        hash ^= (uint32_t)(unsigned char)TO_LOWER(name[i]);
+        hash *= 16777619u;
+    }
+
+    *name_length = i;
+    return hash;
+}
+
+static const char* header_name(const HTTP_HEADER* header)
+{
+    return header->line + header->line_length + 1;
+}
+
+static const char* header_value(const HTTP_HEADER* header)
+{
+    return header->line + header->name_length + /*COLON_AND_SPACE_LENGTH*/ 2;
+}
+
+static bool names_are_equal(const char* left, const char* right, size_t length)
+{
+    size_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        if (TO_LOWER(left[i]) != TO_LOWER(right[i]))
+        {
+            break;
+        }
+    }
+
+    return (i == length);
+}
+
+static size_t* find_slot(HTTP_HEADERS_HANDLE_DATA* handleData, const char* name, size_t name_length, uint32_t hash)
+{
+    size_t* result;
+
+    if (handleData->slots == NULL)
+    {
+        result = NULL;
+    }
+    else
+    {
+        size_t mask = (handleData->capacity * 2) - 1;
+        size_t i = hash & mask;
+
+        /*the index always has free slots, so the probe ends either on the header or on a free slot*/
+        while (handleData->slots[i] != 0)
+        {
+            const HTTP_HEADER* header = &handleData->headers[handleData->slots[i] - 1];
+            if ((header->hash == hash) &&
+                (header->name_length == name_length) &&
+                names_are_equal(header_name(header), name, name_length))
+            {
+                break;
+            }
+            i = (i + 1) & mask;
+        }
+
+        result = &handleData->slots[i];
+    }
+
+    return result;
+}
+
+static HTTP_HEADER* find_header(HTTP_HEADERS_HANDLE_DATA* handleData, const char* name, size_t name_length, uint32_t hash)
+{
+    size_t* slot = find_slot(handleData, name, name_length, hash);
+    return ((slot == NULL) || (*slot == 0)) ? NULL : &handleData->headers[*slot - 1];
+}
+
+/*makes the single allocation of a header: name + ": " + value, or name + ": " + existing_value + ", " + value when
+  there is an existing value, then the name*/
+static char* render_header(const char* name, size_t name_length, const char* existing_value, size_t existing_value_length, const char* value, size_t* line_length)
+{
+    char* result;
+    size_t value_length = strlen(value);
+    size_t length = safe_add_size_t(name_length, /*COLON_AND_SPACE_LENGTH*/ 2);
+    size_t malloc_size;
+    if (existing_value != NULL)
+    {
+        length = safe_add_size_t(length, existing_value_length);
+        length = safe_add_size_t(length, /*COMMA_AND_SPACE_LENGTH*/ 2);
+    }
+    length = safe_add_size_t(length, value_length);
+    malloc_size = safe_add_size_t(length, /*EOL*/ 1);
+    malloc_size = safe_add_size_t(malloc_size, name_length);
+    malloc_size = safe_add_size_t(malloc_size, /*EOL*/ 1);
+
+    if (malloc_size == SIZE_MAX ||
+        (result = (char*)malloc(malloc_size)) == NULL)
+    {
+        LogError("failed to malloc, size= %zu", malloc_size);
+        result = NULL;
+    }
+    else
+    {
+        char* runResult = result;
+        (void)memcpy(runResult, name, name_length);
+        runResult += name_length;
+        (*runResult++) = ':';
+        (*runResult++) = ' ';
+        if (existing_value != NULL)
+        {
+            (void)memcpy(runResult, existing_value, existing_value_length);
+            runResult += existing_value_length;
+            (*runResult++) = ',';
+            (*runResult++) = ' ';
+        }
+        (void)memcpy(runResult, value, value_length + /*EOL*/ 1);
+        runResult += value_length + 1;
+        (void)memcpy(runResult, name, name_length);
+        runResult[name_length] = '\0';
+        *line_length = length;
+    }
+
+    return result;
+}
+
+/*makes room for one more header*/
+static int grow_headers(HTTP_HEADERS_HANDLE_DATA* handleData)
+{
+    int result;
+    size_t newCapacity = (handleData->capacity == 0) ? HTTP_HEADERS_INITIAL_CAPACITY : safe_multiply_size_t(handleData->capacity, 2);
+    size_t headers_size = safe_multiply_size_t(newCapacity, sizeof(HTTP_HEADER));
+    size_t slots_size = safe_multiply_size_t(safe_multiply_size_t(newCapacity, 2), sizeof(size_t));
+    HTTP_HEADER* newHeaders;
+    size_t* newSlots;
+
+    if ((headers_size == SIZE_MAX) || (slots_size == SIZE_MAX))
+    {
+        LogError("too many headers, capacity= %zu", handleData->capacity);
+        result = MU_FAILURE;
+    }
+    else if ((newHeaders = (HTTP_HEADER*)realloc(handleData->headers, headers_size)) == NULL)
+    {
+        LogError("failed to realloc, size= %zu", headers_size);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        handleData->headers = newHeaders;
+        if ((newSlots = (size_t*)malloc(slots_size)) == NULL)
+        {
+            /*the headers stay where realloc put them, with the old capacity*/
+            LogError("failed to malloc, size= %zu", slots_size);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            size_t i;
+
+            free(handleData->slots);
+            (void)memset(newSlots, 0, slots_size);
+            handleData->slots = newSlots;
+            handleData->capacity = newCapacity;
+            for (i = 0; i < handleData->count; i++)
+            {
+                size_t* slot = find_slot(handleData, header_name(&handleData->headers[i]), handleData->headers[i].name_length, handleData->headers[i].hash);
+                *slot = i + 1;
+            }
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
 HTTP_HEADERS_HANDLE HTTPHeaders_Alloc(void)
 {
     /*Codes_SRS_HTTP_HEADERS_99_002:[ This API shall produce a HTTP_HANDLE that can later be used in subsequent calls to the module.]*/
@@ -31,17 +228,10 @@ HTTP_HEADERS_HANDLE HTTPHeaders_Alloc(void)
     else
     {
         /*Codes_SRS_HTTP_HEADERS_99_004:[ After a successful init, HTTPHeaders_GetHeaderCount shall report 0 existing headers.]*/
-        result->headers = Map_Create(NULL);
-        if (result->headers == NULL)
-        {
-            LogError("Map_Create failed");
-            free(result);
-            result = NULL;
-        }
-        else
-        {
-            /*all is fine*/
-        }
+        result->headers = NULL;
+        result->count = 0;
+        result->capacity = 0;
+        result->slots = NULL;
     }
 
     /*Codes_SRS_HTTP_HEADERS_99_003:[ The function shall return NULL when the function cannot execute properly]*/
@@ -60,8 +250,14 @@ void HTTPHeaders_Free(HTTP_HEADERS_HANDLE handle)
     {
         /*Codes_SRS_HTTP_HEADERS_99_005:[ Calling this API shall de-allocate the data structures allocated by previous API calls to the same handle.]*/
         HTTP_HEADERS_HANDLE_DATA* handleData = (HTTP_HEADERS_HANDLE_DATA*)handle;
+        size_t i;
 
-        Map_Destroy(handleData->headers);
+        for (i = 0; i < handleData->count; i++)
+        {
+            free(handleData->headers[i].line);
+        }
+        free(handleData->slots);
+        free(handleData->headers);
         free(handleData);
     }
 }
@@ -85,7 +281,8 @@ static HTTP_HEADERS_RESULT headers_ReplaceHeaderNameValuePair(HTTP_HEADERS_HANDL
         /*Codes_SRS_HTTP_HEADERS_99_036:[ If name contains the characters outside character codes 33 to 126 then the return value shall be HTTP_HEADERS_INVALID_ARG]*/
         /*Codes_SRS_HTTP_HEADERS_99_031:[ If name contains the character ":" then the return value shall be HTTP_HEADERS_INVALID_ARG.]*/
         size_t i;
-        size_t nameLen = strlen(name);
+        size_t nameLen;
+        uint32_t hash = hash_name(name, &nameLen);
         for (i = 0; i < nameLen; i++)
         {
             if ((name[i] < 33) || (126 < name[i]) || (name[i] == ':'))
@@ -102,7 +299,10 @@ static HTTP_HEADERS_RESULT headers_ReplaceHeaderNameValuePair(HTTP_HEADERS_HANDL
         else
         {
             HTTP_HEADERS_HANDLE_DATA* handleData = (HTTP_HEADERS_HANDLE_DATA*)handle;
-            const char* existingValue = Map_GetValueFromKey(handleData->headers, name);
+            /*Codes_SRS_HTTP_HEADERS_99_040: [ Header names shall be compared without regard to case. ]*/
+            HTTP_HEADER* existingHeader = find_header(handleData, name, nameLen, hash);
+            char* newLine;
+            size_t newLineLength;
             /*eat up the whitespaces from value, as per RFC 2616, chapter 4.2 "The field value MAY be preceded by any amount of LWS, though a single SP is preferred."*/
             /*Codes_SRS_HTTP_HEADERS_02_002: [The LWS from the beginning of the value shall not be stored.] */
             while ((value[0] == ' ') || (value[0] == '\t') || (value[0] == '\r') || (value[0] == '\n'))
@@ -110,60 +310,56 @@ static HTTP_HEADERS_RESULT headers_ReplaceHeaderNameValuePair(HTTP_HEADERS_HANDL
                 value++;
             }
 
-            if (!replace && (existingValue != NULL))
+            if (existingHeader != NULL)
             {
-                char* newValue;
-                size_t existingValueLen = strlen(existingValue);
-                size_t valueLen = strlen(value);
-                size_t malloc_size = safe_add_size_t(existingValueLen, /*COMMA_AND_SPACE_LENGTH*/ 2);
-                malloc_size = safe_add_size_t(malloc_size, valueLen);
-                malloc_size = safe_add_size_t(malloc_size, /*EOL*/ 1);
-                malloc_size = safe_multiply_size_t(malloc_size, sizeof(char));
-                if (malloc_size == SIZE_MAX ||
-                    (newValue = (char*)malloc(malloc_size)) == NULL)
+                /*Codes_SRS_HTTP_HEADERS_99_041: [ A header that exists keeps the name it was first added with. ]*/
+                const char* existingValue = header_value(existingHeader);
+                size_t existingValueLen = existingHeader->line_length - existingHeader->name_length - /*COLON_AND_SPACE_LENGTH*/ 2;
+
+                /*Codes_SRS_HTTP_HEADERS_99_017:[ If the name already exists in the collection of headers, the function shall concatenate the new value after the existing value, separated by a comma and a space as in: old-value+", "+new-value.]*/
+                /*Codes_SRS_HTTP_HEADERS_06_001: [This API will perform exactly as HTTPHeaders_AddHeaderNameValuePair except that if the header name already exists the already existing value will be replaced as opposed to concatenated to.] */
+                newLine = render_header(header_name(existingHeader), existingHeader->name_length,
+                    replace ? NULL : existingValue, existingValueLen, value, &newLineLength);
+                if (newLine == NULL)
                 {
                     /*Codes_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
                     result = HTTP_HEADERS_ALLOC_FAILED;
-                    LogError("failed to malloc, size= %zu, result= %" PRI_MU_ENUM "", malloc_size, MU_ENUM_VALUE(HTTP_HEADERS_RESULT, result));
+                    LogError("failed to render the header, result= %" PRI_MU_ENUM "", MU_ENUM_VALUE(HTTP_HEADERS_RESULT, result));
                 }
                 else
                 {
-                    char* runNewValue;
-                    /*Codes_SRS_HTTP_HEADERS_99_017:[ If the name already exists in the collection of headers, the function shall concatenate the new value after the existing value, separated by a comma and a space as in: old-value+", "+new-value.]*/
-                    (void)memcpy(newValue, existingValue, existingValueLen);
-                    runNewValue = newValue + existingValueLen;
-                    (*runNewValue++) = ',';
-                    (*runNewValue++) = ' ';
-                    (void)memcpy(runNewValue, value, valueLen + /*EOL*/ 1);
-
-                    /*Codes_SRS_HTTP_HEADERS_99_016:[ The function shall store the name:value pair in such a way that when later retrieved by a call to GetHeader it will return a string that shall strcmp equal to the name+": "+value.]*/
-                    if (Map_AddOrUpdate(handleData->headers, name, newValue) != MAP_OK)
-                    {
-                        /*Codes_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
-                        result = HTTP_HEADERS_ERROR;
-                        LogError("failed to Map_AddOrUpdate, result= %" PRI_MU_ENUM "", MU_ENUM_VALUE(HTTP_HEADERS_RESULT, result));
-                    }
-                    else
-                    {
-                        /*Codes_SRS_HTTP_HEADERS_99_013:[ The function shall return HTTP_HEADERS_OK when execution is successful.]*/
-                        result = HTTP_HEADERS_OK;
-                    }
-                    free(newValue);
+                    free(existingHeader->line);
+                    existingHeader->line = newLine;
+                    existingHeader->line_length = newLineLength;
+                    /*Codes_SRS_HTTP_HEADERS_99_013:[ The function shall return HTTP_HEADERS_OK when execution is successful.]*/
+                    result = HTTP_HEADERS_OK;
                 }
             }
+            /*Codes_SRS_HTTP_HEADERS_99_016:[ The function shall store the name:value pair in such a way that when later retrieved by a call to GetHeader it will return a string that shall strcmp equal to the name+": "+value.]*/
+            else if ((newLine = render_header(name, nameLen, NULL, 0, value, &newLineLength)) == NULL)
+            {
+                /*Codes_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
+                result = HTTP_HEADERS_ALLOC_FAILED;
+                LogError("failed to render the header, result= %" PRI_MU_ENUM "", MU_ENUM_VALUE(HTTP_HEADERS_RESULT, result));
+            }
+            else if ((handleData->count == handleData->capacity) &&
+                (grow_headers(handleData) != 0))
+            {
+                /*Codes_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
+                result = HTTP_HEADERS_ALLOC_FAILED;
+                LogError("failed to make room for the header, result= %" PRI_MU_ENUM "", MU_ENUM_VALUE(HTTP_HEADERS_RESULT, result));
+                free(newLine);
+            }
             else
             {
-                /*Codes_SRS_HTTP_HEADERS_99_016:[ The function shall store the name:value pair in such a way that when later retrieved by a call to GetHeader it will return a string that shall strcmp equal to the name+": "+value.]*/
-                if (Map_AddOrUpdate(handleData->headers, name, value) != MAP_OK)
-                {
-                    /*Codes_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
-                    result = HTTP_HEADERS_ALLOC_FAILED;
-                    LogError("failed to Map_AddOrUpdate, result= %" PRI_MU_ENUM "", MU_ENUM_VALUE(HTTP_HEADERS_RESULT, result));
-                }
-                else
-                {
-                    result = HTTP_HEADERS_OK;
-                }
+                HTTP_HEADER* newHeader = &handleData->headers[handleData->count];
+                newHeader->line = newLine;
+                newHeader->line_length = newLineLength;
+                newHeader->name_length = nameLen;
+                newHeader->hash = hash;
+                *find_slot(handleData, name, nameLen, hash) = handleData->count + 1;
+                handleData->count++;
+                result = HTTP_HEADERS_OK;
             }
         }
     }
@@ -199,8 +395,12 @@ const char* HTTPHeaders_FindHeaderValue(HTTP_HEADERS_HANDLE httpHeadersHandle, c
         /*Codes_SRS_HTTP_HEADERS_99_018:[ Calling this API shall retrieve the value for a previously stored name.]*/
         /*Codes_SRS_HTTP_HEADERS_99_020:[ The return value shall be different than NULL when the name matches the name of a previously stored name:value pair.] */
         /*Codes_SRS_HTTP_HEADERS_99_021:[ In this case the return value shall point to a string that shall strcmp equal to the original stored string.]*/
+        /*Codes_SRS_HTTP_HEADERS_99_040: [ Header names shall be compared without regard to case. ]*/
         HTTP_HEADERS_HANDLE_DATA* handleData = (HTTP_HEADERS_HANDLE_DATA*)httpHeadersHandle;
-        result = Map_GetValueFromKey(handleData->headers, name);
+        size_t nameLen;
+        uint32_t hash = hash_name(name, &nameLen);
+        HTTP_HEADER* header = find_header(handleData, name, nameLen, hash);
+        result = (header == NULL) ? NULL : header_value(header);
     }
     return result;
 
@@ -220,20 +420,10 @@ HTTP_HEADERS_RESULT HTTPHeaders_GetHeaderCount(HTTP_HEADERS_HANDLE handle, size_
     else
     {
         HTTP_HEADERS_HANDLE_DATA *handleData = (HTTP_HEADERS_HANDLE_DATA *)handle;
-        const char*const* keys;
-        const char*const* values;
         /*Codes_SRS_HTTP_HEADERS_99_023:[ Calling this API shall provide the number of stored headers.]*/
-        if (Map_GetInternals(handleData->headers, &keys, &values, headerCount) != MAP_OK)
-        {
-            /*Codes_SRS_HTTP_HEADERS_99_037:[ The function shall return HTTP_HEADERS_ERROR when an internal error occurs.]*/
-            result = HTTP_HEADERS_ERROR;
-            LogError("Map_GetInternals failed, result= %" PRI_MU_ENUM "", MU_ENUM_VALUE(HTTP_HEADERS_RESULT, result));
-        }
-        else
-        {
-            /*Codes_SRS_HTTP_HEADERS_99_026:[ The function shall write in *headersCount the number of currently stored headers and shall return HTTP_HEADERS_OK]*/
-            result = HTTP_HEADERS_OK;
-        }
+        /*Codes_SRS_HTTP_HEADERS_99_026:[ The function shall write in *headersCount the number of currently stored headers and shall return HTTP_HEADERS_OK]*/
+        *headerCount = handleData->count;
+        result = HTTP_HEADERS_OK;
     }
 
     return result;
@@ -255,62 +445,69 @@ HTTP_HEADERS_RESULT HTTPHeaders_GetHeader(HTTP_HEADERS_HANDLE handle, size_t ind
         LogError("invalid arg (NULL), result= %" PRI_MU_ENUM "", MU_ENUM_VALUE(HTTP_HEADERS_RESULT, result));
     }
     /*Codes_SRS_HTTP_HEADERS_99_029:[ The function shall return HTTP_HEADERS_INVALID_ARG if index is not valid (for example, out of range) for the currently stored headers.]*/
+    else if (index >= ((HTTP_HEADERS_HANDLE_DATA*)handle)->count)
+    {
+        result = HTTP_HEADERS_INVALID_ARG;
+        LogError("index out of bounds, result= %" PRI_MU_ENUM "", MU_ENUM_VALUE(HTTP_HEADERS_RESULT, result));
+    }
     else
     {
-        HTTP_HEADERS_HANDLE_DATA* handleData = (HTTP_HEADERS_HANDLE_DATA*)handle;
-        const char*const* keys;
-        const char*const* values;
-        size_t headerCount;
-        if (Map_GetInternals(handleData->headers, &keys, &values, &headerCount) != MAP_OK)
+        const HTTP_HEADER* header = &((HTTP_HEADERS_HANDLE_DATA*)handle)->headers[index];
+        size_t malloc_size = safe_add_size_t(header->line_length, /*EOL*/ 1);
+        if (malloc_size == SIZE_MAX ||
+            (*destination = (char*)malloc(malloc_size)) == NULL)
         {
             /*Codes_SRS_HTTP_HEADERS_99_034:[ The function shall return HTTP_HEADERS_ERROR when an internal error occurs]*/
             result = HTTP_HEADERS_ERROR;
-            LogError("Map_GetInternals failed, result= %" PRI_MU_ENUM "", MU_ENUM_VALUE(HTTP_HEADERS_RESULT, result));
+            *destination = NULL;
+            LogError("unable to malloc, size=%zu, result= %" PRI_MU_ENUM "", malloc_size, MU_ENUM_VALUE(HTTP_HEADERS_RESULT, result));
         }
         else
         {
-            /*Codes_SRS_HTTP_HEADERS_99_029:[ The function shall return HTTP_HEADERS_INVALID_ARG if index is not valid (for example, out of range) for the currently stored headers.]*/
-            if (index >= headerCount)
-            {
-                result = HTTP_HEADERS_INVALID_ARG;
-                LogError("index out of bounds, result= %" PRI_MU_ENUM "", MU_ENUM_VALUE(HTTP_HEADERS_RESULT, result));
-            }
-            else
-            {
-                size_t keyLen = strlen(keys[index]);
-                size_t valueLen = strlen(values[index]);
-                size_t malloc_size = safe_add_size_t(keyLen, /*COLON_AND_SPACE_LENGTH*/ 2);
-                malloc_size = safe_add_size_t(malloc_size, valueLen);
-                malloc_size = safe_add_size_t(malloc_size, /*EOL*/ 1);
-                malloc_size = safe_multiply_size_t(malloc_size, sizeof(char));
-                if (malloc_size == SIZE_MAX ||
-                    (*destination = (char*)malloc(malloc_size)) == NULL)
-                {
-                    /*Codes_SRS_HTTP_HEADERS_99_034:[ The function shall return HTTP_HEADERS_ERROR when an internal error occurs]*/
-                    result = HTTP_HEADERS_ERROR;
-                    *destination = NULL;
-                    LogError("unable to malloc, size=%zu, result= %" PRI_MU_ENUM "", malloc_size, MU_ENUM_VALUE(HTTP_HEADERS_RESULT, result));
-                }
-                else
-                {
-                    /*Codes_SRS_HTTP_HEADERS_99_016:[ The function shall store the name:value pair in such a way that when later retrieved by a call to GetHeader it will return a string that shall strcmp equal to the name+": "+value.]*/
-                    /*Codes_SRS_HTTP_HEADERS_99_027:[ Calling this API shall produce the string value+": "+pair) for the index header in the *destination parameter.]*/
-                    char* runDestination = (*destination);
-                    (void)memcpy(runDestination, keys[index], keyLen);
-                    runDestination += keyLen;
-                    (*runDestination++) = ':';
-                    (*runDestination++) = ' ';
-                    (void)memcpy(runDestination, values[index], valueLen + /*EOL*/ 1);
-                    /*Codes_SRS_HTTP_HEADERS_99_035:[ The function shall return HTTP_HEADERS_OK when the function executed without error.]*/
-                    result = HTTP_HEADERS_OK;
-                }
-            }
+            /*Codes_SRS_HTTP_HEADERS_99_016:[ The function shall store the name:value pair in such a way that when later retrieved by a call to GetHeader it will return a string that shall strcmp equal to the name+": "+value.]*/
+            /*Codes_SRS_HTTP_HEADERS_99_027:[ Calling this API shall produce the string value+": "+pair) for the index header in the *destination parameter.]*/
+            (void)memcpy(*destination, header->line, malloc_size);
+            /*Codes_SRS_HTTP_HEADERS_99_035:[ The function shall return HTTP_HEADERS_OK when the function executed without error.]*/
+            result = HTTP_HEADERS_OK;
         }
     }
 
     return result;
 }
 
+HTTP_HEADERS_RESULT HTTPHeaders_GetHeaderView(HTTP_HEADERS_HANDLE handle, size_t index, HTTP_HEADER_VIEW* header)
+{
+    HTTP_HEADERS_RESULT result;
+
+    /*Codes_SRS_HTTP_HEADERS_99_042: [ If handle or header is NULL, HTTPHeaders_GetHeaderView shall return HTTP_HEADERS_INVALID_ARG. ]*/
+    if (
+        (handle == NULL) ||
+        (header == NULL)
+        )
+    {
+        result = HTTP_HEADERS_INVALID_ARG;
+        LogError("invalid arg (NULL), result= %" PRI_MU_ENUM "", MU_ENUM_VALUE(HTTP_HEADERS_RESULT, result));
+    }
+    /*Codes_SRS_HTTP_HEADERS_99_043: [ If index is not lower than the number of headers, HTTPHeaders_GetHeaderView shall return HTTP_HEADERS_INVALID_ARG. ]*/
+    else if (index >= ((HTTP_HEADERS_HANDLE_DATA*)handle)->count)
+    {
+        result = HTTP_HEADERS_INVALID_ARG;
+        LogError("index out of bounds, result= %" PRI_MU_ENUM "", MU_ENUM_VALUE(HTTP_HEADERS_RESULT, result));
+    }
+    else
+    {
+        /*Codes_SRS_HTTP_HEADERS_99_044: [ Otherwise HTTPHeaders_GetHeaderView shall fill header with pointers to the name, the value and the name+": "+value string of the header at index, without allocating, and return HTTP_HEADERS_OK. ]*/
+        const HTTP_HEADER* stored = &((HTTP_HEADERS_HANDLE_DATA*)handle)->headers[index];
+        header->name = header_name(stored);
+        header->value = header_value(stored);
+        header->line = stored->line;
+        header->line_length = stored->line_length;
+        result = HTTP_HEADERS_OK;
+    }
+
+    return result;
+}
+
 HTTP_HEADERS_HANDLE HTTPHeaders_Clone(HTTP_HEADERS_HANDLE handle)
 {
     HTTP_HEADERS_HANDLE_DATA* result;
@@ -319,27 +516,55 @@ HTTP_HEADERS_HANDLE HTTPHeaders_Clone(HTTP_HEADERS_HANDLE handle)
     {
         result = NULL;
     }
+    /*Codes_SRS_HTTP_HEADERS_02_004: [Otherwise HTTPHeaders_Clone shall clone the content of handle to a new handle.] */
+    else if ((result = (HTTP_HEADERS_HANDLE_DATA*)HTTPHeaders_Alloc()) == NULL)
+    {
+        /*Codes_SRS_HTTP_HEADERS_02_005: [If cloning fails for any reason, then HTTPHeaders_Clone shall return NULL.] */
+        LogError("HTTPHeaders_Alloc failed");
+    }
     else
     {
-        /*Codes_SRS_HTTP_HEADERS_02_004: [Otherwise HTTPHeaders_Clone shall clone the content of handle to a new handle.] */
-        result = (HTTP_HEADERS_HANDLE_DATA*)malloc(sizeof(HTTP_HEADERS_HANDLE_DATA));
-        if (result == NULL)
-        {
-            /*Codes_SRS_HTTP_HEADERS_02_005: [If cloning fails for any reason, then HTTPHeaders_Clone shall return NULL.] */
-        }
-        else
+        HTTP_HEADERS_HANDLE_DATA* handleData = handle;
+
+        if (handleData->count > 0)
         {
-            HTTP_HEADERS_HANDLE_DATA* handleData = handle;
-            result->headers = Map_Clone(handleData->headers);
-            if (result->headers == NULL)
+            size_t headers_size = handleData->capacity * sizeof(HTTP_HEADER);
+            size_t slots_size = handleData->capacity * 2 * sizeof(size_t);
+
+            if (((result->headers = (HTTP_HEADER*)malloc(headers_size)) == NULL) ||
+                ((result->slots = (size_t*)malloc(slots_size)) == NULL))
             {
                 /*Codes_SRS_HTTP_HEADERS_02_005: [If cloning fails for any reason, then HTTPHeaders_Clone shall return NULL.] */
-                free(result);
+                LogError("failed to malloc the headers");
+                HTTPHeaders_Free(result);
                 result = NULL;
             }
             else
             {
-                /*all is fine*/
+                /*the index of the clone is the same as the index of the original*/
+                (void)memcpy(result->slots, handleData->slots, slots_size);
+                result->capacity = handleData->capacity;
+                for (result->count = 0; result->count < handleData->count; result->count++)
+                {
+                    const HTTP_HEADER* header = &handleData->headers[result->count];
+                    size_t malloc_size = header->line_length + 1 + header->name_length + 1;
+                    if ((result->headers[result->count].line = (char*)malloc(malloc_size)) == NULL)
+                    {
+                        break;
+                    }
+                    (void)memcpy(result->headers[result->count].line, header->line, malloc_size);
+                    result->headers[result->count].line_length = header->line_length;
+                    result->headers[result->count].name_length = header->name_length;
+                    result->headers[result->count].hash = header->hash;
+                }
+
+                if (result->count < handleData->count)
+                {
+                    /*Codes_SRS_HTTP_HEADERS_02_005: [If cloning fails for any reason, then HTTPHeaders_Clone shall return NULL.] */
+                    LogError("failed to malloc a header");
+                    HTTPHeaders_Free(result);
+                    result = NULL;
+                }
             }
         }
     }
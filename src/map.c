@@ -12,12 +12,22 @@
 
 MU_DEFINE_ENUM_STRINGS(MAP_RESULT, MAP_RESULT_VALUES);
 
+/*maps with at most this many keys are searched linearly, bigger maps get a hash index*/
+#ifndef MAP_HASH_INDEX_MIN_COUNT
+#define MAP_HASH_INDEX_MIN_COUNT 8
+#endif
+
 typedef struct MAP_HANDLE_DATA_TAG
 {
     char** keys;
     char** values;
     size_t count;
+    size_t capacity; /*number of slots allocated in keys and values*/
     MAP_FILTER_CALLBACK mapFilterCallback;
+    /*hash index, only present when the map has more than MAP_HASH_INDEX_MIN_COUNT keys. keys/values stay the storage (and what Map_GetInternals returns)*/
+    size_t* hashes; /*hash of keys[i], "capacity" slots*/
+    size_t* index; /*open addressing table of index_size (a power of 2) slots, each is 0 when empty or 1 + the position of the key in keys*/
+    size_t index_size;
 }MAP_HANDLE_DATA;
 
 #define LOG_MAP_ERROR LogError("result = %" PRI_MU_ENUM "", MU_ENUM_VALUE(MAP_RESULT, result));
@@ -33,11 +43,100 @@ MAP_HANDLE Map_Create(MAP_FILTER_CALLBACK mapFilterFunc)
         result->keys = NULL;
         result->values = NULL;
         result->count = 0;
+        result->capacity = 0;
         result->mapFilterCallback = mapFilterFunc;
+        result->hashes = NULL;
+        result->index = NULL;
+        result->index_size = 0;
     }
     return (MAP_HANDLE)result;
 }
 
+/*FNV-1a*/
+static size_t Map_HashKey(const char* key)
+{
+    size_t result = (size_t)2166136261u;
+    while (*key != '\0')
+    {
+        result ^= (unsigned char)*key;
+        result *= (size_t)16777619u;
+        key++;
+    }
+    return result;
+}
+
+static void Map_DestroyIndex(MAP_HANDLE_DATA* handleData)
+{
+    if (handleData->index != NULL)
+    {
+        free(handleData->index);
+        handleData->index = NULL;
+        handleData->index_size = 0;
+    }
+    if (handleData->hashes != NULL)
+    {
+        free(handleData->hashes);
+        handleData->hashes = NULL;
+    }
+}
+
+static void Map_IndexInsert(MAP_HANDLE_DATA* handleData, size_t position)
+{
+    size_t mask = handleData->index_size - 1;
+    size_t slot = handleData->hashes[position] & mask;
+    while (handleData->index[slot] != 0)
+    {
+        slot = (slot + 1) & mask;
+    }
+    handleData->index[slot] = position + 1;
+}
+
+/*(re)creates the index so that it is at most half full. When anything fails the map is left without an index and falls back to linear search*/
+static void Map_RebuildIndex(MAP_HANDLE_DATA* handleData)
+{
+    if (handleData->count <= MAP_HASH_INDEX_MIN_COUNT)
+    {
+        Map_DestroyIndex(handleData);
+    }
+    else
+    {
+        size_t new_index_size = (handleData->index_size == 0) ? (2 * MAP_HASH_INDEX_MIN_COUNT) : handleData->index_size;
+        size_t* new_index;
+        while ((new_index_size / 2 < handleData->count) && (new_index_size < SIZE_MAX / (2 * sizeof(size_t))))
+        {
+            new_index_size *= 2;
+        }
+
+        if ((handleData->hashes == NULL) &&
+            ((handleData->hashes = (size_t*)malloc(safe_multiply_size_t(handleData->capacity, sizeof(size_t)))) == NULL))
+        {
+            LogError("unable to allocate hashes, map continues without index, count=%zu", handleData->count);
+            Map_DestroyIndex(handleData);
+        }
+        else if ((new_index_size != handleData->index_size) &&
+            ((new_index = (size_t*)realloc(handleData->index, new_index_size * sizeof(size_t))) == NULL))
+        {
+            LogError("unable to allocate index, map continues without index, index_size=%zu", new_index_size);
+            Map_DestroyIndex(handleData);
+        }
+        else
+        {
+            size_t i;
+            if (new_index_size != handleData->index_size)
+            {
+                handleData->index = new_index;
+                handleData->index_size = new_index_size;
+            }
+            (void)memset(handleData->index, 0, handleData->index_size * sizeof(size_t));
+            for (i = 0; i < handleData->count; i++)
+            {
+                handleData->hashes[i] = Map_HashKey(handleData->keys[i]);
+                Map_IndexInsert(handleData, i);
+            }
+        }
+    }
+}
+
 void Map_Destroy(MAP_HANDLE handle)
 {
     /*Codes_SRS_MAP_02_005: [If parameter handle is NULL then Map_Destroy shall take no action.] */
@@ -54,6 +153,7 @@ void Map_Destroy(MAP_HANDLE handle)
         }
         free(handleData->keys);
         free(handleData->values);
+        Map_DestroyIndex(handleData);
         free(handleData);
     }
 }
@@ -130,6 +230,7 @@ MAP_HANDLE Map_Clone(MAP_HANDLE handle)
             {
                 result->mapFilterCallback = handleData->mapFilterCallback;
                 result->count = handleData->count;
+                result->capacity = handleData->count;
                 if( (result->keys = Map_CloneVector((const char* const*)handleData->keys, handleData->count))==NULL)
                 {
                     /*Codes_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
@@ -153,6 +254,7 @@ MAP_HANDLE Map_Clone(MAP_HANDLE handle)
                 else
                 {
                     /*all fine, return it*/
+                    Map_RebuildIndex(result);
                 }
             }
         }
@@ -160,58 +262,65 @@ MAP_HANDLE Map_Clone(MAP_HANDLE handle)
     return (MAP_HANDLE)result;
 }
 
+/*makes room for one more key/value pair. The storage is grown geometrically and is not shrunk until the map is empty*/
 static int Map_IncreaseStorageKeysValues(MAP_HANDLE_DATA* handleData)
 {
     int result;
-    char** newKeys;
-    size_t realloc_size = safe_add_size_t(handleData->count, 1);
-    realloc_size = safe_multiply_size_t(realloc_size, sizeof(char*));
-    if (realloc_size == SIZE_MAX ||
-        (newKeys = (char**)realloc(handleData->keys, realloc_size)) == NULL)
+    if (handleData->count < handleData->capacity)
     {
-        LogError("realloc error, size:%zu", realloc_size);
-        result = MU_FAILURE;
+        result = 0;
     }
     else
     {
-        char** newValues;
-        handleData->keys = newKeys;
-        handleData->keys[handleData->count] = NULL;
-        realloc_size = safe_add_size_t(handleData->count, 1);
-        realloc_size = safe_multiply_size_t(realloc_size, sizeof(char*));
+        char** newKeys;
+        /*Codes_SRS_MAP_07_010: [When there is no free slot for the new pair, Map_Add and Map_AddOrUpdate shall double the storage for keys and values.] */
+        size_t new_capacity = (handleData->capacity == 0) ? 1 : safe_multiply_size_t(handleData->capacity, 2);
+        size_t realloc_size = safe_multiply_size_t(new_capacity, sizeof(char*));
         if (realloc_size == SIZE_MAX ||
-            (newValues = (char**)realloc(handleData->values, realloc_size)) == NULL)
+            (newKeys = (char**)realloc(handleData->keys, realloc_size)) == NULL)
         {
             LogError("realloc error, size:%zu", realloc_size);
-            if (handleData->count == 0) /*avoiding an implementation defined behavior */
+            result = MU_FAILURE;
+        }
+        else
+        {
+            char** newValues;
+            /*keys might now be bigger than capacity, that is harmless: the next growth reallocates it again*/
+            handleData->keys = newKeys;
+            if ((newValues = (char**)realloc(handleData->values, realloc_size)) == NULL)
             {
-                free(handleData->keys);
-                handleData->keys = NULL;
+                LogError("realloc error, size:%zu", realloc_size);
+                result = MU_FAILURE;
             }
             else
             {
-                char** undoneKeys;
-                realloc_size = safe_multiply_size_t((handleData->count), sizeof(char*));
-                if (realloc_size == SIZE_MAX ||
-                    (undoneKeys = (char**)realloc(handleData->keys, realloc_size)) == NULL)
+                handleData->values = newValues;
+                handleData->capacity = new_capacity;
+                if (handleData->hashes != NULL)
                 {
-                    LogError("CATASTROPHIC error, unable to undo through realloc to a smaller size, size:%zu", realloc_size);
-                }
-                else
-                {
-                    handleData->keys = undoneKeys;
+                    size_t* newHashes = (size_t*)realloc(handleData->hashes, safe_multiply_size_t(new_capacity, sizeof(size_t)));
+                    if (newHashes == NULL)
+                    {
+                        /*Codes_SRS_MAP_07_012: [If memory for the hash index cannot be allocated, Map_Add and Map_AddOrUpdate shall drop the index, continue with linear search and not fail.] */
+                        LogError("unable to grow hashes, map continues without index, capacity=%zu", new_capacity);
+                        Map_DestroyIndex(handleData);
+                    }
+                    else
+                    {
+                        handleData->hashes = newHashes;
+                    }
                 }
+                result = 0;
             }
-            result = MU_FAILURE;
-        }
-        else
-        {
-            handleData->values = newValues;
-            handleData->values[handleData->count] = NULL;
-            handleData->count++;
-            result = 0;
         }
     }
+
+    if (result == 0)
+    {
+        handleData->keys[handleData->count] = NULL;
+        handleData->values[handleData->count] = NULL;
+        handleData->count++;
+    }
     return result;
 }
 
@@ -224,36 +333,14 @@ static void Map_DecreaseStorageKeysValues(MAP_HANDLE_DATA* handleData)
         free(handleData->values);
         handleData->values = NULL;
         handleData->count = 0;
+        handleData->capacity = 0;
         handleData->mapFilterCallback = NULL;
+        Map_DestroyIndex(handleData);
     }
     else
     {
         /*certainly > 1...*/
-        char** undoneValues;
-        char** undoneKeys;
-        size_t realloc_size = safe_subtract_size_t(handleData->count, 1);
-        realloc_size = safe_multiply_size_t(realloc_size, sizeof(char*));
-
-        if (realloc_size == SIZE_MAX ||
-            (undoneKeys = (char**)realloc(handleData->keys, realloc_size)) == NULL)
-        {
-            LogError("CATASTROPHIC error, unable to undo through realloc to a smaller size, size:%zu", realloc_size);
-        }
-        else
-        {
-            handleData->keys = undoneKeys;
-        }
-
-        if (realloc_size == SIZE_MAX || 
-            (undoneValues = (char**)realloc(handleData->values, realloc_size)) == NULL)
-        {
-            LogError("CATASTROPHIC error, unable to undo through realloc to a smaller size, size:%zu", realloc_size);
-        }
-        else
-        {
-            handleData->values = undoneValues;
-        }
-
+        /*Codes_SRS_MAP_07_013: [Map_Delete shall not shrink the storage for keys and values, unless the map becomes empty, in which case the storage and the hash index shall be freed.] */
         handleData->count--;
     }
 }
@@ -265,6 +352,23 @@ static char** findKey(MAP_HANDLE_DATA* handleData, const char* key)
     {
         result = NULL;
     }
+    else if (handleData->index != NULL)
+    {
+        size_t hash = Map_HashKey(key);
+        size_t mask = handleData->index_size - 1;
+        size_t slot = hash & mask;
+        result = NULL;
+        while (handleData->index[slot] != 0)
+        {
+            size_t position = handleData->index[slot] - 1;
+            if ((handleData->hashes[position] == hash) && (strcmp(handleData->keys[position], key) == 0))
+            {
+                result = handleData->keys + position;
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
     else
     {
         size_t i;
@@ -330,6 +434,24 @@ static int insertNewKeyValue(MAP_HANDLE_DATA* handleData, const char* key, const
             }
             else
             {
+                /*Codes_SRS_MAP_07_011: [When the map has more than MAP_HASH_INDEX_MIN_COUNT keys, Map_Add and Map_AddOrUpdate shall add the new key and its hash to the hash index, rebuilding the index so that it is at most half full.] */
+                size_t position = handleData->count - 1;
+                if (handleData->index == NULL)
+                {
+                    if (handleData->count > MAP_HASH_INDEX_MIN_COUNT)
+                    {
+                        Map_RebuildIndex(handleData);
+                    }
+                }
+                else if (handleData->count > handleData->index_size / 2)
+                {
+                    Map_RebuildIndex(handleData);
+                }
+                else
+                {
+                    handleData->hashes[position] = Map_HashKey(key);
+                    Map_IndexInsert(handleData, position);
+                }
                 result = 0;
             }
         }
@@ -486,6 +608,12 @@ MAP_RESULT Map_Delete(MAP_HANDLE handle, const char* key)
             memmove(handleData->keys + index, handleData->keys + index + 1, (handleData->count - index - 1)*sizeof(char*)); /*if order doesn't matter... then this can be optimized*/
             memmove(handleData->values + index, handleData->values + index + 1, (handleData->count - index - 1)*sizeof(char*));
             Map_DecreaseStorageKeysValues(handleData);
+            if (handleData->index != NULL)
+            {
+                /*Codes_SRS_MAP_07_014: [If the map has a hash index, Map_Delete shall rebuild it.] */
+                /*positions have shifted, deleting is O(n) anyway because of the memmove above*/
+                Map_RebuildIndex(handleData);
+            }
             result = MAP_OK;
         }
 
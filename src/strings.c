@@ -14,31 +14,128 @@
 
 static const char hexToASCII[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
 
+/*strings needing at most this many bytes (including the '\0') are stored in the same allocation as the STRING itself and can grow up to that size without reallocating*/
+#ifndef STRINGS_C_SMALL_STRING_SIZE
+#define STRINGS_C_SMALL_STRING_SIZE 32
+#endif
+
 typedef struct STRING_TAG
 {
     char* s;
+    size_t capacity; /*number of bytes available at s, including the one needed by the '\0'*/
+    size_t inline_size; /*number of bytes available in inline_buffer, 0 when the STRING was created with STRING_new_with_memory*/
+#ifdef _MSC_VER
+    /*warning C4200: nonstandard extension used: zero-sized array in struct/union : looks very standard in C99 and it is called flexible array. Documentation-wise is a flexible array, but called "unsized" in Microsoft's docs*/ /*https://msdn.microsoft.com/library/b6fae073.aspx*/
+#pragma warning(disable:4200)
+#endif
+    char inline_buffer[];
 } STRING;
 
-/*this function will allocate a new string with just '\0' in it*/
-/*return NULL if it fails*/
-/* Codes_SRS_STRING_07_001: [STRING_new shall allocate a new STRING_HANDLE pointing to an empty string.] */
-STRING_HANDLE STRING_new(void)
+static int string_is_inline(const STRING* str)
+{
+    return (str->inline_size > 0) && (str->s == str->inline_buffer);
+}
+
+/*allocates the STRING and room for at least size bytes of content in one single allocation. The content is set to the empty string.*/
+static STRING* string_alloc(size_t size)
 {
     STRING* result;
-    if ((result = (STRING*)malloc(sizeof(STRING))) != NULL)
+    size_t inline_size = (size < STRINGS_C_SMALL_STRING_SIZE) ? STRINGS_C_SMALL_STRING_SIZE : size;
+    size_t malloc_size = safe_add_size_t(sizeof(STRING), inline_size);
+
+    if (size == SIZE_MAX || malloc_size == SIZE_MAX)
     {
-        if ((result->s = (char*)malloc(1)) != NULL)
+        LogError("invalid size for STRING, size=%zu", size);
+        result = NULL;
+    }
+    else if ((result = (STRING*)malloc(malloc_size)) == NULL)
+    {
+        LogError("Failure allocating STRING, size=%zu", malloc_size);
+    }
+    else
+    {
+        result->inline_size = inline_size;
+        result->capacity = inline_size;
+        result->s = result->inline_buffer;
+        result->s[0] = '\0';
+    }
+    return result;
+}
+
+/*makes sure str->s can hold size bytes, allocating exactly size bytes when the current capacity is not enough. The content is preserved.*/
+/*as long as the content fits in the inline buffer no allocation is performed. Once the content has moved to the heap it stays there.*/
+static int string_reserve(STRING* str, size_t size)
+{
+    int result;
+    char* temp;
+    if (size <= str->capacity)
+    {
+        result = 0;
+    }
+    else if (size == SIZE_MAX)
+    {
+        LogError("invalid size for STRING content, size=%zu", size);
+        result = MU_FAILURE;
+    }
+    else if (string_is_inline(str))
+    {
+        if ((temp = (char*)malloc(size)) == NULL)
         {
-            result->s[0] = '\0';
+            LogError("Failure allocating value. size=%zu", size);
+            result = MU_FAILURE;
         }
         else
         {
-            /* Codes_SRS_STRING_07_002: [STRING_new shall return an NULL STRING_HANDLE on any error that is encountered.] */
-            LogError("Failure allocating in STRING_new.");
-            free(result);
-            result = NULL;
+            (void)memcpy(temp, str->s, strlen(str->s) + 1);
+            str->s = temp;
+            str->capacity = size;
+            result = 0;
         }
     }
+    else if ((temp = (char*)realloc(str->s, size)) == NULL)
+    {
+        LogError("Failure reallocating value. size=%zu", size);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        str->s = temp;
+        str->capacity = size;
+        result = 0;
+    }
+    return result;
+}
+
+/*same as string_reserve, but when growing is needed the capacity is at least doubled so that appending in a loop only reallocates O(log n) times*/
+static int string_grow(STRING* str, size_t size)
+{
+    size_t new_capacity;
+    if (size <= str->capacity)
+    {
+        new_capacity = size;
+    }
+    else
+    {
+        new_capacity = (str->capacity > SIZE_MAX / 2) ? SIZE_MAX - 1 : str->capacity * 2;
+        if (new_capacity < size)
+        {
+            new_capacity = size;
+        }
+    }
+    return string_reserve(str, new_capacity);
+}
+
+/*this function will allocate a new string with just '\0' in it*/
+/*return NULL if it fails*/
+/* Codes_SRS_STRING_07_001: [STRING_new shall allocate a new STRING_HANDLE pointing to an empty string.] */
+STRING_HANDLE STRING_new(void)
+{
+    STRING* result;
+    if ((result = string_alloc(1)) == NULL)
+    {
+        /* Codes_SRS_STRING_07_002: [STRING_new shall return an NULL STRING_HANDLE on any error that is encountered.] */
+        LogError("Failure allocating in STRING_new.");
+    }
     return (STRING_HANDLE)result;
 }
 
@@ -53,28 +150,17 @@ STRING_HANDLE STRING_clone(STRING_HANDLE handle)
     }
     else
     {
+        STRING* source = (STRING*)handle;
+        size_t sourceLen = safe_add_size_t(strlen(source->s), 1);
+
         /*Codes_SRS_STRING_02_003: [If STRING_clone fails for any reason, it shall return NULL.] */
-        if ((result = (STRING*)malloc(sizeof(STRING))) != NULL)
+        if ((result = string_alloc(sourceLen)) == NULL)
         {
-            STRING* source = (STRING*)handle;
-            /*Codes_SRS_STRING_02_003: [If STRING_clone fails for any reason, it shall return NULL.] */
-            size_t sourceLen = safe_add_size_t(strlen(source->s), 1);
-
-            if (sourceLen == SIZE_MAX ||
-                (result->s = (char*)malloc(sourceLen)) == NULL)
-            {
-                LogError("Failure allocating clone value. size=%zu", sourceLen);
-                free(result);
-                result = NULL;
-            }
-            else
-            {
-                (void)memcpy(result->s, source->s, sourceLen);
-            }
+            LogError("Failure allocating clone value. size=%zu", sourceLen);
         }
         else
         {
-            /*not much to do, result is NULL from malloc*/
+            (void)memcpy(result->s, source->s, sourceLen);
         }
     }
     return (STRING_HANDLE)result;
@@ -92,26 +178,16 @@ STRING_HANDLE STRING_construct(const char* psz)
     else
     {
         STRING* str;
-        if ((str = (STRING*)malloc(sizeof(STRING))) != NULL)
+        size_t nLen = safe_add_size_t(strlen(psz), 1);
+        if ((str = string_alloc(nLen)) != NULL)
         {
-            size_t nLen = safe_add_size_t(strlen(psz), 1);
-            if (nLen != SIZE_MAX && (str->s = (char*)malloc(nLen)) != NULL)
-            {
-                (void)memcpy(str->s, psz, nLen);
-                result = (STRING_HANDLE)str;
-            }
-            /* Codes_SRS_STRING_07_032: [STRING_construct encounters any error it shall return a NULL value.] */
-            else
-            {
-                LogError("Failure allocating constructed value. size=%zu", nLen);
-                free(str);
-                result = NULL;
-            }
+            (void)memcpy(str->s, psz, nLen);
+            result = (STRING_HANDLE)str;
         }
         else
         {
             /* Codes_SRS_STRING_07_032: [STRING_construct encounters any error it shall return a NULL value.] */
-            LogError("Failure allocating value.");
+            LogError("Failure allocating constructed value. size=%zu", nLen);
             result = NULL;
         }
     }
@@ -144,34 +220,24 @@ STRING_HANDLE STRING_construct_sprintf(const char* format, ...)
         va_end(arg_list);
         if (length > 0)
         {
-            result = (STRING*)malloc(sizeof(STRING));
+            size_t malloc_size = safe_add_size_t((size_t)length, 1);
+            result = string_alloc(malloc_size);
             if (result != NULL)
             {
-                size_t malloc_size = safe_add_size_t((size_t)length, 1);
-                if (malloc_size != SIZE_MAX && (result->s = (char*)malloc(malloc_size)) != NULL)
-                {
-                    va_start(arg_list, format);
-                    if (vsnprintf(result->s, malloc_size, format, arg_list) < 0)
-                    {
-                        /* Codes_SRS_STRING_07_040: [If any error is encountered STRING_construct_sprintf shall return NULL.] */
-                        free(result->s);
-                        free(result);
-                        result = NULL;
-                        LogError("Failure: vsnprintf formatting failed.");
-                    }
-                    va_end(arg_list);
-                }
-                else
+                va_start(arg_list, format);
+                if (vsnprintf(result->s, malloc_size, format, arg_list) < 0)
                 {
                     /* Codes_SRS_STRING_07_040: [If any error is encountered STRING_construct_sprintf shall return NULL.] */
                     free(result);
                     result = NULL;
-                    LogError("Failure: allocation sprintf value failed. size=%zu", malloc_size);
+                    LogError("Failure: vsnprintf formatting failed.");
                 }
+                va_end(arg_list);
             }
             else
             {
-                LogError("Failure: allocation failed.");
+                /* Codes_SRS_STRING_07_040: [If any error is encountered STRING_construct_sprintf shall return NULL.] */
+                LogError("Failure: allocation sprintf value failed. size=%zu", malloc_size);
             }
         }
         else if (length == 0)
@@ -210,6 +276,9 @@ STRING_HANDLE STRING_new_with_memory(const char* memory)
     {
         if ((result = (STRING*)malloc(sizeof(STRING))) != NULL)
         {
+            /*the supplied memory is adopted as is, there is no inline buffer*/
+            result->inline_size = 0;
+            result->capacity = strlen(memory) + 1;
             result->s = (char*)memory;
         }
         else
@@ -229,11 +298,11 @@ STRING_HANDLE STRING_new_quoted(const char* source)
         /* Codes_SRS_STRING_07_009: [STRING_new_quoted shall return a NULL STRING_HANDLE if the supplied const char* is NULL.] */
         result = NULL;
     }
-    else if ((result = (STRING*)malloc(sizeof(STRING))) != NULL)
+    else
     {
         size_t sourceLength = strlen(source);
         size_t malloc_size = safe_add_size_t(sourceLength, 3);
-        if (malloc_size != SIZE_MAX && (result->s = (char*)malloc(malloc_size)) != NULL)
+        if ((result = string_alloc(malloc_size)) != NULL)
         {
             result->s[0] = '"';
             (void)memcpy(result->s + 1, source, sourceLength);
@@ -244,8 +313,6 @@ STRING_HANDLE STRING_new_quoted(const char* source)
         {
             /* Codes_SRS_STRING_07_031: [STRING_new_quoted shall return a NULL STRING_HANDLE if any error is encountered.] */
             LogError("Failure allocating quoted string value. size=%zu", malloc_size);
-            free(result);
-            result = NULL;
         }
     }
     return (STRING_HANDLE)result;
@@ -312,18 +379,11 @@ STRING_HANDLE STRING_new_JSON(const char* source)
                 result = NULL;
                 LogError("malloc len overflow");
             }
-            else if ((result = (STRING*)malloc(sizeof(STRING))) == NULL)
+            else if ((result = string_alloc(malloc_len)) == NULL)
             {
                 /*Codes_SRS_STRING_02_021: [If the complete JSON representation cannot be produced, then STRING_new_JSON shall fail and return NULL.] */
                 LogError("malloc json failure");
             }
-            else if ((result->s = (char*)malloc(malloc_len)) == NULL)
-            {
-                /*Codes_SRS_STRING_02_021: [If the complete JSON representation cannot be produced, then STRING_new_JSON shall fail and return NULL.] */
-                free(result);
-                result = NULL;
-                LogError("malloc failed");
-            }
             else
             {
                 size_t pos = 0;
@@ -366,7 +426,6 @@ STRING_HANDLE STRING_new_JSON(const char* source)
                     }
                     else
                     {
-                        free(result->s);
                         free(result);
                         result = NULL;
                         break;
@@ -382,7 +441,6 @@ STRING_HANDLE STRING_new_JSON(const char* source)
                 }
                 else
                 {
-                    free(result->s);
                     free(result);
                     result = NULL;
                 }
@@ -411,9 +469,7 @@ int STRING_concat(STRING_HANDLE handle, const char* s2)
         size_t s1Length = strlen(s1->s);
         size_t s2Length = strlen(s2);
         size_t realloc_size = safe_add_size_t(safe_add_size_t(s1Length, s2Length), 1);
-        char* temp;
-        if (realloc_size == SIZE_MAX ||
-            (temp = (char*)realloc(s1->s, realloc_size)) == NULL)
+        if (string_grow(s1, realloc_size) != 0)
         {
             /* Codes_SRS_STRING_07_013: [STRING_concat shall return a nonzero number if an error is encountered.] */
             LogError("Failure reallocating value. size=%zu", realloc_size);
@@ -421,7 +477,6 @@ int STRING_concat(STRING_HANDLE handle, const char* s2)
         }
         else
         {
-            s1->s = temp;
             (void)memcpy(s1->s + s1Length, s2, s2Length + 1);
             result = 0;
         }
@@ -450,9 +505,7 @@ int STRING_concat_with_STRING(STRING_HANDLE s1, STRING_HANDLE s2)
         size_t s1Length = strlen(dest->s);
         size_t s2Length = strlen(src->s);
         size_t realloc_size = safe_add_size_t(safe_add_size_t(s1Length, s2Length), 1);
-        char* temp;
-        if (realloc_size == SIZE_MAX ||
-            (temp = (char*)realloc(dest->s, realloc_size)) == NULL)
+        if (string_grow(dest, realloc_size) != 0)
         {
             /* Codes_SRS_STRING_07_035: [String_Concat_with_STRING shall return a nonzero number if an error is encountered.] */
             LogError("Failure reallocating value, size:%zu", realloc_size);
@@ -460,7 +513,6 @@ int STRING_concat_with_STRING(STRING_HANDLE s1, STRING_HANDLE s2)
         }
         else
         {
-            dest->s = temp;
             /* Codes_SRS_STRING_07_034: [String_Concat_with_STRING shall concatenate a given STRING_HANDLE variable with a source STRING_HANDLE.] */
             (void)memcpy(dest->s + s1Length, src->s, s2Length + 1);
             result = 0;
@@ -489,9 +541,7 @@ int STRING_copy(STRING_HANDLE handle, const char* s2)
         {
             size_t s2Length = strlen(s2);
             size_t realloc_size = safe_add_size_t(s2Length, 1);
-            char* temp;
-            if (realloc_size == SIZE_MAX ||
-                (temp = (char*)realloc(s1->s, realloc_size)) == NULL)
+            if (string_reserve(s1, realloc_size) != 0)
             {
                 LogError("Failure reallocating value. size=%zu", realloc_size);
                 /* Codes_SRS_STRING_07_027: [STRING_copy shall return a nonzero value if any error is encountered.] */
@@ -499,7 +549,6 @@ int STRING_copy(STRING_HANDLE handle, const char* s2)
             }
             else
             {
-                s1->s = temp;
                 memmove(s1->s, s2, s2Length + 1);
                 result = 0;
             }
@@ -529,15 +578,13 @@ int STRING_copy_n(STRING_HANDLE handle, const char* s2, size_t n)
     {
         STRING* s1 = (STRING*)handle;
         size_t s2Length = strlen(s2);
-        char* temp;
         if (s2Length > n)
         {
             s2Length = n;
         }
 
         size_t realloc_size = safe_add_size_t(s2Length, 1);
-        if (realloc_size == SIZE_MAX ||
-            (temp = (char*)realloc(s1->s, realloc_size)) == NULL)
+        if (string_reserve(s1, realloc_size) != 0)
         {
             LogError("Failure reallocating value. size=%zu", realloc_size);
             /* Codes_SRS_STRING_07_028: [STRING_copy_n shall return a nonzero value if any error is encountered.] */
@@ -545,7 +592,6 @@ int STRING_copy_n(STRING_HANDLE handle, const char* s2, size_t n)
         }
         else
         {
-            s1->s = temp;
             (void)memcpy(s1->s, s2, s2Length);
             s1->s[s2Length] = 0;
             result = 0;
@@ -598,13 +644,10 @@ int STRING_sprintf(STRING_HANDLE handle, const char* format, ...)
         else
         {
             STRING* s1 = (STRING*)handle;
-            char* temp;
             size_t s1Length = strlen(s1->s);
             size_t realloc_size = safe_add_size_t(safe_add_size_t(s1Length, s2Length), 1);
-            if (realloc_size != SIZE_MAX &&
-                (temp = (char*)realloc(s1->s, realloc_size)) != NULL)
+            if (string_grow(s1, realloc_size) == 0)
             {
-                s1->s = temp;
                 va_start(arg_list, format);
                 if (vsnprintf(s1->s + s1Length, realloc_size, format, arg_list) < 0)
                 {
@@ -648,9 +691,7 @@ int STRING_quote(STRING_HANDLE handle)
         STRING* s1 = (STRING*)handle;
         size_t s1Length = strlen(s1->s);
         size_t realloc_size = safe_add_size_t(safe_add_size_t(s1Length, 2), 1); /*2 because 2 quotes, 1 because '\0'*/
-        char* temp;
-        if (realloc_size == SIZE_MAX ||
-            (temp = (char*)realloc(s1->s, realloc_size)) == NULL)
+        if (string_grow(s1, realloc_size) != 0)
         {
             LogError("Failure reallocating value. size=%zu", realloc_size);
             /* Codes_SRS_STRING_07_029: [STRING_quote shall return a nonzero value if any error is encountered.] */
@@ -658,7 +699,6 @@ int STRING_quote(STRING_HANDLE handle)
         }
         else
         {
-            s1->s = temp;
             memmove(s1->s + 1, s1->s, s1Length);
             s1->s[0] = '"';
             s1->s[s1Length + 1] = '"';
@@ -681,20 +721,11 @@ int STRING_empty(STRING_HANDLE handle)
     }
     else
     {
+        /* Codes_SRS_STRING_07_022: [STRING_empty shall revert the STRING_HANDLE to an empty state.] */
+        /*the capacity is kept so that the STRING can be refilled without reallocating, STRING_shrink_to_fit releases it*/
         STRING* s1 = (STRING*)handle;
-        char* temp = (char*)realloc(s1->s, 1);
-        if (temp == NULL)
-        {
-            LogError("Failure reallocating value.");
-            /* Codes_SRS_STRING_07_030: [STRING_empty shall return a nonzero value if the STRING_HANDLE is NULL.] */
-            result = MU_FAILURE;
-        }
-        else
-        {
-            s1->s = temp;
-            s1->s[0] = '\0';
-            result = 0;
-        }
+        s1->s[0] = '\0';
+        result = 0;
     }
     return result;
 }
@@ -707,7 +738,10 @@ void STRING_delete(STRING_HANDLE handle)
     if (handle != NULL)
     {
         STRING* value = (STRING*)handle;
-        free(value->s);
+        if (!string_is_inline(value))
+        {
+            free(value->s);
+        }
         value->s = NULL;
         free(value);
     }
@@ -764,27 +798,17 @@ STRING_HANDLE STRING_construct_n(const char* psz, size_t n)
         else
         {
             STRING* str;
-            if ((str = (STRING*)malloc(sizeof(STRING))) != NULL)
+            size_t malloc_size = safe_add_size_t(n, 1);
+            if ((str = string_alloc(malloc_size)) != NULL)
             {
-                size_t malloc_size = safe_add_size_t(len, 1);
-                if (malloc_size != SIZE_MAX &&
-                    (str->s = (char*)malloc(malloc_size)) != NULL)
-                {
-                    (void)memcpy(str->s, psz, n);
-                    str->s[n] = '\0';
-                    result = (STRING_HANDLE)str;
-                }
-                /* Codes_SRS_STRING_02_010: [In all other error cases, STRING_construct_n shall return NULL.]  */
-                else
-                {
-                    LogError("Failure allocating value. size=%zu", malloc_size);
-                    free(str);
-                    result = NULL;
-                }
+                (void)memcpy(str->s, psz, n);
+                str->s[n] = '\0';
+                result = (STRING_HANDLE)str;
             }
             else
             {
                 /* Codes_SRS_STRING_02_010: [In all other error cases, STRING_construct_n shall return NULL.]  */
+                LogError("Failure allocating value. size=%zu", malloc_size);
                 result = NULL;
             }
         }
@@ -833,30 +857,21 @@ STRING_HANDLE STRING_from_byte_array(const unsigned char* source, size_t size)
     else
     {
         /*Codes_SRS_STRING_02_023: [ Otherwise, STRING_from_BUFFER shall build a string that has the same content (byte-by-byte) as source and return a non-NULL handle. ]*/
-        result = (STRING*)malloc(sizeof(STRING));
+        size_t malloc_size = safe_add_size_t(size, 1);
+        result = string_alloc(malloc_size);
         if (result == NULL)
         {
             /*Codes_SRS_STRING_02_024: [ If building the string fails, then STRING_from_BUFFER shall fail and return NULL. ]*/
-            LogError("oom - unable to malloc");
+            LogError("oom - unable to malloc, size=%zu", malloc_size);
             /*return as is*/
         }
         else
         {
-            /*Codes_SRS_STRING_02_023: [ Otherwise, STRING_from_BUFFER shall build a string that has the same content (byte-by-byte) as source and return a non-NULL handle. ]*/
-            size_t malloc_size = safe_add_size_t(size, 1);
-            if (malloc_size == SIZE_MAX ||
-                (result->s = (char*)malloc(malloc_size)) == NULL)
-            {
-                /*Codes_SRS_STRING_02_024: [ If building the string fails, then STRING_from_BUFFER shall fail and return NULL. ]*/
-                LogError("oom - unable to malloc, size=%zu", malloc_size);
-                free(result);
-                result = NULL;
-            }
-            else
+            if (size > 0)
             {
                 (void)memcpy(result->s, source, size);
-                result->s[size] = '\0'; /*all is fine*/
             }
+            result->s[size] = '\0'; /*all is fine*/
         }
     }
     return (STRING_HANDLE)result;
@@ -894,3 +909,81 @@ int STRING_replace(STRING_HANDLE handle, char target, char replace)
     }
     return result;
 }
+
+int STRING_reserve(STRING_HANDLE handle, size_t capacity)
+{
+    int result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_STRING_07_050: [ If handle is NULL STRING_reserve shall return a non-zero value. ] */
+        LogError("Invalid argument handle=%p", handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        STRING* str = (STRING*)handle;
+        /* Codes_SRS_STRING_07_051: [ If the STRING can already hold capacity characters STRING_reserve shall not allocate and shall return zero. ] */
+        /* Codes_SRS_STRING_07_052: [ Otherwise STRING_reserve shall reallocate the STRING content to hold exactly capacity characters and the null terminator, preserving the content. ] */
+        if (string_reserve(str, safe_add_size_t(capacity, 1)) != 0)
+        {
+            /* Codes_SRS_STRING_07_053: [ If any error is encountered STRING_reserve shall leave the STRING unchanged and return a non-zero value. ] */
+            LogError("Failure reserving %zu characters", capacity);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_STRING_07_054: [ On success STRING_reserve shall return zero. ] */
+            result = 0;
+        }
+    }
+    return result;
+}
+
+int STRING_shrink_to_fit(STRING_HANDLE handle)
+{
+    int result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_STRING_07_055: [ If handle is NULL STRING_shrink_to_fit shall return a non-zero value. ] */
+        LogError("Invalid argument handle=%p", handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        STRING* str = (STRING*)handle;
+        size_t needed = strlen(str->s) + 1;
+        if (string_is_inline(str) || needed == str->capacity)
+        {
+            /* Codes_SRS_STRING_07_056: [ If the content is stored in the STRING allocation itself or already uses all the capacity STRING_shrink_to_fit shall not allocate and shall return zero. ] */
+            result = 0;
+        }
+        else if (needed <= str->inline_size)
+        {
+            /* Codes_SRS_STRING_07_057: [ If the content fits in the STRING allocation itself STRING_shrink_to_fit shall move it there and free the separately allocated content. ] */
+            (void)memcpy(str->inline_buffer, str->s, needed);
+            free(str->s);
+            str->s = str->inline_buffer;
+            str->capacity = str->inline_size;
+            result = 0;
+        }
+        else
+        {
+            /* Codes_SRS_STRING_07_058: [ Otherwise STRING_shrink_to_fit shall reallocate the content to the length of the string plus the null terminator. ] */
+            char* temp = (char*)realloc(str->s, needed);
+            if (temp == NULL)
+            {
+                /* Codes_SRS_STRING_07_059: [ If any error is encountered STRING_shrink_to_fit shall leave the STRING unchanged and return a non-zero value. ] */
+                LogError("Failure reallocating value. size=%zu", needed);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                str->s = temp;
+                str->capacity = needed;
+                /* Codes_SRS_STRING_07_060: [ On success STRING_shrink_to_fit shall return zero. ] */
+                result = 0;
+            }
+        }
+    }
+    return result;
+}
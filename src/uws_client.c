@@ -17,6 +17,8 @@
 #include "azure_c_shared_utility/tlsio.h"
 #include "azure_c_shared_utility/crt_abstractions.h"
 #include "azure_c_shared_utility/buffer_.h"
+#include "azure_c_shared_utility/constbuffer.h"
+#include "azure_c_shared_utility/constbuffer_array.h"
 #include "azure_c_shared_utility/uws_frame_encoder.h"
 #include "azure_c_shared_utility/crt_abstractions.h"
 #include "azure_c_shared_utility/utf8_checker.h"
@@ -98,8 +100,11 @@ typedef struct UWS_CLIENT_INSTANCE_TAG
     void* on_ws_close_complete_context;
     unsigned char* stream_buffer;
     size_t stream_buffer_size;
+    /* the bytes before stream_buffer_offset are decoded, the ones up to stream_buffer_count wait for the rest of their frame */
+    size_t stream_buffer_offset;
     size_t stream_buffer_count;
     unsigned char* fragment_buffer;
+    size_t fragment_buffer_size;
     size_t fragment_buffer_count;
     unsigned char fragmented_frame_type;
 } UWS_CLIENT_INSTANCE;
@@ -891,12 +896,77 @@ static void on_underlying_io_open_complete(void* context, IO_OPEN_RESULT open_re
 
 static void consume_stream_buffer_bytes(UWS_CLIENT_INSTANCE* uws_client, size_t consumed_bytes)
 {
-    if (consumed_bytes < uws_client->stream_buffer_count)
+    /* the consumed bytes are skipped, the ones left are moved to the front only when more room is needed */
+    uws_client->stream_buffer_offset += consumed_bytes;
+    if (uws_client->stream_buffer_offset >= uws_client->stream_buffer_count)
     {
-        (void)memmove(uws_client->stream_buffer, uws_client->stream_buffer + consumed_bytes, uws_client->stream_buffer_count - consumed_bytes);
+        uws_client->stream_buffer_offset = 0;
+        uws_client->stream_buffer_count = 0;
+    }
+}
+
+/* grows stream_buffer to at least needed_size bytes (to new_size if that is more), the memory is kept for the next frames */
+static int grow_stream_buffer(UWS_CLIENT_INSTANCE* uws_client, size_t needed_size, size_t new_size)
+{
+    int result;
+
+    if (needed_size <= uws_client->stream_buffer_size)
+    {
+        result = 0;
+    }
+    else
+    {
+        unsigned char* new_stream_buffer;
+
+        if (new_size < needed_size)
+        {
+            new_size = needed_size;
+        }
+
+        if ((needed_size == SIZE_MAX) ||
+            ((new_stream_buffer = (unsigned char*)realloc(uws_client->stream_buffer, new_size)) == NULL))
+        {
+            LogError("Cannot allocate memory for received data");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            uws_client->stream_buffer = new_stream_buffer;
+            uws_client->stream_buffer_size = new_size;
+            result = 0;
+        }
     }
 
-    uws_client->stream_buffer_count -= consumed_bytes;
+    return result;
+}
+
+/* appends bytes to the ones waiting in stream_buffer */
+static int append_stream_buffer_bytes(UWS_CLIENT_INSTANCE* uws_client, const unsigned char* buffer, size_t size)
+{
+    int result;
+    size_t needed_size = safe_add_size_t(uws_client->stream_buffer_count, size);
+
+    if ((uws_client->stream_buffer_offset > 0) &&
+        (needed_size > uws_client->stream_buffer_size))
+    {
+        (void)memmove(uws_client->stream_buffer, uws_client->stream_buffer + uws_client->stream_buffer_offset, uws_client->stream_buffer_count - uws_client->stream_buffer_offset);
+        uws_client->stream_buffer_count -= uws_client->stream_buffer_offset;
+        uws_client->stream_buffer_offset = 0;
+        needed_size = safe_add_size_t(uws_client->stream_buffer_count, size);
+    }
+
+    if (grow_stream_buffer(uws_client, needed_size, safe_multiply_size_t(uws_client->stream_buffer_size, 2)) != 0)
+    {
+        result = MU_FAILURE;
+    }
+    else
+    {
+        (void)memcpy(uws_client->stream_buffer + uws_client->stream_buffer_count, buffer, size);
+        uws_client->stream_buffer_count += size;
+        result = 0;
+    }
+
+    return result;
 }
 
 static void on_underlying_io_close_complete(void* context)
@@ -1050,25 +1120,46 @@ static int ParseHttpResponse(const char* src, int* dst)
     return result;
 }
 
-static int process_frame_fragment(UWS_CLIENT_INSTANCE *uws_client, size_t length, size_t needed_bytes)
+static int process_frame_fragment(UWS_CLIENT_INSTANCE *uws_client, const unsigned char* payload, size_t length)
 {
     int result;
     unsigned char* new_fragment_bytes;
-    size_t realloc_size = safe_add_size_t(uws_client->fragment_buffer_count, length);
-    if (realloc_size == SIZE_MAX ||
-        (new_fragment_bytes = (unsigned char*)realloc(uws_client->fragment_buffer, realloc_size)) == NULL)
+    size_t needed_size = safe_add_size_t(uws_client->fragment_buffer_count, length);
+
+    /* Codes_SRS_UWS_CLIENT_01_535: [ The memory used to accumulate fragments shall be kept for the next fragmented messages and only grown when a fragment does not fit in it. ]*/
+    if (needed_size <= uws_client->fragment_buffer_size)
     {
-        /* Codes_SRS_UWS_CLIENT_01_379: [ If allocating memory for accumulating the bytes fails, uws shall report that the open failed by calling the on_ws_open_complete callback passed to uws_client_open_async with WS_OPEN_ERROR_NOT_ENOUGH_MEMORY. ]*/
-        LogError("Cannot allocate memory for received data");
-        indicate_ws_error(uws_client, WS_ERROR_NOT_ENOUGH_MEMORY);
-        result = MU_FAILURE;
+        if (length > 0)
+        {
+            (void)memcpy(uws_client->fragment_buffer + uws_client->fragment_buffer_count, payload, length);
+            uws_client->fragment_buffer_count += length;
+        }
+        result = 0;
     }
     else
     {
-        uws_client->fragment_buffer = new_fragment_bytes;
-        (void)memcpy(uws_client->fragment_buffer + uws_client->fragment_buffer_count, uws_client->stream_buffer + needed_bytes - length, length);
-        uws_client->fragment_buffer_count += length;
-        result = 0;
+        size_t new_size = safe_multiply_size_t(uws_client->fragment_buffer_size, 2);
+        if (new_size < needed_size)
+        {
+            new_size = needed_size;
+        }
+
+        if (needed_size == SIZE_MAX ||
+            (new_fragment_bytes = (unsigned char*)realloc(uws_client->fragment_buffer, new_size)) == NULL)
+        {
+            /* Codes_SRS_UWS_CLIENT_01_379: [ If allocating memory for accumulating the bytes fails, uws shall report that the open failed by calling the on_ws_open_complete callback passed to uws_client_open_async with WS_OPEN_ERROR_NOT_ENOUGH_MEMORY. ]*/
+            LogError("Cannot allocate memory for received data");
+            indicate_ws_error(uws_client, WS_ERROR_NOT_ENOUGH_MEMORY);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            uws_client->fragment_buffer = new_fragment_bytes;
+            uws_client->fragment_buffer_size = new_size;
+            (void)memcpy(uws_client->fragment_buffer + uws_client->fragment_buffer_count, payload, length);
+            uws_client->fragment_buffer_count += length;
+            result = 0;
+        }
     }
 
     return result;
@@ -1090,6 +1181,9 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
         else
         {
             unsigned char decode_stream = 1;
+            /* the bytes decoded in place from buffer, when no bytes are waiting in stream_buffer */
+            const unsigned char* received_bytes = NULL;
+            size_t received_bytes_count = 0;
 
             switch (uws_client->uws_state)
             {
@@ -1107,12 +1201,8 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
             case UWS_STATE_WAITING_FOR_UPGRADE_RESPONSE:
             {
                 /* Codes_SRS_UWS_CLIENT_01_378: [ When on_underlying_io_bytes_received is called while the uws is OPENING, the received bytes shall be accumulated in order to attempt parsing the WebSocket Upgrade response. ]*/
-                unsigned char* new_received_bytes;
-
-                //size_t realloc_size = uws_client->stream_buffer_count + size + 1; **using safe int**
-                uws_client->stream_buffer_size = safe_add_size_t(safe_add_size_t(uws_client->stream_buffer_count, size), 1);
-                if (uws_client->stream_buffer_size == SIZE_MAX || 
-                    (new_received_bytes = (unsigned char*)realloc(uws_client->stream_buffer, uws_client->stream_buffer_size)) == NULL)
+                /* one more byte for the zero terminator the response is parsed with */
+                if (grow_stream_buffer(uws_client, safe_add_size_t(safe_add_size_t(uws_client->stream_buffer_count, size), 1), 0) != 0)
                 {
                     /* Codes_SRS_UWS_CLIENT_01_379: [ If allocating memory for accumulating the bytes fails, uws shall report that the open failed by calling the on_ws_open_complete callback passed to uws_client_open_async with WS_OPEN_ERROR_NOT_ENOUGH_MEMORY. ]*/
                     indicate_ws_open_complete_error_and_close(uws_client, WS_OPEN_ERROR_NOT_ENOUGH_MEMORY);
@@ -1120,7 +1210,6 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
                 }
                 else
                 {
-                    uws_client->stream_buffer = new_received_bytes;
                     (void)memcpy(uws_client->stream_buffer + uws_client->stream_buffer_count, buffer, size);
                     uws_client->stream_buffer_count += size;
 
@@ -1134,25 +1223,25 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
             case UWS_STATE_CLOSING_WAITING_FOR_CLOSE:
             {
                 /* Codes_SRS_UWS_CLIENT_01_385: [ If the state of the uws instance is OPEN, the received bytes shall be used for decoding WebSocket frames. ]*/
-                unsigned char* new_received_bytes;
+                if (uws_client->stream_buffer_count == 0)
+                {
+                    /* Codes_SRS_UWS_CLIENT_01_532: [ If no bytes are waiting for the rest of their frame, the frames shall be decoded from buffer without copying them. ]*/
+                    received_bytes = buffer;
+                    received_bytes_count = size;
 
-                //size_t realloc_size = uws_client->stream_buffer_count + size + 1; **using safe int**
-                uws_client->stream_buffer_size = safe_add_size_t(safe_add_size_t(uws_client->stream_buffer_count, size), 1);
-                if (uws_client->stream_buffer_size == SIZE_MAX ||
-                    (new_received_bytes = (unsigned char*)realloc(uws_client->stream_buffer, uws_client->stream_buffer_size)) == NULL)
+                    decode_stream = 1;
+                }
+                /* Codes_SRS_UWS_CLIENT_01_533: [ Otherwise the received bytes shall be appended to the bytes waiting for the rest of their frame. ]*/
+                /* Codes_SRS_UWS_CLIENT_01_534: [ The memory used to accumulate bytes shall be kept for the next frames and only grown when the bytes do not fit in it. ]*/
+                else if (append_stream_buffer_bytes(uws_client, buffer, size) != 0)
                 {
                     /* Codes_SRS_UWS_CLIENT_01_418: [ If allocating memory for the bytes accumulated for decoding WebSocket frames fails, an error shall be indicated by calling the on_ws_error callback with WS_ERROR_NOT_ENOUGH_MEMORY. ]*/
-                    LogError("Cannot allocate memory for received data");
                     indicate_ws_error(uws_client, WS_ERROR_NOT_ENOUGH_MEMORY);
 
                     decode_stream = 0;
                 }
                 else
                 {
-                    uws_client->stream_buffer = new_received_bytes;
-                    (void)memcpy(uws_client->stream_buffer + uws_client->stream_buffer_count, buffer, size);
-                    uws_client->stream_buffer_count += size;
-
                     decode_stream = 1;
                 }
 
@@ -1230,17 +1319,28 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
                 {
                     size_t needed_bytes = 2;
                     size_t length;
+                    const unsigned char* stream_bytes;
+                    size_t stream_bytes_count;
+
+                    if (uws_client->stream_buffer_count > 0)
+                    {
+                        stream_bytes = uws_client->stream_buffer + uws_client->stream_buffer_offset;
+                        stream_bytes_count = uws_client->stream_buffer_count - uws_client->stream_buffer_offset;
+                    }
+                    else
+                    {
+                        stream_bytes = received_bytes;
+                        stream_bytes_count = received_bytes_count;
+                    }
 
                     /* Codes_SRS_UWS_CLIENT_01_277: [ To receive WebSocket data, an endpoint listens on the underlying network connection. ]*/
                     /* Codes_SRS_UWS_CLIENT_01_278: [ Incoming data MUST be parsed as WebSocket frames as defined in Section 5.2. ]*/
-                    if (uws_client->stream_buffer_count >= needed_bytes && 
-                        uws_client->stream_buffer_size > 1   // validate uws_client->stream_buffer[1] access
-                        )
+                    if (stream_bytes_count >= needed_bytes)
                     {
                         unsigned char has_error = 0;
 
                         /* Codes_SRS_UWS_CLIENT_01_160: [ Defines whether the "Payload data" is masked. ]*/
-                        if ((uws_client->stream_buffer[1] & 0x80) != 0)
+                        if ((stream_bytes[1] & 0x80) != 0)
                         {
                             /* Codes_SRS_UWS_CLIENT_01_144: [ A client MUST close a connection if it detects a masked frame. ]*/
                             /* Codes_SRS_UWS_CLIENT_01_145: [ In this case, it MAY use the status code 1002 (protocol error) as defined in Section 7.4.1. (These rules might be relaxed in a future specification.) ]*/
@@ -1250,18 +1350,16 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
 
                         /* Codes_SRS_UWS_CLIENT_01_163: [ The length of the "Payload data", in bytes: ]*/
                         /* Codes_SRS_UWS_CLIENT_01_164: [ if 0-125, that is the payload length. ]*/
-                        length = uws_client->stream_buffer[1];
+                        length = stream_bytes[1];
 
                         if (length == 126)
                         {
                             /* Codes_SRS_UWS_CLIENT_01_165: [ If 126, the following 2 bytes interpreted as a 16-bit unsigned integer are the payload length. ]*/
                             needed_bytes += 2;
-                            if (uws_client->stream_buffer_count >= needed_bytes && 
-                                uws_client->stream_buffer_size > 3   // validate access upto stream_buffer[3]
-                                )
+                            if (stream_bytes_count >= needed_bytes)
                             {
                                 /* Codes_SRS_UWS_CLIENT_01_167: [ Multibyte length quantities are expressed in network byte order. ]*/
-                                length = ((size_t)(uws_client->stream_buffer[2]) << 8) + (size_t)uws_client->stream_buffer[3];
+                                length = ((size_t)(stream_bytes[2]) << 8) + (size_t)stream_bytes[3];
 
                                 if (length < 126)
                                 {
@@ -1282,9 +1380,9 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
                         {
                             /* Codes_SRS_UWS_CLIENT_01_166: [ If 127, the following 8 bytes interpreted as a 64-bit unsigned integer (the most significant bit MUST be 0) are the payload length. ]*/
                             needed_bytes += 8;
-                            if (uws_client->stream_buffer_count >= needed_bytes)
+                            if (stream_bytes_count >= needed_bytes)
                             {
-                                if (uws_client->stream_buffer_size <= 2 || (uws_client->stream_buffer[2] & 0x80) != 0)
+                                if ((stream_bytes[2] & 0x80) != 0)
                                 {
                                     LogError("Bad frame: received a 64 bit length frame with the highest bit set");
 
@@ -1292,22 +1390,17 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
                                     indicate_ws_error(uws_client, WS_ERROR_BAD_FRAME_RECEIVED);
                                     has_error = 1;
                                 }
-                                else if (uws_client->stream_buffer_size <= 9)  // validate access upto stream_buffer[9] below
-                                {
-                                    indicate_ws_error(uws_client, WS_ERROR_BAD_FRAME_RECEIVED);
-                                    has_error = 1;
-                                }
                                 else
                                 {
                                     /* Codes_SRS_UWS_CLIENT_01_167: [ Multibyte length quantities are expressed in network byte order. ]*/
-                                    uint64_t length_uint64 = (((uint64_t)(uws_client->stream_buffer[2]) << 56) +
-                                        (((uint64_t)uws_client->stream_buffer[3]) << 48) +
-                                        (((uint64_t)uws_client->stream_buffer[4]) << 40) +
-                                        (((uint64_t)uws_client->stream_buffer[5]) << 32) +
-                                        (((uint64_t)uws_client->stream_buffer[6]) << 24) +
-                                        (((uint64_t)uws_client->stream_buffer[7]) << 16) +
-                                        (((uint64_t)uws_client->stream_buffer[8]) << 8) +
-                                        (uint64_t)(uws_client->stream_buffer[9]));
+                                    uint64_t length_uint64 = (((uint64_t)(stream_bytes[2]) << 56) +
+                                        (((uint64_t)stream_bytes[3]) << 48) +
+                                        (((uint64_t)stream_bytes[4]) << 40) +
+                                        (((uint64_t)stream_bytes[5]) << 32) +
+                                        (((uint64_t)stream_bytes[6]) << 24) +
+                                        (((uint64_t)stream_bytes[7]) << 16) +
+                                        (((uint64_t)stream_bytes[8]) << 8) +
+                                        (uint64_t)(stream_bytes[9]));
 
                                     length = (size_t)(length_uint64);
                                     needed_bytes = safe_add_size_t(needed_bytes, length);
@@ -1332,12 +1425,12 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
                         }
 
                         if ((has_error == 0) &&
-                            (uws_client->stream_buffer_count >= needed_bytes))
+                            (stream_bytes_count >= needed_bytes))
                         {
-                            unsigned char opcode = uws_client->stream_buffer[0] & 0xF;
+                            unsigned char opcode = stream_bytes[0] & 0xF;
 
                             /* Codes_SRS_UWS_CLIENT_01_147: [ Indicates that this is the final fragment in a message. ]*/
-                            bool is_final = (uws_client->stream_buffer[0] & 0x80) != 0;
+                            bool is_final = (stream_bytes[0] & 0x80) != 0;
 
                             switch (opcode)
                             {
@@ -1349,7 +1442,7 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
                                 /* Codes_SRS_UWS_CLIENT_01_213: [ A fragmented message consists of a single frame with the FIN bit clear and an opcode other than 0, followed by zero or more frames with the FIN bit clear and the opcode set to 0, and terminated by a single frame with the FIN bit set and an opcode of 0. ]*/
                                 /* Codes_SRS_UWS_CLIENT_01_216: [ Message fragments MUST be delivered to the recipient in the order sent by the sender. ]*/
                                 /* Codes_SRS_UWS_CLIENT_01_219: [ A sender MAY create fragments of any size for non-control messages. ]*/
-                                if (process_frame_fragment(uws_client, length, needed_bytes) != 0)
+                                if (process_frame_fragment(uws_client, stream_bytes + needed_bytes - length, length) != 0)
                                 {
                                     break;
                                 }
@@ -1383,7 +1476,7 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
                                 /* Codes_SRS_UWS_CLIENT_01_282: [ If the frame comprises an unfragmented message (Section 5.4), it is said that _A WebSocket Message Has Been Received_ with type /type/ and data /data/. ]*/
                                 if (is_final)
                                 {
-                                    uws_client->on_ws_frame_received(uws_client->on_ws_frame_received_context, WS_FRAME_TYPE_TEXT, uws_client->stream_buffer + needed_bytes - length, length);
+                                    uws_client->on_ws_frame_received(uws_client->on_ws_frame_received_context, WS_FRAME_TYPE_TEXT, stream_bytes + needed_bytes - length, length);
                                 }
                                 else
                                 {
@@ -1398,7 +1491,7 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
                                     /* Codes_SRS_UWS_CLIENT_01_213: [ A fragmented message consists of a single frame with the FIN bit clear and an opcode other than 0, followed by zero or more frames with the FIN bit clear and the opcode set to 0, and terminated by a single frame with the FIN bit set and an opcode of 0. ]*/
                                     /* Codes_SRS_UWS_CLIENT_01_216: [ Message fragments MUST be delivered to the recipient in the order sent by the sender. ]*/
                                     /* Codes_SRS_UWS_CLIENT_01_219: [ A sender MAY create fragments of any size for non-control messages. ]*/
-                                    if (process_frame_fragment(uws_client, length, needed_bytes) != 0)
+                                    if (process_frame_fragment(uws_client, stream_bytes + needed_bytes - length, length) != 0)
                                     {
                                         break;
                                     }
@@ -1423,7 +1516,7 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
                                 /* Codes_SRS_UWS_CLIENT_01_282: [ If the frame comprises an unfragmented message (Section 5.4), it is said that _A WebSocket Message Has Been Received_ with type /type/ and data /data/. ]*/
                                 if (is_final)
                                 {
-                                    size_t stream_buffer_idx = safe_add_size_t(uws_client->stream_buffer, needed_bytes);
+                                    size_t stream_buffer_idx = safe_add_size_t(stream_bytes, needed_bytes);
                                     stream_buffer_idx = safe_subtract_size_t(stream_buffer_idx, length);
                                     if (stream_buffer_idx != SIZE_MAX)
                                     {
@@ -1450,7 +1543,7 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
                                     /* Codes_SRS_UWS_CLIENT_01_213: [ A fragmented message consists of a single frame with the FIN bit clear and an opcode other than 0, followed by zero or more frames with the FIN bit clear and the opcode set to 0, and terminated by a single frame with the FIN bit set and an opcode of 0. ]*/
                                     /* Codes_SRS_UWS_CLIENT_01_216: [ Message fragments MUST be delivered to the recipient in the order sent by the sender. ]*/
                                     /* Codes_SRS_UWS_CLIENT_01_219: [ A sender MAY create fragments of any size for non-control messages. ]*/
-                                    if (process_frame_fragment(uws_client, length, needed_bytes) != 0)
+                                    if (process_frame_fragment(uws_client, stream_bytes + needed_bytes - length, length) != 0)
                                     {
                                         break;
                                     }
@@ -1470,7 +1563,7 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
                             {
                                 uint16_t close_code;
                                 uint16_t* close_code_ptr;
-                                const unsigned char* data_ptr = uws_client->stream_buffer + needed_bytes - length;
+                                const unsigned char* data_ptr = stream_bytes + needed_bytes - length;
                                 const unsigned char* extra_data_ptr;
                                 size_t extra_data_length;
                                 unsigned char* close_frame_bytes;
@@ -1619,7 +1712,7 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
                                 }
 
                                 /* Codes_SRS_UWS_CLIENT_01_140: [ To avoid confusing network intermediaries (such as intercepting proxies) and for security reasons that are further discussed in Section 10.3, a client MUST mask all frames that it sends to the server (see Section 5.3 for further details). ]*/
-                                pong_frame_buffer = uws_frame_encoder_encode(WS_PONG_FRAME, uws_client->stream_buffer + needed_bytes - length, length, true, true, 0);
+                                pong_frame_buffer = uws_frame_encoder_encode(WS_PONG_FRAME, stream_bytes + needed_bytes - length, length, true, true, 0);
                                 if (pong_frame_buffer == NULL)
                                 {
                                     LogError("Encoding of PONG failed.");
@@ -1644,7 +1737,15 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
                                 break;
                             }
 
-                            consume_stream_buffer_bytes(uws_client, needed_bytes);
+                            if (uws_client->stream_buffer_count > 0)
+                            {
+                                consume_stream_buffer_bytes(uws_client, needed_bytes);
+                            }
+                            else
+                            {
+                                received_bytes += needed_bytes;
+                                received_bytes_count -= needed_bytes;
+                            }
                         }
                     }
 
@@ -1652,6 +1753,14 @@ static void on_underlying_io_bytes_received(void* context, const unsigned char*
                 }
                 }
             }
+
+            /* Codes_SRS_UWS_CLIENT_01_536: [ The bytes left in buffer after decoding in place shall be copied to wait for the rest of their frame. ]*/
+            if ((received_bytes_count > 0) &&
+                (append_stream_buffer_bytes(uws_client, received_bytes, received_bytes_count) != 0))
+            {
+                /* Codes_SRS_UWS_CLIENT_01_418: [ If allocating memory for the bytes accumulated for decoding WebSocket frames fails, an error shall be indicated by calling the on_ws_error callback with WS_ERROR_NOT_ENOUGH_MEMORY. ]*/
+                indicate_ws_error(uws_client, WS_ERROR_NOT_ENOUGH_MEMORY);
+            }
         }
     }
 }
@@ -1721,6 +1830,7 @@ int uws_client_open_async(UWS_CLIENT_HANDLE uws_client, ON_WS_OPEN_COMPLETE on_w
         {
             uws_client->uws_state = UWS_STATE_OPENING_UNDERLYING_IO;
 
+            uws_client->stream_buffer_offset = 0;
             uws_client->stream_buffer_count = 0;
             uws_client->fragment_buffer_count = 0;
             uws_client->fragmented_frame_type = WS_FRAME_TYPE_UNKNOWN;
@@ -2086,6 +2196,130 @@ int uws_client_send_frame_async(UWS_CLIENT_HANDLE uws_client, unsigned char fram
     return result;
 }
 
+int uws_client_send_frame_array_async(UWS_CLIENT_HANDLE uws_client, unsigned char frame_type, CONSTBUFFER_ARRAY_HANDLE buffers, bool is_final, ON_WS_SEND_FRAME_COMPLETE on_ws_send_frame_complete, void* on_ws_send_frame_complete_context)
+{
+    int result;
+
+    if ((uws_client == NULL) ||
+        (buffers == NULL))
+    {
+        /* Codes_SRS_UWS_CLIENT_04_001: [ If uws_client or buffers is NULL, uws_client_send_frame_array_async shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: uws_client=%p, buffers=%p", uws_client, buffers);
+        result = MU_FAILURE;
+    }
+    else if (uws_client->uws_state != UWS_STATE_OPEN)
+    {
+        /* Codes_SRS_UWS_CLIENT_04_002: [ If the uws instance is not OPEN then uws_client_send_frame_array_async shall fail and return a non-zero value. ]*/
+        LogError("uws not in OPEN state.");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        uint32_t buffer_count;
+        uint32_t payload_size;
+
+        /* Codes_SRS_UWS_CLIENT_04_003: [ uws_client_send_frame_array_async shall obtain the number of buffers and the payload size by calling constbuffer_array_get_buffer_count and constbuffer_array_get_all_buffers_size. ]*/
+        if ((constbuffer_array_get_buffer_count(buffers, &buffer_count) != 0) ||
+            (constbuffer_array_get_all_buffers_size(buffers, &payload_size) != 0))
+        {
+            /* Codes_SRS_UWS_CLIENT_04_010: [ If any other error occurs, uws_client_send_frame_array_async shall fail and return a non-zero value. ]*/
+            LogError("Cannot get the buffers of the array");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_UWS_CLIENT_04_004: [ uws_client_send_frame_array_async shall allocate a frame of uws_frame_encoder_get_header_size bytes for a masked payload of that size plus the payload size. ]*/
+            size_t header_size = uws_frame_encoder_get_header_size(payload_size, true);
+            size_t encoded_frame_length = safe_add_size_t(header_size, payload_size);
+            unsigned char* encoded_frame = (encoded_frame_length == SIZE_MAX) ? NULL : (unsigned char*)malloc(encoded_frame_length);
+            if (encoded_frame == NULL)
+            {
+                /* Codes_SRS_UWS_CLIENT_04_010: [ If any other error occurs, uws_client_send_frame_array_async shall fail and return a non-zero value. ]*/
+                LogError("Cannot allocate %u bytes for the frame to be sent", (unsigned int)encoded_frame_length);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                WS_PENDING_SEND* ws_pending_send = (WS_PENDING_SEND*)malloc(sizeof(WS_PENDING_SEND));
+                if (ws_pending_send == NULL)
+                {
+                    /* Codes_SRS_UWS_CLIENT_04_010: [ If any other error occurs, uws_client_send_frame_array_async shall fail and return a non-zero value. ]*/
+                    LogError("Cannot allocate memory for frame to be sent.");
+                    result = MU_FAILURE;
+                }
+                /* Codes_SRS_UWS_CLIENT_04_005: [ The frame header shall be written by calling uws_frame_encoder_encode_header with the payload size, is_final and is_masked set to true. ]*/
+                else if (uws_frame_encoder_encode_header(encoded_frame, header_size, (WS_FRAME_TYPE)frame_type, payload_size, true, is_final, 0) != 0)
+                {
+                    /* Codes_SRS_UWS_CLIENT_04_010: [ If any other error occurs, uws_client_send_frame_array_async shall fail and return a non-zero value. ]*/
+                    LogError("Failed encoding WebSocket frame header");
+                    free(ws_pending_send);
+                    result = MU_FAILURE;
+                }
+                else
+                {
+                    /* the masking key is the last 4 bytes of a masked frame header */
+                    const unsigned char* masking_key = encoded_frame + header_size - 4;
+                    size_t position = 0;
+                    uint32_t i;
+                    LIST_ITEM_HANDLE new_pending_send_list_item;
+
+                    for (i = 0; i < buffer_count; i++)
+                    {
+                        const CONSTBUFFER* content = constbuffer_array_get_buffer_content(buffers, i);
+                        unsigned char buffer_masking_key[4];
+                        size_t j;
+
+                        /* Codes_SRS_UWS_CLIENT_04_006: [ Each buffer shall be masked into the frame by calling uws_frame_encoder_mask, with the masking key rotated by the position of the buffer in the payload. ]*/
+                        for (j = 0; j < sizeof(buffer_masking_key); j++)
+                        {
+                            buffer_masking_key[j] = masking_key[(position + j) % 4];
+                        }
+                        uws_frame_encoder_mask(encoded_frame + header_size + position, content->buffer, content->size, buffer_masking_key);
+                        position += content->size;
+                    }
+
+                    ws_pending_send->on_ws_send_frame_complete = on_ws_send_frame_complete;
+                    ws_pending_send->context = on_ws_send_frame_complete_context;
+                    ws_pending_send->uws_client = uws_client;
+
+                    /* Codes_SRS_UWS_CLIENT_04_007: [ uws_client_send_frame_array_async shall queue the send like uws_client_send_frame_async does. ]*/
+                    new_pending_send_list_item = singlylinkedlist_add(uws_client->pending_sends, ws_pending_send);
+                    if (new_pending_send_list_item == NULL)
+                    {
+                        /* Codes_SRS_UWS_CLIENT_04_010: [ If any other error occurs, uws_client_send_frame_array_async shall fail and return a non-zero value. ]*/
+                        LogError("Could not allocate memory for pending frames");
+                        free(ws_pending_send);
+                        result = MU_FAILURE;
+                    }
+                    /* Codes_SRS_UWS_CLIENT_04_008: [ The frame shall be sent by calling xio_send with on_underlying_io_send_complete as callback. ]*/
+                    else if (xio_send(uws_client->underlying_io, encoded_frame, encoded_frame_length, on_underlying_io_send_complete, new_pending_send_list_item) != 0)
+                    {
+                        /* Codes_SRS_UWS_CLIENT_04_009: [ If xio_send fails, uws_client_send_frame_array_async shall de-queue the send if it is still queued and return a non-zero value. ]*/
+                        LogError("Could not send bytes through the underlying IO");
+                        if (singlylinkedlist_find(uws_client->pending_sends, find_list_node, new_pending_send_list_item) != NULL)
+                        {
+                            (void)singlylinkedlist_remove(uws_client->pending_sends, new_pending_send_list_item);
+                            free(ws_pending_send);
+                        }
+
+                        result = MU_FAILURE;
+                    }
+                    else
+                    {
+                        /* Codes_SRS_UWS_CLIENT_04_011: [ On success, uws_client_send_frame_array_async shall return 0. ]*/
+                        result = 0;
+                    }
+                }
+
+                /* Codes_SRS_UWS_CLIENT_04_012: [ The frame shall be freed once it was handed to xio_send. ]*/
+                free(encoded_frame);
+            }
+        }
+    }
+
+    return result;
+}
+
 void uws_client_dowork(UWS_CLIENT_HANDLE uws_client)
 {
     if (uws_client == NULL)
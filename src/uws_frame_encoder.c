@@ -4,12 +4,216 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/random.h"
 #include "azure_c_shared_utility/uws_frame_encoder.h"
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/buffer_.h"
 #include "azure_c_shared_utility/uniqueid.h"
+#include "azure_c_shared_utility/safe_math.h"
+#include "azure_c_shared_utility/optimize_size.h"
+
+/* SSE2 is part of every x64 CPU, AVX2 is used when the CPU has it (GCC and clang only, they can compile one function for AVX2) */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define UWS_FRAME_ENCODER_SSE2
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define UWS_FRAME_ENCODER_AVX2
+#endif
+#endif
+
+#ifdef UWS_FRAME_ENCODER_AVX2
+__attribute__((target("avx2")))
+static size_t mask_bytes_avx2(unsigned char* destination, const unsigned char* source, size_t length, uint32_t masking_key)
+{
+    size_t i;
+    __m256i key = _mm256_set1_epi32((int)masking_key);
+
+    for (i = 0; i + 32 <= length; i += 32)
+    {
+        __m256i bytes = _mm256_loadu_si256((const __m256i*)(source + i));
+        _mm256_storeu_si256((__m256i*)(destination + i), _mm256_xor_si256(bytes, key));
+    }
+
+    return i;
+}
+
+static int has_avx2(void)
+{
+    /* 0 = not checked yet, the check gives the same answer on every thread so the race is harmless */
+    static volatile int avx2_state = 0;
+    if (avx2_state == 0)
+    {
+        avx2_state = __builtin_cpu_supports("avx2") ? 1 : 2;
+    }
+    return avx2_state == 1;
+}
+#endif
+
+/* The mask repeats every 4 bytes, so it is applied a word (or a vector) at a time with the masking key repeated in it.
+All the wide steps handle multiples of 4 bytes, so the bytes left over at the end still start with masking_key[0]. */
+static void mask_bytes(unsigned char* destination, const unsigned char* source, size_t length, const unsigned char* masking_key)
+{
+    size_t i = 0;
+    uint32_t key;
+
+    (void)memcpy(&key, masking_key, sizeof(key));
+
+#ifdef UWS_FRAME_ENCODER_AVX2
+    if ((length >= 64) && has_avx2())
+    {
+        i = mask_bytes_avx2(destination, source, length, key);
+    }
+#endif
+
+#ifdef UWS_FRAME_ENCODER_SSE2
+    {
+        __m128i key_vector = _mm_set1_epi32((int)key);
+        for (; i + 16 <= length; i += 16)
+        {
+            __m128i bytes = _mm_loadu_si128((const __m128i*)(source + i));
+            _mm_storeu_si128((__m128i*)(destination + i), _mm_xor_si128(bytes, key_vector));
+        }
+    }
+#else
+    {
+        uint64_t key_word = (uint64_t)key | ((uint64_t)key << 32);
+        for (; i + 8 <= length; i += 8)
+        {
+            uint64_t word;
+            (void)memcpy(&word, source + i, sizeof(word));
+            word ^= key_word;
+            (void)memcpy(destination + i, &word, sizeof(word));
+        }
+    }
+#endif
+
+    for (; i < length; i++)
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_041: [ Octet i of the transformed data ("transformed-octet-i") is the XOR of octet i of the original data ("original-octet-i") with octet at index i modulo 4 of the masking key ("masking-key-octet-j"): ]*/
+        destination[i] = source[i] ^ masking_key[i % 4];
+    }
+}
+
+static size_t get_header_size(size_t length, bool is_masked)
+{
+    size_t result = 2;
+
+    if (length > 65535)
+    {
+        result += 8;
+    }
+    else if (length > 125)
+    {
+        result += 2;
+    }
+
+    if (is_masked)
+    {
+        result += 4;
+    }
+
+    return result;
+}
+
+static void write_header(unsigned char* buffer, size_t header_bytes, WS_FRAME_TYPE opcode, size_t length, bool is_masked, bool is_final, unsigned char reserved)
+{
+    /* Codes_SRS_UWS_FRAME_ENCODER_01_007: [ *  %x0 denotes a continuation frame ]*/
+    /* Codes_SRS_UWS_FRAME_ENCODER_01_008: [ *  %x1 denotes a text frame ]*/
+    /* Codes_SRS_UWS_FRAME_ENCODER_01_009: [ *  %x2 denotes a binary frame ]*/
+    /* Codes_SRS_UWS_FRAME_ENCODER_01_010: [ *  %x3-7 are reserved for further non-control frames ]*/
+    /* Codes_SRS_UWS_FRAME_ENCODER_01_011: [ *  %x8 denotes a connection close ]*/
+    /* Codes_SRS_UWS_FRAME_ENCODER_01_012: [ *  %x9 denotes a ping ]*/
+    /* Codes_SRS_UWS_FRAME_ENCODER_01_013: [ *  %xA denotes a pong ]*/
+    /* Codes_SRS_UWS_FRAME_ENCODER_01_014: [ *  %xB-F are reserved for further control frames ]*/
+    buffer[0] = (unsigned char)opcode;
+
+    /* Codes_SRS_UWS_FRAME_ENCODER_01_002: [ Indicates that this is the final fragment in a message. ]*/
+    /* Codes_SRS_UWS_FRAME_ENCODER_01_003: [ The first fragment MAY also be the final fragment. ]*/
+    if (is_final)
+    {
+        buffer[0] |= 0x80;
+    }
+
+    /* Codes_SRS_UWS_FRAME_ENCODER_01_004: [ MUST be 0 unless an extension is negotiated that defines meanings for non-zero values. ]*/
+    buffer[0] |= reserved << 4;
+
+    /* Codes_SRS_UWS_FRAME_ENCODER_01_022: [ Note that in all cases, the minimal number of bytes MUST be used to encode the length, for example, the length of a 124-byte-long string can't be encoded as the sequence 126, 0, 124. ]*/
+    /* Codes_SRS_UWS_FRAME_ENCODER_01_018: [ The length of the "Payload data", in bytes: ]*/
+    /* Codes_SRS_UWS_FRAME_ENCODER_01_023: [ The payload length is the length of the "Extension data" + the length of the "Application data". ]*/
+    /* Codes_SRS_UWS_FRAME_ENCODER_01_042: [ The payload length, indicated in the framing as frame-payload-length, does NOT include the length of the masking key. ]*/
+    if (length > 65535)
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_020: [ If 127, the following 8 bytes interpreted as a 64-bit unsigned integer (the most significant bit MUST be 0) are the payload length. ]*/
+        buffer[1] = 127;
+
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_021: [ Multibyte length quantities are expressed in network byte order. ]*/
+        buffer[2] = (unsigned char)((uint64_t)length >> 56) & 0xFF;
+        buffer[3] = (unsigned char)((uint64_t)length >> 48) & 0xFF;
+        buffer[4] = (unsigned char)((uint64_t)length >> 40) & 0xFF;
+        buffer[5] = (unsigned char)((uint64_t)length >> 32) & 0xFF;
+        buffer[6] = (unsigned char)((uint64_t)length >> 24) & 0xFF;
+        buffer[7] = (unsigned char)((uint64_t)length >> 16) & 0xFF;
+        buffer[8] = (unsigned char)((uint64_t)length >> 8) & 0xFF;
+        buffer[9] = (unsigned char)(length & 0xFF);
+    }
+    else if (length > 125)
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_019: [ If 126, the following 2 bytes interpreted as a 16-bit unsigned integer are the payload length. ]*/
+        buffer[1] = 126;
+
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_021: [ Multibyte length quantities are expressed in network byte order. ]*/
+        buffer[2] = (unsigned char)(length >> 8);
+        buffer[3] = (unsigned char)(length & 0xFF);
+    }
+    else
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_043: [ if 0-125, that is the payload length. ]*/
+        buffer[1] = (unsigned char)length;
+    }
+
+    if (is_masked)
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_015: [ Defines whether the "Payload data" is masked. ]*/
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_033: [ A masked frame MUST have the field frame-masked set to 1, as defined in Section 5.2. ]*/
+        buffer[1] |= 0x80;
+
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_053: [ In order to obtain a 32 bit value for masking, RANDOM_generate shall be used 4 times (for each byte). ]*/
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_016: [ If set to 1, a masking key is present in masking-key, and this is used to unmask the "Payload data" as per Section 5.3. ]*/
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_026: [ This field is present if the mask bit is set to 1 and is absent if the mask bit is set to 0. ]*/
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_034: [ The masking key is contained completely within the frame, as defined in Section 5.2 as frame-masking-key. ]*/
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_036: [ The masking key is a 32-bit value chosen at random by the client. ]*/
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_037: [ When preparing a masked frame, the client MUST pick a fresh masking key from the set of allowed 32-bit values. ]*/
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_038: [ The masking key needs to be unpredictable; thus, the masking key MUST be derived from a strong source of entropy, and the masking key for a given frame MUST NOT make it simple for a server/proxy to predict the masking key for a subsequent frame. ]*/
+        buffer[header_bytes - 4] = (unsigned char)RANDOM_generate();
+        buffer[header_bytes - 3] = (unsigned char)RANDOM_generate();
+        buffer[header_bytes - 2] = (unsigned char)RANDOM_generate();
+        buffer[header_bytes - 1] = (unsigned char)RANDOM_generate();
+    }
+}
+
+static void write_frame(unsigned char* buffer, size_t header_bytes, WS_FRAME_TYPE opcode, const unsigned char* payload, size_t length, bool is_masked, bool is_final, unsigned char reserved)
+{
+    write_header(buffer, header_bytes, opcode, length, is_masked, is_final, reserved);
+
+    if (length > 0)
+    {
+        if (is_masked)
+        {
+            /* Codes_SRS_UWS_FRAME_ENCODER_01_035: [ It is used to mask the "Payload data" defined in the same section as frame-payload-data, which includes "Extension data" and "Application data". ]*/
+            /* Codes_SRS_UWS_FRAME_ENCODER_01_039: [ To convert masked data into unmasked data, or vice versa, the following algorithm is applied. ]*/
+            /* Codes_SRS_UWS_FRAME_ENCODER_01_040: [ The same algorithm applies regardless of the direction of the translation, e.g., the same steps are applied to mask the data as to unmask the data. ]*/
+            mask_bytes(buffer + header_bytes, payload, length, buffer + header_bytes - 4);
+        }
+        else
+        {
+            (void)memcpy(buffer + header_bytes, payload, length);
+        }
+    }
+}
+
 
 BUFFER_HANDLE uws_frame_encoder_encode(WS_FRAME_TYPE opcode, const unsigned char* payload, size_t length, bool is_masked, bool is_final, unsigned char reserved)
 {
@@ -36,8 +240,8 @@ BUFFER_HANDLE uws_frame_encoder_encode(WS_FRAME_TYPE opcode, const unsigned char
     }
     else
     {
-        size_t needed_bytes = 2;
         size_t header_bytes;
+        size_t needed_bytes;
 
         /* Codes_SRS_UWS_FRAME_ENCODER_01_044: [ On success uws_frame_encoder_encode shall return a non-NULL handle to the result buffer. ]*/
         /* Codes_SRS_UWS_FRAME_ENCODER_01_048: [ The newly created buffer shall be created by calling BUFFER_new. ]*/
@@ -50,22 +254,8 @@ BUFFER_HANDLE uws_frame_encoder_encode(WS_FRAME_TYPE opcode, const unsigned char
         else
         {
             /* Codes_SRS_UWS_FRAME_ENCODER_01_001: [ uws_frame_encoder_encode shall encode the information given in opcode, payload, length, is_masked, is_final and reserved according to the RFC6455 into a new buffer.]*/
-            if (length > 65535)
-            {
-                needed_bytes += 8;
-            }
-            else if (length > 125)
-            {
-                needed_bytes += 2;
-            }
-
-            if (is_masked)
-            {
-                needed_bytes += 4;
-            }
-
-            header_bytes = needed_bytes;
-            needed_bytes += length;
+            header_bytes = get_header_size(length, is_masked);
+            needed_bytes = header_bytes + length;
 
             /* Codes_SRS_UWS_FRAME_ENCODER_01_046: [ The result buffer shall be resized accordingly using BUFFER_enlarge. ]*/
             if (BUFFER_enlarge(result, needed_bytes) != 0)
@@ -88,99 +278,7 @@ BUFFER_HANDLE uws_frame_encoder_encode(WS_FRAME_TYPE opcode, const unsigned char
                 }
                 else
                 {
-                    /* Codes_SRS_UWS_FRAME_ENCODER_01_007: [ *  %x0 denotes a continuation frame ]*/
-                    /* Codes_SRS_UWS_FRAME_ENCODER_01_008: [ *  %x1 denotes a text frame ]*/
-                    /* Codes_SRS_UWS_FRAME_ENCODER_01_009: [ *  %x2 denotes a binary frame ]*/
-                    /* Codes_SRS_UWS_FRAME_ENCODER_01_010: [ *  %x3-7 are reserved for further non-control frames ]*/
-                    /* Codes_SRS_UWS_FRAME_ENCODER_01_011: [ *  %x8 denotes a connection close ]*/
-                    /* Codes_SRS_UWS_FRAME_ENCODER_01_012: [ *  %x9 denotes a ping ]*/
-                    /* Codes_SRS_UWS_FRAME_ENCODER_01_013: [ *  %xA denotes a pong ]*/
-                    /* Codes_SRS_UWS_FRAME_ENCODER_01_014: [ *  %xB-F are reserved for further control frames ]*/
-                    buffer[0] = (unsigned char)opcode;
-
-                    /* Codes_SRS_UWS_FRAME_ENCODER_01_002: [ Indicates that this is the final fragment in a message. ]*/
-                    /* Codes_SRS_UWS_FRAME_ENCODER_01_003: [ The first fragment MAY also be the final fragment. ]*/
-                    if (is_final)
-                    {
-                        buffer[0] |= 0x80;
-                    }
-
-                    /* Codes_SRS_UWS_FRAME_ENCODER_01_004: [ MUST be 0 unless an extension is negotiated that defines meanings for non-zero values. ]*/
-                    buffer[0] |= reserved << 4;
-
-                    /* Codes_SRS_UWS_FRAME_ENCODER_01_022: [ Note that in all cases, the minimal number of bytes MUST be used to encode the length, for example, the length of a 124-byte-long string can't be encoded as the sequence 126, 0, 124. ]*/
-                    /* Codes_SRS_UWS_FRAME_ENCODER_01_018: [ The length of the "Payload data", in bytes: ]*/
-                    /* Codes_SRS_UWS_FRAME_ENCODER_01_023: [ The payload length is the length of the "Extension data" + the length of the "Application data". ]*/
-                    /* Codes_SRS_UWS_FRAME_ENCODER_01_042: [ The payload length, indicated in the framing as frame-payload-length, does NOT include the length of the masking key. ]*/
-                    if (length > 65535)
-                    {
-                        /* Codes_SRS_UWS_FRAME_ENCODER_01_020: [ If 127, the following 8 bytes interpreted as a 64-bit unsigned integer (the most significant bit MUST be 0) are the payload length. ]*/
-                        buffer[1] = 127;
-
-                        /* Codes_SRS_UWS_FRAME_ENCODER_01_021: [ Multibyte length quantities are expressed in network byte order. ]*/
-                        buffer[2] = (unsigned char)((uint64_t)length >> 56) & 0xFF;
-                        buffer[3] = (unsigned char)((uint64_t)length >> 48) & 0xFF;
-                        buffer[4] = (unsigned char)((uint64_t)length >> 40) & 0xFF;
-                        buffer[5] = (unsigned char)((uint64_t)length >> 32) & 0xFF;
-                        buffer[6] = (unsigned char)((uint64_t)length >> 24) & 0xFF;
-                        buffer[7] = (unsigned char)((uint64_t)length >> 16) & 0xFF;
-                        buffer[8] = (unsigned char)((uint64_t)length >> 8) & 0xFF;
-                        buffer[9] = (unsigned char)(length & 0xFF);
-                    }
-                    else if (length > 125)
-                    {
-                        /* Codes_SRS_UWS_FRAME_ENCODER_01_019: [ If 126, the following 2 bytes interpreted as a 16-bit unsigned integer are the payload length. ]*/
-                        buffer[1] = 126;
-
-                        /* Codes_SRS_UWS_FRAME_ENCODER_01_021: [ Multibyte length quantities are expressed in network byte order. ]*/
-                        buffer[2] = (unsigned char)(length >> 8);
-                        buffer[3] = (unsigned char)(length & 0xFF);
-                    }
-                    else
-                    {
-                        /* Codes_SRS_UWS_FRAME_ENCODER_01_043: [ if 0-125, that is the payload length. ]*/
-                        buffer[1] = (unsigned char)length;
-                    }
-
-                    if (is_masked)
-                    {
-                        /* Codes_SRS_UWS_FRAME_ENCODER_01_015: [ Defines whether the "Payload data" is masked. ]*/
-                        /* Codes_SRS_UWS_FRAME_ENCODER_01_033: [ A masked frame MUST have the field frame-masked set to 1, as defined in Section 5.2. ]*/
-                        buffer[1] |= 0x80;
-
-                        /* Codes_SRS_UWS_FRAME_ENCODER_01_053: [ In order to obtain a 32 bit value for masking, RANDOM_generate shall be used 4 times (for each byte). ]*/
-                        /* Codes_SRS_UWS_FRAME_ENCODER_01_016: [ If set to 1, a masking key is present in masking-key, and this is used to unmask the "Payload data" as per Section 5.3. ]*/
-                        /* Codes_SRS_UWS_FRAME_ENCODER_01_026: [ This field is present if the mask bit is set to 1 and is absent if the mask bit is set to 0. ]*/
-                        /* Codes_SRS_UWS_FRAME_ENCODER_01_034: [ The masking key is contained completely within the frame, as defined in Section 5.2 as frame-masking-key. ]*/
-                        /* Codes_SRS_UWS_FRAME_ENCODER_01_036: [ The masking key is a 32-bit value chosen at random by the client. ]*/
-                        /* Codes_SRS_UWS_FRAME_ENCODER_01_037: [ When preparing a masked frame, the client MUST pick a fresh masking key from the set of allowed 32-bit values. ]*/
-                        /* Codes_SRS_UWS_FRAME_ENCODER_01_038: [ The masking key needs to be unpredictable; thus, the masking key MUST be derived from a strong source of entropy, and the masking key for a given frame MUST NOT make it simple for a server/proxy to predict the masking key for a subsequent frame. ]*/
-                        buffer[header_bytes - 4] = (unsigned char)RANDOM_generate();
-                        buffer[header_bytes - 3] = (unsigned char)RANDOM_generate();
-                        buffer[header_bytes - 2] = (unsigned char)RANDOM_generate();
-                        buffer[header_bytes - 1] = (unsigned char)RANDOM_generate();
-                    }
-
-                    if (length > 0)
-                    {
-                        if (is_masked)
-                        {
-                            size_t i;
-
-                            /* Codes_SRS_UWS_FRAME_ENCODER_01_035: [ It is used to mask the "Payload data" defined in the same section as frame-payload-data, which includes "Extension data" and "Application data". ]*/
-                            /* Codes_SRS_UWS_FRAME_ENCODER_01_039: [ To convert masked data into unmasked data, or vice versa, the following algorithm is applied. ]*/
-                            /* Codes_SRS_UWS_FRAME_ENCODER_01_040: [ The same algorithm applies regardless of the direction of the translation, e.g., the same steps are applied to mask the data as to unmask the data. ]*/
-                            for (i = 0; i < length; i++)
-                            {
-                                /* Codes_SRS_UWS_FRAME_ENCODER_01_041: [ Octet i of the transformed data ("transformed-octet-i") is the XOR of octet i of the original data ("original-octet-i") with octet at index i modulo 4 of the masking key ("masking-key-octet-j"): ]*/
-                                buffer[header_bytes + i] = ((unsigned char*)payload)[i] ^ buffer[header_bytes - 4 + (i % 4)];
-                            }
-                        }
-                        else
-                        {
-                            (void)memcpy(buffer + header_bytes, payload, length);
-                        }
-                    }
+                    write_frame(buffer, header_bytes, opcode, payload, length, is_masked, is_final, reserved);
                 }
             }
         }
@@ -188,3 +286,111 @@ BUFFER_HANDLE uws_frame_encoder_encode(WS_FRAME_TYPE opcode, const unsigned char
 
     return result;
 }
+
+size_t uws_frame_encoder_get_header_size(size_t length, bool is_masked)
+{
+    /* Codes_SRS_UWS_FRAME_ENCODER_01_055: [ uws_frame_encoder_get_header_size shall return the number of bytes of the header of a frame with length bytes of payload: 2 bytes, plus 2 if length is between 126 and 65535, plus 8 if length is greater than 65535, plus 4 if is_masked is true. ]*/
+    return get_header_size(length, is_masked);
+}
+
+int uws_frame_encoder_encode_header(unsigned char* header, size_t header_size, WS_FRAME_TYPE opcode, size_t length, bool is_masked, bool is_final, unsigned char reserved)
+{
+    int result;
+    size_t header_bytes = get_header_size(length, is_masked);
+
+    if (header == NULL)
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_057: [ If header is NULL, uws_frame_encoder_encode_header shall fail and return a non-zero value. ]*/
+        LogError("NULL header");
+        result = MU_FAILURE;
+    }
+    else if (header_size < header_bytes)
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_058: [ If header_size is smaller than the size returned by uws_frame_encoder_get_header_size for length and is_masked, uws_frame_encoder_encode_header shall fail and return a non-zero value. ]*/
+        LogError("Header size %u is too small, %u bytes are needed", (unsigned int)header_size, (unsigned int)header_bytes);
+        result = MU_FAILURE;
+    }
+    else if (reserved > 7)
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_059: [ If reserved has any bits set except the lowest 3 or opcode is greater than 0x0F, uws_frame_encoder_encode_header shall fail and return a non-zero value. ]*/
+        LogError("Bad reserved value: 0x%02x", reserved);
+        result = MU_FAILURE;
+    }
+    else if (opcode > 0x0F)
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_059: [ If reserved has any bits set except the lowest 3 or opcode is greater than 0x0F, uws_frame_encoder_encode_header shall fail and return a non-zero value. ]*/
+        LogError("Invalid opcode: 0x%02x", opcode);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_056: [ uws_frame_encoder_encode_header shall write in header the header of a frame with length bytes of payload, encoded like uws_frame_encoder_encode does, and return 0. ]*/
+        write_header(header, header_bytes, opcode, length, is_masked, is_final, reserved);
+        result = 0;
+    }
+
+    return result;
+}
+
+int uws_frame_encoder_encode_into(unsigned char* destination, size_t destination_size, WS_FRAME_TYPE opcode, const unsigned char* payload, size_t length, bool is_masked, bool is_final, unsigned char reserved)
+{
+    int result;
+    size_t header_bytes = get_header_size(length, is_masked);
+    size_t needed_bytes = safe_add_size_t(header_bytes, length);
+
+    if (destination == NULL)
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_061: [ If destination is NULL, uws_frame_encoder_encode_into shall fail and return a non-zero value. ]*/
+        LogError("NULL destination");
+        result = MU_FAILURE;
+    }
+    else if ((length > 0) &&
+        (payload == NULL))
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_062: [ If length is greater than 0 and payload is NULL, then uws_frame_encoder_encode_into shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: NULL payload and length=%u", (unsigned int)length);
+        result = MU_FAILURE;
+    }
+    else if ((needed_bytes == SIZE_MAX) ||
+        (destination_size < needed_bytes))
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_063: [ If destination_size is smaller than the header size returned by uws_frame_encoder_get_header_size plus length, uws_frame_encoder_encode_into shall fail and return a non-zero value. ]*/
+        LogError("Destination size %u is too small for a frame with %u bytes of payload", (unsigned int)destination_size, (unsigned int)length);
+        result = MU_FAILURE;
+    }
+    else if (reserved > 7)
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_064: [ If reserved has any bits set except the lowest 3 or opcode is greater than 0x0F, uws_frame_encoder_encode_into shall fail and return a non-zero value. ]*/
+        LogError("Bad reserved value: 0x%02x", reserved);
+        result = MU_FAILURE;
+    }
+    else if (opcode > 0x0F)
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_064: [ If reserved has any bits set except the lowest 3 or opcode is greater than 0x0F, uws_frame_encoder_encode_into shall fail and return a non-zero value. ]*/
+        LogError("Invalid opcode: 0x%02x", opcode);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_060: [ uws_frame_encoder_encode_into shall write in destination the frame that uws_frame_encoder_encode would return for the same arguments and return 0. ]*/
+        write_frame(destination, header_bytes, opcode, payload, length, is_masked, is_final, reserved);
+        result = 0;
+    }
+
+    return result;
+}
+
+void uws_frame_encoder_mask(unsigned char* destination, const unsigned char* source, size_t length, const unsigned char* masking_key)
+{
+    if ((length > 0) &&
+        ((destination == NULL) || (source == NULL) || (masking_key == NULL)))
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_066: [ If length is greater than 0 and any of destination, source or masking_key is NULL, uws_frame_encoder_mask shall return without writing anything. ]*/
+        LogError("Invalid arguments: destination=%p, source=%p, masking_key=%p, length=%u", destination, source, masking_key, (unsigned int)length);
+    }
+    else if (length > 0)
+    {
+        /* Codes_SRS_UWS_FRAME_ENCODER_01_065: [ uws_frame_encoder_mask shall write in destination each byte i of source XORed with byte i modulo 4 of masking_key. ]*/
+        mask_bytes(destination, source, length, masking_key);
+    }
+}
@@ -633,6 +633,76 @@ int wsio_send(CONCRETE_IO_HANDLE ws_io, const void* buffer, size_t size, ON_SEND
     return result;
 }
 
+int wsio_send_array(CONCRETE_IO_HANDLE ws_io, CONSTBUFFER_ARRAY_HANDLE buffers, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    int result;
+
+    if ((ws_io == NULL) ||
+        (buffers == NULL))
+    {
+        /* Codes_SRS_WSIO_04_001: [ If any of the arguments ws_io or buffers are NULL, wsio_send_array shall fail and return a non-zero value. ]*/
+        LogError("Bad arguments: ws_io=%p, buffers=%p", ws_io, buffers);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        WSIO_INSTANCE* wsio_instance = (WSIO_INSTANCE*)ws_io;
+
+        if (wsio_instance->io_state != IO_STATE_OPEN)
+        {
+            /* Codes_SRS_WSIO_04_002: [ If the wsio is not OPEN then wsio_send_array shall fail and return a non-zero value. ]*/
+            LogError("Attempting to send when not open");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            LIST_ITEM_HANDLE new_item;
+            PENDING_IO* pending_socket_io = (PENDING_IO*)malloc(sizeof(PENDING_IO));
+            if (pending_socket_io == NULL)
+            {
+                /* Codes_SRS_WSIO_04_003: [ If allocating memory for the pending IO data fails, wsio_send_array shall fail and return a non-zero value. ]*/
+                LogError("Cannot allocate memory for pending IO");
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /* Codes_SRS_WSIO_04_004: [ wsio_send_array shall queue an entry containing the on_send_complete callback and its context by calling singlylinkedlist_add. ]*/
+                pending_socket_io->on_send_complete = on_send_complete;
+                pending_socket_io->callback_context = callback_context;
+                pending_socket_io->wsio = wsio_instance;
+
+                if ((new_item = singlylinkedlist_add(wsio_instance->pending_io_list, pending_socket_io)) == NULL)
+                {
+                    /* Codes_SRS_WSIO_04_005: [ If singlylinkedlist_add fails, wsio_send_array shall fail and return a non-zero value. ]*/
+                    LogError("Cannot queue pending IO");
+                    free(pending_socket_io);
+                    result = MU_FAILURE;
+                }
+                /* Codes_SRS_WSIO_04_006: [ wsio_send_array shall call uws_client_send_frame_array_async, passing buffers, the frame type WS_FRAME_TYPE_BINARY and is_final set to true. ]*/
+                else if (uws_client_send_frame_array_async(wsio_instance->uws, WS_FRAME_TYPE_BINARY, buffers, true, on_underlying_ws_send_frame_complete, new_item) != 0)
+                {
+                    /* Codes_SRS_WSIO_04_007: [ If uws_client_send_frame_array_async fails, wsio_send_array shall remove the queued entry and return a non-zero value. ]*/
+                    LogError("uws_client_send_frame_array_async failed");
+                    if (singlylinkedlist_remove(wsio_instance->pending_io_list, new_item) != 0)
+                    {
+                        LogError("Failed removing pending IO from linked list.");
+                    }
+
+                    free(pending_socket_io);
+                    result = MU_FAILURE;
+                }
+                else
+                {
+                    /* Codes_SRS_WSIO_04_008: [ On success, wsio_send_array shall return 0. ]*/
+                    result = 0;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
 void wsio_dowork(CONCRETE_IO_HANDLE ws_io)
 {
     if (ws_io == NULL)
@@ -821,7 +891,8 @@ static const IO_INTERFACE_DESCRIPTION ws_io_interface_description =
     wsio_close,
     wsio_send,
     wsio_dowork,
-    wsio_setoption
+    wsio_setoption,
+    wsio_send_array
 };
 
 const IO_INTERFACE_DESCRIPTION* wsio_get_interface_description(void)
@@ -2,6 +2,8 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xio.h"
@@ -153,6 +155,92 @@ int xio_send(XIO_HANDLE xio, const void* buffer, size_t size, ON_SEND_COMPLETE o
     return result;
 }
 
+int xio_send_array(XIO_HANDLE xio, CONSTBUFFER_ARRAY_HANDLE buffers, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    int result;
+
+    /* Codes_SRS_XIO_04_001: [If xio or buffers is NULL, xio_send_array shall return a non-zero value.] */
+    if ((xio == NULL) ||
+        (buffers == NULL))
+    {
+        LogError("Invalid arguments: XIO_HANDLE xio=%p, CONSTBUFFER_ARRAY_HANDLE buffers=%p", xio, buffers);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        XIO_INSTANCE* xio_instance = (XIO_INSTANCE*)xio;
+
+        if (xio_instance->io_interface_description->concrete_io_send_array != NULL)
+        {
+            /* Codes_SRS_XIO_04_002: [If the concrete IO implementation has a concrete_io_send_array function, xio_send_array shall call it, passing down buffers, on_send_complete and callback_context.] */
+            /* Codes_SRS_XIO_04_009: [On success, xio_send_array shall return 0.] */
+            /* Codes_SRS_XIO_04_003: [If concrete_io_send_array or concrete_io_send fails, xio_send_array shall return a non-zero value.] */
+            result = xio_instance->io_interface_description->concrete_io_send_array(xio_instance->concrete_xio_handle, buffers, on_send_complete, callback_context);
+        }
+        else
+        {
+            uint32_t buffer_count;
+            uint32_t all_buffers_size;
+
+            /* Codes_SRS_XIO_04_004: [Otherwise xio_send_array shall get the number of buffers and their total size by calling constbuffer_array_get_buffer_count and constbuffer_array_get_all_buffers_size.] */
+            if (constbuffer_array_get_buffer_count(buffers, &buffer_count) != 0)
+            {
+                /* Codes_SRS_XIO_04_008: [If any other operation fails, xio_send_array shall return a non-zero value.] */
+                LogError("failure in constbuffer_array_get_buffer_count(buffers=%p, &buffer_count)", buffers);
+                result = MU_FAILURE;
+            }
+            else if (constbuffer_array_get_all_buffers_size(buffers, &all_buffers_size) != 0)
+            {
+                /* Codes_SRS_XIO_04_008: [If any other operation fails, xio_send_array shall return a non-zero value.] */
+                LogError("failure in constbuffer_array_get_all_buffers_size(buffers=%p, &all_buffers_size)", buffers);
+                result = MU_FAILURE;
+            }
+            else if (all_buffers_size == 0)
+            {
+                /* Codes_SRS_XIO_04_010: [If the total size of the buffers is 0, xio_send_array shall return a non-zero value.] */
+                LogError("nothing to send in buffers=%p", buffers);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /* Codes_SRS_XIO_04_005: [xio_send_array shall allocate all_buffers_size bytes and copy the content of the buffers one after the other in them.] */
+                unsigned char* bytes = (unsigned char*)malloc(all_buffers_size);
+                if (bytes == NULL)
+                {
+                    /* Codes_SRS_XIO_04_008: [If any other operation fails, xio_send_array shall return a non-zero value.] */
+                    LogError("failure in malloc(all_buffers_size=%" PRIu32 ")", all_buffers_size);
+                    result = MU_FAILURE;
+                }
+                else
+                {
+                    uint32_t i;
+                    size_t position = 0;
+
+                    for (i = 0; i < buffer_count; i++)
+                    {
+                        const CONSTBUFFER* content = constbuffer_array_get_buffer_content(buffers, i);
+                        if (content->size > 0)
+                        {
+                            (void)memcpy(bytes + position, content->buffer, content->size);
+                            position += content->size;
+                        }
+                    }
+
+                    /* Codes_SRS_XIO_04_006: [xio_send_array shall send the copied bytes by calling concrete_io_send, passing down on_send_complete and callback_context.] */
+                    /* Codes_SRS_XIO_04_009: [On success, xio_send_array shall return 0.] */
+                    /* Codes_SRS_XIO_04_003: [If concrete_io_send_array or concrete_io_send fails, xio_send_array shall return a non-zero value.] */
+                    result = xio_instance->io_interface_description->concrete_io_send(xio_instance->concrete_xio_handle, bytes, all_buffers_size, on_send_complete, callback_context);
+
+                    /* Codes_SRS_XIO_04_007: [xio_send_array shall free the copied bytes.] */
+                    free(bytes);
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
 void xio_dowork(XIO_HANDLE xio)
 {
     /* Codes_SRS_XIO_01_018: [When the handle argument is NULL, xio_dowork shall do nothing.] */
@@ -0,0 +1,199 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+#include "azure_c_shared_utility/azure_base64.h"
+#include "azure_c_shared_utility/strings.h"
+#include "azure_c_shared_utility/buffer_.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#include "perf_measure.h"
+
+/*every size encodes or decodes about this many bytes in the timed run*/
+#define AZURE_BASE64_PERF_BYTES_PER_RUN (256 * 1024 * 1024)
+
+static TEST_MUTEX_HANDLE g_testByTest;
+
+typedef struct AZURE_BASE64_PERF_CONTEXT_TAG
+{
+    unsigned char* data;
+    size_t size;
+    char* encoded;
+    size_t encoded_length;
+    unsigned char* decoded;
+} AZURE_BASE64_PERF_CONTEXT;
+
+static void encode_into(void* context, size_t iteration)
+{
+    AZURE_BASE64_PERF_CONTEXT* perf_context = (AZURE_BASE64_PERF_CONTEXT*)context;
+    (void)iteration;
+    if (Azure_Base64_Encode_Bytes_Into(perf_context->data, perf_context->size, perf_context->encoded, perf_context->encoded_length + 1) != 0)
+    {
+        ASSERT_FAIL("Azure_Base64_Encode_Bytes_Into failed");
+    }
+}
+
+static void encode_bytes(void* context, size_t iteration)
+{
+    AZURE_BASE64_PERF_CONTEXT* perf_context = (AZURE_BASE64_PERF_CONTEXT*)context;
+    STRING_HANDLE encoded = Azure_Base64_Encode_Bytes(perf_context->data, perf_context->size);
+    (void)iteration;
+    if (encoded == NULL)
+    {
+        ASSERT_FAIL("Azure_Base64_Encode_Bytes failed");
+    }
+    STRING_delete(encoded);
+}
+
+static void decode_into(void* context, size_t iteration)
+{
+    AZURE_BASE64_PERF_CONTEXT* perf_context = (AZURE_BASE64_PERF_CONTEXT*)context;
+    size_t decoded_size;
+    (void)iteration;
+    if (Azure_Base64_Decode_Into(perf_context->encoded, perf_context->encoded_length, perf_context->decoded, perf_context->size, &decoded_size) != 0)
+    {
+        ASSERT_FAIL("Azure_Base64_Decode_Into failed");
+    }
+}
+
+static void decode(void* context, size_t iteration)
+{
+    AZURE_BASE64_PERF_CONTEXT* perf_context = (AZURE_BASE64_PERF_CONTEXT*)context;
+    BUFFER_HANDLE decoded = Azure_Base64_Decode(perf_context->encoded);
+    (void)iteration;
+    if (decoded == NULL)
+    {
+        ASSERT_FAIL("Azure_Base64_Decode failed");
+    }
+    BUFFER_delete(decoded);
+}
+
+static void create_context(AZURE_BASE64_PERF_CONTEXT* perf_context, size_t size)
+{
+    size_t i;
+    perf_context->size = size;
+    perf_context->encoded_length = Azure_Base64_Encoded_Length(size);
+    perf_context->data = (unsigned char*)malloc(size);
+    ASSERT_IS_NOT_NULL(perf_context->data);
+    perf_context->encoded = (char*)malloc(perf_context->encoded_length + 1);
+    ASSERT_IS_NOT_NULL(perf_context->encoded);
+    perf_context->decoded = (unsigned char*)malloc(size);
+    ASSERT_IS_NOT_NULL(perf_context->decoded);
+
+    for (i = 0; i < size; i++)
+    {
+        perf_context->data[i] = (unsigned char)(i * 131 + (i >> 8));
+    }
+    ASSERT_ARE_EQUAL(int, 0, Azure_Base64_Encode_Bytes_Into(perf_context->data, size, perf_context->encoded, perf_context->encoded_length + 1));
+}
+
+static void destroy_context(AZURE_BASE64_PERF_CONTEXT* perf_context)
+{
+    free(perf_context->data);
+    free(perf_context->encoded);
+    free(perf_context->decoded);
+}
+
+static PERF_MEASURE_RESULT run(const char* operation_name, PERF_MEASURE_OPERATION operation, size_t size)
+{
+    char name[96];
+    AZURE_BASE64_PERF_CONTEXT perf_context;
+    PERF_MEASURE_RESULT result;
+    create_context(&perf_context, size);
+    (void)sprintf(name, "%s (%u bytes)", operation_name, (unsigned int)size);
+
+    ///act
+    result = perf_measure_run(name, operation, &perf_context, AZURE_BASE64_PERF_BYTES_PER_RUN / size);
+
+    ///assert
+    /*bytes per ns are GB/s, counted on the decoded side for both directions*/
+    LogInfo("%s: %.2f GB/s", name, (double)size / result.ns_per_op);
+
+    destroy_context(&perf_context);
+    return result;
+}
+
+static void run_sizes(const char* operation_name, PERF_MEASURE_OPERATION operation, double expected_allocations_per_op)
+{
+    static const size_t sizes[] = { 48, 1024, 64 * 1024, 1024 * 1024 };
+    size_t i;
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        PERF_MEASURE_RESULT result = run(operation_name, operation, sizes[i]);
+        ASSERT_IS_TRUE(result.allocations_per_op == expected_allocations_per_op);
+    }
+}
+
+BEGIN_TEST_SUITE(azure_base64_perf)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+TEST_FUNCTION(azure_base64_roundtrip_is_lossless)
+{
+    ///arrange
+    AZURE_BASE64_PERF_CONTEXT perf_context;
+    size_t decoded_size;
+    create_context(&perf_context, 1024 * 1024 + 1);
+
+    ///act
+    ASSERT_ARE_EQUAL(int, 0, Azure_Base64_Decode_Into(perf_context.encoded, perf_context.encoded_length, perf_context.decoded, perf_context.size, &decoded_size));
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, perf_context.size, decoded_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(perf_context.data, perf_context.decoded, decoded_size));
+
+    ///cleanup
+    destroy_context(&perf_context);
+}
+
+TEST_FUNCTION(azure_base64_encode_perf)
+{
+    /*the caller buffer versions do not allocate, the STRING_HANDLE owns one allocation for the characters and one for itself*/
+    run_sizes("Azure_Base64_Encode_Bytes_Into", encode_into, 0.0);
+    run_sizes("Azure_Base64_Encode_Bytes", encode_bytes, 2.0);
+}
+
+TEST_FUNCTION(azure_base64_decode_perf)
+{
+    run_sizes("Azure_Base64_Decode_Into", decode_into, 0.0);
+    run_sizes("Azure_Base64_Decode", decode, 2.0);
+}
+
+END_TEST_SUITE(azure_base64_perf)
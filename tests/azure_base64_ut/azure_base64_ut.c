@@ -5,10 +5,12 @@
 #include <cstdlib>
 #include <cstddef>
 #include <cstring>
+#include <cstdint>
 #else
 #include <stdlib.h>
 #include <stddef.h>
 #include <string.h>
+#include <stdint.h>
 #endif
 
 #include "macro_utils/macro_utils.h"
@@ -1475,6 +1477,23 @@ static const struct
 
     };
 
+/*the bytes 0, 1, ..., 191 encoded: long enough for the vectorized code to process several blocks*/
+#define LONG_TEST_VECTOR_SIZE 192
+static const char* longTestVector_expectedOutput =
+    "AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8gISIjJCUmJygpKissLS4v"
+    "MDEyMzQ1Njc4OTo7PD0+P0BBQkNERUZHSElKS0xNTk9QUVJTVFVWV1hZWltcXV5f"
+    "YGFiY2RlZmdoaWprbG1ub3BxcnN0dXZ3eHl6e3x9fn+AgYKDhIWGh4iJiouMjY6P"
+    "kJGSk5SVlpeYmZqbnJ2en6ChoqOkpaanqKmqq6ytrq+wsbKztLW2t7i5uru8vb6/";
+
+static void fill_long_test_vector(unsigned char* data)
+{
+    size_t i;
+    for (i = 0; i < LONG_TEST_VECTOR_SIZE; i++)
+    {
+        data[i] = (unsigned char)i;
+    }
+}
+
     static TEST_MUTEX_HANDLE g_testByTest;
 
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
@@ -1807,5 +1826,403 @@ TEST_FUNCTION(Azure_Base64_Decode_invalid_length_fails_6)
 
 }
 
+/*Tests_SRS_BASE64_04_001: [If the source string has a character that is not in the base64 alphabet or misplaced padding then Azure_Base64_Decode shall return NULL.]*/
+TEST_FUNCTION(Azure_Base64_Decode_with_invalid_character_fails)
+{
+    ///arrange
+    BUFFER_HANDLE result;
+
+    ///act
+    result = Azure_Base64_Decode("QUJD*EVG");
+
+    ///assert
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_BASE64_04_001: [If the source string has a character that is not in the base64 alphabet or misplaced padding then Azure_Base64_Decode shall return NULL.]*/
+TEST_FUNCTION(Azure_Base64_Decode_with_padding_in_the_middle_fails)
+{
+    ///arrange
+    BUFFER_HANDLE result;
+
+    ///act
+    result = Azure_Base64_Decode("QQ==QUJD");
+
+    ///assert
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_BASE64_04_001: [If the source string has a character that is not in the base64 alphabet or misplaced padding then Azure_Base64_Decode shall return NULL.]*/
+TEST_FUNCTION(Azure_Base64_Decode_with_padding_before_a_character_fails)
+{
+    ///arrange
+    BUFFER_HANDLE result;
+
+    ///act
+    result = Azure_Base64_Decode("QQ=A");
+
+    ///assert
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_BASE64_04_001: [If the source string has a character that is not in the base64 alphabet or misplaced padding then Azure_Base64_Decode shall return NULL.]*/
+TEST_FUNCTION(Azure_Base64_Decode_with_invalid_character_in_a_long_string_fails)
+{
+    ///arrange
+    char* source = (char*)malloc(strlen(longTestVector_expectedOutput) + 1);
+    size_t i;
+    ASSERT_IS_NOT_NULL(source);
+    (void)strcpy(source, longTestVector_expectedOutput);
+
+    for (i = 0; i < strlen(longTestVector_expectedOutput); i++)
+    {
+        BUFFER_HANDLE result;
+        source[i] = '.';
+
+        ///act
+        result = Azure_Base64_Decode(source);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+
+        source[i] = longTestVector_expectedOutput[i];
+    }
+
+    ///cleanup
+    free(source);
+}
+
+TEST_FUNCTION(Azure_Base64_Encode_Bytes_long_succeeds)
+{
+    ///arrange
+    unsigned char data[LONG_TEST_VECTOR_SIZE];
+    STRING_HANDLE result;
+    fill_long_test_vector(data);
+
+    ///act
+    result = Azure_Base64_Encode_Bytes(data, sizeof(data));
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, longTestVector_expectedOutput, STRING_c_str(result));
+
+    ///cleanup
+    STRING_delete(result);
+}
+
+TEST_FUNCTION(Azure_Base64_Decode_long_succeeds)
+{
+    ///arrange
+    unsigned char data[LONG_TEST_VECTOR_SIZE];
+    BUFFER_HANDLE result;
+    fill_long_test_vector(data);
+
+    ///act
+    result = Azure_Base64_Decode(longTestVector_expectedOutput);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, sizeof(data), BUFFER_length(result));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(result), data, sizeof(data)));
+
+    ///cleanup
+    BUFFER_delete(result);
+}
+
+/*Tests_SRS_BASE64_04_002: [Azure_Base64_Encoded_Length shall return 4 characters for every started group of 3 bytes in size, or SIZE_MAX if that does not fit in a size_t.]*/
+TEST_FUNCTION(Azure_Base64_Encoded_Length_succeeds)
+{
+    ///act
+    size_t result0 = Azure_Base64_Encoded_Length(0);
+    size_t result1 = Azure_Base64_Encoded_Length(1);
+    size_t result3 = Azure_Base64_Encoded_Length(3);
+    size_t result4 = Azure_Base64_Encoded_Length(4);
+    size_t result_max = Azure_Base64_Encoded_Length(SIZE_MAX);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 0, result0);
+    ASSERT_ARE_EQUAL(size_t, 4, result1);
+    ASSERT_ARE_EQUAL(size_t, 4, result3);
+    ASSERT_ARE_EQUAL(size_t, 8, result4);
+    ASSERT_ARE_EQUAL(size_t, SIZE_MAX, result_max);
+}
+
+/*Tests_SRS_BASE64_04_003: [If source is NULL then Azure_Base64_Encode_Bytes_Into shall fail and return a non-zero value.]*/
+TEST_FUNCTION(Azure_Base64_Encode_Bytes_Into_with_NULL_source_fails)
+{
+    ///arrange
+    char destination[8];
+
+    ///act
+    int result = Azure_Base64_Encode_Bytes_Into(NULL, 3, destination, sizeof(destination));
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_04_004: [If destination is NULL then Azure_Base64_Encode_Bytes_Into shall fail and return a non-zero value.]*/
+TEST_FUNCTION(Azure_Base64_Encode_Bytes_Into_with_NULL_destination_fails)
+{
+    ///act
+    int result = Azure_Base64_Encode_Bytes_Into((const unsigned char*)"abc", 3, NULL, 8);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_04_005: [If destination_size is less than Azure_Base64_Encoded_Length(size) + 1 then Azure_Base64_Encode_Bytes_Into shall fail and return a non-zero value.]*/
+TEST_FUNCTION(Azure_Base64_Encode_Bytes_Into_with_destination_without_room_for_the_terminator_fails)
+{
+    ///arrange
+    char destination[5] = "xxxx";
+
+    ///act
+    int result = Azure_Base64_Encode_Bytes_Into((const unsigned char*)"abc", 3, destination, 4);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, "xxxx", destination);
+}
+
+/*Tests_SRS_BASE64_04_006: [Otherwise Azure_Base64_Encode_Bytes_Into shall write the base64 encoding of source followed by a terminating '\0' to destination and return 0.]*/
+TEST_FUNCTION(Azure_Base64_Encode_Bytes_Into_with_zero_size_writes_an_empty_string)
+{
+    ///arrange
+    char destination[1] = { 'x' };
+
+    ///act
+    int result = Azure_Base64_Encode_Bytes_Into((const unsigned char*)"a", 0, destination, sizeof(destination));
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, "", destination);
+}
+
+/*Tests_SRS_BASE64_04_006: [Otherwise Azure_Base64_Encode_Bytes_Into shall write the base64 encoding of source followed by a terminating '\0' to destination and return 0.]*/
+TEST_FUNCTION(Azure_Base64_Encode_Bytes_Into_exhaustive_succeeds)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(testVector_BINARY_with_equal_signs) / sizeof(testVector_BINARY_with_equal_signs[0]); i++)
+    {
+        ///arrange
+        char destination[32];
+        size_t destination_size = strlen(testVector_BINARY_with_equal_signs[i].expectedOutput) + 1;
+        int result;
+
+        ///act
+        result = Azure_Base64_Encode_Bytes_Into(testVector_BINARY_with_equal_signs[i].inputData, testVector_BINARY_with_equal_signs[i].inputLength, destination, destination_size);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, testVector_BINARY_with_equal_signs[i].expectedOutput, destination);
+    }
+}
+
+/*Tests_SRS_BASE64_04_006: [Otherwise Azure_Base64_Encode_Bytes_Into shall write the base64 encoding of source followed by a terminating '\0' to destination and return 0.]*/
+TEST_FUNCTION(Azure_Base64_Encode_Bytes_Into_long_succeeds)
+{
+    ///arrange
+    unsigned char data[LONG_TEST_VECTOR_SIZE];
+    char destination[LONG_TEST_VECTOR_SIZE / 3 * 4 + 1];
+    int result;
+    fill_long_test_vector(data);
+
+    ///act
+    result = Azure_Base64_Encode_Bytes_Into(data, sizeof(data), destination, sizeof(destination));
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, longTestVector_expectedOutput, destination);
+}
+
+/*Tests_SRS_BASE64_04_007: [If source is NULL or length is not a multiple of 4 then Azure_Base64_Decoded_Length shall return 0.]*/
+TEST_FUNCTION(Azure_Base64_Decoded_Length_with_NULL_source_returns_0)
+{
+    ///act
+    size_t result = Azure_Base64_Decoded_Length(NULL, 4);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 0, result);
+}
+
+/*Tests_SRS_BASE64_04_007: [If source is NULL or length is not a multiple of 4 then Azure_Base64_Decoded_Length shall return 0.]*/
+TEST_FUNCTION(Azure_Base64_Decoded_Length_with_invalid_length_returns_0)
+{
+    ///act
+    size_t result = Azure_Base64_Decoded_Length("QUJDRA", 6);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 0, result);
+}
+
+/*Tests_SRS_BASE64_04_008: [Otherwise Azure_Base64_Decoded_Length shall return 3 bytes for every 4 characters in source, minus 1 for each padding character at its end.]*/
+TEST_FUNCTION(Azure_Base64_Decoded_Length_succeeds)
+{
+    ///act
+    size_t result0 = Azure_Base64_Decoded_Length("", 0);
+    size_t result1 = Azure_Base64_Decoded_Length("QUJDQQ==", 8);
+    size_t result2 = Azure_Base64_Decoded_Length("QUJDQUI=", 8);
+    size_t result3 = Azure_Base64_Decoded_Length("QUJDQUJD", 8);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 0, result0);
+    ASSERT_ARE_EQUAL(size_t, 4, result1);
+    ASSERT_ARE_EQUAL(size_t, 5, result2);
+    ASSERT_ARE_EQUAL(size_t, 6, result3);
+}
+
+/*Tests_SRS_BASE64_04_009: [If source is NULL then Azure_Base64_Decode_Into shall fail and return a non-zero value.]*/
+TEST_FUNCTION(Azure_Base64_Decode_Into_with_NULL_source_fails)
+{
+    ///arrange
+    unsigned char destination[3];
+    size_t decoded_size;
+
+    ///act
+    int result = Azure_Base64_Decode_Into(NULL, 4, destination, sizeof(destination), &decoded_size);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_04_010: [If destination is NULL then Azure_Base64_Decode_Into shall fail and return a non-zero value.]*/
+TEST_FUNCTION(Azure_Base64_Decode_Into_with_NULL_destination_fails)
+{
+    ///arrange
+    size_t decoded_size;
+
+    ///act
+    int result = Azure_Base64_Decode_Into("QUJD", 4, NULL, 3, &decoded_size);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_04_011: [If decoded_size is NULL then Azure_Base64_Decode_Into shall fail and return a non-zero value.]*/
+TEST_FUNCTION(Azure_Base64_Decode_Into_with_NULL_decoded_size_fails)
+{
+    ///arrange
+    unsigned char destination[3];
+
+    ///act
+    int result = Azure_Base64_Decode_Into("QUJD", 4, destination, sizeof(destination), NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_04_012: [If length is not a multiple of 4 then Azure_Base64_Decode_Into shall fail and return a non-zero value.]*/
+TEST_FUNCTION(Azure_Base64_Decode_Into_with_invalid_length_fails)
+{
+    ///arrange
+    unsigned char destination[3];
+    size_t decoded_size;
+
+    ///act
+    int result = Azure_Base64_Decode_Into("QUJ", 3, destination, sizeof(destination), &decoded_size);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_04_013: [If destination_size is less than Azure_Base64_Decoded_Length(source, length) then Azure_Base64_Decode_Into shall fail and return a non-zero value.]*/
+TEST_FUNCTION(Azure_Base64_Decode_Into_with_destination_too_small_fails)
+{
+    ///arrange
+    unsigned char destination[3];
+    size_t decoded_size;
+
+    ///act
+    int result = Azure_Base64_Decode_Into("QUJDQQ==", 8, destination, sizeof(destination), &decoded_size);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_04_014: [If length is 0 then Azure_Base64_Decode_Into shall set decoded_size to 0 and return 0.]*/
+TEST_FUNCTION(Azure_Base64_Decode_Into_with_zero_length_succeeds)
+{
+    ///arrange
+    unsigned char destination[1];
+    size_t decoded_size = 42;
+
+    ///act
+    int result = Azure_Base64_Decode_Into("", 0, destination, sizeof(destination), &decoded_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 0, decoded_size);
+}
+
+/*Tests_SRS_BASE64_04_015: [If source has a character that is not in the base64 alphabet or misplaced padding then Azure_Base64_Decode_Into shall fail and return a non-zero value.]*/
+TEST_FUNCTION(Azure_Base64_Decode_Into_with_invalid_character_fails)
+{
+    ///arrange
+    unsigned char destination[6];
+    size_t decoded_size;
+
+    ///act
+    int result = Azure_Base64_Decode_Into("QUJD QUJD", 8, destination, sizeof(destination), &decoded_size);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_04_015: [If source has a character that is not in the base64 alphabet or misplaced padding then Azure_Base64_Decode_Into shall fail and return a non-zero value.]*/
+TEST_FUNCTION(Azure_Base64_Decode_Into_with_padding_in_the_middle_fails)
+{
+    ///arrange
+    unsigned char destination[6];
+    size_t decoded_size;
+
+    ///act
+    int result = Azure_Base64_Decode_Into("QQ==QUJD", 8, destination, sizeof(destination), &decoded_size);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_04_016: [Otherwise Azure_Base64_Decode_Into shall write the decoded bytes to destination, set decoded_size to their count and return 0.]*/
+TEST_FUNCTION(Azure_Base64_Decode_Into_exhaustive_succeeds)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(testVector_BINARY_with_equal_signs) / sizeof(testVector_BINARY_with_equal_signs[0]); i++)
+    {
+        ///arrange
+        unsigned char destination[32];
+        size_t decoded_size;
+        int result;
+
+        ///act
+        result = Azure_Base64_Decode_Into(testVector_BINARY_with_equal_signs[i].expectedOutput, strlen(testVector_BINARY_with_equal_signs[i].expectedOutput),
+            destination, testVector_BINARY_with_equal_signs[i].inputLength, &decoded_size);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, testVector_BINARY_with_equal_signs[i].inputLength, decoded_size);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(destination, testVector_BINARY_with_equal_signs[i].inputData, decoded_size));
+    }
+}
+
+/*Tests_SRS_BASE64_04_016: [Otherwise Azure_Base64_Decode_Into shall write the decoded bytes to destination, set decoded_size to their count and return 0.]*/
+TEST_FUNCTION(Azure_Base64_Decode_Into_long_succeeds)
+{
+    ///arrange
+    unsigned char data[LONG_TEST_VECTOR_SIZE];
+    unsigned char destination[LONG_TEST_VECTOR_SIZE];
+    size_t decoded_size;
+    int result;
+    fill_long_test_vector(data);
+
+    ///act
+    result = Azure_Base64_Decode_Into(longTestVector_expectedOutput, strlen(longTestVector_expectedOutput), destination, sizeof(destination), &decoded_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, sizeof(data), decoded_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(destination, data, sizeof(data)));
+}
 
 END_TEST_SUITE(base64_unittests);
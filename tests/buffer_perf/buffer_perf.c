@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+#include "azure_c_shared_utility/buffer_.h"
+
+#include "perf_measure.h"
+
+#define BUFFER_PERF_ITERATIONS 10000
+#define BUFFER_PERF_PIECES 256
+#define BUFFER_PERF_PIECE_SIZE 64
+
+static const unsigned char PIECE[BUFFER_PERF_PIECE_SIZE] = { 0 };
+
+static TEST_MUTEX_HANDLE g_testByTest;
+
+/*builds a 16KB buffer out of 64 bytes pieces*/
+static void append_build_and_delete(void* context, size_t iteration)
+{
+    size_t i;
+    BUFFER_HANDLE handle = BUFFER_new();
+    (void)context;
+    (void)iteration;
+    for (i = 0; i < BUFFER_PERF_PIECES; i++)
+    {
+        (void)BUFFER_append_build(handle, PIECE, sizeof(PIECE));
+    }
+    BUFFER_delete(handle);
+}
+
+static void enlarge_and_delete(void* context, size_t iteration)
+{
+    size_t i;
+    BUFFER_HANDLE handle = BUFFER_create(PIECE, sizeof(PIECE));
+    (void)context;
+    (void)iteration;
+    for (i = 1; i < BUFFER_PERF_PIECES; i++)
+    {
+        (void)BUFFER_enlarge(handle, sizeof(PIECE));
+    }
+    BUFFER_delete(handle);
+}
+
+static void reserve_append_build_and_delete(void* context, size_t iteration)
+{
+    size_t i;
+    BUFFER_HANDLE handle = BUFFER_new();
+    (void)context;
+    (void)iteration;
+    (void)BUFFER_reserve(handle, BUFFER_PERF_PIECES * sizeof(PIECE));
+    for (i = 0; i < BUFFER_PERF_PIECES; i++)
+    {
+        (void)BUFFER_append_build(handle, PIECE, sizeof(PIECE));
+    }
+    BUFFER_delete(handle);
+}
+
+BEGIN_TEST_SUITE(buffer_perf)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+TEST_FUNCTION(BUFFER_append_build_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result = perf_measure_run("BUFFER_new + 256 x BUFFER_append_build (64 bytes) + BUFFER_delete", append_build_and_delete, NULL, BUFFER_PERF_ITERATIONS);
+
+    ///assert
+    ASSERT_IS_TRUE(result.allocations_per_op <= 12.0);
+}
+
+TEST_FUNCTION(BUFFER_enlarge_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result = perf_measure_run("BUFFER_create + 255 x BUFFER_enlarge (64 bytes) + BUFFER_delete", enlarge_and_delete, NULL, BUFFER_PERF_ITERATIONS);
+
+    ///assert
+    ASSERT_IS_TRUE(result.allocations_per_op <= 12.0);
+}
+
+TEST_FUNCTION(BUFFER_reserve_append_build_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result = perf_measure_run("BUFFER_new + BUFFER_reserve + 256 x BUFFER_append_build (64 bytes) + BUFFER_delete", reserve_append_build_and_delete, NULL, BUFFER_PERF_ITERATIONS);
+
+    ///assert
+    ASSERT_IS_TRUE(result.allocations_per_op == 2.0);
+}
+
+END_TEST_SUITE(buffer_perf)
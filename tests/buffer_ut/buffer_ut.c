@@ -599,6 +599,55 @@ BEGIN_TEST_SUITE(Buffer_UnitTests)
         BUFFER_delete(hBuffer);
     }
 
+    /* Tests_SRS_BUFFER_07_044: [ BUFFER_append_build and BUFFER_enlarge shall not reallocate when the capacity of the buffer is already enough and shall at least double the capacity when it is not. ] */
+    TEST_FUNCTION(BUFFER_append_build_doubles_the_capacity_when_growing)
+    {
+        //arrange
+        int nResult;
+        BUFFER_HANDLE hBuffer;
+        hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 2 * ALLOCATION_SIZE));
+
+        //act
+        nResult = BUFFER_append_build(hBuffer, BUFFER_Test1, BUFFER_TEST1_SIZE);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, nResult, 0);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE + BUFFER_TEST1_SIZE, BUFFER_length(hBuffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hBuffer) + ALLOCATION_SIZE, BUFFER_Test1, BUFFER_TEST1_SIZE));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_07_044: [ BUFFER_append_build and BUFFER_enlarge shall not reallocate when the capacity of the buffer is already enough and shall at least double the capacity when it is not. ] */
+    TEST_FUNCTION(BUFFER_append_build_within_capacity_does_not_allocate)
+    {
+        //arrange
+        int nResult;
+        BUFFER_HANDLE hBuffer;
+        hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        (void)BUFFER_append_build(hBuffer, BUFFER_Test1, BUFFER_TEST1_SIZE);
+
+        umock_c_reset_all_calls();
+
+        //act
+        nResult = BUFFER_append_build(hBuffer, BUFFER_Test1, BUFFER_TEST1_SIZE);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, nResult, 0);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE + 2 * BUFFER_TEST1_SIZE, BUFFER_length(hBuffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hBuffer) + ALLOCATION_SIZE + BUFFER_TEST1_SIZE, BUFFER_Test1, BUFFER_TEST1_SIZE));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(hBuffer);
+    }
+
     /* Tests_SRS_BUFFER_07_011: [BUFFER_build shall overwrite previous contents if the buffer has been previously allocated.] */
     TEST_FUNCTION(BUFFER_build_when_the_buffer_is_already_allocated_and_the_same_amount_of_bytes_is_needed_succeeds)
     {
@@ -757,6 +806,30 @@ BEGIN_TEST_SUITE(Buffer_UnitTests)
         BUFFER_delete(g_hBuffer);
     }
 
+    /* Tests_SRS_BUFFER_07_044: [ BUFFER_append_build and BUFFER_enlarge shall not reallocate when the capacity of the buffer is already enough and shall at least double the capacity when it is not. ] */
+    TEST_FUNCTION(BUFFER_enlarge_within_capacity_does_not_allocate)
+    {
+        ///arrange
+        int nResult;
+        BUFFER_HANDLE g_hBuffer;
+        g_hBuffer = BUFFER_new();
+        (void)BUFFER_build(g_hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        (void)BUFFER_enlarge(g_hBuffer, 1);
+        umock_c_reset_all_calls();
+
+        ///act
+        nResult = BUFFER_enlarge(g_hBuffer, ALLOCATION_SIZE - 1);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, nResult, 0);
+        ASSERT_ARE_EQUAL(size_t, TOTAL_ALLOCATION_SIZE, BUFFER_length(g_hBuffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(g_hBuffer), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
     /* Tests_SRS_BUFFER_07_017: [BUFFER_enlarge shall return a nonzero result if any parameters are NULL or zero.] */
     /* Tests_SRS_BUFFER_07_018: [BUFFER_enlarge shall return a nonzero result if any error is encountered.] */
     TEST_FUNCTION(BUFFER_enlarge_NULL_HANDLE_Fail)
@@ -1738,4 +1811,200 @@ BEGIN_TEST_SUITE(Buffer_UnitTests)
         BUFFER_delete(buffer);
     }
 
+    /* Tests_SRS_BUFFER_07_045: [ If handle is NULL BUFFER_reserve shall return a non-zero value. ] */
+    TEST_FUNCTION(BUFFER_reserve_handle_NULL_fail)
+    {
+        int result;
+
+        //arrange
+
+        //act
+        result = BUFFER_reserve(NULL, ALLOCATION_SIZE);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_BUFFER_07_046: [ If the buffer can already hold capacity bytes BUFFER_reserve shall not allocate and shall return zero. ] */
+    TEST_FUNCTION(BUFFER_reserve_within_capacity_does_not_allocate)
+    {
+        int result;
+
+        //arrange
+        BUFFER_HANDLE buffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        umock_c_reset_all_calls();
+
+        //act
+        result = BUFFER_reserve(buffer, ALLOCATION_SIZE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE, BUFFER_length(buffer));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(buffer);
+    }
+
+    /* Tests_SRS_BUFFER_07_047: [ Otherwise BUFFER_reserve shall reallocate the buffer to exactly capacity bytes, preserving its content and its size. ] */
+    /* Tests_SRS_BUFFER_07_049: [ On success BUFFER_reserve shall return zero. ] */
+    TEST_FUNCTION(BUFFER_reserve_reallocates_exactly_the_capacity)
+    {
+        int result;
+
+        //arrange
+        BUFFER_HANDLE buffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, TOTAL_ALLOCATION_SIZE + 1));
+
+        //act
+        result = BUFFER_reserve(buffer, TOTAL_ALLOCATION_SIZE + 1);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE, BUFFER_length(buffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(buffer), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(buffer);
+    }
+
+    /* Tests_SRS_BUFFER_07_047: [ Otherwise BUFFER_reserve shall reallocate the buffer to exactly capacity bytes, preserving its content and its size. ] */
+    TEST_FUNCTION(BUFFER_reserve_then_append_build_up_to_the_capacity_does_not_allocate)
+    {
+        int result;
+
+        //arrange
+        BUFFER_HANDLE buffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        ASSERT_ARE_EQUAL(int, 0, BUFFER_reserve(buffer, TOTAL_ALLOCATION_SIZE));
+        umock_c_reset_all_calls();
+
+        //act
+        result = BUFFER_append_build(buffer, ADDITIONAL_BUFFER, ALLOCATION_SIZE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, TOTAL_ALLOCATION_SIZE, BUFFER_length(buffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(buffer), TOTAL_BUFFER, TOTAL_ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(buffer);
+    }
+
+    /* Tests_SRS_BUFFER_07_048: [ If any error is encountered BUFFER_reserve shall leave the buffer unchanged and return a non-zero value. ] */
+    TEST_FUNCTION(BUFFER_reserve_fails_when_realloc_fails)
+    {
+        int result;
+
+        //arrange
+        BUFFER_HANDLE buffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, TOTAL_ALLOCATION_SIZE))
+            .SetReturn(NULL);
+
+        //act
+        result = BUFFER_reserve(buffer, TOTAL_ALLOCATION_SIZE);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE, BUFFER_length(buffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(buffer), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(buffer);
+    }
+
+    /* Tests_SRS_BUFFER_07_050: [ If handle is NULL BUFFER_shrink_to_fit shall return a non-zero value. ] */
+    TEST_FUNCTION(BUFFER_shrink_to_fit_handle_NULL_fail)
+    {
+        int result;
+
+        //arrange
+
+        //act
+        result = BUFFER_shrink_to_fit(NULL);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_BUFFER_07_051: [ If the size of the buffer is 0 or equal to its capacity BUFFER_shrink_to_fit shall not allocate and shall return zero. ] */
+    TEST_FUNCTION(BUFFER_shrink_to_fit_without_spare_capacity_does_not_allocate)
+    {
+        int result;
+
+        //arrange
+        BUFFER_HANDLE buffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        umock_c_reset_all_calls();
+
+        //act
+        result = BUFFER_shrink_to_fit(buffer);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE, BUFFER_length(buffer));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(buffer);
+    }
+
+    /* Tests_SRS_BUFFER_07_052: [ Otherwise BUFFER_shrink_to_fit shall reallocate the buffer to its size. ] */
+    /* Tests_SRS_BUFFER_07_054: [ On success BUFFER_shrink_to_fit shall return zero. ] */
+    TEST_FUNCTION(BUFFER_shrink_to_fit_reallocates_to_the_size)
+    {
+        int result;
+
+        //arrange
+        BUFFER_HANDLE buffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        ASSERT_ARE_EQUAL(int, 0, BUFFER_append_build(buffer, BUFFER_Test1, BUFFER_TEST1_SIZE));
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, ALLOCATION_SIZE + BUFFER_TEST1_SIZE));
+
+        //act
+        result = BUFFER_shrink_to_fit(buffer);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE + BUFFER_TEST1_SIZE, BUFFER_length(buffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(buffer), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(buffer);
+    }
+
+    /* Tests_SRS_BUFFER_07_053: [ If any error is encountered BUFFER_shrink_to_fit shall leave the buffer unchanged and return a non-zero value. ] */
+    TEST_FUNCTION(BUFFER_shrink_to_fit_fails_when_realloc_fails)
+    {
+        int result;
+
+        //arrange
+        BUFFER_HANDLE buffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        ASSERT_ARE_EQUAL(int, 0, BUFFER_append_build(buffer, BUFFER_Test1, BUFFER_TEST1_SIZE));
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, ALLOCATION_SIZE + BUFFER_TEST1_SIZE))
+            .SetReturn(NULL);
+
+        //act
+        result = BUFFER_shrink_to_fit(buffer);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE + BUFFER_TEST1_SIZE, BUFFER_length(buffer));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(buffer);
+    }
+
 END_TEST_SUITE(Buffer_UnitTests)
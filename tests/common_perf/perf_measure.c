@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include "windows.h"
+#else
+#include <time.h>
+#endif
+
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#include "perf_measure.h"
+
+/*allocations are counted over this many calls at most, gballoc tracking is too slow for the full run*/
+#define PERF_MEASURE_ALLOCATION_COUNT_ITERATIONS 10000
+
+double perf_measure_now_ns(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER now;
+    (void)QueryPerformanceFrequency(&frequency);
+    (void)QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1000000000.0 / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1000000000.0 + (double)now.tv_nsec;
+#endif
+}
+
+PERF_MEASURE_RESULT perf_measure_run(const char* name, PERF_MEASURE_OPERATION operation, void* context, size_t iterations)
+{
+    PERF_MEASURE_RESULT result;
+    size_t counted_iterations = (iterations < PERF_MEASURE_ALLOCATION_COUNT_ITERATIONS) ? iterations : PERF_MEASURE_ALLOCATION_COUNT_ITERATIONS;
+    size_t i;
+    double start;
+
+    result.allocations_per_op = -1.0;
+    if (gballoc_init() == 0)
+    {
+        gballoc_resetMetrics();
+        for (i = 0; i < counted_iterations; i++)
+        {
+            operation(context, i);
+        }
+        result.allocations_per_op = (double)gballoc_getAllocationCount() / (double)counted_iterations;
+        gballoc_deinit();
+    }
+
+    start = perf_measure_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        operation(context, i);
+    }
+    result.ns_per_op = (perf_measure_now_ns() - start) / (double)iterations;
+
+    LogInfo("%s: %.1f ns/op, %.2f allocations/op (%zu iterations)", name, result.ns_per_op, result.allocations_per_op, iterations);
+
+    return result;
+}
@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef PERF_MEASURE_H
+#define PERF_MEASURE_H
+
+#ifdef __cplusplus
+#include <cstddef>
+#else
+#include <stddef.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void(*PERF_MEASURE_OPERATION)(void* context, size_t iteration);
+
+typedef struct PERF_MEASURE_RESULT_TAG
+{
+    double ns_per_op;
+    double allocations_per_op;
+} PERF_MEASURE_RESULT;
+
+/*returns a monotonic timestamp in nanoseconds*/
+double perf_measure_now_ns(void);
+
+/*runs operation iterations times and returns the time per call. If the translation units under test are built with gballoc measurement
+(GB_MEASURE_MEMORY_FOR_THIS), a second, shorter, run is made with gballoc initialized to count the allocations per call.
+The timed run is made with gballoc not initialized so that the tracking overhead is not part of the result.*/
+PERF_MEASURE_RESULT perf_measure_run(const char* name, PERF_MEASURE_OPERATION operation, void* context, size_t iterations);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PERF_MEASURE_H */
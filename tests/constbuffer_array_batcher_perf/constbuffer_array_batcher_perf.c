@@ -0,0 +1,226 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+#include "azure_c_shared_utility/constbuffer.h"
+#include "azure_c_shared_utility/constbuffer_array.h"
+#include "azure_c_shared_utility/constbuffer_array_batcher.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#include "perf_measure.h"
+
+/*each measurement batches this many payloads in total, whatever the batch size*/
+#define CONSTBUFFER_ARRAY_BATCHER_PERF_PAYLOADS 1000000
+#define CONSTBUFFER_ARRAY_BATCHER_PERF_BUFFER_SIZE 16
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static const unsigned char g_data[CONSTBUFFER_ARRAY_BATCHER_PERF_BUFFER_SIZE] = { 0 };
+
+typedef struct CONSTBUFFER_ARRAY_BATCHER_PERF_CONTEXT_TAG
+{
+    CONSTBUFFER_ARRAY_HANDLE* payloads;
+    uint32_t payload_count;
+    CONSTBUFFER_ARRAY_HANDLE batch;
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher;
+    uint32_t batches;
+} CONSTBUFFER_ARRAY_BATCHER_PERF_CONTEXT;
+
+static void on_batch_complete(void* context, CONSTBUFFER_ARRAY_HANDLE batch)
+{
+    CONSTBUFFER_ARRAY_BATCHER_PERF_CONTEXT* perf_context = (CONSTBUFFER_ARRAY_BATCHER_PERF_CONTEXT*)context;
+    (void)batch;
+    perf_context->batches++;
+}
+
+/*all the payloads at once*/
+static void batch(void* context, size_t iteration)
+{
+    CONSTBUFFER_ARRAY_BATCHER_PERF_CONTEXT* perf_context = (CONSTBUFFER_ARRAY_BATCHER_PERF_CONTEXT*)context;
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_batcher_batch(perf_context->payloads, perf_context->payload_count);
+    (void)iteration;
+    if (result == NULL)
+    {
+        ASSERT_FAIL("constbuffer_array_batcher_batch failed");
+    }
+    constbuffer_array_dec_ref(result);
+    perf_context->batches++;
+}
+
+/*the payloads one at a time, as they would come from a queue*/
+static void append(void* context, size_t iteration)
+{
+    CONSTBUFFER_ARRAY_BATCHER_PERF_CONTEXT* perf_context = (CONSTBUFFER_ARRAY_BATCHER_PERF_CONTEXT*)context;
+    uint32_t i;
+    (void)iteration;
+    for (i = 0; i < perf_context->payload_count; i++)
+    {
+        if (constbuffer_array_batcher_append(perf_context->batcher, perf_context->payloads[i]) != 0)
+        {
+            ASSERT_FAIL("constbuffer_array_batcher_append failed");
+        }
+    }
+    if (constbuffer_array_batcher_finish(perf_context->batcher) != 0)
+    {
+        ASSERT_FAIL("constbuffer_array_batcher_finish failed");
+    }
+}
+
+static void unbatch(void* context, size_t iteration)
+{
+    CONSTBUFFER_ARRAY_BATCHER_PERF_CONTEXT* perf_context = (CONSTBUFFER_ARRAY_BATCHER_PERF_CONTEXT*)context;
+    uint32_t payload_count;
+    uint32_t i;
+    CONSTBUFFER_ARRAY_HANDLE* payloads = constbuffer_array_batcher_unbatch(perf_context->batch, &payload_count);
+    (void)iteration;
+    if (payloads == NULL)
+    {
+        ASSERT_FAIL("constbuffer_array_batcher_unbatch failed");
+    }
+    for (i = 0; i < payload_count; i++)
+    {
+        constbuffer_array_dec_ref(payloads[i]);
+    }
+    free(payloads);
+    perf_context->batches++;
+}
+
+static void create_context(CONSTBUFFER_ARRAY_BATCHER_PERF_CONTEXT* perf_context, uint32_t payload_count)
+{
+    CONSTBUFFER_HANDLE buffer = CONSTBUFFER_Create(g_data, sizeof(g_data));
+    uint32_t i;
+    ASSERT_IS_NOT_NULL(buffer);
+
+    perf_context->payloads = (CONSTBUFFER_ARRAY_HANDLE*)malloc(sizeof(CONSTBUFFER_ARRAY_HANDLE) * payload_count);
+    ASSERT_IS_NOT_NULL(perf_context->payloads);
+    for (i = 0; i < payload_count; i++)
+    {
+        perf_context->payloads[i] = constbuffer_array_create(&buffer, 1);
+        ASSERT_IS_NOT_NULL(perf_context->payloads[i]);
+    }
+    perf_context->payload_count = payload_count;
+    perf_context->batch = constbuffer_array_batcher_batch(perf_context->payloads, payload_count);
+    ASSERT_IS_NOT_NULL(perf_context->batch);
+    perf_context->batcher = constbuffer_array_batcher_create(payload_count, UINT32_MAX, on_batch_complete, perf_context);
+    ASSERT_IS_NOT_NULL(perf_context->batcher);
+    /*grow the header and the handles of the batcher once, so that the runs measure batches of the steady state*/
+    append(perf_context, 0);
+    perf_context->batches = 0;
+
+    CONSTBUFFER_DecRef(buffer);
+}
+
+static void destroy_context(CONSTBUFFER_ARRAY_BATCHER_PERF_CONTEXT* perf_context)
+{
+    uint32_t i;
+    constbuffer_array_batcher_destroy(perf_context->batcher);
+    constbuffer_array_dec_ref(perf_context->batch);
+    for (i = 0; i < perf_context->payload_count; i++)
+    {
+        constbuffer_array_dec_ref(perf_context->payloads[i]);
+    }
+    free(perf_context->payloads);
+}
+
+static PERF_MEASURE_RESULT run(const char* operation_name, PERF_MEASURE_OPERATION operation, uint32_t payload_count)
+{
+    char name[96];
+    CONSTBUFFER_ARRAY_BATCHER_PERF_CONTEXT perf_context;
+    PERF_MEASURE_RESULT result;
+    size_t iterations = CONSTBUFFER_ARRAY_BATCHER_PERF_PAYLOADS / payload_count;
+    create_context(&perf_context, payload_count);
+    (void)sprintf(name, "%s (%u payloads)", operation_name, (unsigned int)payload_count);
+
+    ///act
+    result = perf_measure_run(name, operation, &perf_context, iterations);
+
+    ///assert
+    LogInfo("%s: %.2f Mpayloads/s", name, (double)payload_count * 1000.0 / result.ns_per_op);
+    /*the counted and the timed run each produce one batch per iteration*/
+    ASSERT_ARE_EQUAL(uint32_t, (uint32_t)(iterations + ((iterations < 10000) ? iterations : 10000)), perf_context.batches);
+
+    destroy_context(&perf_context);
+    return result;
+}
+
+BEGIN_TEST_SUITE(constbuffer_array_batcher_perf)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+TEST_FUNCTION(constbuffer_array_batcher_batch_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result1k = run("constbuffer_array_batcher_batch", batch, 1000);
+    PERF_MEASURE_RESULT result10k = run("constbuffer_array_batcher_batch", batch, 10000);
+    PERF_MEASURE_RESULT result100k = run("constbuffer_array_batcher_batch", batch, 100000);
+
+    ///assert
+    /*header memory, header buffer, handles and the batch, whatever the number of payloads*/
+    ASSERT_IS_TRUE(result1k.allocations_per_op == 4.0);
+    ASSERT_IS_TRUE(result10k.allocations_per_op == 4.0);
+    ASSERT_IS_TRUE(result100k.allocations_per_op == 4.0);
+}
+
+TEST_FUNCTION(constbuffer_array_batcher_append_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result1k = run("constbuffer_array_batcher_append", append, 1000);
+    PERF_MEASURE_RESULT result10k = run("constbuffer_array_batcher_append", append, 10000);
+    PERF_MEASURE_RESULT result100k = run("constbuffer_array_batcher_append", append, 100000);
+
+    ///assert
+    /*the handles, the header buffer and the batch, whatever the number of payloads*/
+    ASSERT_IS_TRUE(result1k.allocations_per_op == 3.0);
+    ASSERT_IS_TRUE(result10k.allocations_per_op == 3.0);
+    ASSERT_IS_TRUE(result100k.allocations_per_op == 3.0);
+}
+
+TEST_FUNCTION(constbuffer_array_batcher_unbatch_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result1k = run("constbuffer_array_batcher_unbatch", unbatch, 1000);
+    PERF_MEASURE_RESULT result10k = run("constbuffer_array_batcher_unbatch", unbatch, 10000);
+    PERF_MEASURE_RESULT result100k = run("constbuffer_array_batcher_unbatch", unbatch, 100000);
+
+    ///assert
+    /*the payloads share the buffers of the batch, only the payload handles are allocated*/
+    ASSERT_IS_TRUE(result1k.allocations_per_op == 1001.0);
+    ASSERT_IS_TRUE(result10k.allocations_per_op == 10001.0);
+    ASSERT_IS_TRUE(result100k.allocations_per_op == 100001.0);
+}
+
+END_TEST_SUITE(constbuffer_array_batcher_perf)
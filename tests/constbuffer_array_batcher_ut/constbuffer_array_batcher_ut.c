@@ -15,6 +15,11 @@ void* real_malloc(size_t size)
     return malloc(size);
 }
 
+void* real_realloc(void* ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
 void real_free(void* ptr)
 {
     free(ptr);
@@ -40,6 +45,18 @@ void real_free(void* ptr)
 #include "../real_test_files/real_constbuffer_array.h"
 #include "../real_test_files/real_memory_data.h"
 
+static CONSTBUFFER_ARRAY_HANDLE test_batch;
+
+#define ENABLE_MOCKS
+
+/*keeps the batch so that the tests can look at it once it was released by the batcher*/
+MOCK_FUNCTION_WITH_CODE(, void, test_on_batch_complete, void*, context, CONSTBUFFER_ARRAY_HANDLE, batch)
+    real_constbuffer_array_inc_ref(batch);
+    test_batch = batch;
+MOCK_FUNCTION_END()
+
+#undef ENABLE_MOCKS
+
 static TEST_MUTEX_HANDLE test_serialize_mutex;
 
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
@@ -65,12 +82,19 @@ TEST_SUITE_INITIALIZE(suite_init)
     ASSERT_ARE_EQUAL(int, 0, result, "umocktypes_stdint_register_types failed");
 
     REGISTER_GLOBAL_MOCK_HOOK(malloc, real_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(realloc, real_realloc);
     REGISTER_GLOBAL_MOCK_HOOK(free, real_free);
 
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(realloc, NULL);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_create_empty, NULL);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_create, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_create_from_buffer_index_and_count, NULL);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_CreateWithMoveMemory, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_Create, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_create_with_move_buffers, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_get_buffer_count, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_get_all_buffers_size, MU_FAILURE);
 
     REGISTER_CONSTBUFFER_GLOBAL_MOCK_HOOK();
     REGISTER_CONSTBUFFER_ARRAY_GLOBAL_MOCK_HOOK();
@@ -96,6 +120,7 @@ TEST_FUNCTION_INITIALIZE(method_init)
 
     umock_c_reset_all_calls();
     umock_c_negative_tests_init();
+    test_batch = NULL;
 }
 
 TEST_FUNCTION_CLEANUP(method_cleanup)
@@ -731,7 +756,7 @@ TEST_FUNCTION(constbuffer_array_batcher_unbatch_with_NULL_payload_count_fails)
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_015: [ constbuffer_array_batcher_unbatch shall extract the number of buffer arrays batched by reading the first uint32_t. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_017: [ constbuffer_array_batcher_unbatch shall allocate enough memory to hold the handles for buffer arrays that will be unbatched. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_016: [ constbuffer_array_batcher_unbatch shall extract the number of buffers in each of the batched payloads reading the uint32_t values encoded in the rest of the first (header) buffer. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_018: [ constbuffer_array_batcher_unbatch shall create a const buffer array for each of the payloads in the batch. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_018: [ constbuffer_array_batcher_unbatch shall create a const buffer array for each of the payloads in the batch by calling constbuffer_array_create_from_buffer_index_and_count, so that the payloads share the buffers of batch. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_019: [ On success constbuffer_array_batcher_unbatch shall return the array of const buffer array handles that constitute the batch. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_020: [ On success constbuffer_array_batcher_unbatch shall write in payload_count the number of const buffer arrays that are in the batch. ]*/
 TEST_FUNCTION(constbuffer_array_batcher_unbatch_with_1_payload_with_0_buffers_succeeds)
@@ -776,7 +801,7 @@ TEST_FUNCTION(constbuffer_array_batcher_unbatch_with_1_payload_with_0_buffers_su
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_015: [ constbuffer_array_batcher_unbatch shall extract the number of buffer arrays batched by reading the first uint32_t. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_017: [ constbuffer_array_batcher_unbatch shall allocate enough memory to hold the handles for buffer arrays that will be unbatched. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_016: [ constbuffer_array_batcher_unbatch shall extract the number of buffers in each of the batched payloads reading the uint32_t values encoded in the rest of the first (header) buffer. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_018: [ constbuffer_array_batcher_unbatch shall create a const buffer array for each of the payloads in the batch. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_018: [ constbuffer_array_batcher_unbatch shall create a const buffer array for each of the payloads in the batch by calling constbuffer_array_create_from_buffer_index_and_count, so that the payloads share the buffers of batch. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_019: [ On success constbuffer_array_batcher_unbatch shall return the array of const buffer array handles that constitute the batch. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_020: [ On success constbuffer_array_batcher_unbatch shall write in payload_count the number of const buffer arrays that are in the batch. ]*/
 TEST_FUNCTION(constbuffer_array_batcher_unbatch_with_2_payload_with_0_buffers_succeeds)
@@ -826,7 +851,7 @@ TEST_FUNCTION(constbuffer_array_batcher_unbatch_with_2_payload_with_0_buffers_su
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_015: [ constbuffer_array_batcher_unbatch shall extract the number of buffer arrays batched by reading the first uint32_t. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_017: [ constbuffer_array_batcher_unbatch shall allocate enough memory to hold the handles for buffer arrays that will be unbatched. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_016: [ constbuffer_array_batcher_unbatch shall extract the number of buffers in each of the batched payloads reading the uint32_t values encoded in the rest of the first (header) buffer. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_018: [ constbuffer_array_batcher_unbatch shall create a const buffer array for each of the payloads in the batch. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_018: [ constbuffer_array_batcher_unbatch shall create a const buffer array for each of the payloads in the batch by calling constbuffer_array_create_from_buffer_index_and_count, so that the payloads share the buffers of batch. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_019: [ On success constbuffer_array_batcher_unbatch shall return the array of const buffer array handles that constitute the batch. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_020: [ On success constbuffer_array_batcher_unbatch shall write in payload_count the number of const buffer arrays that are in the batch. ]*/
 TEST_FUNCTION(constbuffer_array_batcher_unbatch_with_1_payload_with_1_buffers_succeeds)
@@ -850,11 +875,7 @@ TEST_FUNCTION(constbuffer_array_batcher_unbatch_with_1_payload_with_1_buffers_su
     STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(malloc(sizeof(CONSTBUFFER_ARRAY_HANDLE) * 1));
     STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(malloc(sizeof(CONSTBUFFER_HANDLE) * 1));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(batch, 1));
-    STRICT_EXPECTED_CALL(constbuffer_array_create(IGNORED_ARG, 1));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(test_buffers[1]));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_index_and_count(batch, 1, 1));
 
     // act
     result = constbuffer_array_batcher_unbatch(batch, &payload_count);
@@ -882,7 +903,7 @@ TEST_FUNCTION(constbuffer_array_batcher_unbatch_with_1_payload_with_1_buffers_su
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_015: [ constbuffer_array_batcher_unbatch shall extract the number of buffer arrays batched by reading the first uint32_t. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_017: [ constbuffer_array_batcher_unbatch shall allocate enough memory to hold the handles for buffer arrays that will be unbatched. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_016: [ constbuffer_array_batcher_unbatch shall extract the number of buffers in each of the batched payloads reading the uint32_t values encoded in the rest of the first (header) buffer. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_018: [ constbuffer_array_batcher_unbatch shall create a const buffer array for each of the payloads in the batch. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_018: [ constbuffer_array_batcher_unbatch shall create a const buffer array for each of the payloads in the batch by calling constbuffer_array_create_from_buffer_index_and_count, so that the payloads share the buffers of batch. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_019: [ On success constbuffer_array_batcher_unbatch shall return the array of const buffer array handles that constitute the batch. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_020: [ On success constbuffer_array_batcher_unbatch shall write in payload_count the number of const buffer arrays that are in the batch. ]*/
 TEST_FUNCTION(constbuffer_array_batcher_unbatch_with_1_payload_with_2_buffers_succeeds)
@@ -907,13 +928,7 @@ TEST_FUNCTION(constbuffer_array_batcher_unbatch_with_1_payload_with_2_buffers_su
     STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(malloc(sizeof(CONSTBUFFER_ARRAY_HANDLE) * 1));
     STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(malloc(sizeof(CONSTBUFFER_HANDLE) * 2));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(batch, 1));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(batch, 2));
-    STRICT_EXPECTED_CALL(constbuffer_array_create(IGNORED_ARG, 2));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(test_buffers[1]));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(test_buffers[2]));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_index_and_count(batch, 1, 2));
 
     // act
     result = constbuffer_array_batcher_unbatch(batch, &payload_count);
@@ -945,7 +960,7 @@ TEST_FUNCTION(constbuffer_array_batcher_unbatch_with_1_payload_with_2_buffers_su
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_015: [ constbuffer_array_batcher_unbatch shall extract the number of buffer arrays batched by reading the first uint32_t. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_017: [ constbuffer_array_batcher_unbatch shall allocate enough memory to hold the handles for buffer arrays that will be unbatched. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_016: [ constbuffer_array_batcher_unbatch shall extract the number of buffers in each of the batched payloads reading the uint32_t values encoded in the rest of the first (header) buffer. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_018: [ constbuffer_array_batcher_unbatch shall create a const buffer array for each of the payloads in the batch. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_018: [ constbuffer_array_batcher_unbatch shall create a const buffer array for each of the payloads in the batch by calling constbuffer_array_create_from_buffer_index_and_count, so that the payloads share the buffers of batch. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_019: [ On success constbuffer_array_batcher_unbatch shall return the array of const buffer array handles that constitute the batch. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_01_020: [ On success constbuffer_array_batcher_unbatch shall write in payload_count the number of const buffer arrays that are in the batch. ]*/
 TEST_FUNCTION(constbuffer_array_batcher_unbatch_with_2_payloads_each_with_different_number_of_buffers_succeeds)
@@ -973,22 +988,10 @@ TEST_FUNCTION(constbuffer_array_batcher_unbatch_with_2_payloads_each_with_differ
     STRICT_EXPECTED_CALL(malloc(sizeof(CONSTBUFFER_ARRAY_HANDLE) * 2));
 
     STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(malloc(sizeof(CONSTBUFFER_HANDLE) * 1)); // 1st payload with 1 buffer
-    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(batch, 1));
-    STRICT_EXPECTED_CALL(constbuffer_array_create(IGNORED_ARG, 1));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(test_buffers[1]));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_index_and_count(batch, 1, 1)); // 1st payload with 1 buffer
 
     STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(malloc(sizeof(CONSTBUFFER_HANDLE) * 3)); // 2nd payload with 3 buffer
-    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(batch, 2));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(batch, 3));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(batch, 4));
-    STRICT_EXPECTED_CALL(constbuffer_array_create(IGNORED_ARG, 3));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(test_buffers[2]));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(test_buffers[3]));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(test_buffers[4]));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_index_and_count(batch, 2, 3)); // 2nd payload with 3 buffer
 
     // act
     result = constbuffer_array_batcher_unbatch(batch, &payload_count);
@@ -1057,26 +1060,10 @@ TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_batcher_unbatch_fails
     STRICT_EXPECTED_CALL(malloc(sizeof(CONSTBUFFER_ARRAY_HANDLE) * 2));
 
     STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(malloc(sizeof(CONSTBUFFER_HANDLE) * 1)); // 1st payload with 1 buffer
-    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(batch, 1))
-        .CallCannotFail();
-    STRICT_EXPECTED_CALL(constbuffer_array_create(IGNORED_ARG, 1));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(test_buffers[1]));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_index_and_count(batch, 1, 1)); // 1st payload with 1 buffer
 
     STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(malloc(sizeof(CONSTBUFFER_HANDLE) * 3)); // 2nd payload with 3 buffer
-    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(batch, 2))
-        .CallCannotFail();
-    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(batch, 3))
-        .CallCannotFail();
-    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(batch, 4))
-        .CallCannotFail();
-    STRICT_EXPECTED_CALL(constbuffer_array_create(IGNORED_ARG, 3));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(test_buffers[2]));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(test_buffers[3]));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(test_buffers[4]));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_index_and_count(batch, 2, 3)); // 2nd payload with 3 buffer
 
     umock_c_negative_tests_snapshot();
 
@@ -1317,11 +1304,7 @@ TEST_FUNCTION(constbuffer_array_batcher_unbatch_with_2_payloads_with_1_buffer_bu
     STRICT_EXPECTED_CALL(malloc(sizeof(CONSTBUFFER_ARRAY_HANDLE) * 2));
 
     STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(malloc(sizeof(CONSTBUFFER_HANDLE) * 1)); // 1st payload with 1 buffer
-    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(batch, 1));
-    STRICT_EXPECTED_CALL(constbuffer_array_create(IGNORED_ARG, 1));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(test_buffers[1]));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_index_and_count(batch, 1, 1)); // 1st payload with 1 buffer
 
     STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
 
@@ -1400,4 +1383,564 @@ TEST_FUNCTION(constbuffer_array_batcher_unbatch_with_payload_count_0_fails)
     real_CONSTBUFFER_DecRef(test_buffers[0]);
 }
 
+/* constbuffer_array_batcher_create */
+
+static const unsigned char test_buffer_payload[] = { 0x42 };
+
+/*a payload made of 2 buffers of 1 byte*/
+static CONSTBUFFER_ARRAY_HANDLE create_test_payload(CONSTBUFFER_HANDLE* test_buffers)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+    test_buffers[0] = real_CONSTBUFFER_Create(test_buffer_payload, sizeof(test_buffer_payload));
+    ASSERT_IS_NOT_NULL(test_buffers[0]);
+    test_buffers[1] = real_CONSTBUFFER_Create(test_buffer_payload, sizeof(test_buffer_payload));
+    ASSERT_IS_NOT_NULL(test_buffers[1]);
+    result = real_constbuffer_array_create(test_buffers, 2);
+    ASSERT_IS_NOT_NULL(result);
+    real_CONSTBUFFER_DecRef(test_buffers[0]);
+    real_CONSTBUFFER_DecRef(test_buffers[1]);
+    return result;
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_001: [ If max_payload_count is 0, constbuffer_array_batcher_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_create_with_0_max_payload_count_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE result;
+
+    // act
+    result = constbuffer_array_batcher_create(0, UINT32_MAX, test_on_batch_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_002: [ If max_batch_size is 0, constbuffer_array_batcher_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_create_with_0_max_batch_size_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE result;
+
+    // act
+    result = constbuffer_array_batcher_create(UINT32_MAX, 0, test_on_batch_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_003: [ If on_batch_complete is NULL, constbuffer_array_batcher_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_create_with_NULL_on_batch_complete_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE result;
+
+    // act
+    result = constbuffer_array_batcher_create(UINT32_MAX, UINT32_MAX, NULL, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_004: [ Otherwise constbuffer_array_batcher_create shall allocate memory for a new batcher. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_006: [ The memory for the header and for the buffer handles of the batch being built shall only be allocated when the first payload is appended. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_007: [ On success constbuffer_array_batcher_create shall return a non-NULL handle. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_create_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE result;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+
+    // act
+    result = constbuffer_array_batcher_create(UINT32_MAX, UINT32_MAX, test_on_batch_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+
+    // cleanup
+    constbuffer_array_batcher_destroy(result);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_005: [ If any error occurs, constbuffer_array_batcher_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_fails_constbuffer_array_batcher_create_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE result;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    // act
+    result = constbuffer_array_batcher_create(UINT32_MAX, UINT32_MAX, test_on_batch_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/* constbuffer_array_batcher_destroy */
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_008: [ If batcher is NULL, constbuffer_array_batcher_destroy shall return. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_destroy_with_NULL_batcher_returns)
+{
+    // act
+    constbuffer_array_batcher_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_010: [ constbuffer_array_batcher_destroy shall free the memory used by batcher. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_destroy_frees_the_batcher)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher = constbuffer_array_batcher_create(UINT32_MAX, UINT32_MAX, test_on_batch_complete, (void*)0x4242);
+    ASSERT_IS_NOT_NULL(batcher);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(free(batcher));
+
+    // act
+    constbuffer_array_batcher_destroy(batcher);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_009: [ constbuffer_array_batcher_destroy shall release the buffers of the payloads that were appended but not yet batched, without producing a batch. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_010: [ constbuffer_array_batcher_destroy shall free the memory used by batcher. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_destroy_releases_the_payloads_not_batched)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(test_buffers);
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher = constbuffer_array_batcher_create(UINT32_MAX, UINT32_MAX, test_on_batch_complete, (void*)0x4242);
+    ASSERT_IS_NOT_NULL(batcher);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_append(batcher, payload));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(test_buffers[0]));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(test_buffers[1]));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(batcher));
+
+    // act
+    constbuffer_array_batcher_destroy(batcher);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(test_batch);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(payload);
+}
+
+/* constbuffer_array_batcher_append */
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_011: [ If batcher is NULL, constbuffer_array_batcher_append shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_append_with_NULL_batcher_fails)
+{
+    // arrange
+    int result;
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(test_buffers);
+    umock_c_reset_all_calls();
+
+    // act
+    result = constbuffer_array_batcher_append(NULL, payload);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(payload);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_012: [ If payload is NULL, constbuffer_array_batcher_append shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_append_with_NULL_payload_fails)
+{
+    // arrange
+    int result;
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher = constbuffer_array_batcher_create(UINT32_MAX, UINT32_MAX, test_on_batch_complete, (void*)0x4242);
+    ASSERT_IS_NOT_NULL(batcher);
+    umock_c_reset_all_calls();
+
+    // act
+    result = constbuffer_array_batcher_append(batcher, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    constbuffer_array_batcher_destroy(batcher);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_013: [ constbuffer_array_batcher_append shall obtain the number of buffers and the size of payload. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_015: [ constbuffer_array_batcher_append shall make room for one more header entry and for the buffers of payload, at least doubling the memory it needs to grow. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_016: [ constbuffer_array_batcher_append shall add the buffer count of payload to the header and a reference to each of its buffers to the batch being built. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_022: [ On success constbuffer_array_batcher_append shall return 0. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_append_adds_the_payload_to_the_batch_being_built)
+{
+    // arrange
+    int result;
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(test_buffers);
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher = constbuffer_array_batcher_create(2, UINT32_MAX, test_on_batch_complete, (void*)0x4242);
+    ASSERT_IS_NOT_NULL(batcher);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(realloc(NULL, sizeof(uint32_t) * 3));
+    STRICT_EXPECTED_CALL(realloc(NULL, sizeof(CONSTBUFFER_HANDLE) * 16));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_const_buffer_handle_array(payload));
+    STRICT_EXPECTED_CALL(write_uint32_t(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(test_buffers[0]));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(test_buffers[1]));
+
+    // act
+    result = constbuffer_array_batcher_append(batcher, payload);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(test_batch);
+
+    // cleanup
+    constbuffer_array_batcher_destroy(batcher);
+    real_constbuffer_array_dec_ref(payload);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_017: [ If the batch being built has max_payload_count payloads or at least max_batch_size bytes, constbuffer_array_batcher_append shall produce it. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_019: [ To produce a batch, the payload count shall be written as the first uint32_t in the header and a header buffer shall be created by calling CONSTBUFFER_Create. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_020: [ The header buffer followed by the buffers of the payloads shall be moved into the batch by calling constbuffer_array_create_with_move_buffers. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_021: [ The batch shall be passed to on_batch_complete and released by calling constbuffer_array_dec_ref once on_batch_complete returns. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_append_of_max_payload_count_payloads_produces_a_batch)
+{
+    // arrange
+    int result;
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(test_buffers);
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher = constbuffer_array_batcher_create(1, UINT32_MAX, test_on_batch_complete, (void*)0x4242);
+    uint8_t expected_header_memory[] = { 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02 };
+    uint32_t buffer_count;
+    ASSERT_IS_NOT_NULL(batcher);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(realloc(NULL, sizeof(uint32_t) * 2));
+    STRICT_EXPECTED_CALL(realloc(NULL, sizeof(CONSTBUFFER_HANDLE) * 16));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_const_buffer_handle_array(payload));
+    STRICT_EXPECTED_CALL(write_uint32_t(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(test_buffers[0]));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(test_buffers[1]));
+    STRICT_EXPECTED_CALL(write_uint32_t(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_Create(IGNORED_ARG, sizeof(uint32_t) * 2))
+        .ValidateArgumentBuffer(1, expected_header_memory, sizeof(expected_header_memory));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 3));
+    STRICT_EXPECTED_CALL(test_on_batch_complete((void*)0x4242, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_dec_ref(IGNORED_ARG));
+
+    // act
+    result = constbuffer_array_batcher_append(batcher, payload);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(test_batch);
+    ASSERT_ARE_EQUAL(int, 0, real_constbuffer_array_get_buffer_count(test_batch, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 3, buffer_count);
+    ASSERT_ARE_EQUAL(void_ptr, test_buffers[0], real_constbuffer_array_get_const_buffer_handle_array(test_batch)[1]);
+    ASSERT_ARE_EQUAL(void_ptr, test_buffers[1], real_constbuffer_array_get_const_buffer_handle_array(test_batch)[2]);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(test_batch);
+    constbuffer_array_batcher_destroy(batcher);
+    real_constbuffer_array_dec_ref(payload);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_014: [ If the batch being built is not empty and adding payload would make it larger than max_batch_size bytes (header included), constbuffer_array_batcher_append shall first produce the batch being built. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_append_over_max_batch_size_produces_the_batch_being_built_first)
+{
+    // arrange
+    int result;
+    CONSTBUFFER_HANDLE test_buffers_1[2];
+    CONSTBUFFER_HANDLE test_buffers_2[2];
+    CONSTBUFFER_ARRAY_HANDLE payload_1 = create_test_payload(test_buffers_1);
+    CONSTBUFFER_ARRAY_HANDLE payload_2 = create_test_payload(test_buffers_2);
+    /*a batch with 1 payload is 4 + 4 + 2 bytes*/
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher = constbuffer_array_batcher_create(10, 11, test_on_batch_complete, (void*)0x4242);
+    uint32_t buffer_count;
+    ASSERT_IS_NOT_NULL(batcher);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_append(batcher, payload_1));
+    ASSERT_IS_NULL(test_batch);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(payload_2, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(payload_2, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_uint32_t(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_Create(IGNORED_ARG, sizeof(uint32_t) * 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 3));
+    STRICT_EXPECTED_CALL(test_on_batch_complete((void*)0x4242, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_dec_ref(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(realloc(NULL, sizeof(CONSTBUFFER_HANDLE) * 16));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_const_buffer_handle_array(payload_2));
+    STRICT_EXPECTED_CALL(write_uint32_t(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(test_buffers_2[0]));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(test_buffers_2[1]));
+
+    // act
+    result = constbuffer_array_batcher_append(batcher, payload_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(test_batch);
+    ASSERT_ARE_EQUAL(int, 0, real_constbuffer_array_get_buffer_count(test_batch, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 3, buffer_count);
+    ASSERT_ARE_EQUAL(void_ptr, test_buffers_1[0], real_constbuffer_array_get_const_buffer_handle_array(test_batch)[1]);
+    ASSERT_ARE_EQUAL(void_ptr, test_buffers_1[1], real_constbuffer_array_get_const_buffer_handle_array(test_batch)[2]);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(test_batch);
+    constbuffer_array_batcher_destroy(batcher);
+    real_constbuffer_array_dec_ref(payload_1);
+    real_constbuffer_array_dec_ref(payload_2);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_028: [ If getting the number of buffers or the size of payload fails, constbuffer_array_batcher_append shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_getting_the_buffer_count_fails_constbuffer_array_batcher_append_fails)
+{
+    // arrange
+    int result;
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(test_buffers);
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher = constbuffer_array_batcher_create(2, UINT32_MAX, test_on_batch_complete, (void*)0x4242);
+    ASSERT_IS_NOT_NULL(batcher);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(payload, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+
+    // act
+    result = constbuffer_array_batcher_append(batcher, payload);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(test_batch);
+
+    // cleanup
+    constbuffer_array_batcher_destroy(batcher);
+    real_constbuffer_array_dec_ref(payload);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_028: [ If getting the number of buffers or the size of payload fails, constbuffer_array_batcher_append shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_the_payload_size_overflows_constbuffer_array_batcher_append_fails)
+{
+    // arrange
+    int result;
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(test_buffers);
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher = constbuffer_array_batcher_create(2, UINT32_MAX, test_on_batch_complete, (void*)0x4242);
+    ASSERT_IS_NOT_NULL(batcher);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(payload, IGNORED_ARG));
+    /* constbuffer_array_get_all_buffers_size fails when the buffers add up to more than UINT32_MAX bytes */
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(payload, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+
+    // act
+    result = constbuffer_array_batcher_append(batcher, payload);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(test_batch);
+
+    // cleanup
+    constbuffer_array_batcher_destroy(batcher);
+    real_constbuffer_array_dec_ref(payload);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_018: [ If any error occurs, constbuffer_array_batcher_append shall fail, leave the payloads appended before unchanged and return a non-zero value. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_batcher_append_fails)
+{
+    // arrange
+    int result;
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(test_buffers);
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher;
+    size_t i;
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(realloc(NULL, sizeof(uint32_t) * 2));
+    STRICT_EXPECTED_CALL(realloc(NULL, sizeof(CONSTBUFFER_HANDLE) * 16));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_const_buffer_handle_array(payload))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(write_uint32_t(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(test_buffers[0]));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(test_buffers[1]));
+    STRICT_EXPECTED_CALL(write_uint32_t(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_Create(IGNORED_ARG, sizeof(uint32_t) * 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 3));
+    STRICT_EXPECTED_CALL(test_on_batch_complete((void*)0x4242, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_dec_ref(IGNORED_ARG));
+
+    umock_c_negative_tests_snapshot();
+
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            batcher = constbuffer_array_batcher_create(1, UINT32_MAX, test_on_batch_complete, (void*)0x4242);
+            ASSERT_IS_NOT_NULL(batcher);
+
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            result = constbuffer_array_batcher_append(batcher, payload);
+
+            // assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+            ASSERT_IS_NULL(test_batch, "On failed call %zu", i);
+
+            // cleanup
+            constbuffer_array_batcher_destroy(batcher);
+        }
+    }
+
+    // cleanup
+    real_constbuffer_array_dec_ref(payload);
+}
+
+/* constbuffer_array_batcher_finish */
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_023: [ If batcher is NULL, constbuffer_array_batcher_finish shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_finish_with_NULL_batcher_fails)
+{
+    // arrange
+    int result;
+
+    // act
+    result = constbuffer_array_batcher_finish(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_024: [ If no payload was appended since the last batch was produced, constbuffer_array_batcher_finish shall return 0 without producing a batch. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_finish_with_no_payload_does_not_produce_a_batch)
+{
+    // arrange
+    int result;
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher = constbuffer_array_batcher_create(UINT32_MAX, UINT32_MAX, test_on_batch_complete, (void*)0x4242);
+    ASSERT_IS_NOT_NULL(batcher);
+    umock_c_reset_all_calls();
+
+    // act
+    result = constbuffer_array_batcher_finish(batcher);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(test_batch);
+
+    // cleanup
+    constbuffer_array_batcher_destroy(batcher);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_025: [ Otherwise constbuffer_array_batcher_finish shall produce the batch from the payloads appended since the last batch was produced. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_027: [ On success constbuffer_array_batcher_finish shall return 0. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_finish_produces_the_batch_being_built)
+{
+    // arrange
+    int result;
+    CONSTBUFFER_HANDLE test_buffers_1[2];
+    CONSTBUFFER_HANDLE test_buffers_2[2];
+    CONSTBUFFER_ARRAY_HANDLE payload_1 = create_test_payload(test_buffers_1);
+    CONSTBUFFER_ARRAY_HANDLE payload_2 = create_test_payload(test_buffers_2);
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher = constbuffer_array_batcher_create(UINT32_MAX, UINT32_MAX, test_on_batch_complete, (void*)0x4242);
+    uint8_t expected_header_memory[] = { 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02 };
+    uint32_t buffer_count;
+    ASSERT_IS_NOT_NULL(batcher);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_append(batcher, payload_1));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_append(batcher, payload_2));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(write_uint32_t(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_Create(IGNORED_ARG, sizeof(uint32_t) * 3))
+        .ValidateArgumentBuffer(1, expected_header_memory, sizeof(expected_header_memory));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 5));
+    STRICT_EXPECTED_CALL(test_on_batch_complete((void*)0x4242, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_dec_ref(IGNORED_ARG));
+
+    // act
+    result = constbuffer_array_batcher_finish(batcher);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(test_batch);
+    ASSERT_ARE_EQUAL(int, 0, real_constbuffer_array_get_buffer_count(test_batch, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 5, buffer_count);
+    ASSERT_ARE_EQUAL(void_ptr, test_buffers_1[0], real_constbuffer_array_get_const_buffer_handle_array(test_batch)[1]);
+    ASSERT_ARE_EQUAL(void_ptr, test_buffers_2[1], real_constbuffer_array_get_const_buffer_handle_array(test_batch)[4]);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(test_batch);
+    constbuffer_array_batcher_destroy(batcher);
+    real_constbuffer_array_dec_ref(payload_1);
+    real_constbuffer_array_dec_ref(payload_2);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_04_026: [ If any error occurs, constbuffer_array_batcher_finish shall fail and return a non-zero value, the appended payloads are kept. ]*/
+TEST_FUNCTION(when_producing_the_batch_fails_constbuffer_array_batcher_finish_fails_and_keeps_the_payloads)
+{
+    // arrange
+    int result;
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(test_buffers);
+    CONSTBUFFER_ARRAY_BATCHER_HANDLE batcher = constbuffer_array_batcher_create(UINT32_MAX, UINT32_MAX, test_on_batch_complete, (void*)0x4242);
+    uint32_t buffer_count;
+    ASSERT_IS_NOT_NULL(batcher);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_append(batcher, payload));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(write_uint32_t(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_Create(IGNORED_ARG, sizeof(uint32_t) * 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 3))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
+
+    // act
+    result = constbuffer_array_batcher_finish(batcher);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(test_batch);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_finish(batcher));
+    ASSERT_IS_NOT_NULL(test_batch);
+    ASSERT_ARE_EQUAL(int, 0, real_constbuffer_array_get_buffer_count(test_batch, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 3, buffer_count);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(test_batch);
+    constbuffer_array_batcher_destroy(batcher);
+    real_constbuffer_array_dec_ref(payload);
+}
+
 END_TEST_SUITE(constbuffer_array_batcher_unittests)
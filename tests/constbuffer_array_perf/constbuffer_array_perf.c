@@ -0,0 +1,234 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+#include "azure_c_shared_utility/constbuffer.h"
+#include "azure_c_shared_utility/constbuffer_array.h"
+
+#include "perf_measure.h"
+
+#define CONSTBUFFER_ARRAY_PERF_SIZE_ITERATIONS 1000000
+#define CONSTBUFFER_ARRAY_PERF_BUFFER_SIZE 16
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static const unsigned char g_data[CONSTBUFFER_ARRAY_PERF_BUFFER_SIZE] = { 0 };
+
+typedef struct CONSTBUFFER_ARRAY_PERF_CONTEXT_TAG
+{
+    CONSTBUFFER_HANDLE buffer;
+    CONSTBUFFER_ARRAY_HANDLE array;
+    /*how many times the operation ran, over the counted and the timed run*/
+    uint32_t calls;
+} CONSTBUFFER_ARRAY_PERF_CONTEXT;
+
+/*a message being built by adding the headers of each protocol layer in front of it*/
+static void add_front(void* context, size_t iteration)
+{
+    CONSTBUFFER_ARRAY_PERF_CONTEXT* perf_context = (CONSTBUFFER_ARRAY_PERF_CONTEXT*)context;
+    CONSTBUFFER_ARRAY_HANDLE new_array = constbuffer_array_add_front(perf_context->array, perf_context->buffer);
+    (void)iteration;
+    if (new_array == NULL)
+    {
+        ASSERT_FAIL("constbuffer_array_add_front failed");
+    }
+    constbuffer_array_dec_ref(perf_context->array);
+    perf_context->array = new_array;
+    perf_context->calls++;
+}
+
+/*a queue of buffers being sent one at a time*/
+static void remove_front(void* context, size_t iteration)
+{
+    CONSTBUFFER_ARRAY_PERF_CONTEXT* perf_context = (CONSTBUFFER_ARRAY_PERF_CONTEXT*)context;
+    CONSTBUFFER_HANDLE removed;
+    CONSTBUFFER_ARRAY_HANDLE new_array = constbuffer_array_remove_front(perf_context->array, &removed);
+    (void)iteration;
+    if (new_array == NULL)
+    {
+        ASSERT_FAIL("constbuffer_array_remove_front failed");
+    }
+    CONSTBUFFER_DecRef(removed);
+    constbuffer_array_dec_ref(perf_context->array);
+    perf_context->array = new_array;
+    perf_context->calls++;
+}
+
+static void get_all_buffers_size(void* context, size_t iteration)
+{
+    CONSTBUFFER_ARRAY_PERF_CONTEXT* perf_context = (CONSTBUFFER_ARRAY_PERF_CONTEXT*)context;
+    uint32_t all_buffers_size;
+    (void)iteration;
+    if (constbuffer_array_get_all_buffers_size(perf_context->array, &all_buffers_size) != 0)
+    {
+        ASSERT_FAIL("constbuffer_array_get_all_buffers_size failed");
+    }
+    perf_context->calls++;
+}
+
+static void create_context(CONSTBUFFER_ARRAY_PERF_CONTEXT* perf_context, uint32_t buffer_count)
+{
+    CONSTBUFFER_HANDLE* buffers = (CONSTBUFFER_HANDLE*)malloc(sizeof(CONSTBUFFER_HANDLE) * (buffer_count + 1));
+    uint32_t i;
+    ASSERT_IS_NOT_NULL(buffers);
+
+    perf_context->buffer = CONSTBUFFER_Create(g_data, sizeof(g_data));
+    ASSERT_IS_NOT_NULL(perf_context->buffer);
+    for (i = 0; i < buffer_count; i++)
+    {
+        buffers[i] = perf_context->buffer;
+    }
+    perf_context->array = constbuffer_array_create(buffers, buffer_count);
+    ASSERT_IS_NOT_NULL(perf_context->array);
+    perf_context->calls = 0;
+
+    free(buffers);
+}
+
+static void destroy_context(CONSTBUFFER_ARRAY_PERF_CONTEXT* perf_context)
+{
+    constbuffer_array_dec_ref(perf_context->array);
+    CONSTBUFFER_DecRef(perf_context->buffer);
+}
+
+static uint32_t get_buffer_count(CONSTBUFFER_ARRAY_HANDLE array)
+{
+    uint32_t result;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(array, &result));
+    return result;
+}
+
+static PERF_MEASURE_RESULT run_add_front(uint32_t buffer_count)
+{
+    char name[64];
+    CONSTBUFFER_ARRAY_PERF_CONTEXT perf_context;
+    PERF_MEASURE_RESULT result;
+    create_context(&perf_context, 0);
+    (void)sprintf(name, "constbuffer_array_add_front (%u buffers)", (unsigned int)buffer_count);
+
+    ///act
+    result = perf_measure_run(name, add_front, &perf_context, buffer_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, perf_context.calls, get_buffer_count(perf_context.array));
+
+    destroy_context(&perf_context);
+    return result;
+}
+
+static PERF_MEASURE_RESULT run_remove_front(uint32_t buffer_count)
+{
+    char name[64];
+    CONSTBUFFER_ARRAY_PERF_CONTEXT perf_context;
+    PERF_MEASURE_RESULT result;
+    /*the counted run removes buffers too*/
+    create_context(&perf_context, 2 * buffer_count);
+    (void)sprintf(name, "constbuffer_array_remove_front (%u buffers)", (unsigned int)buffer_count);
+
+    ///act
+    result = perf_measure_run(name, remove_front, &perf_context, buffer_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 2 * buffer_count - perf_context.calls, get_buffer_count(perf_context.array));
+
+    destroy_context(&perf_context);
+    return result;
+}
+
+static PERF_MEASURE_RESULT run_get_all_buffers_size(uint32_t buffer_count)
+{
+    char name[64];
+    CONSTBUFFER_ARRAY_PERF_CONTEXT perf_context;
+    PERF_MEASURE_RESULT result;
+    uint32_t all_buffers_size;
+    create_context(&perf_context, buffer_count);
+    (void)sprintf(name, "constbuffer_array_get_all_buffers_size (%u buffers)", (unsigned int)buffer_count);
+
+    ///act
+    result = perf_measure_run(name, get_all_buffers_size, &perf_context, CONSTBUFFER_ARRAY_PERF_SIZE_ITERATIONS);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size(perf_context.array, &all_buffers_size));
+    ASSERT_ARE_EQUAL(uint32_t, buffer_count * CONSTBUFFER_ARRAY_PERF_BUFFER_SIZE, all_buffers_size);
+
+    destroy_context(&perf_context);
+    return result;
+}
+
+BEGIN_TEST_SUITE(constbuffer_array_perf)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+TEST_FUNCTION(constbuffer_array_add_front_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result1k = run_add_front(1000);
+    PERF_MEASURE_RESULT result10k = run_add_front(10000);
+    PERF_MEASURE_RESULT result100k = run_add_front(100000);
+
+    ///assert
+    /*the handles are shared or copied into a storage allocated with the array, never both*/
+    ASSERT_IS_TRUE(result1k.allocations_per_op == 1.0);
+    ASSERT_IS_TRUE(result10k.allocations_per_op == 1.0);
+    ASSERT_IS_TRUE(result100k.allocations_per_op == 1.0);
+}
+
+TEST_FUNCTION(constbuffer_array_remove_front_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result1k = run_remove_front(1000);
+    PERF_MEASURE_RESULT result10k = run_remove_front(10000);
+    PERF_MEASURE_RESULT result100k = run_remove_front(100000);
+
+    ///assert
+    ASSERT_IS_TRUE(result1k.allocations_per_op == 1.0);
+    ASSERT_IS_TRUE(result10k.allocations_per_op == 1.0);
+    ASSERT_IS_TRUE(result100k.allocations_per_op == 1.0);
+}
+
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result1k = run_get_all_buffers_size(1000);
+    PERF_MEASURE_RESULT result100k = run_get_all_buffers_size(100000);
+
+    ///assert
+    ASSERT_IS_TRUE(result1k.allocations_per_op == 0.0);
+    ASSERT_IS_TRUE(result100k.allocations_per_op == 0.0);
+}
+
+END_TEST_SUITE(constbuffer_array_perf)
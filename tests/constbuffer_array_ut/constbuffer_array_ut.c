@@ -97,6 +97,7 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_HANDLE, void*);
 
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_GetContent, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_CreateFromOffsetAndSize, NULL);
 
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(gballoc_malloc, NULL);
@@ -165,6 +166,7 @@ static void constbuffer_array_create_empty_inert_path(void)
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_009: [ constbuffer_array_create shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that can hold buffer_count buffers. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_010: [ constbuffer_array_create shall clone the buffers in buffers and store them. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_011: [ On success constbuffer_array_create shall return a non-NULL handle. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_032: [ constbuffer_array_create shall compute the total size of the buffers by calling CONSTBUFFER_GetContent for each buffer. ]*/
 TEST_FUNCTION(constbuffer_array_create_succeeds)
 {
     ///arrange
@@ -177,6 +179,8 @@ TEST_FUNCTION(constbuffer_array_create_succeeds)
     STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
     STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
     STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
 
     ///act
     constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
@@ -244,6 +248,10 @@ TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_create_fails)
     STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
     STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
     STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+        .CallCannotFail();
 
     umock_c_negative_tests_snapshot();
     for (i = 0; i < umock_c_negative_tests_call_count(); i++)
@@ -282,6 +290,7 @@ TEST_FUNCTION(constbuffer_array_create_with_move_buffers_with_NULL_buffers_fails
 
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_029: [ Otherwise, constbuffer_array_create_with_move_buffers shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that holds the const buffers in buffers. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_031: [ On success constbuffer_array_create_with_move_buffers shall return a non-NULL handle. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_033: [ constbuffer_array_create_with_move_buffers shall compute the total size of the buffers by calling CONSTBUFFER_GetContent for each buffer. ]*/
 TEST_FUNCTION(constbuffer_array_create_with_move_buffers_succeeds)
 {
     ///arrange
@@ -296,6 +305,8 @@ TEST_FUNCTION(constbuffer_array_create_with_move_buffers_succeeds)
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
 
     ///act
     constbuffer_array = constbuffer_array_create_with_move_buffers(test_buffers, 2);
@@ -323,6 +334,10 @@ TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_create_with_move_buff
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+        .CallCannotFail();
 
     umock_c_negative_tests_snapshot();
     for (i = 0; i < umock_c_negative_tests_call_count(); i++)
@@ -439,15 +454,12 @@ static CONSTBUFFER_ARRAY_HANDLE TEST_constbuffer_array_add_front(CONSTBUFFER_ARR
 
 static CONSTBUFFER_ARRAY_HANDLE TEST_constbuffer_array_remove_front(CONSTBUFFER_ARRAY_HANDLE constbuffer_array, uint32_t nExistingBuffers, CONSTBUFFER_HANDLE* constbuffer_handle)
 {
-    uint32_t i;
     CONSTBUFFER_ARRAY_HANDLE result;
 
     ASSERT_IS_TRUE(nExistingBuffers > 0);
     STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
-    for (i = 0; i < nExistingBuffers-1; i++)
-    {
-        STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(IGNORED_ARG));
-    }
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
 
     result = constbuffer_array_remove_front(constbuffer_array, constbuffer_handle);
     ASSERT_IS_NOT_NULL(result);
@@ -952,75 +964,187 @@ TEST_FUNCTION(constbuffer_array_create_from_array_array_fails_if_malloc_fails)
     }
 }
 
-/*constbuffer_array_add_front*/
+/* constbuffer_array_create_from_buffer_index_and_count */
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_006: [ If constbuffer_array_handle is NULL then constbuffer_array_add_front shall fail and return NULL ]*/
-TEST_FUNCTION(constbuffer_array_add_front_with_constbuffer_array_handle_NULL_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_001: [ If constbuffer_array_handle is NULL then constbuffer_array_create_from_buffer_index_and_count shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_with_NULL_constbuffer_array_handle_fails)
 {
     ///arrange
+    CONSTBUFFER_ARRAY_HANDLE result;
 
     ///act
-    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_add_front(NULL, TEST_CONSTBUFFER_HANDLE_1);
+    result = constbuffer_array_create_from_buffer_index_and_count(NULL, 0, 0);
 
     ///assert
     ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_007: [ If constbuffer_handle is NULL then constbuffer_array_add_front shall fail and return NULL ]*/
-TEST_FUNCTION(constbuffer_array_add_front_with_constbuffer_handle_NULL_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_002: [ If start_buffer_index is greater than the number of buffers in constbuffer_array_handle then constbuffer_array_create_from_buffer_index_and_count shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_with_start_buffer_index_out_of_range_fails)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
 
     ///act
-    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, NULL);
+    result = constbuffer_array_create_from_buffer_index_and_count(constbuffer_array, 4, 0);
 
     ///assert
     ASSERT_IS_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    ///clean
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    ///cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
 }
 
-static void constbuffer_array_add_front_inert_path(void)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_003: [ If start_buffer_index + buffer_count is greater than the number of buffers in constbuffer_array_handle then constbuffer_array_create_from_buffer_index_and_count shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_with_buffer_count_out_of_range_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    ///act
+    result = constbuffer_array_create_from_buffer_index_and_count(constbuffer_array, 1, 3);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_003: [ If start_buffer_index + buffer_count is greater than the number of buffers in constbuffer_array_handle then constbuffer_array_create_from_buffer_index_and_count shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_with_buffer_count_UINT32_MAX_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    ///act
+    result = constbuffer_array_create_from_buffer_index_and_count(constbuffer_array, 1, UINT32_MAX);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_004: [ If the range is all the buffers of constbuffer_array_handle then constbuffer_array_create_from_buffer_index_and_count shall inc_ref constbuffer_array_handle and return it. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_with_all_the_buffers_returns_constbuffer_array_handle)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    ///act
+    result = constbuffer_array_create_from_buffer_index_and_count(constbuffer_array, 0, 3);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, constbuffer_array, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(result);
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_005: [ Otherwise constbuffer_array_create_from_buffer_index_and_count shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_006: [ constbuffer_array_create_from_buffer_index_and_count shall share the storage of constbuffer_array_handle, the new CONSTBUFFER_ARRAY_HANDLE holding buffer_count CONSTBUFFER_HANDLEs starting at start_buffer_index, without copying nor inc_ref-ing them. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_007: [ constbuffer_array_create_from_buffer_index_and_count shall compute the total size of the buffers by calling CONSTBUFFER_GetContent for each buffer in the range. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_009: [ constbuffer_array_create_from_buffer_index_and_count shall succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_shares_the_storage)
 {
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    const CONSTBUFFER_HANDLE* result_buffers;
+    uint32_t buffer_count;
+    uint32_t all_buffers_size;
+
     STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
+
+    ///act
+    result = constbuffer_array_create_from_buffer_index_and_count(constbuffer_array, 1, 2);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    result_buffers = constbuffer_array_get_const_buffer_handle_array(result);
+    ASSERT_ARE_EQUAL(void_ptr, constbuffer_array_get_const_buffer_handle_array(constbuffer_array) + 1, result_buffers);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 2, buffer_count);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size(result, &all_buffers_size));
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(two) + sizeof(three), all_buffers_size);
+
+    ///cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(result);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_042: [ constbuffer_array_add_front shall allocate enough memory to hold all of constbuffer_array_handle existing CONSTBUFFER_HANDLE and constbuffer_handle. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_043: [ constbuffer_array_add_front shall copy constbuffer_handle and all of constbuffer_array_handle existing CONSTBUFFER_HANDLE. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_044: [ constbuffer_array_add_front shall inc_ref all the CONSTBUFFER_HANDLE it had copied. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_010: [ constbuffer_array_add_front shall succeed and return a non-NULL value. ]*/
-TEST_FUNCTION(constbuffer_array_add_front_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_006: [ constbuffer_array_create_from_buffer_index_and_count shall share the storage of constbuffer_array_handle, the new CONSTBUFFER_ARRAY_HANDLE holding buffer_count CONSTBUFFER_HANDLEs starting at start_buffer_index, without copying nor inc_ref-ing them. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_with_0_buffers_succeeds)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
     CONSTBUFFER_ARRAY_HANDLE result;
+    uint32_t buffer_count;
 
-    constbuffer_array_add_front_inert_path();
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
 
     ///act
-    result = constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_1);
+    result = constbuffer_array_create_from_buffer_index_and_count(constbuffer_array, 3, 0);
 
     ///assert
     ASSERT_IS_NOT_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 0, buffer_count);
 
-    ///clean
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    ///cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
     constbuffer_array_dec_ref(result);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_011: [ If there any failures constbuffer_array_add_front shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_add_front_unhappy_paths)
+/*Tests_SRS_CONSTBUFFER_ARRAY_01_040: [ When the last CONSTBUFFER_ARRAY_HANDLE sharing a storage is freed, constbuffer_array_dec_ref shall dec_ref all the CONSTBUFFER_HANDLEs in the storage and free it. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_keeps_the_buffers_after_constbuffer_array_handle_is_freed)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_create_from_buffer_index_and_count(constbuffer_array, 0, 1);
+    CONSTBUFFER_HANDLE buffer;
+    ASSERT_IS_NOT_NULL(result);
+    umock_c_reset_all_calls();
+
+    ///act
+    constbuffer_array_dec_ref(constbuffer_array);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    buffer = constbuffer_array_get_buffer(result, 0);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, buffer);
+
+    ///cleanup
+    CONSTBUFFER_DecRef(buffer);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_008: [ If there are any failures then constbuffer_array_create_from_buffer_index_and_count shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_create_from_buffer_index_and_count_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
     size_t i;
 
-    constbuffer_array_add_front_inert_path();
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+        .CallCannotFail();
 
     umock_c_negative_tests_snapshot();
     for (i = 0; i < umock_c_negative_tests_call_count(); i++)
@@ -1033,1113 +1157,2318 @@ TEST_FUNCTION(constbuffer_array_add_front_unhappy_paths)
             umock_c_negative_tests_fail_call(i);
 
             ///act
-            result = constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_1);
+            result = constbuffer_array_create_from_buffer_index_and_count(constbuffer_array, 1, 1);
 
             ///assert
             ASSERT_IS_NULL(result);
         }
     }
 
-    ///clean
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    ///cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_012: [ If constbuffer_array_handle is NULL then constbuffer_array_remove_front shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_remove_front_with_constbuffer_array_handle_NULL_fails)
+/* constbuffer_array_create_from_offset_and_size */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_010: [ If constbuffer_array_handle is NULL then constbuffer_array_create_from_offset_and_size shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_offset_and_size_with_NULL_constbuffer_array_handle_fails)
 {
     ///arrange
-    CONSTBUFFER_HANDLE constbuffer_handle;
+    CONSTBUFFER_ARRAY_HANDLE result;
 
     ///act
-    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_remove_front(NULL, &constbuffer_handle);
+    result = constbuffer_array_create_from_offset_and_size(NULL, 0, 1);
 
     ///assert
     ASSERT_IS_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_045: [ If constbuffer_handle is NULL then constbuffer_array_remove_front shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_remove_front_with_constbuffer_handle_NULL_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_011: [ If the total size of the buffers in constbuffer_array_handle overflows uint32_t then constbuffer_array_create_from_offset_and_size shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_offset_and_size_when_the_size_overflows_fails)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    CONSTBUFFER_ARRAY_HANDLE result;
+    CONSTBUFFER_HANDLE test_buffers[2];
+    const CONSTBUFFER fake_const_buffer_1 = { (const unsigned char*)0x4242, UINT32_MAX };
+    const CONSTBUFFER fake_const_buffer_2 = { (const unsigned char*)0x4242, 1 };
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_2;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_1;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+        .SetReturn(&fake_const_buffer_2);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .SetReturn(&fake_const_buffer_1);
+    constbuffer_array = constbuffer_array_create(test_buffers, 2);
+    ASSERT_IS_NOT_NULL(constbuffer_array);
+    umock_c_reset_all_calls();
 
     ///act
-    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_remove_front(TEST_CONSTBUFFER_ARRAY_HANDLE, NULL);
+    result = constbuffer_array_create_from_offset_and_size(constbuffer_array, 0, 1);
 
     ///assert
     ASSERT_IS_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    ///clean
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    ///cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_002: [ constbuffer_array_remove_front shall fail when called on a newly constructed CONSTBUFFER_ARRAY_HANDLE. ]*/
-TEST_FUNCTION(constbuffer_array_remove_front_with_constbuffer_array_handle_empty_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_012: [ If offset + size is greater than the total size of the buffers in constbuffer_array_handle then constbuffer_array_create_from_offset_and_size shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_offset_and_size_with_size_out_of_range_fails)
 {
     ///arrange
-    CONSTBUFFER_HANDLE constbuffer_handle;
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
 
     ///act
-    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_remove_front(TEST_CONSTBUFFER_ARRAY_HANDLE, &constbuffer_handle);
+    result = constbuffer_array_create_from_offset_and_size(constbuffer_array, 2, 5);
 
     ///assert
     ASSERT_IS_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_013: [ If there is no front CONSTBUFFER_HANDLE then constbuffer_array_remove_front shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_remove_front_with_constbuffer_array_handle_empty_fails_2)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_012: [ If offset + size is greater than the total size of the buffers in constbuffer_array_handle then constbuffer_array_create_from_offset_and_size shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_offset_and_size_with_offset_out_of_range_fails)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_HANDLE removed;
-    CONSTBUFFER_ARRAY_HANDLE afterRemove = TEST_constbuffer_array_remove_front(afterAdd, 1, &removed); /*maybe this is a different kind of empty*/ /*shrugs*/
-    CONSTBUFFER_HANDLE removed2;
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
     CONSTBUFFER_ARRAY_HANDLE result;
-    CONSTBUFFER_DecRef(removed);
-    TEST_constbuffer_array_dec_ref(afterAdd, 1);
-    umock_c_reset_all_calls();
 
     ///act
-    result = constbuffer_array_remove_front(afterRemove, &removed2);
+    result = constbuffer_array_create_from_offset_and_size(constbuffer_array, 7, 0);
 
     ///assert
     ASSERT_IS_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///cleanup
-    constbuffer_array_dec_ref(afterRemove);
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-}
-
-static void constbuffer_array_remove_front_inert_path(uint32_t nExistingItems)
-{
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
-    // clone front buffer
-    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(IGNORED_ARG));
-    if (nExistingItems > 0)
-    {
-        uint32_t i;
-        for (i = 0; i < nExistingItems-1; i++)
-        {
-            STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(IGNORED_ARG));
-        }
-    }
+    constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_046: [ constbuffer_array_remove_front shall allocate memory to hold all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the front one. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_047: [ constbuffer_array_remove_front shall copy all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the front one. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_048: [ constbuffer_array_remove_front shall inc_ref all the copied CONSTBUFFER_HANDLEs. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_01_001: [ constbuffer_array_remove_front shall inc_ref the removed buffer. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_049: [ constbuffer_array_remove_front shall succeed, write in constbuffer_handle the front handle and return a non-NULL value. ]*/
-TEST_FUNCTION(constbuffer_array_remove_front_with_1_item_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_013: [ If size is 0 then constbuffer_array_create_from_offset_and_size shall create a new, empty CONSTBUFFER_ARRAY_HANDLE. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_offset_and_size_with_size_0_creates_an_empty_array)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd =TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_HANDLE removed;
-    CONSTBUFFER_ARRAY_HANDLE afterRemove;
-
-    umock_c_reset_all_calls();
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    uint32_t buffer_count;
 
-    constbuffer_array_remove_front_inert_path(1);
+    constbuffer_array_create_empty_inert_path();
 
     ///act
-    afterRemove = constbuffer_array_remove_front(afterAdd, &removed);
+    result = constbuffer_array_create_from_offset_and_size(constbuffer_array, 6, 0);
 
     ///assert
-    ASSERT_IS_NOT_NULL(removed);
-    ASSERT_IS_NOT_NULL(afterRemove);
-    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, removed);
+    ASSERT_IS_NOT_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 0, buffer_count);
 
     ///cleanup
-    constbuffer_array_dec_ref(afterRemove);
-    constbuffer_array_dec_ref(afterAdd);
-    CONSTBUFFER_DecRef(removed);
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(result);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_046: [ constbuffer_array_remove_front shall allocate memory to hold all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the front one. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_047: [ constbuffer_array_remove_front shall copy all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the front one. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_048: [ constbuffer_array_remove_front shall inc_ref all the copied CONSTBUFFER_HANDLEs. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_01_001: [ constbuffer_array_remove_front shall inc_ref the removed buffer. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_049: [ constbuffer_array_remove_front shall succeed, write in constbuffer_handle the front handle and return a non-NULL value. ]*/
-TEST_FUNCTION(constbuffer_array_remove_front_with_2_items_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_014: [ If the slice starts and ends at buffer boundaries, constbuffer_array_create_from_offset_and_size shall share the storage of constbuffer_array_handle like constbuffer_array_create_from_buffer_index_and_count does. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_017: [ constbuffer_array_create_from_offset_and_size shall succeed and return a non-NULL value holding the size bytes that start offset bytes into constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_offset_and_size_at_buffer_boundaries_shares_the_storage)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    CONSTBUFFER_HANDLE removed = NULL;
-    CONSTBUFFER_ARRAY_HANDLE afterRemove1;
-    umock_c_reset_all_calls();
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
 
-    constbuffer_array_remove_front_inert_path(2);
+    /*finding where the slice starts and ends*/
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
+    /*the view*/
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
 
     ///act
-    afterRemove1 = constbuffer_array_remove_front(afterAdd2, &removed);
+    result = constbuffer_array_create_from_offset_and_size(constbuffer_array, sizeof(one), sizeof(two) + sizeof(three));
 
     ///assert
-    ASSERT_IS_NOT_NULL(afterRemove1);
-    ASSERT_IS_NOT_NULL(removed);
-    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, removed);
+    ASSERT_IS_NOT_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, constbuffer_array_get_const_buffer_handle_array(constbuffer_array) + 1, constbuffer_array_get_const_buffer_handle_array(result));
 
     ///cleanup
-    constbuffer_array_dec_ref(afterRemove1);
-    CONSTBUFFER_DecRef(removed);
-    constbuffer_array_dec_ref(afterAdd2);
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(result);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_036: [ If there are any failures then constbuffer_array_remove_front shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_remove_front_unhappy_paths)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_015: [ Otherwise constbuffer_array_create_from_offset_and_size shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that can hold the buffers in the slice. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_016: [ constbuffer_array_create_from_offset_and_size shall inc_ref the buffers that are entirely in the slice and shall call CONSTBUFFER_CreateFromOffsetAndSize for the first and the last buffer when only a part of them is in the slice. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_017: [ constbuffer_array_create_from_offset_and_size shall succeed and return a non-NULL value holding the size bytes that start offset bytes into constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_offset_and_size_across_buffers_succeeds)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    size_t i;
-    umock_c_reset_all_calls();
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(4, 1); /*22 333 4444 55555*/
+    CONSTBUFFER_ARRAY_HANDLE result;
+    const CONSTBUFFER* content;
+    uint32_t buffer_count;
+    uint32_t all_buffers_size;
 
-    constbuffer_array_remove_front_inert_path(1);
+    /*finding where the slice starts and ends*/
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_4));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_5));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateFromOffsetAndSize(TEST_CONSTBUFFER_HANDLE_3, 1, 2));
+    STRICT_EXPECTED_CALL(gballoc_calloc(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_4));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_4));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_4));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_5));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateFromOffsetAndSize(TEST_CONSTBUFFER_HANDLE_5, 0, 1));
+    STRICT_EXPECTED_CALL(gballoc_calloc(IGNORED_ARG, IGNORED_ARG));
 
-    umock_c_negative_tests_snapshot();
-    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
-    {
+    ///act
+    result = constbuffer_array_create_from_offset_and_size(constbuffer_array, sizeof(two) + 1, 2 + sizeof(four) + 1);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 3, buffer_count);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size(result, &all_buffers_size));
+    ASSERT_ARE_EQUAL(uint32_t, 2 + sizeof(four) + 1, all_buffers_size);
+    content = constbuffer_array_get_buffer_content(result, 0);
+    ASSERT_ARE_EQUAL(size_t, 2, content->size);
+    ASSERT_ARE_EQUAL(void_ptr, three + 1, content->buffer);
+    content = constbuffer_array_get_buffer_content(result, 1);
+    ASSERT_ARE_EQUAL(size_t, sizeof(four), content->size);
+    ASSERT_ARE_EQUAL(void_ptr, four, content->buffer);
+    content = constbuffer_array_get_buffer_content(result, 2);
+    ASSERT_ARE_EQUAL(size_t, 1, content->size);
+    ASSERT_ARE_EQUAL(void_ptr, five, content->buffer);
+
+    ///cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_016: [ constbuffer_array_create_from_offset_and_size shall inc_ref the buffers that are entirely in the slice and shall call CONSTBUFFER_CreateFromOffsetAndSize for the first and the last buffer when only a part of them is in the slice. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_offset_and_size_inside_one_buffer_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    const CONSTBUFFER* content;
+    uint32_t buffer_count;
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateFromOffsetAndSize(TEST_CONSTBUFFER_HANDLE_3, 1, 1));
+    STRICT_EXPECTED_CALL(gballoc_calloc(IGNORED_ARG, IGNORED_ARG));
+
+    ///act
+    result = constbuffer_array_create_from_offset_and_size(constbuffer_array, sizeof(one) + sizeof(two) + 1, 1);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 1, buffer_count);
+    content = constbuffer_array_get_buffer_content(result, 0);
+    ASSERT_ARE_EQUAL(size_t, 1, content->size);
+    ASSERT_ARE_EQUAL(void_ptr, three + 1, content->buffer);
+
+    ///cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_018: [ If there are any failures then constbuffer_array_create_from_offset_and_size shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_create_from_offset_and_size_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(4, 1); /*22 333 4444 55555*/
+    size_t i;
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_4))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_5))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateFromOffsetAndSize(TEST_CONSTBUFFER_HANDLE_3, 1, 2));
+    STRICT_EXPECTED_CALL(gballoc_calloc(IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail(); /*failing CONSTBUFFER_CreateFromOffsetAndSize covers it*/
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_4))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_4))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_4));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_5))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateFromOffsetAndSize(TEST_CONSTBUFFER_HANDLE_5, 0, 1));
+    STRICT_EXPECTED_CALL(gballoc_calloc(IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail();
+
+    umock_c_negative_tests_snapshot();
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
         if (umock_c_negative_tests_can_call_fail(i))
         {
-            CONSTBUFFER_HANDLE removed;
-            CONSTBUFFER_ARRAY_HANDLE afterRemove;
+            CONSTBUFFER_ARRAY_HANDLE result;
+
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            result = constbuffer_array_create_from_offset_and_size(constbuffer_array, sizeof(two) + 1, 2 + sizeof(four) + 1);
+
+            ///assert
+            ASSERT_IS_NULL(result);
+        }
+    }
+
+    ///cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/*constbuffer_array_add_front*/
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_006: [ If constbuffer_array_handle is NULL then constbuffer_array_add_front shall fail and return NULL ]*/
+TEST_FUNCTION(constbuffer_array_add_front_with_constbuffer_array_handle_NULL_fails)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_add_front(NULL, TEST_CONSTBUFFER_HANDLE_1);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_007: [ If constbuffer_handle is NULL then constbuffer_array_add_front shall fail and return NULL ]*/
+TEST_FUNCTION(constbuffer_array_add_front_with_constbuffer_handle_NULL_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, NULL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+static void constbuffer_array_add_front_inert_path(void)
+{
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .CallCannotFail();
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_042: [ Otherwise constbuffer_array_add_front shall allocate enough memory to hold all of constbuffer_array_handle existing CONSTBUFFER_HANDLE and constbuffer_handle, and as many free slots in front of them. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_043: [ constbuffer_array_add_front shall copy constbuffer_handle and all of constbuffer_array_handle existing CONSTBUFFER_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_044: [ constbuffer_array_add_front shall inc_ref all the CONSTBUFFER_HANDLE it had copied. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_010: [ constbuffer_array_add_front shall succeed and return a non-NULL value. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_01_038: [ constbuffer_array_add_front shall compute the total size of the buffers from the total size of constbuffer_array_handle and the size of constbuffer_handle obtained by calling CONSTBUFFER_GetContent. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    constbuffer_array_add_front_inert_path();
+
+    ///act
+    result = constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_1);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_011: [ If there any failures constbuffer_array_add_front shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_unhappy_paths)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    size_t i;
+
+    constbuffer_array_add_front_inert_path();
+
+    umock_c_negative_tests_snapshot();
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            CONSTBUFFER_ARRAY_HANDLE result;
+
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            result = constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_1);
+
+            ///assert
+            ASSERT_IS_NULL(result);
+        }
+    }
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_01_035: [ If there is a free slot in the storage just before the CONSTBUFFER_HANDLEs of constbuffer_array_handle and constbuffer_array_add_front was not already called on constbuffer_array_handle, constbuffer_array_add_front shall share the storage of constbuffer_array_handle: ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_01_036: [ constbuffer_array_add_front shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_01_037: [ constbuffer_array_add_front shall inc_ref constbuffer_handle and write it in the free slot. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_01_038: [ constbuffer_array_add_front shall compute the total size of the buffers from the total size of constbuffer_array_handle and the size of constbuffer_handle obtained by calling CONSTBUFFER_GetContent. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_010: [ constbuffer_array_add_front shall succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_shares_the_storage_when_there_is_a_free_slot)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    const CONSTBUFFER_HANDLE* afterAdd1_buffers;
+    const CONSTBUFFER_HANDLE* result_buffers;
+
+    /*no copy of TEST_CONSTBUFFER_HANDLE_1*/
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+
+    ///act
+    result = constbuffer_array_add_front(afterAdd1, TEST_CONSTBUFFER_HANDLE_2);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    afterAdd1_buffers = constbuffer_array_get_const_buffer_handle_array(afterAdd1);
+    result_buffers = constbuffer_array_get_const_buffer_handle_array(result);
+    ASSERT_ARE_EQUAL(void_ptr, afterAdd1_buffers, result_buffers + 1);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, result_buffers[0]);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result_buffers[1]);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_01_035: [ If there is a free slot in the storage just before the CONSTBUFFER_HANDLEs of constbuffer_array_handle and constbuffer_array_add_front was not already called on constbuffer_array_handle, constbuffer_array_add_front shall share the storage of constbuffer_array_handle: ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_042: [ Otherwise constbuffer_array_add_front shall allocate enough memory to hold all of constbuffer_array_handle existing CONSTBUFFER_HANDLE and constbuffer_handle, and as many free slots in front of them. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_043: [ constbuffer_array_add_front shall copy constbuffer_handle and all of constbuffer_array_handle existing CONSTBUFFER_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_044: [ constbuffer_array_add_front shall inc_ref all the CONSTBUFFER_HANDLE it had copied. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_twice_on_the_same_array_copies_the_second_time)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE first = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
+    CONSTBUFFER_ARRAY_HANDLE second;
+    const CONSTBUFFER_HANDLE* first_buffers;
+    const CONSTBUFFER_HANDLE* second_buffers;
+
+    /*the free slot is taken by first*/
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_3));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
+
+    ///act
+    second = constbuffer_array_add_front(afterAdd1, TEST_CONSTBUFFER_HANDLE_3);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(second);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    first_buffers = constbuffer_array_get_const_buffer_handle_array(first);
+    second_buffers = constbuffer_array_get_const_buffer_handle_array(second);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, first_buffers[0]);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, first_buffers[1]);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_3, second_buffers[0]);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, second_buffers[1]);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(first);
+    constbuffer_array_dec_ref(second);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_011: [ If there any failures constbuffer_array_add_front shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_fails_constbuffer_array_add_front_fails_and_the_free_slot_can_still_be_used)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+    result = constbuffer_array_add_front(afterAdd1, TEST_CONSTBUFFER_HANDLE_2);
+    ASSERT_IS_NULL(result);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+
+    ///act
+    result = constbuffer_array_add_front(afterAdd1, TEST_CONSTBUFFER_HANDLE_2);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, constbuffer_array_get_const_buffer_handle_array(afterAdd1), constbuffer_array_get_const_buffer_handle_array(result) + 1);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_012: [ If constbuffer_array_handle is NULL then constbuffer_array_remove_front shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_remove_front_with_constbuffer_array_handle_NULL_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE constbuffer_handle;
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_remove_front(NULL, &constbuffer_handle);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_045: [ If constbuffer_handle is NULL then constbuffer_array_remove_front shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_remove_front_with_constbuffer_handle_NULL_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_remove_front(TEST_CONSTBUFFER_ARRAY_HANDLE, NULL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_002: [ constbuffer_array_remove_front shall fail when called on a newly constructed CONSTBUFFER_ARRAY_HANDLE. ]*/
+TEST_FUNCTION(constbuffer_array_remove_front_with_constbuffer_array_handle_empty_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE constbuffer_handle;
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_remove_front(TEST_CONSTBUFFER_ARRAY_HANDLE, &constbuffer_handle);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_013: [ If there is no front CONSTBUFFER_HANDLE then constbuffer_array_remove_front shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_remove_front_with_constbuffer_array_handle_empty_fails_2)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_HANDLE removed;
+    CONSTBUFFER_ARRAY_HANDLE afterRemove = TEST_constbuffer_array_remove_front(afterAdd, 1, &removed); /*maybe this is a different kind of empty*/ /*shrugs*/
+    CONSTBUFFER_HANDLE removed2;
+    CONSTBUFFER_ARRAY_HANDLE result;
+    CONSTBUFFER_DecRef(removed);
+    TEST_constbuffer_array_dec_ref(afterAdd, 1);
+    umock_c_reset_all_calls();
+
+    ///act
+    result = constbuffer_array_remove_front(afterRemove, &removed2);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(afterRemove);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+static void constbuffer_array_remove_front_inert_path(CONSTBUFFER_HANDLE front)
+{
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    // clone front buffer
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(front));
+    // the rest of the buffers are shared, only the size of the front one is needed
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(front))
+        .CallCannotFail();
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_046: [ constbuffer_array_remove_front shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_047: [ constbuffer_array_remove_front shall share the storage of constbuffer_array_handle, the new CONSTBUFFER_ARRAY_HANDLE holding all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the front one. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_048: [ constbuffer_array_remove_front shall not copy nor inc_ref the CONSTBUFFER_HANDLEs it holds. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_01_001: [ constbuffer_array_remove_front shall inc_ref the removed buffer. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_01_039: [ constbuffer_array_remove_front shall compute the total size of the buffers by subtracting the size of the removed buffer obtained by calling CONSTBUFFER_GetContent from the total size of constbuffer_array_handle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_049: [ constbuffer_array_remove_front shall succeed, write in constbuffer_handle the front handle and return a non-NULL value. ]*/
+TEST_FUNCTION(constbuffer_array_remove_front_with_1_item_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd =TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_HANDLE removed;
+    CONSTBUFFER_ARRAY_HANDLE afterRemove;
+
+    umock_c_reset_all_calls();
+
+    constbuffer_array_remove_front_inert_path(TEST_CONSTBUFFER_HANDLE_1);
+
+    ///act
+    afterRemove = constbuffer_array_remove_front(afterAdd, &removed);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(removed);
+    ASSERT_IS_NOT_NULL(afterRemove);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, removed);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(afterRemove);
+    constbuffer_array_dec_ref(afterAdd);
+    CONSTBUFFER_DecRef(removed);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_046: [ constbuffer_array_remove_front shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_047: [ constbuffer_array_remove_front shall share the storage of constbuffer_array_handle, the new CONSTBUFFER_ARRAY_HANDLE holding all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the front one. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_048: [ constbuffer_array_remove_front shall not copy nor inc_ref the CONSTBUFFER_HANDLEs it holds. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_01_001: [ constbuffer_array_remove_front shall inc_ref the removed buffer. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_01_039: [ constbuffer_array_remove_front shall compute the total size of the buffers by subtracting the size of the removed buffer obtained by calling CONSTBUFFER_GetContent from the total size of constbuffer_array_handle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_049: [ constbuffer_array_remove_front shall succeed, write in constbuffer_handle the front handle and return a non-NULL value. ]*/
+TEST_FUNCTION(constbuffer_array_remove_front_with_2_items_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
+    CONSTBUFFER_HANDLE removed = NULL;
+    CONSTBUFFER_ARRAY_HANDLE afterRemove1;
+    umock_c_reset_all_calls();
+
+    constbuffer_array_remove_front_inert_path(TEST_CONSTBUFFER_HANDLE_2);
+
+    ///act
+    afterRemove1 = constbuffer_array_remove_front(afterAdd2, &removed);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(afterRemove1);
+    ASSERT_IS_NOT_NULL(removed);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, removed);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(afterRemove1);
+    CONSTBUFFER_DecRef(removed);
+    constbuffer_array_dec_ref(afterAdd2);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_036: [ If there are any failures then constbuffer_array_remove_front shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_remove_front_unhappy_paths)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    size_t i;
+    umock_c_reset_all_calls();
+
+    constbuffer_array_remove_front_inert_path(TEST_CONSTBUFFER_HANDLE_1);
+
+    umock_c_negative_tests_snapshot();
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            CONSTBUFFER_HANDLE removed;
+            CONSTBUFFER_ARRAY_HANDLE afterRemove;
+
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            afterRemove = constbuffer_array_remove_front(afterAdd, &removed);
+
+            ///assert
+            ASSERT_IS_NULL(afterRemove);
+        }
+    }
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_047: [ constbuffer_array_remove_front shall share the storage of constbuffer_array_handle, the new CONSTBUFFER_ARRAY_HANDLE holding all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the front one. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_048: [ constbuffer_array_remove_front shall not copy nor inc_ref the CONSTBUFFER_HANDLEs it holds. ]*/
+TEST_FUNCTION(constbuffer_array_remove_front_shares_the_storage)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_HANDLE removed;
+    CONSTBUFFER_ARRAY_HANDLE afterRemove;
+    const CONSTBUFFER_HANDLE* afterRemove_buffers;
+
+    constbuffer_array_remove_front_inert_path(TEST_CONSTBUFFER_HANDLE_1);
+
+    ///act
+    afterRemove = constbuffer_array_remove_front(constbuffer_array, &removed);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(afterRemove);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    afterRemove_buffers = constbuffer_array_get_const_buffer_handle_array(afterRemove);
+    ASSERT_ARE_EQUAL(void_ptr, constbuffer_array_get_const_buffer_handle_array(constbuffer_array) + 1, afterRemove_buffers);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, afterRemove_buffers[0]);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_3, afterRemove_buffers[1]);
+
+    ///cleanup
+    CONSTBUFFER_DecRef(removed);
+    constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(afterRemove);
+}
+
+/* constbuffer_array_get_buffer_count */
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_count_returns_0_for_an_empty_array)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create_empty();
+    uint32_t buffer_count;
+
+    // act
+    int result = constbuffer_array_get_buffer_count(constbuffer_array, &buffer_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, buffer_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_count_after_add_on_empty_array_yields_1)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
+    uint32_t buffer_count;
+
+    // act
+    int result = constbuffer_array_get_buffer_count(afterAdd1, &buffer_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, buffer_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_count_on_a_1_buffer_array_yields_1)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[1];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    uint32_t buffer_count;
+    int result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    // act
+    result = constbuffer_array_get_buffer_count(constbuffer_array, &buffer_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, buffer_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_count_on_a_2_buffer_array_yields_2)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    uint32_t buffer_count;
+    int result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    // act
+    result = constbuffer_array_get_buffer_count(constbuffer_array, &buffer_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, buffer_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_003: [ If constbuffer_array_handle is NULL, constbuffer_array_get_buffer_count shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_count_with_NULL_constbuffer_array_handle_fails)
+{
+    // arrange
+    uint32_t buffer_count;
+
+    // act
+    int result = constbuffer_array_get_buffer_count(NULL, &buffer_count);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_004: [ If buffer_count is NULL, constbuffer_array_get_buffer_count shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_count_with_NULL_buffer_count_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create_empty();
+
+    // act
+    int result = constbuffer_array_get_buffer_count(constbuffer_array, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* constbuffer_array_get_buffer */
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_005: [ On success, constbuffer_array_get_buffer shall return a non-NULL handle to the buffer_index-th const buffer in the array. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_006: [ The returned handle shall have its reference count incremented. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_succeeds)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    CONSTBUFFER_HANDLE result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+
+    // act
+    result = constbuffer_array_get_buffer(constbuffer_array, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+    CONSTBUFFER_DecRef(result);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_005: [ On success, constbuffer_array_get_buffer shall return a non-NULL handle to the buffer_index-th const buffer in the array. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_006: [ The returned handle shall have its reference count incremented. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_for_2nd_buffer_succeeds)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    CONSTBUFFER_HANDLE result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+
+    // act
+    result = constbuffer_array_get_buffer(constbuffer_array, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+    CONSTBUFFER_DecRef(result);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_007: [ If constbuffer_array_handle is NULL, constbuffer_array_get_buffer shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_with_NULL_constbuffer_array_handle_fails)
+{
+    // arrange
+    CONSTBUFFER_HANDLE result;
+
+    // act
+    result = constbuffer_array_get_buffer(NULL, 0);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_008: [ If buffer_index is greater or equal to the number of buffers in the array, constbuffer_array_get_buffer shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_with_index_equal_to_number_of_buffers_fails)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    CONSTBUFFER_HANDLE result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    // act
+    result = constbuffer_array_get_buffer(constbuffer_array, 2);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_008: [ If buffer_index is greater or equal to the number of buffers in the array, constbuffer_array_get_buffer shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_with_index_grater_than_number_of_buffers_fails)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    CONSTBUFFER_HANDLE result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    // act
+    result = constbuffer_array_get_buffer(constbuffer_array, 3);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_008: [ If buffer_index is greater or equal to the number of buffers in the array, constbuffer_array_get_buffer shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_with_index_0_on_empty_array_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    CONSTBUFFER_HANDLE result;
+
+    constbuffer_array = TEST_constbuffer_array_create_empty();
+
+    // act
+    result = constbuffer_array_get_buffer(constbuffer_array, 0);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* constbuffer_array_get_buffer_content */
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_023: [ If constbuffer_array_handle is NULL, constbuffer_array_get_buffer_content shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_content_with_NULL_constbuffer_array_handle_fails)
+{
+    // arrange
+    const CONSTBUFFER* result;
+
+    // act
+    result = constbuffer_array_get_buffer_content(NULL, 0);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_025: [ Otherwise constbuffer_array_get_buffer_content shall call CONSTBUFFER_GetContent for the buffer_index-th buffer and return its result. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_content_succeeds)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    const CONSTBUFFER* result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+
+    // act
+    result = constbuffer_array_get_buffer_content(constbuffer_array, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, result->size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(&one, result->buffer, result->size));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_025: [ Otherwise constbuffer_array_get_buffer_content shall call CONSTBUFFER_GetContent for the buffer_index-th buffer and return its result. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_content_for_the_2nd_buffer_succeeds)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    const CONSTBUFFER* result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+
+    // act
+    result = constbuffer_array_get_buffer_content(constbuffer_array, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 2, result->size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(two, result->buffer, result->size));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_024: [ If buffer_index is greater or equal to the number of buffers in the array, constbuffer_array_get_buffer_content shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_content_with_index_out_of_range_fails)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    const CONSTBUFFER* result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    // act
+    result = constbuffer_array_get_buffer_content(constbuffer_array, 2);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* constbuffer_array_inc_ref */
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_018: [ Otherwise constbuffer_array_inc_ref shall increment the reference count for constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_inc_ref_increments_the_ref_count_for_empty_buffer_array)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+
+    ///act
+    constbuffer_array_inc_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_018: [ Otherwise constbuffer_array_inc_ref shall increment the reference count for constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_inc_ref_increments_the_ref_count)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    ///act
+    constbuffer_array_inc_ref(constbuffer_array);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_017: [ If constbuffer_array_handle is NULL then constbuffer_array_inc_ref shall return. ]*/
+TEST_FUNCTION(constbuffer_array_inc_ref_with_NULL_constbuffer_array_handle_returns)
+{
+    ///arrange
+
+    ///act
+    constbuffer_array_inc_ref(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* constbuffer_array_dec_ref */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_039: [ If constbuffer_array_handle is NULL then constbuffer_array_dec_ref shall return. ]*/
+TEST_FUNCTION(constbuffer_array_dec_ref_with_constbuffer_array_handle_NULL_returns)
+{
+    ///arrange
+
+    ///act
+    constbuffer_array_dec_ref(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_016: [ Otherwise constbuffer_array_dec_ref shall decrement the reference count for constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_dec_ref_does_not_free_when_references_are_still_held)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
+    constbuffer_array_inc_ref(afterAdd2);
+    umock_c_reset_all_calls();
+
+    ///act
+    constbuffer_array_dec_ref(afterAdd2);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(afterAdd2);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_016: [ Otherwise constbuffer_array_dec_ref shall decrement the reference count for constbuffer_array_handle. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_02_038: [ If the reference count reaches 0, constbuffer_array_dec_ref shall free all used resources. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_040: [ When the last CONSTBUFFER_ARRAY_HANDLE sharing a storage is freed, constbuffer_array_dec_ref shall dec_ref all the CONSTBUFFER_HANDLEs in the storage and free it. ]*/
+TEST_FUNCTION(constbuffer_array_dec_ref_frees)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
+    constbuffer_array_dec_ref(afterAdd1);
+    umock_c_reset_all_calls();
+
+    /*afterAdd2 shares the storage of afterAdd1*/
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+
+    ///act
+    constbuffer_array_dec_ref(afterAdd2);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
 
-            umock_c_negative_tests_reset();
-            umock_c_negative_tests_fail_call(i);
+/* Tests_SRS_CONSTBUFFER_ARRAY_02_038: [ If the reference count reaches 0, constbuffer_array_dec_ref shall free all used resources. ]*/
+TEST_FUNCTION(constbuffer_array_dec_ref_does_not_free_the_storage_while_another_array_uses_it)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
+    CONSTBUFFER_HANDLE buffer;
+    umock_c_reset_all_calls();
 
-            ///act
-            afterRemove = constbuffer_array_remove_front(afterAdd, &removed);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
 
-            ///assert
-            ASSERT_IS_NULL(afterRemove);
-        }
-    }
+    ///act
+    constbuffer_array_dec_ref(afterAdd2);
 
-    ///clean
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    buffer = constbuffer_array_get_buffer(afterAdd1, 0);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, buffer);
+
+    ///cleanup
+    CONSTBUFFER_DecRef(buffer);
+    constbuffer_array_dec_ref(afterAdd1);
     constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-    constbuffer_array_dec_ref(afterAdd);
 }
 
-/* constbuffer_array_get_buffer_count */
+/* constbuffer_array_get_all_buffers_size */
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_count_returns_0_for_an_empty_array)
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_019: [ If constbuffer_array_handle is NULL, constbuffer_array_get_all_buffers_size shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_NULL_constbuffer_array_handle_fails)
 {
-    // arrange
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create_empty();
-    uint32_t buffer_count;
+    ///arrange
+    uint32_t all_buffers_size;
+    int result;
 
-    // act
-    int result = constbuffer_array_get_buffer_count(constbuffer_array, &buffer_count);
+    ///act
+    result = constbuffer_array_get_all_buffers_size(NULL, &all_buffers_size);
 
-    // assert
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(uint32_t, 0, buffer_count);
+    ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-    // cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_count_after_add_on_empty_array_yields_1)
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_020: [ If all_buffers_size is NULL, constbuffer_array_get_all_buffers_size shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_NULL_all_buffers_size_fails)
 {
-    // arrange
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
-    uint32_t buffer_count;
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    int result;
 
-    // act
-    int result = constbuffer_array_get_buffer_count(afterAdd1, &buffer_count);
+    ///act
+    result = constbuffer_array_get_all_buffers_size(TEST_CONSTBUFFER_ARRAY_HANDLE, NULL);
 
-    // assert
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(uint32_t, 1, buffer_count);
+    ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 
     // cleanup
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_count_on_a_1_buffer_array_yields_1)
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_021: [ If summing up the sizes results in an uint32_t overflow, shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_when_overflow_happens_fails)
 {
-    // arrange
-    CONSTBUFFER_HANDLE test_buffers[1];
+    ///arrange
     CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    uint32_t buffer_count;
+    CONSTBUFFER_HANDLE test_buffers[2];
+    uint32_t all_buffers_size;
     int result;
+    const CONSTBUFFER fake_const_buffer_1 = { (const unsigned char*)0x4242, UINT32_MAX };
+    const CONSTBUFFER fake_const_buffer_2 = { (const unsigned char*)0x4242, 1 };
 
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_2;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_1;
 
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+        .SetReturn(&fake_const_buffer_2);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .SetReturn(&fake_const_buffer_1);
+    constbuffer_array = constbuffer_array_create(test_buffers, 2);
+    ASSERT_IS_NOT_NULL(constbuffer_array);
     umock_c_reset_all_calls();
 
-    // act
-    result = constbuffer_array_get_buffer_count(constbuffer_array, &buffer_count);
+    ///act
+    result = constbuffer_array_get_all_buffers_size(constbuffer_array, &all_buffers_size);
 
-    // assert
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(uint32_t, 1, buffer_count);
+    ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 
     // cleanup
     constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_count_on_a_2_buffer_array_yields_2)
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_021: [ If summing up the sizes results in an uint32_t overflow, shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_max_all_size_succeeds)
 {
-    // arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
+    ///arrange
     CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    uint32_t buffer_count;
+    CONSTBUFFER_HANDLE test_buffers[2];
+    uint32_t all_buffers_size;
     int result;
+    const CONSTBUFFER fake_const_buffer_1 = { (const unsigned char*)0x4242, UINT32_MAX - 1 };
+    const CONSTBUFFER fake_const_buffer_2 = { (const unsigned char*)0x4242, 1 };
 
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_2;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_1;
 
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+        .SetReturn(&fake_const_buffer_2);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .SetReturn(&fake_const_buffer_1);
+    constbuffer_array = constbuffer_array_create(test_buffers, 2);
+    ASSERT_IS_NOT_NULL(constbuffer_array);
     umock_c_reset_all_calls();
 
-    // act
-    result = constbuffer_array_get_buffer_count(constbuffer_array, &buffer_count);
+    ///act
+    result = constbuffer_array_get_all_buffers_size(constbuffer_array, &all_buffers_size);
 
-    // assert
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(uint32_t, 2, buffer_count);
+    ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, UINT32_MAX, all_buffers_size);
 
     // cleanup
     constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_003: [ If constbuffer_array_handle is NULL, constbuffer_array_get_buffer_count shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_count_with_NULL_constbuffer_array_handle_fails)
+#if SIZE_MAX > UINT32_MAX
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_021: [ If summing up the sizes results in an uint32_t overflow, shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_when_buffer_size_bigger_than_UINT32_MAX_fails)
 {
-    // arrange
-    uint32_t buffer_count;
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1;
+    uint32_t all_buffers_size;
+    int result;
+    const CONSTBUFFER fake_const_buffer_1 = { (const unsigned char*)0x4242, (size_t)UINT32_MAX + 1 };
 
-    // act
-    int result = constbuffer_array_get_buffer_count(NULL, &buffer_count);
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .SetReturn(&fake_const_buffer_1);
+    afterAdd1 = constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_1);
+    ASSERT_IS_NOT_NULL(afterAdd1);
+    umock_c_reset_all_calls();
 
-    // assert
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ///act
+    result = constbuffer_array_get_all_buffers_size(afterAdd1, &all_buffers_size);
+
+    ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
 }
+#endif
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_004: [ If buffer_count is NULL, constbuffer_array_get_buffer_count shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_count_with_NULL_buffer_count_fails)
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_on_empty_const_buffer_array_succeeds)
 {
-    // arrange
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create_empty();
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    uint32_t all_buffers_size;
+    int result;
 
-    // act
-    int result = constbuffer_array_get_buffer_count(constbuffer_array, NULL);
+    ///act
+    result = constbuffer_array_get_all_buffers_size(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size);
 
-    // assert
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, all_buffers_size);
 
     // cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
 }
 
-/* constbuffer_array_get_buffer */
-
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_005: [ On success, constbuffer_array_get_buffer shall return a non-NULL handle to the buffer_index-th const buffer in the array. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_006: [ The returned handle shall have its reference count incremented. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_succeeds)
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_041: [ constbuffer_array_get_all_buffers_size shall not call CONSTBUFFER_GetContent, the total size is computed when the array is created. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_1_buffer_succeeds)
 {
-    // arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    CONSTBUFFER_HANDLE result;
-
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
-
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    uint32_t all_buffers_size;
+    int result;
 
-    // act
-    result = constbuffer_array_get_buffer(constbuffer_array, 0);
+    ///act
+    result = constbuffer_array_get_all_buffers_size(afterAdd1, &all_buffers_size);
 
-    // assert
-    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result);
+    ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, all_buffers_size);
 
     // cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
-    CONSTBUFFER_DecRef(result);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_005: [ On success, constbuffer_array_get_buffer shall return a non-NULL handle to the buffer_index-th const buffer in the array. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_006: [ The returned handle shall have its reference count incremented. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_for_2nd_buffer_succeeds)
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_041: [ constbuffer_array_get_all_buffers_size shall not call CONSTBUFFER_GetContent, the total size is computed when the array is created. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_2_buffers_succeeds)
 {
-    // arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    CONSTBUFFER_HANDLE result;
-
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
-
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
-
-    // act
-    result = constbuffer_array_get_buffer(constbuffer_array, 1);
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
+    uint32_t all_buffers_size;
+    int result;
 
-    // assert
-    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, result);
+    ///act
+    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+
+    ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 3, all_buffers_size);
 
     // cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
-    CONSTBUFFER_DecRef(result);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(afterAdd2);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_007: [ If constbuffer_array_handle is NULL, constbuffer_array_get_buffer shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_with_NULL_constbuffer_array_handle_fails)
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_039: [ constbuffer_array_remove_front shall compute the total size of the buffers by subtracting the size of the removed buffer obtained by calling CONSTBUFFER_GetContent from the total size of constbuffer_array_handle. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_041: [ constbuffer_array_get_all_buffers_size shall not call CONSTBUFFER_GetContent, the total size is computed when the array is created. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_after_remove_front_succeeds)
 {
-    // arrange
-    CONSTBUFFER_HANDLE result;
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_HANDLE removed;
+    CONSTBUFFER_ARRAY_HANDLE afterRemove = TEST_constbuffer_array_remove_front(constbuffer_array, 3, &removed);
+    uint32_t all_buffers_size;
+    int result;
 
-    // act
-    result = constbuffer_array_get_buffer(NULL, 0);
+    ///act
+    result = constbuffer_array_get_all_buffers_size(afterRemove, &all_buffers_size);
 
-    // assert
-    ASSERT_IS_NULL(result);
+    ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2 + 3, all_buffers_size);
+
+    // cleanup
+    CONSTBUFFER_DecRef(removed);
+    constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(afterRemove);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_008: [ If buffer_index is greater or equal to the number of buffers in the array, constbuffer_array_get_buffer shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_with_index_equal_to_number_of_buffers_fails)
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_039: [ constbuffer_array_remove_front shall compute the total size of the buffers by subtracting the size of the removed buffer obtained by calling CONSTBUFFER_GetContent from the total size of constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_after_remove_front_of_the_buffer_that_overflows_succeeds)
 {
-    // arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
+    ///arrange
     CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    CONSTBUFFER_HANDLE result;
+    CONSTBUFFER_ARRAY_HANDLE afterRemove;
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_HANDLE removed;
+    uint32_t all_buffers_size;
+    int result;
+    const CONSTBUFFER fake_const_buffer_1 = { (const unsigned char*)0x4242, 1 };
+    const CONSTBUFFER fake_const_buffer_2 = { (const unsigned char*)0x4242, UINT32_MAX };
 
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_2;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_1;
 
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+        .SetReturn(&fake_const_buffer_2);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .SetReturn(&fake_const_buffer_1);
+    constbuffer_array = constbuffer_array_create(test_buffers, 2);
+    ASSERT_IS_NOT_NULL(constbuffer_array);
     umock_c_reset_all_calls();
 
-    // act
-    result = constbuffer_array_get_buffer(constbuffer_array, 2);
+    /*the size of the rest is computed again*/
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .SetReturn(&fake_const_buffer_1);
+    afterRemove = constbuffer_array_remove_front(constbuffer_array, &removed);
+    ASSERT_IS_NOT_NULL(afterRemove);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
 
-    // assert
-    ASSERT_IS_NULL(result);
+    ///act
+    result = constbuffer_array_get_all_buffers_size(afterRemove, &all_buffers_size);
+
+    ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, all_buffers_size);
 
     // cleanup
+    CONSTBUFFER_DecRef(removed);
     constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(afterRemove);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_008: [ If buffer_index is greater or equal to the number of buffers in the array, constbuffer_array_get_buffer shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_with_index_grater_than_number_of_buffers_fails)
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_034: [ constbuffer_array_create_from_array_array shall compute the total size of the buffers from the total sizes of the arrays in buffer_arrays. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_041: [ constbuffer_array_get_all_buffers_size shall not call CONSTBUFFER_GetContent, the total size is computed when the array is created. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_for_create_from_array_array_succeeds)
 {
-    // arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE buffer_arrays[2];
     CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    CONSTBUFFER_HANDLE result;
-
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+    uint32_t all_buffers_size;
+    int result;
 
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    buffer_arrays[0] = TEST_constbuffer_array_create(2, 0);
+    buffer_arrays[1] = TEST_constbuffer_array_create(3, 2);
+    constbuffer_array = constbuffer_array_create_from_array_array(buffer_arrays, 2);
+    ASSERT_IS_NOT_NULL(constbuffer_array);
     umock_c_reset_all_calls();
 
-    // act
-    result = constbuffer_array_get_buffer(constbuffer_array, 3);
+    ///act
+    result = constbuffer_array_get_all_buffers_size(constbuffer_array, &all_buffers_size);
 
-    // assert
-    ASSERT_IS_NULL(result);
+    ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1 + 2 + 3 + 4 + 5, all_buffers_size);
 
     // cleanup
     constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(buffer_arrays[0]);
+    constbuffer_array_dec_ref(buffer_arrays[1]);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_008: [ If buffer_index is greater or equal to the number of buffers in the array, constbuffer_array_get_buffer shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_with_index_0_on_empty_array_fails)
-{
-    // arrange
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    CONSTBUFFER_HANDLE result;
+/* constbuffer_array_get_const_buffer_handle_array */
 
-    constbuffer_array = TEST_constbuffer_array_create_empty();
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_026: [ If constbuffer_array_handle is NULL, constbuffer_array_get_const_buffer_handle_array shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_NULL_constbuffer_array_handle_fails)
+{
+    ///arrange
+    const CONSTBUFFER_HANDLE* result;
 
-    // act
-    result = constbuffer_array_get_buffer(constbuffer_array, 0);
+    ///act
+    result = constbuffer_array_get_const_buffer_handle_array(NULL);
 
-    // assert
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
+TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_empty_array_succeeds)
+{
+    ///arrange
+    const CONSTBUFFER_HANDLE* result;
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
+    umock_c_reset_all_calls();
+
+    ///act
+    result = constbuffer_array_get_const_buffer_handle_array(constbuffer_array);
+
+    ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
 
-    // cleanup
+    /// cleanup
     constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/* constbuffer_array_get_buffer_content */
-
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_023: [ If constbuffer_array_handle is NULL, constbuffer_array_get_buffer_content shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_content_with_NULL_constbuffer_array_handle_fails)
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
+TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_array_with_1_buffer_succeeds)
 {
-    // arrange
-    const CONSTBUFFER* result;
+    ///arrange
+    const CONSTBUFFER_HANDLE* result;
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
+    umock_c_reset_all_calls();
 
-    // act
-    result = constbuffer_array_get_buffer_content(NULL, 0);
+    ///act
+    result = constbuffer_array_get_const_buffer_handle_array(afterAdd1);
 
-    // assert
-    ASSERT_IS_NULL(result);
+    ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result[0]);
+
+    /// cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(afterAdd1);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_025: [ Otherwise constbuffer_array_get_buffer_content shall call CONSTBUFFER_GetContent for the buffer_index-th buffer and return its result. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_content_succeeds)
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
+TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_array_with_2_buffers_succeeds)
 {
-    // arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    const CONSTBUFFER* result;
-
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
-
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    ///arrange
+    const CONSTBUFFER_HANDLE* result;
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 0, TEST_CONSTBUFFER_HANDLE_2);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
-
-    // act
-    result = constbuffer_array_get_buffer_content(constbuffer_array, 0);
+    ///act
+    result = constbuffer_array_get_const_buffer_handle_array(afterAdd2);
 
-    // assert
-    ASSERT_ARE_EQUAL(size_t, 1, result->size);
-    ASSERT_ARE_EQUAL(int, 0, memcmp(&one, result->buffer, result->size));
+    ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, result[0]);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result[1]);
 
-    // cleanup
+    /// cleanup
     constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(afterAdd2);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_025: [ Otherwise constbuffer_array_get_buffer_content shall call CONSTBUFFER_GetContent for the buffer_index-th buffer and return its result. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_content_for_the_2nd_buffer_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_050: [ If left is NULL and right is NULL then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return true. ]*/
+TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_left_NULL_and_right_NULL_returns_true)
 {
-    // arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    const CONSTBUFFER* result;
+    ///arrange
+    bool result;
 
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+    ///act
+    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(NULL, NULL);
 
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
-    umock_c_reset_all_calls();
+    ///assert
+    ASSERT_IS_TRUE(result);
+}
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_051: [ If left is NULL and right is not NULL then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return false. ]*/
+TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_left_NULL_and_right_non_NULL_returns_false)
+{
+    ///arrange
+    bool result;
+    CONSTBUFFER_ARRAY_HANDLE right = constbuffer_array_create(&TEST_CONSTBUFFER_HANDLE_1, 1);
+    ASSERT_IS_NOT_NULL(right);
+    umock_c_reset_all_calls();
 
-    // act
-    result = constbuffer_array_get_buffer_content(constbuffer_array, 1);
+    ///act
+    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(NULL, right);
 
-    // assert
-    ASSERT_ARE_EQUAL(size_t, 2, result->size);
-    ASSERT_ARE_EQUAL(int, 0, memcmp(two, result->buffer, result->size));
+    ///assert
+    ASSERT_IS_FALSE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    // cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
+    ///clean
+    constbuffer_array_dec_ref(right);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_024: [ If buffer_index is greater or equal to the number of buffers in the array, constbuffer_array_get_buffer_content shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_content_with_index_out_of_range_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_052: [ If left is not NULL and right is NULL then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return false. ]*/
+TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_left_non_NULL_and_right_NULL_returns_false)
 {
-    // arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    const CONSTBUFFER* result;
-
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
-
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    ///arrange
+    bool result;
+    CONSTBUFFER_ARRAY_HANDLE left = constbuffer_array_create(&TEST_CONSTBUFFER_HANDLE_1, 1);
+    ASSERT_IS_NOT_NULL(left);
     umock_c_reset_all_calls();
 
-    // act
-    result = constbuffer_array_get_buffer_content(constbuffer_array, 2);
+    ///act
+    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(left, NULL);
 
-    // assert
-    ASSERT_IS_NULL(result);
+    ///assert
+    ASSERT_IS_FALSE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    // cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
+    ///clean
+    constbuffer_array_dec_ref(left);
 }
 
-/* constbuffer_array_inc_ref */
-
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_018: [ Otherwise constbuffer_array_inc_ref shall increment the reference count for constbuffer_array_handle. ]*/
-TEST_FUNCTION(constbuffer_array_inc_ref_increments_the_ref_count_for_empty_buffer_array)
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_053: [ If the number of CONSTBUFFER_HANDLEs in left is different then the number of CONSTBUFFER_HANDLEs in right then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return false. ]*/
+TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_different_number_of_buffers_return_false)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    bool result;
+    CONSTBUFFER_ARRAY_HANDLE left = constbuffer_array_create(&TEST_CONSTBUFFER_HANDLE_1, 1);
+    ASSERT_IS_NOT_NULL(left);
+
+    CONSTBUFFER_HANDLE twoAndThree[2];
+    twoAndThree[0] = TEST_CONSTBUFFER_HANDLE_2;
+    twoAndThree[1] = TEST_CONSTBUFFER_HANDLE_3;
+    CONSTBUFFER_ARRAY_HANDLE right = constbuffer_array_create(twoAndThree, 2);
+    ASSERT_IS_NOT_NULL(right);
+    umock_c_reset_all_calls();
 
     ///act
-    constbuffer_array_inc_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(left, right);
 
     ///assert
+    ASSERT_IS_FALSE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    ///cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    ///clean
+    constbuffer_array_dec_ref(left);
+    constbuffer_array_dec_ref(right);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_018: [ Otherwise constbuffer_array_inc_ref shall increment the reference count for constbuffer_array_handle. ]*/
-TEST_FUNCTION(constbuffer_array_inc_ref_increments_the_ref_count)
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_054: [ If left and right CONSTBUFFER_HANDLEs at same index are different (as indicated by CONSTBUFFER_HANDLE_contain_same call) then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return false. ]*/
+TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_content_of_buffers_different_return_false)
 {
     ///arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+    bool result;
+    CONSTBUFFER_HANDLE twoAndOne[2];
+    twoAndOne[0] = TEST_CONSTBUFFER_HANDLE_2;
+    twoAndOne[1] = TEST_CONSTBUFFER_HANDLE_1;
+    CONSTBUFFER_ARRAY_HANDLE left = constbuffer_array_create(twoAndOne, 2);
+    ASSERT_IS_NOT_NULL(left);
 
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    CONSTBUFFER_HANDLE twoAndThree[2];
+    twoAndThree[0] = TEST_CONSTBUFFER_HANDLE_2;
+    twoAndThree[1] = TEST_CONSTBUFFER_HANDLE_3;
+    CONSTBUFFER_ARRAY_HANDLE right = constbuffer_array_create(twoAndThree, 2);
+    ASSERT_IS_NOT_NULL(right);
     umock_c_reset_all_calls();
 
+    STRICT_EXPECTED_CALL(CONSTBUFFER_HANDLE_contain_same(TEST_CONSTBUFFER_HANDLE_2, TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_HANDLE_contain_same(TEST_CONSTBUFFER_HANDLE_1, TEST_CONSTBUFFER_HANDLE_3));
+
     ///act
-    constbuffer_array_inc_ref(constbuffer_array);
+    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(left, right);
 
     ///assert
+    ASSERT_IS_FALSE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    ///cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
-    constbuffer_array_dec_ref(constbuffer_array);
+    ///clean
+    constbuffer_array_dec_ref(left);
+    constbuffer_array_dec_ref(right);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_017: [ If constbuffer_array_handle is NULL then constbuffer_array_inc_ref shall return. ]*/
-TEST_FUNCTION(constbuffer_array_inc_ref_with_NULL_constbuffer_array_handle_returns)
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_055: [ CONSTBUFFER_ARRAY_HANDLE_contain_same shall return true. ]*/
+TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_content_of_buffers_same_return_true)
 {
     ///arrange
+    bool result;
+    CONSTBUFFER_HANDLE twoAndOne[2];
+    twoAndOne[0] = TEST_CONSTBUFFER_HANDLE_2;
+    twoAndOne[1] = TEST_CONSTBUFFER_HANDLE_1;
+    CONSTBUFFER_ARRAY_HANDLE left = constbuffer_array_create(twoAndOne, 2);
+    ASSERT_IS_NOT_NULL(left);
+
+    CONSTBUFFER_HANDLE alsoTwoAndOne[2];
+    alsoTwoAndOne[0] = TEST_CONSTBUFFER_HANDLE_2;
+    alsoTwoAndOne[1] = TEST_CONSTBUFFER_HANDLE_1;
+    CONSTBUFFER_ARRAY_HANDLE right = constbuffer_array_create(alsoTwoAndOne, 2);
+    ASSERT_IS_NOT_NULL(right);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_HANDLE_contain_same(TEST_CONSTBUFFER_HANDLE_2, TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_HANDLE_contain_same(TEST_CONSTBUFFER_HANDLE_1, TEST_CONSTBUFFER_HANDLE_1));
 
     ///act
-    constbuffer_array_inc_ref(NULL);
+    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(left, right);
 
     ///assert
+    ASSERT_IS_TRUE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    constbuffer_array_dec_ref(left);
+    constbuffer_array_dec_ref(right);
 }
 
-/* constbuffer_array_dec_ref */
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_039: [ If constbuffer_array_handle is NULL then constbuffer_array_dec_ref shall return. ]*/
-TEST_FUNCTION(constbuffer_array_dec_ref_with_constbuffer_array_handle_NULL_returns)
+/* constbuffer_array_cursor_create */
+
+static CONSTBUFFER_ARRAY_CURSOR_HANDLE TEST_constbuffer_array_cursor_create(CONSTBUFFER_ARRAY_HANDLE constbuffer_array)
+{
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE result = constbuffer_array_cursor_create(constbuffer_array);
+    ASSERT_IS_NOT_NULL(result);
+    umock_c_reset_all_calls();
+    return result;
+}
+
+static uint32_t TEST_constbuffer_array_cursor_get_remaining_size(CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor)
+{
+    uint32_t result;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_cursor_get_remaining_size(cursor, &result));
+    return result;
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_019: [ If constbuffer_array_handle is NULL then constbuffer_array_cursor_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_create_with_NULL_constbuffer_array_handle_fails)
 {
     ///arrange
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor;
 
     ///act
-    constbuffer_array_dec_ref(NULL);
+    cursor = constbuffer_array_cursor_create(NULL);
 
     ///assert
+    ASSERT_IS_NULL(cursor);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_016: [ Otherwise constbuffer_array_dec_ref shall decrement the reference count for constbuffer_array_handle. ]*/
-TEST_FUNCTION(constbuffer_array_dec_ref_does_not_free_when_references_are_still_held)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_020: [ If the total size of the buffers in constbuffer_array_handle overflows uint32_t then constbuffer_array_cursor_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_create_when_the_size_overflows_fails)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    constbuffer_array_inc_ref(afterAdd2);
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor;
+    CONSTBUFFER_HANDLE test_buffers[2];
+    const CONSTBUFFER fake_const_buffer_1 = { (const unsigned char*)0x4242, UINT32_MAX };
+    const CONSTBUFFER fake_const_buffer_2 = { (const unsigned char*)0x4242, 1 };
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_2;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_1;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+        .SetReturn(&fake_const_buffer_2);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .SetReturn(&fake_const_buffer_1);
+    constbuffer_array = constbuffer_array_create(test_buffers, 2);
+    ASSERT_IS_NOT_NULL(constbuffer_array);
     umock_c_reset_all_calls();
 
     ///act
-    constbuffer_array_dec_ref(afterAdd2);
+    cursor = constbuffer_array_cursor_create(constbuffer_array);
 
     ///assert
+    ASSERT_IS_NULL(cursor);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///cleanup
-    constbuffer_array_dec_ref(afterAdd2);
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_016: [ Otherwise constbuffer_array_dec_ref shall decrement the reference count for constbuffer_array_handle. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_02_038: [ If the reference count reaches 0, constbuffer_array_dec_ref shall free all used resources. ]*/
-TEST_FUNCTION(constbuffer_array_dec_ref_frees)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_021: [ constbuffer_array_cursor_create shall allocate memory for a new CONSTBUFFER_ARRAY_CURSOR_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_023: [ constbuffer_array_cursor_create shall inc_ref constbuffer_array_handle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_024: [ constbuffer_array_cursor_create shall succeed and return a non-NULL value positioned at the first byte of constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_create_succeeds)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    umock_c_reset_all_calls();
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor;
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
 
     ///act
-    constbuffer_array_dec_ref(afterAdd2);
+    cursor = constbuffer_array_cursor_create(constbuffer_array);
 
     ///assert
+    ASSERT_IS_NOT_NULL(cursor);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(one) + sizeof(two) + sizeof(three), TEST_constbuffer_array_cursor_get_remaining_size(cursor));
 
     ///cleanup
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    /*the cursor holds a reference*/
+    constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_cursor_destroy(cursor);
 }
 
-/* constbuffer_array_get_all_buffers_size */
-
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_019: [ If constbuffer_array_handle is NULL, constbuffer_array_get_all_buffers_size shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_NULL_constbuffer_array_handle_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_024: [ constbuffer_array_cursor_create shall succeed and return a non-NULL value positioned at the first byte of constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_create_with_empty_array_succeeds)
 {
     ///arrange
-    uint32_t all_buffers_size;
-    int result;
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(NULL, &all_buffers_size);
+    cursor = constbuffer_array_cursor_create(constbuffer_array);
 
     ///assert
+    ASSERT_IS_NOT_NULL(cursor);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, TEST_constbuffer_array_cursor_get_remaining_size(cursor));
+
+    ///cleanup
+    constbuffer_array_cursor_destroy(cursor);
+    constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_020: [ If all_buffers_size is NULL, constbuffer_array_get_all_buffers_size shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_NULL_all_buffers_size_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_022: [ If there are any failures then constbuffer_array_cursor_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_fails_constbuffer_array_cursor_create_fails)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    int result;
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
+        .SetReturn(NULL);
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(TEST_CONSTBUFFER_ARRAY_HANDLE, NULL);
+    cursor = constbuffer_array_cursor_create(constbuffer_array);
 
     ///assert
+    ASSERT_IS_NULL(cursor);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 
-    // cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    ///cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_021: [ If summing up the sizes results in an uint32_t overflow, shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_size_when_overflow_happens_fails)
-{
-    ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    uint32_t all_buffers_size;
-    int result;
-    const CONSTBUFFER fake_const_buffer_1 = { (const unsigned char*)0x4242, UINT32_MAX };
-    const CONSTBUFFER fake_const_buffer_2 = { (const unsigned char*)0x4242, 1 };
-
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
-        .SetReturn(&fake_const_buffer_2);
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
-        .SetReturn(&fake_const_buffer_1);
+/* constbuffer_array_cursor_destroy */
 
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_025: [ If cursor is NULL then constbuffer_array_cursor_destroy shall return. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_destroy_with_NULL_cursor_returns)
+{
     ///act
-    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+    constbuffer_array_cursor_destroy(NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
-
-    // cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(afterAdd2);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_021: [ If summing up the sizes results in an uint32_t overflow, shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_size_max_all_size_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_026: [ Otherwise constbuffer_array_cursor_destroy shall dec_ref the CONSTBUFFER_ARRAY_HANDLE of the cursor and free the cursor. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_destroy_frees_the_cursor_and_the_array)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    uint32_t all_buffers_size;
-    int result;
-    const CONSTBUFFER fake_const_buffer_1 = { (const unsigned char*)0x4242, UINT32_MAX - 1 };
-    const CONSTBUFFER fake_const_buffer_2 = { (const unsigned char*)0x4242, 1 };
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(1, 0);
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor = TEST_constbuffer_array_cursor_create(constbuffer_array);
+    constbuffer_array_dec_ref(constbuffer_array);
+    umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
-        .SetReturn(&fake_const_buffer_2);
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
-        .SetReturn(&fake_const_buffer_1);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(gballoc_free(constbuffer_array));
+    STRICT_EXPECTED_CALL(gballoc_free(cursor));
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+    constbuffer_array_cursor_destroy(cursor);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(int, UINT32_MAX, all_buffers_size);
-
-    // cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(afterAdd2);
 }
 
-#if SIZE_MAX > UINT32_MAX
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_021: [ If summing up the sizes results in an uint32_t overflow, shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_size_when_buffer_size_bigger_than_UINT32_MAX_fails)
+/* constbuffer_array_cursor_get_remaining_size */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_027: [ If cursor is NULL then constbuffer_array_cursor_get_remaining_size shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_get_remaining_size_with_NULL_cursor_fails)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    uint32_t all_buffers_size;
+    uint32_t remaining_size;
     int result;
-    const CONSTBUFFER fake_const_buffer_1 = { (const unsigned char*)0x4242, (size_t)UINT32_MAX + 1 };
-
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
-        .SetReturn(&fake_const_buffer_1);
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(afterAdd1, &all_buffers_size);
+    result = constbuffer_array_cursor_get_remaining_size(NULL, &remaining_size);
 
     ///assert
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_NOT_EQUAL(int, 0, result);
-
-    // cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-    constbuffer_array_dec_ref(afterAdd1);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
-#endif
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_on_empty_const_buffer_array_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_028: [ If remaining_size is NULL then constbuffer_array_cursor_get_remaining_size shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_get_remaining_size_with_NULL_remaining_size_fails)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    uint32_t all_buffers_size;
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor = TEST_constbuffer_array_cursor_create(constbuffer_array);
     int result;
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size);
+    result = constbuffer_array_cursor_get_remaining_size(cursor, NULL);
 
     ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(uint32_t, 0, all_buffers_size);
 
-    // cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    ///cleanup
+    constbuffer_array_cursor_destroy(cursor);
+    constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_1_buffer_succeeds)
+/* constbuffer_array_cursor_consume */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_030: [ If cursor is NULL then constbuffer_array_cursor_consume shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_consume_with_NULL_cursor_fails)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    uint32_t all_buffers_size;
-    int result;
-
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    CONSTBUFFER_ARRAY_HANDLE result;
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(afterAdd1, &all_buffers_size);
+    result = constbuffer_array_cursor_consume(NULL, 1);
 
     ///assert
+    ASSERT_IS_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(uint32_t, 1, all_buffers_size);
-
-    // cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-    constbuffer_array_dec_ref(afterAdd1);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_2_buffers_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_031: [ If size is greater than the number of bytes after the cursor then constbuffer_array_cursor_consume shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_consume_with_size_too_big_fails)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    uint32_t all_buffers_size;
-    int result;
-
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor = TEST_constbuffer_array_cursor_create(constbuffer_array);
+    CONSTBUFFER_ARRAY_HANDLE result;
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+    result = constbuffer_array_cursor_consume(cursor, sizeof(one) + sizeof(two) + sizeof(three) + 1);
 
     ///assert
+    ASSERT_IS_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(uint32_t, 3, all_buffers_size);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(one) + sizeof(two) + sizeof(three), TEST_constbuffer_array_cursor_get_remaining_size(cursor));
 
-    // cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(afterAdd2);
+    ///cleanup
+    constbuffer_array_cursor_destroy(cursor);
+    constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/* constbuffer_array_get_const_buffer_handle_array */
-
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_026: [ If constbuffer_array_handle is NULL, constbuffer_array_get_const_buffer_handle_array shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_NULL_constbuffer_array_handle_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_032: [ If size is 0 then constbuffer_array_cursor_consume shall create a new, empty CONSTBUFFER_ARRAY_HANDLE. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_consume_with_size_0_creates_an_empty_array)
 {
     ///arrange
-    const CONSTBUFFER_HANDLE* result;
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor = TEST_constbuffer_array_cursor_create(constbuffer_array);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    uint32_t buffer_count;
+
+    constbuffer_array_create_empty_inert_path();
 
     ///act
-    result = constbuffer_array_get_const_buffer_handle_array(NULL);
+    result = constbuffer_array_cursor_consume(cursor, 0);
 
     ///assert
+    ASSERT_IS_NOT_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 0, buffer_count);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(one) + sizeof(two) + sizeof(three), TEST_constbuffer_array_cursor_get_remaining_size(cursor));
+
+    ///cleanup
+    constbuffer_array_dec_ref(result);
+    constbuffer_array_cursor_destroy(cursor);
+    constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
-TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_empty_array_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_033: [ Otherwise constbuffer_array_cursor_consume shall create a CONSTBUFFER_ARRAY_HANDLE with the size bytes after the cursor in the same way constbuffer_array_create_from_offset_and_size does. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_035: [ constbuffer_array_cursor_consume shall move the cursor size bytes further, succeed and return the new CONSTBUFFER_ARRAY_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_029: [ Otherwise constbuffer_array_cursor_get_remaining_size shall write in remaining_size the number of bytes after the cursor and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_consume_a_whole_buffer_shares_the_storage)
 {
     ///arrange
-    const CONSTBUFFER_HANDLE* result;
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
-    umock_c_reset_all_calls();
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor = TEST_constbuffer_array_cursor_create(constbuffer_array);
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    /*moving the cursor*/
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
 
     ///act
-    result = constbuffer_array_get_const_buffer_handle_array(constbuffer_array);
+    result = constbuffer_array_cursor_consume(cursor, sizeof(one));
 
     ///assert
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, constbuffer_array_get_const_buffer_handle_array(constbuffer_array), constbuffer_array_get_const_buffer_handle_array(result));
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(two) + sizeof(three), TEST_constbuffer_array_cursor_get_remaining_size(cursor));
 
-    /// cleanup
+    ///cleanup
+    constbuffer_array_dec_ref(result);
+    constbuffer_array_cursor_destroy(cursor);
     constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
-TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_array_with_1_buffer_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_033: [ Otherwise constbuffer_array_cursor_consume shall create a CONSTBUFFER_ARRAY_HANDLE with the size bytes after the cursor in the same way constbuffer_array_create_from_offset_and_size does. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_035: [ constbuffer_array_cursor_consume shall move the cursor size bytes further, succeed and return the new CONSTBUFFER_ARRAY_HANDLE. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_consume_across_buffers_succeeds)
 {
     ///arrange
-    const CONSTBUFFER_HANDLE* result;
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
-    umock_c_reset_all_calls();
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor = TEST_constbuffer_array_cursor_create(constbuffer_array);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    const CONSTBUFFER* content;
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateFromOffsetAndSize(TEST_CONSTBUFFER_HANDLE_2, 0, 1));
+    STRICT_EXPECTED_CALL(gballoc_calloc(IGNORED_ARG, IGNORED_ARG));
+    /*moving the cursor*/
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
 
     ///act
-    result = constbuffer_array_get_const_buffer_handle_array(afterAdd1);
+    result = constbuffer_array_cursor_consume(cursor, sizeof(one) + 1);
 
     ///assert
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_IS_NOT_NULL(result);
-    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result[0]);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    content = constbuffer_array_get_buffer_content(result, 0);
+    ASSERT_ARE_EQUAL(void_ptr, &one, content->buffer);
+    content = constbuffer_array_get_buffer_content(result, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, content->size);
+    ASSERT_ARE_EQUAL(void_ptr, two, content->buffer);
+    ASSERT_ARE_EQUAL(uint32_t, 1 + sizeof(three), TEST_constbuffer_array_cursor_get_remaining_size(cursor));
 
-    /// cleanup
+    ///cleanup
+    constbuffer_array_dec_ref(result);
+    constbuffer_array_cursor_destroy(cursor);
     constbuffer_array_dec_ref(constbuffer_array);
-    constbuffer_array_dec_ref(afterAdd1);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
-TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_array_with_2_buffers_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_034: [ If there are any failures then constbuffer_array_cursor_consume shall fail, return NULL and leave the cursor where it was. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_cursor_consume_fails)
 {
     ///arrange
-    const CONSTBUFFER_HANDLE* result;
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 0, TEST_CONSTBUFFER_HANDLE_2);
-    umock_c_reset_all_calls();
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor = TEST_constbuffer_array_cursor_create(constbuffer_array);
+    size_t i;
 
-    ///act
-    result = constbuffer_array_get_const_buffer_handle_array(afterAdd2);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+        .CallCannotFail();
 
-    ///assert
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_IS_NOT_NULL(result);
-    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, result[0]);
-    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result[1]);
+    umock_c_negative_tests_snapshot();
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            CONSTBUFFER_ARRAY_HANDLE result;
 
-    /// cleanup
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            result = constbuffer_array_cursor_consume(cursor, sizeof(one));
+
+            ///assert
+            ASSERT_IS_NULL(result);
+            ASSERT_ARE_EQUAL(uint32_t, sizeof(one) + sizeof(two) + sizeof(three), TEST_constbuffer_array_cursor_get_remaining_size(cursor));
+        }
+    }
+
+    ///cleanup
+    constbuffer_array_cursor_destroy(cursor);
     constbuffer_array_dec_ref(constbuffer_array);
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(afterAdd2);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_050: [ If left is NULL and right is NULL then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return true. ]*/
-TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_left_NULL_and_right_NULL_returns_true)
+/* constbuffer_array_cursor_read */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_036: [ If cursor is NULL then constbuffer_array_cursor_read shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_read_with_NULL_cursor_fails)
 {
     ///arrange
-    bool result;
+    unsigned char destination[1];
+    int result;
 
     ///act
-    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(NULL, NULL);
+    result = constbuffer_array_cursor_read(NULL, destination, sizeof(destination));
 
     ///assert
-    ASSERT_IS_TRUE(result);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_051: [ If left is NULL and right is not NULL then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return false. ]*/
-TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_left_NULL_and_right_non_NULL_returns_false)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_037: [ If destination is NULL and size is not 0 then constbuffer_array_cursor_read shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_read_with_NULL_destination_fails)
 {
     ///arrange
-    bool result;
-    CONSTBUFFER_ARRAY_HANDLE right = constbuffer_array_create(&TEST_CONSTBUFFER_HANDLE_1, 1);
-    ASSERT_IS_NOT_NULL(right);
-    umock_c_reset_all_calls();
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor = TEST_constbuffer_array_cursor_create(constbuffer_array);
+    int result;
 
     ///act
-    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(NULL, right);
+    result = constbuffer_array_cursor_read(cursor, NULL, 1);
 
     ///assert
-    ASSERT_IS_FALSE(result);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    ///clean
-    constbuffer_array_dec_ref(right);
+    ///cleanup
+    constbuffer_array_cursor_destroy(cursor);
+    constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_052: [ If left is not NULL and right is NULL then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return false. ]*/
-TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_left_non_NULL_and_right_NULL_returns_false)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_038: [ If size is greater than the number of bytes after the cursor then constbuffer_array_cursor_read shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_read_with_size_too_big_fails)
 {
     ///arrange
-    bool result;
-    CONSTBUFFER_ARRAY_HANDLE left = constbuffer_array_create(&TEST_CONSTBUFFER_HANDLE_1, 1);
-    ASSERT_IS_NOT_NULL(left);
-    umock_c_reset_all_calls();
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(1, 0);
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor = TEST_constbuffer_array_cursor_create(constbuffer_array);
+    unsigned char destination[2];
+    int result;
 
     ///act
-    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(left, NULL);
+    result = constbuffer_array_cursor_read(cursor, destination, sizeof(destination));
 
     ///assert
-    ASSERT_IS_FALSE(result);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(one), TEST_constbuffer_array_cursor_get_remaining_size(cursor));
 
-    ///clean
-    constbuffer_array_dec_ref(left);
+    ///cleanup
+    constbuffer_array_cursor_destroy(cursor);
+    constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_053: [ If the number of CONSTBUFFER_HANDLEs in left is different then the number of CONSTBUFFER_HANDLEs in right then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return false. ]*/
-TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_different_number_of_buffers_return_false)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_039: [ constbuffer_array_cursor_read shall copy the size bytes after the cursor in destination, calling CONSTBUFFER_GetContent for each buffer it copies from. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_040: [ constbuffer_array_cursor_read shall move the cursor size bytes further and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_read_across_buffers_succeeds)
 {
     ///arrange
-    bool result;
-    CONSTBUFFER_ARRAY_HANDLE left = constbuffer_array_create(&TEST_CONSTBUFFER_HANDLE_1, 1);
-    ASSERT_IS_NOT_NULL(left);
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor = TEST_constbuffer_array_cursor_create(constbuffer_array);
+    unsigned char destination[4];
+    int result;
 
-    CONSTBUFFER_HANDLE twoAndThree[2];
-    twoAndThree[0] = TEST_CONSTBUFFER_HANDLE_2;
-    twoAndThree[1] = TEST_CONSTBUFFER_HANDLE_3;
-    CONSTBUFFER_ARRAY_HANDLE right = constbuffer_array_create(twoAndThree, 2);
-    ASSERT_IS_NOT_NULL(right);
-    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
 
     ///act
-    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(left, right);
+    result = constbuffer_array_cursor_read(cursor, destination, sizeof(destination));
 
     ///assert
-    ASSERT_IS_FALSE(result);
+    ASSERT_ARE_EQUAL(int, 0, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, memcmp(destination, "1223", sizeof(destination)));
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(three) - 1, TEST_constbuffer_array_cursor_get_remaining_size(cursor));
 
-    ///clean
-    constbuffer_array_dec_ref(left);
-    constbuffer_array_dec_ref(right);
+    ///cleanup
+    constbuffer_array_cursor_destroy(cursor);
+    constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_054: [ If left and right CONSTBUFFER_HANDLEs at same index are different (as indicated by CONSTBUFFER_HANDLE_contain_same call) then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return false. ]*/
-TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_content_of_buffers_different_return_false)
+/* constbuffer_array_cursor_skip */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_041: [ If cursor is NULL then constbuffer_array_cursor_skip shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_skip_with_NULL_cursor_fails)
 {
     ///arrange
-    bool result;
-    CONSTBUFFER_HANDLE twoAndOne[2];
-    twoAndOne[0] = TEST_CONSTBUFFER_HANDLE_2;
-    twoAndOne[1] = TEST_CONSTBUFFER_HANDLE_1;
-    CONSTBUFFER_ARRAY_HANDLE left = constbuffer_array_create(twoAndOne, 2);
-    ASSERT_IS_NOT_NULL(left);
+    int result;
 
-    CONSTBUFFER_HANDLE twoAndThree[2];
-    twoAndThree[0] = TEST_CONSTBUFFER_HANDLE_2;
-    twoAndThree[1] = TEST_CONSTBUFFER_HANDLE_3;
-    CONSTBUFFER_ARRAY_HANDLE right = constbuffer_array_create(twoAndThree, 2);
-    ASSERT_IS_NOT_NULL(right);
-    umock_c_reset_all_calls();
+    ///act
+    result = constbuffer_array_cursor_skip(NULL, 1);
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_HANDLE_contain_same(TEST_CONSTBUFFER_HANDLE_2, TEST_CONSTBUFFER_HANDLE_2));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_HANDLE_contain_same(TEST_CONSTBUFFER_HANDLE_1, TEST_CONSTBUFFER_HANDLE_3));
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_042: [ If size is greater than the number of bytes after the cursor then constbuffer_array_cursor_skip shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_skip_with_size_too_big_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(1, 0);
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor = TEST_constbuffer_array_cursor_create(constbuffer_array);
+    int result;
 
     ///act
-    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(left, right);
+    result = constbuffer_array_cursor_skip(cursor, sizeof(one) + 1);
 
     ///assert
-    ASSERT_IS_FALSE(result);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    ///clean
-    constbuffer_array_dec_ref(left);
-    constbuffer_array_dec_ref(right);
+    ///cleanup
+    constbuffer_array_cursor_destroy(cursor);
+    constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_055: [ CONSTBUFFER_ARRAY_HANDLE_contain_same shall return true. ]*/
-TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_content_of_buffers_same_return_true)
+/*Tests_SRS_CONSTBUFFER_ARRAY_04_043: [ Otherwise constbuffer_array_cursor_skip shall move the cursor size bytes further and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_cursor_skip_succeeds)
 {
     ///arrange
-    bool result;
-    CONSTBUFFER_HANDLE twoAndOne[2];
-    twoAndOne[0] = TEST_CONSTBUFFER_HANDLE_2;
-    twoAndOne[1] = TEST_CONSTBUFFER_HANDLE_1;
-    CONSTBUFFER_ARRAY_HANDLE left = constbuffer_array_create(twoAndOne, 2);
-    ASSERT_IS_NOT_NULL(left);
-
-    CONSTBUFFER_HANDLE alsoTwoAndOne[2];
-    alsoTwoAndOne[0] = TEST_CONSTBUFFER_HANDLE_2;
-    alsoTwoAndOne[1] = TEST_CONSTBUFFER_HANDLE_1;
-    CONSTBUFFER_ARRAY_HANDLE right = constbuffer_array_create(alsoTwoAndOne, 2);
-    ASSERT_IS_NOT_NULL(right);
-    umock_c_reset_all_calls();
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor = TEST_constbuffer_array_cursor_create(constbuffer_array);
+    unsigned char destination[1];
+    int result;
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_HANDLE_contain_same(TEST_CONSTBUFFER_HANDLE_2, TEST_CONSTBUFFER_HANDLE_2));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_HANDLE_contain_same(TEST_CONSTBUFFER_HANDLE_1, TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
 
     ///act
-    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(left, right);
+    result = constbuffer_array_cursor_skip(cursor, sizeof(one) + sizeof(two));
 
     ///assert
-    ASSERT_IS_TRUE(result);
+    ASSERT_ARE_EQUAL(int, 0, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(three), TEST_constbuffer_array_cursor_get_remaining_size(cursor));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_cursor_read(cursor, destination, sizeof(destination)));
+    ASSERT_ARE_EQUAL(int, '3', destination[0]);
 
-    ///clean
-    constbuffer_array_dec_ref(left);
-    constbuffer_array_dec_ref(right);
+    ///cleanup
+    constbuffer_array_cursor_destroy(cursor);
+    constbuffer_array_dec_ref(constbuffer_array);
 }
 
-
 END_TEST_SUITE(constbuffer_array_unittests)
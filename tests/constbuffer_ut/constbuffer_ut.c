@@ -1018,6 +1018,7 @@ BEGIN_TEST_SUITE(constbuffer_unittests)
     }
 
     /*Tests_SRS_CONSTBUFFER_02_024: [ If the constbufferHandle was created by calling CONSTBUFFER_CreateFromOffsetAndSize then CONSTBUFFER_DecRef shall decrement the ref count of the original handle passed to CONSTBUFFER_CreateFromOffsetAndSize. ]*/
+    /*Tests_SRS_CONSTBUFFER_04_001: [ If handle was itself created by CONSTBUFFER_CreateFromOffsetAndSize then CONSTBUFFER_CreateFromOffsetAndSize shall use the handle that handle was created from instead of handle. ]*/
     TEST_FUNCTION(CONSTBUFFER_DecRef_for_CONSTBUFFER_CreateFromOffsetAndSize_succeeds_3)
     {
         ///arrange
@@ -1044,19 +1045,24 @@ BEGIN_TEST_SUITE(constbuffer_unittests)
         CONSTBUFFER_DecRef(origin);
         umock_c_reset_all_calls();
 
-        /*note: no expected calls - after the below call all buffers are at ref count == 1*/
+        /*result2 has a ref to origin, not to result1, so only result1 is freed*/
+        STRICT_EXPECTED_CALL(gballoc_free(result1));
 
         ///act
-        CONSTBUFFER_DecRef(result1); /*at this time result 2 has a ref to result1, which has a ref to origin. Nothing is freed*/
+        CONSTBUFFER_DecRef(result1);
 
         ///assert 
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        const CONSTBUFFER* content = CONSTBUFFER_GetContent(result2);
+        ASSERT_ARE_EQUAL(size_t, 1, content->size);
+        ASSERT_IS_TRUE(memcmp(content->buffer, source + 1, 1) == 0);
 
         ///cleanup
-        CONSTBUFFER_DecRef(result2); /*triggers the release of result1, which triggers the release of origin*/
+        CONSTBUFFER_DecRef(result2); /*triggers the release of origin*/
     }
 
     /*Tests_SRS_CONSTBUFFER_02_024: [ If the constbufferHandle was created by calling CONSTBUFFER_CreateFromOffsetAndSize then CONSTBUFFER_DecRef shall decrement the ref count of the original handle passed to CONSTBUFFER_CreateFromOffsetAndSize. ]*/
+    /*Tests_SRS_CONSTBUFFER_04_001: [ If handle was itself created by CONSTBUFFER_CreateFromOffsetAndSize then CONSTBUFFER_CreateFromOffsetAndSize shall use the handle that handle was created from instead of handle. ]*/
     TEST_FUNCTION(CONSTBUFFER_DecRef_for_CONSTBUFFER_CreateFromOffsetAndSize_succeeds_4)
     {
         ///arrange
@@ -1081,17 +1087,14 @@ BEGIN_TEST_SUITE(constbuffer_unittests)
         umock_c_reset_all_calls();
 
         CONSTBUFFER_DecRef(origin);
-        CONSTBUFFER_DecRef(result1); /*at this time result 2 has a ref to result1, which has a ref to origin. Nothing is freed*/
+        CONSTBUFFER_DecRef(result1); /*result1 is freed, result2 has a ref to origin*/
         umock_c_reset_all_calls();
 
-        /*note: no expected calls - after the below call all buffers are at ref count == 1*/
-
         STRICT_EXPECTED_CALL(gballoc_free(origin));
-        STRICT_EXPECTED_CALL(gballoc_free(result1));
         STRICT_EXPECTED_CALL(gballoc_free(result2));
 
         ///act
-        CONSTBUFFER_DecRef(result2); /*triggers the release of result1, which triggers the release of origin*/
+        CONSTBUFFER_DecRef(result2); /*triggers the release of origin*/
 
         ///assert 
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -0,0 +1,548 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#if defined(GB_MEASURE_MEMORY_FOR_THIS)
+#undef GB_MEASURE_MEMORY_FOR_THIS
+#endif
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+#include "azure_c_shared_utility/optimize_size.h"
+#include "azure_c_shared_utility/gballoc.h"
+#include "testrunnerswitcher.h"
+
+#ifndef SIZE_MAX
+#define SIZE_MAX ((size_t)~(size_t)0)
+#endif
+
+static TEST_MUTEX_HANDLE g_testByTest;
+
+/* a block that looks like it was not allocated by gballoc: the bytes in front of the pointer are all zero */
+static unsigned char foreign_block[128];
+
+#define ENABLE_MOCKS
+
+#include "umock_c/umock_c.h"
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+    MOCKABLE_FUNCTION(, void*, mock_malloc, size_t, size);
+    MOCKABLE_FUNCTION(, void*, mock_calloc, size_t, nmemb, size_t, size);
+    MOCKABLE_FUNCTION(, void*, mock_realloc, void*, ptr, size_t, size);
+    MOCKABLE_FUNCTION(, void, mock_free, void*, ptr);
+#ifdef __cplusplus
+}
+#endif
+
+#undef ENABLE_MOCKS
+
+/* the last block returned by the underlying malloc, the header of a gballoc allocation is at its start */
+static unsigned char* last_block;
+
+static void* my_mock_malloc(size_t size)
+{
+    last_block = (unsigned char*)malloc(size);
+    return last_block;
+}
+
+static void* my_mock_calloc(size_t nmemb, size_t size)
+{
+    return calloc(nmemb, size);
+}
+
+static void* my_mock_realloc(void* ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+static void my_mock_free(void* ptr)
+{
+    free(ptr);
+}
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+BEGIN_TEST_SUITE(GBAlloc_Header_UnitTests)
+
+TEST_SUITE_INITIALIZE(TestClassInitialize)
+{
+    int result;
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    result = umock_c_init(on_umock_c_error);
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    REGISTER_GLOBAL_MOCK_HOOK(mock_malloc, my_mock_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_calloc, my_mock_calloc);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_realloc, my_mock_realloc);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_free, my_mock_free);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+{
+    gballoc_deinit();
+
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* gballoc_init */
+
+/* Tests_SRS_GBALLOC_01_024: [gballoc_init shall initialize the gballoc module and return 0 upon success.] */
+/* Tests_SRS_GBALLOC_07_009: [ When built with GB_TRACK_IN_HEADER, gballoc_init shall not create a lock. ]*/
+TEST_FUNCTION(gballoc_init_succeeds_without_allocating)
+{
+    // arrange
+    int result;
+
+    // act
+    result = gballoc_init();
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getMaximumMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getAllocationCount());
+}
+
+/* Tests_SRS_GBALLOC_01_025: [Init after Init shall fail and return a non-zero value.] */
+TEST_FUNCTION(gballoc_init_after_gballoc_init_fails)
+{
+    // arrange
+    int result;
+    (void)gballoc_init();
+
+    // act
+    result = gballoc_init();
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_GBALLOC_01_002: [Upon initialization the total memory used and maximum total memory used tracked by the module shall be set to 0.] */
+TEST_FUNCTION(gballoc_init_resets_memory_used)
+{
+    // arrange
+    (void)gballoc_init();
+    gballoc_free(gballoc_malloc(10));
+    gballoc_deinit();
+
+    // act
+    (void)gballoc_init();
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getMaximumMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getAllocationCount());
+}
+
+/* gballoc_malloc */
+
+/* Tests_SRS_GBALLOC_01_003: [gballoc_malloc shall call the C99 malloc function and return its result.] */
+/* Tests_SRS_GBALLOC_01_004: [If the underlying malloc call is successful, gballoc_malloc shall increment the total memory used with the amount indicated by size.] */
+/* Tests_SRS_GBALLOC_07_010: [ When built with GB_TRACK_IN_HEADER, gballoc_malloc, gballoc_calloc and gballoc_realloc shall allocate a header in front of the returned memory to hold the size, also when gballoc is not initialized. ]*/
+/* Tests_SRS_GBALLOC_07_011: [ When built with GB_TRACK_IN_HEADER, the counters shall be updated with atomic operations and without taking a lock. ]*/
+TEST_FUNCTION(gballoc_malloc_allocates_a_header_and_counts_the_size)
+{
+    // arrange
+    void* result;
+    (void)gballoc_init();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_malloc(IGNORED_ARG));
+
+    // act
+    result = gballoc_malloc(10);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 10, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 10, gballoc_getMaximumMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 1, gballoc_getAllocationCount());
+    (void)memset(result, 0xAB, 10);
+
+    ///cleanup
+    gballoc_free(result);
+}
+
+/* Tests_SRS_GBALLOC_01_012: [When the underlying malloc call fails, gballoc_malloc shall return NULL and size should not be counted towards total memory used.] */
+TEST_FUNCTION(when_the_underlying_malloc_fails_gballoc_malloc_fails)
+{
+    // arrange
+    void* result;
+    (void)gballoc_init();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    // act
+    result = gballoc_malloc(10);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getAllocationCount());
+}
+
+TEST_FUNCTION(gballoc_malloc_with_a_size_that_overflows_with_the_header_fails)
+{
+    // arrange
+    void* result;
+    (void)gballoc_init();
+    umock_c_reset_all_calls();
+
+    // act
+    result = gballoc_malloc(SIZE_MAX - 1);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_01_039: [If gballoc was not initialized gballoc_malloc shall simply call malloc without any memory tracking being performed.] */
+TEST_FUNCTION(memory_allocated_before_init_can_be_freed_after_init_and_is_not_counted)
+{
+    // arrange
+    void* allocation = gballoc_malloc(10);
+    ASSERT_IS_NOT_NULL(allocation);
+    (void)gballoc_init();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_free(IGNORED_ARG));
+
+    // act
+    gballoc_free(allocation);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+}
+
+/* gballoc_calloc */
+
+/* Tests_SRS_GBALLOC_01_020: [gballoc_calloc shall call the C99 calloc function and return its result.] */
+/* Tests_SRS_GBALLOC_01_021: [If the underlying calloc call is successful, gballoc_calloc shall increment the total memory used with nmemb*size.] */
+TEST_FUNCTION(gballoc_calloc_returns_zeroed_memory_and_counts_nmemb_times_size)
+{
+    // arrange
+    unsigned char* result;
+    size_t i;
+    (void)gballoc_init();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_calloc(1, IGNORED_ARG));
+
+    // act
+    result = (unsigned char*)gballoc_calloc(3, 5);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    for (i = 0; i < 15; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, result[i]);
+    }
+    ASSERT_ARE_EQUAL(size_t, 15, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 1, gballoc_getAllocationCount());
+
+    ///cleanup
+    gballoc_free(result);
+}
+
+/* Tests_SRS_GBALLOC_01_022: [When the underlying calloc call fails, gballoc_calloc shall return NULL and size should not be counted towards total memory used.] */
+TEST_FUNCTION(when_the_underlying_calloc_fails_gballoc_calloc_fails)
+{
+    // arrange
+    void* result;
+    (void)gballoc_init();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_calloc(1, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    // act
+    result = gballoc_calloc(3, 5);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+}
+
+TEST_FUNCTION(gballoc_calloc_with_nmemb_times_size_overflowing_fails)
+{
+    // arrange
+    void* result;
+    (void)gballoc_init();
+    umock_c_reset_all_calls();
+
+    // act
+    result = gballoc_calloc(SIZE_MAX / 2, 3);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* gballoc_realloc */
+
+/* Tests_SRS_GBALLOC_01_017: [When ptr is NULL, gballoc_realloc shall call the underlying realloc with ptr being NULL and the realloc result shall be tracked by gballoc.] */
+TEST_FUNCTION(gballoc_realloc_with_NULL_counts_the_new_block)
+{
+    // arrange
+    void* result;
+    (void)gballoc_init();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_realloc(NULL, IGNORED_ARG));
+
+    // act
+    result = gballoc_realloc(NULL, 20);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 20, gballoc_getCurrentMemoryUsed());
+
+    ///cleanup
+    gballoc_free(result);
+}
+
+/* Tests_SRS_GBALLOC_01_005: [gballoc_realloc shall call the C99 realloc function and return its result.] */
+/* Tests_SRS_GBALLOC_01_006: [If the underlying realloc call is successful, gballoc_realloc shall look up the size associated with the pointer ptr and decrease the total memory used with that size.] */
+/* Tests_SRS_GBALLOC_01_007: [If realloc is successful, gballoc_realloc shall also increment the total memory used value tracked by this module.] */
+TEST_FUNCTION(gballoc_realloc_replaces_the_old_size_with_the_new_size)
+{
+    // arrange
+    unsigned char* allocation;
+    unsigned char* result;
+    (void)gballoc_init();
+    allocation = (unsigned char*)gballoc_malloc(10);
+    ASSERT_IS_NOT_NULL(allocation);
+    (void)memset(allocation, 0x42, 10);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_realloc(IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    result = (unsigned char*)gballoc_realloc(allocation, 30);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0x42, result[9]);
+    ASSERT_ARE_EQUAL(size_t, 30, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 30, gballoc_getMaximumMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 2, gballoc_getAllocationCount());
+
+    ///cleanup
+    gballoc_free(result);
+}
+
+/* Tests_SRS_GBALLOC_01_014: [When the underlying realloc call fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
+TEST_FUNCTION(when_the_underlying_realloc_fails_gballoc_realloc_fails_and_keeps_the_old_size)
+{
+    // arrange
+    void* allocation;
+    void* result;
+    (void)gballoc_init();
+    allocation = gballoc_malloc(10);
+    ASSERT_IS_NOT_NULL(allocation);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_realloc(IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    // act
+    result = gballoc_realloc(allocation, 30);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 10, gballoc_getCurrentMemoryUsed());
+
+    ///cleanup
+    gballoc_free(allocation);
+}
+
+/* Tests_SRS_GBALLOC_01_016: [When the ptr pointer cannot be found in the pointers tracked by gballoc, gballoc_realloc shall return NULL and the underlying realloc shall not be called.] */
+TEST_FUNCTION(gballoc_realloc_with_a_pointer_not_allocated_by_gballoc_fails)
+{
+    // arrange
+    void* result;
+    (void)gballoc_init();
+    umock_c_reset_all_calls();
+
+    // act
+    result = gballoc_realloc(foreign_block + 64, 30);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* gballoc_free */
+
+/* Tests_SRS_GBALLOC_01_008: [gballoc_free shall call the C99 free function.] */
+/* Tests_SRS_GBALLOC_01_009: [gballoc_free shall also look up the size associated with the ptr pointer and decrease the total memory used with the associated size amount.] */
+/* Tests_SRS_GBALLOC_01_011: [The maximum total memory used shall be the maximum of the total memory used at any point.] */
+TEST_FUNCTION(gballoc_free_decreases_the_memory_used_and_keeps_the_maximum)
+{
+    // arrange
+    void* allocation1;
+    void* allocation2;
+    (void)gballoc_init();
+    allocation1 = gballoc_malloc(10);
+    allocation2 = gballoc_malloc(20);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_free(IGNORED_ARG));
+
+    // act
+    gballoc_free(allocation2);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 10, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 30, gballoc_getMaximumMemoryUsed());
+
+    ///cleanup
+    gballoc_free(allocation1);
+}
+
+/* Tests_SRS_GBALLOC_01_019: [When the ptr pointer cannot be found in the pointers tracked by gballoc, gballoc_free shall not free any memory.] */
+TEST_FUNCTION(gballoc_free_with_a_pointer_not_allocated_by_gballoc_does_not_free)
+{
+    // arrange
+    (void)gballoc_init();
+    umock_c_reset_all_calls();
+
+    // act
+    gballoc_free(foreign_block + 64);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_01_019: [When the ptr pointer cannot be found in the pointers tracked by gballoc, gballoc_free shall not free any memory.] */
+TEST_FUNCTION(gballoc_free_with_a_copy_of_a_header_at_another_address_does_not_free)
+{
+    // arrange
+    unsigned char* allocation;
+    size_t header_size;
+    (void)gballoc_init();
+    allocation = (unsigned char*)gballoc_malloc(10);
+    ASSERT_IS_NOT_NULL(allocation);
+    header_size = (size_t)(allocation - last_block);
+    ASSERT_IS_TRUE(header_size <= 64);
+    (void)memcpy(foreign_block + 64 - header_size, last_block, header_size);
+    umock_c_reset_all_calls();
+
+    // act
+    gballoc_free(foreign_block + 64);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 10, gballoc_getCurrentMemoryUsed());
+
+    ///cleanup
+    (void)memset(foreign_block, 0, sizeof(foreign_block));
+    gballoc_free(allocation);
+}
+
+TEST_FUNCTION(gballoc_free_with_NULL_does_nothing)
+{
+    // arrange
+    (void)gballoc_init();
+    umock_c_reset_all_calls();
+
+    // act
+    gballoc_free(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+}
+
+/* gballoc_resetMetrics */
+
+/* Tests_SRS_GBALLOC_07_008: [ gballoc_resetMetrics shall reset the total allocation size, max allocation size and number of allocation to zero. ] */
+/* Tests_SRS_GBALLOC_07_012: [ When built with GB_TRACK_IN_HEADER, memory allocated before gballoc_resetMetrics shall not be subtracted from the total memory used when it is freed. ]*/
+TEST_FUNCTION(gballoc_resetMetrics_resets_and_older_allocations_are_not_subtracted)
+{
+    // arrange
+    void* allocation1;
+    void* allocation2;
+    (void)gballoc_init();
+    allocation1 = gballoc_malloc(10);
+
+    // act
+    gballoc_resetMetrics();
+    allocation2 = gballoc_malloc(20);
+    gballoc_free(allocation1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 20, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 20, gballoc_getMaximumMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 1, gballoc_getAllocationCount());
+
+    ///cleanup
+    gballoc_free(allocation2);
+}
+
+/* getters without init */
+
+/* Tests_SRS_GBALLOC_01_038: [If gballoc was not initialized gballoc_getMaximumMemoryUsed shall return MAX_INT_SIZE.] */
+/* Tests_SRS_GBALLOC_01_044: [If gballoc was not initialized gballoc_getCurrentMemoryUsed shall return SIZE_MAX.] */
+/* Tests_SRS_GBALLOC_07_001: [ If gballoc was not initialized gballoc_getAllocationCount shall return 0. ] */
+TEST_FUNCTION(the_metrics_are_not_available_when_not_initialized)
+{
+    // arrange
+    void* allocation = gballoc_malloc(10);
+
+    // act
+    // assert
+    ASSERT_ARE_EQUAL(size_t, SIZE_MAX, gballoc_getMaximumMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, SIZE_MAX, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getAllocationCount());
+
+    ///cleanup
+    gballoc_free(allocation);
+}
+
+END_TEST_SUITE(GBAlloc_Header_UnitTests)
@@ -0,0 +1,171 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#include "perf_measure.h"
+
+/*the baseline is the C runtime allocator, gballoc is called by name*/
+#undef malloc
+#undef free
+
+#define GBALLOC_PERF_ITERATIONS 1000000
+#define GBALLOC_PERF_THREAD_COUNT 4
+#define GBALLOC_PERF_THREAD_ROUNDS 200000
+/*the blocks allocated in a row before they are freed, a STRING, a MAP entry, a couple of headers...*/
+#define GBALLOC_PERF_BLOCKS 16
+
+/*the small sizes the library allocates most: handles, short strings, list nodes*/
+static const size_t BLOCK_SIZES[GBALLOC_PERF_BLOCKS] = { 8, 16, 24, 32, 40, 48, 64, 80, 16, 24, 96, 128, 12, 20, 200, 300 };
+
+typedef void*(*ALLOCATE_FUNCTION)(size_t size);
+typedef void(*RELEASE_FUNCTION)(void* ptr);
+
+typedef struct ALLOCATOR_TAG
+{
+    ALLOCATE_FUNCTION allocate;
+    RELEASE_FUNCTION release;
+} ALLOCATOR;
+
+static const ALLOCATOR SYSTEM_ALLOCATOR = { malloc, free };
+static const ALLOCATOR GBALLOC_ALLOCATOR = { gballoc_malloc, gballoc_free };
+
+static TEST_MUTEX_HANDLE g_testByTest;
+
+static void allocate_and_release_blocks(const ALLOCATOR* allocator)
+{
+    void* blocks[GBALLOC_PERF_BLOCKS];
+    size_t i;
+    for (i = 0; i < GBALLOC_PERF_BLOCKS; i++)
+    {
+        blocks[i] = allocator->allocate(BLOCK_SIZES[i]);
+    }
+    for (i = 0; i < GBALLOC_PERF_BLOCKS; i++)
+    {
+        allocator->release(blocks[i]);
+    }
+}
+
+static void allocate_and_release(void* context, size_t iteration)
+{
+    (void)iteration;
+    allocate_and_release_blocks((const ALLOCATOR*)context);
+}
+
+static int allocating_thread(void* context)
+{
+    size_t round;
+    for (round = 0; round < GBALLOC_PERF_THREAD_ROUNDS; round++)
+    {
+        allocate_and_release_blocks((const ALLOCATOR*)context);
+    }
+    return 0;
+}
+
+/*returns the time per allocation + free pair with GBALLOC_PERF_THREAD_COUNT threads allocating at the same time*/
+static double run_threads(const char* name, const ALLOCATOR* allocator)
+{
+    THREAD_HANDLE threads[GBALLOC_PERF_THREAD_COUNT];
+    size_t i;
+    double start = perf_measure_now_ns();
+    double result;
+
+    for (i = 0; i < GBALLOC_PERF_THREAD_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, THREADAPI_OK, ThreadAPI_Create(&threads[i], allocating_thread, (void*)allocator));
+    }
+    for (i = 0; i < GBALLOC_PERF_THREAD_COUNT; i++)
+    {
+        int thread_result;
+        ASSERT_ARE_EQUAL(int, THREADAPI_OK, ThreadAPI_Join(threads[i], &thread_result));
+    }
+
+    result = (perf_measure_now_ns() - start) / ((double)GBALLOC_PERF_THREAD_COUNT * GBALLOC_PERF_THREAD_ROUNDS * GBALLOC_PERF_BLOCKS);
+    LogInfo("%s: %.1f ns/op with %d threads", name, result, GBALLOC_PERF_THREAD_COUNT);
+    return result;
+}
+
+BEGIN_TEST_SUITE(gballoc_perf)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+TEST_FUNCTION(malloc_free_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result = perf_measure_run("16 x malloc + 16 x free", allocate_and_release, (void*)&SYSTEM_ALLOCATOR, GBALLOC_PERF_ITERATIONS);
+
+    ///assert
+    ASSERT_IS_TRUE(result.ns_per_op > 0.0);
+}
+
+TEST_FUNCTION(gballoc_pool_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result = perf_measure_run("16 x gballoc_malloc + 16 x gballoc_free (pool)", allocate_and_release, (void*)&GBALLOC_ALLOCATOR, GBALLOC_PERF_ITERATIONS);
+
+    ///assert
+    ASSERT_IS_TRUE(result.allocations_per_op == (double)GBALLOC_PERF_BLOCKS);
+}
+
+TEST_FUNCTION(malloc_free_threads_perf)
+{
+    ///act
+    double ns_per_op = run_threads("malloc + free", &SYSTEM_ALLOCATOR);
+
+    ///assert
+    ASSERT_IS_TRUE(ns_per_op > 0.0);
+}
+
+TEST_FUNCTION(gballoc_pool_threads_perf)
+{
+    ///arrange
+    size_t hits;
+    size_t misses;
+
+    ///act
+    double ns_per_op = run_threads("gballoc_malloc + gballoc_free (pool)", &GBALLOC_ALLOCATOR);
+
+    ///assert
+    hits = gballoc_getPoolHitCount();
+    misses = gballoc_getPoolMissCount();
+    LogInfo("pool: %zu hits, %zu misses, %zu bytes reserved, %zu bytes not in use", hits, misses, gballoc_getPoolReservedMemory(), gballoc_getPoolWastedMemory());
+    ASSERT_IS_TRUE(ns_per_op > 0.0);
+    /*the slabs are carved once, everything after comes from the caches*/
+    ASSERT_IS_TRUE(hits > 1000 * misses);
+}
+
+END_TEST_SUITE(gballoc_perf)
@@ -0,0 +1,480 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#if defined(GB_MEASURE_MEMORY_FOR_THIS)
+#undef GB_MEASURE_MEMORY_FOR_THIS
+#endif
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+#include "azure_c_shared_utility/optimize_size.h"
+#include "azure_c_shared_utility/gballoc.h"
+#include "testrunnerswitcher.h"
+
+#ifndef SIZE_MAX
+#define SIZE_MAX ((size_t)~(size_t)0)
+#endif
+
+/* must match the slab size of the pool */
+#define TEST_SLAB_SIZE 16384
+/* a size that does not fit the biggest class (512 bytes, header included) */
+#define TEST_BIG_SIZE 1000
+
+static TEST_MUTEX_HANDLE g_testByTest;
+
+#define ENABLE_MOCKS
+
+#include "umock_c/umock_c.h"
+#include "umock_c/umock_c_prod.h"
+#include "azure_c_shared_utility/threadapi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+    MOCKABLE_FUNCTION(, void*, mock_malloc, size_t, size);
+    MOCKABLE_FUNCTION(, void*, mock_calloc, size_t, nmemb, size_t, size);
+    MOCKABLE_FUNCTION(, void*, mock_realloc, void*, ptr, size_t, size);
+    MOCKABLE_FUNCTION(, void, mock_free, void*, ptr);
+#ifdef __cplusplus
+}
+#endif
+
+#undef ENABLE_MOCKS
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+    extern void gballoc_pool_reset(void);
+    extern void gballoc_pool_exit_thread(void);
+#ifdef __cplusplus
+}
+#endif
+
+static void* my_mock_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+static void* my_mock_calloc(size_t nmemb, size_t size)
+{
+    return calloc(nmemb, size);
+}
+
+static void* my_mock_realloc(void* ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+static void my_mock_free(void* ptr)
+{
+    free(ptr);
+}
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+BEGIN_TEST_SUITE(GBAlloc_Pool_UnitTests)
+
+TEST_SUITE_INITIALIZE(TestClassInitialize)
+{
+    int result;
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    result = umock_c_init(on_umock_c_error);
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    REGISTER_GLOBAL_MOCK_HOOK(mock_malloc, my_mock_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_calloc, my_mock_calloc);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_realloc, my_mock_realloc);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_free, my_mock_free);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+{
+    gballoc_deinit();
+    gballoc_pool_reset();
+
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* Tests_SRS_GBALLOC_07_013: [ When built with GB_USE_POOL, allocations that fit in a size class shall be served from the pool instead of malloc. ]*/
+/* Tests_SRS_GBALLOC_07_015: [ An allocation served without calling malloc shall be counted as a pool hit, an allocation that needed a new slab shall be counted as a pool miss. ]*/
+/* Tests_SRS_GBALLOC_07_017: [ gballoc_getPoolMissCount shall return the number of allocations for which the pool had to allocate a new slab. ]*/
+/* Tests_SRS_GBALLOC_07_018: [ gballoc_getPoolReservedMemory shall return the memory allocated by the pool for its slabs. ]*/
+TEST_FUNCTION(the_first_small_allocation_creates_the_thread_cache_and_a_slab)
+{
+    // arrange
+    void* result;
+
+    STRICT_EXPECTED_CALL(mock_calloc(1, IGNORED_ARG)); /* thread cache */
+    STRICT_EXPECTED_CALL(mock_malloc(TEST_SLAB_SIZE));
+
+    // act
+    result = gballoc_malloc(10);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getPoolHitCount());
+    ASSERT_ARE_EQUAL(size_t, 1, gballoc_getPoolMissCount());
+    ASSERT_ARE_EQUAL(size_t, TEST_SLAB_SIZE, gballoc_getPoolReservedMemory());
+    (void)memset(result, 0x42, 10);
+
+    ///cleanup
+    gballoc_free(result);
+}
+
+/* Tests_SRS_GBALLOC_07_014: [ When built with GB_USE_POOL, blocks shall be taken from a per-thread cache without taking a lock when the cache has one. ]*/
+/* Tests_SRS_GBALLOC_07_016: [ gballoc_getPoolHitCount shall return the number of allocations served by the pool without calling malloc. ]*/
+TEST_FUNCTION(small_allocations_after_the_first_are_served_from_the_thread_cache)
+{
+    // arrange
+    void* allocation1 = gballoc_malloc(10);
+    void* allocation2;
+    void* allocation3;
+    umock_c_reset_all_calls();
+
+    // act
+    allocation2 = gballoc_malloc(12);
+    gballoc_free(allocation1);
+    allocation3 = gballoc_malloc(10);
+
+    // assert
+    ASSERT_IS_NOT_NULL(allocation2);
+    ASSERT_ARE_EQUAL(void_ptr, allocation1, allocation3);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 2, gballoc_getPoolHitCount());
+    ASSERT_ARE_EQUAL(size_t, 1, gballoc_getPoolMissCount());
+
+    ///cleanup
+    gballoc_free(allocation2);
+    gballoc_free(allocation3);
+}
+
+TEST_FUNCTION(allocations_too_big_for_the_pool_go_to_malloc_and_free)
+{
+    // arrange
+    void* result;
+
+    STRICT_EXPECTED_CALL(mock_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_free(IGNORED_ARG));
+
+    // act
+    result = gballoc_malloc(TEST_BIG_SIZE);
+    gballoc_free(result);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getPoolReservedMemory());
+}
+
+/* Tests_SRS_GBALLOC_01_012: [When the underlying malloc call fails, gballoc_malloc shall return NULL and size should not be counted towards total memory used.] */
+TEST_FUNCTION(when_allocating_a_slab_fails_gballoc_malloc_fails)
+{
+    // arrange
+    void* result;
+    (void)gballoc_init();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_calloc(1, IGNORED_ARG)); /* thread cache */
+    STRICT_EXPECTED_CALL(mock_malloc(TEST_SLAB_SIZE))
+        .SetReturn(NULL);
+
+    // act
+    result = gballoc_malloc(10);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getPoolMissCount());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getPoolReservedMemory());
+}
+
+TEST_FUNCTION(when_the_thread_cache_cannot_be_allocated_the_shared_cache_is_used)
+{
+    // arrange
+    void* allocation;
+    void* result;
+
+    STRICT_EXPECTED_CALL(mock_calloc(1, IGNORED_ARG)) /* thread cache */
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(mock_malloc(TEST_SLAB_SIZE));
+    STRICT_EXPECTED_CALL(mock_calloc(1, IGNORED_ARG)) /* thread cache, on free */
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(mock_calloc(1, IGNORED_ARG)) /* thread cache, on the second malloc */
+        .SetReturn(NULL);
+
+    // act
+    allocation = gballoc_malloc(10);
+    gballoc_free(allocation);
+    result = gballoc_malloc(10);
+
+    // assert
+    ASSERT_IS_NOT_NULL(allocation);
+    ASSERT_ARE_EQUAL(void_ptr, allocation, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 1, gballoc_getPoolHitCount());
+    ASSERT_ARE_EQUAL(size_t, 1, gballoc_getPoolMissCount());
+
+    ///cleanup
+    gballoc_free(result);
+}
+
+/* Tests_SRS_GBALLOC_01_004: [If the underlying malloc call is successful, gballoc_malloc shall increment the total memory used with the amount indicated by size.] */
+/* Tests_SRS_GBALLOC_01_009: [gballoc_free shall also look up the size associated with the ptr pointer and decrease the total memory used with the associated size amount.] */
+TEST_FUNCTION(pooled_allocations_are_counted_in_the_memory_used)
+{
+    // arrange
+    void* allocation1;
+    void* allocation2;
+    (void)gballoc_init();
+
+    // act
+    allocation1 = gballoc_malloc(10);
+    allocation2 = gballoc_malloc(100);
+    gballoc_free(allocation1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 100, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 110, gballoc_getMaximumMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 2, gballoc_getAllocationCount());
+
+    ///cleanup
+    gballoc_free(allocation2);
+}
+
+/* Tests_SRS_GBALLOC_01_021: [If the underlying calloc call is successful, gballoc_calloc shall increment the total memory used with nmemb*size.] */
+TEST_FUNCTION(gballoc_calloc_from_the_pool_returns_zeroed_memory_when_the_block_is_reused)
+{
+    // arrange
+    unsigned char* allocation = (unsigned char*)gballoc_malloc(40);
+    unsigned char* result;
+    size_t i;
+    (void)memset(allocation, 0xFF, 40);
+    gballoc_free(allocation);
+    umock_c_reset_all_calls();
+
+    // act
+    result = (unsigned char*)gballoc_calloc(4, 10);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, allocation, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    for (i = 0; i < 40; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, result[i]);
+    }
+
+    ///cleanup
+    gballoc_free(result);
+}
+
+/* Tests_SRS_GBALLOC_01_005: [gballoc_realloc shall call the C99 realloc function and return its result.] */
+TEST_FUNCTION(gballoc_realloc_within_the_same_class_keeps_the_block)
+{
+    // arrange
+    /* both sizes are in the same class with the header sizes of the supported platforms (12 to 32 bytes) */
+    void* allocation = gballoc_malloc(100);
+    void* result;
+    umock_c_reset_all_calls();
+
+    // act
+    result = gballoc_realloc(allocation, 104);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, allocation, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    gballoc_free(result);
+}
+
+/* Tests_SRS_GBALLOC_01_006: [If the underlying realloc call is successful, gballoc_realloc shall look up the size associated with the pointer ptr and decrease the total memory used with that size.] */
+/* Tests_SRS_GBALLOC_01_007: [If realloc is successful, gballoc_realloc shall also increment the total memory used value tracked by this module.] */
+TEST_FUNCTION(gballoc_realloc_to_another_class_moves_the_content)
+{
+    // arrange
+    unsigned char* allocation;
+    unsigned char* result;
+    (void)gballoc_init();
+    allocation = (unsigned char*)gballoc_malloc(10);
+    (void)memset(allocation, 0x42, 10);
+
+    // act
+    result = (unsigned char*)gballoc_realloc(allocation, 200);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, allocation, result);
+    ASSERT_ARE_EQUAL(int, 0x42, result[0]);
+    ASSERT_ARE_EQUAL(int, 0x42, result[9]);
+    ASSERT_ARE_EQUAL(size_t, 200, gballoc_getCurrentMemoryUsed());
+
+    ///cleanup
+    gballoc_free(result);
+}
+
+TEST_FUNCTION(gballoc_realloc_from_the_pool_to_a_big_size_moves_to_malloc)
+{
+    // arrange
+    unsigned char* allocation = (unsigned char*)gballoc_malloc(10);
+    unsigned char* result;
+    (void)memset(allocation, 0x42, 10);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_malloc(IGNORED_ARG));
+
+    // act
+    result = (unsigned char*)gballoc_realloc(allocation, TEST_BIG_SIZE);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0x42, result[9]);
+
+    ///cleanup
+    gballoc_free(result);
+}
+
+/* Tests_SRS_GBALLOC_01_014: [When the underlying realloc call fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
+TEST_FUNCTION(when_moving_out_of_the_pool_fails_gballoc_realloc_fails_and_keeps_the_block)
+{
+    // arrange
+    unsigned char* allocation;
+    void* result;
+    (void)gballoc_init();
+    allocation = (unsigned char*)gballoc_malloc(10);
+    (void)memset(allocation, 0x42, 10);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    // act
+    result = gballoc_realloc(allocation, TEST_BIG_SIZE);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0x42, allocation[9]);
+    ASSERT_ARE_EQUAL(size_t, 10, gballoc_getCurrentMemoryUsed());
+
+    ///cleanup
+    gballoc_free(allocation);
+}
+
+/* Tests_SRS_GBALLOC_07_019: [ gballoc_getPoolWastedMemory shall return the memory reserved by the pool that is not holding requested bytes: free blocks, headers and the unused end of blocks. ]*/
+TEST_FUNCTION(gballoc_getPoolWastedMemory_is_the_reserved_memory_not_requested)
+{
+    // arrange
+    void* allocation1 = gballoc_malloc(10);
+    void* allocation2 = gballoc_malloc(12);
+    void* allocation3 = gballoc_malloc(14);
+
+    // act
+    gballoc_free(allocation2);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, TEST_SLAB_SIZE - 24, gballoc_getPoolWastedMemory());
+
+    ///cleanup
+    gballoc_free(allocation1);
+    gballoc_free(allocation3);
+    ASSERT_ARE_EQUAL(size_t, TEST_SLAB_SIZE, gballoc_getPoolWastedMemory());
+}
+
+TEST_FUNCTION(freed_blocks_beyond_the_thread_cache_limit_go_back_to_the_shared_depot)
+{
+    // arrange
+    void* allocations[200];
+    size_t i;
+    for (i = 0; i < 200; i++)
+    {
+        allocations[i] = gballoc_malloc(10);
+        ASSERT_IS_NOT_NULL(allocations[i]);
+    }
+
+    // act
+    for (i = 0; i < 200; i++)
+    {
+        gballoc_free(allocations[i]);
+    }
+    for (i = 0; i < 200; i++)
+    {
+        allocations[i] = gballoc_malloc(10);
+    }
+
+    // assert
+    /* 200 blocks of 32 bytes fit in one slab, so everything after the first allocation was a hit */
+    ASSERT_ARE_EQUAL(size_t, 1, gballoc_getPoolMissCount());
+    ASSERT_ARE_EQUAL(size_t, 399, gballoc_getPoolHitCount());
+    ASSERT_ARE_EQUAL(size_t, TEST_SLAB_SIZE, gballoc_getPoolReservedMemory());
+
+    ///cleanup
+    for (i = 0; i < 200; i++)
+    {
+        gballoc_free(allocations[i]);
+    }
+}
+
+/* Tests_SRS_GBALLOC_07_021: [ When a thread exits, the free blocks of its cache shall be given back to the pool and its counters shall be kept. ]*/
+TEST_FUNCTION(when_a_thread_exits_its_blocks_go_back_to_the_pool_and_its_counters_are_kept)
+{
+    // arrange
+    void* allocation = gballoc_malloc(10);
+    void* result;
+    ASSERT_IS_NOT_NULL(allocation);
+    gballoc_free(allocation);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_free(IGNORED_ARG)); /* thread cache */
+    STRICT_EXPECTED_CALL(mock_calloc(1, IGNORED_ARG)); /* thread cache of the next allocation */
+
+    // act
+    gballoc_pool_exit_thread();
+    result = gballoc_malloc(10);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 1, gballoc_getPoolMissCount());
+    ASSERT_ARE_EQUAL(size_t, 1, gballoc_getPoolHitCount());
+    ASSERT_ARE_EQUAL(size_t, TEST_SLAB_SIZE, gballoc_getPoolReservedMemory());
+    ASSERT_ARE_EQUAL(size_t, TEST_SLAB_SIZE - 10, gballoc_getPoolWastedMemory());
+
+    ///cleanup
+    gballoc_free(result);
+}
+
+END_TEST_SUITE(GBAlloc_Pool_UnitTests)
@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#define malloc mock_malloc
+#define calloc mock_calloc
+#define realloc mock_realloc
+#define free mock_free
+
+extern void* mock_malloc(size_t size);
+extern void* mock_calloc(size_t nmemb, size_t size);
+extern void* mock_realloc(void* ptr, size_t size);
+extern void mock_free(void* ptr);
+
+#undef _CRTDBG_MAP_ALLOC
+#ifndef GB_USE_POOL
+#define GB_USE_POOL
+#endif
+#include "../src/gballoc.c"
+
+#undef free
+
+/* gives the slabs and the thread caches back so that every test starts with an empty pool */
+void gballoc_pool_reset(void)
+{
+    size_t i;
+    while (pool_slabs != NULL)
+    {
+        void* next = *(void**)pool_slabs;
+        free(pool_slabs);
+        pool_slabs = next;
+    }
+    while (pool_thread_caches != NULL)
+    {
+        POOL_THREAD_CACHE* next = pool_thread_caches->next;
+        free(pool_thread_caches);
+        pool_thread_caches = next;
+    }
+    for (i = 0; i < POOL_CLASS_COUNT; i++)
+    {
+        pool_depot[i] = NULL;
+    }
+    (void)memset(&pool_shared_cache, 0, sizeof(pool_shared_cache));
+    pool_reserved_bytes = 0;
+    pool_thread_cache = NULL;
+    pool_set_thread_exit_cache(NULL);
+}
+
+/* does what happens when the calling thread exits */
+void gballoc_pool_exit_thread(void)
+{
+    pool_flush_thread_cache(pool_thread_cache);
+    pool_set_thread_exit_cache(NULL);
+}
@@ -0,0 +1,15 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stddef.h>
+#include "testrunnerswitcher.h"
+#include "c_logging/logger.h"
+
+int main(void)
+{
+    size_t failedTestCount = 0;
+    (void)logger_init();
+    RUN_TEST_SUITE(GBAlloc_Pool_UnitTests, failedTestCount);
+    logger_deinit();
+    return (int)failedTestCount;
+}
@@ -13,4 +13,7 @@ extern void* mock_realloc(void* ptr, size_t size);
 extern void mock_free(void* ptr);
 
 #undef _CRTDBG_MAP_ALLOC
+/* these tests cover the default tracking (list of allocations under a lock) */
+#undef GB_TRACK_IN_HEADER
+#undef GB_USE_POOL
 #include "../src/gballoc.c"
@@ -67,6 +67,7 @@ IMPLEMENT_UMOCK_C_ENUM_TYPE(IO_SEND_RESULT, IO_SEND_RESULT_VALUES);
 #define TEST_OPTION_HANDLER                     (OPTIONHANDLER_HANDLE)0x4244
 #define TEST_SOCKETIO_INTERFACE_DESCRIPTION     (const IO_INTERFACE_DESCRIPTION*)0x4242
 #define TEST_IO_HANDLE                          (XIO_HANDLE)0x4243
+#define TEST_CONSTBUFFER_ARRAY_HANDLE           (CONSTBUFFER_ARRAY_HANDLE)0x4248
 #define TEST_STRING_HANDLE                      (STRING_HANDLE)0x4244
 #define OPTION_UNDERLYING_IO_OPTIONS            "underlying_io_options"
 
@@ -338,6 +339,7 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(ON_IO_ERROR, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_IO_CLOSE_COMPLETE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_SEND_COMPLETE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_ARRAY_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(STRING_HANDLE, void*);
     REGISTER_UMOCKC_PAIRED_CREATE_DESTROY_CALLS(xio_create, xio_destroy);
 }
@@ -1354,6 +1356,148 @@ TEST_FUNCTION(when_xio_send_fails_http_proxy_io_send_also_fails)
     http_proxy_io_get_interface_description()->concrete_io_destroy(http_io);
 }
 
+/* http_proxy_io_send_array */
+
+/* Tests_SRS_HTTP_PROXY_IO_04_003: [ http_proxy_io_send_array shall send the buffers by calling xio_send_array on the underlying IO created in http_proxy_io_create and passing buffers, on_send_complete and on_send_complete_context as arguments. ]*/
+/* Tests_SRS_HTTP_PROXY_IO_04_005: [ On success http_proxy_io_send_array shall return 0. ]*/
+TEST_FUNCTION(http_proxy_io_send_array_calls_send_array_on_the_underlying_IO)
+{
+    // arrange
+    CONCRETE_IO_HANDLE http_io;
+    int result;
+
+    http_io = http_proxy_io_get_interface_description()->concrete_io_create((void*)&default_http_proxy_io_config);
+    (void)http_proxy_io_get_interface_description()->concrete_io_open(http_io, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    g_on_io_open_complete(g_on_io_open_complete_context, IO_OPEN_OK);
+    g_on_bytes_received(g_on_io_open_complete_context, (const unsigned char*)connect_response, sizeof(connect_response) - 1);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(xio_send_array(TEST_IO_HANDLE, TEST_CONSTBUFFER_ARRAY_HANDLE, test_on_send_complete, (void*)0x4247));
+
+    // act
+    result = http_proxy_io_get_interface_description()->concrete_io_send_array(http_io, TEST_CONSTBUFFER_ARRAY_HANDLE, test_on_send_complete, (void*)0x4247);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_get_interface_description()->concrete_io_destroy(http_io);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_04_001: [ If any of the arguments http_proxy_io or buffers is NULL, http_proxy_io_send_array shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(http_proxy_io_send_array_with_NULL_handle_fails)
+{
+    // arrange
+    int result;
+
+    // act
+    result = http_proxy_io_get_interface_description()->concrete_io_send_array(NULL, TEST_CONSTBUFFER_ARRAY_HANDLE, test_on_send_complete, (void*)0x4247);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_04_001: [ If any of the arguments http_proxy_io or buffers is NULL, http_proxy_io_send_array shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(http_proxy_io_send_array_with_NULL_buffers_fails)
+{
+    // arrange
+    CONCRETE_IO_HANDLE http_io;
+    int result;
+
+    http_io = http_proxy_io_get_interface_description()->concrete_io_create((void*)&default_http_proxy_io_config);
+    (void)http_proxy_io_get_interface_description()->concrete_io_open(http_io, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    g_on_io_open_complete(g_on_io_open_complete_context, IO_OPEN_OK);
+    g_on_bytes_received(g_on_io_open_complete_context, (const unsigned char*)connect_response, sizeof(connect_response) - 1);
+    umock_c_reset_all_calls();
+
+    // act
+    result = http_proxy_io_get_interface_description()->concrete_io_send_array(http_io, NULL, test_on_send_complete, (void*)0x4247);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_get_interface_description()->concrete_io_destroy(http_io);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_04_002: [ If http_proxy_io_send_array is called when the IO is not open or is in an error state, http_proxy_io_send_array shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(http_proxy_io_send_array_when_waiting_for_connect_reply_fails)
+{
+    // arrange
+    CONCRETE_IO_HANDLE http_io;
+    int result;
+
+    http_io = http_proxy_io_get_interface_description()->concrete_io_create((void*)&default_http_proxy_io_config);
+    (void)http_proxy_io_get_interface_description()->concrete_io_open(http_io, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    g_on_io_open_complete(g_on_io_open_complete_context, IO_OPEN_OK);
+    umock_c_reset_all_calls();
+
+    // act
+    result = http_proxy_io_get_interface_description()->concrete_io_send_array(http_io, TEST_CONSTBUFFER_ARRAY_HANDLE, test_on_send_complete, (void*)0x4247);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_get_interface_description()->concrete_io_destroy(http_io);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_04_002: [ If http_proxy_io_send_array is called when the IO is not open or is in an error state, http_proxy_io_send_array shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(http_proxy_io_send_array_when_IO_is_in_error_fails)
+{
+    // arrange
+    CONCRETE_IO_HANDLE http_io;
+    int result;
+
+    http_io = http_proxy_io_get_interface_description()->concrete_io_create((void*)&default_http_proxy_io_config);
+    (void)http_proxy_io_get_interface_description()->concrete_io_open(http_io, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    g_on_io_open_complete(g_on_io_open_complete_context, IO_OPEN_OK);
+    g_on_bytes_received(g_on_io_open_complete_context, (const unsigned char*)connect_response, sizeof(connect_response) - 1);
+    g_on_io_error(g_on_io_error_context);
+    umock_c_reset_all_calls();
+
+    // act
+    result = http_proxy_io_get_interface_description()->concrete_io_send_array(http_io, TEST_CONSTBUFFER_ARRAY_HANDLE, test_on_send_complete, (void*)0x4247);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_get_interface_description()->concrete_io_destroy(http_io);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_04_004: [ If xio_send_array fails, http_proxy_io_send_array shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_xio_send_array_fails_http_proxy_io_send_array_also_fails)
+{
+    // arrange
+    CONCRETE_IO_HANDLE http_io;
+    int result;
+
+    http_io = http_proxy_io_get_interface_description()->concrete_io_create((void*)&default_http_proxy_io_config);
+    (void)http_proxy_io_get_interface_description()->concrete_io_open(http_io, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    g_on_io_open_complete(g_on_io_open_complete_context, IO_OPEN_OK);
+    g_on_bytes_received(g_on_io_open_complete_context, (const unsigned char*)connect_response, sizeof(connect_response) - 1);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(xio_send_array(TEST_IO_HANDLE, TEST_CONSTBUFFER_ARRAY_HANDLE, NULL, (void*)0x4247))
+        .SetReturn(1);
+
+    // act
+    result = http_proxy_io_get_interface_description()->concrete_io_send_array(http_io, TEST_CONSTBUFFER_ARRAY_HANDLE, NULL, (void*)0x4247);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_get_interface_description()->concrete_io_destroy(http_io);
+}
+
 /* http_proxy_io_dowork */
 
 /* Tests_SRS_HTTP_PROXY_IO_01_037: [ http_proxy_io_dowork shall call xio_dowork on the underlying IO created in http_proxy_io_create. ]*/
@@ -1676,7 +1820,7 @@ TEST_FUNCTION(when_xio_retrieveoptions_fails_then_http_proxy_io_retrieve_options
 
 /* http_proxy_io_get_interface_description */
 
-/* Tests_SRS_HTTP_PROXY_IO_01_049: [ http_proxy_io_get_interface_description shall return a pointer to an IO_INTERFACE_DESCRIPTION structure that contains pointers to the functions: http_proxy_io_retrieve_options, http_proxy_io_retrieve_create, http_proxy_io_destroy, http_proxy_io_open, http_proxy_io_close, http_proxy_io_send and http_proxy_io_dowork. ]*/
+/* Tests_SRS_HTTP_PROXY_IO_01_049: [ http_proxy_io_get_interface_description shall return a pointer to an IO_INTERFACE_DESCRIPTION structure that contains pointers to the functions: http_proxy_io_retrieve_options, http_proxy_io_retrieve_create, http_proxy_io_destroy, http_proxy_io_open, http_proxy_io_close, http_proxy_io_send, http_proxy_io_dowork and http_proxy_io_send_array. ]*/
 TEST_FUNCTION(http_proxy_io_get_interface_description_returns_a_structure_with_non_NULL_members)
 {
     // arrange
@@ -1694,6 +1838,7 @@ TEST_FUNCTION(http_proxy_io_get_interface_description_returns_a_structure_with_n
     ASSERT_IS_NOT_NULL(io_interface->concrete_io_send);
     ASSERT_IS_NOT_NULL(io_interface->concrete_io_setoption);
     ASSERT_IS_NOT_NULL(io_interface->concrete_io_retrieveoptions);
+    ASSERT_IS_NOT_NULL(io_interface->concrete_io_send_array);
 }
 
 /* on_underlying_io_open_complete */
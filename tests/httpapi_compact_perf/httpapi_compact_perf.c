@@ -0,0 +1,275 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "testrunnerswitcher.h"
+
+#include "azure_c_shared_utility/httpapi.h"
+#include "azure_c_shared_utility/httpheaders.h"
+#include "azure_c_shared_utility/buffer_.h"
+#include "azure_c_shared_utility/platform.h"
+#include "azure_c_shared_utility/socketio.h"
+#include "azure_c_shared_utility/tlsio.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/shared_util_options.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#include "perf_measure.h"
+
+/*the sleeping path takes at least a retry interval (100 ms) per request*/
+#define HTTPAPI_COMPACT_PERF_SLEEP_ITERATIONS 10
+#define HTTPAPI_COMPACT_PERF_REACTOR_ITERATIONS 1000
+#define HTTPAPI_COMPACT_PERF_THROUGHPUT_ITERATIONS 10000
+/*time the stub server takes to answer, so that the response is never there when httpapi_compact first looks for it*/
+#define HTTPAPI_COMPACT_PERF_SERVER_TIME_MS 1
+#define HTTPAPI_COMPACT_PERF_HEADER_COUNT 8
+#define HTTPAPI_COMPACT_PERF_CONTENT_SIZE 256
+
+static const char HTTP_RESPONSE[] = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+
+typedef struct REQUEST_CONTEXT_TAG
+{
+    HTTP_HANDLE http_handle;
+    HTTP_HEADERS_HANDLE request_headers;
+    const unsigned char* content;
+    size_t content_size;
+    BUFFER_HANDLE response_content;
+} REQUEST_CONTEXT;
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static IO_INTERFACE_DESCRIPTION g_stub_tlsio_description;
+static int g_server_socket;
+static bool g_refuse_reactor;
+static size_t g_answered_requests;
+static unsigned int g_server_time_ms;
+static size_t g_sends;
+static unsigned char g_content[HTTPAPI_COMPACT_PERF_CONTENT_SIZE];
+
+/*a local HTTP server on the other end of a socket pair, answering each request with HTTP_RESPONSE, the content of the
+  requests has no empty line so each one is answered as soon as its heads are received*/
+static int stub_server(void* context)
+{
+    char request[4096];
+    size_t request_size = 0;
+    ssize_t received;
+    (void)context;
+
+    while ((received = recv(g_server_socket, request + request_size, sizeof(request) - request_size - 1, 0)) > 0)
+    {
+        char* end_of_request;
+
+        request_size += (size_t)received;
+        request[request_size] = '\0';
+        while ((end_of_request = strstr(request, "\r\n\r\n")) != NULL)
+        {
+            size_t consumed = (size_t)(end_of_request + 4 - request);
+            if (g_server_time_ms > 0)
+            {
+                ThreadAPI_Sleep(g_server_time_ms);
+            }
+            if (send(g_server_socket, HTTP_RESPONSE, sizeof(HTTP_RESPONSE) - 1, MSG_NOSIGNAL) != (ssize_t)(sizeof(HTTP_RESPONSE) - 1))
+            {
+                return 1;
+            }
+            g_answered_requests++;
+            request_size -= consumed;
+            (void)memmove(request, request + consumed, request_size + 1);
+        }
+    }
+
+    return 0;
+}
+
+/*httpapi_compact always opens a tlsio, the stub one is a socketio on the client end of the socket pair*/
+static CONCRETE_IO_HANDLE stub_tlsio_create(void* io_create_parameters)
+{
+    int sockets[2];
+    SOCKETIO_CONFIG config;
+    (void)io_create_parameters;
+
+    ASSERT_ARE_EQUAL(int, 0, socketpair(AF_UNIX, SOCK_STREAM, 0, sockets));
+    ASSERT_ARE_NOT_EQUAL(int, -1, fcntl(sockets[0], F_SETFL, fcntl(sockets[0], F_GETFL, 0) | O_NONBLOCK));
+    g_server_socket = sockets[1];
+
+    config.hostname = NULL;
+    config.port = 0;
+    config.accepted_socket = &sockets[0];
+    return socketio_get_interface_description()->concrete_io_create(&config);
+}
+
+static int stub_tlsio_setoption(CONCRETE_IO_HANDLE concrete_io, const char* optionName, const void* value)
+{
+    int result;
+
+    if (g_refuse_reactor && (strcmp(optionName, OPTION_SOCKETIO_REACTOR) == 0))
+    {
+        /*as a tlsio without the option does, httpapi_compact goes back to sleeping between retries*/
+        result = MU_FAILURE;
+    }
+    else
+    {
+        result = socketio_get_interface_description()->concrete_io_setoption(concrete_io, optionName, value);
+    }
+
+    return result;
+}
+
+static int stub_tlsio_send(CONCRETE_IO_HANDLE concrete_io, const void* buffer, size_t size, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    g_sends++;
+    return socketio_get_interface_description()->concrete_io_send(concrete_io, buffer, size, on_send_complete, callback_context);
+}
+
+const IO_INTERFACE_DESCRIPTION* platform_get_default_tlsio(void)
+{
+    return &g_stub_tlsio_description;
+}
+
+static void execute_request(void* context, size_t iteration)
+{
+    REQUEST_CONTEXT* request_context = (REQUEST_CONTEXT*)context;
+    unsigned int status_code = 0;
+    (void)iteration;
+
+    /*httpapi_compact builds the response content in an empty buffer*/
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_unbuild(request_context->response_content));
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, HTTPAPI_ExecuteRequest(request_context->http_handle,
+        (request_context->content != NULL) ? HTTPAPI_REQUEST_POST : HTTPAPI_REQUEST_GET, "/perf",
+        request_context->request_headers, request_context->content, request_context->content_size, &status_code, NULL, request_context->response_content));
+    ASSERT_ARE_EQUAL(int, 200, status_code);
+}
+
+/*returns the transport writes per request*/
+static size_t run_requests(const char* name, size_t iterations, size_t header_count, size_t content_size)
+{
+    REQUEST_CONTEXT request_context;
+    THREAD_HANDLE server_thread;
+    PERF_MEASURE_RESULT result;
+    int server_result;
+    size_t sends;
+    size_t i;
+
+    request_context.http_handle = HTTPAPI_CreateConnection("localhost");
+    ASSERT_IS_NOT_NULL(request_context.http_handle);
+    request_context.request_headers = HTTPHeaders_Alloc();
+    ASSERT_IS_NOT_NULL(request_context.request_headers);
+    for (i = 0; i < header_count; i++)
+    {
+        char name_buffer[32];
+        (void)sprintf(name_buffer, "x-perf-header-%u", (unsigned int)i);
+        ASSERT_ARE_EQUAL(int, HTTP_HEADERS_OK, HTTPHeaders_AddHeaderNameValuePair(request_context.request_headers, name_buffer, "0123456789abcdef0123456789abcdef"));
+    }
+    request_context.content = (content_size > 0) ? g_content : NULL;
+    request_context.content_size = content_size;
+    request_context.response_content = BUFFER_new();
+    ASSERT_IS_NOT_NULL(request_context.response_content);
+    ASSERT_ARE_EQUAL(int, THREADAPI_OK, ThreadAPI_Create(&server_thread, stub_server, NULL));
+
+    /*the first request opens the connection, its response content is released before gballoc starts counting*/
+    execute_request(&request_context, 0);
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_unbuild(request_context.response_content));
+
+    /*on the open connection, a request takes as many writes as it will take in the measure*/
+    sends = g_sends;
+    execute_request(&request_context, 0);
+    sends = g_sends - sends;
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_unbuild(request_context.response_content));
+
+    ///act
+    result = perf_measure_run(name, execute_request, &request_context, iterations);
+
+    /*closing the connection ends the server*/
+    HTTPAPI_CloseConnection(request_context.http_handle);
+    ASSERT_ARE_EQUAL(int, THREADAPI_OK, ThreadAPI_Join(server_thread, &server_result));
+
+    ///assert
+    LogInfo("%s: %.1f us/request, %.0f requests/s, %u writes/request", name, result.ns_per_op / 1000.0, 1000000000.0 / result.ns_per_op, (unsigned int)sends);
+    ASSERT_ARE_EQUAL(int, 0, server_result);
+    ASSERT_IS_TRUE(g_answered_requests > iterations);
+    ASSERT_ARE_EQUAL(size_t, 2, BUFFER_length(request_context.response_content));
+    ASSERT_ARE_EQUAL(int, 0, memcmp("ok", BUFFER_u_char(request_context.response_content), 2));
+
+    ///cleanup
+    BUFFER_delete(request_context.response_content);
+    HTTPHeaders_Free(request_context.request_headers);
+    (void)close(g_server_socket);
+
+    return sends;
+}
+
+BEGIN_TEST_SUITE(httpapi_compact_perf)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    g_stub_tlsio_description = *socketio_get_interface_description();
+    g_stub_tlsio_description.concrete_io_create = stub_tlsio_create;
+    g_stub_tlsio_description.concrete_io_setoption = stub_tlsio_setoption;
+    g_stub_tlsio_description.concrete_io_send = stub_tlsio_send;
+    (void)memset(g_content, 'c', sizeof(g_content));
+
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, HTTPAPI_Init());
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    HTTPAPI_Deinit();
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    g_answered_requests = 0;
+    g_server_time_ms = HTTPAPI_COMPACT_PERF_SERVER_TIME_MS;
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+TEST_FUNCTION(httpapi_compact_request_sleeping_between_retries_perf)
+{
+    g_refuse_reactor = true;
+    (void)run_requests("GET sleeping between retries", HTTPAPI_COMPACT_PERF_SLEEP_ITERATIONS, 0, 0);
+}
+
+TEST_FUNCTION(httpapi_compact_request_waiting_on_socketio_reactor_perf)
+{
+    g_refuse_reactor = false;
+    (void)run_requests("GET waiting on the socketio reactor", HTTPAPI_COMPACT_PERF_REACTOR_ITERATIONS, 0, 0);
+}
+
+TEST_FUNCTION(httpapi_compact_back_to_back_requests_perf)
+{
+    ///arrange
+    size_t writes_per_request;
+    g_refuse_reactor = false;
+    g_server_time_ms = 0;
+
+    ///act
+    writes_per_request = run_requests("POST with 8 headers and 256 bytes of content back to back", HTTPAPI_COMPACT_PERF_THROUGHPUT_ITERATIONS,
+        HTTPAPI_COMPACT_PERF_HEADER_COUNT, HTTPAPI_COMPACT_PERF_CONTENT_SIZE);
+
+    ///assert
+    /*the request line, headers and content go in a single write*/
+    ASSERT_ARE_EQUAL(size_t, 1, writes_per_request);
+}
+
+END_TEST_SUITE(httpapi_compact_perf)
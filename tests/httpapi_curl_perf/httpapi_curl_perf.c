@@ -0,0 +1,489 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include "openssl/ssl.h"
+#include "openssl/evp.h"
+#include "openssl/pem.h"
+#include "openssl/rsa.h"
+#include "openssl/x509.h"
+#include "openssl/x509v3.h"
+
+#include "testrunnerswitcher.h"
+
+#include "azure_c_shared_utility/httpapi.h"
+#include "azure_c_shared_utility/httpapi_async.h"
+#include "azure_c_shared_utility/httpheaders.h"
+#include "azure_c_shared_utility/buffer_.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/shared_util_options.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#include "perf_measure.h"
+
+/*time the stub server takes to answer a request, what a service does before it answers*/
+#define HTTPAPI_CURL_PERF_SERVER_TIME_MS 10
+#define HTTPAPI_CURL_PERF_SEQUENTIAL_ITERATIONS 20
+/*requests given to httpapi_async at once, and how many times*/
+#define HTTPAPI_CURL_PERF_CONCURRENT_REQUESTS 32
+#define HTTPAPI_CURL_PERF_CONCURRENT_ITERATIONS 5
+/*the stub server answers the requests in flight when httpapi_async_destroy is called long after the destroy*/
+#define HTTPAPI_CURL_PERF_SLOW_SERVER_TIME_MS 2000
+#define HTTPAPI_CURL_PERF_MAX_CONNECTIONS 256
+#define HTTPAPI_CURL_PERF_WAIT_MS 10000
+
+static const char HTTP_RESPONSE[] = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+
+typedef struct STUB_CONNECTION_TAG
+{
+    int socket;
+    THREAD_HANDLE thread;
+} STUB_CONNECTION;
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static EVP_PKEY* g_server_key;
+static X509* g_server_certificate;
+static char* g_server_certificate_pem;
+static SSL_CTX* g_server_context;
+static int g_listen_socket;
+static THREAD_HANDLE g_accept_thread;
+static STUB_CONNECTION g_connections[HTTPAPI_CURL_PERF_MAX_CONNECTIONS];
+static size_t g_connection_count;
+static char g_host_name[32];
+static unsigned int g_server_time_ms;
+
+static LOCK_HANDLE g_lock;
+static size_t g_completed_requests;
+static size_t g_failed_requests;
+static HTTPAPI_ASYNC_HANDLE g_destroyed_from_callback;
+
+/*a self signed certificate for localhost, trusted by the client*/
+static void create_server_credentials(void)
+{
+    EVP_PKEY_CTX* key_context = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, NULL);
+    X509_NAME* name;
+    X509_EXTENSION* subject_alt_name;
+    BIO* pem_bio;
+    char* pem;
+    long pem_length;
+
+    ASSERT_IS_NOT_NULL(key_context);
+    ASSERT_ARE_EQUAL(int, 1, EVP_PKEY_keygen_init(key_context));
+    ASSERT_ARE_EQUAL(int, 1, EVP_PKEY_CTX_set_rsa_keygen_bits(key_context, 2048));
+    ASSERT_ARE_EQUAL(int, 1, EVP_PKEY_keygen(key_context, &g_server_key));
+    EVP_PKEY_CTX_free(key_context);
+
+    g_server_certificate = X509_new();
+    ASSERT_IS_NOT_NULL(g_server_certificate);
+    (void)X509_set_version(g_server_certificate, 2);
+    (void)ASN1_INTEGER_set(X509_get_serialNumber(g_server_certificate), 1);
+    (void)X509_gmtime_adj(X509_get_notBefore(g_server_certificate), 0);
+    (void)X509_gmtime_adj(X509_get_notAfter(g_server_certificate), 24 * 60 * 60);
+    ASSERT_ARE_EQUAL(int, 1, X509_set_pubkey(g_server_certificate, g_server_key));
+    name = X509_get_subject_name(g_server_certificate);
+    (void)X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char*)"localhost", -1, -1, 0);
+    ASSERT_ARE_EQUAL(int, 1, X509_set_issuer_name(g_server_certificate, name));
+    subject_alt_name = X509V3_EXT_conf_nid(NULL, NULL, NID_subject_alt_name, "DNS:localhost");
+    ASSERT_IS_NOT_NULL(subject_alt_name);
+    (void)X509_add_ext(g_server_certificate, subject_alt_name, -1);
+    X509_EXTENSION_free(subject_alt_name);
+    ASSERT_IS_TRUE(X509_sign(g_server_certificate, g_server_key, EVP_sha256()) > 0);
+
+    pem_bio = BIO_new(BIO_s_mem());
+    ASSERT_IS_NOT_NULL(pem_bio);
+    ASSERT_ARE_EQUAL(int, 1, PEM_write_bio_X509(pem_bio, g_server_certificate));
+    pem_length = BIO_get_mem_data(pem_bio, &pem);
+    g_server_certificate_pem = (char*)malloc((size_t)pem_length + 1);
+    ASSERT_IS_NOT_NULL(g_server_certificate_pem);
+    (void)memcpy(g_server_certificate_pem, pem, (size_t)pem_length);
+    g_server_certificate_pem[pem_length] = '\0';
+    BIO_free(pem_bio);
+
+    g_server_context = SSL_CTX_new(TLS_server_method());
+    ASSERT_IS_NOT_NULL(g_server_context);
+    ASSERT_ARE_EQUAL(int, 1, SSL_CTX_use_certificate(g_server_context, g_server_certificate));
+    ASSERT_ARE_EQUAL(int, 1, SSL_CTX_use_PrivateKey(g_server_context, g_server_key));
+}
+
+/*answers each request of one connection with HTTP_RESPONSE after g_server_time_ms, until the client closes the connection.
+The requests have no content, so each one ends with its headers*/
+static int stub_connection(void* context)
+{
+    STUB_CONNECTION* connection = (STUB_CONNECTION*)context;
+    SSL* ssl = SSL_new(g_server_context);
+    char request[4096];
+    size_t request_size = 0;
+    int received;
+
+    if ((ssl != NULL) &&
+        (SSL_set_fd(ssl, connection->socket) == 1) &&
+        (SSL_accept(ssl) == 1))
+    {
+        while ((received = SSL_read(ssl, request + request_size, (int)(sizeof(request) - request_size - 1))) > 0)
+        {
+            char* end_of_request;
+
+            request_size += (size_t)received;
+            request[request_size] = '\0';
+            while ((end_of_request = strstr(request, "\r\n\r\n")) != NULL)
+            {
+                size_t consumed = (size_t)(end_of_request + 4 - request);
+                ThreadAPI_Sleep(g_server_time_ms);
+                if (SSL_write(ssl, HTTP_RESPONSE, sizeof(HTTP_RESPONSE) - 1) != (int)(sizeof(HTTP_RESPONSE) - 1))
+                {
+                    break;
+                }
+                request_size -= consumed;
+                (void)memmove(request, request + consumed, request_size + 1);
+            }
+        }
+    }
+
+    SSL_free(ssl);
+    (void)close(connection->socket);
+    return 0;
+}
+
+static int stub_server(void* context)
+{
+    int socket;
+    (void)context;
+
+    /*shutting down the listening socket ends the accept*/
+    while ((socket = accept(g_listen_socket, NULL, NULL)) >= 0)
+    {
+        if (g_connection_count == HTTPAPI_CURL_PERF_MAX_CONNECTIONS)
+        {
+            (void)close(socket);
+        }
+        else
+        {
+            STUB_CONNECTION* connection = &g_connections[g_connection_count];
+            connection->socket = socket;
+            if (ThreadAPI_Create(&connection->thread, stub_connection, connection) != THREADAPI_OK)
+            {
+                (void)close(socket);
+            }
+            else
+            {
+                g_connection_count++;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static void start_server(unsigned int server_time_ms)
+{
+    struct sockaddr_in address;
+    socklen_t address_length = sizeof(address);
+
+    g_server_time_ms = server_time_ms;
+    g_connection_count = 0;
+    g_listen_socket = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_ARE_NOT_EQUAL(int, -1, g_listen_socket);
+    (void)memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    ASSERT_ARE_EQUAL(int, 0, bind(g_listen_socket, (struct sockaddr*)&address, sizeof(address)));
+    ASSERT_ARE_EQUAL(int, 0, listen(g_listen_socket, HTTPAPI_CURL_PERF_MAX_CONNECTIONS));
+    ASSERT_ARE_EQUAL(int, 0, getsockname(g_listen_socket, (struct sockaddr*)&address, &address_length));
+    (void)sprintf(g_host_name, "localhost:%u", (unsigned int)ntohs(address.sin_port));
+    ASSERT_ARE_EQUAL(int, THREADAPI_OK, ThreadAPI_Create(&g_accept_thread, stub_server, NULL));
+}
+
+/*the clients shall be closed first, the connections end when their client closes them*/
+static void stop_server(void)
+{
+    size_t i;
+    int thread_result;
+
+    (void)shutdown(g_listen_socket, SHUT_RDWR);
+    ASSERT_ARE_EQUAL(int, THREADAPI_OK, ThreadAPI_Join(g_accept_thread, &thread_result));
+    (void)close(g_listen_socket);
+    for (i = 0; i < g_connection_count; i++)
+    {
+        ASSERT_ARE_EQUAL(int, THREADAPI_OK, ThreadAPI_Join(g_connections[i].thread, &thread_result));
+    }
+}
+
+static HTTP_HANDLE create_connection(void)
+{
+    HTTP_HANDLE result = HTTPAPI_CreateConnection(g_host_name);
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, HTTPAPI_SetOption(result, OPTION_TRUSTED_CERT, g_server_certificate_pem));
+    return result;
+}
+
+static void on_request_complete(void* context, HTTPAPI_RESULT result, unsigned int status_code, HTTP_HEADERS_HANDLE response_headers, BUFFER_HANDLE response_content)
+{
+    (void)context;
+    (void)response_headers;
+
+    ASSERT_ARE_EQUAL(int, LOCK_OK, Lock(g_lock));
+    if ((result == HTTPAPI_OK) &&
+        (status_code == 200) &&
+        (BUFFER_length(response_content) == 2) &&
+        (memcmp(BUFFER_u_char(response_content), "ok", 2) == 0))
+    {
+        g_completed_requests++;
+    }
+    else
+    {
+        g_failed_requests++;
+    }
+    (void)Unlock(g_lock);
+}
+
+static void on_request_complete_destroy(void* context, HTTPAPI_RESULT result, unsigned int status_code, HTTP_HEADERS_HANDLE response_headers, BUFFER_HANDLE response_content)
+{
+    HTTPAPI_ASYNC_HANDLE httpapi_async = (HTTPAPI_ASYNC_HANDLE)context;
+
+    /*this is on the thread of httpapi_async, which tears httpapi_async down once this returns*/
+    httpapi_async_destroy(httpapi_async);
+
+    on_request_complete(NULL, result, status_code, response_headers, response_content);
+    ASSERT_ARE_EQUAL(int, LOCK_OK, Lock(g_lock));
+    g_destroyed_from_callback = httpapi_async;
+    (void)Unlock(g_lock);
+}
+
+/*waits until the count of completed and failed requests reaches expected_requests*/
+static void wait_for_requests(size_t expected_requests)
+{
+    size_t waited_ms;
+
+    for (waited_ms = 0; waited_ms < HTTPAPI_CURL_PERF_WAIT_MS; waited_ms++)
+    {
+        size_t done_requests;
+        ASSERT_ARE_EQUAL(int, LOCK_OK, Lock(g_lock));
+        done_requests = g_completed_requests + g_failed_requests;
+        (void)Unlock(g_lock);
+        if (done_requests >= expected_requests)
+        {
+            break;
+        }
+        ThreadAPI_Sleep(1);
+    }
+}
+
+typedef struct SEQUENTIAL_CONTEXT_TAG
+{
+    HTTP_HANDLE http_handle;
+    HTTP_HEADERS_HANDLE request_headers;
+    BUFFER_HANDLE response_content;
+} SEQUENTIAL_CONTEXT;
+
+static void execute_request(void* context, size_t iteration)
+{
+    SEQUENTIAL_CONTEXT* sequential_context = (SEQUENTIAL_CONTEXT*)context;
+    unsigned int status_code = 0;
+    (void)iteration;
+
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_unbuild(sequential_context->response_content));
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, HTTPAPI_ExecuteRequest(sequential_context->http_handle, HTTPAPI_REQUEST_GET, "/perf",
+        sequential_context->request_headers, NULL, 0, &status_code, NULL, sequential_context->response_content));
+    ASSERT_ARE_EQUAL(int, 200, status_code);
+}
+
+typedef struct CONCURRENT_CONTEXT_TAG
+{
+    HTTPAPI_ASYNC_HANDLE httpapi_async;
+    HTTP_HANDLE http_handle;
+    HTTP_HEADERS_HANDLE request_headers;
+} CONCURRENT_CONTEXT;
+
+/*gives HTTPAPI_CURL_PERF_CONCURRENT_REQUESTS requests to httpapi_async and waits for all of them*/
+static void execute_concurrent_requests(void* context, size_t iteration)
+{
+    CONCURRENT_CONTEXT* concurrent_context = (CONCURRENT_CONTEXT*)context;
+    size_t i;
+    (void)iteration;
+
+    g_completed_requests = 0;
+    g_failed_requests = 0;
+    for (i = 0; i < HTTPAPI_CURL_PERF_CONCURRENT_REQUESTS; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, httpapi_async_execute_request(concurrent_context->httpapi_async, concurrent_context->http_handle, HTTPAPI_REQUEST_GET, "/perf",
+            concurrent_context->request_headers, NULL, on_request_complete, NULL));
+    }
+
+    wait_for_requests(HTTPAPI_CURL_PERF_CONCURRENT_REQUESTS);
+    ASSERT_ARE_EQUAL(size_t, HTTPAPI_CURL_PERF_CONCURRENT_REQUESTS, g_completed_requests);
+}
+
+BEGIN_TEST_SUITE(httpapi_curl_perf)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    g_lock = Lock_Init();
+    ASSERT_IS_NOT_NULL(g_lock);
+    create_server_credentials();
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, HTTPAPI_Init());
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    HTTPAPI_Deinit();
+    SSL_CTX_free(g_server_context);
+    X509_free(g_server_certificate);
+    EVP_PKEY_free(g_server_key);
+    free(g_server_certificate_pem);
+    (void)Lock_Deinit(g_lock);
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    g_completed_requests = 0;
+    g_failed_requests = 0;
+    g_destroyed_from_callback = NULL;
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+TEST_FUNCTION(httpapi_curl_sequential_requests_perf)
+{
+    ///arrange
+    SEQUENTIAL_CONTEXT sequential_context;
+    PERF_MEASURE_RESULT result;
+    start_server(HTTPAPI_CURL_PERF_SERVER_TIME_MS);
+    sequential_context.http_handle = create_connection();
+    sequential_context.request_headers = HTTPHeaders_Alloc();
+    ASSERT_IS_NOT_NULL(sequential_context.request_headers);
+    sequential_context.response_content = BUFFER_new();
+    ASSERT_IS_NOT_NULL(sequential_context.response_content);
+
+    ///act
+    result = perf_measure_run("HTTPAPI_ExecuteRequest one after the other", execute_request, &sequential_context, HTTPAPI_CURL_PERF_SEQUENTIAL_ITERATIONS);
+
+    ///assert
+    LogInfo("HTTPAPI_ExecuteRequest one after the other: %.1f ms/request with a server taking %u ms", result.ns_per_op / 1000000.0, HTTPAPI_CURL_PERF_SERVER_TIME_MS);
+    ASSERT_ARE_EQUAL(size_t, 2, BUFFER_length(sequential_context.response_content));
+    ASSERT_ARE_EQUAL(int, 0, memcmp("ok", BUFFER_u_char(sequential_context.response_content), 2));
+
+    ///cleanup
+    BUFFER_delete(sequential_context.response_content);
+    HTTPHeaders_Free(sequential_context.request_headers);
+    HTTPAPI_CloseConnection(sequential_context.http_handle);
+    stop_server();
+}
+
+TEST_FUNCTION(httpapi_async_concurrent_requests_perf)
+{
+    ///arrange
+    CONCURRENT_CONTEXT concurrent_context;
+    PERF_MEASURE_RESULT result;
+    double ms_per_request;
+    start_server(HTTPAPI_CURL_PERF_SERVER_TIME_MS);
+    concurrent_context.http_handle = create_connection();
+    concurrent_context.request_headers = HTTPHeaders_Alloc();
+    ASSERT_IS_NOT_NULL(concurrent_context.request_headers);
+    concurrent_context.httpapi_async = httpapi_async_create();
+    ASSERT_IS_NOT_NULL(concurrent_context.httpapi_async);
+
+    ///act
+    result = perf_measure_run("httpapi_async_execute_request, requests at once", execute_concurrent_requests, &concurrent_context, HTTPAPI_CURL_PERF_CONCURRENT_ITERATIONS);
+
+    ///assert
+    ms_per_request = result.ns_per_op / 1000000.0 / HTTPAPI_CURL_PERF_CONCURRENT_REQUESTS;
+    LogInfo("httpapi_async_execute_request, %u requests at once: %.2f ms/request with a server taking %u ms", HTTPAPI_CURL_PERF_CONCURRENT_REQUESTS, ms_per_request, HTTPAPI_CURL_PERF_SERVER_TIME_MS);
+    /*the requests wait for the server at the same time, one after the other each one would take at least the server time*/
+    ASSERT_IS_TRUE(ms_per_request < HTTPAPI_CURL_PERF_SERVER_TIME_MS);
+
+    ///cleanup
+    httpapi_async_destroy(concurrent_context.httpapi_async);
+    HTTPHeaders_Free(concurrent_context.request_headers);
+    HTTPAPI_CloseConnection(concurrent_context.http_handle);
+    stop_server();
+}
+
+TEST_FUNCTION(httpapi_async_destroy_completes_the_requests_in_flight_with_HTTPAPI_ERROR)
+{
+    ///arrange
+    HTTPAPI_ASYNC_HANDLE httpapi_async;
+    HTTP_HANDLE http_handle;
+    HTTP_HEADERS_HANDLE request_headers;
+    size_t i;
+    start_server(HTTPAPI_CURL_PERF_SLOW_SERVER_TIME_MS);
+    http_handle = create_connection();
+    request_headers = HTTPHeaders_Alloc();
+    ASSERT_IS_NOT_NULL(request_headers);
+    httpapi_async = httpapi_async_create();
+    ASSERT_IS_NOT_NULL(httpapi_async);
+    for (i = 0; i < HTTPAPI_CURL_PERF_CONCURRENT_REQUESTS; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, httpapi_async_execute_request(httpapi_async, http_handle, HTTPAPI_REQUEST_GET, "/perf", request_headers, NULL, on_request_complete, NULL));
+    }
+
+    ///act
+    httpapi_async_destroy(httpapi_async);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 0, g_completed_requests);
+    ASSERT_ARE_EQUAL(size_t, HTTPAPI_CURL_PERF_CONCURRENT_REQUESTS, g_failed_requests);
+
+    ///cleanup
+    HTTPHeaders_Free(request_headers);
+    HTTPAPI_CloseConnection(http_handle);
+    stop_server();
+}
+
+TEST_FUNCTION(httpapi_async_destroy_from_on_request_complete_destroys_httpapi_async_after_the_callback)
+{
+    ///arrange
+    HTTPAPI_ASYNC_HANDLE httpapi_async;
+    HTTPAPI_ASYNC_HANDLE next_httpapi_async;
+    HTTP_HANDLE http_handle;
+    HTTP_HEADERS_HANDLE request_headers;
+    start_server(0);
+    http_handle = create_connection();
+    request_headers = HTTPHeaders_Alloc();
+    ASSERT_IS_NOT_NULL(request_headers);
+    httpapi_async = httpapi_async_create();
+    ASSERT_IS_NOT_NULL(httpapi_async);
+
+    ///act
+    ASSERT_ARE_EQUAL(int, 0, httpapi_async_execute_request(httpapi_async, http_handle, HTTPAPI_REQUEST_GET, "/perf", request_headers, NULL, on_request_complete_destroy, httpapi_async));
+    wait_for_requests(1);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 1, g_completed_requests);
+    ASSERT_IS_TRUE(g_destroyed_from_callback == httpapi_async);
+    /*joins the thread of the destroyed httpapi_async, which is not used anymore*/
+    next_httpapi_async = httpapi_async_create();
+    ASSERT_IS_NOT_NULL(next_httpapi_async);
+
+    ///cleanup
+    httpapi_async_destroy(next_httpapi_async);
+    HTTPHeaders_Free(request_headers);
+    HTTPAPI_CloseConnection(http_handle);
+    stop_server();
+}
+
+END_TEST_SUITE(httpapi_curl_perf)
@@ -0,0 +1,603 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+
+/*the curl functions below replace libcurl, they are called with their declared types*/
+#define CURL_DISABLE_TYPECHECK
+#include "curl/curl.h"
+
+#include "testrunnerswitcher.h"
+
+#include "azure_c_shared_utility/httpapi.h"
+#include "azure_c_shared_utility/httpapi_async.h"
+#include "azure_c_shared_utility/httpheaders.h"
+#include "azure_c_shared_utility/buffer_.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/threadapi.h"
+
+#define HTTPAPI_CURL_UT_MAX_TRANSFERS 8
+#define HTTPAPI_CURL_UT_WAIT_TIMEOUT_MS 10000
+#define HTTPAPI_CURL_UT_CONTENT "ok"
+#define HTTPAPI_CURL_UT_HEADER_VALUE "text/plain"
+
+/*A fake curl: the easy handles keep the options httpapi_curl sets, the multi handle "transfers" the handles added to it
+when the test lets it (g_transfers_to_complete) by calling their header and write callbacks and answering 200.
+All of it runs on the thread of httpapi_async, except for what the test reads under g_lock.*/
+typedef struct FAKE_CURL_TAG
+{
+    curl_write_callback header_function;
+    void* header_data;
+    curl_write_callback write_function;
+    void* write_data;
+    void* private_data;
+} FAKE_CURL;
+
+typedef struct FAKE_CURLM_TAG
+{
+    FAKE_CURL* added[HTTPAPI_CURL_UT_MAX_TRANSFERS];
+    size_t added_count;
+    CURLMsg done[HTTPAPI_CURL_UT_MAX_TRANSFERS];
+    size_t done_count;
+} FAKE_CURLM;
+
+typedef struct COMPLETED_REQUEST_TAG
+{
+    void* context;
+    HTTPAPI_RESULT result;
+    unsigned int status_code;
+    bool has_expected_header;
+    bool has_expected_content;
+} COMPLETED_REQUEST;
+
+static TEST_MUTEX_HANDLE g_testByTest;
+/*guards what the thread of httpapi_async and the test share*/
+static LOCK_HANDLE g_lock;
+static size_t g_transfers_to_complete;
+static size_t g_transfers_in_multi;
+static size_t g_multi_cleanups;
+static COMPLETED_REQUEST g_completed_requests[HTTPAPI_CURL_UT_MAX_TRANSFERS];
+static size_t g_completed_request_count;
+
+CURLcode curl_global_init(long flags)
+{
+    (void)flags;
+    return CURLE_OK;
+}
+
+void curl_global_cleanup(void)
+{
+}
+
+CURL* curl_easy_init(void)
+{
+    return (CURL*)calloc(1, sizeof(FAKE_CURL));
+}
+
+CURL* curl_easy_duphandle(CURL* curl)
+{
+    FAKE_CURL* result = (FAKE_CURL*)malloc(sizeof(FAKE_CURL));
+    if (result != NULL)
+    {
+        *result = *(FAKE_CURL*)curl;
+    }
+    return (CURL*)result;
+}
+
+void curl_easy_cleanup(CURL* curl)
+{
+    free(curl);
+}
+
+CURLcode curl_easy_setopt(CURL* curl, CURLoption option, ...)
+{
+    FAKE_CURL* fake_curl = (FAKE_CURL*)curl;
+    va_list args;
+
+    va_start(args, option);
+    switch (option)
+    {
+        case CURLOPT_HEADERFUNCTION:
+            fake_curl->header_function = va_arg(args, curl_write_callback);
+            break;
+        case CURLOPT_HEADERDATA:
+            fake_curl->header_data = va_arg(args, void*);
+            break;
+        case CURLOPT_WRITEFUNCTION:
+            fake_curl->write_function = va_arg(args, curl_write_callback);
+            break;
+        case CURLOPT_WRITEDATA:
+            fake_curl->write_data = va_arg(args, void*);
+            break;
+        case CURLOPT_PRIVATE:
+            fake_curl->private_data = va_arg(args, void*);
+            break;
+        default:
+            /*the other options are taken as they come*/
+            break;
+    }
+    va_end(args);
+
+    return CURLE_OK;
+}
+
+CURLcode curl_easy_getinfo(CURL* curl, CURLINFO info, ...)
+{
+    static const struct curl_tlssessioninfo tls_session_info = { CURLSSLBACKEND_OPENSSL, NULL };
+    FAKE_CURL* fake_curl = (FAKE_CURL*)curl;
+    CURLcode result = CURLE_OK;
+    va_list args;
+
+    va_start(args, info);
+    switch (info)
+    {
+        case CURLINFO_PRIVATE:
+            *va_arg(args, void**) = fake_curl->private_data;
+            break;
+        case CURLINFO_RESPONSE_CODE:
+            *va_arg(args, long*) = 200;
+            break;
+        case CURLINFO_TLS_SSL_PTR:
+            *va_arg(args, const struct curl_tlssessioninfo**) = &tls_session_info;
+            break;
+        default:
+            result = CURLE_UNKNOWN_OPTION;
+            break;
+    }
+    va_end(args);
+
+    return result;
+}
+
+CURLcode curl_easy_perform(CURL* curl)
+{
+    (void)curl;
+    return CURLE_COULDNT_CONNECT;
+}
+
+const char* curl_easy_strerror(CURLcode error)
+{
+    (void)error;
+    return "fake curl error";
+}
+
+struct curl_slist* curl_slist_append(struct curl_slist* list, const char* data)
+{
+    struct curl_slist* result;
+    struct curl_slist* item = (struct curl_slist*)malloc(sizeof(struct curl_slist));
+    if (item == NULL)
+    {
+        result = NULL;
+    }
+    else if ((item->data = (char*)malloc(strlen(data) + 1)) == NULL)
+    {
+        free(item);
+        result = NULL;
+    }
+    else
+    {
+        (void)strcpy(item->data, data);
+        item->next = NULL;
+        if (list == NULL)
+        {
+            result = item;
+        }
+        else
+        {
+            struct curl_slist* last = list;
+            while (last->next != NULL)
+            {
+                last = last->next;
+            }
+            last->next = item;
+            result = list;
+        }
+    }
+    return result;
+}
+
+void curl_slist_free_all(struct curl_slist* list)
+{
+    while (list != NULL)
+    {
+        struct curl_slist* next = list->next;
+        free(list->data);
+        free(list);
+        list = next;
+    }
+}
+
+CURLM* curl_multi_init(void)
+{
+    return (CURLM*)calloc(1, sizeof(FAKE_CURLM));
+}
+
+CURLMcode curl_multi_cleanup(CURLM* multi_handle)
+{
+    free(multi_handle);
+    ASSERT_ARE_EQUAL(int, LOCK_OK, Lock(g_lock));
+    g_multi_cleanups++;
+    (void)Unlock(g_lock);
+    return CURLM_OK;
+}
+
+CURLMcode curl_multi_add_handle(CURLM* multi_handle, CURL* curl_handle)
+{
+    FAKE_CURLM* multi = (FAKE_CURLM*)multi_handle;
+    CURLMcode result;
+
+    if (multi->added_count == HTTPAPI_CURL_UT_MAX_TRANSFERS)
+    {
+        result = CURLM_OUT_OF_MEMORY;
+    }
+    else
+    {
+        multi->added[multi->added_count++] = (FAKE_CURL*)curl_handle;
+        ASSERT_ARE_EQUAL(int, LOCK_OK, Lock(g_lock));
+        g_transfers_in_multi++;
+        (void)Unlock(g_lock);
+        result = CURLM_OK;
+    }
+    return result;
+}
+
+CURLMcode curl_multi_remove_handle(CURLM* multi_handle, CURL* curl_handle)
+{
+    FAKE_CURLM* multi = (FAKE_CURLM*)multi_handle;
+    size_t i;
+
+    for (i = 0; i < multi->added_count; i++)
+    {
+        if (multi->added[i] == (FAKE_CURL*)curl_handle)
+        {
+            (void)memmove(&multi->added[i], &multi->added[i + 1], (multi->added_count - i - 1) * sizeof(multi->added[0]));
+            multi->added_count--;
+            ASSERT_ARE_EQUAL(int, LOCK_OK, Lock(g_lock));
+            g_transfers_in_multi--;
+            (void)Unlock(g_lock);
+            break;
+        }
+    }
+    return CURLM_OK;
+}
+
+/*"transfers" the oldest added handles, as many as the test lets through*/
+CURLMcode curl_multi_perform(CURLM* multi_handle, int* running_handles)
+{
+    FAKE_CURLM* multi = (FAKE_CURLM*)multi_handle;
+    size_t i;
+
+    for (i = multi->done_count; i < multi->added_count; i++)
+    {
+        FAKE_CURL* fake_curl = multi->added[i];
+        bool can_complete;
+        char status_line[] = "HTTP/1.1 200 OK\r\n";
+        char header_line[] = "Content-Type: " HTTPAPI_CURL_UT_HEADER_VALUE "\r\n";
+        char content[] = HTTPAPI_CURL_UT_CONTENT;
+
+        ASSERT_ARE_EQUAL(int, LOCK_OK, Lock(g_lock));
+        can_complete = (g_transfers_to_complete > 0);
+        if (can_complete)
+        {
+            g_transfers_to_complete--;
+        }
+        (void)Unlock(g_lock);
+
+        if (!can_complete)
+        {
+            break;
+        }
+
+        (void)fake_curl->header_function(status_line, 1, sizeof(status_line) - 1, fake_curl->header_data);
+        (void)fake_curl->header_function(header_line, 1, sizeof(header_line) - 1, fake_curl->header_data);
+        (void)fake_curl->write_function(content, 1, sizeof(content) - 1, fake_curl->write_data);
+
+        multi->done[multi->done_count].msg = CURLMSG_DONE;
+        multi->done[multi->done_count].easy_handle = (CURL*)fake_curl;
+        multi->done[multi->done_count].data.result = CURLE_OK;
+        multi->done_count++;
+    }
+
+    *running_handles = (int)(multi->added_count - multi->done_count);
+    return CURLM_OK;
+}
+
+/*the done handles are the first ones added, they leave the multi handle with curl_multi_remove_handle*/
+CURLMsg* curl_multi_info_read(CURLM* multi_handle, int* msgs_in_queue)
+{
+    static CURLMsg message;
+    FAKE_CURLM* multi = (FAKE_CURLM*)multi_handle;
+    CURLMsg* result;
+
+    if (multi->done_count == 0)
+    {
+        result = NULL;
+    }
+    else
+    {
+        message = multi->done[0];
+        (void)memmove(&multi->done[0], &multi->done[1], (multi->done_count - 1) * sizeof(multi->done[0]));
+        multi->done_count--;
+        result = &message;
+    }
+
+    *msgs_in_queue = (int)multi->done_count;
+    return result;
+}
+
+CURLMcode curl_multi_wait(CURLM* multi_handle, struct curl_waitfd extra_fds[], unsigned int extra_nfds, int timeout_ms, int* ret)
+{
+    (void)multi_handle;
+    (void)extra_fds;
+    (void)extra_nfds;
+    (void)timeout_ms;
+    (void)ret;
+    ThreadAPI_Sleep(1);
+    return CURLM_OK;
+}
+
+#if LIBCURL_VERSION_NUM >= 0x074400
+CURLMcode curl_multi_poll(CURLM* multi_handle, struct curl_waitfd extra_fds[], unsigned int extra_nfds, int timeout_ms, int* ret)
+{
+    return curl_multi_wait(multi_handle, extra_fds, extra_nfds, timeout_ms, ret);
+}
+
+CURLMcode curl_multi_wakeup(CURLM* multi_handle)
+{
+    (void)multi_handle;
+    return CURLM_OK;
+}
+#endif
+
+static void let_transfers_complete(size_t count)
+{
+    ASSERT_ARE_EQUAL(int, LOCK_OK, Lock(g_lock));
+    g_transfers_to_complete += count;
+    (void)Unlock(g_lock);
+}
+
+static void on_request_complete(void* context, HTTPAPI_RESULT result, unsigned int status_code, HTTP_HEADERS_HANDLE response_headers, BUFFER_HANDLE response_content)
+{
+    ASSERT_ARE_EQUAL(int, LOCK_OK, Lock(g_lock));
+    ASSERT_IS_TRUE(g_completed_request_count < HTTPAPI_CURL_UT_MAX_TRANSFERS);
+    g_completed_requests[g_completed_request_count].context = context;
+    g_completed_requests[g_completed_request_count].result = result;
+    g_completed_requests[g_completed_request_count].status_code = status_code;
+    if (result == HTTPAPI_OK)
+    {
+        const char* header_value = HTTPHeaders_FindHeaderValue(response_headers, "Content-Type");
+        g_completed_requests[g_completed_request_count].has_expected_header = (header_value != NULL) && (strcmp(header_value, HTTPAPI_CURL_UT_HEADER_VALUE) == 0);
+        g_completed_requests[g_completed_request_count].has_expected_content =
+            (BUFFER_length(response_content) == strlen(HTTPAPI_CURL_UT_CONTENT)) &&
+            (memcmp(BUFFER_u_char(response_content), HTTPAPI_CURL_UT_CONTENT, strlen(HTTPAPI_CURL_UT_CONTENT)) == 0);
+    }
+    g_completed_request_count++;
+    (void)Unlock(g_lock);
+}
+
+static void on_request_complete_destroy(void* context, HTTPAPI_RESULT result, unsigned int status_code, HTTP_HEADERS_HANDLE response_headers, BUFFER_HANDLE response_content)
+{
+    /*this is on the thread of httpapi_async, which tears httpapi_async down once this returns*/
+    httpapi_async_destroy((HTTPAPI_ASYNC_HANDLE)context);
+
+    on_request_complete(context, result, status_code, response_headers, response_content);
+}
+
+/*waits until *counter reaches expected, counter is guarded by g_lock*/
+static void wait_for_count(const size_t* counter, size_t expected)
+{
+    size_t waited_ms;
+    size_t count = 0;
+
+    for (waited_ms = 0; waited_ms < HTTPAPI_CURL_UT_WAIT_TIMEOUT_MS; waited_ms++)
+    {
+        ASSERT_ARE_EQUAL(int, LOCK_OK, Lock(g_lock));
+        count = *counter;
+        (void)Unlock(g_lock);
+
+        if (count >= expected)
+        {
+            break;
+        }
+        ThreadAPI_Sleep(1);
+    }
+
+    ASSERT_ARE_EQUAL(size_t, expected, count);
+}
+
+BEGIN_TEST_SUITE(httpapi_curl_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    g_lock = Lock_Init();
+    ASSERT_IS_NOT_NULL(g_lock);
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, HTTPAPI_Init());
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    HTTPAPI_Deinit();
+    (void)Lock_Deinit(g_lock);
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    g_transfers_to_complete = 0;
+    g_transfers_in_multi = 0;
+    g_multi_cleanups = 0;
+    g_completed_request_count = 0;
+    (void)memset(g_completed_requests, 0, sizeof(g_completed_requests));
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* httpapi_async_execute_request */
+
+TEST_FUNCTION(httpapi_async_execute_request_completes_with_the_status_code_headers_and_content)
+{
+    ///arrange
+    HTTPAPI_ASYNC_HANDLE httpapi_async;
+    HTTP_HANDLE http_handle = HTTPAPI_CreateConnection("localhost");
+    HTTP_HEADERS_HANDLE request_headers = HTTPHeaders_Alloc();
+    ASSERT_IS_NOT_NULL(http_handle);
+    ASSERT_IS_NOT_NULL(request_headers);
+    httpapi_async = httpapi_async_create();
+    ASSERT_IS_NOT_NULL(httpapi_async);
+    let_transfers_complete(1);
+
+    ///act
+    ASSERT_ARE_EQUAL(int, 0, httpapi_async_execute_request(httpapi_async, http_handle, HTTPAPI_REQUEST_GET, "/ut", request_headers, NULL, on_request_complete, (void*)0x42));
+    wait_for_count(&g_completed_request_count, 1);
+
+    ///assert
+    ASSERT_IS_TRUE(g_completed_requests[0].context == (void*)0x42);
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, g_completed_requests[0].result);
+    ASSERT_ARE_EQUAL(int, 200, g_completed_requests[0].status_code);
+    ASSERT_IS_TRUE(g_completed_requests[0].has_expected_header);
+    ASSERT_IS_TRUE(g_completed_requests[0].has_expected_content);
+
+    ///cleanup
+    httpapi_async_destroy(httpapi_async);
+    HTTPHeaders_Free(request_headers);
+    HTTPAPI_CloseConnection(http_handle);
+}
+
+TEST_FUNCTION(httpapi_async_execute_request_with_NULL_on_request_complete_fails)
+{
+    ///arrange
+    HTTPAPI_ASYNC_HANDLE httpapi_async;
+    HTTP_HANDLE http_handle = HTTPAPI_CreateConnection("localhost");
+    HTTP_HEADERS_HANDLE request_headers = HTTPHeaders_Alloc();
+    int result;
+    ASSERT_IS_NOT_NULL(http_handle);
+    ASSERT_IS_NOT_NULL(request_headers);
+    httpapi_async = httpapi_async_create();
+    ASSERT_IS_NOT_NULL(httpapi_async);
+
+    ///act
+    result = httpapi_async_execute_request(httpapi_async, http_handle, HTTPAPI_REQUEST_GET, "/ut", request_headers, NULL, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    ///cleanup
+    httpapi_async_destroy(httpapi_async);
+    HTTPHeaders_Free(request_headers);
+    HTTPAPI_CloseConnection(http_handle);
+}
+
+/* httpapi_async_destroy */
+
+TEST_FUNCTION(httpapi_async_destroy_completes_the_requests_in_flight_with_HTTPAPI_ERROR)
+{
+    ///arrange
+    HTTPAPI_ASYNC_HANDLE httpapi_async;
+    HTTP_HANDLE http_handle = HTTPAPI_CreateConnection("localhost");
+    HTTP_HEADERS_HANDLE request_headers = HTTPHeaders_Alloc();
+    ASSERT_IS_NOT_NULL(http_handle);
+    ASSERT_IS_NOT_NULL(request_headers);
+    httpapi_async = httpapi_async_create();
+    ASSERT_IS_NOT_NULL(httpapi_async);
+    ASSERT_ARE_EQUAL(int, 0, httpapi_async_execute_request(httpapi_async, http_handle, HTTPAPI_REQUEST_GET, "/ut", request_headers, NULL, on_request_complete, NULL));
+    ASSERT_ARE_EQUAL(int, 0, httpapi_async_execute_request(httpapi_async, http_handle, HTTPAPI_REQUEST_GET, "/ut", request_headers, NULL, on_request_complete, NULL));
+    /*both given to curl, which does not complete them*/
+    wait_for_count(&g_transfers_in_multi, 2);
+
+    ///act
+    httpapi_async_destroy(httpapi_async);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 2, g_completed_request_count);
+    ASSERT_ARE_EQUAL(int, HTTPAPI_ERROR, g_completed_requests[0].result);
+    ASSERT_ARE_EQUAL(int, HTTPAPI_ERROR, g_completed_requests[1].result);
+    ASSERT_ARE_EQUAL(size_t, 0, g_transfers_in_multi);
+    ASSERT_ARE_EQUAL(size_t, 1, g_multi_cleanups);
+
+    ///cleanup
+    HTTPHeaders_Free(request_headers);
+    HTTPAPI_CloseConnection(http_handle);
+}
+
+TEST_FUNCTION(httpapi_async_destroy_from_on_request_complete_completes_the_other_requests_with_HTTPAPI_ERROR)
+{
+    ///arrange
+    HTTPAPI_ASYNC_HANDLE httpapi_async;
+    HTTP_HANDLE http_handle = HTTPAPI_CreateConnection("localhost");
+    HTTP_HEADERS_HANDLE request_headers = HTTPHeaders_Alloc();
+    ASSERT_IS_NOT_NULL(http_handle);
+    ASSERT_IS_NOT_NULL(request_headers);
+    httpapi_async = httpapi_async_create();
+    ASSERT_IS_NOT_NULL(httpapi_async);
+    ASSERT_ARE_EQUAL(int, 0, httpapi_async_execute_request(httpapi_async, http_handle, HTTPAPI_REQUEST_GET, "/ut", request_headers, NULL, on_request_complete_destroy, httpapi_async));
+    ASSERT_ARE_EQUAL(int, 0, httpapi_async_execute_request(httpapi_async, http_handle, HTTPAPI_REQUEST_GET, "/ut", request_headers, NULL, on_request_complete, NULL));
+    wait_for_count(&g_transfers_in_multi, 2);
+
+    ///act
+    /*only the first one, its on_request_complete destroys httpapi_async*/
+    let_transfers_complete(1);
+    wait_for_count(&g_completed_request_count, 2);
+
+    ///assert
+    ASSERT_IS_TRUE(g_completed_requests[0].context == httpapi_async);
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, g_completed_requests[0].result);
+    ASSERT_IS_NULL(g_completed_requests[1].context);
+    ASSERT_ARE_EQUAL(int, HTTPAPI_ERROR, g_completed_requests[1].result);
+    /*the thread tore httpapi_async down*/
+    wait_for_count(&g_multi_cleanups, 1);
+    ASSERT_ARE_EQUAL(size_t, 0, g_transfers_in_multi);
+
+    ///cleanup
+    HTTPHeaders_Free(request_headers);
+    HTTPAPI_CloseConnection(http_handle);
+    /*joins the thread of httpapi_async*/
+    HTTPAPI_Deinit();
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, HTTPAPI_Init());
+}
+
+TEST_FUNCTION(httpapi_async_create_after_a_destroy_from_on_request_complete_succeeds)
+{
+    ///arrange
+    HTTPAPI_ASYNC_HANDLE httpapi_async;
+    HTTPAPI_ASYNC_HANDLE next_httpapi_async;
+    HTTP_HANDLE http_handle = HTTPAPI_CreateConnection("localhost");
+    HTTP_HEADERS_HANDLE request_headers = HTTPHeaders_Alloc();
+    ASSERT_IS_NOT_NULL(http_handle);
+    ASSERT_IS_NOT_NULL(request_headers);
+    httpapi_async = httpapi_async_create();
+    ASSERT_IS_NOT_NULL(httpapi_async);
+    let_transfers_complete(1);
+    ASSERT_ARE_EQUAL(int, 0, httpapi_async_execute_request(httpapi_async, http_handle, HTTPAPI_REQUEST_GET, "/ut", request_headers, NULL, on_request_complete_destroy, httpapi_async));
+    wait_for_count(&g_multi_cleanups, 1);
+
+    ///act
+    /*joins the thread of the destroyed httpapi_async*/
+    next_httpapi_async = httpapi_async_create();
+
+    ///assert
+    ASSERT_IS_NOT_NULL(next_httpapi_async);
+    ASSERT_ARE_EQUAL(size_t, 1, g_completed_request_count);
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, g_completed_requests[0].result);
+
+    ///cleanup
+    httpapi_async_destroy(next_httpapi_async);
+    HTTPHeaders_Free(request_headers);
+    HTTPAPI_CloseConnection(http_handle);
+}
+
+END_TEST_SUITE(httpapi_curl_ut)
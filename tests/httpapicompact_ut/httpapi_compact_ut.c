@@ -75,10 +75,16 @@ int my_mallocAndStrcpy_s(char** destination, const char* source)
 #define TEST_EXECUTE_REQUEST_RELATIVE_PATH (const char*)"/devices/Huzzah_w_DHT22/messages/events?api-version=2016-11-14"
 #define TEST_EXECUTE_REQUEST_CONTENT (const unsigned char*)"{\"ObjectType\":\"DeviceInfo\", \"Version\":\"1.0\", \"IsSimulatedDevice\":false, \"DeviceProperties\":{\"DeviceID\":\"Huzzah_w_DHT22\", \"HubEnabledState\":true}, \"Commands\":[{ \"Name\":\"SetHumidity\", \"Parameters\":[{\"Name\":\"humidity\",\"Type\":\"int\"}]},{ \"Name\":\"SetTemperature\", \"Parameters\":[{\"Name\":\"temperature\",\"Type\":\"int\"}]}]}"
 #define TEST_EXECUTE_REQUEST_CONTENT_LENGTH (size_t)320
+/*HTTPAPI_COMPACT_REQUEST_BUFFER_SIZE, the heads and content of a request that fit in it are sent at once*/
+#define TEST_REQUEST_BUFFER_SIZE 1024
+/*with the 15 bytes of "GET " and " HTTP/1.1\r\n" the request line leaves no room in the request buffer for a header*/
+#define TEST_LONG_RELATIVE_PATH_LENGTH 1000
 #define TEST_SETOPTIONS_CERTIFICATE    (const unsigned char*)"blah!blah!blah!"
 #define TEST_SETOPTIONS_X509CLIENTCERT    (const unsigned char*)"ADMITONE"
 #define TEST_SETOPTIONS_X509PRIVATEKEY    (const unsigned char*)"SPEAKFRIENDANDENTER"
 #define TEST_GET_HEADER_HEAD_COUNT (size_t)2
+#define TEST_SOCKETIO_REACTOR (SOCKETIO_REACTOR_HANDLE)0x4242
+#define TEST_TICK_COUNTER (TICK_COUNTER_HANDLE)0x4243
 
 
 #define ENABLE_MOCKS
@@ -91,6 +97,8 @@ int my_mallocAndStrcpy_s(char** destination, const char* source)
 #include "azure_c_shared_utility/platform.h"
 #include "azure_c_shared_utility/buffer_.h"
 #include "azure_c_shared_utility/http_proxy_io.h"
+#include "azure_c_shared_utility/socketio.h"
+#include "azure_c_shared_utility/tickcounter.h"
 #undef ENABLE_MOCKS
 #include "azure_c_shared_utility/httpapi.h"
 #include "azure_c_shared_utility/shared_util_options.h"
@@ -139,7 +147,8 @@ static int xio_open_shallReturn;
 static int xio_close_shallReturn;
 static const int* xio_send_shallReturn;
 static int xio_send_shallReturn_counter;
-static char xio_send_transmited_buffer[1024];
+static char xio_send_transmited_buffer[TEST_REQUEST_BUFFER_SIZE + 1];
+static size_t xio_send_transmited_buffer_size;
 static int xio_send_transmited_buffer_target = 0;
 
 typedef enum xio_dowork_job_tag
@@ -158,7 +167,6 @@ static const int xio_send_e[4] = { 123, 123, 123, 123 };
 static const int xio_send_0_e[4] = { 0, 123, 0, 0 };
 static const int xio_send_00_e[4] = { 0, 0, 123, 0 };
 static const int xio_send_7x0[7] = { 0, 0, 0, 0, 0, 0, 0 };
-static const int xio_send_6x0_e[7] = { 0, 0, 0, 0, 0, 0, 123 };
 static const xio_dowork_job doworkjob_end[1] = { XIO_DOWORK_JOB_END };
 static const xio_dowork_job doworkjob_oe[2] = { XIO_DOWORK_JOB_OPEN, XIO_DOWORK_JOB_END };
 static const xio_dowork_job doworkjob_4none_oe[6] = { XIO_DOWORK_JOB_NONE, XIO_DOWORK_JOB_NONE, XIO_DOWORK_JOB_NONE, XIO_DOWORK_JOB_NONE, XIO_DOWORK_JOB_OPEN, XIO_DOWORK_JOB_END };
@@ -171,8 +179,7 @@ static const xio_dowork_job doworkjob_o_re[3] = { XIO_DOWORK_JOB_OPEN, XIO_DOWOR
 static const xio_dowork_job doworkjob_o_rce[8] = { XIO_DOWORK_JOB_OPEN, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_CLOSE, XIO_DOWORK_JOB_END };
 static const xio_dowork_job doworkjob_o_rc_error[9] = { XIO_DOWORK_JOB_OPEN, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_CLOSE, XIO_DOWORK_JOB_ERROR, XIO_DOWORK_JOB_END };
 static const xio_dowork_job doworkjob_o_rre[4] = { XIO_DOWORK_JOB_OPEN, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_END };
-static const xio_dowork_job doworkjob_o_sre[15] = { XIO_DOWORK_JOB_OPEN,
-    XIO_DOWORK_JOB_SEND, XIO_DOWORK_JOB_SEND, XIO_DOWORK_JOB_SEND, XIO_DOWORK_JOB_SEND, XIO_DOWORK_JOB_SEND, XIO_DOWORK_JOB_SEND, XIO_DOWORK_JOB_SEND,
+static const xio_dowork_job doworkjob_o_sre[9] = { XIO_DOWORK_JOB_OPEN, XIO_DOWORK_JOB_SEND,
     XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_CLOSE, XIO_DOWORK_JOB_END };
 
 static const IO_OPEN_RESULT openresult_ok[1] = { IO_OPEN_OK };
@@ -306,6 +313,8 @@ int my_xio_send(XIO_HANDLE xio, const void* buffer, size_t size, ON_SEND_COMPLET
             if (xio_send_transmited_buffer_target == 0)
             {
                 (void)memcpy(xio_send_transmited_buffer, buffer, size);
+                xio_send_transmited_buffer[size] = '\0';
+                xio_send_transmited_buffer_size = size;
             }
         }
         result = xio_send_shallReturn[xio_send_shallReturn_counter];
@@ -429,18 +438,20 @@ HTTP_HEADERS_RESULT my_HTTPHeaders_GetHeaderCount(HTTP_HEADERS_HANDLE handle, si
 }
 
 static HTTP_HEADERS_RESULT HTTPHeaders_GetHeader_shallReturn;
-HTTP_HEADERS_RESULT my_HTTPHeaders_GetHeader(HTTP_HEADERS_HANDLE handle, size_t index, char** destination)
+HTTP_HEADERS_RESULT my_HTTPHeaders_GetHeaderView(HTTP_HEADERS_HANDLE handle, size_t index, HTTP_HEADER_VIEW* header)
 {
     HTTP_HEADERS_RESULT result;
 
-    if ((handle == NULL) || (destination == NULL) || (index > TEST_GET_HEADER_HEAD_COUNT))
+    if ((handle == NULL) || (header == NULL) || (index > TEST_GET_HEADER_HEAD_COUNT))
     {
         result = HTTP_HEADERS_INVALID_ARG;
     }
     else
     {
-        *destination = (char*)malloc(11 * sizeof(char));
-        strcpy(*destination, "0123456789");
+        header->name = "header";
+        header->value = "0123456789";
+        header->line = "header: 0123456789";
+        header->line_length = 18;
         result = HTTPHeaders_GetHeaderCount_shallReturn;
     }
 
@@ -517,6 +528,9 @@ static HTTP_HANDLE createHttpConnection(void)
     STRICT_EXPECTED_CALL(platform_get_default_tlsio());
     STRICT_EXPECTED_CALL(xio_create(&default_tlsio, IGNORED_ARG)).IgnoreArgument(2);
     STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
+#ifdef USE_SOCKETIO_REACTOR
+    STRICT_EXPECTED_CALL(socketio_reactor_create());
+#endif
 
     HTTPAPI_Init();
     return HTTPAPI_CreateConnection(TEST_CREATE_CONNECTION_HOST_NAME);    /* currentmalloc_call += 2 */
@@ -605,23 +619,10 @@ static void setupAllCallBeforeReceiveHTTPsequenceWithSuccess()
 
 static void setupAllCallBeforeSendHTTPsequenceWithSuccess(HTTP_HEADERS_HANDLE requestHttpHeaders)
 {
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeader(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderView(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
         .IgnoreArgument(2).IgnoreArgument(3);
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeader(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderView(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
         .IgnoreArgument(2).IgnoreArgument(3);
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-
     STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
 }
 
@@ -711,6 +712,7 @@ TEST_SUITE_INITIALIZE(setsBufferTempSize)
     REGISTER_TYPE(HTTP_HEADERS_RESULT, HTTP_HEADERS_RESULT);
 
     REGISTER_UMOCK_ALIAS_TYPE(HTTP_HEADERS_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(HTTP_HEADER_VIEW*, void*);
     REGISTER_UMOCK_ALIAS_TYPE(XIO_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_SEND_COMPLETE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_IO_CLOSE_COMPLETE, void*);
@@ -718,6 +720,8 @@ TEST_SUITE_INITIALIZE(setsBufferTempSize)
     REGISTER_UMOCK_ALIAS_TYPE(ON_BYTES_RECEIVED, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_IO_ERROR, void*);
     REGISTER_UMOCK_ALIAS_TYPE(BUFFER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(SOCKETIO_REACTOR_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(TICK_COUNTER_HANDLE, void*);
 
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_realloc, my_gballoc_realloc);
@@ -736,7 +740,7 @@ TEST_SUITE_INITIALIZE(setsBufferTempSize)
     REGISTER_GLOBAL_MOCK_HOOK(BUFFER_new, my_BUFFER_new);
     REGISTER_GLOBAL_MOCK_HOOK(BUFFER_delete, my_BUFFER_delete);
     REGISTER_GLOBAL_MOCK_HOOK(HTTPHeaders_GetHeaderCount, my_HTTPHeaders_GetHeaderCount);
-    REGISTER_GLOBAL_MOCK_HOOK(HTTPHeaders_GetHeader, my_HTTPHeaders_GetHeader);
+    REGISTER_GLOBAL_MOCK_HOOK(HTTPHeaders_GetHeaderView, my_HTTPHeaders_GetHeaderView);
 
     REGISTER_GLOBAL_MOCK_HOOK(platform_get_default_tlsio, my_platform_get_default_tlsio);
     REGISTER_GLOBAL_MOCK_HOOK(mallocAndStrcpy_s, my_mallocAndStrcpy_s);
@@ -764,6 +768,7 @@ TEST_FUNCTION_INITIALIZE(f)
     whenShallmalloc_fail = 0;
 
     xio_send_transmited_buffer[0] = '\0';
+    xio_send_transmited_buffer_size = 0;
 
     call_on_send_complete_in_xio_send = true;
     SkipDoworkJobsOpenResult = 0;
@@ -880,6 +885,9 @@ TEST_FUNCTION(HTTPAPI_CreateConnection__valid_hostName_Succeed)
     STRICT_EXPECTED_CALL(platform_get_default_tlsio());
     STRICT_EXPECTED_CALL(xio_create(&default_tlsio, IGNORED_ARG)).IgnoreArgument(2);
     STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
+#ifdef USE_SOCKETIO_REACTOR
+    STRICT_EXPECTED_CALL(socketio_reactor_create());
+#endif
 
     /// act
     httpHandle = HTTPAPI_CreateConnection(TEST_CREATE_CONNECTION_HOST_NAME);    /* currentmalloc_call += 2 */
@@ -894,6 +902,67 @@ TEST_FUNCTION(HTTPAPI_CreateConnection__valid_hostName_Succeed)
     HTTPAPI_Deinit();
 }
 
+#ifdef USE_SOCKETIO_REACTOR
+TEST_FUNCTION(HTTPAPI_CreateConnection__sets_the_socketio_reactor_on_the_tlsio)
+{
+    /// arrange
+    HTTP_HANDLE httpHandle;
+    HTTPAPI_Init();
+    current_xioCreate_must_fail = false;
+    xio_setoption_shallReturn = 0;
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(platform_get_default_tlsio());
+    STRICT_EXPECTED_CALL(xio_create(&default_tlsio, IGNORED_ARG)).IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(socketio_reactor_create()).SetReturn(TEST_SOCKETIO_REACTOR);
+    STRICT_EXPECTED_CALL(tickcounter_create()).SetReturn(TEST_TICK_COUNTER);
+    STRICT_EXPECTED_CALL(xio_setoption(IGNORED_ARG, OPTION_SOCKETIO_REACTOR, TEST_SOCKETIO_REACTOR));
+
+    /// act
+    httpHandle = HTTPAPI_CreateConnection(TEST_CREATE_CONNECTION_HOST_NAME);    /* currentmalloc_call += 2 */
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(httpHandle);
+
+    /// cleanup
+    HTTPAPI_CloseConnection(httpHandle);    /* currentmalloc_call -= 2 */
+    HTTPAPI_Deinit();
+}
+
+TEST_FUNCTION(HTTPAPI_CreateConnection__tlsio_refuses_the_socketio_reactor_falls_back_to_sleep)
+{
+    /// arrange
+    HTTP_HANDLE httpHandle;
+    HTTPAPI_Init();
+    current_xioCreate_must_fail = false;
+    xio_setoption_shallReturn = MU_FAILURE;
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(platform_get_default_tlsio());
+    STRICT_EXPECTED_CALL(xio_create(&default_tlsio, IGNORED_ARG)).IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(socketio_reactor_create()).SetReturn(TEST_SOCKETIO_REACTOR);
+    STRICT_EXPECTED_CALL(tickcounter_create()).SetReturn(TEST_TICK_COUNTER);
+    STRICT_EXPECTED_CALL(xio_setoption(IGNORED_ARG, OPTION_SOCKETIO_REACTOR, TEST_SOCKETIO_REACTOR));
+    STRICT_EXPECTED_CALL(socketio_reactor_destroy(TEST_SOCKETIO_REACTOR));
+    STRICT_EXPECTED_CALL(tickcounter_destroy(TEST_TICK_COUNTER));
+
+    /// act
+    httpHandle = HTTPAPI_CreateConnection(TEST_CREATE_CONNECTION_HOST_NAME);    /* currentmalloc_call += 2 */
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(httpHandle);
+
+    /// cleanup
+    xio_setoption_shallReturn = 0;
+    HTTPAPI_CloseConnection(httpHandle);    /* currentmalloc_call -= 2 */
+    HTTPAPI_Deinit();
+}
+#endif
+
 /*Tests_SRS_HTTPAPI_COMPACT_21_013: [ If there is not enough memory to control the http connection, the HTTPAPI_CreateConnection shall return NULL as the handle. ]*/
 TEST_FUNCTION(HTTPAPI_CreateConnection__no_enough_memory_failed)
 {
@@ -1080,7 +1149,7 @@ TEST_FUNCTION(HTTPAPI_CloseConnection__return_LINE_failed)
 }
 
 /*Tests_SRS_HTTPAPI_COMPACT_21_084: [ The HTTPAPI_CloseConnection shall wait, at least, 10 seconds for the SSL close process. ]*/
-/*Tests_SRS_HTTPAPI_COMPACT_21_086: [ The HTTPAPI_CloseConnection shall wait, at least, 100 milliseconds between retries. ]*/
+/*Tests_SRS_HTTPAPI_COMPACT_04_002: [ Between retries, the HTTPAPI_CloseConnection shall wait for the transport for up to 100 milliseconds: on the socketio reactor of the connection until its socket is ready, or by sleeping when the transport does not take a socketio reactor. ]*/
 TEST_FUNCTION(HTTPAPI_CloseConnection__close_on_dowork_succeed)
 {
     /// arrange
@@ -1326,8 +1395,9 @@ TEST_FUNCTION(HTTPAPI_CloseConnection__close_timeout_failed)
     SkipDoworkJobsCloseResult = 101;
     call_on_io_close_complete_in_xio_close = false;
 
+    /*the 10 seconds of the close go by in 100 sleeps of 100 ms, the close result comes after them*/
     STRICT_EXPECTED_CALL(xio_close(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    for (i = 0; i < SkipDoworkJobsCloseResult; i++)
+    for (i = 0; i < 100; i++)
     {
         STRICT_EXPECTED_CALL(xio_dowork(IGNORED_ARG))
             .IgnoreArgument(1);
@@ -2141,7 +2211,8 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_io_open_complete_with_timeout_failed)
     DoworkJobs = (const xio_dowork_job*)doworkjob_4none_oe;
     DoworkJobsOpenResult = (const IO_OPEN_RESULT*)openresult_ok;
 
-    SkipDoworkJobsOpenResult = 98;
+    /*the 10 seconds of the open go by in 100 sleeps of 100 ms, the open result comes after them*/
+    SkipDoworkJobsOpenResult = 97;
     setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, SkipDoworkJobsOpenResult + 4, false);
     STRICT_EXPECTED_CALL(xio_dowork(IGNORED_ARG))
         .IgnoreArgument(1);
@@ -2318,6 +2389,10 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__io_send_header_return_error_failed)
     setHttpx509ClientCertificateAndKey(httpHandle);
     setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, 1, true);
     xio_send_shallReturn = (const int*)xio_send_e;
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderView(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
+        .IgnoreArgument(2).IgnoreArgument(3);
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderView(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
+        .IgnoreArgument(2).IgnoreArgument(3);
     STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
 
     /// act
@@ -2349,11 +2424,15 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_send_header_complete_with_success_befor
     /// arrange
     unsigned int statusCode;
     HTTPAPI_RESULT result;
+    char relativePath[TEST_LONG_RELATIVE_PATH_LENGTH + 1];
     HTTP_HEADERS_HANDLE requestHttpHeaders;
     HTTP_HEADERS_HANDLE responseHttpHeaders;
     HTTP_HANDLE httpHandle = createHttpConnection();
     createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
     setHttpCertificate(httpHandle);
+    (void)memset(relativePath, 'a', TEST_LONG_RELATIVE_PATH_LENGTH);
+    relativePath[0] = '/';
+    relativePath[TEST_LONG_RELATIVE_PATH_LENGTH] = '\0';
 
     DoworkJobs = (const xio_dowork_job*)doworkjob_oe;
     DoworkJobsOpenResult = (const IO_OPEN_RESULT*)openresult_ok;
@@ -2361,13 +2440,12 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_send_header_complete_with_success_befor
     xio_send_shallReturn = (const int*)xio_send_0_e;
 
     setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, 1, false);
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderView(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
+        .IgnoreArgument(2).IgnoreArgument(3);
     STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeader(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderView(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
         .IgnoreArgument(2).IgnoreArgument(3);
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
     STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-        .IgnoreArgument(1);
 
     HTTPHeaders_GetHeader_shallReturn = HTTP_HEADERS_OK;
 
@@ -2375,7 +2453,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_send_header_complete_with_success_befor
     result = HTTPAPI_ExecuteRequest(
         httpHandle,
         HTTPAPI_REQUEST_GET,
-        TEST_EXECUTE_REQUEST_RELATIVE_PATH,
+        relativePath,
         requestHttpHeaders,
         TEST_EXECUTE_REQUEST_CONTENT,
         TEST_EXECUTE_REQUEST_CONTENT_LENGTH,
@@ -2400,11 +2478,16 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_send_header_complete_with_2_success_bef
     /// arrange
     unsigned int statusCode;
     HTTPAPI_RESULT result;
+    char relativePath[TEST_LONG_RELATIVE_PATH_LENGTH + 1];
+    unsigned char content[TEST_REQUEST_BUFFER_SIZE + 1] = { 0 };
     HTTP_HEADERS_HANDLE requestHttpHeaders;
     HTTP_HEADERS_HANDLE responseHttpHeaders;
     HTTP_HANDLE httpHandle = createHttpConnection();
     createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
     setHttpCertificate(httpHandle);
+    (void)memset(relativePath, 'a', TEST_LONG_RELATIVE_PATH_LENGTH);
+    relativePath[0] = '/';
+    relativePath[TEST_LONG_RELATIVE_PATH_LENGTH] = '\0';
 
     DoworkJobs = (const xio_dowork_job*)doworkjob_oe;
     DoworkJobsOpenResult = (const IO_OPEN_RESULT*)openresult_ok;
@@ -2412,14 +2495,13 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_send_header_complete_with_2_success_bef
     xio_send_shallReturn = (const int*)xio_send_00_e;
 
     setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, 1, false);
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderView(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
+        .IgnoreArgument(2).IgnoreArgument(3);
     STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeader(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderView(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
         .IgnoreArgument(2).IgnoreArgument(3);
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
     STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-        .IgnoreArgument(1);
 
     HTTPHeaders_GetHeader_shallReturn = HTTP_HEADERS_OK;
 
@@ -2427,10 +2509,10 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_send_header_complete_with_2_success_bef
     result = HTTPAPI_ExecuteRequest(
         httpHandle,
         HTTPAPI_REQUEST_GET,
-        TEST_EXECUTE_REQUEST_RELATIVE_PATH,
+        relativePath,
         requestHttpHeaders,
-        TEST_EXECUTE_REQUEST_CONTENT,
-        TEST_EXECUTE_REQUEST_CONTENT_LENGTH,
+        content,
+        sizeof(content),
         &statusCode,
         responseHttpHeaders,
         TestBufferHandle);
@@ -2467,6 +2549,10 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_send_header_complete_timeout_failed)
     call_on_send_complete_in_xio_send = false;
 
     setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, 1, false);
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderView(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
+        .IgnoreArgument(2).IgnoreArgument(3);
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderView(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
+        .IgnoreArgument(2).IgnoreArgument(3);
     STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
     SkipDoworkJobsSendResult = 200;
     for (i = 0; i < SkipDoworkJobsSendResult; i++)
@@ -2524,6 +2610,10 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_send_header_complete_retry_n_and_failed
     call_on_send_complete_in_xio_send = false;
 
     setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, 1, false);
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderView(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
+        .IgnoreArgument(2).IgnoreArgument(3);
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderView(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
+        .IgnoreArgument(2).IgnoreArgument(3);
     STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
     SkipDoworkJobsSendResult = 10;
     for (i = 0; i < SkipDoworkJobsSendResult; i++)
@@ -2566,6 +2656,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_send_buffer_complete_with_error_failed)
     /// arrange
     unsigned int statusCode;
     HTTPAPI_RESULT result;
+    unsigned char content[TEST_REQUEST_BUFFER_SIZE + 1] = { 0 };
     HTTP_HEADERS_HANDLE requestHttpHeaders;
     HTTP_HEADERS_HANDLE responseHttpHeaders;
     HTTP_HANDLE httpHandle = createHttpConnection();
@@ -2575,27 +2666,14 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_send_buffer_complete_with_error_failed)
     DoworkJobs = (const xio_dowork_job*)doworkjob_oe;
     DoworkJobsOpenResult = (const IO_OPEN_RESULT*)openresult_ok;
     DoworkJobsSendResult = (const IO_SEND_RESULT*)sendresult_6ok_error;
-    xio_send_shallReturn = (const int*)xio_send_6x0_e;
+    xio_send_shallReturn = (const int*)xio_send_0_e;
 
     setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, 1, false);
-
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeader(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderView(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
         .IgnoreArgument(2).IgnoreArgument(3);
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeader(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderView(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
         .IgnoreArgument(2).IgnoreArgument(3);
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-        .IgnoreArgument(1);
     STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-
     STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
 
     HTTPHeaders_GetHeader_shallReturn = HTTP_HEADERS_OK;
@@ -2606,8 +2684,8 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_send_buffer_complete_with_error_failed)
         HTTPAPI_REQUEST_GET,
         TEST_EXECUTE_REQUEST_RELATIVE_PATH,
         requestHttpHeaders,
-        TEST_EXECUTE_REQUEST_CONTENT,
-        TEST_EXECUTE_REQUEST_CONTENT_LENGTH,
+        content,
+        sizeof(content),
         &statusCode,
         responseHttpHeaders,
         TestBufferHandle);
@@ -3173,6 +3251,10 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_retry_send_succeed)
 
     setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, 1, false);
 
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderView(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
+        .IgnoreArgument(2).IgnoreArgument(3);
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderView(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
+        .IgnoreArgument(2).IgnoreArgument(3);
     STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
     SkipDoworkJobsSendResult = 199;
     for (i = 0; i < SkipDoworkJobsSendResult+1; i++)
@@ -3181,41 +3263,6 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_retry_send_succeed)
             .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
     }
-    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeader(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
-        .IgnoreArgument(2).IgnoreArgument(3);
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeader(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
-        .IgnoreArgument(2).IgnoreArgument(3);
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
-
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
 
     setupAllCallBeforeReceiveHTTPsequenceWithSuccess();
 
@@ -3636,7 +3683,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__request_with_content_succeed)
     setupAllCallBeforeReceiveHTTPsequenceWithSuccess();
 
     HTTPHeaders_GetHeader_shallReturn = HTTP_HEADERS_OK;
-    xio_send_transmited_buffer_target = 7;
+    xio_send_transmited_buffer_target = 1;
 
     /// act
     result = HTTPAPI_ExecuteRequest(
@@ -3653,7 +3700,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__request_with_content_succeed)
     /// assert
     ASSERT_ARE_EQUAL(int, HTTPAPI_OK, result);
     ASSERT_ARE_EQUAL(int, 433, statusCode);
-    ASSERT_ARE_EQUAL(char_ptr, (const char*)TEST_EXECUTE_REQUEST_CONTENT, xio_send_transmited_buffer);
+    ASSERT_ARE_EQUAL(char_ptr, (const char*)TEST_EXECUTE_REQUEST_CONTENT, xio_send_transmited_buffer + xio_send_transmited_buffer_size - TEST_EXECUTE_REQUEST_CONTENT_LENGTH);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_EQUAL(int, 6, currentmalloc_call);
 
@@ -3683,26 +3730,11 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__request_NULL_content_succeed)
     DoworkJobsSendResult = DoworkJobsSendResult_ReceiveHead;
 
     setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, 1, false);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeader(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
-        .IgnoreArgument(2).IgnoreArgument(3);
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeader(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
-        .IgnoreArgument(2).IgnoreArgument(3);
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    setupAllCallBeforeSendHTTPsequenceWithSuccess(requestHttpHeaders);
     setupAllCallBeforeReceiveHTTPsequenceWithSuccess();
 
     HTTPHeaders_GetHeader_shallReturn = HTTP_HEADERS_OK;
-    xio_send_transmited_buffer_target = 7;
+    xio_send_transmited_buffer_target = 1;
 
     /// act
     result = HTTPAPI_ExecuteRequest(
@@ -3719,7 +3751,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__request_NULL_content_succeed)
     /// assert
     ASSERT_ARE_EQUAL(int, HTTPAPI_OK, result);
     ASSERT_ARE_EQUAL(int, 433, statusCode);
-    ASSERT_ARE_EQUAL(char_ptr, (const char*)"", xio_send_transmited_buffer);
+    ASSERT_ARE_EQUAL(char_ptr, "header: 0123456789\r\n\r\n", xio_send_transmited_buffer + xio_send_transmited_buffer_size - 22);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_EQUAL(int, 6, currentmalloc_call);
 
@@ -3750,26 +3782,11 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__request_content_size_0_succeed)
 
     setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, 1, false);
 
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeader(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
-        .IgnoreArgument(2).IgnoreArgument(3);
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeader(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
-        .IgnoreArgument(2).IgnoreArgument(3);
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    setupAllCallBeforeSendHTTPsequenceWithSuccess(requestHttpHeaders);
     setupAllCallBeforeReceiveHTTPsequenceWithSuccess();
 
     HTTPHeaders_GetHeader_shallReturn = HTTP_HEADERS_OK;
-    xio_send_transmited_buffer_target = 7;
+    xio_send_transmited_buffer_target = 1;
 
     /// act
     result = HTTPAPI_ExecuteRequest(
@@ -3786,7 +3803,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__request_content_size_0_succeed)
     /// assert
     ASSERT_ARE_EQUAL(int, HTTPAPI_OK, result);
     ASSERT_ARE_EQUAL(int, 433, statusCode);
-    ASSERT_ARE_EQUAL(char_ptr, (const char*)"", xio_send_transmited_buffer);
+    ASSERT_ARE_EQUAL(char_ptr, "header: 0123456789\r\n\r\n", xio_send_transmited_buffer + xio_send_transmited_buffer_size - 22);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_EQUAL(int, 6, currentmalloc_call);
 
@@ -3864,23 +3881,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_no_responseHeadersHandle_s
 
     setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, 1, false);
 
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeader(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
-        .IgnoreArgument(2).IgnoreArgument(3);
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeader(requestHttpHeaders, IGNORED_ARG, IGNORED_ARG))
-        .IgnoreArgument(2).IgnoreArgument(3);
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(xio_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    setupAllCallBeforeSendHTTPsequenceWithSuccess(requestHttpHeaders);
     STRICT_EXPECTED_CALL(xio_dowork(IGNORED_ARG))
         .IgnoreArgument(1);
     STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, DoworkJobsReceivedBuffer_size[0])).IgnoreArgument(1);
@@ -3974,7 +3975,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_responseContent_NULL_succe
 
 /*Tests_SRS_HTTPAPI_COMPACT_21_081: [ The HTTPAPI_ExecuteRequest shall try to read the message with the response up to 20 seconds. ]*/
 /*Tests_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
-/*Tests_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
+/*Tests_SRS_HTTPAPI_COMPACT_04_001: [ Between retries, the HTTPAPI_ExecuteRequest shall wait for the transport for up to 100 milliseconds: on the socketio reactor of the connection until its socket is ready, or by sleeping when the transport does not take a socketio reactor. ]*/
 TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_content_failed)
 {
     /// arrange
@@ -4051,7 +4052,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_content_fai
 
 /*Tests_SRS_HTTPAPI_COMPACT_21_081: [ The HTTPAPI_ExecuteRequest shall try to read the message with the response up to 20 seconds. ]*/
 /*Tests_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
-/*Tests_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
+/*Tests_SRS_HTTPAPI_COMPACT_04_001: [ Between retries, the HTTPAPI_ExecuteRequest shall wait for the transport for up to 100 milliseconds: on the socketio reactor of the connection until its socket is ready, or by sleeping when the transport does not take a socketio reactor. ]*/
 TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_parameter_failed)
 {
     /// arrange
@@ -4122,7 +4123,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_parameter_f
 
 /*Tests_SRS_HTTPAPI_COMPACT_21_081: [ The HTTPAPI_ExecuteRequest shall try to read the message with the response up to 20 seconds. ]*/
 /*Tests_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
-/*Tests_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
+/*Tests_SRS_HTTPAPI_COMPACT_04_001: [ Between retries, the HTTPAPI_ExecuteRequest shall wait for the transport for up to 100 milliseconds: on the socketio reactor of the connection until its socket is ready, or by sleeping when the transport does not take a socketio reactor. ]*/
 TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_header_failed)
 {
     /// arrange
@@ -4209,7 +4210,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__request_with_no_content_succeed)
     setupAllCallBeforeReceiveHTTPHeadsequenceWithSuccess();
 
     HTTPHeaders_GetHeader_shallReturn = HTTP_HEADERS_OK;
-    xio_send_transmited_buffer_target = 7;
+    xio_send_transmited_buffer_target = 1;
 
     /// act
     result = HTTPAPI_ExecuteRequest(
@@ -4226,7 +4227,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__request_with_no_content_succeed)
     /// assert
     ASSERT_ARE_EQUAL(int, HTTPAPI_OK, result);
     ASSERT_ARE_EQUAL(int, 433, statusCode);
-    ASSERT_ARE_EQUAL(char_ptr, (const char*)TEST_EXECUTE_REQUEST_CONTENT, xio_send_transmited_buffer);
+    ASSERT_ARE_EQUAL(char_ptr, (const char*)TEST_EXECUTE_REQUEST_CONTENT, xio_send_transmited_buffer + xio_send_transmited_buffer_size - TEST_EXECUTE_REQUEST_CONTENT_LENGTH);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_EQUAL(int, 6, currentmalloc_call);
 
@@ -102,6 +102,9 @@ void my_gballoc_free(void* ptr)
 #include "azure_c_shared_utility/buffer_.h"
 #include "azure_c_shared_utility/httpheaders.h"
 #include "azure_c_shared_utility/httpapi.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/condition.h"
+#include "azure_c_shared_utility/tickcounter.h"
 
 static size_t currentHTTPAPI_SaveOption_call;
 static size_t whenShallHTTPAPI_SaveOption_fail;
@@ -218,6 +221,34 @@ void my_HTTPAPI_CloseConnection(HTTP_HANDLE handle)
     free(handle);
 }
 
+static size_t currentHTTPAPI_ExecuteRequest_call;
+static size_t whenShallHTTPAPI_ExecuteRequest_fail;
+
+HTTPAPI_RESULT my_HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath, HTTP_HEADERS_HANDLE httpHeadersHandle,
+    const unsigned char* content, size_t contentLength, unsigned int* statusCode, HTTP_HEADERS_HANDLE responseHeadersHandle, BUFFER_HANDLE responseContent)
+{
+    (void)handle;
+    (void)requestType;
+    (void)relativePath;
+    (void)httpHeadersHandle;
+    (void)content;
+    (void)contentLength;
+    (void)statusCode;
+    (void)responseHeadersHandle;
+    (void)responseContent;
+    currentHTTPAPI_ExecuteRequest_call++;
+    return (currentHTTPAPI_ExecuteRequest_call == whenShallHTTPAPI_ExecuteRequest_fail) ? HTTPAPI_ERROR : HTTPAPI_OK;
+}
+
+static tickcounter_ms_t current_ms;
+
+int my_tickcounter_get_current_ms(TICK_COUNTER_HANDLE tick_counter, tickcounter_ms_t* current_ms_out)
+{
+    (void)tick_counter;
+    *current_ms_out = current_ms;
+    return 0;
+}
+
 HTTPAPI_RESULT my_HTTPAPI_CloneOption(const char* optionName, const void* value, const void** savedValue)
 {
     HTTPAPI_RESULT result2;
@@ -295,6 +326,7 @@ extern "C"
 #undef ENABLE_MOCKS
 
 #include "azure_c_shared_utility/httpapiex.h"
+#include "azure_c_shared_utility/shared_util_options.h"
 
 IMPLEMENT_UMOCK_C_ENUM_TYPE(HTTPAPI_RESULT, HTTPAPI_RESULT_VALUES);
 TEST_DEFINE_ENUM_TYPE(HTTPAPIEX_RESULT, HTTPAPIEX_RESULT_VALUES);
@@ -313,6 +345,9 @@ IMPLEMENT_UMOCK_C_ENUM_TYPE(HTTPAPI_REQUEST_TYPE, HTTPAPI_REQUEST_TYPE_VALUES);
 #define TEST_BUFFER_RESP_BODY   (BUFFER_HANDLE) 0x49
 unsigned char* TEST_BUFFER = (unsigned char*)"333333";
 #define TEST_BUFFER_SIZE 6
+#define TEST_LOCK (LOCK_HANDLE)0x50
+#define TEST_CONDITION (COND_HANDLE)0x51
+#define TEST_TICK_COUNTER (TICK_COUNTER_HANDLE)0x52
 
 static TEST_MUTEX_HANDLE g_testByTest;
 
@@ -462,6 +497,9 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_UMOCK_ALIAS_TYPE(HTTP_HEADERS_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(HTTP_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(const unsigned char*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(LOCK_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(COND_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(TICK_COUNTER_HANDLE, void*);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_calloc, my_gballoc_calloc);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_realloc, my_gballoc_realloc);
@@ -481,7 +519,7 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_GLOBAL_MOCK_HOOK(HTTPAPI_Deinit, my_HTTPAPI_Deinit);
     REGISTER_GLOBAL_MOCK_HOOK(HTTPAPI_CreateConnection, my_HTTPAPI_CreateConnection);
     REGISTER_GLOBAL_MOCK_HOOK(HTTPAPI_CloseConnection, my_HTTPAPI_CloseConnection);
-    REGISTER_GLOBAL_MOCK_RETURN(HTTPAPI_ExecuteRequest, HTTPAPI_OK);
+    REGISTER_GLOBAL_MOCK_HOOK(HTTPAPI_ExecuteRequest, my_HTTPAPI_ExecuteRequest);
     REGISTER_GLOBAL_MOCK_RETURN(HTTPAPI_SetOption, HTTPAPI_OK);
     REGISTER_GLOBAL_MOCK_HOOK(HTTPAPI_CloneOption, my_HTTPAPI_CloneOption);
     REGISTER_GLOBAL_MOCK_HOOK(VECTOR_create, real_VECTOR_create);
@@ -497,6 +535,13 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_GLOBAL_MOCK_HOOK(VECTOR_size, real_VECTOR_size);
     REGISTER_GLOBAL_MOCK_HOOK(mallocAndStrcpy_s, real_mallocAndStrcpy_s);
     REGISTER_GLOBAL_MOCK_HOOK(size_tToString, real_size_tToString);
+    REGISTER_GLOBAL_MOCK_RETURN(Lock_Init, TEST_LOCK);
+    REGISTER_GLOBAL_MOCK_RETURN(Lock, LOCK_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(Unlock, LOCK_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(Condition_Init, TEST_CONDITION);
+    REGISTER_GLOBAL_MOCK_RETURN(Condition_Post, COND_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(tickcounter_create, TEST_TICK_COUNTER);
+    REGISTER_GLOBAL_MOCK_HOOK(tickcounter_get_current_ms, my_tickcounter_get_current_ms);
 }
 
 TEST_SUITE_CLEANUP(TestClassCleanup)
@@ -541,6 +586,10 @@ TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
     currentHTTPAPI_Init_call = 0;
     for (i = 0; i<N_MAX_FAILS; i++) whenShallHTTPAPI_Init_fail[i] = 0;
 
+    currentHTTPAPI_ExecuteRequest_call = 0;
+    whenShallHTTPAPI_ExecuteRequest_fail = 0;
+    current_ms = 0;
+
     umock_c_reset_all_calls();
 }
 
@@ -3639,4 +3688,208 @@ TEST_FUNCTION(HTTPAPIEX_Destroy_with_NULL_argument_does_nothing)
     ///destroy
 }
 
+static HTTPAPIEX_HANDLE create_pooled_handle(size_t max_connections, size_t max_idle_connections, uint32_t idle_timeout_ms)
+{
+    HTTPAPIEX_CONNECTION_POOL_CONFIG config;
+    HTTPAPIEX_HANDLE result;
+
+    config.max_connections = max_connections;
+    config.max_idle_connections = max_idle_connections;
+    config.idle_timeout_ms = idle_timeout_ms;
+
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, HTTPAPIEX_Init());
+    result = HTTPAPIEX_Create(TEST_HOSTNAME);
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, HTTPAPIEX_SetOption(result, OPTION_HTTPAPIEX_CONNECTION_POOL, &config));
+    umock_c_reset_all_calls();
+    return result;
+}
+
+static void execute_pooled_request(HTTPAPIEX_HANDLE handle)
+{
+    unsigned int statusCode;
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, HTTPAPIEX_ExecuteRequest(handle, HTTPAPI_REQUEST_POST, TEST_RELATIVE_PATH, TEST_REQUEST_HTTP_HEADERS, TEST_REQUEST_BODY, &statusCode, TEST_RESPONSE_HTTP_HEADERS, TEST_RESPONSE_BODY));
+}
+
+TEST_FUNCTION(HTTPAPIEX_SetOption_connection_pool_without_HTTPAPIEX_Init_fails)
+{
+    /// arrange
+    HTTPAPIEX_RESULT result;
+    HTTPAPIEX_CONNECTION_POOL_CONFIG config = { 4, 2, 0 };
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    umock_c_reset_all_calls();
+
+    /// act
+    result = HTTPAPIEX_SetOption(httpapiexhandle, OPTION_HTTPAPIEX_CONNECTION_POOL, &config);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///destroy
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
+TEST_FUNCTION(HTTPAPIEX_SetOption_connection_pool_with_more_idle_than_max_connections_fails)
+{
+    /// arrange
+    HTTPAPIEX_RESULT result;
+    HTTPAPIEX_CONNECTION_POOL_CONFIG config = { 2, 4, 0 };
+    HTTPAPIEX_HANDLE httpapiexhandle;
+    (void)HTTPAPIEX_Init();
+    httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    umock_c_reset_all_calls();
+
+    /// act
+    result = HTTPAPIEX_SetOption(httpapiexhandle, OPTION_HTTPAPIEX_CONNECTION_POOL, &config);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///destroy
+    HTTPAPIEX_Destroy(httpapiexhandle);
+    HTTPAPIEX_Deinit();
+}
+
+TEST_FUNCTION(HTTPAPIEX_SetOption_connection_pool_succeeds)
+{
+    /// arrange
+    HTTPAPIEX_RESULT result;
+    HTTPAPIEX_CONNECTION_POOL_CONFIG config = { 4, 2, 30000 };
+    HTTPAPIEX_HANDLE httpapiexhandle;
+    (void)HTTPAPIEX_Init();
+    httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_calloc(1, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(Lock_Init());
+    STRICT_EXPECTED_CALL(Condition_Init());
+    STRICT_EXPECTED_CALL(tickcounter_create());
+
+    /// act
+    result = HTTPAPIEX_SetOption(httpapiexhandle, OPTION_HTTPAPIEX_CONNECTION_POOL, &config);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///destroy
+    HTTPAPIEX_Destroy(httpapiexhandle);
+    HTTPAPIEX_Deinit();
+}
+
+TEST_FUNCTION(HTTPAPIEX_ExecuteRequest_with_connection_pool_reuses_the_connection)
+{
+    /// arrange
+    HTTPAPIEX_CONNECTION_POOL_STATISTICS statistics;
+    HTTPAPIEX_HANDLE httpapiexhandle = create_pooled_handle(4, 2, 0);
+
+    /// act
+    execute_pooled_request(httpapiexhandle);
+    execute_pooled_request(httpapiexhandle);
+    execute_pooled_request(httpapiexhandle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 1, currentHTTPAPI_CreateConnection_call);
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, HTTPAPIEX_GetConnectionPoolStatistics(httpapiexhandle, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.connections_created);
+    ASSERT_ARE_EQUAL(uint64_t, 2, statistics.connections_reused);
+    ASSERT_ARE_EQUAL(size_t, 1, statistics.idle_connections);
+
+    ///destroy
+    HTTPAPIEX_Destroy(httpapiexhandle);
+    HTTPAPIEX_Deinit();
+}
+
+TEST_FUNCTION(HTTPAPIEX_ExecuteRequest_with_connection_pool_evicts_connections_idle_for_too_long)
+{
+    /// arrange
+    HTTPAPIEX_CONNECTION_POOL_STATISTICS statistics;
+    HTTPAPIEX_HANDLE httpapiexhandle = create_pooled_handle(4, 2, 1000);
+    execute_pooled_request(httpapiexhandle);
+    current_ms = 1001;
+
+    /// act
+    execute_pooled_request(httpapiexhandle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 2, currentHTTPAPI_CreateConnection_call);
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, HTTPAPIEX_GetConnectionPoolStatistics(httpapiexhandle, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 2, statistics.connections_created);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.connections_reused);
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.connections_evicted);
+
+    ///destroy
+    HTTPAPIEX_Destroy(httpapiexhandle);
+    HTTPAPIEX_Deinit();
+}
+
+TEST_FUNCTION(HTTPAPIEX_ExecuteRequest_with_connection_pool_retries_a_failed_request_on_a_new_connection)
+{
+    /// arrange
+    unsigned int statusCode;
+    HTTPAPIEX_RESULT result;
+    HTTPAPIEX_CONNECTION_POOL_STATISTICS statistics;
+    HTTPAPIEX_HANDLE httpapiexhandle = create_pooled_handle(4, 2, 0);
+    execute_pooled_request(httpapiexhandle);
+    /*the idle connection was closed by the host, the next request fails on it*/
+    whenShallHTTPAPI_ExecuteRequest_fail = 2;
+
+    /// act
+    result = HTTPAPIEX_ExecuteRequest(httpapiexhandle, HTTPAPI_REQUEST_POST, TEST_RELATIVE_PATH, TEST_REQUEST_HTTP_HEADERS, TEST_REQUEST_BODY, &statusCode, TEST_RESPONSE_HTTP_HEADERS, TEST_RESPONSE_BODY);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, result);
+    ASSERT_ARE_EQUAL(size_t, 3, currentHTTPAPI_ExecuteRequest_call);
+    ASSERT_ARE_EQUAL(size_t, 2, currentHTTPAPI_CreateConnection_call);
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, HTTPAPIEX_GetConnectionPoolStatistics(httpapiexhandle, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.requests_retried);
+    ASSERT_ARE_EQUAL(uint64_t, 2, statistics.connections_created);
+    ASSERT_ARE_EQUAL(size_t, 1, statistics.idle_connections);
+
+    ///destroy
+    HTTPAPIEX_Destroy(httpapiexhandle);
+    HTTPAPIEX_Deinit();
+}
+
+TEST_FUNCTION(HTTPAPIEX_ExecuteRequest_with_connection_pool_closes_connections_beyond_max_idle)
+{
+    /// arrange
+    HTTPAPIEX_CONNECTION_POOL_STATISTICS statistics;
+    HTTPAPIEX_HANDLE httpapiexhandle = create_pooled_handle(4, 0, 0);
+
+    /// act
+    execute_pooled_request(httpapiexhandle);
+    execute_pooled_request(httpapiexhandle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 2, currentHTTPAPI_CreateConnection_call);
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, HTTPAPIEX_GetConnectionPoolStatistics(httpapiexhandle, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 2, statistics.connections_evicted);
+    ASSERT_ARE_EQUAL(size_t, 0, statistics.idle_connections);
+
+    ///destroy
+    HTTPAPIEX_Destroy(httpapiexhandle);
+    HTTPAPIEX_Deinit();
+}
+
+TEST_FUNCTION(HTTPAPIEX_GetConnectionPoolStatistics_without_connection_pool_fails)
+{
+    /// arrange
+    HTTPAPIEX_CONNECTION_POOL_STATISTICS statistics;
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    umock_c_reset_all_calls();
+
+    /// act
+    HTTPAPIEX_RESULT result = HTTPAPIEX_GetConnectionPoolStatistics(httpapiexhandle, &statistics);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///destroy
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
 END_TEST_SUITE(httpapiex_unittests)
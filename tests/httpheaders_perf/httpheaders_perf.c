@@ -0,0 +1,220 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+#include "azure_c_shared_utility/httpheaders.h"
+
+#include "perf_measure.h"
+
+#define HTTPHEADERS_PERF_LOOKUP_ITERATIONS 1000000
+#define HTTPHEADERS_PERF_SERIALIZE_ITERATIONS 100000
+#define HTTPHEADERS_PERF_MAX_HEADERS 256
+#define HTTPHEADERS_PERF_BLOCK_SIZE (HTTPHEADERS_PERF_MAX_HEADERS * 64)
+
+static char NAMES[HTTPHEADERS_PERF_MAX_HEADERS][32];
+/*lookups are made with the name in another case than it was added with, as a server would send it*/
+static char LOOKUP_NAMES[HTTPHEADERS_PERF_MAX_HEADERS][32];
+static const char* VALUE = "0123456789abcdef0123456789abcdef";
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static char g_block[HTTPHEADERS_PERF_BLOCK_SIZE];
+
+typedef struct HTTPHEADERS_PERF_CONTEXT_TAG
+{
+    HTTP_HEADERS_HANDLE headers;
+    size_t header_count;
+    size_t block_length;
+} HTTPHEADERS_PERF_CONTEXT;
+
+static HTTP_HEADERS_HANDLE create_headers(size_t header_count)
+{
+    size_t i;
+    HTTP_HEADERS_HANDLE result = HTTPHeaders_Alloc();
+    ASSERT_IS_NOT_NULL(result);
+    for (i = 0; i < header_count; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)HTTP_HEADERS_OK, (int)HTTPHeaders_AddHeaderNameValuePair(result, NAMES[i], VALUE));
+    }
+    return result;
+}
+
+static void find(void* context, size_t iteration)
+{
+    HTTPHEADERS_PERF_CONTEXT* perf_context = (HTTPHEADERS_PERF_CONTEXT*)context;
+    /*spread the lookups over all the headers, so that small collections do not only hit the first header*/
+    if (HTTPHeaders_FindHeaderValue(perf_context->headers, LOOKUP_NAMES[(iteration * 7) % perf_context->header_count]) == NULL)
+    {
+        ASSERT_FAIL("header not found");
+    }
+}
+
+/*what the httpapi adapters used to do: a copy of every header, appended to the request*/
+static void serialize_with_get_header(void* context, size_t iteration)
+{
+    HTTPHEADERS_PERF_CONTEXT* perf_context = (HTTPHEADERS_PERF_CONTEXT*)context;
+    size_t length = 0;
+    size_t i;
+    (void)iteration;
+
+    for (i = 0; i < perf_context->header_count; i++)
+    {
+        char* header;
+        size_t header_length;
+        ASSERT_ARE_EQUAL(int, (int)HTTP_HEADERS_OK, (int)HTTPHeaders_GetHeader(perf_context->headers, i, &header));
+        header_length = strlen(header);
+        (void)memcpy(g_block + length, header, header_length);
+        length += header_length;
+        g_block[length++] = '\r';
+        g_block[length++] = '\n';
+        free(header);
+    }
+
+    perf_context->block_length = length;
+}
+
+static void serialize_with_get_header_view(void* context, size_t iteration)
+{
+    HTTPHEADERS_PERF_CONTEXT* perf_context = (HTTPHEADERS_PERF_CONTEXT*)context;
+    size_t length = 0;
+    size_t i;
+    (void)iteration;
+
+    for (i = 0; i < perf_context->header_count; i++)
+    {
+        HTTP_HEADER_VIEW header;
+        ASSERT_ARE_EQUAL(int, (int)HTTP_HEADERS_OK, (int)HTTPHeaders_GetHeaderView(perf_context->headers, i, &header));
+        (void)memcpy(g_block + length, header.line, header.line_length);
+        length += header.line_length;
+        g_block[length++] = '\r';
+        g_block[length++] = '\n';
+    }
+
+    perf_context->block_length = length;
+}
+
+static PERF_MEASURE_RESULT run_find(size_t header_count)
+{
+    char name[64];
+    HTTPHEADERS_PERF_CONTEXT context;
+    PERF_MEASURE_RESULT result;
+    context.headers = create_headers(header_count);
+    context.header_count = header_count;
+    (void)sprintf(name, "HTTPHeaders_FindHeaderValue (%u headers)", (unsigned int)header_count);
+
+    result = perf_measure_run(name, find, &context, HTTPHEADERS_PERF_LOOKUP_ITERATIONS);
+
+    HTTPHeaders_Free(context.headers);
+    return result;
+}
+
+static PERF_MEASURE_RESULT run_serialize(const char* operation_name, PERF_MEASURE_OPERATION operation, size_t header_count, size_t* block_length)
+{
+    char name[96];
+    HTTPHEADERS_PERF_CONTEXT context;
+    PERF_MEASURE_RESULT result;
+    context.headers = create_headers(header_count);
+    context.header_count = header_count;
+    context.block_length = 0;
+    (void)sprintf(name, "serialize %u headers with %s", (unsigned int)header_count, operation_name);
+
+    result = perf_measure_run(name, operation, &context, HTTPHEADERS_PERF_SERIALIZE_ITERATIONS / header_count);
+
+    HTTPHeaders_Free(context.headers);
+    *block_length = context.block_length;
+    return result;
+}
+
+BEGIN_TEST_SUITE(httpheaders_perf)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    size_t i;
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    for (i = 0; i < HTTPHEADERS_PERF_MAX_HEADERS; i++)
+    {
+        (void)sprintf(NAMES[i], "X-Perf-Header-%04u", (unsigned int)i);
+        (void)sprintf(LOOKUP_NAMES[i], "x-perf-header-%04u", (unsigned int)i);
+    }
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+TEST_FUNCTION(HTTPHeaders_FindHeaderValue_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result8 = run_find(8);
+    PERF_MEASURE_RESULT result32 = run_find(32);
+    PERF_MEASURE_RESULT result256 = run_find(256);
+
+    ///assert
+    ASSERT_IS_TRUE(result8.allocations_per_op == 0.0);
+    ASSERT_IS_TRUE(result32.allocations_per_op == 0.0);
+    ASSERT_IS_TRUE(result256.allocations_per_op == 0.0);
+}
+
+TEST_FUNCTION(HTTPHeaders_GetHeader_serialize_perf)
+{
+    ///arrange
+    size_t block_length;
+
+    ///act
+    PERF_MEASURE_RESULT result = run_serialize("HTTPHeaders_GetHeader", serialize_with_get_header, 32, &block_length);
+
+    ///assert
+    ASSERT_IS_TRUE(result.allocations_per_op == 32.0);
+    ASSERT_ARE_EQUAL(size_t, 32 * (18 + 2 + 32 + 2), block_length);
+}
+
+TEST_FUNCTION(HTTPHeaders_GetHeaderView_serialize_perf)
+{
+    ///act
+    size_t block_length8;
+    size_t block_length32;
+    size_t block_length256;
+    PERF_MEASURE_RESULT result8 = run_serialize("HTTPHeaders_GetHeaderView", serialize_with_get_header_view, 8, &block_length8);
+    PERF_MEASURE_RESULT result32 = run_serialize("HTTPHeaders_GetHeaderView", serialize_with_get_header_view, 32, &block_length32);
+    PERF_MEASURE_RESULT result256 = run_serialize("HTTPHeaders_GetHeaderView", serialize_with_get_header_view, 256, &block_length256);
+
+    ///assert
+    ASSERT_IS_TRUE(result8.allocations_per_op == 0.0);
+    ASSERT_IS_TRUE(result32.allocations_per_op == 0.0);
+    ASSERT_IS_TRUE(result256.allocations_per_op == 0.0);
+    /*"X-Perf-Header-0000: " + value + CRLF*/
+    ASSERT_ARE_EQUAL(size_t, 8 * (18 + 2 + 32 + 2), block_length8);
+    ASSERT_ARE_EQUAL(size_t, 32 * (18 + 2 + 32 + 2), block_length32);
+    ASSERT_ARE_EQUAL(size_t, 256 * (18 + 2 + 32 + 2), block_length256);
+    ASSERT_ARE_EQUAL(int, 0, memcmp("X-Perf-Header-0000: 0123456789abcdef0123456789abcdef\r\n", g_block, 54));
+}
+
+END_TEST_SUITE(httpheaders_perf)
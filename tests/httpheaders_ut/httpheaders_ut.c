@@ -3,9 +3,11 @@
 
 #ifdef __cplusplus
 #include <cstdlib>
+#include <cstdio>
 #include <climits>
 #else
 #include <stdlib.h>
+#include <stdio.h>
 #include <limits.h>
 #endif
 
@@ -72,25 +74,6 @@ void my_gballoc_free(void* ptr)
 
 #define ENABLE_MOCKS
 
-#include "azure_c_shared_utility/map.h"
-
-MAP_HANDLE my_Map_Create(MAP_FILTER_CALLBACK mapFilterFunc)
-{
-    (void)mapFilterFunc;
-    return (MAP_HANDLE)malloc(1);
-}
-
-MAP_HANDLE my_Map_Clone(MAP_HANDLE handle)
-{
-    (void)handle;
-    return (MAP_HANDLE)malloc(1);
-}
-
-void my_Map_Destroy(MAP_HANDLE handle)
-{
-    free(handle);
-}
-
 #include "azure_c_shared_utility/gballoc.h"
 
 #undef ENABLE_MOCKS
@@ -105,24 +88,17 @@ static TEST_MUTEX_HANDLE g_testByTest;
 TEST_DEFINE_ENUM_TYPE(HTTP_HEADERS_RESULT, HTTP_HEADERS_RESULT_VALUES);
 IMPLEMENT_UMOCK_C_ENUM_TYPE(HTTP_HEADERS_RESULT, HTTP_HEADERS_RESULT_VALUES);
 
-IMPLEMENT_UMOCK_C_ENUM_TYPE(MAP_RESULT, MAP_RESULT_VALUES);
-
 /*test assets*/
 #define NAME1 "name1"
 #define VALUE1 "value1"
 #define HEADER1 NAME1 ": " VALUE1
-static const char *NAME1_TRICK1 = "name1:";
-static const char *NAME1_TRICK2 = "name1: ";
-static const char *NAME1_TRICK3 = "name1: value1";
 
 #define NAME2 "name2"
 #define VALUE2 "value2"
 #define HEADER2 NAME2 ": " VALUE2
 
-#define TEMP_BUFFER_SIZE 1024
-static char tempBuffer[TEMP_BUFFER_SIZE];
-
-#define MAX_NAME_VALUE_PAIR 100
+/*more than a collection has room for when it is first made*/
+#define MANY_HEADERS 100
 
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 
@@ -131,6 +107,15 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
     ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
 }
 
+/*the calls made when the first header of a collection is added: the header, the array of headers and the index*/
+static void setup_first_header_add_expectations(void)
+{
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_realloc(NULL, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(NULL));
+}
+
 BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
 
     TEST_SUITE_INITIALIZE(TestClassInitialize)
@@ -145,17 +130,6 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         result = umocktypes_charptr_register_types();
         ASSERT_ARE_EQUAL(int, 0, result);
 
-        REGISTER_TYPE(MAP_RESULT, MAP_RESULT);
-        REGISTER_UMOCK_ALIAS_TYPE(MAP_FILTER_CALLBACK, void*);
-        REGISTER_UMOCK_ALIAS_TYPE(MAP_HANDLE, void*);
-
-        REGISTER_GLOBAL_MOCK_HOOK(Map_Create, my_Map_Create);
-        REGISTER_GLOBAL_MOCK_HOOK(Map_Clone, my_Map_Clone);
-        REGISTER_GLOBAL_MOCK_HOOK(Map_Destroy, my_Map_Destroy);
-        REGISTER_GLOBAL_MOCK_RETURN(Map_AddOrUpdate, MAP_OK);
-        REGISTER_GLOBAL_MOCK_RETURN(Map_GetValueFromKey, VALUE1);
-        REGISTER_GLOBAL_MOCK_RETURN(Map_GetInternals, MAP_OK);
-
         REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
         REGISTER_GLOBAL_MOCK_HOOK(gballoc_realloc, my_gballoc_realloc);
         REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
@@ -195,10 +169,7 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     {
         ///arrange
         HTTP_HEADERS_HANDLE handle;
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(Map_Create(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
 
         ///act
         handle = HTTPHeaders_Alloc();
@@ -218,8 +189,7 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         ///arrange
         HTTP_HEADERS_HANDLE httpHandle;
         whenShallmalloc_fail = currentmalloc_call + 1;
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
 
         ///act
         httpHandle = HTTPHeaders_Alloc();
@@ -249,10 +219,9 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         HTTP_HEADERS_HANDLE handle = HTTPHeaders_Alloc();
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_Destroy(IGNORED_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_free(NULL));
+        STRICT_EXPECTED_CALL(gballoc_free(NULL));
+        STRICT_EXPECTED_CALL(gballoc_free(handle));
 
         ///act
         HTTPHeaders_Free(handle);
@@ -261,25 +230,25 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     }
 
-
-    /*Tests_SRS_HTTP_HEADERS_99_003:[ The function shall return NULL when the function cannot execute properly]*/
-    TEST_FUNCTION(HTTPHeaders_Alloc_fails_when_Map_Create_fails)
+    /*Tests_SRS_HTTP_HEADERS_99_005:[ Calling this API shall de-allocate the data structures allocated by previous API calls to the same handle.]*/
+    TEST_FUNCTION(HTTPHeaders_Free_frees_every_header)
     {
         ///arrange
-        HTTP_HEADERS_HANDLE httpHandle;
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(Map_Create(IGNORED_ARG))
-            .SetReturn(NULL);
+        HTTP_HEADERS_HANDLE handle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(handle, NAME1, VALUE1);
+        (void)HTTPHeaders_AddHeaderNameValuePair(handle, NAME2, VALUE2);
+        umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_free(handle));
 
         ///act
-        httpHandle = HTTPHeaders_Alloc();
+        HTTPHeaders_Free(handle);
 
         ///assert
-        ASSERT_IS_NULL(httpHandle);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     }
 
@@ -290,12 +259,8 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         HTTP_HEADERS_RESULT res;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         size_t nHeaders;
-        size_t zero = 0;
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-            .CopyOutArgumentBuffer(4, &zero, sizeof(zero));
-
         ///act
         res = HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
 
@@ -317,12 +282,7 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist*/
-
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_ARG, NAME1, VALUE1))
-            .IgnoreArgument(1);
+        setup_first_header_add_expectations();
 
         ///act
         res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
@@ -330,29 +290,50 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         ///assert
         ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        //checking content
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1, HTTPHeaders_FindHeaderValue(httpHandle, NAME1));
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
     }
 
-    /*Codes_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
-    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_fails_when_Map_AddOrUpdate_fails)
+    /*Tests_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
+    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_fails_when_malloc_of_the_header_fails)
     {
         ///arrange
         HTTP_HEADERS_RESULT res;
+        size_t nHeaders;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist*/
+        whenShallmalloc_fail = currentmalloc_call + 1;
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+
+        ///act
+        res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
 
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ALLOC_FAILED, res);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        (void)HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
+        ASSERT_ARE_EQUAL(size_t, 0, nHeaders);
 
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_ARG, NAME1, VALUE1))
-            .IgnoreArgument(1)
-            .SetReturn(MAP_ERROR);
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
+    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_fails_when_realloc_of_the_headers_fails)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res;
+        size_t nHeaders;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+        whenShallrealloc_fail = currentrealloc_call + 1;
+        STRICT_EXPECTED_CALL(gballoc_realloc(NULL, IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
 
         ///act
         res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
@@ -360,8 +341,36 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         ///assert
         ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ALLOC_FAILED, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        (void)HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
+        ASSERT_ARE_EQUAL(size_t, 0, nHeaders);
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
+    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_fails_when_malloc_of_the_index_fails)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res;
+        size_t nHeaders;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        umock_c_reset_all_calls();
 
-        //checking content
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_realloc(NULL, IGNORED_ARG));
+        whenShallmalloc_fail = currentmalloc_call + 2;
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+
+        ///act
+        res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ALLOC_FAILED, res);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        (void)HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
+        ASSERT_ARE_EQUAL(size_t, 0, nHeaders);
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
@@ -372,15 +381,11 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     {
         ///arrange
         HTTP_HEADERS_RESULT res;
+        char* header;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist*/
-
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_ARG, NAME1, VALUE1))
-            .IgnoreArgument(1);
+        setup_first_header_add_expectations();
 
         ///act
         res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
@@ -388,15 +393,14 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         ///assert
         ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        //checking content
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, HTTPHeaders_GetHeader(httpHandle, 0, &header));
+        ASSERT_ARE_EQUAL(char_ptr, HEADER1, header);
 
         ///cleanup
+        free(header);
         HTTPHeaders_Free(httpHandle);
     }
 
-
-
     /*Tests_SRS_HTTP_HEADERS_99_014:[ The function shall return when the handle is not valid or when name parameter is NULL or when value parameter is NULL.]*/
     TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_with_NULL_handle_fails)
     {
@@ -453,25 +457,13 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     {
         ///arrange
         HTTP_HEADERS_RESULT res;
+        size_t nHeaders;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn(VALUE1);
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_ARG, NAME1, VALUE1 ", " VALUE1))
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
 
         ///act
         res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
@@ -479,104 +471,97 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         ///assert
         ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1 ", " VALUE1, HTTPHeaders_FindHeaderValue(httpHandle, NAME1));
+        (void)HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
+        ASSERT_ARE_EQUAL(size_t, 1, nHeaders);
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
     }
 
     /*Tests_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
-    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_with_same_Name_appends_fails_when_Map_AddOrUpdate_fails)
+    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_with_same_Name_fails_when_gballoc_fails)
     {
         ///arrange
         HTTP_HEADERS_RESULT res;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn(VALUE1);
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_ARG, NAME1, VALUE1 ", " VALUE1))
-            .IgnoreArgument(1)
-            .SetReturn(MAP_ERROR);
-
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-            .IgnoreArgument(1);
+        whenShallmalloc_fail = currentmalloc_call + 1;
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
 
         ///act
         res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
 
         ///assert
-        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ERROR, res);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ALLOC_FAILED, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        /*the header is left as it was*/
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1, HTTPHeaders_FindHeaderValue(httpHandle, NAME1));
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
     }
 
-    /*Tests_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
-    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_with_same_Name_fails_when_gballoc_fails)
+    /*Tests_SRS_HTTP_HEADERS_99_012:[ Calling this API shall record a header from name and value parameters.]*/
+    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_add_two_headers_produces_two_headers)
     {
         ///arrange
         HTTP_HEADERS_RESULT res;
+        size_t nHeaders;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn(VALUE1);
-
-        whenShallmalloc_fail = currentmalloc_call + 1;
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
-            .IgnoreArgument(1);
+        /*there is room for the second header already*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
 
         ///act
-        res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME2, VALUE2);
 
         ///assert
-        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ALLOC_FAILED, res);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        (void)HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
+        ASSERT_ARE_EQUAL(size_t, 2, nHeaders);
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
     }
 
     /*Tests_SRS_HTTP_HEADERS_99_012:[ Calling this API shall record a header from name and value parameters.]*/
-    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_add_two_headers_produces_two_headers)
+    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_many_headers_keeps_all_of_them_in_order)
     {
         ///arrange
-        HTTP_HEADERS_RESULT res;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
-        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME2))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
-
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_ARG, NAME2, VALUE2))
-            .IgnoreArgument(1);
+        size_t nHeaders;
+        size_t i;
 
         ///act
-        res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME2, VALUE2);
+        for (i = 0; i < MANY_HEADERS; i++)
+        {
+            char name[32];
+            char value[32];
+            (void)sprintf(name, "name%u", (unsigned int)i);
+            (void)sprintf(value, "value%u", (unsigned int)i);
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, HTTPHeaders_AddHeaderNameValuePair(httpHandle, name, value));
+        }
 
         ///assert
-        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        (void)HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
+        ASSERT_ARE_EQUAL(size_t, MANY_HEADERS, nHeaders);
+        for (i = 0; i < MANY_HEADERS; i++)
+        {
+            char name[32];
+            char value[32];
+            HTTP_HEADER_VIEW header;
+            (void)sprintf(name, "name%u", (unsigned int)i);
+            (void)sprintf(value, "value%u", (unsigned int)i);
+            ASSERT_ARE_EQUAL(char_ptr, value, HTTPHeaders_FindHeaderValue(httpHandle, name));
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, HTTPHeaders_GetHeaderView(httpHandle, i, &header));
+            ASSERT_ARE_EQUAL(char_ptr, name, header.name);
+        }
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
@@ -587,19 +572,12 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     {
         ///arrange
         HTTP_HEADERS_RESULT result;
+        size_t nHeaders;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, "ab"))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, "ab", VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, "a"))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
-
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_ARG, "a", VALUE1))
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
 
         ///act
         result = HTTPHeaders_AddHeaderNameValuePair(httpHandle, "a", VALUE1);
@@ -607,8 +585,41 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         ///assert
         ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        (void)HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
+        ASSERT_ARE_EQUAL(size_t, 2, nHeaders);
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_040: [ Header names shall be compared without regard to case. ]*/
+    /*Tests_SRS_HTTP_HEADERS_99_041: [ A header that exists keeps the name it was first added with. ]*/
+    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_with_same_Name_in_other_case_appends_to_existing_value)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res;
+        size_t nHeaders;
+        char* header;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, "Content-Type", "text/plain");
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+
+        ///act
+        res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, "content-TYPE", "charset=utf-8");
+
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        (void)HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
+        ASSERT_ARE_EQUAL(size_t, 1, nHeaders);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, HTTPHeaders_GetHeader(httpHandle, 0, &header));
+        ASSERT_ARE_EQUAL(char_ptr, "Content-Type: text/plain, charset=utf-8", header);
 
         ///cleanup
+        free(header);
         HTTPHeaders_Free(httpHandle);
     }
 
@@ -651,15 +662,9 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         ///arrange
         const char* res1;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1);
-
         ///act
         res1 = HTTPHeaders_FindHeaderValue(httpHandle, NAME1);
 
@@ -679,23 +684,10 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         const char* res1;
         const char* res2;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME2))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME2, VALUE2);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn(VALUE1);
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME2))
-            .IgnoreArgument(1)
-            .SetReturn(VALUE2);
-
         ///act
         res1 = HTTPHeaders_FindHeaderValue(httpHandle, NAME1);
         res2 = HTTPHeaders_FindHeaderValue(httpHandle, NAME2);
@@ -713,95 +705,81 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     /*Tests_SRS_HTTP_HEADERS_99_021:[ In this case the return value shall point to a string that shall strcmp equal to the original stored string.]*/
     TEST_FUNCTION(HTTPHeaders_FindHeaderValue_retrieves_concatenation_of_previously_stored_values_for_header_name_succeeds)
     {
+        ///arrange
         const char* res;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn(VALUE1); /*this key exists, was added above*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE2);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn(VALUE1 ", " VALUE2);
-
         ///act
         res = HTTPHeaders_FindHeaderValue(httpHandle, NAME1);
 
         ///assert
-        ASSERT_ARE_EQUAL(char_ptr,VALUE1 ", " VALUE2, res);
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1 ", " VALUE2, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
     }
 
-    /*Tests_SRS_HTTP_HEADERS_99_020:[ The return value shall be different than NULL when the name matches the name of a previously stored name:value pair.]*/
-    /*actually we are trying to see that finding a nonexisting value produces NULL*/
-    TEST_FUNCTION(HTTPHeaders_FindHeaderValue_returns_NULL_for_nonexistent_value)
+    /*Tests_SRS_HTTP_HEADERS_99_040: [ Header names shall be compared without regard to case. ]*/
+    TEST_FUNCTION(HTTPHeaders_FindHeaderValue_finds_the_name_in_any_case)
     {
         ///arrange
+        const char* res1;
         const char* res2;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
-        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, "Content-Length", "42");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME2))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL);
+        ///act
+        res1 = HTTPHeaders_FindHeaderValue(httpHandle, "content-length");
+        res2 = HTTPHeaders_FindHeaderValue(httpHandle, "CONTENT-LENGTH");
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, "42", res1);
+        ASSERT_ARE_EQUAL(char_ptr, "42", res2);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_020:[ The return value shall be different than NULL when the name matches the name of a previously stored name:value pair.]*/
+    TEST_FUNCTION(HTTPHeaders_FindHeaderValue_returns_NULL_for_nonexistent_value)
+    {
+        ///arrange
+        const char* res;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        umock_c_reset_all_calls();
 
         ///act
-        res2 = HTTPHeaders_FindHeaderValue(httpHandle, NAME2);
+        res = HTTPHeaders_FindHeaderValue(httpHandle, NAME1);
 
         ///assert
-        ASSERT_IS_NULL(res2);
+        ASSERT_IS_NULL(res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
     }
 
-    /*trying to catch some errors here*/
     /*Tests_SRS_HTTP_HEADERS_99_020:[ The return value shall be different than NULL when the name matches the name of a previously stored name:value pair.]*/
     TEST_FUNCTION(HTTPHeaders_FindHeaderValue_with_nonexistent_header_succeeds)
     {
         ///arrange
-        const char* res1;
-        const char* res2;
-        const char* res3;
+        const char* res;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, "ab", VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1_TRICK1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL);
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1_TRICK2))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL);
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1_TRICK3))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL);
-
         ///act
-        res1 = HTTPHeaders_FindHeaderValue(httpHandle, NAME1_TRICK1);
-        res2 = HTTPHeaders_FindHeaderValue(httpHandle, NAME1_TRICK2);
-        res3 = HTTPHeaders_FindHeaderValue(httpHandle, NAME1_TRICK3);
+        res = HTTPHeaders_FindHeaderValue(httpHandle, "a");
 
         ///assert
-        ASSERT_IS_NULL(res1);
-        ASSERT_IS_NULL(res2);
-        ASSERT_IS_NULL(res3);
+        ASSERT_IS_NULL(res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
@@ -813,19 +791,13 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     {
         ///arrange
         HTTP_HEADERS_RESULT res;
+        size_t nHeaders;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn(VALUE1); /*this key does not exist, the line below is adding it*/
-
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_ARG, NAME1, VALUE2))
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
 
         ///act
         res = HTTPHeaders_ReplaceHeaderNameValuePair(httpHandle, NAME1, VALUE2);
@@ -833,6 +805,9 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         ///assert
         ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, VALUE2, HTTPHeaders_FindHeaderValue(httpHandle, NAME1));
+        (void)HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
+        ASSERT_ARE_EQUAL(size_t, 1, nHeaders);
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
@@ -846,21 +821,41 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL);
-
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_ARG, NAME1, VALUE2))
-            .IgnoreArgument(1);
+        setup_first_header_add_expectations();
 
         ///act
-        res = HTTPHeaders_ReplaceHeaderNameValuePair(httpHandle, NAME1, VALUE2);
+        res = HTTPHeaders_ReplaceHeaderNameValuePair(httpHandle, NAME1, VALUE1);
 
         ///assert
         ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1, HTTPHeaders_FindHeaderValue(httpHandle, NAME1));
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_040: [ Header names shall be compared without regard to case. ]*/
+    /*Tests_SRS_HTTP_HEADERS_99_041: [ A header that exists keeps the name it was first added with. ]*/
+    TEST_FUNCTION(HTTPHeaders_ReplaceHeaderNameValuePair_with_same_Name_in_other_case_replaces_the_value)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res;
+        char* header;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, "Authorization", "old");
+        umock_c_reset_all_calls();
+
+        ///act
+        res = HTTPHeaders_ReplaceHeaderNameValuePair(httpHandle, "AUTHORIZATION", "new");
+
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, HTTPHeaders_GetHeader(httpHandle, 0, &header));
+        ASSERT_ARE_EQUAL(char_ptr, "Authorization: new", header);
 
         ///cleanup
+        free(header);
         HTTPHeaders_Free(httpHandle);
     }
 
@@ -868,14 +863,13 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     TEST_FUNCTION(HTTPHeaders_GetHeaderCount_with_NULL_handle_fails)
     {
         ///arrange
-        HTTP_HEADERS_RESULT res1;
         size_t nHeaders;
 
         ///act
-        res1 = HTTPHeaders_GetHeaderCount(NULL, &nHeaders);
+        HTTP_HEADERS_RESULT res = HTTPHeaders_GetHeaderCount(NULL, &nHeaders);
 
         ///assert
-        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res1);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     }
 
@@ -883,15 +877,15 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     TEST_FUNCTION(HTTPHeaders_GetHeaderCount_with_NULL_headersCount_fails)
     {
         ///arrange
-        HTTP_HEADERS_RESULT res1;
+        HTTP_HEADERS_RESULT res;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         umock_c_reset_all_calls();
 
         ///act
-        res1 = HTTPHeaders_GetHeaderCount(httpHandle, NULL);
+        res = HTTPHeaders_GetHeaderCount(httpHandle, NULL);
 
         ///assert
-        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res1);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
@@ -900,63 +894,23 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
 
     /*Tests_SRS_HTTP_HEADERS_99_026:[ The function shall write in *headersCount the number of currently stored headers and shall return HTTP_HEADERS_OK]*/
     /*Tests_SRS_HTTP_HEADERS_99_023:[ Calling this API shall provide the number of stored headers.]*/
-    /*Tests_SRS_HTTP_HEADERS_99_016:[ The function shall store the name:value pair in such a way that when later retrieved by a call to GetHeader it will return a string that shall strcmp equal to the name+": "+value.]*/
     TEST_FUNCTION(HTTPHeaders_GetHeaderCount_with_1_header_produces_1)
     {
         ///arrange
-        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        size_t nHeaders;
-        const char* keys[] = { "NAME1" };
-        const char* values[] = { "VALUE1" };
-        const char* const ** pKeys = (const char* const **)&keys;
-        const char* const ** pValues = (const char* const **)&values;
-        const size_t one = 1;
         HTTP_HEADERS_RESULT res;
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
+        size_t nHeaders;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-            .IgnoreArgument(1)
-            .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
-            .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
-            .CopyOutArgumentBuffer(4, &one, sizeof(one));
-
-
         ///act
         res = HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
 
         ///assert
         ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
-        ASSERT_ARE_EQUAL(size_t, (size_t)1, nHeaders);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        HTTPHeaders_Free(httpHandle);
-    }
-
-    /*Tests_SRS_HTTP_HEADERS_99_037:[ The function shall return HTTP_HEADERS_ERROR when an internal error occurs.]*/
-    TEST_FUNCTION(HTTPHeaders_GetHeaderCount_fails_when_Map_GetInternals_fails)
-    {
-        ///arrange
-        HTTP_HEADERS_RESULT res;
-        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        size_t nHeaders;
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-            .SetReturn(MAP_ERROR);
-
-        ///act
-        res = HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
-
-        ///assert
-        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ERROR, res);
+        ASSERT_ARE_EQUAL(size_t, 1, nHeaders);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-
         ///cleanup
         HTTPHeaders_Free(httpHandle);
     }
@@ -967,31 +921,12 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     {
         ///arrange
         HTTP_HEADERS_RESULT res;
-        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         size_t nHeaders;
-        const char* keys[2] = { "NAME1", "NAME2" };
-        const char* values[2] = { "VALUE1", "VALUE2" };
-        const char* const ** pKeys = (const char* const **)&keys;
-        const char* const ** pValues = (const char* const **)&values;
-
-        const size_t two = 2;
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME2))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME2, VALUE2);
         umock_c_reset_all_calls();
 
-
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-            .IgnoreArgument(1)
-            .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
-            .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
-            .CopyOutArgumentBuffer(4, &two, sizeof(two));
-
         ///act
         res = HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
 
@@ -1024,9 +959,6 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         ///arrange
         HTTP_HEADERS_RESULT res;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
@@ -1047,18 +979,10 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     {
         ///arrange
         HTTP_HEADERS_RESULT res1;
-        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         char* headerValue;
-        const char* thisIsNULL = NULL;
-        const char* zero = 0;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-            .IgnoreArgument(1)
-            .CopyOutArgumentBuffer(2, &thisIsNULL, sizeof(thisIsNULL))
-            .CopyOutArgumentBuffer(3, &thisIsNULL, sizeof(thisIsNULL))
-            .CopyOutArgumentBuffer(4, &zero, sizeof(zero));
-
         ///act
         res1 = HTTPHeaders_GetHeader(httpHandle, 0, &headerValue);
 
@@ -1076,25 +1000,11 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     {
         ///arrange
         HTTP_HEADERS_RESULT res1;
-        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        const char* keys[1] = { "NAME1" };
-        const char* values[1] = { "VALUE1" };
-        const char* const ** pKeys = (const char* const **)&keys;
-        const char* const ** pValues = (const char* const **)&values;
-        const size_t one = 1;
         char* headerValue;
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-            .IgnoreArgument(1)
-            .CopyOutArgumentBuffer(2, pKeys, sizeof(pKeys))
-            .CopyOutArgumentBuffer(3, pValues, sizeof(pValues))
-            .CopyOutArgumentBuffer(4, &one, sizeof(one));
-
         ///act
         res1 = HTTPHeaders_GetHeader(httpHandle, 1, &headerValue);
 
@@ -1114,25 +1024,10 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         HTTP_HEADERS_RESULT res1;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         char* headerValue;
-        const char* keys[1] = { "a" };
-        const char** pKeys = &keys[0];
-        const char* values[1] = { "b" };
-        const char** pValues = &values[0];
-        const size_t one = 1;
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, "a"))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, "a", "b");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-            .IgnoreArgument(1)
-            .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
-            .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
-            .CopyOutArgumentBuffer(4, &one, sizeof(one));
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
 
         ///act
         res1 = HTTPHeaders_GetHeader(httpHandle, 0, &headerValue);
@@ -1147,80 +1042,172 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         free(headerValue);
     }
 
+    /*Tests_SRS_HTTP_HEADERS_99_027:[ Calling this API shall produce the string value+": "+pair) for the index header in the buffer pointed to by buffer.]*/
+    TEST_FUNCTION(HTTPHeaders_GetHeader_returns_the_headers_in_the_order_they_were_added)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res1;
+        HTTP_HEADERS_RESULT res2;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        char* header1;
+        char* header2;
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME2, VALUE2);
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        umock_c_reset_all_calls();
+
+        ///act
+        res1 = HTTPHeaders_GetHeader(httpHandle, 0, &header2);
+        res2 = HTTPHeaders_GetHeader(httpHandle, 1, &header1);
+
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res1);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res2);
+        ASSERT_ARE_EQUAL(char_ptr, HEADER2, header2);
+        ASSERT_ARE_EQUAL(char_ptr, HEADER1, header1);
+
+        ///cleanup
+        free(header1);
+        free(header2);
+        HTTPHeaders_Free(httpHandle);
+    }
+
     /*Tests_SRS_HTTP_HEADERS_99_034:[ The function shall return HTTP_HEADERS_ERROR when an internal error occurs]*/
-    TEST_FUNCTION(HTTPHeaders_GetHeader_fails_when_Map_GetInternals_fails)
+    TEST_FUNCTION(HTTPHeaders_GetHeader_succeeds_fails_when_malloc_fails)
     {
         ///arrange
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         char* headerValue;
-        const char* keys[1] = { "a" };
-        const char** pKeys = &keys[0];
-        const char* values[1] = { "b" };
-        const char** pValues = &values[0];
-        const size_t one = 1;
         HTTP_HEADERS_RESULT res1;
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, "a"))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, "a", "b");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-            .IgnoreArgument(1)
-            .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
-            .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
-            .CopyOutArgumentBuffer(4, &one, sizeof(one))
-            .SetReturn(MAP_ERROR);
+        whenShallmalloc_fail = currentmalloc_call + 1;
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
 
         ///act
         res1 = HTTPHeaders_GetHeader(httpHandle, 0, &headerValue);
 
         ///assert
         ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ERROR, res1);
+        ASSERT_IS_NULL(headerValue);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
     }
 
-    /*Tests_SRS_HTTP_HEADERS_99_034:[ The function shall return HTTP_HEADERS_ERROR when an internal error occurs]*/
-    TEST_FUNCTION(HTTPHeaders_GetHeader_succeeds_fails_when_malloc_fails)
+    /*Tests_SRS_HTTP_HEADERS_99_042: [ If handle or header is NULL, HTTPHeaders_GetHeaderView shall return HTTP_HEADERS_INVALID_ARG. ]*/
+    TEST_FUNCTION(HTTPHeaders_GetHeaderView_with_NULL_handle_fails)
     {
         ///arrange
+        HTTP_HEADER_VIEW header;
+
+        ///act
+        HTTP_HEADERS_RESULT res = HTTPHeaders_GetHeaderView(NULL, 0, &header);
+
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_042: [ If handle or header is NULL, HTTPHeaders_GetHeaderView shall return HTTP_HEADERS_INVALID_ARG. ]*/
+    TEST_FUNCTION(HTTPHeaders_GetHeaderView_with_NULL_header_fails)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        char* headerValue;
-        const char* keys[1] = { "a" };
-        const char** pKeys = &keys[0];
-        const char* values[1] = { "b" };
-        const char** pValues = &values[0];
-        const size_t one = 1;
-        HTTP_HEADERS_RESULT res1;
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, "a"))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
-        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, "a", "b");
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-            .IgnoreArgument(1)
-            .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
-            .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
-            .CopyOutArgumentBuffer(4, &one, sizeof(one));
+        ///act
+        res = HTTPHeaders_GetHeaderView(httpHandle, 0, NULL);
 
-        whenShallmalloc_fail = currentmalloc_call + 1;
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
-            .IgnoreArgument(1);
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_043: [ If index is not lower than the number of headers, HTTPHeaders_GetHeaderView shall return HTTP_HEADERS_INVALID_ARG. ]*/
+    TEST_FUNCTION(HTTPHeaders_GetHeaderView_with_index_too_big_fails)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res;
+        HTTP_HEADER_VIEW header;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        umock_c_reset_all_calls();
 
         ///act
-        res1 = HTTPHeaders_GetHeader(httpHandle, 0, &headerValue);
+        res = HTTPHeaders_GetHeaderView(httpHandle, 1, &header);
 
         ///assert
-        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ERROR, res1);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
-        free(headerValue);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_044: [ Otherwise HTTPHeaders_GetHeaderView shall fill header with pointers to the name, the value and the name+": "+value string of the header at index, without allocating, and return HTTP_HEADERS_OK. ]*/
+    TEST_FUNCTION(HTTPHeaders_GetHeaderView_succeeds_without_allocating)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res1;
+        HTTP_HEADERS_RESULT res2;
+        HTTP_HEADER_VIEW header1;
+        HTTP_HEADER_VIEW header2;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME2, VALUE2);
+        umock_c_reset_all_calls();
+
+        ///act
+        res1 = HTTPHeaders_GetHeaderView(httpHandle, 0, &header1);
+        res2 = HTTPHeaders_GetHeaderView(httpHandle, 1, &header2);
+
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res1);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res2);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, NAME1, header1.name);
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1, header1.value);
+        ASSERT_ARE_EQUAL(char_ptr, HEADER1, header1.line);
+        ASSERT_ARE_EQUAL(size_t, sizeof(HEADER1) - 1, header1.line_length);
+        ASSERT_ARE_EQUAL(char_ptr, NAME2, header2.name);
+        ASSERT_ARE_EQUAL(char_ptr, VALUE2, header2.value);
+        ASSERT_ARE_EQUAL(char_ptr, HEADER2, header2.line);
+        ASSERT_ARE_EQUAL(size_t, sizeof(HEADER2) - 1, header2.line_length);
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_044: [ Otherwise HTTPHeaders_GetHeaderView shall fill header with pointers to the name, the value and the name+": "+value string of the header at index, without allocating, and return HTTP_HEADERS_OK. ]*/
+    TEST_FUNCTION(HTTPHeaders_GetHeaderView_of_a_concatenated_header_succeeds)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res;
+        HTTP_HEADER_VIEW header;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE2);
+        umock_c_reset_all_calls();
+
+        ///act
+        res = HTTPHeaders_GetHeaderView(httpHandle, 0, &header);
+
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
+        ASSERT_ARE_EQUAL(char_ptr, NAME1, header.name);
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1 ", " VALUE2, header.value);
+        ASSERT_ARE_EQUAL(char_ptr, NAME1 ": " VALUE1 ", " VALUE2, header.line);
+        ASSERT_ARE_EQUAL(size_t, sizeof(NAME1 ": " VALUE1 ", " VALUE2) - 1, header.line_length);
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
     }
 
     /*Tests_SRS_HTTP_HEADERS_99_031:[ If name contains the character ":" then the return value shall be HTTP_HEADERS_INVALID_ARG.]*/
@@ -1246,28 +1233,13 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_with_colon_in_value_succeeds_1)
     {
         ///arrange
-        const char* keys[1] = { "a" };
-        const char** pKeys = &keys[0];
-        const char* values[1] = { ":" };
-        const char** pValues = &values[0];
-        const size_t one = 1;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         char* headerValue;
         HTTP_HEADERS_RESULT res1;
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, "a"))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, "a", ":");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-            .IgnoreArgument(1)
-            .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
-            .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
-            .CopyOutArgumentBuffer(4, &one, sizeof(one));
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
 
         ///act
         res1 = HTTPHeaders_GetHeader(httpHandle, 0, &headerValue);
@@ -1322,12 +1294,7 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist*/
-
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_ARG, NAME1, VALUE1))
-            .IgnoreArgument(1);
+        setup_first_header_add_expectations();
 
         ///act
         res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, " \r\t\n" VALUE1); /*notice how there are some LWS characters in the value*/
@@ -1335,8 +1302,7 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         ///assert
         ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        //checking content
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1, HTTPHeaders_FindHeaderValue(httpHandle, NAME1));
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
@@ -1363,10 +1329,7 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         HTTP_HEADERS_HANDLE source = HTTPHeaders_Alloc();
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(Map_Clone(IGNORED_ARG))
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
 
         ///act
         result = HTTPHeaders_Clone(source);
@@ -1380,21 +1343,89 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         HTTPHeaders_Free(result);
     }
 
+    /*Tests_SRS_HTTP_HEADERS_02_004: [Otherwise HTTPHeaders_Clone shall clone the content of handle to a new handle.*/
+    TEST_FUNCTION(HTTPHEADERS_Clone_with_headers_copies_the_headers)
+    {
+        ///arrange
+        HTTP_HEADERS_HANDLE result;
+        size_t nHeaders;
+        HTTP_HEADER_VIEW header;
+        HTTP_HEADERS_HANDLE source = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(source, NAME1, VALUE1);
+        (void)HTTPHeaders_AddHeaderNameValuePair(source, NAME2, VALUE2);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+
+        ///act
+        result = HTTPHeaders_Clone(source);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        HTTPHeaders_Free(source);
+        (void)HTTPHeaders_GetHeaderCount(result, &nHeaders);
+        ASSERT_ARE_EQUAL(size_t, 2, nHeaders);
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1, HTTPHeaders_FindHeaderValue(result, "NAME1"));
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, HTTPHeaders_GetHeaderView(result, 1, &header));
+        ASSERT_ARE_EQUAL(char_ptr, HEADER2, header.line);
+
+        ///cleanup
+        HTTPHeaders_Free(result);
+    }
+
     /*Tests_SRS_HTTP_HEADERS_02_005: [If cloning fails for any reason, then HTTPHeaders_Clone shall return NULL.] */
-    TEST_FUNCTION(HTTPHEADERS_Clone_fails_when_map_clone_fails)
+    TEST_FUNCTION(HTTPHEADERS_Clone_fails_when_malloc_of_a_header_fails)
     {
         ///arrange
         HTTP_HEADERS_HANDLE result;
         HTTP_HEADERS_HANDLE source = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(source, NAME1, VALUE1);
+        (void)HTTPHeaders_AddHeaderNameValuePair(source, NAME2, VALUE2);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(Map_Clone(IGNORED_ARG))
-            .IgnoreArgument(1).SetReturn(NULL);
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+        whenShallmalloc_fail = currentmalloc_call + 5;
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+        /*the header that was copied, the index, the headers and the clone*/
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+
+        ///act
+        result = HTTPHeaders_Clone(source);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-            .IgnoreArgument(1);
+        ///cleanup
+        HTTPHeaders_Free(source);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_02_005: [If cloning fails for any reason, then HTTPHeaders_Clone shall return NULL.] */
+    TEST_FUNCTION(HTTPHEADERS_Clone_fails_when_malloc_of_the_headers_fails)
+    {
+        ///arrange
+        HTTP_HEADERS_HANDLE result;
+        HTTP_HEADERS_HANDLE source = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(source, NAME1, VALUE1);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+        whenShallmalloc_fail = currentmalloc_call + 2;
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_free(NULL));
+        STRICT_EXPECTED_CALL(gballoc_free(NULL));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
 
         ///act
         result = HTTPHeaders_Clone(source);
@@ -1405,7 +1436,6 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
 
         ///cleanup
         HTTPHeaders_Free(source);
-        HTTPHeaders_Free(result);
     }
 
     /*Tests_SRS_HTTP_HEADERS_02_005: [If cloning fails for any reason, then HTTPHeaders_Clone shall return NULL.] */
@@ -1417,7 +1447,7 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         umock_c_reset_all_calls();
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
-            .IgnoreArgument(1).SetReturn(NULL);
+            .SetReturn(NULL);
 
         ///act
         result = HTTPHeaders_Clone(source);
@@ -1428,7 +1458,6 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
 
         ///cleanup
         HTTPHeaders_Free(source);
-        HTTPHeaders_Free(result);
     }
 
 END_TEST_SUITE(HTTPHeaders_UnitTests)
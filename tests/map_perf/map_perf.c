@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdio>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdio.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+#include "azure_c_shared_utility/map.h"
+
+#include "perf_measure.h"
+
+#define MAP_PERF_LOOKUP_ITERATIONS 1000000
+#define MAP_PERF_MAX_KEYS 4096
+
+/*property bags and device twins: keys share a long prefix, which is the worst case for strcmp*/
+static char KEYS[MAP_PERF_MAX_KEYS][32];
+static const char* VALUE = "42";
+
+static TEST_MUTEX_HANDLE g_testByTest;
+
+typedef struct MAP_PERF_CONTEXT_TAG
+{
+    MAP_HANDLE map;
+    size_t key_count;
+} MAP_PERF_CONTEXT;
+
+static MAP_HANDLE create_map(size_t key_count)
+{
+    size_t i;
+    MAP_HANDLE result = Map_Create(NULL);
+    ASSERT_IS_NOT_NULL(result);
+    for (i = 0; i < key_count; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)MAP_OK, (int)Map_Add(result, KEYS[i], VALUE));
+    }
+    return result;
+}
+
+static void lookup(void* context, size_t iteration)
+{
+    MAP_PERF_CONTEXT* perf_context = (MAP_PERF_CONTEXT*)context;
+    /*spread the lookups over all the keys, so that small maps do not only hit the first key*/
+    if (Map_GetValueFromKey(perf_context->map, KEYS[(iteration * 7) % perf_context->key_count]) == NULL)
+    {
+        ASSERT_FAIL("key not found");
+    }
+}
+
+static void insert_all_and_destroy(void* context, size_t iteration)
+{
+    MAP_PERF_CONTEXT* perf_context = (MAP_PERF_CONTEXT*)context;
+    size_t i;
+    MAP_HANDLE map = Map_Create(NULL);
+    (void)iteration;
+    for (i = 0; i < perf_context->key_count; i++)
+    {
+        (void)Map_AddOrUpdate(map, KEYS[i], VALUE);
+    }
+    Map_Destroy(map);
+}
+
+static PERF_MEASURE_RESULT run_lookup(size_t key_count)
+{
+    char name[64];
+    MAP_PERF_CONTEXT context;
+    PERF_MEASURE_RESULT result;
+    context.map = create_map(key_count);
+    context.key_count = key_count;
+    (void)sprintf(name, "Map_GetValueFromKey (%u keys)", (unsigned int)key_count);
+
+    result = perf_measure_run(name, lookup, &context, MAP_PERF_LOOKUP_ITERATIONS);
+
+    Map_Destroy(context.map);
+    return result;
+}
+
+static PERF_MEASURE_RESULT run_insert(size_t key_count)
+{
+    char name[64];
+    MAP_PERF_CONTEXT context;
+    context.map = NULL;
+    context.key_count = key_count;
+    (void)sprintf(name, "Map_Create + %u x Map_AddOrUpdate + Map_Destroy", (unsigned int)key_count);
+
+    /*same total number of inserts for every size*/
+    return perf_measure_run(name, insert_all_and_destroy, &context, (MAP_PERF_LOOKUP_ITERATIONS / 10) / key_count);
+}
+
+BEGIN_TEST_SUITE(map_perf)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    size_t i;
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    for (i = 0; i < MAP_PERF_MAX_KEYS; i++)
+    {
+        (void)sprintf(KEYS[i], "$.properties.reported.p%04u", (unsigned int)i);
+    }
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+TEST_FUNCTION(Map_GetValueFromKey_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result8 = run_lookup(8);
+    PERF_MEASURE_RESULT result64 = run_lookup(64);
+    PERF_MEASURE_RESULT result512 = run_lookup(512);
+    PERF_MEASURE_RESULT result4096 = run_lookup(4096);
+
+    ///assert
+    ASSERT_IS_TRUE(result8.allocations_per_op == 0.0);
+    ASSERT_IS_TRUE(result64.allocations_per_op == 0.0);
+    ASSERT_IS_TRUE(result512.allocations_per_op == 0.0);
+    ASSERT_IS_TRUE(result4096.allocations_per_op == 0.0);
+    /*hashed lookups do not grow with the number of keys, a linear search would be 64 times slower*/
+    ASSERT_IS_TRUE(result4096.ns_per_op < 16.0 * result64.ns_per_op);
+}
+
+TEST_FUNCTION(Map_AddOrUpdate_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result8 = run_insert(8);
+    PERF_MEASURE_RESULT result64 = run_insert(64);
+    PERF_MEASURE_RESULT result512 = run_insert(512);
+    PERF_MEASURE_RESULT result4096 = run_insert(4096);
+
+    ///assert
+    /*1 for the map, 2 per key for the copies of key and value, and the storage/index growth is logarithmic*/
+    ASSERT_IS_TRUE(result8.allocations_per_op <= 1.0 + 2.0 * 8 + 8.0);
+    ASSERT_IS_TRUE(result64.allocations_per_op <= 1.0 + 2.0 * 64 + 24.0);
+    ASSERT_IS_TRUE(result512.allocations_per_op <= 1.0 + 2.0 * 512 + 36.0);
+    ASSERT_IS_TRUE(result4096.allocations_per_op <= 1.0 + 2.0 * 4096 + 48.0);
+}
+
+END_TEST_SUITE(map_perf)
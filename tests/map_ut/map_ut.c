@@ -3,8 +3,10 @@
 
 #ifdef __cplusplus
 #include <cstdlib>
+#include <cstdio>
 #else
 #include <stdlib.h>
+#include <stdio.h>
 #endif
 
 #include "macro_utils/macro_utils.h"
@@ -172,6 +174,27 @@ static const char* TEST_BLUEVALUE = "cyan";
 static const char* TEST_GREENKEY = "testgreenkey";
 static const char* TEST_GREENVALUE = "green";
 
+/*enough keys to get past the linear search threshold of the map (8)*/
+#define TEST_MANY_KEYS_COUNT 17
+static char TEST_MANY_KEYS[TEST_MANY_KEYS_COUNT][16];
+static const char* TEST_MANY_VALUE = "v";
+
+static MAP_HANDLE createMapWithManyKeys(size_t count)
+{
+    size_t i;
+    MAP_HANDLE result = Map_Create(NULL);
+    ASSERT_IS_NOT_NULL(result);
+    for (i = 0; i < TEST_MANY_KEYS_COUNT; i++)
+    {
+        (void)sprintf(TEST_MANY_KEYS[i], "manyKey%u", (unsigned int)i);
+    }
+    for (i = 0; i < count; i++)
+    {
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(result, TEST_MANY_KEYS[i], TEST_MANY_VALUE));
+    }
+    return result;
+}
+
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 
 static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
@@ -572,11 +595,6 @@ BEGIN_TEST_SUITE(map_unittests)
         /*below are undo actions*/
         STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG)) /*undo copy of blue key*/
             .ValidateArgumentBuffer(1, TEST_BLUEKEY, strlen(TEST_BLUEKEY) + 1);
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 1 * sizeof(const char*))) /*undo growing values*/
-            .IgnoreArgument(1);
-
 
         ///act
         result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -627,12 +645,7 @@ BEGIN_TEST_SUITE(map_unittests)
         whenShallmalloc_fail = currentmalloc_call + 3;
         STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of blue key*/
 
-        /*below are undo actions*/
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 1 * sizeof(const char*))) /*undo growing values*/
-            .IgnoreArgument(1);
-
+        /*below are undo actions*/ /*none, the grown storage is kept until Map_Destroy*/
 
         ///act
         result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -681,9 +694,7 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 2 * sizeof(const char*))) /*growing values*/
             .IgnoreArgument(1);
 
-        /*below are undo actions*/
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
+        /*below are undo actions*/ /*none, the grown storage is kept until Map_Destroy*/
 
         ///act
         result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -729,7 +740,7 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 2 * sizeof(const char*))) /*growing keys*/
             .IgnoreArgument(1);
 
-        /*below are undo actions*/
+        /*below are undo actions*/ /*none, the grown storage is kept until Map_Destroy*/
 
         ///act
         result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -851,9 +862,7 @@ BEGIN_TEST_SUITE(map_unittests)
         whenShallrealloc_fail = currentrealloc_call + 2;
         STRICT_EXPECTED_CALL(gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
 
-        /*below are undo actions*/
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG)) /*undo growing keys*/
-            .IgnoreArgument(1);
+        /*below are undo actions*/ /*none, the grown storage is kept until Map_Destroy*/
 
         ///act
         result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1132,10 +1141,6 @@ BEGIN_TEST_SUITE(map_unittests)
         /*below are undo actions*/
         STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG)) /*undo blue key value*/
             .ValidateArgumentBuffer(1, TEST_BLUEKEY, strlen(TEST_BLUEKEY) + 1);
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 1 * sizeof(const char*))) /*undo growing values*/
-            .IgnoreArgument(1);
 
         ///act
         result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1180,11 +1185,7 @@ BEGIN_TEST_SUITE(map_unittests)
         whenShallmalloc_fail = currentmalloc_call + 3;
         STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of red key*/
 
-        /*below are undo actions*/
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 1 * sizeof(const char*))) /*undo growing values*/
-            .IgnoreArgument(1);
+        /*below are undo actions*/ /*none, the grown storage is kept until Map_Destroy*/
 
         ///act
         result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1228,9 +1229,7 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 2 * sizeof(const char*))) /*growing values*/
             .IgnoreArgument(1);
 
-        /*below are undo actions*/
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
+        /*below are undo actions*/ /*none, the grown storage is kept until Map_Destroy*/
 
         ///act
         result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1386,9 +1385,7 @@ BEGIN_TEST_SUITE(map_unittests)
         whenShallrealloc_fail = currentrealloc_call + 2;
         STRICT_EXPECTED_CALL(gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
 
-        /*below are undo actions*/
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG)) /*undo growing keys*/
-            .IgnoreArgument(1);
+        /*below are undo actions*/ /*none, the grown storage is kept until Map_Destroy*/
 
         ///act
         result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1419,7 +1416,7 @@ BEGIN_TEST_SUITE(map_unittests)
         whenShallrealloc_fail = currentrealloc_call + 1;
         STRICT_EXPECTED_CALL(gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
 
-        /*below are undo actions*/
+        /*below are undo actions*/ /*none, the grown storage is kept until Map_Destroy*/
 
         ///act
         result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1715,12 +1712,6 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG)) /*freeing yellow value*/
             .ValidateArgumentBuffer(1, TEST_YELLOWVALUE, strlen(TEST_YELLOWVALUE) + 1);
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 1* sizeof(const char*))) /*ungrowing values*/
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 1 * sizeof(const char*))) /*ungrowing keys*/
-            .IgnoreArgument(1);
-
         ///act
         result1 = Map_Delete(handle, TEST_YELLOWKEY);
         result3 = Map_GetInternals(handle, &keys, &values, &count);
@@ -1758,12 +1749,6 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG)) /*freeing yellow value*/
             .ValidateArgumentBuffer(1, TEST_REDVALUE, strlen(TEST_REDVALUE) + 1);
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 1 * sizeof(const char*))) /*ungrowing values*/
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 1 * sizeof(const char*))) /*ungrowing keys*/
-            .IgnoreArgument(1);
-
         ///act
         result1 = Map_Delete(handle, TEST_REDKEY);
         result3 = Map_GetInternals(handle, &keys, &values, &count);
@@ -1780,6 +1765,229 @@ BEGIN_TEST_SUITE(map_unittests)
         Map_Destroy(handle);
     }
 
+    /*Tests_SRS_MAP_07_013: [Map_Delete shall not shrink the storage for keys and values, unless the map becomes empty, in which case the storage and the hash index shall be freed.] */
+    TEST_FUNCTION(Map_Delete_then_Add_does_not_reallocate)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        MAP_RESULT result1;
+        MAP_RESULT result2;
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        (void)Map_Add(handle, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG)) /*freeing yellow key*/
+            .ValidateArgumentBuffer(1, TEST_YELLOWKEY, strlen(TEST_YELLOWKEY) + 1);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG)) /*freeing yellow value*/
+            .ValidateArgumentBuffer(1, TEST_YELLOWVALUE, strlen(TEST_YELLOWVALUE) + 1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of blue key*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEVALUE) + 1)); /*copy of blue value*/
+
+        ///act
+        result1 = Map_Delete(handle, TEST_YELLOWKEY);
+        result2 = Map_Add(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result1);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result2);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_07_010: [When there is no free slot for the new pair, Map_Add and Map_AddOrUpdate shall double the storage for keys and values.] */
+    TEST_FUNCTION(Map_Add_third_key_doubles_the_storage)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        MAP_RESULT result1;
+        MAP_RESULT result2;
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        (void)Map_Add(handle, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 4 * sizeof(const char*))) /*growing keys*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 4 * sizeof(const char*))) /*growing values*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of blue key*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEVALUE) + 1)); /*copy of blue value*/
+        /*4th key fits in the storage already grown*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_GREENKEY) + 1)); /*copy of green key*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_GREENVALUE) + 1)); /*copy of green value*/
+
+        ///act
+        result1 = Map_Add(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        result2 = Map_Add(handle, TEST_GREENKEY, TEST_GREENVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result1);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result2);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_07_011: [When the map has more than MAP_HASH_INDEX_MIN_COUNT keys, Map_Add and Map_AddOrUpdate shall add the new key and its hash to the hash index, rebuilding the index so that it is at most half full.] */
+    TEST_FUNCTION(Map_Add_9th_key_creates_the_hash_index)
+    {
+        ///arrange
+        MAP_HANDLE handle = createMapWithManyKeys(8);
+        MAP_RESULT result;
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 16 * sizeof(const char*))) /*growing keys*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 16 * sizeof(const char*))) /*growing values*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_MANY_KEYS[8]) + 1)); /*copy of key*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_MANY_VALUE) + 1)); /*copy of value*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(16 * sizeof(size_t))); /*hashes, as many as the storage*/
+        STRICT_EXPECTED_CALL(gballoc_realloc(NULL, 32 * sizeof(size_t))); /*index, at most half full*/
+
+        ///act
+        result = Map_Add(handle, TEST_MANY_KEYS[8], TEST_MANY_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_07_011: [When the map has more than MAP_HASH_INDEX_MIN_COUNT keys, Map_Add and Map_AddOrUpdate shall add the new key and its hash to the hash index, rebuilding the index so that it is at most half full.] */
+    TEST_FUNCTION(Map_with_hash_index_finds_all_keys)
+    {
+        ///arrange
+        MAP_HANDLE handle = createMapWithManyKeys(TEST_MANY_KEYS_COUNT);
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        size_t i;
+        bool keyExists;
+        umock_c_reset_all_calls();
+
+        ///act
+        for (i = 0; i < TEST_MANY_KEYS_COUNT; i++)
+        {
+            ///assert
+            ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsKey(handle, TEST_MANY_KEYS[i], &keyExists));
+            ASSERT_IS_TRUE(keyExists);
+            ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_VALUE, Map_GetValueFromKey(handle, TEST_MANY_KEYS[i]));
+        }
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsKey(handle, TEST_REDKEY, &keyExists));
+        ASSERT_IS_FALSE(keyExists);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_KEYEXISTS, Map_Add(handle, TEST_MANY_KEYS[TEST_MANY_KEYS_COUNT - 1], TEST_MANY_VALUE));
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(handle, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, TEST_MANY_KEYS_COUNT, count);
+        for (i = 0; i < TEST_MANY_KEYS_COUNT; i++)
+        {
+            ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_KEYS[i], keys[i]);
+        }
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_07_012: [If memory for the hash index cannot be allocated, Map_Add and Map_AddOrUpdate shall drop the index, continue with linear search and not fail.] */
+    TEST_FUNCTION(Map_Add_succeeds_when_hash_index_cannot_be_allocated)
+    {
+        ///arrange
+        MAP_HANDLE handle = createMapWithManyKeys(8);
+        MAP_RESULT result;
+        bool keyExists;
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 16 * sizeof(const char*))) /*growing keys*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 16 * sizeof(const char*))) /*growing values*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_MANY_KEYS[8]) + 1)); /*copy of key*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_MANY_VALUE) + 1)); /*copy of value*/
+        whenShallmalloc_fail = currentmalloc_call + 3;
+        STRICT_EXPECTED_CALL(gballoc_malloc(16 * sizeof(size_t))); /*hashes*/
+
+        ///act
+        result = Map_Add(handle, TEST_MANY_KEYS[8], TEST_MANY_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsKey(handle, TEST_MANY_KEYS[8], &keyExists));
+        ASSERT_IS_TRUE(keyExists);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_07_014: [If the map has a hash index, Map_Delete shall rebuild it.] */
+    TEST_FUNCTION(Map_Delete_with_hash_index_keeps_finding_keys)
+    {
+        ///arrange
+        MAP_HANDLE handle = createMapWithManyKeys(TEST_MANY_KEYS_COUNT);
+        MAP_RESULT result;
+        bool keyExists;
+        size_t i;
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG)) /*key*/
+            .ValidateArgumentBuffer(1, TEST_MANY_KEYS[3], strlen(TEST_MANY_KEYS[3]) + 1);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG)) /*value*/
+            .IgnoreArgument(1);
+
+        ///act
+        result = Map_Delete(handle, TEST_MANY_KEYS[3]);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        for (i = 0; i < TEST_MANY_KEYS_COUNT; i++)
+        {
+            ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsKey(handle, TEST_MANY_KEYS[i], &keyExists));
+            ASSERT_ARE_EQUAL(bool, (i != 3), keyExists);
+        }
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_02_004: [Map_Destroy shall release all resources associated with the map.] */
+    TEST_FUNCTION(Map_Destroy_frees_the_hash_index)
+    {
+        ///arrange
+        MAP_HANDLE handle = createMapWithManyKeys(9);
+        size_t i;
+        umock_c_reset_all_calls();
+
+        for (i = 0; i < 9; i++)
+        {
+            STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG)) /*key*/
+                .ValidateArgumentBuffer(1, TEST_MANY_KEYS[i], strlen(TEST_MANY_KEYS[i]) + 1);
+            STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG)) /*value*/
+                .IgnoreArgument(1);
+        }
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG)) /*keys*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG)) /*values*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG)) /*index*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG)) /*hashes*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG)) /*handleData*/
+            .IgnoreArgument(1);
+
+        ///act
+        Map_Destroy(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
     /*Tests_SRS_MAP_02_024: [If parameter handle, key or keyExists are NULL then Map_ContainsKey shall return MAP_INVALIDARG.]*/
     TEST_FUNCTION(Map_ContainsKey_fails_with_invalid_arg_1)
     {
@@ -13,6 +13,8 @@
         constbuffer_array_create_with_move_buffers, \
         constbuffer_array_create_from_array_array, \
         constbuffer_array_create_empty, \
+        constbuffer_array_create_from_buffer_index_and_count, \
+        constbuffer_array_create_from_offset_and_size, \
         constbuffer_array_inc_ref, \
         constbuffer_array_dec_ref, \
         constbuffer_array_add_front, \
@@ -22,7 +24,13 @@
         constbuffer_array_get_buffer_content, \
         constbuffer_array_get_all_buffers_size, \
         constbuffer_array_get_const_buffer_handle_array, \
-        CONSTBUFFER_ARRAY_HANDLE_contain_same \
+        CONSTBUFFER_ARRAY_HANDLE_contain_same, \
+        constbuffer_array_cursor_create, \
+        constbuffer_array_cursor_destroy, \
+        constbuffer_array_cursor_get_remaining_size, \
+        constbuffer_array_cursor_consume, \
+        constbuffer_array_cursor_read, \
+        constbuffer_array_cursor_skip \
 )
 
 #ifdef __cplusplus
@@ -43,6 +51,10 @@ CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_create_with_move_buffers(CONSTBU
 CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_create_empty(void);
 CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_create_from_array_array(const CONSTBUFFER_ARRAY_HANDLE* buffer_arrays, uint32_t buffer_array_count);
 
+/*slice, sharing the buffers*/
+CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_create_from_buffer_index_and_count(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint32_t start_buffer_index, uint32_t buffer_count);
+CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_create_from_offset_and_size(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint32_t offset, uint32_t size);
+
 void real_constbuffer_array_inc_ref(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle);
 void real_constbuffer_array_dec_ref(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle);
 
@@ -62,6 +74,14 @@ const CONSTBUFFER_HANDLE* real_constbuffer_array_get_const_buffer_handle_array(C
 /* compare */
 bool real_CONSTBUFFER_ARRAY_HANDLE_contain_same(CONSTBUFFER_ARRAY_HANDLE left, CONSTBUFFER_ARRAY_HANDLE right);
 
+/* cursor */
+CONSTBUFFER_ARRAY_CURSOR_HANDLE real_constbuffer_array_cursor_create(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle);
+void real_constbuffer_array_cursor_destroy(CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor);
+int real_constbuffer_array_cursor_get_remaining_size(CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor, uint32_t* remaining_size);
+CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_cursor_consume(CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor, uint32_t size);
+int real_constbuffer_array_cursor_read(CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor, unsigned char* destination, uint32_t size);
+int real_constbuffer_array_cursor_skip(CONSTBUFFER_ARRAY_CURSOR_HANDLE cursor, uint32_t size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,6 +4,8 @@
 #define constbuffer_array_create_with_move_buffers real_constbuffer_array_create_with_move_buffers
 #define constbuffer_array_create_empty real_constbuffer_array_create_empty
 #define constbuffer_array_create_from_array_array real_constbuffer_array_create_from_array_array
+#define constbuffer_array_create_from_buffer_index_and_count real_constbuffer_array_create_from_buffer_index_and_count
+#define constbuffer_array_create_from_offset_and_size real_constbuffer_array_create_from_offset_and_size
 #define constbuffer_array_inc_ref real_constbuffer_array_inc_ref
 #define constbuffer_array_dec_ref real_constbuffer_array_dec_ref
 #define constbuffer_array_add_front real_constbuffer_array_add_front
@@ -13,4 +15,10 @@
 #define constbuffer_array_get_buffer_content real_constbuffer_array_get_buffer_content
 #define constbuffer_array_get_all_buffers_size real_constbuffer_array_get_all_buffers_size
 #define constbuffer_array_get_const_buffer_handle_array real_constbuffer_array_get_const_buffer_handle_array
-#define CONSTBUFFER_ARRAY_HANDLE_contain_same real_CONSTBUFFER_ARRAY_HANDLE_contain_same
\ No newline at end of file
+#define CONSTBUFFER_ARRAY_HANDLE_contain_same real_CONSTBUFFER_ARRAY_HANDLE_contain_same
+#define constbuffer_array_cursor_create real_constbuffer_array_cursor_create
+#define constbuffer_array_cursor_destroy real_constbuffer_array_cursor_destroy
+#define constbuffer_array_cursor_get_remaining_size real_constbuffer_array_cursor_get_remaining_size
+#define constbuffer_array_cursor_consume real_constbuffer_array_cursor_consume
+#define constbuffer_array_cursor_read real_constbuffer_array_cursor_read
+#define constbuffer_array_cursor_skip real_constbuffer_array_cursor_skip
@@ -0,0 +1,263 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "testrunnerswitcher.h"
+
+#include "azure_c_shared_utility/socketio.h"
+#include "azure_c_shared_utility/shared_util_options.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#include "perf_measure.h"
+
+/*idle connections held by one process, each one is a socket pair so twice as many descriptors are needed*/
+#define SOCKETIO_PERF_CONNECTIONS 10000
+/*dowork rounds over all connections*/
+#define SOCKETIO_PERF_ROUNDS 100
+/*connections that get bytes during the check that the reactor still delivers them*/
+#define SOCKETIO_PERF_ACTIVE_CONNECTIONS 100
+
+typedef struct CONNECTION_TAG
+{
+    int peer_socket;
+    CONCRETE_IO_HANDLE socket_io;
+} CONNECTION;
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static CONNECTION* g_connections;
+static size_t g_connection_count;
+static size_t g_received_bytes;
+
+static void on_io_open_complete(void* context, IO_OPEN_RESULT open_result)
+{
+    (void)context;
+    ASSERT_ARE_EQUAL(int, IO_OPEN_OK, open_result);
+}
+
+static void on_bytes_received(void* context, const unsigned char* buffer, size_t size)
+{
+    (void)context;
+    (void)buffer;
+    g_received_bytes += size;
+}
+
+static void on_io_error(void* context)
+{
+    (void)context;
+    ASSERT_FAIL("unexpected socket io error");
+}
+
+/*user + system time of the process*/
+static double cpu_time_ns(void)
+{
+    struct rusage usage;
+    (void)getrusage(RUSAGE_SELF, &usage);
+    return ((double)usage.ru_utime.tv_sec + (double)usage.ru_stime.tv_sec) * 1000000000.0 +
+        ((double)usage.ru_utime.tv_usec + (double)usage.ru_stime.tv_usec) * 1000.0;
+}
+
+/*as many connections as the descriptor limit allows, up to SOCKETIO_PERF_CONNECTIONS*/
+static size_t get_connection_count(void)
+{
+    struct rlimit limit;
+    size_t result = SOCKETIO_PERF_CONNECTIONS;
+
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        (void)setrlimit(RLIMIT_NOFILE, &limit);
+        (void)getrlimit(RLIMIT_NOFILE, &limit);
+        if ((limit.rlim_cur != RLIM_INFINITY) && ((limit.rlim_cur - 64) / 2 < result))
+        {
+            result = (size_t)((limit.rlim_cur - 64) / 2);
+        }
+    }
+
+    return result;
+}
+
+static void open_connections(SOCKETIO_REACTOR_HANDLE reactor)
+{
+    size_t i;
+
+    g_connection_count = get_connection_count();
+    g_connections = (CONNECTION*)malloc(g_connection_count * sizeof(CONNECTION));
+    ASSERT_IS_NOT_NULL(g_connections);
+
+    for (i = 0; i < g_connection_count; i++)
+    {
+        int sockets[2];
+        SOCKETIO_CONFIG config;
+
+        ASSERT_ARE_EQUAL(int, 0, socketpair(AF_UNIX, SOCK_STREAM, 0, sockets));
+        ASSERT_ARE_NOT_EQUAL(int, -1, fcntl(sockets[0], F_SETFL, fcntl(sockets[0], F_GETFL, 0) | O_NONBLOCK));
+
+        config.hostname = NULL;
+        config.port = 0;
+        config.accepted_socket = &sockets[0];
+        g_connections[i].peer_socket = sockets[1];
+        g_connections[i].socket_io = socketio_create(&config);
+        ASSERT_IS_NOT_NULL(g_connections[i].socket_io);
+        if (reactor != NULL)
+        {
+            ASSERT_ARE_EQUAL(int, 0, socketio_setoption(g_connections[i].socket_io, OPTION_SOCKETIO_REACTOR, reactor));
+        }
+        ASSERT_ARE_EQUAL(int, 0, socketio_open(g_connections[i].socket_io, on_io_open_complete, NULL, on_bytes_received, NULL, on_io_error, NULL));
+    }
+}
+
+static void close_connections(void)
+{
+    size_t i;
+    for (i = 0; i < g_connection_count; i++)
+    {
+        (void)socketio_close(g_connections[i].socket_io, NULL, NULL);
+        socketio_destroy(g_connections[i].socket_io);
+        (void)close(g_connections[i].peer_socket);
+    }
+    free(g_connections);
+    g_connections = NULL;
+}
+
+/*what the layers above do on every tick: socketio_dowork on every connection, plus the reactor when there is one*/
+static double run_rounds(const char* name, SOCKETIO_REACTOR_HANDLE reactor)
+{
+    size_t round;
+    size_t i;
+    double start = cpu_time_ns();
+    double result;
+
+    for (round = 0; round < SOCKETIO_PERF_ROUNDS; round++)
+    {
+        if (reactor != NULL)
+        {
+            ASSERT_ARE_EQUAL(int, 0, socketio_reactor_dowork(reactor, 0));
+        }
+        for (i = 0; i < g_connection_count; i++)
+        {
+            socketio_dowork(g_connections[i].socket_io);
+        }
+    }
+
+    result = (cpu_time_ns() - start) / SOCKETIO_PERF_ROUNDS;
+    LogInfo("%s: %.0f us of CPU per round over %lu idle connections", name, result / 1000.0, (unsigned long)g_connection_count);
+    return result;
+}
+
+/*writes to a few peers and runs the reactor until everything is received*/
+static void check_delivery(SOCKETIO_REACTOR_HANDLE reactor)
+{
+    size_t i;
+    size_t expected_bytes = 0;
+    size_t rounds = 0;
+
+    g_received_bytes = 0;
+    for (i = 0; i < g_connection_count; i += g_connection_count / SOCKETIO_PERF_ACTIVE_CONNECTIONS + 1)
+    {
+        ASSERT_ARE_EQUAL(int, 5, (int)write(g_connections[i].peer_socket, "hello", 5));
+        expected_bytes += 5;
+    }
+
+    while ((g_received_bytes < expected_bytes) && (rounds++ < 100))
+    {
+        if (reactor != NULL)
+        {
+            ASSERT_ARE_EQUAL(int, 0, socketio_reactor_dowork(reactor, 10));
+        }
+        else
+        {
+            for (i = 0; i < g_connection_count; i++)
+            {
+                socketio_dowork(g_connections[i].socket_io);
+            }
+        }
+    }
+
+    ASSERT_ARE_EQUAL(size_t, expected_bytes, g_received_bytes);
+}
+
+BEGIN_TEST_SUITE(socketio_perf)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+TEST_FUNCTION(socketio_dowork_idle_connections_perf)
+{
+    ///arrange
+    open_connections(NULL);
+
+    ///act
+    (void)run_rounds("socketio_dowork (polling)", NULL);
+
+    ///assert
+    check_delivery(NULL);
+
+    ///cleanup
+    close_connections();
+}
+
+TEST_FUNCTION(socketio_reactor_idle_connections_perf)
+{
+    ///arrange
+    SOCKETIO_REACTOR_HANDLE reactor = socketio_reactor_create();
+    ASSERT_IS_NOT_NULL(reactor);
+    open_connections(reactor);
+
+    ///act
+    (void)run_rounds("socketio_reactor_dowork + socketio_dowork (reactor)", reactor);
+
+    ///assert
+    check_delivery(reactor);
+
+    ///cleanup
+    close_connections();
+    socketio_reactor_destroy(reactor);
+}
+
+TEST_FUNCTION(socketio_reactor_destroyed_with_open_connections_leaves_them_to_socketio_dowork)
+{
+    ///arrange
+    SOCKETIO_REACTOR_HANDLE reactor = socketio_reactor_create();
+    ASSERT_IS_NOT_NULL(reactor);
+    open_connections(reactor);
+
+    ///act
+    socketio_reactor_destroy(reactor);
+
+    ///assert
+    check_delivery(NULL);
+
+    ///cleanup
+    close_connections();
+}
+
+END_TEST_SUITE(socketio_perf)
@@ -83,6 +83,7 @@ void my_gballoc_free(void* ptr)
 
 #define ENABLE_MOCKS
 #include "azure_c_shared_utility/optionhandler.h"
+#include "azure_c_shared_utility/constbuffer.h"
 #undef ENABLE_MOCKS
 
 #include "azure_c_shared_utility/optimize_size.h"
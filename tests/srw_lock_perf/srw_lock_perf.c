@@ -0,0 +1,267 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdbool.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+#include "azure_c_shared_utility/srw_lock.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#include "perf_measure.h"
+
+#define SRW_LOCK_PERF_UNCONTENDED_ITERATIONS 10000000
+#define SRW_LOCK_PERF_OPERATIONS_PER_THREAD 1000000
+#define SRW_LOCK_PERF_MAX_THREADS 8
+/*the data a reader copies while it holds the lock, so that readers overlap*/
+#define SRW_LOCK_PERF_DATA_SIZE 16
+
+typedef struct SRW_LOCK_PERF_CONTEXT_TAG
+{
+    SRW_LOCK_HANDLE lock;
+    /*one operation out of writes_period takes the lock exclusively, 0 means readers only*/
+    size_t writes_period;
+    volatile int64_t data[SRW_LOCK_PERF_DATA_SIZE];
+    volatile bool start;
+} SRW_LOCK_PERF_CONTEXT;
+
+typedef struct SRW_LOCK_PERF_THREAD_CONTEXT_TAG
+{
+    SRW_LOCK_PERF_CONTEXT* perf_context;
+    size_t writes;
+    int64_t checksum;
+} SRW_LOCK_PERF_THREAD_CONTEXT;
+
+static TEST_MUTEX_HANDLE g_testByTest;
+
+static void write_data(SRW_LOCK_PERF_CONTEXT* perf_context)
+{
+    size_t i;
+    srw_lock_acquire_exclusive(perf_context->lock);
+    for (i = 0; i < SRW_LOCK_PERF_DATA_SIZE; i++)
+    {
+        perf_context->data[i]++;
+    }
+    srw_lock_release_exclusive(perf_context->lock);
+}
+
+static int64_t read_data(SRW_LOCK_PERF_CONTEXT* perf_context)
+{
+    size_t i;
+    int64_t result = 0;
+    srw_lock_acquire_shared(perf_context->lock);
+    for (i = 0; i < SRW_LOCK_PERF_DATA_SIZE; i++)
+    {
+        result += perf_context->data[i];
+    }
+    srw_lock_release_shared(perf_context->lock);
+    return result;
+}
+
+static void exclusive(void* context, size_t iteration)
+{
+    (void)iteration;
+    write_data((SRW_LOCK_PERF_CONTEXT*)context);
+}
+
+static void shared(void* context, size_t iteration)
+{
+    (void)iteration;
+    if (read_data((SRW_LOCK_PERF_CONTEXT*)context) < 0)
+    {
+        ASSERT_FAIL("data is only ever incremented");
+    }
+}
+
+static int contending_thread(void* context)
+{
+    SRW_LOCK_PERF_THREAD_CONTEXT* thread_context = (SRW_LOCK_PERF_THREAD_CONTEXT*)context;
+    SRW_LOCK_PERF_CONTEXT* perf_context = thread_context->perf_context;
+    size_t i;
+
+    while (!perf_context->start)
+    {
+        /*all the threads start contending at the same time*/
+    }
+
+    for (i = 0; i < SRW_LOCK_PERF_OPERATIONS_PER_THREAD; i++)
+    {
+        if ((perf_context->writes_period != 0) && (i % perf_context->writes_period == 0))
+        {
+            write_data(perf_context);
+            thread_context->writes++;
+        }
+        else
+        {
+            thread_context->checksum += read_data(perf_context);
+        }
+    }
+
+    return 0;
+}
+
+static SRW_LOCK_PERF_CONTEXT* create_context(bool do_statistics, size_t writes_period)
+{
+    SRW_LOCK_PERF_CONTEXT* result = (SRW_LOCK_PERF_CONTEXT*)calloc(1, sizeof(SRW_LOCK_PERF_CONTEXT));
+    ASSERT_IS_NOT_NULL(result);
+    result->lock = srw_lock_create(do_statistics, "srw_lock_perf");
+    ASSERT_IS_NOT_NULL(result->lock);
+    result->writes_period = writes_period;
+    return result;
+}
+
+static void destroy_context(SRW_LOCK_PERF_CONTEXT* perf_context)
+{
+    srw_lock_destroy(perf_context->lock);
+    free(perf_context);
+}
+
+static PERF_MEASURE_RESULT run_uncontended(const char* operation_name, PERF_MEASURE_OPERATION operation, bool do_statistics)
+{
+    char name[96];
+    PERF_MEASURE_RESULT result;
+    SRW_LOCK_PERF_CONTEXT* perf_context = create_context(do_statistics, 0);
+    (void)sprintf(name, "%s uncontended (do_statistics=%s)", operation_name, do_statistics ? "true" : "false");
+
+    result = perf_measure_run(name, operation, perf_context, SRW_LOCK_PERF_UNCONTENDED_ITERATIONS);
+
+    destroy_context(perf_context);
+    return result;
+}
+
+static void run_contended(bool do_statistics, size_t thread_count, size_t writes_period)
+{
+    SRW_LOCK_PERF_THREAD_CONTEXT thread_contexts[SRW_LOCK_PERF_MAX_THREADS];
+    THREAD_HANDLE threads[SRW_LOCK_PERF_MAX_THREADS];
+    SRW_LOCK_PERF_CONTEXT* perf_context = create_context(do_statistics, writes_period);
+    double start;
+    double elapsed_ns;
+    double operations_per_second;
+    size_t writes = 0;
+    size_t i;
+    char name[64];
+
+    if (writes_period == 0)
+    {
+        (void)sprintf(name, "readers only");
+    }
+    else
+    {
+        (void)sprintf(name, "1 write every %u operations", (unsigned int)writes_period);
+    }
+
+    for (i = 0; i < thread_count; i++)
+    {
+        thread_contexts[i].perf_context = perf_context;
+        thread_contexts[i].writes = 0;
+        thread_contexts[i].checksum = 0;
+        ASSERT_ARE_EQUAL(int, THREADAPI_OK, ThreadAPI_Create(&threads[i], contending_thread, &thread_contexts[i]));
+    }
+
+    ///act
+    start = perf_measure_now_ns();
+    perf_context->start = true;
+    for (i = 0; i < thread_count; i++)
+    {
+        int thread_result;
+        ASSERT_ARE_EQUAL(int, THREADAPI_OK, ThreadAPI_Join(threads[i], &thread_result));
+        ASSERT_ARE_EQUAL(int, 0, thread_result);
+        writes += thread_contexts[i].writes;
+    }
+    elapsed_ns = perf_measure_now_ns() - start;
+
+    ///assert
+    operations_per_second = (double)(thread_count * SRW_LOCK_PERF_OPERATIONS_PER_THREAD) * 1000000000.0 / elapsed_ns;
+    LogInfo("srw_lock (do_statistics=%s) %u threads, %s: %.2f Mops/s", do_statistics ? "true" : "false", (unsigned int)thread_count, name, operations_per_second / 1000000.0);
+    /*no write was lost and no reader saw a torn write*/
+    for (i = 0; i < SRW_LOCK_PERF_DATA_SIZE; i++)
+    {
+        ASSERT_ARE_EQUAL(int64_t, (int64_t)writes, perf_context->data[i]);
+    }
+    for (i = 0; i < thread_count; i++)
+    {
+        ASSERT_ARE_EQUAL(int64_t, 0, thread_contexts[i].checksum % SRW_LOCK_PERF_DATA_SIZE);
+    }
+
+    ///cleanup
+    destroy_context(perf_context);
+}
+
+static void run_thread_counts(bool do_statistics, size_t writes_period)
+{
+    size_t thread_count;
+    for (thread_count = 1; thread_count <= SRW_LOCK_PERF_MAX_THREADS; thread_count *= 2)
+    {
+        run_contended(do_statistics, thread_count, writes_period);
+    }
+}
+
+BEGIN_TEST_SUITE(srw_lock_perf)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+TEST_FUNCTION(srw_lock_uncontended_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT exclusive_result = run_uncontended("srw_lock_acquire_exclusive/srw_lock_release_exclusive", exclusive, false);
+    PERF_MEASURE_RESULT shared_result = run_uncontended("srw_lock_acquire_shared/srw_lock_release_shared", shared, false);
+    PERF_MEASURE_RESULT exclusive_statistics_result = run_uncontended("srw_lock_acquire_exclusive/srw_lock_release_exclusive", exclusive, true);
+    PERF_MEASURE_RESULT shared_statistics_result = run_uncontended("srw_lock_acquire_shared/srw_lock_release_shared", shared, true);
+
+    ///assert
+    ASSERT_IS_TRUE(exclusive_result.allocations_per_op == 0.0);
+    ASSERT_IS_TRUE(shared_result.allocations_per_op == 0.0);
+    ASSERT_IS_TRUE(exclusive_statistics_result.allocations_per_op == 0.0);
+    ASSERT_IS_TRUE(shared_statistics_result.allocations_per_op == 0.0);
+}
+
+TEST_FUNCTION(srw_lock_readers_only_perf)
+{
+    run_thread_counts(false, 0);
+    run_thread_counts(true, 0);
+}
+
+TEST_FUNCTION(srw_lock_readers_and_writers_perf)
+{
+    /*1% and 10% of the operations are writes*/
+    run_thread_counts(false, 100);
+    run_thread_counts(false, 10);
+    run_thread_counts(true, 100);
+    run_thread_counts(true, 10);
+}
+
+END_TEST_SUITE(srw_lock_perf)
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+#include <time.h>
+#include <pthread.h>
+
+#define pthread_rwlock_init mocked_pthread_rwlock_init
+#define pthread_rwlock_wrlock mocked_pthread_rwlock_wrlock
+#define pthread_rwlock_rdlock mocked_pthread_rwlock_rdlock
+#define pthread_rwlock_unlock mocked_pthread_rwlock_unlock
+#define pthread_rwlock_destroy mocked_pthread_rwlock_destroy
+#define clock_gettime mocked_clock_gettime
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int mocked_pthread_rwlock_init(pthread_rwlock_t* rwlock, const pthread_rwlockattr_t* attr);
+int mocked_pthread_rwlock_wrlock(pthread_rwlock_t* rwlock);
+int mocked_pthread_rwlock_rdlock(pthread_rwlock_t* rwlock);
+int mocked_pthread_rwlock_unlock(pthread_rwlock_t* rwlock);
+int mocked_pthread_rwlock_destroy(pthread_rwlock_t* rwlock);
+int mocked_clock_gettime(clockid_t clock_id, struct timespec* tp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#include "../../adapters/srw_lock_pthreads.c"
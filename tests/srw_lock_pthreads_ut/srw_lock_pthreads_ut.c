@@ -0,0 +1,584 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#else
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#endif
+
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "macro_utils/macro_utils.h"
+
+static void* my_gballoc_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+static void* my_gballoc_calloc(size_t nmemb, size_t size)
+{
+    return calloc(nmemb, size);
+}
+
+static void my_gballoc_free(void* s)
+{
+    free(s);
+}
+
+static int my_mallocAndStrcpy_s(char** destination, const char* source)
+{
+    *destination = (char*)malloc(strlen(source) + 1);
+    (void)strcpy(*destination, source);
+    return 0;
+}
+
+#include "testrunnerswitcher.h"
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes.h"
+
+#define ENABLE_MOCKS
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/crt_abstractions.h"
+
+typedef struct timespec* PTIMESPEC;
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+MOCKABLE_FUNCTION(, int, mocked_pthread_rwlock_init, pthread_rwlock_t*, rwlock, const pthread_rwlockattr_t*, attr);
+MOCKABLE_FUNCTION(, int, mocked_pthread_rwlock_wrlock, pthread_rwlock_t*, rwlock);
+MOCKABLE_FUNCTION(, int, mocked_pthread_rwlock_rdlock, pthread_rwlock_t*, rwlock);
+MOCKABLE_FUNCTION(, int, mocked_pthread_rwlock_unlock, pthread_rwlock_t*, rwlock);
+MOCKABLE_FUNCTION(, int, mocked_pthread_rwlock_destroy, pthread_rwlock_t*, rwlock);
+MOCKABLE_FUNCTION(, int, mocked_clock_gettime, clockid_t, clock_id, PTIMESPEC, tp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#undef ENABLE_MOCKS
+
+#include "azure_c_shared_utility/srw_lock.h"
+
+/*TIME_BETWEEN_STATISTICS_LOG, 10 minutes*/
+#define TEST_STATISTICS_PERIOD_NS (INT64_C(600) * 1000000000)
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static int64_t g_now_ns;
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static int my_mocked_clock_gettime(clockid_t clock_id, PTIMESPEC tp)
+{
+    (void)clock_id;
+    tp->tv_sec = (time_t)(g_now_ns / 1000000000);
+    tp->tv_nsec = (long)(g_now_ns % 1000000000);
+    return 0;
+}
+
+static SRW_LOCK_HANDLE TEST_srw_lock_create(bool do_statistics, const char* lock_name)
+{
+    SRW_LOCK_HANDLE result;
+    STRICT_EXPECTED_CALL(gballoc_calloc(IGNORED_ARG, IGNORED_ARG));
+    if (do_statistics)
+    {
+        STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_ARG, lock_name));
+    }
+    STRICT_EXPECTED_CALL(mocked_pthread_rwlock_init(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    result = srw_lock_create(do_statistics, lock_name);
+    ASSERT_IS_NOT_NULL(result);
+    umock_c_reset_all_calls();
+    return result;
+}
+
+BEGIN_TEST_SUITE(srw_lock_pthreads_unittests)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    int result;
+
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    result = umock_c_init(on_umock_c_error);
+    ASSERT_ARE_EQUAL(int, 0, result, "umock_c_init");
+
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_calloc, my_gballoc_calloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+    REGISTER_GLOBAL_MOCK_HOOK(mallocAndStrcpy_s, my_mallocAndStrcpy_s);
+    REGISTER_GLOBAL_MOCK_HOOK(mocked_clock_gettime, my_mocked_clock_gettime);
+    REGISTER_GLOBAL_MOCK_RETURN(mocked_pthread_rwlock_init, 0);
+    REGISTER_GLOBAL_MOCK_RETURN(mocked_pthread_rwlock_wrlock, 0);
+    REGISTER_GLOBAL_MOCK_RETURN(mocked_pthread_rwlock_rdlock, 0);
+    REGISTER_GLOBAL_MOCK_RETURN(mocked_pthread_rwlock_unlock, 0);
+    REGISTER_GLOBAL_MOCK_RETURN(mocked_pthread_rwlock_destroy, 0);
+
+    REGISTER_UMOCK_ALIAS_TYPE(pthread_rwlock_t*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(const pthread_rwlockattr_t*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(PTIMESPEC, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(clockid_t, int);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    umock_c_reset_all_calls();
+    g_now_ns = INT64_C(1000) * 1000000000;
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+/*Tests_SRS_SRW_LOCK_02_001: [ srw_lock_create shall allocate memory for SRW_LOCK_HANDLE. ]*/
+/*Tests_SRS_SRW_LOCK_02_023: [ If do_statistics is true then srw_lock_create shall copy lock_name. ]*/
+/*Tests_SRS_SRW_LOCK_01_001: [ srw_lock_create shall call pthread_rwlock_init. ]*/
+/*Tests_SRS_SRW_LOCK_01_002: [ If do_statistics is true then srw_lock_create shall start counting TIME_BETWEEN_STATISTICS_LOG seconds from the creation of the lock. ]*/
+/*Tests_SRS_SRW_LOCK_02_003: [ srw_lock_create shall succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(srw_lock_create_succeeds)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock;
+    STRICT_EXPECTED_CALL(gballoc_calloc(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_ARG, "test_lock"));
+    STRICT_EXPECTED_CALL(mocked_pthread_rwlock_init(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+
+    ///act
+    bsdlLock = srw_lock_create(true, "test_lock");
+
+    ///assert
+    ASSERT_IS_NOT_NULL(bsdlLock);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    srw_lock_destroy(bsdlLock);
+}
+
+/*Tests_SRS_SRW_LOCK_02_001: [ srw_lock_create shall allocate memory for SRW_LOCK_HANDLE. ]*/
+/*Tests_SRS_SRW_LOCK_01_001: [ srw_lock_create shall call pthread_rwlock_init. ]*/
+/*Tests_SRS_SRW_LOCK_02_003: [ srw_lock_create shall succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(srw_lock_create_with_do_statistics_false_succeeds)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock;
+    STRICT_EXPECTED_CALL(gballoc_calloc(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_pthread_rwlock_init(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+
+    ///act
+    bsdlLock = srw_lock_create(false, "test_lock");
+
+    ///assert
+    ASSERT_IS_NOT_NULL(bsdlLock);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    srw_lock_destroy(bsdlLock);
+}
+
+/*Tests_SRS_SRW_LOCK_02_004: [ If there are any failures then srw_lock_create shall fail and return NULL. ]*/
+TEST_FUNCTION(srw_lock_create_fails_when_pthread_rwlock_init_fails)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock;
+    STRICT_EXPECTED_CALL(gballoc_calloc(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_ARG, "test_lock"));
+    STRICT_EXPECTED_CALL(mocked_pthread_rwlock_init(IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(EAGAIN);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+
+    ///act
+    bsdlLock = srw_lock_create(true, "test_lock");
+
+    ///assert
+    ASSERT_IS_NULL(bsdlLock);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SRW_LOCK_02_004: [ If there are any failures then srw_lock_create shall fail and return NULL. ]*/
+TEST_FUNCTION(srw_lock_create_fails_when_copying_the_name_fails)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock;
+    STRICT_EXPECTED_CALL(gballoc_calloc(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_ARG, "test_lock"))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+
+    ///act
+    bsdlLock = srw_lock_create(true, "test_lock");
+
+    ///assert
+    ASSERT_IS_NULL(bsdlLock);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SRW_LOCK_02_004: [ If there are any failures then srw_lock_create shall fail and return NULL. ]*/
+TEST_FUNCTION(srw_lock_create_fails_when_calloc_fails)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock;
+    STRICT_EXPECTED_CALL(gballoc_calloc(IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    bsdlLock = srw_lock_create(true, "test_lock");
+
+    ///assert
+    ASSERT_IS_NULL(bsdlLock);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SRW_LOCK_02_022: [ If handle is NULL then srw_lock_acquire_exclusive shall return. ]*/
+TEST_FUNCTION(srw_lock_acquire_exclusive_with_handle_NULL_returns)
+{
+    ///act
+    srw_lock_acquire_exclusive(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SRW_LOCK_01_003: [ srw_lock_acquire_exclusive shall call pthread_rwlock_wrlock. ]*/
+TEST_FUNCTION(srw_lock_acquire_exclusive_succeeds)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock = TEST_srw_lock_create(true, "test_lock");
+
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_pthread_rwlock_wrlock(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+
+    ///act
+    srw_lock_acquire_exclusive(bsdlLock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    srw_lock_release_exclusive(bsdlLock);
+    srw_lock_destroy(bsdlLock);
+}
+
+/*Tests_SRS_SRW_LOCK_01_003: [ srw_lock_acquire_exclusive shall call pthread_rwlock_wrlock. ]*/
+TEST_FUNCTION(srw_lock_acquire_exclusive_with_do_statistics_false_succeeds)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock = TEST_srw_lock_create(false, "test_lock");
+
+    STRICT_EXPECTED_CALL(mocked_pthread_rwlock_wrlock(IGNORED_ARG));
+
+    ///act
+    srw_lock_acquire_exclusive(bsdlLock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    srw_lock_release_exclusive(bsdlLock);
+    srw_lock_destroy(bsdlLock);
+}
+
+/*Tests_SRS_SRW_LOCK_02_025: [ If do_statistics is true and if the timer created has recorded more than TIME_BETWEEN_STATISTICS_LOG seconds then statistics will be logged and the timer shall be started again. ]*/
+TEST_FUNCTION(srw_lock_acquire_exclusive_after_the_statistics_period_logs_statistics)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock = TEST_srw_lock_create(true, "test_lock");
+    g_now_ns += TEST_STATISTICS_PERIOD_NS;
+
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_pthread_rwlock_wrlock(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG)); /*LogStatistics*/
+
+    ///act
+    srw_lock_acquire_exclusive(bsdlLock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    srw_lock_release_exclusive(bsdlLock);
+    srw_lock_destroy(bsdlLock);
+}
+
+/*Tests_SRS_SRW_LOCK_02_025: [ If do_statistics is true and if the timer created has recorded more than TIME_BETWEEN_STATISTICS_LOG seconds then statistics will be logged and the timer shall be started again. ]*/
+TEST_FUNCTION(srw_lock_acquire_exclusive_after_logging_statistics_restarts_the_period)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock = TEST_srw_lock_create(true, "test_lock");
+    g_now_ns += TEST_STATISTICS_PERIOD_NS;
+    srw_lock_acquire_exclusive(bsdlLock);
+    srw_lock_release_exclusive(bsdlLock);
+    umock_c_reset_all_calls();
+    g_now_ns += TEST_STATISTICS_PERIOD_NS - 1;
+
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_pthread_rwlock_wrlock(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+
+    ///act
+    srw_lock_acquire_exclusive(bsdlLock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    srw_lock_release_exclusive(bsdlLock);
+    srw_lock_destroy(bsdlLock);
+}
+
+/*Tests_SRS_SRW_LOCK_01_002: [ If do_statistics is true then srw_lock_create shall start counting TIME_BETWEEN_STATISTICS_LOG seconds from the creation of the lock. ]*/
+TEST_FUNCTION(srw_lock_acquire_exclusive_before_the_statistics_period_does_not_log_statistics)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock = TEST_srw_lock_create(true, "test_lock");
+    g_now_ns += TEST_STATISTICS_PERIOD_NS - 1;
+
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_pthread_rwlock_wrlock(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+
+    ///act
+    srw_lock_acquire_exclusive(bsdlLock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    srw_lock_release_exclusive(bsdlLock);
+    srw_lock_destroy(bsdlLock);
+}
+
+/*Tests_SRS_SRW_LOCK_02_009: [ If handle is NULL then srw_lock_release_exclusive shall return. ]*/
+TEST_FUNCTION(srw_lock_release_exclusive_with_handle_NULL_returns)
+{
+    ///act
+    srw_lock_release_exclusive(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SRW_LOCK_01_004: [ srw_lock_release_exclusive shall call pthread_rwlock_unlock. ]*/
+TEST_FUNCTION(srw_lock_release_exclusive_succeeds)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock = TEST_srw_lock_create(true, "test_lock");
+    srw_lock_acquire_exclusive(bsdlLock);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_pthread_rwlock_unlock(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+
+    ///act
+    srw_lock_release_exclusive(bsdlLock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    srw_lock_destroy(bsdlLock);
+}
+
+/*Tests_SRS_SRW_LOCK_01_004: [ srw_lock_release_exclusive shall call pthread_rwlock_unlock. ]*/
+TEST_FUNCTION(srw_lock_release_exclusive_with_do_statistics_false_succeeds)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock = TEST_srw_lock_create(false, "test_lock");
+    srw_lock_acquire_exclusive(bsdlLock);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mocked_pthread_rwlock_unlock(IGNORED_ARG));
+
+    ///act
+    srw_lock_release_exclusive(bsdlLock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    srw_lock_destroy(bsdlLock);
+}
+
+/*Tests_SRS_SRW_LOCK_02_011: [ If handle is NULL then srw_lock_destroy shall return. ]*/
+TEST_FUNCTION(srw_lock_destroy_with_handle_NULL_returns)
+{
+    ///act
+    srw_lock_destroy(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SRW_LOCK_02_012: [ srw_lock_destroy shall free all used resources. ]*/
+/*Tests_SRS_SRW_LOCK_01_007: [ srw_lock_destroy shall call pthread_rwlock_destroy. ]*/
+TEST_FUNCTION(srw_lock_destroy_free_used_resources)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock = TEST_srw_lock_create(true, "test_lock");
+
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_pthread_rwlock_destroy(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(bsdlLock));
+
+    ///act
+    srw_lock_destroy(bsdlLock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SRW_LOCK_02_012: [ srw_lock_destroy shall free all used resources. ]*/
+/*Tests_SRS_SRW_LOCK_01_007: [ srw_lock_destroy shall call pthread_rwlock_destroy. ]*/
+TEST_FUNCTION(srw_lock_destroy_with_do_statistics_false_free_used_resources)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock = TEST_srw_lock_create(false, "test_lock");
+
+    STRICT_EXPECTED_CALL(mocked_pthread_rwlock_destroy(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(bsdlLock));
+
+    ///act
+    srw_lock_destroy(bsdlLock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SRW_LOCK_02_017: [ If handle is NULL then srw_lock_acquire_shared shall return. ]*/
+TEST_FUNCTION(srw_lock_acquire_shared_with_handle_NULL_returns)
+{
+    ///act
+    srw_lock_acquire_shared(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SRW_LOCK_01_005: [ srw_lock_acquire_shared shall call pthread_rwlock_rdlock. ]*/
+TEST_FUNCTION(srw_lock_acquire_shared_succeeds)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock = TEST_srw_lock_create(true, "test_lock");
+
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_pthread_rwlock_rdlock(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+
+    ///act
+    srw_lock_acquire_shared(bsdlLock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    srw_lock_release_shared(bsdlLock);
+    srw_lock_destroy(bsdlLock);
+}
+
+/*Tests_SRS_SRW_LOCK_02_026: [ If do_statistics is true and the timer created has recorded more than TIME_BETWEEN_STATISTICS_LOG seconds then statistics will be logged and the timer shall be started again. ]*/
+TEST_FUNCTION(srw_lock_acquire_shared_after_the_statistics_period_logs_statistics)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock = TEST_srw_lock_create(true, "test_lock");
+    g_now_ns += TEST_STATISTICS_PERIOD_NS;
+
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_pthread_rwlock_rdlock(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG)); /*LogStatistics*/
+
+    ///act
+    srw_lock_acquire_shared(bsdlLock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    srw_lock_release_shared(bsdlLock);
+    srw_lock_destroy(bsdlLock);
+}
+
+/*Tests_SRS_SRW_LOCK_01_005: [ srw_lock_acquire_shared shall call pthread_rwlock_rdlock. ]*/
+TEST_FUNCTION(srw_lock_acquire_shared_with_do_statistic_false_succeeds)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock = TEST_srw_lock_create(false, "test_lock");
+
+    STRICT_EXPECTED_CALL(mocked_pthread_rwlock_rdlock(IGNORED_ARG));
+
+    ///act
+    srw_lock_acquire_shared(bsdlLock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    srw_lock_release_shared(bsdlLock);
+    srw_lock_destroy(bsdlLock);
+}
+
+/*Tests_SRS_SRW_LOCK_02_020: [ If handle is NULL then srw_lock_release_shared shall return. ]*/
+TEST_FUNCTION(srw_lock_release_shared_with_handle_NULL_returns)
+{
+    ///act
+    srw_lock_release_shared(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SRW_LOCK_01_006: [ srw_lock_release_shared shall call pthread_rwlock_unlock. ]*/
+TEST_FUNCTION(srw_lock_release_shared_succeeds)
+{
+    ///arrange
+    SRW_LOCK_HANDLE bsdlLock = TEST_srw_lock_create(true, "test_lock");
+    srw_lock_acquire_shared(bsdlLock);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_pthread_rwlock_unlock(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+
+    ///act
+    srw_lock_release_shared(bsdlLock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    srw_lock_destroy(bsdlLock);
+}
+
+END_TEST_SUITE(srw_lock_pthreads_unittests)
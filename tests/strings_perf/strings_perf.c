@@ -0,0 +1,180 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+#include "azure_c_shared_utility/strings.h"
+
+#include "perf_measure.h"
+
+#define STRINGS_PERF_ITERATIONS 1000000
+#define STRINGS_PERF_BUILD_ITERATIONS 10000
+#define STRINGS_PERF_BUILD_PIECES 256
+
+/*typical header names, property keys and SAS fragments*/
+static const char* const SHORT_VALUES[] =
+{
+    "content-type",
+    "iothub-messageid",
+    "$.cid",
+    "sr=myhub.azure-devices.net",
+    "se=1700000000",
+    "skn=iothubowner"
+};
+
+#define SHORT_VALUES_COUNT (sizeof(SHORT_VALUES) / sizeof(SHORT_VALUES[0]))
+
+static const char LONG_VALUE[] = "HostName=myhub.azure-devices.net;DeviceId=device_0001;SharedAccessKey=AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA=";
+
+static TEST_MUTEX_HANDLE g_testByTest;
+
+static void construct_short_and_delete(void* context, size_t iteration)
+{
+    STRING_HANDLE handle = STRING_construct(SHORT_VALUES[iteration % SHORT_VALUES_COUNT]);
+    (void)context;
+    STRING_delete(handle);
+}
+
+static void construct_long_and_delete(void* context, size_t iteration)
+{
+    STRING_HANDLE handle = STRING_construct(LONG_VALUE);
+    (void)context;
+    (void)iteration;
+    STRING_delete(handle);
+}
+
+static void new_and_delete(void* context, size_t iteration)
+{
+    STRING_HANDLE handle = STRING_new();
+    (void)context;
+    (void)iteration;
+    STRING_delete(handle);
+}
+
+static void clone_short_and_delete(void* context, size_t iteration)
+{
+    STRING_HANDLE handle = STRING_clone((STRING_HANDLE)context);
+    (void)iteration;
+    STRING_delete(handle);
+}
+
+static void build_short_and_delete(void* context, size_t iteration)
+{
+    STRING_HANDLE handle = STRING_new();
+    (void)context;
+    (void)STRING_concat(handle, "sr=");
+    (void)STRING_concat(handle, SHORT_VALUES[iteration % SHORT_VALUES_COUNT]);
+    STRING_delete(handle);
+}
+
+/*builds a 4KB string out of 16 characters pieces, the way JSON payloads and HTTP headers are built*/
+static void build_long_and_delete(void* context, size_t iteration)
+{
+    size_t i;
+    STRING_HANDLE handle = STRING_new();
+    (void)context;
+    (void)iteration;
+    for (i = 0; i < STRINGS_PERF_BUILD_PIECES; i++)
+    {
+        (void)STRING_concat(handle, "0123456789abcdef");
+    }
+    STRING_delete(handle);
+}
+
+BEGIN_TEST_SUITE(strings_perf)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+TEST_FUNCTION(STRING_construct_short_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result = perf_measure_run("STRING_construct (short) + STRING_delete", construct_short_and_delete, NULL, STRINGS_PERF_ITERATIONS);
+
+    ///assert
+    ASSERT_IS_TRUE(result.allocations_per_op == 1.0);
+}
+
+TEST_FUNCTION(STRING_construct_long_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result = perf_measure_run("STRING_construct (long) + STRING_delete", construct_long_and_delete, NULL, STRINGS_PERF_ITERATIONS);
+
+    ///assert
+    ASSERT_IS_TRUE(result.allocations_per_op == 1.0);
+}
+
+TEST_FUNCTION(STRING_new_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result = perf_measure_run("STRING_new + STRING_delete", new_and_delete, NULL, STRINGS_PERF_ITERATIONS);
+
+    ///assert
+    ASSERT_IS_TRUE(result.allocations_per_op == 1.0);
+}
+
+TEST_FUNCTION(STRING_clone_short_perf)
+{
+    ///arrange
+    STRING_HANDLE source = STRING_construct(SHORT_VALUES[0]);
+    ASSERT_IS_NOT_NULL(source);
+
+    ///act
+    PERF_MEASURE_RESULT result = perf_measure_run("STRING_clone (short) + STRING_delete", clone_short_and_delete, source, STRINGS_PERF_ITERATIONS);
+
+    ///assert
+    ASSERT_IS_TRUE(result.allocations_per_op == 1.0);
+
+    ///cleanup
+    STRING_delete(source);
+}
+
+TEST_FUNCTION(STRING_concat_short_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result = perf_measure_run("STRING_new + 2 x STRING_concat (short) + STRING_delete", build_short_and_delete, NULL, STRINGS_PERF_ITERATIONS);
+
+    ///assert
+    ASSERT_IS_TRUE(result.allocations_per_op == 1.0);
+}
+
+TEST_FUNCTION(STRING_concat_build_long_perf)
+{
+    ///act
+    PERF_MEASURE_RESULT result = perf_measure_run("STRING_new + 256 x STRING_concat (16 chars) + STRING_delete", build_long_and_delete, NULL, STRINGS_PERF_BUILD_ITERATIONS);
+
+    ///assert
+    /*the capacity doubles, so 4KB take a handful of allocations instead of one per piece*/
+    ASSERT_IS_TRUE(result.allocations_per_op <= 10.0);
+}
+
+END_TEST_SUITE(strings_perf)
@@ -52,6 +52,10 @@ static const char* INIT_FORMAT_INTEGER_RESULT = "Initial_test_format_1234";
 static const char* EMPTY_STRING = "";
 static const char* MODIFIED_STRING_VALUE = "Initial*";
 static const char* MODIFIED_STRING_VALUE2 = "*nitial_";
+/*longer than the strings kept in the STRING allocation itself*/
+static const char LONG_STRING_VALUE[] = "DataValueTestDataValueTestDataValueTestDataValueTest";
+static const char* QUOTED_LONG_STRING_VALUE = "\"DataValueTestDataValueTestDataValueTestDataValueTest\"";
+static const char* INITIAL_LONG_STRING_VALUE = "Initial_DataValueTestDataValueTestDataValueTestDataValueTest";
 
 #define NUMBER_OF_CHAR_TOCOPY           8
 #define TEST_INTEGER_VALUE              1234
@@ -135,7 +139,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(1));
 
         ///act
         g_hString = STRING_new();
@@ -159,7 +162,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(1));
 
         umock_c_negative_tests_snapshot();
 
@@ -230,7 +232,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_STRING_VALUE) + 1));
 
         ///act
         g_hString = STRING_construct(TEST_STRING_VALUE);
@@ -255,7 +256,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_STRING_VALUE) + 1));
 
         umock_c_negative_tests_snapshot();
 
@@ -302,7 +302,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(2 + strlen(TEST_STRING_VALUE) + 1));
 
         ///act
         g_hString = STRING_new_quoted(TEST_STRING_VALUE);
@@ -351,7 +350,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         ///arrange
         STRING_HANDLE str_handle;
 
-        EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
         EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
 
         ///act
@@ -373,7 +371,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         ///arrange
         STRING_HANDLE str_handle;
 
-        EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
         EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
 
         ///act
@@ -398,7 +395,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         int negativeTestsInitResult = umock_c_negative_tests_init();
         ASSERT_ARE_EQUAL(int, 0, negativeTestsInitResult);
 
-        EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
         EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
 
         umock_c_negative_tests_snapshot();
@@ -433,9 +429,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_construct(INITIAL_STRING_VALUE);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, strlen(INITIAL_STRING_VALUE) + strlen(TEST_STRING_VALUE) + 1))
-            .IgnoreArgument(1);
-
         ///act
         nResult = STRING_concat(g_hString, TEST_STRING_VALUE);
 
@@ -448,6 +441,140 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_delete(g_hString);
     }
 
+    TEST_FUNCTION(STRING_Concat_past_small_string_size_allocates_the_content)
+    {
+        ///arrange
+        int nResult;
+        STRING_HANDLE g_hString;
+        g_hString = STRING_construct(INITIAL_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+
+        ///act
+        nResult = STRING_concat(g_hString, LONG_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, INITIAL_LONG_STRING_VALUE, STRING_c_str(g_hString));
+        ASSERT_ARE_EQUAL(int, nResult, 0);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
+    TEST_FUNCTION(STRING_Concat_doubles_the_capacity_when_growing)
+    {
+        ///arrange
+        int nResult;
+        STRING_HANDLE g_hString;
+        g_hString = STRING_construct(LONG_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(2 * (strlen(LONG_STRING_VALUE) + 1)));
+
+        ///act
+        nResult = STRING_concat(g_hString, TEST_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, nResult, 0);
+        ASSERT_ARE_EQUAL(size_t, strlen(LONG_STRING_VALUE) + strlen(TEST_STRING_VALUE), STRING_length(g_hString));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
+    TEST_FUNCTION(STRING_Concat_within_capacity_does_not_allocate)
+    {
+        ///arrange
+        int nResult;
+        STRING_HANDLE g_hString;
+        g_hString = STRING_construct(LONG_STRING_VALUE);
+        (void)STRING_concat(g_hString, TEST_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        ///act
+        nResult = STRING_concat(g_hString, TEST_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, nResult, 0);
+        ASSERT_ARE_EQUAL(size_t, strlen(LONG_STRING_VALUE) + 2 * strlen(TEST_STRING_VALUE), STRING_length(g_hString));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
+    TEST_FUNCTION(STRING_Concat_to_allocated_content_reallocs)
+    {
+        ///arrange
+        int nResult;
+        STRING_HANDLE g_hString;
+        g_hString = STRING_construct(LONG_STRING_VALUE);
+        (void)STRING_concat(g_hString, TEST_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 4 * (strlen(LONG_STRING_VALUE) + 1)))
+            .IgnoreArgument(1);
+
+        ///act
+        nResult = STRING_concat(g_hString, LONG_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, nResult, 0);
+        ASSERT_ARE_EQUAL(size_t, 2 * strlen(LONG_STRING_VALUE) + strlen(TEST_STRING_VALUE), STRING_length(g_hString));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
+    TEST_FUNCTION(STRING_Concat_grows_to_the_needed_size_when_doubling_is_not_enough)
+    {
+        ///arrange
+        int nResult;
+        STRING_HANDLE g_hString;
+        g_hString = STRING_construct(LONG_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(LONG_STRING_VALUE) + strlen(QUOTED_LONG_STRING_VALUE) + 1));
+
+        ///act
+        nResult = STRING_concat(g_hString, QUOTED_LONG_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, nResult, 0);
+        ASSERT_ARE_EQUAL(size_t, strlen(LONG_STRING_VALUE) + strlen(QUOTED_LONG_STRING_VALUE), STRING_length(g_hString));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
+    TEST_FUNCTION(STRING_Concat_past_small_string_size_fails_when_malloc_fails)
+    {
+        ///arrange
+        int nResult;
+        STRING_HANDLE g_hString;
+        g_hString = STRING_construct(INITIAL_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
+            .SetReturn(NULL);
+
+        ///act
+        nResult = STRING_concat(g_hString, LONG_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, nResult, 0);
+        ASSERT_ARE_EQUAL(char_ptr, INITIAL_STRING_VALUE, STRING_c_str(g_hString));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
     /* Tests_SRS_STRING_07_013: [STRING_concat shall return a nonzero number if the STRING_HANDLE and const char* is NULL.] */
     TEST_FUNCTION(STRING_Concat_HANDLE_NULL_Fail)
     {
@@ -512,10 +639,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_copy(g_hString, TEST_STRING_VALUE);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, strlen(TEST_STRING_VALUE) + strlen(TEST_STRING_VALUE)+1))
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
-
         ///act
         STRING_concat(g_hString, TEST_STRING_VALUE);
 
@@ -536,9 +659,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_HANDLE hAppend = STRING_construct(TEST_STRING_VALUE);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, strlen(INITIAL_STRING_VALUE) + strlen(TEST_STRING_VALUE) + 1))
-            .IgnoreArgument(1);
-
         ///act
         nResult = STRING_concat_with_STRING(g_hString, hAppend);
 
@@ -613,9 +733,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_construct(INITIAL_STRING_VALUE);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, strlen(TEST_STRING_VALUE) + 1))
-            .IgnoreArgument(1);
-
         ///act
         nResult = STRING_copy(g_hString, TEST_STRING_VALUE);
 
@@ -657,9 +774,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_construct(INITIAL_STRING_VALUE);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, NUMBER_OF_CHAR_TOCOPY + 1))
-            .IgnoreArgument(1);
-
         ///act
         nResult = STRING_copy_n(g_hString, COMBINED_STRING_VALUE, NUMBER_OF_CHAR_TOCOPY);
 
@@ -714,9 +828,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_construct(INITIAL_STRING_VALUE);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 1))
-            .IgnoreArgument(1);
-
         ///act
         nResult = STRING_copy_n(g_hString, COMBINED_STRING_VALUE, 0);
 
@@ -738,9 +849,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_construct(TEST_STRING_VALUE);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 2 + strlen(TEST_STRING_VALUE) + 1))
-            .IgnoreArgument(1);
-
         ///act
         nResult = STRING_quote(g_hString);
 
@@ -753,6 +861,29 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_delete(g_hString);
     }
 
+    /* Tests_SRS_STRING_07_014: [STRING_quote shall "quote" the supplied STRING_HANDLE and return 0 on success.] */
+    TEST_FUNCTION(STRING_quote_long_string_Succeed)
+    {
+        ///arrange
+        int nResult;
+        STRING_HANDLE g_hString;
+        g_hString = STRING_construct(LONG_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(2 * (strlen(LONG_STRING_VALUE) + 1)));
+
+        ///act
+        nResult = STRING_quote(g_hString);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, QUOTED_LONG_STRING_VALUE, STRING_c_str(g_hString));
+        ASSERT_ARE_EQUAL(int, nResult, 0);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
     TEST_FUNCTION(STRING_quote_fail)
     {
         ///arrange
@@ -762,11 +893,10 @@ BEGIN_TEST_SUITE(strings_unittests)
         int negativeTestsInitResult = umock_c_negative_tests_init();
         ASSERT_ARE_EQUAL(int, 0, negativeTestsInitResult);
 
-        str_handle = STRING_construct(TEST_STRING_VALUE);
+        str_handle = STRING_construct(LONG_STRING_VALUE);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 2 + strlen(TEST_STRING_VALUE) + 1))
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(2 * (strlen(LONG_STRING_VALUE) + 1)));
 
         umock_c_negative_tests_snapshot();
 
@@ -828,7 +958,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_STRING_VALUE) + 1));
 
         ///act
         g_hString = STRING_construct(TEST_STRING_VALUE);
@@ -851,9 +980,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_construct(TEST_STRING_VALUE);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 1))
-            .IgnoreArgument(1);
-
         ///act
         nResult = STRING_empty(g_hString);
 
@@ -866,6 +992,29 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_delete(g_hString);
     }
 
+    /* Tests_SRS_STRING_07_022: [STRING_empty shall revert the STRING_HANDLE to an empty state.] */
+    TEST_FUNCTION(STRING_empty_keeps_the_capacity)
+    {
+        ///arrange
+        STRING_HANDLE g_hString;
+        int nResult;
+        g_hString = STRING_construct(LONG_STRING_VALUE);
+        (void)STRING_concat(g_hString, TEST_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        ///act
+        nResult = STRING_empty(g_hString);
+        (void)STRING_concat(g_hString, LONG_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, nResult, 0);
+        ASSERT_ARE_EQUAL(char_ptr, LONG_STRING_VALUE, STRING_c_str(g_hString));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
     /* Tests_SRS_STRING_07_023: [STRING_empty shall return a nonzero value if the STRING_HANDLE is NULL.] */
     TEST_FUNCTION(STRING_empty_NULL_HANDLE_Fail)
     {
@@ -899,8 +1048,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_new();
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
             .IgnoreArgument(1);
 
@@ -911,6 +1058,25 @@ BEGIN_TEST_SUITE(strings_unittests)
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     }
 
+    /* Tests_SRS_STRING_07_010: [STRING_delete will free the memory allocated by the STRING_HANDLE.] */
+    TEST_FUNCTION(STRING_delete_with_allocated_content_frees_the_content)
+    {
+        ///arrange
+        STRING_HANDLE g_hString;
+        g_hString = STRING_new();
+        (void)STRING_concat(g_hString, LONG_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+
+        ///act
+        STRING_delete(g_hString);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
     TEST_FUNCTION(STRING_length_Succeed)
     {
         ///arrange
@@ -965,7 +1131,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof("aa")));
 
         ///act
         result = STRING_clone(hSource);
@@ -996,7 +1161,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof("aa")));
 
         umock_c_negative_tests_snapshot();
 
@@ -1057,8 +1221,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(3))
-            .IgnoreArgument(1);
 
         ///act
         result = STRING_construct_n("qq", 2);
@@ -1079,8 +1241,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_HANDLE result;
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(4))
-            .IgnoreArgument(1);
 
         ///act
         result = STRING_construct_n("12345", 3);
@@ -1104,8 +1264,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(3))
-            .IgnoreArgument(1);
 
         umock_c_negative_tests_snapshot();
 
@@ -1282,7 +1440,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
             STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
                 .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(gballoc_malloc(strlen(JSONtests[i].expectedJSON) + 1));
 
             ///act
             result = STRING_new_JSON(JSONtests[i].source);
@@ -1306,7 +1463,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         ASSERT_ARE_EQUAL(int, 0, negativeTestsInitResult);
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG)).IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen("ab") + 2+1));
 
         umock_c_negative_tests_snapshot();
 
@@ -1370,8 +1526,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
             .IgnoreArgument_size();
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(1 + 1));
-
         ///act
         result = STRING_from_byte_array((const unsigned char*)"a", 1);
 
@@ -1392,8 +1546,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
             .IgnoreArgument_size();
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(1 + 0));
-
         ///act
         result = STRING_from_byte_array(NULL, 0);
 
@@ -1406,30 +1558,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_delete(result);
     }
 
-    /*Tests_SRS_STRING_02_024: [ If building the string fails, then STRING_from_BUFFER shall fail and return NULL. ]*/
-    TEST_FUNCTION(STRING_from_byte_array_fails_1)
-    {
-        ///arrange
-        STRING_HANDLE result;
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
-            .IgnoreArgument_size();
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(1 + 1))
-            .SetReturn(NULL);
-
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
-            .IgnoreArgument_ptr();
-
-        ///act
-        result = STRING_from_byte_array((const unsigned char*)"a", 1);
-
-        ///assert
-        ASSERT_IS_NULL(result);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-    }
-
     /*Tests_SRS_STRING_02_024: [ If building the string fails, then STRING_from_BUFFER shall fail and return NULL. ]*/
     TEST_FUNCTION(STRING_from_byte_array_fails_2)
     {
@@ -1493,7 +1621,7 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         umock_c_reset_all_calls();
 
-        EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
+        EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
 
         ///act
         str_result = STRING_sprintf(str_handle, FORMAT_STRING, TEST_STRING_VALUE);
@@ -1544,7 +1672,7 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         umock_c_reset_all_calls();
 
-        EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
+        EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
 
         umock_c_negative_tests_snapshot();
 
@@ -1696,4 +1824,243 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_delete(str_handle);
     }
 
+    /* Tests_SRS_STRING_07_050: [ If handle is NULL STRING_reserve shall return a non-zero value. ] */
+    TEST_FUNCTION(STRING_reserve_handle_NULL_fail)
+    {
+        //arrange
+        int str_result;
+
+        //act
+        str_result = STRING_reserve(NULL, 10);
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, str_result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_STRING_07_051: [ If the STRING can already hold capacity characters STRING_reserve shall not allocate and shall return zero. ] */
+    TEST_FUNCTION(STRING_reserve_within_capacity_does_not_allocate)
+    {
+        //arrange
+        int str_result;
+        STRING_HANDLE str_handle = STRING_construct(LONG_STRING_VALUE);
+        ASSERT_IS_NOT_NULL(str_handle);
+        umock_c_reset_all_calls();
+
+        //act
+        str_result = STRING_reserve(str_handle, strlen(LONG_STRING_VALUE));
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, str_result);
+        ASSERT_ARE_EQUAL(char_ptr, LONG_STRING_VALUE, STRING_c_str(str_handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        STRING_delete(str_handle);
+    }
+
+    /* Tests_SRS_STRING_07_052: [ Otherwise STRING_reserve shall reallocate the STRING content to hold exactly capacity characters and the null terminator, preserving the content. ] */
+    /* Tests_SRS_STRING_07_054: [ On success STRING_reserve shall return zero. ] */
+    TEST_FUNCTION(STRING_reserve_allocates_exactly_the_capacity)
+    {
+        //arrange
+        int str_result;
+        STRING_HANDLE str_handle = STRING_construct(INITIAL_STRING_VALUE);
+        ASSERT_IS_NOT_NULL(str_handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(INITIAL_LONG_STRING_VALUE) + 1));
+
+        //act
+        str_result = STRING_reserve(str_handle, strlen(INITIAL_LONG_STRING_VALUE));
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, str_result);
+        ASSERT_ARE_EQUAL(char_ptr, INITIAL_STRING_VALUE, STRING_c_str(str_handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        STRING_delete(str_handle);
+    }
+
+    /* Tests_SRS_STRING_07_052: [ Otherwise STRING_reserve shall reallocate the STRING content to hold exactly capacity characters and the null terminator, preserving the content. ] */
+    TEST_FUNCTION(STRING_reserve_then_concat_up_to_the_capacity_does_not_allocate)
+    {
+        //arrange
+        int str_result;
+        STRING_HANDLE str_handle = STRING_construct(INITIAL_STRING_VALUE);
+        ASSERT_IS_NOT_NULL(str_handle);
+        ASSERT_ARE_EQUAL(int, 0, STRING_reserve(str_handle, strlen(INITIAL_LONG_STRING_VALUE)));
+        umock_c_reset_all_calls();
+
+        //act
+        str_result = STRING_concat(str_handle, LONG_STRING_VALUE);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, str_result);
+        ASSERT_ARE_EQUAL(char_ptr, INITIAL_LONG_STRING_VALUE, STRING_c_str(str_handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        STRING_delete(str_handle);
+    }
+
+    /* Tests_SRS_STRING_07_052: [ Otherwise STRING_reserve shall reallocate the STRING content to hold exactly capacity characters and the null terminator, preserving the content. ] */
+    TEST_FUNCTION(STRING_reserve_on_allocated_content_reallocs)
+    {
+        //arrange
+        int str_result;
+        STRING_HANDLE str_handle = STRING_construct(INITIAL_STRING_VALUE);
+        ASSERT_IS_NOT_NULL(str_handle);
+        ASSERT_ARE_EQUAL(int, 0, STRING_concat(str_handle, LONG_STRING_VALUE));
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, 1000 + 1));
+
+        //act
+        str_result = STRING_reserve(str_handle, 1000);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, str_result);
+        ASSERT_ARE_EQUAL(char_ptr, INITIAL_LONG_STRING_VALUE, STRING_c_str(str_handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        STRING_delete(str_handle);
+    }
+
+    /* Tests_SRS_STRING_07_053: [ If any error is encountered STRING_reserve shall leave the STRING unchanged and return a non-zero value. ] */
+    TEST_FUNCTION(STRING_reserve_fails_when_malloc_fails)
+    {
+        //arrange
+        int str_result;
+        STRING_HANDLE str_handle = STRING_construct(INITIAL_STRING_VALUE);
+        ASSERT_IS_NOT_NULL(str_handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(1000 + 1))
+            .SetReturn(NULL);
+
+        //act
+        str_result = STRING_reserve(str_handle, 1000);
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, str_result);
+        ASSERT_ARE_EQUAL(char_ptr, INITIAL_STRING_VALUE, STRING_c_str(str_handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        STRING_delete(str_handle);
+    }
+
+    /* Tests_SRS_STRING_07_055: [ If handle is NULL STRING_shrink_to_fit shall return a non-zero value. ] */
+    TEST_FUNCTION(STRING_shrink_to_fit_handle_NULL_fail)
+    {
+        //arrange
+        int str_result;
+
+        //act
+        str_result = STRING_shrink_to_fit(NULL);
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, str_result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_STRING_07_056: [ If the content is stored in the STRING allocation itself or already uses all the capacity STRING_shrink_to_fit shall not allocate and shall return zero. ] */
+    TEST_FUNCTION(STRING_shrink_to_fit_with_inline_content_does_nothing)
+    {
+        //arrange
+        int str_result;
+        STRING_HANDLE str_handle = STRING_construct(INITIAL_STRING_VALUE);
+        ASSERT_IS_NOT_NULL(str_handle);
+        umock_c_reset_all_calls();
+
+        //act
+        str_result = STRING_shrink_to_fit(str_handle);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, str_result);
+        ASSERT_ARE_EQUAL(char_ptr, INITIAL_STRING_VALUE, STRING_c_str(str_handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        STRING_delete(str_handle);
+    }
+
+    /* Tests_SRS_STRING_07_057: [ If the content fits in the STRING allocation itself STRING_shrink_to_fit shall move it there and free the separately allocated content. ] */
+    /* Tests_SRS_STRING_07_060: [ On success STRING_shrink_to_fit shall return zero. ] */
+    TEST_FUNCTION(STRING_shrink_to_fit_moves_short_content_back_inline)
+    {
+        //arrange
+        int str_result;
+        STRING_HANDLE str_handle = STRING_construct(INITIAL_STRING_VALUE);
+        ASSERT_IS_NOT_NULL(str_handle);
+        ASSERT_ARE_EQUAL(int, 0, STRING_concat(str_handle, LONG_STRING_VALUE));
+        ASSERT_ARE_EQUAL(int, 0, STRING_copy(str_handle, TEST_STRING_VALUE));
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+
+        //act
+        str_result = STRING_shrink_to_fit(str_handle);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, str_result);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_STRING_VALUE, STRING_c_str(str_handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        STRING_delete(str_handle);
+    }
+
+    /* Tests_SRS_STRING_07_058: [ Otherwise STRING_shrink_to_fit shall reallocate the content to the length of the string plus the null terminator. ] */
+    TEST_FUNCTION(STRING_shrink_to_fit_reallocs_to_the_length)
+    {
+        //arrange
+        int str_result;
+        STRING_HANDLE str_handle = STRING_construct(LONG_STRING_VALUE);
+        ASSERT_IS_NOT_NULL(str_handle);
+        ASSERT_ARE_EQUAL(int, 0, STRING_concat(str_handle, TEST_STRING_VALUE));
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, strlen(LONG_STRING_VALUE) + strlen(TEST_STRING_VALUE) + 1));
+
+        //act
+        str_result = STRING_shrink_to_fit(str_handle);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, str_result);
+        ASSERT_ARE_EQUAL(size_t, strlen(LONG_STRING_VALUE) + strlen(TEST_STRING_VALUE), STRING_length(str_handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        STRING_delete(str_handle);
+    }
+
+    /* Tests_SRS_STRING_07_059: [ If any error is encountered STRING_shrink_to_fit shall leave the STRING unchanged and return a non-zero value. ] */
+    TEST_FUNCTION(STRING_shrink_to_fit_fails_when_realloc_fails)
+    {
+        //arrange
+        int str_result;
+        STRING_HANDLE str_handle = STRING_construct(LONG_STRING_VALUE);
+        ASSERT_IS_NOT_NULL(str_handle);
+        ASSERT_ARE_EQUAL(int, 0, STRING_concat(str_handle, TEST_STRING_VALUE));
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG))
+            .SetReturn(NULL);
+
+        //act
+        str_result = STRING_shrink_to_fit(str_handle);
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, str_result);
+        ASSERT_ARE_EQUAL(size_t, strlen(LONG_STRING_VALUE) + strlen(TEST_STRING_VALUE), STRING_length(str_handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        STRING_delete(str_handle);
+    }
+
 END_TEST_SUITE(strings_unittests)
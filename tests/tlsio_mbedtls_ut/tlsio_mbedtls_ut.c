@@ -76,11 +76,14 @@ static void my_gballoc_free(void* ptr)
 #include "azure_c_shared_utility/shared_util_options.h"
 #include "azure_c_shared_utility/optionhandler.h"
 #include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/tickcounter.h"
 
 
 typedef int(*f_rng)(void *p_rng, unsigned char *output, size_t output_len);
 typedef void(*f_dbg)(void* a, int b, const char* c, int d, const char* e);
 typedef int(*f_entropy)(void *, unsigned char *, size_t);
+typedef int(*f_vrfy)(void *, mbedtls_x509_crt *, int, uint32_t *);
 
 MOCKABLE_FUNCTION(, void, mbedtls_init, void*, instance, const char*, hostname);
 MOCKABLE_FUNCTION(, int, mbedtls_x509_crt_parse, mbedtls_x509_crt*, crt, const unsigned char*, buf, size_t, buflen);
@@ -106,6 +109,7 @@ MOCKABLE_FUNCTION(, void, mbedtls_ssl_config_free, mbedtls_ssl_config*, conf)
 MOCKABLE_FUNCTION(, int, mbedtls_ssl_handshake_step, mbedtls_ssl_context*, ssl)
 MOCKABLE_FUNCTION(, int, mbedtls_ssl_setup, mbedtls_ssl_context*, ssl, const mbedtls_ssl_config*, conf)
 MOCKABLE_FUNCTION(, int, mbedtls_ssl_set_session, mbedtls_ssl_context*, ssl, const mbedtls_ssl_session*, session)
+MOCKABLE_FUNCTION(, int, mbedtls_ssl_get_session, const mbedtls_ssl_context*, ssl, mbedtls_ssl_session*, session)
 MOCKABLE_FUNCTION(, int, mbedtls_ssl_read, mbedtls_ssl_context*, ssl, unsigned char*, buf, size_t, len)
 MOCKABLE_FUNCTION(, size_t, mbedtls_ssl_get_max_frag_len, const mbedtls_ssl_context*, ssl)
 // Note: unlike mbedtls_ssl_get_max_frag_len which returns size_t,
@@ -131,6 +135,7 @@ MOCKABLE_FUNCTION(, int, mbedtls_ssl_session_reset, mbedtls_ssl_context*, ssl);
 MOCKABLE_FUNCTION(, void, mbedtls_ssl_session_free, mbedtls_ssl_session*, ssl);
 MOCKABLE_FUNCTION(, int, mbedtls_ssl_conf_own_cert, mbedtls_ssl_config*, conf, mbedtls_x509_crt*, own_cert, mbedtls_pk_context*, pk_key);
 MOCKABLE_FUNCTION(, void, mbedtls_ssl_conf_renegotiation, mbedtls_ssl_config*, conf, int, renegotiation);
+MOCKABLE_FUNCTION(, void, mbedtls_ssl_conf_verify, mbedtls_ssl_config*, conf, f_vrfy, fv, void*, p_vrfy);
 
 MOCKABLE_FUNCTION(, void, mbedtls_debug_set_threshold, int, threshold);
 
@@ -375,6 +380,7 @@ BEGIN_TEST_SUITE(tlsio_mbedtls_ut)
         REGISTER_UMOCK_ALIAS_TYPE(f_entropy, void*);
         REGISTER_UMOCK_ALIAS_TYPE(f_rng, void*);
         REGISTER_UMOCK_ALIAS_TYPE(f_dbg, void*);
+        REGISTER_UMOCK_ALIAS_TYPE(f_vrfy, void*);
         REGISTER_UMOCK_ALIAS_TYPE(XIO_HANDLE, void*);
         REGISTER_UMOCK_ALIAS_TYPE(ON_IO_OPEN_COMPLETE, void*);
         REGISTER_UMOCK_ALIAS_TYPE(ON_BYTES_RECEIVED, void*);
@@ -1292,4 +1298,39 @@ BEGIN_TEST_SUITE(tlsio_mbedtls_ut)
         tlsio_mbedtls_destroy(handle);
     }
 
+    TEST_FUNCTION(tlsio_mbedtls_setoption_session_cache_without_init_fail)
+    {
+        //arrange
+        TLSIO_CONFIG tls_io_config;
+        tls_io_config.hostname = TEST_HOSTNAME;
+        tls_io_config.port = TEST_CONNECTION_PORT;
+        tls_io_config.underlying_io_interface = TEST_INTERFACE_DESC;
+        tls_io_config.underlying_io_parameters = NULL;
+        CONCRETE_IO_HANDLE handle = tlsio_mbedtls_create(&tls_io_config);
+        umock_c_reset_all_calls();
+
+        //act
+        bool is_session_cache_enabled = true;
+        int result = tlsio_mbedtls_setoption(handle, OPTION_TLS_SESSION_CACHE, &is_session_cache_enabled);
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        tlsio_mbedtls_destroy(handle);
+    }
+
+    TEST_FUNCTION(tlsio_mbedtls_get_handshake_statistics_NULL_fail)
+    {
+        //arrange
+
+        //act
+        int result = tlsio_mbedtls_get_handshake_statistics(NULL);
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
 END_TEST_SUITE(tlsio_mbedtls_ut)
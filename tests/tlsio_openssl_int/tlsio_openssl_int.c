@@ -0,0 +1,1045 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "openssl/ssl.h"
+#include "openssl/err.h"
+#include "openssl/evp.h"
+#include "openssl/pem.h"
+#include "openssl/rsa.h"
+#include "openssl/x509.h"
+#include "openssl/x509v3.h"
+
+#include "testrunnerswitcher.h"
+
+#include "azure_c_shared_utility/tlsio.h"
+#include "azure_c_shared_utility/tlsio_openssl.h"
+#include "azure_c_shared_utility/xio.h"
+#include "azure_c_shared_utility/constbuffer.h"
+#include "azure_c_shared_utility/constbuffer_array.h"
+#include "azure_c_shared_utility/shared_util_options.h"
+
+#define TLSIO_OPENSSL_INT_RECORD_SIZE (16 * 1024)
+#define TLSIO_OPENSSL_INT_UNDERLYING_READ_SIZE (16 * 1024)
+/*records sent by the server in the receive tests*/
+#define TLSIO_OPENSSL_INT_RECORD_COUNT 16
+/*sends the underlying IO keeps without completing them when g_hold_send_completes is set*/
+#define TLSIO_OPENSSL_INT_MAX_HELD_SENDS 16
+
+/*The server is an OpenSSL SSL object on memory BIOs in the same thread: what tlsio sends goes into the server read BIO,
+what the server writes is handed to tlsio by the dowork of the underlying IO below. No sockets, no other threads.*/
+typedef struct HELD_SEND_TAG
+{
+    ON_SEND_COMPLETE on_send_complete;
+    void* callback_context;
+} HELD_SEND;
+
+typedef struct LOOPBACK_SERVER_TAG
+{
+    SSL* ssl;
+    BIO* in_bio;
+    BIO* out_bio;
+    ON_BYTES_RECEIVED on_bytes_received;
+    void* on_bytes_received_context;
+} LOOPBACK_SERVER;
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static EVP_PKEY* g_server_key;
+static X509* g_server_certificate;
+static char* g_server_certificate_pem;
+static SSL_CTX* g_server_context;
+static LOOPBACK_SERVER g_server;
+static unsigned char g_record[TLSIO_OPENSSL_INT_RECORD_SIZE];
+static unsigned char g_read_buffer[TLSIO_OPENSSL_INT_UNDERLYING_READ_SIZE];
+static size_t g_received_bytes;
+static size_t g_receive_callbacks;
+static size_t g_largest_receive;
+static bool g_is_received_content_as_sent;
+static bool g_is_open;
+static bool g_has_error;
+/*when set the underlying IO completes the sends without handing them to the server, the send tests only look at the client*/
+static bool g_discard_sent_bytes;
+/*when set with g_discard_sent_bytes the underlying IO keeps the sends in g_held_sends, as a socket that cannot send*/
+static bool g_hold_send_completes;
+static HELD_SEND g_held_sends[TLSIO_OPENSSL_INT_MAX_HELD_SENDS];
+static size_t g_held_send_count;
+static size_t g_sent_bytes;
+/*the contexts of the completed sends of the test, in the order of on_send_complete*/
+static size_t g_completed_sends[TLSIO_OPENSSL_INT_MAX_HELD_SENDS];
+static IO_SEND_RESULT g_send_results[TLSIO_OPENSSL_INT_MAX_HELD_SENDS];
+static size_t g_send_complete_count;
+
+static void server_drive(void)
+{
+    if (!SSL_is_init_finished(g_server.ssl))
+    {
+        (void)SSL_do_handshake(g_server.ssl);
+    }
+}
+
+static CONCRETE_IO_HANDLE loopback_io_create(void* io_create_parameters)
+{
+    (void)io_create_parameters;
+    return &g_server;
+}
+
+static void loopback_io_destroy(CONCRETE_IO_HANDLE concrete_io)
+{
+    (void)concrete_io;
+}
+
+static int loopback_io_open(CONCRETE_IO_HANDLE concrete_io, ON_IO_OPEN_COMPLETE on_io_open_complete, void* on_io_open_complete_context, ON_BYTES_RECEIVED on_bytes_received, void* on_bytes_received_context, ON_IO_ERROR on_io_error, void* on_io_error_context)
+{
+    LOOPBACK_SERVER* server = (LOOPBACK_SERVER*)concrete_io;
+    (void)on_io_error;
+    (void)on_io_error_context;
+    server->on_bytes_received = on_bytes_received;
+    server->on_bytes_received_context = on_bytes_received_context;
+    on_io_open_complete(on_io_open_complete_context, IO_OPEN_OK);
+    return 0;
+}
+
+static int loopback_io_close(CONCRETE_IO_HANDLE concrete_io, ON_IO_CLOSE_COMPLETE on_io_close_complete, void* callback_context)
+{
+    (void)concrete_io;
+    if (on_io_close_complete != NULL)
+    {
+        on_io_close_complete(callback_context);
+    }
+    return 0;
+}
+
+static int loopback_io_send(CONCRETE_IO_HANDLE concrete_io, const void* buffer, size_t size, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    LOOPBACK_SERVER* server = (LOOPBACK_SERVER*)concrete_io;
+    int result;
+
+    if (server->ssl == NULL)
+    {
+        /*no server, the SSL_CTX tests only look at what tlsio does until its ClientHello is sent*/
+        result = 0;
+    }
+    else if (g_discard_sent_bytes)
+    {
+        g_sent_bytes += size;
+        if (on_send_complete == NULL)
+        {
+            result = 0;
+        }
+        else if (!g_hold_send_completes)
+        {
+            on_send_complete(callback_context, IO_SEND_OK);
+            result = 0;
+        }
+        else if (g_held_send_count == TLSIO_OPENSSL_INT_MAX_HELD_SENDS)
+        {
+            result = MU_FAILURE;
+        }
+        else
+        {
+            g_held_sends[g_held_send_count].on_send_complete = on_send_complete;
+            g_held_sends[g_held_send_count].callback_context = callback_context;
+            g_held_send_count++;
+            result = 0;
+        }
+    }
+    else if (BIO_write(server->in_bio, buffer, (int)size) != (int)size)
+    {
+        result = MU_FAILURE;
+    }
+    else
+    {
+        server_drive();
+        if (on_send_complete != NULL)
+        {
+            on_send_complete(callback_context, IO_SEND_OK);
+        }
+        result = 0;
+    }
+
+    return result;
+}
+
+/*hands what the server wrote to tlsio, TLSIO_OPENSSL_INT_UNDERLYING_READ_SIZE bytes at a time*/
+static void loopback_io_dowork(CONCRETE_IO_HANDLE concrete_io)
+{
+    LOOPBACK_SERVER* server = (LOOPBACK_SERVER*)concrete_io;
+    int read_bytes;
+
+    while ((server->out_bio != NULL) && (read_bytes = BIO_read(server->out_bio, g_read_buffer, sizeof(g_read_buffer))) > 0)
+    {
+        server->on_bytes_received(server->on_bytes_received_context, g_read_buffer, (size_t)read_bytes);
+    }
+}
+
+static int loopback_io_setoption(CONCRETE_IO_HANDLE concrete_io, const char* optionName, const void* value)
+{
+    (void)concrete_io;
+    (void)optionName;
+    (void)value;
+    return 0;
+}
+
+static OPTIONHANDLER_HANDLE loopback_io_retrieveoptions(CONCRETE_IO_HANDLE concrete_io)
+{
+    (void)concrete_io;
+    return NULL;
+}
+
+static const IO_INTERFACE_DESCRIPTION loopback_io_interface_description =
+{
+    loopback_io_retrieveoptions,
+    loopback_io_create,
+    loopback_io_destroy,
+    loopback_io_open,
+    loopback_io_close,
+    loopback_io_send,
+    loopback_io_dowork,
+    loopback_io_setoption
+};
+
+static void on_io_open_complete(void* context, IO_OPEN_RESULT open_result)
+{
+    (void)context;
+    g_is_open = (open_result == IO_OPEN_OK);
+}
+
+static void on_bytes_received(void* context, const unsigned char* buffer, size_t size)
+{
+    size_t i;
+    (void)context;
+
+    for (i = 0; i < size; i++)
+    {
+        if (buffer[i] != g_record[(g_received_bytes + i) % sizeof(g_record)])
+        {
+            g_is_received_content_as_sent = false;
+        }
+    }
+    g_received_bytes += size;
+    g_receive_callbacks++;
+    if (size > g_largest_receive)
+    {
+        g_largest_receive = size;
+    }
+}
+
+static void on_send_complete(void* context, IO_SEND_RESULT send_result)
+{
+    ASSERT_IS_TRUE(g_send_complete_count < TLSIO_OPENSSL_INT_MAX_HELD_SENDS);
+    g_completed_sends[g_send_complete_count] = (size_t)context;
+    g_send_results[g_send_complete_count] = send_result;
+    g_send_complete_count++;
+}
+
+/*completes the held sends of the underlying IO, in the order they were sent*/
+static void complete_held_sends(size_t count, IO_SEND_RESULT send_result)
+{
+    size_t i;
+
+    ASSERT_IS_TRUE(count <= g_held_send_count);
+    for (i = 0; i < count; i++)
+    {
+        g_held_sends[i].on_send_complete(g_held_sends[i].callback_context, send_result);
+    }
+    (void)memmove(g_held_sends, g_held_sends + count, (g_held_send_count - count) * sizeof(HELD_SEND));
+    g_held_send_count -= count;
+}
+
+static void on_io_error(void* context)
+{
+    (void)context;
+    g_has_error = true;
+}
+
+/*a self signed certificate for localhost, trusted by the client*/
+static void create_server_credentials(void)
+{
+    EVP_PKEY_CTX* key_context = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, NULL);
+    X509_NAME* name;
+    X509_EXTENSION* subject_alt_name;
+    BIO* pem_bio;
+    char* pem;
+    long pem_length;
+
+    ASSERT_IS_NOT_NULL(key_context);
+    ASSERT_ARE_EQUAL(int, 1, EVP_PKEY_keygen_init(key_context));
+    ASSERT_ARE_EQUAL(int, 1, EVP_PKEY_CTX_set_rsa_keygen_bits(key_context, 2048));
+    ASSERT_ARE_EQUAL(int, 1, EVP_PKEY_keygen(key_context, &g_server_key));
+    EVP_PKEY_CTX_free(key_context);
+
+    g_server_certificate = X509_new();
+    ASSERT_IS_NOT_NULL(g_server_certificate);
+    (void)X509_set_version(g_server_certificate, 2);
+    (void)ASN1_INTEGER_set(X509_get_serialNumber(g_server_certificate), 1);
+    (void)X509_gmtime_adj(X509_get_notBefore(g_server_certificate), 0);
+    (void)X509_gmtime_adj(X509_get_notAfter(g_server_certificate), 24 * 60 * 60);
+    ASSERT_ARE_EQUAL(int, 1, X509_set_pubkey(g_server_certificate, g_server_key));
+    name = X509_get_subject_name(g_server_certificate);
+    (void)X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char*)"localhost", -1, -1, 0);
+    ASSERT_ARE_EQUAL(int, 1, X509_set_issuer_name(g_server_certificate, name));
+    subject_alt_name = X509V3_EXT_conf_nid(NULL, NULL, NID_subject_alt_name, "DNS:localhost");
+    ASSERT_IS_NOT_NULL(subject_alt_name);
+    (void)X509_add_ext(g_server_certificate, subject_alt_name, -1);
+    X509_EXTENSION_free(subject_alt_name);
+    ASSERT_IS_TRUE(X509_sign(g_server_certificate, g_server_key, EVP_sha256()) > 0);
+
+    pem_bio = BIO_new(BIO_s_mem());
+    ASSERT_IS_NOT_NULL(pem_bio);
+    ASSERT_ARE_EQUAL(int, 1, PEM_write_bio_X509(pem_bio, g_server_certificate));
+    pem_length = BIO_get_mem_data(pem_bio, &pem);
+    g_server_certificate_pem = (char*)malloc((size_t)pem_length + 1);
+    ASSERT_IS_NOT_NULL(g_server_certificate_pem);
+    (void)memcpy(g_server_certificate_pem, pem, (size_t)pem_length);
+    g_server_certificate_pem[pem_length] = '\0';
+    BIO_free(pem_bio);
+}
+
+/*the server certificate count times, trusted certificates no other test uses make SSL_CTXs no other test shares*/
+static char* create_trusted_certificates(size_t count)
+{
+    size_t pem_length = strlen(g_server_certificate_pem);
+    char* result = (char*)malloc((pem_length * count) + 1);
+    size_t i;
+
+    ASSERT_IS_NOT_NULL(result);
+    for (i = 0; i < count; i++)
+    {
+        (void)memcpy(result + (i * pem_length), g_server_certificate_pem, pem_length);
+    }
+    result[pem_length * count] = '\0';
+
+    return result;
+}
+
+/*one server context for all the connections, so that it resumes the sessions of the previous ones*/
+static void create_server_context(void)
+{
+    g_server_context = SSL_CTX_new(TLS_server_method());
+    ASSERT_IS_NOT_NULL(g_server_context);
+    ASSERT_ARE_EQUAL(int, 1, SSL_CTX_use_certificate(g_server_context, g_server_certificate));
+    ASSERT_ARE_EQUAL(int, 1, SSL_CTX_use_PrivateKey(g_server_context, g_server_key));
+}
+
+static void create_server(void)
+{
+    g_server.ssl = SSL_new(g_server_context);
+    ASSERT_IS_NOT_NULL(g_server.ssl);
+    g_server.in_bio = BIO_new(BIO_s_mem());
+    g_server.out_bio = BIO_new(BIO_s_mem());
+    ASSERT_IS_NOT_NULL(g_server.in_bio);
+    ASSERT_IS_NOT_NULL(g_server.out_bio);
+    SSL_set_bio(g_server.ssl, g_server.in_bio, g_server.out_bio);
+    SSL_set_accept_state(g_server.ssl);
+}
+
+static void destroy_server(void)
+{
+    SSL_free(g_server.ssl);
+    (void)memset(&g_server, 0, sizeof(g_server));
+}
+
+/*opens tlsio on a new server connection, up to the session tickets of the server*/
+static void open_tlsio(XIO_HANDLE tlsio)
+{
+    size_t i;
+
+    create_server();
+    g_is_open = false;
+    ASSERT_ARE_EQUAL(int, 0, xio_open(tlsio, on_io_open_complete, NULL, on_bytes_received, NULL, on_io_error, NULL));
+
+    for (i = 0; (i < 100) && !g_is_open && !g_has_error; i++)
+    {
+        xio_dowork(tlsio);
+    }
+    ASSERT_IS_TRUE(g_is_open);
+    /*the server answers the Finished message of the client with its TLS 1.3 session tickets, the next dowork hands them to tlsio*/
+    xio_dowork(tlsio);
+    ASSERT_IS_TRUE(SSL_is_init_finished(g_server.ssl) == 1);
+}
+
+static XIO_HANDLE create_tlsio(const char* trusted_certificates)
+{
+    TLSIO_CONFIG tlsio_config;
+    XIO_HANDLE result;
+
+    tlsio_config.hostname = "localhost";
+    tlsio_config.port = 443;
+    tlsio_config.underlying_io_interface = &loopback_io_interface_description;
+    tlsio_config.underlying_io_parameters = NULL;
+    tlsio_config.invoke_on_send_complete_callback_for_fragments = false;
+
+    result = xio_create(tlsio_openssl_get_interface_description(), &tlsio_config);
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(int, 0, xio_setoption(result, OPTION_TRUSTED_CERT, trusted_certificates));
+
+    return result;
+}
+
+static XIO_HANDLE create_open_tlsio(size_t receive_buffer_size)
+{
+    XIO_HANDLE result = create_tlsio(g_server_certificate_pem);
+    ASSERT_ARE_EQUAL(int, 0, xio_setoption(result, OPTION_TLS_RECEIVE_BUFFER_SIZE, &receive_buffer_size));
+    open_tlsio(result);
+
+    return result;
+}
+
+/*a connection to the server up to its session tickets, closed without close_notify as a destroyed connection is*/
+static void connect_with_session_cache(const char* trusted_certificates, bool ignore_host_name_check)
+{
+    XIO_HANDLE tlsio = create_tlsio(trusted_certificates);
+    bool is_session_cache_enabled = true;
+    ASSERT_ARE_EQUAL(int, 0, xio_setoption(tlsio, OPTION_TLS_SESSION_CACHE, &is_session_cache_enabled));
+    ASSERT_ARE_EQUAL(int, 0, xio_setoption(tlsio, "ignore_host_name_check", &ignore_host_name_check));
+    open_tlsio(tlsio);
+    xio_destroy(tlsio);
+    destroy_server();
+}
+
+/*the handshakes since before*/
+static TLSIO_HANDSHAKE_STATISTICS get_handshakes_since(const TLSIO_HANDSHAKE_STATISTICS* before)
+{
+    TLSIO_HANDSHAKE_STATISTICS result;
+    ASSERT_ARE_EQUAL(int, 0, tlsio_openssl_get_handshake_statistics(&result));
+
+    result.handshake_count -= before->handshake_count;
+    result.session_offer_count -= before->session_offer_count;
+    result.resumed_handshake_count -= before->resumed_handshake_count;
+
+    return result;
+}
+
+/*the server sends TLSIO_OPENSSL_INT_RECORD_COUNT full records, tlsio decrypts them*/
+static void receive_records(XIO_HANDLE tlsio)
+{
+    size_t i;
+
+    for (i = 0; i < TLSIO_OPENSSL_INT_RECORD_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, TLSIO_OPENSSL_INT_RECORD_SIZE, SSL_write(g_server.ssl, g_record, TLSIO_OPENSSL_INT_RECORD_SIZE));
+        xio_dowork(tlsio);
+    }
+}
+
+/*an array of the CONSTBUFFERs of g_record at each offset and of each size*/
+static CONSTBUFFER_ARRAY_HANDLE create_record_buffers(const size_t* offsets, const size_t* sizes, uint32_t count)
+{
+    CONSTBUFFER_HANDLE buffers[4];
+    CONSTBUFFER_ARRAY_HANDLE result;
+    uint32_t i;
+
+    ASSERT_IS_TRUE(count <= sizeof(buffers) / sizeof(buffers[0]));
+    for (i = 0; i < count; i++)
+    {
+        buffers[i] = CONSTBUFFER_Create(g_record + offsets[i], sizes[i]);
+        ASSERT_IS_NOT_NULL(buffers[i]);
+    }
+    result = constbuffer_array_create(buffers, count);
+    ASSERT_IS_NOT_NULL(result);
+    for (i = 0; i < count; i++)
+    {
+        CONSTBUFFER_DecRef(buffers[i]);
+    }
+
+    return result;
+}
+
+static void do_not_free(void* context)
+{
+    (void)context;
+}
+
+/*a connection that stays in its handshake, it has its SSL_CTX from xio_open on*/
+static XIO_HANDLE create_connecting_tlsio(const char* trusted_certificates)
+{
+    XIO_HANDLE result = create_tlsio(trusted_certificates);
+    ASSERT_ARE_EQUAL(int, 0, xio_open(result, on_io_open_complete, NULL, on_bytes_received, NULL, on_io_error, NULL));
+
+    return result;
+}
+
+BEGIN_TEST_SUITE(tlsio_openssl_int)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    size_t i;
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    ASSERT_ARE_EQUAL(int, 0, tlsio_openssl_init());
+    create_server_credentials();
+    create_server_context();
+    for (i = 0; i < sizeof(g_record); i++)
+    {
+        g_record[i] = (unsigned char)i;
+    }
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    SSL_CTX_free(g_server_context);
+    free(g_server_certificate_pem);
+    X509_free(g_server_certificate);
+    EVP_PKEY_free(g_server_key);
+    tlsio_openssl_deinit();
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    g_received_bytes = 0;
+    g_receive_callbacks = 0;
+    g_largest_receive = 0;
+    g_is_received_content_as_sent = true;
+    g_is_open = false;
+    g_has_error = false;
+    g_discard_sent_bytes = false;
+    g_hold_send_completes = false;
+    g_held_send_count = 0;
+    g_sent_bytes = 0;
+    g_send_complete_count = 0;
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+TEST_FUNCTION(tlsio_openssl_connections_with_the_same_options_share_the_ssl_context)
+{
+    ///arrange
+    char* trusted_certificates = create_trusted_certificates(2);
+    char* other_certificates = create_trusted_certificates(3);
+    XIO_HANDLE first = create_connecting_tlsio(trusted_certificates);
+    XIO_HANDLE second = create_connecting_tlsio(trusted_certificates);
+    XIO_HANDLE other = create_connecting_tlsio(other_certificates);
+    int shared_result;
+    int other_result;
+    int released_result;
+
+    ///act
+    /*the trusted certificates of an open connection can only be changed when it does not share its SSL_CTX*/
+    shared_result = xio_setoption(second, OPTION_TRUSTED_CERT, g_server_certificate_pem);
+    other_result = xio_setoption(other, OPTION_TRUSTED_CERT, g_server_certificate_pem);
+    xio_destroy(first);
+    released_result = xio_setoption(second, OPTION_TRUSTED_CERT, g_server_certificate_pem);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, shared_result);
+    ASSERT_ARE_EQUAL(int, 0, other_result);
+    ASSERT_ARE_EQUAL(int, 0, released_result);
+
+    ///cleanup
+    xio_destroy(second);
+    xio_destroy(other);
+    free(other_certificates);
+    free(trusted_certificates);
+}
+
+TEST_FUNCTION(tlsio_openssl_a_reopened_connection_takes_the_cached_ssl_context_again)
+{
+    ///arrange
+    char* trusted_certificates = create_trusted_certificates(4);
+    XIO_HANDLE first = create_connecting_tlsio(trusted_certificates);
+    XIO_HANDLE second = create_connecting_tlsio(trusted_certificates);
+    ASSERT_ARE_EQUAL(int, 0, xio_close(first, NULL, NULL));
+
+    ///act
+    ASSERT_ARE_EQUAL(int, 0, xio_open(first, on_io_open_complete, NULL, on_bytes_received, NULL, on_io_error, NULL));
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, xio_setoption(first, OPTION_TRUSTED_CERT, g_server_certificate_pem));
+    ASSERT_ARE_NOT_EQUAL(int, 0, xio_setoption(second, OPTION_TRUSTED_CERT, g_server_certificate_pem));
+
+    ///cleanup
+    xio_destroy(first);
+    xio_destroy(second);
+    free(trusted_certificates);
+}
+
+TEST_FUNCTION(tlsio_openssl_a_connection_opened_after_its_ssl_context_is_released_builds_a_new_one)
+{
+    ///arrange
+    char* trusted_certificates = create_trusted_certificates(5);
+    XIO_HANDLE first = create_connecting_tlsio(trusted_certificates);
+    XIO_HANDLE second;
+    xio_destroy(first);
+
+    ///act
+    second = create_connecting_tlsio(trusted_certificates);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, xio_setoption(second, OPTION_TRUSTED_CERT, g_server_certificate_pem));
+
+    ///cleanup
+    xio_destroy(second);
+    free(trusted_certificates);
+}
+
+TEST_FUNCTION(tlsio_openssl_connections_open_at_deinit_release_their_ssl_context_later)
+{
+    ///arrange
+    char* trusted_certificates = create_trusted_certificates(6);
+    XIO_HANDLE first = create_connecting_tlsio(trusted_certificates);
+    XIO_HANDLE second = create_connecting_tlsio(trusted_certificates);
+    XIO_HANDLE after_init;
+    tlsio_openssl_deinit();
+    ASSERT_ARE_EQUAL(int, 0, tlsio_openssl_init());
+
+    ///act
+    after_init = create_connecting_tlsio(trusted_certificates);
+
+    ///assert
+    /*the contexts still used at deinit are out of the cache, the next connection does not share them*/
+    ASSERT_ARE_EQUAL(int, 0, xio_setoption(after_init, OPTION_TRUSTED_CERT, g_server_certificate_pem));
+
+    ///cleanup
+    xio_destroy(first);
+    xio_destroy(second);
+    xio_destroy(after_init);
+    free(trusted_certificates);
+}
+
+TEST_FUNCTION(tlsio_openssl_an_open_connection_shares_the_ssl_context_with_a_new_one)
+{
+    ///arrange
+    char* trusted_certificates = create_trusted_certificates(7);
+    XIO_HANDLE open_tlsio_handle = create_tlsio(trusted_certificates);
+    XIO_HANDLE connecting;
+    open_tlsio(open_tlsio_handle);
+    /*the next connection stays in its handshake*/
+    destroy_server();
+
+    ///act
+    connecting = create_connecting_tlsio(trusted_certificates);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, xio_setoption(connecting, OPTION_TRUSTED_CERT, g_server_certificate_pem));
+    ASSERT_IS_FALSE(g_has_error);
+
+    ///cleanup
+    xio_destroy(connecting);
+    xio_destroy(open_tlsio_handle);
+    free(trusted_certificates);
+}
+
+TEST_FUNCTION(tlsio_openssl_indicates_a_record_in_one_call_with_the_default_receive_buffer)
+{
+    ///arrange
+    XIO_HANDLE tlsio = create_tlsio(g_server_certificate_pem);
+    open_tlsio(tlsio);
+
+    ///act
+    receive_records(tlsio);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, TLSIO_OPENSSL_INT_RECORD_COUNT * TLSIO_OPENSSL_INT_RECORD_SIZE, g_received_bytes);
+    ASSERT_IS_TRUE(g_is_received_content_as_sent);
+    ASSERT_ARE_EQUAL(size_t, TLSIO_OPENSSL_INT_RECORD_COUNT, g_receive_callbacks);
+    ASSERT_ARE_EQUAL(size_t, TLSIO_OPENSSL_INT_RECORD_SIZE, g_largest_receive);
+    ASSERT_IS_FALSE(g_has_error);
+
+    ///cleanup
+    xio_destroy(tlsio);
+    destroy_server();
+}
+
+TEST_FUNCTION(tlsio_openssl_indicates_at_most_the_receive_buffer_size_in_one_call)
+{
+    ///arrange
+    XIO_HANDLE tlsio = create_open_tlsio(64);
+
+    ///act
+    receive_records(tlsio);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, TLSIO_OPENSSL_INT_RECORD_COUNT * TLSIO_OPENSSL_INT_RECORD_SIZE, g_received_bytes);
+    ASSERT_IS_TRUE(g_is_received_content_as_sent);
+    ASSERT_ARE_EQUAL(size_t, g_received_bytes / 64, g_receive_callbacks);
+    ASSERT_ARE_EQUAL(size_t, 64, g_largest_receive);
+    ASSERT_IS_FALSE(g_has_error);
+
+    ///cleanup
+    xio_destroy(tlsio);
+    destroy_server();
+}
+
+TEST_FUNCTION(tlsio_openssl_indicates_the_small_records_received_together_in_one_call)
+{
+    ///arrange
+    XIO_HANDLE tlsio = create_tlsio(g_server_certificate_pem);
+    size_t i;
+    open_tlsio(tlsio);
+
+    ///act
+    /*the records the underlying IO hands to tlsio in one on_bytes_received are read into the same buffer*/
+    for (i = 0; i < TLSIO_OPENSSL_INT_RECORD_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 1024, SSL_write(g_server.ssl, g_record + (i * 1024), 1024));
+    }
+    xio_dowork(tlsio);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, TLSIO_OPENSSL_INT_RECORD_COUNT * 1024, g_received_bytes);
+    ASSERT_IS_TRUE(g_is_received_content_as_sent);
+    ASSERT_IS_TRUE(g_receive_callbacks < TLSIO_OPENSSL_INT_RECORD_COUNT);
+    ASSERT_IS_TRUE(g_largest_receive > 1024);
+    ASSERT_IS_FALSE(g_has_error);
+
+    ///cleanup
+    xio_destroy(tlsio);
+    destroy_server();
+}
+
+TEST_FUNCTION(tlsio_openssl_setoption_receive_buffer_size_fails_with_0)
+{
+    ///arrange
+    XIO_HANDLE tlsio = create_tlsio(g_server_certificate_pem);
+    size_t receive_buffer_size = 0;
+
+    ///act
+    int result = xio_setoption(tlsio, OPTION_TLS_RECEIVE_BUFFER_SIZE, &receive_buffer_size);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    ///cleanup
+    xio_destroy(tlsio);
+}
+
+TEST_FUNCTION(tlsio_openssl_setoption_receive_buffer_size_fails_while_open)
+{
+    ///arrange
+    XIO_HANDLE tlsio = create_open_tlsio(64);
+    size_t receive_buffer_size = 1024;
+
+    ///act
+    int result = xio_setoption(tlsio, OPTION_TLS_RECEIVE_BUFFER_SIZE, &receive_buffer_size);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    receive_records(tlsio);
+    ASSERT_ARE_EQUAL(size_t, 64, g_largest_receive);
+
+    ///cleanup
+    xio_destroy(tlsio);
+    destroy_server();
+}
+
+TEST_FUNCTION(tlsio_openssl_without_session_cache_does_full_handshakes)
+{
+    ///arrange
+    TLSIO_HANDSHAKE_STATISTICS before;
+    TLSIO_HANDSHAKE_STATISTICS handshakes;
+    size_t i;
+    ASSERT_ARE_EQUAL(int, 0, tlsio_openssl_get_handshake_statistics(&before));
+
+    ///act
+    for (i = 0; i < 3; i++)
+    {
+        XIO_HANDLE tlsio = create_tlsio(g_server_certificate_pem);
+        open_tlsio(tlsio);
+        xio_destroy(tlsio);
+        destroy_server();
+    }
+
+    ///assert
+    handshakes = get_handshakes_since(&before);
+    ASSERT_ARE_EQUAL(uint64_t, 3, handshakes.handshake_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, handshakes.session_offer_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, handshakes.resumed_handshake_count);
+    ASSERT_IS_FALSE(g_has_error);
+}
+
+TEST_FUNCTION(tlsio_openssl_with_session_cache_resumes_the_session_of_the_previous_connection)
+{
+    ///arrange
+    char* trusted_certificates = create_trusted_certificates(8);
+    TLSIO_HANDSHAKE_STATISTICS before;
+    TLSIO_HANDSHAKE_STATISTICS handshakes;
+    size_t i;
+    ASSERT_ARE_EQUAL(int, 0, tlsio_openssl_get_handshake_statistics(&before));
+
+    ///act
+    for (i = 0; i < 3; i++)
+    {
+        connect_with_session_cache(trusted_certificates, false);
+    }
+
+    ///assert
+    /*all but the first connection resume the session of the previous one*/
+    handshakes = get_handshakes_since(&before);
+    ASSERT_ARE_EQUAL(uint64_t, 3, handshakes.handshake_count);
+    ASSERT_ARE_EQUAL(uint64_t, 2, handshakes.session_offer_count);
+    ASSERT_ARE_EQUAL(uint64_t, 2, handshakes.resumed_handshake_count);
+    ASSERT_IS_FALSE(g_has_error);
+
+    ///cleanup
+    free(trusted_certificates);
+}
+
+TEST_FUNCTION(tlsio_openssl_does_not_resume_a_session_made_without_the_host_name_check_with_the_check)
+{
+    ///arrange
+    char* trusted_certificates = create_trusted_certificates(9);
+    TLSIO_HANDSHAKE_STATISTICS before;
+    TLSIO_HANDSHAKE_STATISTICS unchecked_then_checked;
+    TLSIO_HANDSHAKE_STATISTICS checked_again;
+    TLSIO_HANDSHAKE_STATISTICS unchecked_again;
+    connect_with_session_cache(trusted_certificates, true);
+    ASSERT_ARE_EQUAL(int, 0, tlsio_openssl_get_handshake_statistics(&before));
+
+    ///act
+    /*the peer is not verified without the host name check, the session does not vouch for the server*/
+    connect_with_session_cache(trusted_certificates, false);
+    unchecked_then_checked = get_handshakes_since(&before);
+    connect_with_session_cache(trusted_certificates, false);
+    checked_again = get_handshakes_since(&before);
+    connect_with_session_cache(trusted_certificates, true);
+    unchecked_again = get_handshakes_since(&before);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint64_t, 1, unchecked_then_checked.handshake_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, unchecked_then_checked.session_offer_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, unchecked_then_checked.resumed_handshake_count);
+    /*each kind of connection resumes the sessions of its own kind*/
+    ASSERT_ARE_EQUAL(uint64_t, 1, checked_again.session_offer_count);
+    ASSERT_ARE_EQUAL(uint64_t, 1, checked_again.resumed_handshake_count);
+    ASSERT_ARE_EQUAL(uint64_t, 2, unchecked_again.session_offer_count);
+    ASSERT_ARE_EQUAL(uint64_t, 2, unchecked_again.resumed_handshake_count);
+    ASSERT_IS_FALSE(g_has_error);
+
+    ///cleanup
+    free(trusted_certificates);
+}
+
+TEST_FUNCTION(tlsio_openssl_completes_each_send_once_the_underlying_io_sent_its_records)
+{
+    ///arrange
+    XIO_HANDLE tlsio = create_tlsio(g_server_certificate_pem);
+    size_t i;
+    open_tlsio(tlsio);
+    g_discard_sent_bytes = true;
+
+    ///act
+    /*sends of a full record each, then of a small one*/
+    ASSERT_ARE_EQUAL(int, 0, xio_send(tlsio, g_record, sizeof(g_record), on_send_complete, (void*)1));
+    ASSERT_ARE_EQUAL(int, 0, xio_send(tlsio, g_record, sizeof(g_record), on_send_complete, (void*)2));
+    ASSERT_ARE_EQUAL(int, 0, xio_send(tlsio, g_record, 100, on_send_complete, (void*)3));
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 3, g_send_complete_count);
+    for (i = 0; i < 3; i++)
+    {
+        ASSERT_ARE_EQUAL(size_t, i + 1, g_completed_sends[i]);
+        ASSERT_ARE_EQUAL(int, IO_SEND_OK, g_send_results[i]);
+    }
+    /*the records are sent with their headers*/
+    ASSERT_IS_TRUE(g_sent_bytes > (2 * sizeof(g_record)) + 100);
+    ASSERT_IS_FALSE(g_has_error);
+
+    ///cleanup
+    xio_destroy(tlsio);
+    destroy_server();
+}
+
+TEST_FUNCTION(tlsio_openssl_completes_the_sends_in_order_when_the_underlying_io_completes_later)
+{
+    ///arrange
+    XIO_HANDLE tlsio = create_tlsio(g_server_certificate_pem);
+    unsigned char* two_records = (unsigned char*)malloc(2 * sizeof(g_record));
+    size_t records_of_first_send;
+    ASSERT_IS_NOT_NULL(two_records);
+    (void)memset(two_records, 'x', 2 * sizeof(g_record));
+    open_tlsio(tlsio);
+    g_discard_sent_bytes = true;
+    g_hold_send_completes = true;
+    ASSERT_ARE_EQUAL(int, 0, xio_send(tlsio, two_records, 2 * sizeof(g_record), on_send_complete, (void*)1));
+    records_of_first_send = g_held_send_count;
+    ASSERT_ARE_EQUAL(size_t, 2, records_of_first_send);
+    ASSERT_ARE_EQUAL(int, 0, xio_send(tlsio, g_record, 100, on_send_complete, (void*)2));
+    ASSERT_ARE_EQUAL(int, 0, xio_send(tlsio, g_record, 100, on_send_complete, (void*)3));
+    ASSERT_ARE_EQUAL(size_t, records_of_first_send + 2, g_held_send_count);
+
+    ///act
+    /*the first send completes with its last record, a failed record fails the send it belongs to only*/
+    complete_held_sends(records_of_first_send - 1, IO_SEND_OK);
+    ASSERT_ARE_EQUAL(size_t, 0, g_send_complete_count);
+    complete_held_sends(1, IO_SEND_OK);
+    complete_held_sends(1, IO_SEND_ERROR);
+    complete_held_sends(1, IO_SEND_OK);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 3, g_send_complete_count);
+    ASSERT_ARE_EQUAL(size_t, 1, g_completed_sends[0]);
+    ASSERT_ARE_EQUAL(int, IO_SEND_OK, g_send_results[0]);
+    ASSERT_ARE_EQUAL(size_t, 2, g_completed_sends[1]);
+    ASSERT_ARE_EQUAL(int, IO_SEND_ERROR, g_send_results[1]);
+    ASSERT_ARE_EQUAL(size_t, 3, g_completed_sends[2]);
+    ASSERT_ARE_EQUAL(int, IO_SEND_OK, g_send_results[2]);
+
+    ///cleanup
+    xio_destroy(tlsio);
+    destroy_server();
+    free(two_records);
+}
+
+TEST_FUNCTION(tlsio_openssl_close_cancels_the_sends_the_underlying_io_did_not_complete)
+{
+    ///arrange
+    XIO_HANDLE tlsio = create_tlsio(g_server_certificate_pem);
+    open_tlsio(tlsio);
+    g_discard_sent_bytes = true;
+    g_hold_send_completes = true;
+    ASSERT_ARE_EQUAL(int, 0, xio_send(tlsio, g_record, 100, on_send_complete, (void*)1));
+    ASSERT_ARE_EQUAL(int, 0, xio_send(tlsio, g_record, 100, on_send_complete, (void*)2));
+
+    ///act
+    ASSERT_ARE_EQUAL(int, 0, xio_close(tlsio, NULL, NULL));
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 2, g_send_complete_count);
+    ASSERT_ARE_EQUAL(int, IO_SEND_CANCELLED, g_send_results[0]);
+    ASSERT_ARE_EQUAL(int, IO_SEND_CANCELLED, g_send_results[1]);
+
+    /*the records of the closed connection are not waited for by the sends of the next one*/
+    destroy_server();
+    g_discard_sent_bytes = false;
+    g_hold_send_completes = false;
+    g_held_send_count = 0;
+    open_tlsio(tlsio);
+    g_discard_sent_bytes = true;
+    ASSERT_ARE_EQUAL(int, 0, xio_send(tlsio, g_record, 100, on_send_complete, (void*)3));
+    ASSERT_ARE_EQUAL(size_t, 3, g_send_complete_count);
+    ASSERT_ARE_EQUAL(int, IO_SEND_OK, g_send_results[2]);
+    ASSERT_IS_FALSE(g_has_error);
+
+    ///cleanup
+    xio_destroy(tlsio);
+    destroy_server();
+}
+
+TEST_FUNCTION(tlsio_openssl_sends_through_a_memory_bio_without_tlsio_openssl_init)
+{
+    ///arrange
+    XIO_HANDLE tlsio;
+    tlsio_openssl_deinit();
+    tlsio = create_tlsio(g_server_certificate_pem);
+    open_tlsio(tlsio);
+    g_discard_sent_bytes = true;
+
+    ///act
+    ASSERT_ARE_EQUAL(int, 0, xio_send(tlsio, g_record, sizeof(g_record), on_send_complete, (void*)1));
+    ASSERT_ARE_EQUAL(int, 0, xio_send(tlsio, g_record, 100, on_send_complete, (void*)2));
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 2, g_send_complete_count);
+    ASSERT_ARE_EQUAL(size_t, 1, g_completed_sends[0]);
+    ASSERT_ARE_EQUAL(size_t, 2, g_completed_sends[1]);
+    ASSERT_IS_TRUE(g_sent_bytes > sizeof(g_record) + 100);
+    ASSERT_IS_FALSE(g_has_error);
+
+    ///cleanup
+    xio_destroy(tlsio);
+    destroy_server();
+    ASSERT_ARE_EQUAL(int, 0, tlsio_openssl_init());
+}
+
+TEST_FUNCTION(tlsio_openssl_send_array_sends_the_buffers_one_after_the_other)
+{
+    ///arrange
+    /*a small buffer gathered with the next one, a full record written as is, then small ones gathered again*/
+    static const size_t offsets[] = { 0, 0, 7, 1000 };
+    static const size_t sizes[] = { 100, TLSIO_OPENSSL_INT_RECORD_SIZE, 50, 3000 };
+    XIO_HANDLE tlsio = create_tlsio(g_server_certificate_pem);
+    CONSTBUFFER_ARRAY_HANDLE buffers = create_record_buffers(offsets, sizes, 4);
+    unsigned char* received = (unsigned char*)malloc(sizeof(g_record));
+    size_t received_size = 0;
+    size_t i;
+    ASSERT_IS_NOT_NULL(received);
+    open_tlsio(tlsio);
+
+    ///act
+    ASSERT_ARE_EQUAL(int, 0, xio_send_array(tlsio, buffers, on_send_complete, (void*)1));
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 1, g_send_complete_count);
+    ASSERT_ARE_EQUAL(size_t, 1, g_completed_sends[0]);
+    ASSERT_ARE_EQUAL(int, IO_SEND_OK, g_send_results[0]);
+    ASSERT_IS_FALSE(g_has_error);
+    /*the server reads the buffers in order*/
+    for (i = 0; i < 4; i++)
+    {
+        size_t read_size = 0;
+        while (read_size < sizes[i])
+        {
+            int read_bytes = SSL_read(g_server.ssl, received + read_size, (int)(sizes[i] - read_size));
+            ASSERT_IS_TRUE(read_bytes > 0);
+            read_size += (size_t)read_bytes;
+        }
+        ASSERT_ARE_EQUAL(int, 0, memcmp(received, g_record + offsets[i], sizes[i]));
+        received_size += read_size;
+    }
+    ASSERT_ARE_EQUAL(size_t, 100 + TLSIO_OPENSSL_INT_RECORD_SIZE + 50 + 3000, received_size);
+
+    ///cleanup
+    free(received);
+    constbuffer_array_dec_ref(buffers);
+    xio_destroy(tlsio);
+    destroy_server();
+}
+
+TEST_FUNCTION(tlsio_openssl_send_array_with_a_buffer_larger_than_INT_MAX_fails_and_the_tlsio_stays_open)
+{
+    ///arrange
+    XIO_HANDLE tlsio = create_tlsio(g_server_certificate_pem);
+    /*never read: tlsio rejects it before writing anything*/
+    CONSTBUFFER_HANDLE too_large = CONSTBUFFER_CreateWithCustomFree(g_record, (size_t)INT_MAX + 1, do_not_free, NULL);
+    CONSTBUFFER_HANDLE small = CONSTBUFFER_Create(g_record, 100);
+    CONSTBUFFER_HANDLE buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE buffer_array;
+    int result;
+    ASSERT_IS_NOT_NULL(too_large);
+    ASSERT_IS_NOT_NULL(small);
+    buffers[0] = small;
+    buffers[1] = too_large;
+    buffer_array = constbuffer_array_create(buffers, 2);
+    ASSERT_IS_NOT_NULL(buffer_array);
+    open_tlsio(tlsio);
+    g_discard_sent_bytes = true;
+
+    ///act
+    result = xio_send_array(tlsio, buffer_array, on_send_complete, (void*)1);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 0, g_send_complete_count);
+    ASSERT_ARE_EQUAL(size_t, 0, g_sent_bytes);
+    ASSERT_IS_FALSE(g_has_error);
+    /*nothing of the array was written, the connection goes on*/
+    ASSERT_ARE_EQUAL(int, 0, xio_send(tlsio, g_record, 100, on_send_complete, (void*)2));
+    ASSERT_ARE_EQUAL(size_t, 1, g_send_complete_count);
+    ASSERT_ARE_EQUAL(size_t, 2, g_completed_sends[0]);
+
+    ///cleanup
+    constbuffer_array_dec_ref(buffer_array);
+    CONSTBUFFER_DecRef(small);
+    CONSTBUFFER_DecRef(too_large);
+    xio_destroy(tlsio);
+    destroy_server();
+}
+
+END_TEST_SUITE(tlsio_openssl_int)
@@ -0,0 +1,639 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "openssl/ssl.h"
+#include "openssl/err.h"
+#include "openssl/evp.h"
+#include "openssl/pem.h"
+#include "openssl/rsa.h"
+#include "openssl/x509.h"
+#include "openssl/x509v3.h"
+
+#include "testrunnerswitcher.h"
+
+#include "azure_c_shared_utility/tlsio.h"
+#include "azure_c_shared_utility/tlsio_openssl.h"
+#include "azure_c_shared_utility/xio.h"
+#include "azure_c_shared_utility/shared_util_options.h"
+#include "azure_c_shared_utility/xlogging.h"
+#include "azure_c_shared_utility/gballoc.h"
+
+#include "perf_measure.h"
+
+#undef malloc
+#undef free
+
+/*plaintext sent by the server in one iteration, as 16KB records (the largest TLS record)*/
+#define TLSIO_OPENSSL_PERF_TRANSFER_SIZE (1024 * 1024)
+#define TLSIO_OPENSSL_PERF_RECORD_SIZE (16 * 1024)
+#define TLSIO_OPENSSL_PERF_ITERATIONS 200
+/*bytes handed to tlsio by one on_bytes_received of the underlying IO, what a socket read typically returns*/
+#define TLSIO_OPENSSL_PERF_UNDERLYING_READ_SIZE (16 * 1024)
+/*the trusted certificates set on each connection, a CA bundle is typically 100+ certificates*/
+#define TLSIO_OPENSSL_PERF_TRUSTED_CERTIFICATE_COUNT 100
+#define TLSIO_OPENSSL_PERF_CONNECTION_ITERATIONS 200
+#define TLSIO_OPENSSL_PERF_HANDSHAKE_ITERATIONS 100
+#define TLSIO_OPENSSL_PERF_SEND_ITERATIONS 200
+
+/*The server is an OpenSSL SSL object on memory BIOs in the same thread: what tlsio sends goes into the server read BIO,
+what the server writes is handed to tlsio by the dowork of the underlying IO below. This keeps sockets and scheduling
+out of the numbers, the time is the server encryption plus what tlsio does to decrypt and indicate the bytes.*/
+typedef struct LOOPBACK_SERVER_TAG
+{
+    SSL* ssl;
+    BIO* in_bio;
+    BIO* out_bio;
+    ON_BYTES_RECEIVED on_bytes_received;
+    void* on_bytes_received_context;
+} LOOPBACK_SERVER;
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static EVP_PKEY* g_server_key;
+static X509* g_server_certificate;
+static char* g_server_certificate_pem;
+static char* g_trusted_certificates;
+static SSL_CTX* g_server_context;
+static LOOPBACK_SERVER g_server;
+static unsigned char g_record[TLSIO_OPENSSL_PERF_RECORD_SIZE];
+static unsigned char g_read_buffer[TLSIO_OPENSSL_PERF_UNDERLYING_READ_SIZE];
+static size_t g_received_bytes;
+static size_t g_receive_callbacks;
+/*when set the underlying IO completes the sends without handing them to the server, the send tests only look at the client*/
+static bool g_discard_sent_bytes;
+static size_t g_sent_bytes;
+static size_t g_send_completes;
+static bool g_is_open;
+static bool g_has_error;
+
+static void server_drive(void)
+{
+    if (!SSL_is_init_finished(g_server.ssl))
+    {
+        (void)SSL_do_handshake(g_server.ssl);
+    }
+}
+
+static CONCRETE_IO_HANDLE loopback_io_create(void* io_create_parameters)
+{
+    (void)io_create_parameters;
+    return &g_server;
+}
+
+static void loopback_io_destroy(CONCRETE_IO_HANDLE concrete_io)
+{
+    (void)concrete_io;
+}
+
+static int loopback_io_open(CONCRETE_IO_HANDLE concrete_io, ON_IO_OPEN_COMPLETE on_io_open_complete, void* on_io_open_complete_context, ON_BYTES_RECEIVED on_bytes_received, void* on_bytes_received_context, ON_IO_ERROR on_io_error, void* on_io_error_context)
+{
+    LOOPBACK_SERVER* server = (LOOPBACK_SERVER*)concrete_io;
+    (void)on_io_error;
+    (void)on_io_error_context;
+    server->on_bytes_received = on_bytes_received;
+    server->on_bytes_received_context = on_bytes_received_context;
+    on_io_open_complete(on_io_open_complete_context, IO_OPEN_OK);
+    return 0;
+}
+
+static int loopback_io_close(CONCRETE_IO_HANDLE concrete_io, ON_IO_CLOSE_COMPLETE on_io_close_complete, void* callback_context)
+{
+    (void)concrete_io;
+    if (on_io_close_complete != NULL)
+    {
+        on_io_close_complete(callback_context);
+    }
+    return 0;
+}
+
+static int loopback_io_send(CONCRETE_IO_HANDLE concrete_io, const void* buffer, size_t size, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    LOOPBACK_SERVER* server = (LOOPBACK_SERVER*)concrete_io;
+    int result;
+
+    if (server->ssl == NULL)
+    {
+        /*no server, the connection setup tests only look at what tlsio does until its ClientHello is sent*/
+        result = 0;
+    }
+    else if (g_discard_sent_bytes)
+    {
+        g_sent_bytes += size;
+        if (on_send_complete != NULL)
+        {
+            on_send_complete(callback_context, IO_SEND_OK);
+        }
+        result = 0;
+    }
+    else if (BIO_write(server->in_bio, buffer, (int)size) != (int)size)
+    {
+        result = MU_FAILURE;
+    }
+    else
+    {
+        server_drive();
+        if (on_send_complete != NULL)
+        {
+            on_send_complete(callback_context, IO_SEND_OK);
+        }
+        result = 0;
+    }
+
+    return result;
+}
+
+/*hands what the server wrote to tlsio, TLSIO_OPENSSL_PERF_UNDERLYING_READ_SIZE bytes at a time*/
+static void loopback_io_dowork(CONCRETE_IO_HANDLE concrete_io)
+{
+    LOOPBACK_SERVER* server = (LOOPBACK_SERVER*)concrete_io;
+    int read_bytes;
+
+    while ((server->out_bio != NULL) && (read_bytes = BIO_read(server->out_bio, g_read_buffer, sizeof(g_read_buffer))) > 0)
+    {
+        server->on_bytes_received(server->on_bytes_received_context, g_read_buffer, (size_t)read_bytes);
+    }
+}
+
+static int loopback_io_setoption(CONCRETE_IO_HANDLE concrete_io, const char* optionName, const void* value)
+{
+    (void)concrete_io;
+    (void)optionName;
+    (void)value;
+    return 0;
+}
+
+static OPTIONHANDLER_HANDLE loopback_io_retrieveoptions(CONCRETE_IO_HANDLE concrete_io)
+{
+    (void)concrete_io;
+    return NULL;
+}
+
+static const IO_INTERFACE_DESCRIPTION loopback_io_interface_description =
+{
+    loopback_io_retrieveoptions,
+    loopback_io_create,
+    loopback_io_destroy,
+    loopback_io_open,
+    loopback_io_close,
+    loopback_io_send,
+    loopback_io_dowork,
+    loopback_io_setoption
+};
+
+static void on_io_open_complete(void* context, IO_OPEN_RESULT open_result)
+{
+    (void)context;
+    g_is_open = (open_result == IO_OPEN_OK);
+}
+
+static void on_bytes_received(void* context, const unsigned char* buffer, size_t size)
+{
+    (void)context;
+    (void)buffer;
+    g_received_bytes += size;
+    g_receive_callbacks++;
+}
+
+static void on_send_complete(void* context, IO_SEND_RESULT send_result)
+{
+    (void)context;
+    if (send_result == IO_SEND_OK)
+    {
+        g_send_completes++;
+    }
+    else
+    {
+        g_has_error = true;
+    }
+}
+
+static void on_io_error(void* context)
+{
+    (void)context;
+    g_has_error = true;
+}
+
+/*a self signed certificate for localhost, trusted by the client*/
+static void create_server_credentials(void)
+{
+    EVP_PKEY_CTX* key_context = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, NULL);
+    X509_NAME* name;
+    X509_EXTENSION* subject_alt_name;
+    BIO* pem_bio;
+    char* pem;
+    long pem_length;
+    size_t i;
+
+    ASSERT_IS_NOT_NULL(key_context);
+    ASSERT_ARE_EQUAL(int, 1, EVP_PKEY_keygen_init(key_context));
+    ASSERT_ARE_EQUAL(int, 1, EVP_PKEY_CTX_set_rsa_keygen_bits(key_context, 2048));
+    ASSERT_ARE_EQUAL(int, 1, EVP_PKEY_keygen(key_context, &g_server_key));
+    EVP_PKEY_CTX_free(key_context);
+
+    g_server_certificate = X509_new();
+    ASSERT_IS_NOT_NULL(g_server_certificate);
+    (void)X509_set_version(g_server_certificate, 2);
+    (void)ASN1_INTEGER_set(X509_get_serialNumber(g_server_certificate), 1);
+    (void)X509_gmtime_adj(X509_get_notBefore(g_server_certificate), 0);
+    (void)X509_gmtime_adj(X509_get_notAfter(g_server_certificate), 24 * 60 * 60);
+    ASSERT_ARE_EQUAL(int, 1, X509_set_pubkey(g_server_certificate, g_server_key));
+    name = X509_get_subject_name(g_server_certificate);
+    (void)X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char*)"localhost", -1, -1, 0);
+    ASSERT_ARE_EQUAL(int, 1, X509_set_issuer_name(g_server_certificate, name));
+    subject_alt_name = X509V3_EXT_conf_nid(NULL, NULL, NID_subject_alt_name, "DNS:localhost");
+    ASSERT_IS_NOT_NULL(subject_alt_name);
+    (void)X509_add_ext(g_server_certificate, subject_alt_name, -1);
+    X509_EXTENSION_free(subject_alt_name);
+    ASSERT_IS_TRUE(X509_sign(g_server_certificate, g_server_key, EVP_sha256()) > 0);
+
+    pem_bio = BIO_new(BIO_s_mem());
+    ASSERT_IS_NOT_NULL(pem_bio);
+    ASSERT_ARE_EQUAL(int, 1, PEM_write_bio_X509(pem_bio, g_server_certificate));
+    pem_length = BIO_get_mem_data(pem_bio, &pem);
+    g_server_certificate_pem = (char*)malloc((size_t)pem_length + 1);
+    ASSERT_IS_NOT_NULL(g_server_certificate_pem);
+    (void)memcpy(g_server_certificate_pem, pem, (size_t)pem_length);
+    g_server_certificate_pem[pem_length] = '\0';
+    BIO_free(pem_bio);
+
+    g_trusted_certificates = (char*)malloc(((size_t)pem_length * TLSIO_OPENSSL_PERF_TRUSTED_CERTIFICATE_COUNT) + 1);
+    ASSERT_IS_NOT_NULL(g_trusted_certificates);
+    for (i = 0; i < TLSIO_OPENSSL_PERF_TRUSTED_CERTIFICATE_COUNT; i++)
+    {
+        (void)memcpy(g_trusted_certificates + (i * (size_t)pem_length), g_server_certificate_pem, (size_t)pem_length);
+    }
+    g_trusted_certificates[(size_t)pem_length * TLSIO_OPENSSL_PERF_TRUSTED_CERTIFICATE_COUNT] = '\0';
+}
+
+/*one server context for all the connections, so that it resumes the sessions of the previous ones*/
+static void create_server_context(void)
+{
+    g_server_context = SSL_CTX_new(TLS_server_method());
+    ASSERT_IS_NOT_NULL(g_server_context);
+    ASSERT_ARE_EQUAL(int, 1, SSL_CTX_use_certificate(g_server_context, g_server_certificate));
+    ASSERT_ARE_EQUAL(int, 1, SSL_CTX_use_PrivateKey(g_server_context, g_server_key));
+}
+
+static void create_server(void)
+{
+    g_server.ssl = SSL_new(g_server_context);
+    ASSERT_IS_NOT_NULL(g_server.ssl);
+    g_server.in_bio = BIO_new(BIO_s_mem());
+    g_server.out_bio = BIO_new(BIO_s_mem());
+    ASSERT_IS_NOT_NULL(g_server.in_bio);
+    ASSERT_IS_NOT_NULL(g_server.out_bio);
+    SSL_set_bio(g_server.ssl, g_server.in_bio, g_server.out_bio);
+    SSL_set_accept_state(g_server.ssl);
+}
+
+static void destroy_server(void)
+{
+    SSL_free(g_server.ssl);
+    (void)memset(&g_server, 0, sizeof(g_server));
+}
+
+/*opens tlsio on a new server connection, up to the session tickets of the server*/
+static void open_tlsio(XIO_HANDLE tlsio)
+{
+    size_t i;
+
+    create_server();
+    g_is_open = false;
+    ASSERT_ARE_EQUAL(int, 0, xio_open(tlsio, on_io_open_complete, NULL, on_bytes_received, NULL, on_io_error, NULL));
+
+    for (i = 0; (i < 100) && !g_is_open && !g_has_error; i++)
+    {
+        xio_dowork(tlsio);
+    }
+    ASSERT_IS_TRUE(g_is_open);
+    /*the server answers the Finished message of the client with its TLS 1.3 session tickets, the next dowork hands them to tlsio*/
+    xio_dowork(tlsio);
+    ASSERT_IS_TRUE(SSL_is_init_finished(g_server.ssl) == 1);
+}
+
+static XIO_HANDLE create_open_tlsio(size_t receive_buffer_size, bool is_session_cache_enabled)
+{
+    TLSIO_CONFIG tlsio_config;
+    XIO_HANDLE result;
+
+    tlsio_config.hostname = "localhost";
+    tlsio_config.port = 443;
+    tlsio_config.underlying_io_interface = &loopback_io_interface_description;
+    tlsio_config.underlying_io_parameters = NULL;
+    tlsio_config.invoke_on_send_complete_callback_for_fragments = false;
+
+    result = xio_create(tlsio_openssl_get_interface_description(), &tlsio_config);
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(int, 0, xio_setoption(result, OPTION_TRUSTED_CERT, g_server_certificate_pem));
+    ASSERT_ARE_EQUAL(int, 0, xio_setoption(result, OPTION_TLS_RECEIVE_BUFFER_SIZE, &receive_buffer_size));
+    if (is_session_cache_enabled)
+    {
+        ASSERT_ARE_EQUAL(int, 0, xio_setoption(result, OPTION_TLS_SESSION_CACHE, &is_session_cache_enabled));
+    }
+    open_tlsio(result);
+
+    return result;
+}
+
+/*the server sends TLSIO_OPENSSL_PERF_TRANSFER_SIZE bytes, tlsio decrypts them*/
+static void transfer(void* context, size_t iteration)
+{
+    XIO_HANDLE tlsio = (XIO_HANDLE)context;
+    size_t sent;
+    (void)iteration;
+
+    for (sent = 0; sent < TLSIO_OPENSSL_PERF_TRANSFER_SIZE; sent += TLSIO_OPENSSL_PERF_RECORD_SIZE)
+    {
+        ASSERT_ARE_EQUAL(int, TLSIO_OPENSSL_PERF_RECORD_SIZE, SSL_write(g_server.ssl, g_record, TLSIO_OPENSSL_PERF_RECORD_SIZE));
+        xio_dowork(tlsio);
+    }
+}
+
+static void run_transfer(const char* name, size_t receive_buffer_size)
+{
+    XIO_HANDLE tlsio = create_open_tlsio(receive_buffer_size, false);
+    PERF_MEASURE_RESULT result;
+    double megabytes;
+
+    /*the receive buffer is allocated by the first read*/
+    transfer(tlsio, 0);
+    g_received_bytes = 0;
+    g_receive_callbacks = 0;
+
+    ///act
+    result = perf_measure_run(name, transfer, tlsio, TLSIO_OPENSSL_PERF_ITERATIONS);
+
+    ///assert
+    megabytes = (double)g_received_bytes / (1024.0 * 1024.0);
+    LogInfo("%s: %.1f MB/s, %.1f on_bytes_received calls per MB, %.3f allocations per MB", name,
+        (double)TLSIO_OPENSSL_PERF_TRANSFER_SIZE * 1000.0 / result.ns_per_op,
+        (double)g_receive_callbacks / megabytes,
+        result.allocations_per_op * (1024.0 * 1024.0) / TLSIO_OPENSSL_PERF_TRANSFER_SIZE);
+    /*what the receive buffer size changes in the calls is checked by tlsio_openssl_int*/
+    ASSERT_IS_FALSE(g_has_error);
+    ASSERT_ARE_EQUAL(size_t, 0, g_received_bytes % TLSIO_OPENSSL_PERF_TRANSFER_SIZE);
+
+    ///cleanup
+    xio_destroy(tlsio);
+    destroy_server();
+}
+
+static XIO_HANDLE create_connecting_tlsio(const char* trusted_certificates)
+{
+    TLSIO_CONFIG tlsio_config;
+    XIO_HANDLE result;
+
+    tlsio_config.hostname = "localhost";
+    tlsio_config.port = 443;
+    tlsio_config.underlying_io_interface = &loopback_io_interface_description;
+    tlsio_config.underlying_io_parameters = NULL;
+    tlsio_config.invoke_on_send_complete_callback_for_fragments = false;
+
+    result = xio_create(tlsio_openssl_get_interface_description(), &tlsio_config);
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(int, 0, xio_setoption(result, OPTION_TRUSTED_CERT, trusted_certificates));
+    ASSERT_ARE_EQUAL(int, 0, xio_open(result, on_io_open_complete, NULL, on_bytes_received, NULL, on_io_error, NULL));
+
+    return result;
+}
+
+/*creates a tlsio, opens it until the ClientHello is sent and destroys it*/
+static void connect(void* context, size_t iteration)
+{
+    XIO_HANDLE tlsio = create_connecting_tlsio(g_trusted_certificates);
+    (void)context;
+    (void)iteration;
+
+    /*destroying frees the SSL object as closing would, without the log of closing while the handshake is on*/
+    xio_destroy(tlsio);
+}
+
+static PERF_MEASURE_RESULT run_connect(const char* name)
+{
+    PERF_MEASURE_RESULT result = perf_measure_run(name, connect, NULL, TLSIO_OPENSSL_PERF_CONNECTION_ITERATIONS);
+
+    LogInfo("%s: %.1f us per connection setup, %.1f allocations", name, result.ns_per_op / 1000.0, result.allocations_per_op);
+    ASSERT_IS_FALSE(g_has_error);
+
+    return result;
+}
+
+/*tlsio encrypts TLSIO_OPENSSL_PERF_TRANSFER_SIZE bytes and sends them to the underlying IO*/
+static void send_through_tlsio(void* context, size_t iteration)
+{
+    XIO_HANDLE tlsio = (XIO_HANDLE)context;
+    size_t sent;
+    (void)iteration;
+
+    for (sent = 0; sent < TLSIO_OPENSSL_PERF_TRANSFER_SIZE; sent += TLSIO_OPENSSL_PERF_RECORD_SIZE)
+    {
+        ASSERT_ARE_EQUAL(int, 0, xio_send(tlsio, g_record, TLSIO_OPENSSL_PERF_RECORD_SIZE, on_send_complete, NULL));
+    }
+}
+
+/*what tlsio_openssl did before it wrote the records straight to the underlying IO: the server SSL object encrypts into
+its memory BIO, the ciphertext is read into a new buffer which is sent. The counts of the copies are in *context.*/
+static void send_through_memory_bio(void* context, size_t iteration)
+{
+    size_t* copied_bytes = (size_t*)context;
+    size_t sent;
+    (void)iteration;
+
+    for (sent = 0; sent < TLSIO_OPENSSL_PERF_TRANSFER_SIZE; sent += TLSIO_OPENSSL_PERF_RECORD_SIZE)
+    {
+        size_t pending;
+        unsigned char* bytes_to_send;
+
+        ASSERT_ARE_EQUAL(int, TLSIO_OPENSSL_PERF_RECORD_SIZE, SSL_write(g_server.ssl, g_record, TLSIO_OPENSSL_PERF_RECORD_SIZE));
+        pending = BIO_ctrl_pending(g_server.out_bio);
+        bytes_to_send = (unsigned char*)gballoc_malloc(pending);
+        ASSERT_IS_NOT_NULL(bytes_to_send);
+        ASSERT_ARE_EQUAL(int, (int)pending, BIO_read(g_server.out_bio, bytes_to_send, (int)pending));
+        *copied_bytes += pending;
+        ASSERT_ARE_EQUAL(int, 0, loopback_io_send(&g_server, bytes_to_send, pending, on_send_complete, NULL));
+        gballoc_free(bytes_to_send);
+    }
+}
+
+static void log_send(const char* name, PERF_MEASURE_RESULT result, size_t copied_bytes, size_t sent_bytes)
+{
+    double megabytes = (double)sent_bytes / (1024.0 * 1024.0);
+
+    LogInfo("%s: %.1f MB/s, %.3f allocations per MB, %.0f bytes copied per MB", name,
+        (double)TLSIO_OPENSSL_PERF_TRANSFER_SIZE * 1000.0 / result.ns_per_op,
+        result.allocations_per_op * (1024.0 * 1024.0) / TLSIO_OPENSSL_PERF_TRANSFER_SIZE,
+        (double)copied_bytes / megabytes);
+}
+
+/*a connection to the server, up to its session tickets*/
+static void handshake(void* context, size_t iteration)
+{
+    const bool* is_session_cache_enabled = (const bool*)context;
+    XIO_HANDLE tlsio;
+    (void)iteration;
+
+    tlsio = create_open_tlsio(TLSIO_OPENSSL_PERF_RECORD_SIZE, *is_session_cache_enabled);
+    xio_destroy(tlsio);
+    destroy_server();
+}
+
+static TLSIO_HANDSHAKE_STATISTICS run_handshakes(const char* name, bool is_session_cache_enabled)
+{
+    TLSIO_HANDSHAKE_STATISTICS before;
+    TLSIO_HANDSHAKE_STATISTICS result;
+
+    ASSERT_ARE_EQUAL(int, 0, tlsio_openssl_get_handshake_statistics(&before));
+    (void)perf_measure_run(name, handshake, &is_session_cache_enabled, TLSIO_OPENSSL_PERF_HANDSHAKE_ITERATIONS);
+    ASSERT_ARE_EQUAL(int, 0, tlsio_openssl_get_handshake_statistics(&result));
+
+    result.handshake_count -= before.handshake_count;
+    result.session_offer_count -= before.session_offer_count;
+    result.resumed_handshake_count -= before.resumed_handshake_count;
+    result.handshake_time_ms -= before.handshake_time_ms;
+    result.handshake_cpu_time_us -= before.handshake_cpu_time_us;
+
+    /*the time includes the server side of the handshake, the processor time is the client side*/
+    LogInfo("%s: %.1f%% resumed, %.3f ms per handshake, %.0f us of processor time in the client handshake", name,
+        (double)result.resumed_handshake_count * 100.0 / (double)result.handshake_count,
+        (double)result.handshake_time_ms / (double)result.handshake_count,
+        (double)result.handshake_cpu_time_us / (double)result.handshake_count);
+    ASSERT_IS_FALSE(g_has_error);
+
+    return result;
+}
+
+BEGIN_TEST_SUITE(tlsio_openssl_perf)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    ASSERT_ARE_EQUAL(int, 0, tlsio_openssl_init());
+    create_server_credentials();
+    create_server_context();
+    (void)memset(g_record, 'x', sizeof(g_record));
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    SSL_CTX_free(g_server_context);
+    free(g_trusted_certificates);
+    free(g_server_certificate_pem);
+    X509_free(g_server_certificate);
+    EVP_PKEY_free(g_server_key);
+    tlsio_openssl_deinit();
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    g_received_bytes = 0;
+    g_receive_callbacks = 0;
+    g_is_open = false;
+    g_has_error = false;
+    g_discard_sent_bytes = false;
+    g_sent_bytes = 0;
+    g_send_completes = 0;
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+TEST_FUNCTION(tlsio_openssl_receive_64_byte_reads_perf)
+{
+    run_transfer("receive 1MB through a 64 byte receive buffer", 64);
+}
+
+TEST_FUNCTION(tlsio_openssl_receive_16KB_reads_perf)
+{
+    run_transfer("receive 1MB through a 16KB receive buffer (default)", 16 * 1024);
+}
+
+TEST_FUNCTION(tlsio_openssl_receive_64KB_reads_perf)
+{
+    run_transfer("receive 1MB through a 64KB receive buffer", 64 * 1024);
+}
+
+TEST_FUNCTION(tlsio_openssl_send_perf)
+{
+    ///arrange
+    XIO_HANDLE tlsio = create_open_tlsio(TLSIO_OPENSSL_PERF_RECORD_SIZE, false);
+    PERF_MEASURE_RESULT memory_bio_result;
+    PERF_MEASURE_RESULT tlsio_result;
+    size_t memory_bio_copied_bytes = 0;
+    size_t memory_bio_sent_bytes;
+
+    g_discard_sent_bytes = true;
+    send_through_tlsio(tlsio, 0);
+    send_through_memory_bio(&memory_bio_copied_bytes, 0);
+    memory_bio_copied_bytes = 0;
+    g_sent_bytes = 0;
+
+    ///act
+    memory_bio_result = perf_measure_run("send 1MB, copied out of a memory BIO", send_through_memory_bio, &memory_bio_copied_bytes, TLSIO_OPENSSL_PERF_SEND_ITERATIONS);
+    memory_bio_sent_bytes = g_sent_bytes;
+    g_sent_bytes = 0;
+    g_send_completes = 0;
+    tlsio_result = perf_measure_run("send 1MB, written by the out BIO", send_through_tlsio, tlsio, TLSIO_OPENSSL_PERF_SEND_ITERATIONS);
+
+    ///assert
+    log_send("send 1MB, copied out of a memory BIO", memory_bio_result, memory_bio_copied_bytes, memory_bio_sent_bytes);
+    /*the bytes tlsio copies would be in buffers it allocates, it allocates none*/
+    log_send("send 1MB through tlsio", tlsio_result, 0, g_sent_bytes);
+    /*when the sends complete is checked by tlsio_openssl_int*/
+    ASSERT_IS_FALSE(g_has_error);
+    ASSERT_IS_TRUE(memory_bio_result.allocations_per_op > 0.0);
+    ASSERT_IS_TRUE(tlsio_result.allocations_per_op == 0.0);
+
+    ///cleanup
+    g_discard_sent_bytes = false;
+    xio_destroy(tlsio);
+    destroy_server();
+}
+
+TEST_FUNCTION(tlsio_openssl_connection_setup_perf)
+{
+    ///arrange
+    PERF_MEASURE_RESULT new_context_result;
+    PERF_MEASURE_RESULT shared_context_result;
+    XIO_HANDLE holder;
+
+    ///act
+    /*nothing keeps the SSL_CTX of a connection once it is closed, each one builds it as before the cache*/
+    new_context_result = run_connect("connection setup, new SSL_CTX");
+    /*an open connection with the same options keeps its SSL_CTX in the cache*/
+    holder = create_connecting_tlsio(g_trusted_certificates);
+    shared_context_result = run_connect("connection setup, shared SSL_CTX");
+
+    ///assert
+    ASSERT_IS_TRUE(shared_context_result.allocations_per_op < new_context_result.allocations_per_op);
+
+    ///cleanup
+    xio_destroy(holder);
+}
+
+TEST_FUNCTION(tlsio_openssl_handshake_perf)
+{
+    ///act
+    TLSIO_HANDSHAKE_STATISTICS full_handshakes = run_handshakes("handshakes without session cache", false);
+    TLSIO_HANDSHAKE_STATISTICS resumed_handshakes = run_handshakes("handshakes with session cache", true);
+
+    ///assert
+    /*which handshakes resume a session is checked by tlsio_openssl_int, the comparison needs some of them resumed*/
+    ASSERT_IS_TRUE(full_handshakes.handshake_count > 0);
+    ASSERT_IS_TRUE(resumed_handshakes.resumed_handshake_count > 0);
+}
+
+END_TEST_SUITE(tlsio_openssl_perf)
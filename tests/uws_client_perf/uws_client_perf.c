@@ -0,0 +1,276 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "testrunnerswitcher.h"
+
+#include "azure_c_shared_utility/uws_client.h"
+#include "azure_c_shared_utility/xio.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#include "perf_measure.h"
+
+#define UWS_CLIENT_PERF_ITERATIONS 2000
+/*frames in the stream fed to uws_client by one iteration*/
+#define UWS_CLIENT_PERF_FRAME_COUNT 64
+#define UWS_CLIENT_PERF_PAYLOAD_SIZE 1024
+/*header of a server frame with a 16 bit payload length*/
+#define UWS_CLIENT_PERF_HEADER_SIZE 4
+#define UWS_CLIENT_PERF_FRAME_SIZE (UWS_CLIENT_PERF_HEADER_SIZE + UWS_CLIENT_PERF_PAYLOAD_SIZE)
+#define UWS_CLIENT_PERF_STREAM_SIZE (UWS_CLIENT_PERF_FRAME_COUNT * UWS_CLIENT_PERF_FRAME_SIZE)
+
+/*an underlying IO that hands the bytes it is given by the test to uws_client*/
+typedef struct TEST_IO_TAG
+{
+    ON_BYTES_RECEIVED on_bytes_received;
+    void* on_bytes_received_context;
+} TEST_IO;
+
+typedef struct FEED_CONTEXT_TAG
+{
+    size_t chunk_size;
+} FEED_CONTEXT;
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_IO g_test_io;
+static unsigned char g_stream[UWS_CLIENT_PERF_STREAM_SIZE];
+static size_t g_received_frames;
+static size_t g_received_payload_bytes;
+static bool g_is_open;
+static bool g_has_error;
+
+static CONCRETE_IO_HANDLE test_io_create(void* io_create_parameters)
+{
+    (void)io_create_parameters;
+    return &g_test_io;
+}
+
+static void test_io_destroy(CONCRETE_IO_HANDLE concrete_io)
+{
+    (void)concrete_io;
+}
+
+static int test_io_open(CONCRETE_IO_HANDLE concrete_io, ON_IO_OPEN_COMPLETE on_io_open_complete, void* on_io_open_complete_context, ON_BYTES_RECEIVED on_bytes_received, void* on_bytes_received_context, ON_IO_ERROR on_io_error, void* on_io_error_context)
+{
+    TEST_IO* test_io = (TEST_IO*)concrete_io;
+    (void)on_io_error;
+    (void)on_io_error_context;
+    test_io->on_bytes_received = on_bytes_received;
+    test_io->on_bytes_received_context = on_bytes_received_context;
+    on_io_open_complete(on_io_open_complete_context, IO_OPEN_OK);
+    return 0;
+}
+
+static int test_io_close(CONCRETE_IO_HANDLE concrete_io, ON_IO_CLOSE_COMPLETE on_io_close_complete, void* callback_context)
+{
+    (void)concrete_io;
+    if (on_io_close_complete != NULL)
+    {
+        on_io_close_complete(callback_context);
+    }
+    return 0;
+}
+
+static int test_io_send(CONCRETE_IO_HANDLE concrete_io, const void* buffer, size_t size, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    (void)concrete_io;
+    (void)buffer;
+    (void)size;
+    if (on_send_complete != NULL)
+    {
+        on_send_complete(callback_context, IO_SEND_OK);
+    }
+    return 0;
+}
+
+static void test_io_dowork(CONCRETE_IO_HANDLE concrete_io)
+{
+    (void)concrete_io;
+}
+
+static int test_io_setoption(CONCRETE_IO_HANDLE concrete_io, const char* optionName, const void* value)
+{
+    (void)concrete_io;
+    (void)optionName;
+    (void)value;
+    return 0;
+}
+
+static OPTIONHANDLER_HANDLE test_io_retrieveoptions(CONCRETE_IO_HANDLE concrete_io)
+{
+    (void)concrete_io;
+    return NULL;
+}
+
+static const IO_INTERFACE_DESCRIPTION test_io_interface_description =
+{
+    test_io_retrieveoptions,
+    test_io_create,
+    test_io_destroy,
+    test_io_open,
+    test_io_close,
+    test_io_send,
+    test_io_dowork,
+    test_io_setoption
+};
+
+static void on_ws_open_complete(void* context, WS_OPEN_RESULT ws_open_result)
+{
+    (void)context;
+    g_is_open = (ws_open_result == WS_OPEN_OK);
+}
+
+static void on_ws_frame_received(void* context, unsigned char frame_type, const unsigned char* buffer, size_t size)
+{
+    (void)context;
+    (void)frame_type;
+    (void)buffer;
+    g_received_frames++;
+    g_received_payload_bytes += size;
+}
+
+static void on_ws_peer_closed(void* context, uint16_t* close_code, const unsigned char* extra_data, size_t extra_data_length)
+{
+    (void)context;
+    (void)close_code;
+    (void)extra_data;
+    (void)extra_data_length;
+}
+
+static void on_ws_error(void* context, WS_ERROR error_code)
+{
+    (void)context;
+    LogError("uws_client error %d", (int)error_code);
+    g_has_error = true;
+}
+
+static UWS_CLIENT_HANDLE create_open_uws_client(void)
+{
+    static const char upgrade_response[] = "HTTP/1.1 101 Switching Protocols\r\n\r\n";
+    WS_PROTOCOL protocols[] = { { "test_protocol" } };
+    UWS_CLIENT_HANDLE result = uws_client_create_with_io(&test_io_interface_description, NULL, "test_host", 443, "/test", protocols, 1);
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(int, 0, uws_client_open_async(result, on_ws_open_complete, NULL, on_ws_frame_received, NULL, on_ws_peer_closed, NULL, on_ws_error, NULL));
+    g_test_io.on_bytes_received(g_test_io.on_bytes_received_context, (const unsigned char*)upgrade_response, sizeof(upgrade_response) - 1);
+    ASSERT_IS_TRUE(g_is_open);
+    return result;
+}
+
+/*feeds the whole stream of frames to uws_client, chunk_size bytes at a time*/
+static void feed_stream(void* context, size_t iteration)
+{
+    const FEED_CONTEXT* feed_context = (const FEED_CONTEXT*)context;
+    size_t position;
+    (void)iteration;
+
+    for (position = 0; position < UWS_CLIENT_PERF_STREAM_SIZE; position += feed_context->chunk_size)
+    {
+        size_t size = UWS_CLIENT_PERF_STREAM_SIZE - position;
+        if (size > feed_context->chunk_size)
+        {
+            size = feed_context->chunk_size;
+        }
+        g_test_io.on_bytes_received(g_test_io.on_bytes_received_context, g_stream + position, size);
+    }
+}
+
+static void run_feed(const char* name, size_t chunk_size)
+{
+    FEED_CONTEXT feed_context;
+    PERF_MEASURE_RESULT result;
+    UWS_CLIENT_HANDLE uws_client = create_open_uws_client();
+    size_t frames_before;
+
+    feed_context.chunk_size = chunk_size;
+    /*a first pass grows the memory for partial frames, gballoc does not realloc blocks allocated before perf_measure_run initializes it*/
+    feed_stream(&feed_context, 0);
+
+    ///act
+    frames_before = g_received_frames;
+    result = perf_measure_run(name, feed_stream, &feed_context, UWS_CLIENT_PERF_ITERATIONS);
+
+    ///assert
+    LogInfo("%s: %.1f ns/frame, %.1f MB/s, %.3f allocations/frame", name,
+        result.ns_per_op / UWS_CLIENT_PERF_FRAME_COUNT,
+        (double)UWS_CLIENT_PERF_STREAM_SIZE * 1000.0 / result.ns_per_op,
+        result.allocations_per_op / UWS_CLIENT_PERF_FRAME_COUNT);
+    ASSERT_IS_FALSE(g_has_error);
+    ASSERT_IS_TRUE(g_received_frames > frames_before);
+    ASSERT_ARE_EQUAL(size_t, 0, (g_received_frames - frames_before) % UWS_CLIENT_PERF_FRAME_COUNT);
+    ASSERT_ARE_EQUAL(size_t, (size_t)UWS_CLIENT_PERF_PAYLOAD_SIZE * g_received_frames, g_received_payload_bytes);
+    /*once the memory for the partial frames has grown to a frame, receiving does not allocate*/
+    ASSERT_IS_TRUE(result.allocations_per_op == 0.0);
+
+    ///cleanup
+    uws_client_destroy(uws_client);
+}
+
+BEGIN_TEST_SUITE(uws_client_perf)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    size_t i;
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    /*unmasked final binary frames, as a server sends them*/
+    for (i = 0; i < UWS_CLIENT_PERF_FRAME_COUNT; i++)
+    {
+        unsigned char* frame = g_stream + (i * UWS_CLIENT_PERF_FRAME_SIZE);
+        frame[0] = 0x82;
+        frame[1] = 126;
+        frame[2] = (unsigned char)(UWS_CLIENT_PERF_PAYLOAD_SIZE >> 8);
+        frame[3] = (unsigned char)(UWS_CLIENT_PERF_PAYLOAD_SIZE & 0xFF);
+        (void)memset(frame + UWS_CLIENT_PERF_HEADER_SIZE, (int)(i & 0xFF), UWS_CLIENT_PERF_PAYLOAD_SIZE);
+    }
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    g_received_frames = 0;
+    g_received_payload_bytes = 0;
+    g_is_open = false;
+    g_has_error = false;
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+TEST_FUNCTION(uws_client_receive_whole_stream_perf)
+{
+    run_feed("receive 64 x 1KB frames in one call", UWS_CLIENT_PERF_STREAM_SIZE);
+}
+
+TEST_FUNCTION(uws_client_receive_1KB_chunks_perf)
+{
+    run_feed("receive 64 x 1KB frames in 1000 byte chunks", 1000);
+}
+
+TEST_FUNCTION(uws_client_receive_100_byte_chunks_perf)
+{
+    run_feed("receive 64 x 1KB frames in 100 byte chunks", 100);
+}
+
+TEST_FUNCTION(uws_client_receive_7_byte_chunks_perf)
+{
+    run_feed("receive 64 x 1KB frames in 7 byte chunks", 7);
+}
+
+END_TEST_SUITE(uws_client_perf)
@@ -17,6 +17,7 @@
 #include "umock_c/umock_c.h"
 #include "umock_c/umocktypes_charptr.h"
 #include "umock_c/umocktypes_bool.h"
+#include "umock_c/umocktypes_stdint.h"
 #include "umock_c/umock_c_negative_tests.h"
 
 /* Requirements not needed as they are optional:
@@ -232,6 +233,9 @@ static MAP_RESULT my_Map_GetInternals(MAP_HANDLE handle, const char*const** keys
 
 #include "azure_c_shared_utility/uws_client.h"
 
+#include "../real_test_files/real_constbuffer.h"
+#include "../real_test_files/real_constbuffer_array.h"
+
 static const WS_PROTOCOL protocols[] = { { "test_protocol" } };
 
 IMPLEMENT_UMOCK_C_ENUM_TYPE(WS_OPEN_RESULT, WS_OPEN_RESULT_VALUES);
@@ -432,6 +436,37 @@ extern "C" {
 }
 #endif
 
+static const unsigned char test_masking_key[] = { 0x01, 0x02, 0x03, 0x04 };
+static const unsigned char test_array_payload_1[] = { 0x42, 0x43 };
+static const unsigned char test_array_payload_2[] = { 0x44, 0x45, 0x46 };
+
+static int my_uws_frame_encoder_encode_header(unsigned char* header, size_t header_size, WS_FRAME_TYPE opcode, size_t length, bool is_masked, bool is_final, unsigned char reserved)
+{
+    (void)opcode;
+    (void)length;
+    (void)is_masked;
+    (void)is_final;
+    (void)reserved;
+    /* the masking key is always the end of a masked header */
+    (void)memcpy(header + header_size - sizeof(test_masking_key), test_masking_key, sizeof(test_masking_key));
+    return 0;
+}
+
+static CONSTBUFFER_ARRAY_HANDLE create_test_array_payload(void)
+{
+    CONSTBUFFER_HANDLE buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE result;
+    buffers[0] = real_CONSTBUFFER_Create(test_array_payload_1, sizeof(test_array_payload_1));
+    ASSERT_IS_NOT_NULL(buffers[0]);
+    buffers[1] = real_CONSTBUFFER_Create(test_array_payload_2, sizeof(test_array_payload_2));
+    ASSERT_IS_NOT_NULL(buffers[1]);
+    result = real_constbuffer_array_create(buffers, 2);
+    ASSERT_IS_NOT_NULL(result);
+    real_CONSTBUFFER_DecRef(buffers[0]);
+    real_CONSTBUFFER_DecRef(buffers[1]);
+    return result;
+}
+
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 
 static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
@@ -453,6 +488,8 @@ TEST_SUITE_INITIALIZE(suite_init)
     ASSERT_ARE_EQUAL(int, 0, result);
     result = umocktypes_bool_register_types();
     ASSERT_ARE_EQUAL(int, 0, result);
+    result = umocktypes_stdint_register_types();
+    ASSERT_ARE_EQUAL(int, 0, result);
 
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_realloc, my_gballoc_realloc);
@@ -482,6 +519,10 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_GLOBAL_MOCK_HOOK(BUFFER_u_char, real_BUFFER_u_char);
     REGISTER_GLOBAL_MOCK_HOOK(BUFFER_length, real_BUFFER_length);
     REGISTER_GLOBAL_MOCK_HOOK(uws_frame_encoder_encode, my_uws_frame_encoder_encode);
+    REGISTER_GLOBAL_MOCK_HOOK(uws_frame_encoder_encode_header, my_uws_frame_encoder_encode_header);
+    REGISTER_GLOBAL_MOCK_RETURN(uws_frame_encoder_get_header_size, 6);
+    REGISTER_CONSTBUFFER_GLOBAL_MOCK_HOOK();
+    REGISTER_CONSTBUFFER_ARRAY_GLOBAL_MOCK_HOOK();
     REGISTER_GLOBAL_MOCK_HOOK(Map_GetInternals, my_Map_GetInternals);
     REGISTER_GLOBAL_MOCK_RETURN(STRING_c_str, "test_str");
     REGISTER_GLOBAL_MOCK_RETURN(Map_Create, TEST_REQUEST_HEADERS_MAP);
@@ -517,6 +558,8 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(pfDestroyOption, void*);
     REGISTER_UMOCK_ALIAS_TYPE(MAP_FILTER_CALLBACK, void*);
     REGISTER_UMOCK_ALIAS_TYPE(MAP_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_ARRAY_HANDLE, void*);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -3844,7 +3887,6 @@ TEST_FUNCTION(when_1_extra_byte_is_received_the_open_complete_is_properly_indica
 
     EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_open_complete((void*)0x4242, WS_OPEN_OK));
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
 
     // act
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response));
@@ -3888,7 +3930,6 @@ TEST_FUNCTION(when_a_1_byte_binary_frame_is_received_it_shall_be_indicated_to_th
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_BINARY, IGNORED_ARG, 1))
         .ValidateArgumentBuffer(3, expected_payload, sizeof(expected_payload));
 
@@ -3925,7 +3966,6 @@ TEST_FUNCTION(when_a_1_byte_text_frame_is_received_it_shall_be_indicated_to_the_
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_TEXT, IGNORED_ARG, 1))
         .ValidateArgumentBuffer(3, expected_payload, sizeof(expected_payload));
 
@@ -3959,7 +3999,6 @@ TEST_FUNCTION(when_a_0_bytes_binary_frame_is_received_it_shall_be_indicated_to_t
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_BINARY, IGNORED_ARG, 0))
         .IgnoreArgument_buffer();
 
@@ -3993,7 +4032,6 @@ TEST_FUNCTION(when_a_0_bytes_text_frame_is_received_it_shall_be_indicated_to_the
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_TEXT, IGNORED_ARG, 0))
         .IgnoreArgument_buffer();
 
@@ -4047,10 +4085,6 @@ TEST_FUNCTION(when_a_fragmented_text_frame_is_received_it_shall_be_indicated_to_
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_TEXT, IGNORED_ARG, 255))
@@ -4109,10 +4143,6 @@ TEST_FUNCTION(when_a_fragmented_binary_frame_is_received_it_shall_be_indicated_t
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_BINARY, IGNORED_ARG, 255))
@@ -4131,6 +4161,40 @@ TEST_FUNCTION(when_a_fragmented_binary_frame_is_received_it_shall_be_indicated_t
     uws_client_destroy(uws_client);
 }
 
+/* Tests_SRS_UWS_CLIENT_01_535: [ The memory used to accumulate fragments shall be kept for the next fragmented messages and only grown when a fragment does not fit in it. ]*/
+TEST_FUNCTION(the_memory_for_fragments_is_reused_for_the_next_fragmented_message)
+{
+    // arrange
+    TLSIO_CONFIG tlsio_config;
+    UWS_CLIENT_HANDLE uws_client;
+    const char test_upgrade_response[] = "HTTP/1.1 101 Switching Protocols\r\n\r\n";
+    unsigned char first_message[] = { 0x02, 0x01, 0x41, 0x80, 0x01, 0x42 };
+    unsigned char second_message[] = { 0x02, 0x01, 0x43, 0x80, 0x01, 0x44 };
+    unsigned char expected_payload[] = { 0x43, 0x44 };
+
+    tlsio_config.hostname = "test_host";
+    tlsio_config.port = 444;
+
+    uws_client = uws_client_create("test_host", 444, "/aaa", true, protocols, sizeof(protocols) / sizeof(protocols[0]));
+    (void)uws_client_open_async(uws_client, test_on_ws_open_complete, (void*)0x4242, test_on_ws_frame_received, (void*)0x4243, test_on_ws_peer_closed, (void*)0x4301, test_on_ws_error, (void*)0x4244);
+    g_on_io_open_complete(g_on_io_open_complete_context, IO_OPEN_OK);
+    g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
+    g_on_bytes_received(g_on_bytes_received_context, first_message, sizeof(first_message));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_BINARY, IGNORED_ARG, 2))
+        .ValidateArgumentBuffer(3, expected_payload, sizeof(expected_payload));
+
+    // act
+    g_on_bytes_received(g_on_bytes_received_context, second_message, sizeof(second_message));
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    uws_client_destroy(uws_client);
+}
+
 /* Tests_SRS_UWS_CLIENT_01_217: [ The fragments of one message MUST NOT be interleaved between the fragments of another message unless an extension has been negotiated that can interpret the interleaving. ]*/
 TEST_FUNCTION(when_a_fragmented_frame_is_interleaved_within_another_fragmented_frame_there_is_an_error)
 {
@@ -4150,9 +4214,6 @@ TEST_FUNCTION(when_a_fragmented_frame_is_interleaved_within_another_fragmented_f
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_error((void*)0x4244, WS_ERROR_BAD_FRAME_RECEIVED));
 
     // act
@@ -4189,9 +4250,6 @@ TEST_FUNCTION(when_a_fragmented_frame_is_received_all_at_once_the_frame_is_indic
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_BINARY, IGNORED_ARG, 1))
         .IgnoreArgument_buffer();
@@ -4250,10 +4308,8 @@ TEST_FUNCTION(pong_frame_can_be_injected_in_middle_of_fragmented_message)
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_PONG_FRAME, IGNORED_ARG, 0, true, true, 0))
         .IgnoreArgument_payload()
         .CaptureReturn(&buffer_handle);
@@ -4268,9 +4324,6 @@ TEST_FUNCTION(pong_frame_can_be_injected_in_middle_of_fragmented_message)
     STRICT_EXPECTED_CALL(BUFFER_delete(IGNORED_ARG))
         .ValidateArgumentValue_handle(&buffer_handle);
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_TEXT, IGNORED_ARG, 255))
         .ValidateArgumentBuffer(3, result_payload, 255);
@@ -4307,7 +4360,6 @@ TEST_FUNCTION(when_a_fragmented_control_frame_is_received_there_is_an_error)
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_error((void*)0x4244, WS_ERROR_BAD_FRAME_RECEIVED));
 
     // act
@@ -4347,7 +4399,6 @@ TEST_FUNCTION(when_a_125_bytes_binary_frame_is_received_it_shall_be_indicated_to
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_BINARY, IGNORED_ARG, 125))
         .ValidateArgumentBuffer(3, &test_frame[2], 125);
 
@@ -4386,7 +4437,6 @@ TEST_FUNCTION(when_a_126_bytes_binary_frame_is_received_it_shall_be_indicated_to
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_BINARY, IGNORED_ARG, 126))
         .ValidateArgumentBuffer(3, &test_frame[4], 126);
 
@@ -4425,7 +4475,6 @@ TEST_FUNCTION(when_a_127_bytes_binary_frame_is_received_it_shall_be_indicated_to
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_BINARY, IGNORED_ARG, 127))
         .ValidateArgumentBuffer(3, &test_frame[4], 127);
 
@@ -4468,7 +4517,6 @@ TEST_FUNCTION(when_a_65535_bytes_binary_frame_is_received_it_shall_be_indicated_
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_BINARY, IGNORED_ARG, 65535))
         .ValidateArgumentBuffer(3, &test_frame[4], 65535);
 
@@ -4518,7 +4566,6 @@ TEST_FUNCTION(when_a_65536_bytes_binary_frame_is_received_it_shall_be_indicated_
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_BINARY, IGNORED_ARG, 65536))
         .ValidateArgumentBuffer(3, &test_frame[10], 65536);
 
@@ -4568,7 +4615,6 @@ TEST_FUNCTION(when_a_65537_bytes_binary_frame_is_received_it_shall_be_indicated_
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_BINARY, IGNORED_ARG, 65537))
         .ValidateArgumentBuffer(3, &test_frame[10], 65537);
 
@@ -4602,7 +4648,6 @@ TEST_FUNCTION(when_a_0_byte_binary_frame_is_received_with_16_bit_length_an_error
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_error((void*)0x4244, WS_ERROR_BAD_FRAME_RECEIVED));
 
     // act
@@ -4640,8 +4685,8 @@ TEST_FUNCTION(when_a_125_byte_binary_frame_is_received_with_16_bit_length_an_err
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_error((void*)0x4244, WS_ERROR_BAD_FRAME_RECEIVED));
+    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
 
     // act
     g_on_bytes_received(g_on_bytes_received_context, test_frame, sizeof(test_frame));
@@ -4672,7 +4717,6 @@ TEST_FUNCTION(when_a_0_byte_binary_frame_is_received_with_64_bit_length_an_error
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_error((void*)0x4244, WS_ERROR_BAD_FRAME_RECEIVED));
 
     // act
@@ -4720,8 +4764,8 @@ TEST_FUNCTION(when_a_65535_byte_binary_frame_is_received_with_64_bit_length_an_e
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_error((void*)0x4244, WS_ERROR_BAD_FRAME_RECEIVED));
+    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
 
     // act
     g_on_bytes_received(g_on_bytes_received_context, test_frame, 65535 + 10);
@@ -4753,7 +4797,6 @@ TEST_FUNCTION(check_for_16_bit_length_too_low_is_done_as_soon_as_length_is_recei
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_error((void*)0x4244, WS_ERROR_BAD_FRAME_RECEIVED));
 
     // act
@@ -4785,7 +4828,6 @@ TEST_FUNCTION(check_for_64_bit_length_too_low_is_done_as_soon_as_length_is_recei
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_error((void*)0x4244, WS_ERROR_BAD_FRAME_RECEIVED));
 
     // act
@@ -4833,8 +4875,8 @@ TEST_FUNCTION(when_the_highest_bit_is_set_in_a_64_bit_length_frame_an_error_is_i
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_error((void*)0x4244, WS_ERROR_BAD_FRAME_RECEIVED));
+    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
 
     // act
     g_on_bytes_received(g_on_bytes_received_context, test_frame, 65536 + 10);
@@ -4854,7 +4896,8 @@ TEST_FUNCTION(when_allocating_memory_for_the_received_frame_bytes_fails_an_error
     TLSIO_CONFIG tlsio_config;
     UWS_CLIENT_HANDLE uws_client;
     const char test_upgrade_response[] = "HTTP/1.1 101 Switching Protocols\r\n\r\n";
-    unsigned char test_frame[] = { 0x82, 0x00 };
+    /* only the header of a frame with 126 bytes of payload, more than the bytes kept from the upgrade response fit */
+    unsigned char test_frame[64] = { 0x82, 0x7E, 0x00, 0x7E };
 
     tlsio_config.hostname = "test_host";
     tlsio_config.port = 444;
@@ -4879,6 +4922,152 @@ TEST_FUNCTION(when_allocating_memory_for_the_received_frame_bytes_fails_an_error
     uws_client_destroy(uws_client);
 }
 
+/* Tests_SRS_UWS_CLIENT_01_532: [ If no bytes are waiting for the rest of their frame, the frames shall be decoded from buffer without copying them. ]*/
+TEST_FUNCTION(frames_received_in_one_call_are_decoded_without_allocating_memory)
+{
+    // arrange
+    TLSIO_CONFIG tlsio_config;
+    UWS_CLIENT_HANDLE uws_client;
+    const char test_upgrade_response[] = "HTTP/1.1 101 Switching Protocols\r\n\r\n";
+    unsigned char test_frames[] = { 0x82, 0x01, 0x42, 0x81, 0x01, 0x43 };
+    unsigned char expected_binary_payload[] = { 0x42 };
+    unsigned char expected_text_payload[] = { 0x43 };
+
+    tlsio_config.hostname = "test_host";
+    tlsio_config.port = 444;
+
+    uws_client = uws_client_create("test_host", 444, "/aaa", true, protocols, sizeof(protocols) / sizeof(protocols[0]));
+    (void)uws_client_open_async(uws_client, test_on_ws_open_complete, (void*)0x4242, test_on_ws_frame_received, (void*)0x4243, test_on_ws_peer_closed, (void*)0x4301, test_on_ws_error, (void*)0x4244);
+    g_on_io_open_complete(g_on_io_open_complete_context, IO_OPEN_OK);
+    g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_BINARY, IGNORED_ARG, 1))
+        .ValidateArgumentBuffer(3, expected_binary_payload, sizeof(expected_binary_payload));
+    STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_TEXT, IGNORED_ARG, 1))
+        .ValidateArgumentBuffer(3, expected_text_payload, sizeof(expected_text_payload));
+
+    // act
+    g_on_bytes_received(g_on_bytes_received_context, test_frames, sizeof(test_frames));
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    uws_client_destroy(uws_client);
+}
+
+/* Tests_SRS_UWS_CLIENT_01_536: [ The bytes left in buffer after decoding in place shall be copied to wait for the rest of their frame. ]*/
+/* Tests_SRS_UWS_CLIENT_01_533: [ Otherwise the received bytes shall be appended to the bytes waiting for the rest of their frame. ]*/
+/* Tests_SRS_UWS_CLIENT_01_534: [ The memory used to accumulate bytes shall be kept for the next frames and only grown when the bytes do not fit in it. ]*/
+TEST_FUNCTION(a_frame_split_in_2_calls_that_fits_the_accumulated_bytes_memory_is_decoded_without_allocating_memory)
+{
+    // arrange
+    TLSIO_CONFIG tlsio_config;
+    UWS_CLIENT_HANDLE uws_client;
+    const char test_upgrade_response[] = "HTTP/1.1 101 Switching Protocols\r\n\r\n";
+    unsigned char test_frame_part1[] = { 0x82 };
+    unsigned char test_frame_part2[] = { 0x01, 0x42 };
+    unsigned char expected_payload[] = { 0x42 };
+
+    tlsio_config.hostname = "test_host";
+    tlsio_config.port = 444;
+
+    uws_client = uws_client_create("test_host", 444, "/aaa", true, protocols, sizeof(protocols) / sizeof(protocols[0]));
+    (void)uws_client_open_async(uws_client, test_on_ws_open_complete, (void*)0x4242, test_on_ws_frame_received, (void*)0x4243, test_on_ws_peer_closed, (void*)0x4301, test_on_ws_error, (void*)0x4244);
+    g_on_io_open_complete(g_on_io_open_complete_context, IO_OPEN_OK);
+    g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_BINARY, IGNORED_ARG, 1))
+        .ValidateArgumentBuffer(3, expected_payload, sizeof(expected_payload));
+
+    // act
+    g_on_bytes_received(g_on_bytes_received_context, test_frame_part1, sizeof(test_frame_part1));
+    g_on_bytes_received(g_on_bytes_received_context, test_frame_part2, sizeof(test_frame_part2));
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    uws_client_destroy(uws_client);
+}
+
+/* Tests_SRS_UWS_CLIENT_01_533: [ Otherwise the received bytes shall be appended to the bytes waiting for the rest of their frame. ]*/
+/* Tests_SRS_UWS_CLIENT_01_534: [ The memory used to accumulate bytes shall be kept for the next frames and only grown when the bytes do not fit in it. ]*/
+TEST_FUNCTION(a_frame_split_in_2_calls_that_does_not_fit_the_accumulated_bytes_memory_grows_it_once)
+{
+    // arrange
+    TLSIO_CONFIG tlsio_config;
+    UWS_CLIENT_HANDLE uws_client;
+    const char test_upgrade_response[] = "HTTP/1.1 101 Switching Protocols\r\n\r\n";
+    unsigned char test_frame_header[] = { 0x82, 0x7E, 0x00, 0x7E };
+    unsigned char test_frame_payload[126];
+    size_t i;
+
+    for (i = 0; i < sizeof(test_frame_payload); i++)
+    {
+        test_frame_payload[i] = (unsigned char)i;
+    }
+
+    tlsio_config.hostname = "test_host";
+    tlsio_config.port = 444;
+
+    uws_client = uws_client_create("test_host", 444, "/aaa", true, protocols, sizeof(protocols) / sizeof(protocols[0]));
+    (void)uws_client_open_async(uws_client, test_on_ws_open_complete, (void*)0x4242, test_on_ws_frame_received, (void*)0x4243, test_on_ws_peer_closed, (void*)0x4301, test_on_ws_error, (void*)0x4244);
+    g_on_io_open_complete(g_on_io_open_complete_context, IO_OPEN_OK);
+    g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
+    g_on_bytes_received(g_on_bytes_received_context, test_frame_header, sizeof(test_frame_header));
+    umock_c_reset_all_calls();
+
+    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_BINARY, IGNORED_ARG, sizeof(test_frame_payload)))
+        .ValidateArgumentBuffer(3, test_frame_payload, sizeof(test_frame_payload));
+
+    // act
+    g_on_bytes_received(g_on_bytes_received_context, test_frame_payload, sizeof(test_frame_payload));
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    uws_client_destroy(uws_client);
+}
+
+/* Tests_SRS_UWS_CLIENT_01_418: [ If allocating memory for the bytes accumulated for decoding WebSocket frames fails, an error shall be indicated by calling the on_ws_error callback with WS_ERROR_NOT_ENOUGH_MEMORY. ]*/
+TEST_FUNCTION(when_growing_the_memory_for_the_accumulated_bytes_fails_an_error_is_indicated)
+{
+    // arrange
+    TLSIO_CONFIG tlsio_config;
+    UWS_CLIENT_HANDLE uws_client;
+    const char test_upgrade_response[] = "HTTP/1.1 101 Switching Protocols\r\n\r\n";
+    unsigned char test_frame_header[] = { 0x82, 0x7E, 0x00, 0x7E };
+    unsigned char test_frame_payload[126] = { 0 };
+
+    tlsio_config.hostname = "test_host";
+    tlsio_config.port = 444;
+
+    uws_client = uws_client_create("test_host", 444, "/aaa", true, protocols, sizeof(protocols) / sizeof(protocols[0]));
+    (void)uws_client_open_async(uws_client, test_on_ws_open_complete, (void*)0x4242, test_on_ws_frame_received, (void*)0x4243, test_on_ws_peer_closed, (void*)0x4301, test_on_ws_error, (void*)0x4244);
+    g_on_io_open_complete(g_on_io_open_complete_context, IO_OPEN_OK);
+    g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
+    g_on_bytes_received(g_on_bytes_received_context, test_frame_header, sizeof(test_frame_header));
+    umock_c_reset_all_calls();
+
+    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(test_on_ws_error((void*)0x4244, WS_ERROR_NOT_ENOUGH_MEMORY));
+
+    // act
+    g_on_bytes_received(g_on_bytes_received_context, test_frame_payload, sizeof(test_frame_payload));
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    uws_client_destroy(uws_client);
+}
+
 /* Tests_SRS_UWS_CLIENT_01_384: [ Any extra bytes that are left unconsumed after decoding a succesfull WebSocket upgrade response shall be used for decoding WebSocket frames ]*/
 TEST_FUNCTION(when_1_byte_is_received_together_with_the_upgrade_request_and_one_byte_with_a_separate_call_decoding_frame_succeeds)
 {
@@ -4901,7 +5090,6 @@ TEST_FUNCTION(when_1_byte_is_received_together_with_the_upgrade_request_and_one_
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)upgrade_response_frame, sizeof(test_upgrade_response));
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_frame_received((void*)0x4243, WS_FRAME_TYPE_BINARY, IGNORED_ARG, 0))
         .IgnoreArgument_buffer();
 
@@ -5061,7 +5249,6 @@ TEST_FUNCTION(when_a_masked_frame_is_received_an_error_is_indicated_and_connecti
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response));
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_CLOSE_FRAME, IGNORED_ARG, sizeof(close_frame_payload), true, true, 0))
         .ValidateArgumentBuffer(2, close_frame_payload, sizeof(close_frame_payload))
         .CaptureReturn(&buffer_handle);
@@ -5113,7 +5300,6 @@ TEST_FUNCTION(when_a_masked_frame_is_received_and_encoding_the_close_frame_fails
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response));
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_CLOSE_FRAME, IGNORED_ARG, sizeof(close_frame_payload), true, true, 0))
         .ValidateArgumentBuffer(2, close_frame_payload, sizeof(close_frame_payload))
         .SetReturn(NULL);
@@ -5153,7 +5339,6 @@ TEST_FUNCTION(when_a_masked_frame_is_received_and_sending_the_encoded_CLOSE_fram
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response));
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_CLOSE_FRAME, IGNORED_ARG, sizeof(close_frame_payload), true, true, 0))
         .ValidateArgumentBuffer(2, close_frame_payload, sizeof(close_frame_payload))
         .CaptureReturn(&buffer_handle);
@@ -5211,7 +5396,6 @@ TEST_FUNCTION(when_a_CLOSE_frame_is_received_while_in_open_the_code_is_reported_
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_CLOSE_FRAME, NULL, 0, true, true, 0))
         .CaptureReturn(&buffer_handle);
     STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_ARG))
@@ -5264,7 +5448,6 @@ TEST_FUNCTION(when_a_CLOSE_frame_is_received_without_a_close_code_while_in_open_
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_CLOSE_FRAME, NULL, 0, true, true, 0))
         .CaptureReturn(&buffer_handle);
     STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_ARG))
@@ -5315,7 +5498,6 @@ TEST_FUNCTION(when_a_CLOSE_frame_is_received_with_extra_bytes_the_bytes_are_pass
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(utf8_checker_is_valid_utf8(IGNORED_ARG, 2))
         .ValidateArgumentBuffer(1, &close_frame[4], 2);
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_CLOSE_FRAME, NULL, 0, true, true, 0))
@@ -5365,7 +5547,6 @@ TEST_FUNCTION(when_a_CLOSE_frame_is_received_with_a_malformed_UTF8_text_the_conn
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(utf8_checker_is_valid_utf8(IGNORED_ARG, 1))
         .ValidateArgumentBuffer(1, &close_frame[4], 1)
         .SetReturn(false);
@@ -5406,7 +5587,6 @@ TEST_FUNCTION(when_a_CLOSE_frame_is_received_while_in_open_and_encoding_the_outg
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_CLOSE_FRAME, NULL, 0, true, true, 0))
         .SetReturn(NULL);
     STRICT_EXPECTED_CALL(xio_close(TEST_IO_HANDLE, IGNORED_ARG, IGNORED_ARG))
@@ -5448,7 +5628,6 @@ TEST_FUNCTION(when_a_CLOSE_frame_is_received_while_in_open_and_sending_the_outgo
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_CLOSE_FRAME, NULL, 0, true, true, 0))
         .CaptureReturn(&buffer_handle);
     STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_ARG))
@@ -6262,6 +6441,214 @@ TEST_FUNCTION(on_underlying_io_send_complete_with_an_unknown_result_indicates_an
     uws_client_destroy(uws_client);
 }
 
+/* uws_client_send_frame_array_async */
+
+/* Tests_SRS_UWS_CLIENT_04_001: [ If uws_client or buffers is NULL, uws_client_send_frame_array_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(uws_client_send_frame_array_async_with_NULL_handle_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE buffers = create_test_array_payload();
+    int result;
+    umock_c_reset_all_calls();
+
+    // act
+    result = uws_client_send_frame_array_async(NULL, WS_FRAME_TYPE_BINARY, buffers, true, test_on_ws_send_frame_complete, (void*)0x4248);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/* Tests_SRS_UWS_CLIENT_04_001: [ If uws_client or buffers is NULL, uws_client_send_frame_array_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(uws_client_send_frame_array_async_with_NULL_buffers_fails)
+{
+    // arrange
+    UWS_CLIENT_HANDLE uws_client;
+    const char test_upgrade_response[] = "HTTP/1.1 101 Switching Protocols\r\n\r\n";
+    int result;
+
+    uws_client = uws_client_create("test_host", 444, "/aaa", true, protocols, sizeof(protocols) / sizeof(protocols[0]));
+    (void)uws_client_open_async(uws_client, test_on_ws_open_complete, (void*)0x4242, test_on_ws_frame_received, (void*)0x4243, test_on_ws_peer_closed, (void*)0x4301, test_on_ws_error, (void*)0x4244);
+    g_on_io_open_complete(g_on_io_open_complete_context, IO_OPEN_OK);
+    g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response));
+    umock_c_reset_all_calls();
+
+    // act
+    result = uws_client_send_frame_array_async(uws_client, WS_FRAME_TYPE_BINARY, NULL, true, test_on_ws_send_frame_complete, (void*)0x4248);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    uws_client_destroy(uws_client);
+}
+
+/* Tests_SRS_UWS_CLIENT_04_002: [ If the uws instance is not OPEN then uws_client_send_frame_array_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(uws_client_send_frame_array_async_when_not_open_fails)
+{
+    // arrange
+    UWS_CLIENT_HANDLE uws_client;
+    CONSTBUFFER_ARRAY_HANDLE buffers = create_test_array_payload();
+    int result;
+
+    uws_client = uws_client_create("test_host", 444, "/aaa", true, protocols, sizeof(protocols) / sizeof(protocols[0]));
+    umock_c_reset_all_calls();
+
+    // act
+    result = uws_client_send_frame_array_async(uws_client, WS_FRAME_TYPE_BINARY, buffers, true, test_on_ws_send_frame_complete, (void*)0x4248);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    uws_client_destroy(uws_client);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+static void setup_uws_client_send_frame_array_async_expectations(CONSTBUFFER_ARRAY_HANDLE buffers)
+{
+    /* the masking key rotated by the 2 bytes of the first buffer */
+    static const unsigned char rotated_masking_key[] = { 0x03, 0x04, 0x01, 0x02 };
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(uws_frame_encoder_get_header_size(5, true));
+    STRICT_EXPECTED_CALL(gballoc_malloc(6 + 5));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(uws_frame_encoder_encode_header(IGNORED_ARG, 6, WS_BINARY_FRAME, 5, true, true, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(uws_frame_encoder_mask(IGNORED_ARG, IGNORED_ARG, sizeof(test_array_payload_1), IGNORED_ARG))
+        .ValidateArgumentBuffer(2, test_array_payload_1, sizeof(test_array_payload_1))
+        .ValidateArgumentBuffer(4, test_masking_key, sizeof(test_masking_key));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(uws_frame_encoder_mask(IGNORED_ARG, IGNORED_ARG, sizeof(test_array_payload_2), IGNORED_ARG))
+        .ValidateArgumentBuffer(2, test_array_payload_2, sizeof(test_array_payload_2))
+        .ValidateArgumentBuffer(4, rotated_masking_key, sizeof(rotated_masking_key));
+    STRICT_EXPECTED_CALL(singlylinkedlist_add(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(xio_send(TEST_IO_HANDLE, IGNORED_ARG, 6 + 5, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+}
+
+/* Tests_SRS_UWS_CLIENT_04_003: [ uws_client_send_frame_array_async shall obtain the number of buffers and the payload size by calling constbuffer_array_get_buffer_count and constbuffer_array_get_all_buffers_size. ]*/
+/* Tests_SRS_UWS_CLIENT_04_004: [ uws_client_send_frame_array_async shall allocate a frame of uws_frame_encoder_get_header_size bytes for a masked payload of that size plus the payload size. ]*/
+/* Tests_SRS_UWS_CLIENT_04_005: [ The frame header shall be written by calling uws_frame_encoder_encode_header with the payload size, is_final and is_masked set to true. ]*/
+/* Tests_SRS_UWS_CLIENT_04_006: [ Each buffer shall be masked into the frame by calling uws_frame_encoder_mask, with the masking key rotated by the position of the buffer in the payload. ]*/
+/* Tests_SRS_UWS_CLIENT_04_007: [ uws_client_send_frame_array_async shall queue the send like uws_client_send_frame_async does. ]*/
+/* Tests_SRS_UWS_CLIENT_04_008: [ The frame shall be sent by calling xio_send with on_underlying_io_send_complete as callback. ]*/
+/* Tests_SRS_UWS_CLIENT_04_011: [ On success, uws_client_send_frame_array_async shall return 0. ]*/
+/* Tests_SRS_UWS_CLIENT_04_012: [ The frame shall be freed once it was handed to xio_send. ]*/
+TEST_FUNCTION(uws_client_send_frame_array_async_succeeds)
+{
+    // arrange
+    UWS_CLIENT_HANDLE uws_client;
+    const char test_upgrade_response[] = "HTTP/1.1 101 Switching Protocols\r\n\r\n";
+    CONSTBUFFER_ARRAY_HANDLE buffers = create_test_array_payload();
+    int result;
+
+    uws_client = uws_client_create("test_host", 444, "/aaa", true, protocols, sizeof(protocols) / sizeof(protocols[0]));
+    (void)uws_client_open_async(uws_client, test_on_ws_open_complete, (void*)0x4242, test_on_ws_frame_received, (void*)0x4243, test_on_ws_peer_closed, (void*)0x4301, test_on_ws_error, (void*)0x4244);
+    g_on_io_open_complete(g_on_io_open_complete_context, IO_OPEN_OK);
+    g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response));
+    umock_c_reset_all_calls();
+
+    setup_uws_client_send_frame_array_async_expectations(buffers);
+
+    // act
+    result = uws_client_send_frame_array_async(uws_client, WS_FRAME_TYPE_BINARY, buffers, true, test_on_ws_send_frame_complete, (void*)0x4248);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    uws_client_destroy(uws_client);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/* Tests_SRS_UWS_CLIENT_04_009: [ If xio_send fails, uws_client_send_frame_array_async shall de-queue the send if it is still queued and return a non-zero value. ]*/
+TEST_FUNCTION(when_xio_send_fails_uws_client_send_frame_array_async_fails)
+{
+    // arrange
+    UWS_CLIENT_HANDLE uws_client;
+    const char test_upgrade_response[] = "HTTP/1.1 101 Switching Protocols\r\n\r\n";
+    CONSTBUFFER_ARRAY_HANDLE buffers = create_test_array_payload();
+    int result;
+
+    uws_client = uws_client_create("test_host", 444, "/aaa", true, protocols, sizeof(protocols) / sizeof(protocols[0]));
+    (void)uws_client_open_async(uws_client, test_on_ws_open_complete, (void*)0x4242, test_on_ws_frame_received, (void*)0x4243, test_on_ws_peer_closed, (void*)0x4301, test_on_ws_error, (void*)0x4244);
+    g_on_io_open_complete(g_on_io_open_complete_context, IO_OPEN_OK);
+    g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(uws_frame_encoder_get_header_size(5, true));
+    STRICT_EXPECTED_CALL(gballoc_malloc(6 + 5));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(uws_frame_encoder_encode_header(IGNORED_ARG, 6, WS_BINARY_FRAME, 5, true, true, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(uws_frame_encoder_mask(IGNORED_ARG, IGNORED_ARG, sizeof(test_array_payload_1), IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(uws_frame_encoder_mask(IGNORED_ARG, IGNORED_ARG, sizeof(test_array_payload_2), IGNORED_ARG));
+    STRICT_EXPECTED_CALL(singlylinkedlist_add(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(xio_send(TEST_IO_HANDLE, IGNORED_ARG, 6 + 5, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(singlylinkedlist_find(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn((LIST_ITEM_HANDLE)0x1234);
+    STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+
+    // act
+    result = uws_client_send_frame_array_async(uws_client, WS_FRAME_TYPE_BINARY, buffers, true, test_on_ws_send_frame_complete, (void*)0x4248);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    uws_client_destroy(uws_client);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/* Tests_SRS_UWS_CLIENT_04_010: [ If any other error occurs, uws_client_send_frame_array_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_allocating_the_frame_fails_uws_client_send_frame_array_async_fails)
+{
+    // arrange
+    UWS_CLIENT_HANDLE uws_client;
+    const char test_upgrade_response[] = "HTTP/1.1 101 Switching Protocols\r\n\r\n";
+    CONSTBUFFER_ARRAY_HANDLE buffers = create_test_array_payload();
+    int result;
+
+    uws_client = uws_client_create("test_host", 444, "/aaa", true, protocols, sizeof(protocols) / sizeof(protocols[0]));
+    (void)uws_client_open_async(uws_client, test_on_ws_open_complete, (void*)0x4242, test_on_ws_frame_received, (void*)0x4243, test_on_ws_peer_closed, (void*)0x4301, test_on_ws_error, (void*)0x4244);
+    g_on_io_open_complete(g_on_io_open_complete_context, IO_OPEN_OK);
+    g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(uws_frame_encoder_get_header_size(5, true));
+    STRICT_EXPECTED_CALL(gballoc_malloc(6 + 5))
+        .SetReturn(NULL);
+
+    // act
+    result = uws_client_send_frame_array_async(uws_client, WS_FRAME_TYPE_BINARY, buffers, true, test_on_ws_send_frame_complete, (void*)0x4248);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    uws_client_destroy(uws_client);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
 /* uws_client_dowork */
 
 /* Tests_SRS_UWS_CLIENT_01_059: [ If the uws_client argument is NULL, uws_client_dowork shall do nothing. ]*/
@@ -6767,7 +7154,6 @@ TEST_FUNCTION(when_a_PING_frame_was_received_a_PONG_frame_is_sent)
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_PONG_FRAME, IGNORED_ARG, 0, true, true, 0))
         .IgnoreArgument_payload()
         .CaptureReturn(&buffer_handle);
@@ -6818,7 +7204,6 @@ TEST_FUNCTION(when_a_PING_frame_was_received_with_some_payload_a_PONG_frame_is_s
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_PONG_FRAME, pong_frame_payload, sizeof(pong_frame_payload), true, true, 0))
         .ValidateArgumentBuffer(2, pong_frame_payload, sizeof(pong_frame_payload))
         .CaptureReturn(&buffer_handle);
@@ -6864,7 +7249,6 @@ TEST_FUNCTION(when_a_PING_frame_is_received_after_a_close_frame_no_pong_is_sent)
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_CLOSE_FRAME, NULL, 0, true, true, 0))
         .CaptureReturn(&buffer_handle);
     STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_ARG))
@@ -7395,7 +7779,6 @@ TEST_FUNCTION(underlying_io_close_after_a_send_close_frame_failed_puts_the_uws_i
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_CLOSE_FRAME, NULL, 0, true, true, 0))
         .SetReturn(NULL);
     STRICT_EXPECTED_CALL(xio_close(TEST_IO_HANDLE, IGNORED_ARG, IGNORED_ARG))
@@ -7447,7 +7830,6 @@ TEST_FUNCTION(underlying_io_close_due_to_CLOSE_frame_being_received_doe_not_trig
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_CLOSE_FRAME, NULL, 0, true, true, 0))
         .SetReturn(NULL);
     STRICT_EXPECTED_CALL(xio_close(TEST_IO_HANDLE, IGNORED_ARG, IGNORED_ARG))
@@ -7490,7 +7872,6 @@ TEST_FUNCTION(underlying_io_close_complete_with_NULL_context_does_nothing)
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response) - 1);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_realloc(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_CLOSE_FRAME, NULL, 0, true, true, 0))
         .SetReturn(NULL);
     STRICT_EXPECTED_CALL(xio_close(TEST_IO_HANDLE, IGNORED_ARG, IGNORED_ARG))
@@ -0,0 +1,194 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "testrunnerswitcher.h"
+
+#include "azure_c_shared_utility/uws_frame_encoder.h"
+#include "azure_c_shared_utility/buffer_.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#include "perf_measure.h"
+
+#undef malloc
+#undef free
+
+/*bytes masked or encoded per size, the iterations are derived from it*/
+#define UWS_FRAME_ENCODER_PERF_TOTAL_BYTES (256 * 1024 * 1024)
+#define UWS_FRAME_ENCODER_PERF_MAX_PAYLOAD (1024 * 1024)
+/*the largest header: 2 bytes, 8 bytes of length and the masking key*/
+#define UWS_FRAME_ENCODER_PERF_MAX_HEADER 14
+
+static const size_t PAYLOAD_SIZES[] = { 1024, 16 * 1024, 64 * 1024, 1024 * 1024 };
+static const unsigned char MASKING_KEY[4] = { 0x12, 0x34, 0x56, 0x78 };
+
+typedef struct ENCODE_CONTEXT_TAG
+{
+    const unsigned char* payload;
+    size_t length;
+    unsigned char* destination;
+    size_t destination_size;
+} ENCODE_CONTEXT;
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static unsigned char* g_payload;
+static unsigned char* g_destination;
+
+/*what uws_frame_encoder_encode used to do with the payload, one byte at a time*/
+static void mask_byte_by_byte(void* context, size_t iteration)
+{
+    ENCODE_CONTEXT* encode_context = (ENCODE_CONTEXT*)context;
+    size_t i;
+    (void)iteration;
+
+    for (i = 0; i < encode_context->length; i++)
+    {
+        encode_context->destination[i] = encode_context->payload[i] ^ MASKING_KEY[i % 4];
+    }
+}
+
+static void mask(void* context, size_t iteration)
+{
+    ENCODE_CONTEXT* encode_context = (ENCODE_CONTEXT*)context;
+    (void)iteration;
+    uws_frame_encoder_mask(encode_context->destination, encode_context->payload, encode_context->length, MASKING_KEY);
+}
+
+static void encode(void* context, size_t iteration)
+{
+    ENCODE_CONTEXT* encode_context = (ENCODE_CONTEXT*)context;
+    BUFFER_HANDLE frame = uws_frame_encoder_encode(WS_BINARY_FRAME, encode_context->payload, encode_context->length, true, true, 0);
+    (void)iteration;
+    ASSERT_IS_NOT_NULL(frame);
+    BUFFER_delete(frame);
+}
+
+static void encode_into(void* context, size_t iteration)
+{
+    ENCODE_CONTEXT* encode_context = (ENCODE_CONTEXT*)context;
+    (void)iteration;
+    ASSERT_ARE_EQUAL(int, 0, uws_frame_encoder_encode_into(encode_context->destination, encode_context->destination_size, WS_BINARY_FRAME, encode_context->payload, encode_context->length, true, true, 0));
+}
+
+/*runs operation for each payload size and returns the allocations per operation of the largest one*/
+static double run_sizes(const char* name, PERF_MEASURE_OPERATION operation)
+{
+    double allocations_per_op = 0.0;
+    size_t i;
+
+    for (i = 0; i < sizeof(PAYLOAD_SIZES) / sizeof(PAYLOAD_SIZES[0]); i++)
+    {
+        ENCODE_CONTEXT encode_context;
+        PERF_MEASURE_RESULT result;
+        char measure_name[128];
+
+        encode_context.payload = g_payload;
+        encode_context.length = PAYLOAD_SIZES[i];
+        encode_context.destination = g_destination;
+        encode_context.destination_size = UWS_FRAME_ENCODER_PERF_MAX_PAYLOAD + UWS_FRAME_ENCODER_PERF_MAX_HEADER;
+
+        (void)sprintf(measure_name, "%s %u bytes", name, (unsigned int)PAYLOAD_SIZES[i]);
+        result = perf_measure_run(measure_name, operation, &encode_context, UWS_FRAME_ENCODER_PERF_TOTAL_BYTES / PAYLOAD_SIZES[i]);
+        LogInfo("%s: %.1f MB/s", measure_name, (double)PAYLOAD_SIZES[i] * 1000.0 / result.ns_per_op);
+        allocations_per_op = result.allocations_per_op;
+    }
+
+    return allocations_per_op;
+}
+
+BEGIN_TEST_SUITE(uws_frame_encoder_perf)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    size_t i;
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    g_payload = (unsigned char*)malloc(UWS_FRAME_ENCODER_PERF_MAX_PAYLOAD);
+    ASSERT_IS_NOT_NULL(g_payload);
+    g_destination = (unsigned char*)malloc(UWS_FRAME_ENCODER_PERF_MAX_PAYLOAD + UWS_FRAME_ENCODER_PERF_MAX_HEADER);
+    ASSERT_IS_NOT_NULL(g_destination);
+
+    for (i = 0; i < UWS_FRAME_ENCODER_PERF_MAX_PAYLOAD; i++)
+    {
+        g_payload[i] = (unsigned char)(i * 31);
+    }
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    free(g_destination);
+    free(g_payload);
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+TEST_FUNCTION(mask_byte_by_byte_perf)
+{
+    ///act
+    (void)run_sizes("mask byte by byte", mask_byte_by_byte);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, (int)(g_payload[5] ^ MASKING_KEY[1]), (int)g_destination[5]);
+}
+
+TEST_FUNCTION(uws_frame_encoder_mask_perf)
+{
+    ///arrange
+    unsigned char* expected = (unsigned char*)malloc(UWS_FRAME_ENCODER_PERF_MAX_PAYLOAD);
+    ENCODE_CONTEXT encode_context;
+    ASSERT_IS_NOT_NULL(expected);
+    encode_context.payload = g_payload;
+    encode_context.length = UWS_FRAME_ENCODER_PERF_MAX_PAYLOAD;
+    encode_context.destination = expected;
+    mask_byte_by_byte(&encode_context, 0);
+
+    ///act
+    (void)run_sizes("uws_frame_encoder_mask", mask);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, memcmp(expected, g_destination, UWS_FRAME_ENCODER_PERF_MAX_PAYLOAD));
+
+    ///cleanup
+    free(expected);
+}
+
+TEST_FUNCTION(uws_frame_encoder_encode_perf)
+{
+    ///act
+    double allocations_per_op = run_sizes("uws_frame_encoder_encode", encode);
+
+    ///assert
+    ASSERT_IS_TRUE(allocations_per_op != 0.0);
+}
+
+TEST_FUNCTION(uws_frame_encoder_encode_into_perf)
+{
+    ///act
+    double allocations_per_op = run_sizes("uws_frame_encoder_encode_into", encode_into);
+
+    ///assert
+    ASSERT_IS_TRUE(allocations_per_op == 0.0);
+    /*the payload follows the 14 byte header of a masked 1MB frame, masked with the key in the header*/
+    ASSERT_ARE_EQUAL(int, 127, (int)(g_destination[1] & 0x7F));
+    ASSERT_ARE_EQUAL(int, (int)(g_payload[6] ^ g_destination[10 + (6 % 4)]), (int)g_destination[UWS_FRAME_ENCODER_PERF_MAX_HEADER + 6]);
+}
+
+END_TEST_SUITE(uws_frame_encoder_perf)
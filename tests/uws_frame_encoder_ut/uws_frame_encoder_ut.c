@@ -1416,4 +1416,321 @@ TEST_FUNCTION(uws_frame_encoder_encode_masks_a_8_byte_frame_with_different_mask_
     real_BUFFER_delete(result);
 }
 
+/* uws_frame_encoder_get_header_size */
+
+/* Tests_SRS_UWS_FRAME_ENCODER_01_055: [ uws_frame_encoder_get_header_size shall return the number of bytes of the header of a frame with length bytes of payload: 2 bytes, plus 2 if length is between 126 and 65535, plus 8 if length is greater than 65535, plus 4 if is_masked is true. ]*/
+TEST_FUNCTION(uws_frame_encoder_get_header_size_returns_the_header_size_for_each_length_encoding)
+{
+    // arrange
+
+    // act
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 2, uws_frame_encoder_get_header_size(0, false));
+    ASSERT_ARE_EQUAL(size_t, 2, uws_frame_encoder_get_header_size(125, false));
+    ASSERT_ARE_EQUAL(size_t, 4, uws_frame_encoder_get_header_size(126, false));
+    ASSERT_ARE_EQUAL(size_t, 4, uws_frame_encoder_get_header_size(65535, false));
+    ASSERT_ARE_EQUAL(size_t, 10, uws_frame_encoder_get_header_size(65536, false));
+    ASSERT_ARE_EQUAL(size_t, 6, uws_frame_encoder_get_header_size(0, true));
+    ASSERT_ARE_EQUAL(size_t, 8, uws_frame_encoder_get_header_size(126, true));
+    ASSERT_ARE_EQUAL(size_t, 14, uws_frame_encoder_get_header_size(65536, true));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* uws_frame_encoder_encode_header */
+
+/* Tests_SRS_UWS_FRAME_ENCODER_01_056: [ uws_frame_encoder_encode_header shall write in header the header of a frame with length bytes of payload, encoded like uws_frame_encoder_encode does, and return 0. ]*/
+TEST_FUNCTION(uws_frame_encoder_encode_header_encodes_the_header_of_a_masked_126_byte_frame)
+{
+    // arrange
+    unsigned char header[8];
+    unsigned char expected_bytes[] = { 0x82, 0xFE, 0x00, 0x7E, 0x01, 0x02, 0x03, 0x04 };
+    int result;
+
+    STRICT_EXPECTED_CALL(RANDOM_generate())
+        .SetReturn(0x01);
+    STRICT_EXPECTED_CALL(RANDOM_generate())
+        .SetReturn(0x02);
+    STRICT_EXPECTED_CALL(RANDOM_generate())
+        .SetReturn(0x03);
+    STRICT_EXPECTED_CALL(RANDOM_generate())
+        .SetReturn(0x04);
+
+    // act
+    result = uws_frame_encoder_encode_header(header, sizeof(header), WS_BINARY_FRAME, 126, true, true, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    stringify_bytes(expected_bytes, sizeof(expected_bytes), expected_encoded_str, sizeof(expected_encoded_str));
+    stringify_bytes(header, sizeof(header), actual_encoded_str, sizeof(actual_encoded_str));
+    ASSERT_ARE_EQUAL(char_ptr, expected_encoded_str, actual_encoded_str);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_UWS_FRAME_ENCODER_01_057: [ If header is NULL, uws_frame_encoder_encode_header shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(uws_frame_encoder_encode_header_with_NULL_header_fails)
+{
+    // arrange
+    int result;
+
+    // act
+    result = uws_frame_encoder_encode_header(NULL, 2, WS_BINARY_FRAME, 0, false, true, 0);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_UWS_FRAME_ENCODER_01_058: [ If header_size is smaller than the size returned by uws_frame_encoder_get_header_size for length and is_masked, uws_frame_encoder_encode_header shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(uws_frame_encoder_encode_header_with_a_header_too_small_for_the_masking_key_fails)
+{
+    // arrange
+    unsigned char header[7];
+    int result;
+
+    // act
+    result = uws_frame_encoder_encode_header(header, sizeof(header), WS_BINARY_FRAME, 126, true, true, 0);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_UWS_FRAME_ENCODER_01_059: [ If reserved has any bits set except the lowest 3 or opcode is greater than 0x0F, uws_frame_encoder_encode_header shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(uws_frame_encoder_encode_header_with_bad_reserved_bits_fails)
+{
+    // arrange
+    unsigned char header[2];
+    int result;
+
+    // act
+    result = uws_frame_encoder_encode_header(header, sizeof(header), WS_BINARY_FRAME, 0, false, true, 8);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_UWS_FRAME_ENCODER_01_059: [ If reserved has any bits set except the lowest 3 or opcode is greater than 0x0F, uws_frame_encoder_encode_header shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(uws_frame_encoder_encode_header_with_bad_opcode_fails)
+{
+    // arrange
+    unsigned char header[2];
+    int result;
+
+    // act
+    result = uws_frame_encoder_encode_header(header, sizeof(header), (WS_FRAME_TYPE)0x10, 0, false, true, 0);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* uws_frame_encoder_encode_into */
+
+/* Tests_SRS_UWS_FRAME_ENCODER_01_060: [ uws_frame_encoder_encode_into shall write in destination the frame that uws_frame_encoder_encode would return for the same arguments and return 0. ]*/
+TEST_FUNCTION(uws_frame_encoder_encode_into_encodes_a_masked_5_byte_frame)
+{
+    // arrange
+    unsigned char destination[11];
+    unsigned char payload[] = { 0x42, 0x43, 0x44, 0x45, 0x01 };
+    unsigned char expected_bytes[] = { 0x82, 0x85, 0xFF, 0xFF, 0xFF, 0xFF, 0xBD, 0xBC, 0xBB, 0xBA, 0xFE };
+    int result;
+
+    STRICT_EXPECTED_CALL(RANDOM_generate())
+        .SetReturn(0xFF);
+    STRICT_EXPECTED_CALL(RANDOM_generate())
+        .SetReturn(0xFF);
+    STRICT_EXPECTED_CALL(RANDOM_generate())
+        .SetReturn(0xFF);
+    STRICT_EXPECTED_CALL(RANDOM_generate())
+        .SetReturn(0xFF);
+
+    // act
+    result = uws_frame_encoder_encode_into(destination, sizeof(destination), WS_BINARY_FRAME, payload, sizeof(payload), true, true, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    stringify_bytes(expected_bytes, sizeof(expected_bytes), expected_encoded_str, sizeof(expected_encoded_str));
+    stringify_bytes(destination, sizeof(destination), actual_encoded_str, sizeof(actual_encoded_str));
+    ASSERT_ARE_EQUAL(char_ptr, expected_encoded_str, actual_encoded_str);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_UWS_FRAME_ENCODER_01_060: [ uws_frame_encoder_encode_into shall write in destination the frame that uws_frame_encoder_encode would return for the same arguments and return 0. ]*/
+TEST_FUNCTION(uws_frame_encoder_encode_into_encodes_an_unmasked_126_byte_frame)
+{
+    // arrange
+    unsigned char destination[130];
+    unsigned char payload[126];
+    int result;
+    size_t i;
+
+    for (i = 0; i < sizeof(payload); i++)
+    {
+        payload[i] = (unsigned char)i;
+    }
+
+    // act
+    result = uws_frame_encoder_encode_into(destination, sizeof(destination), WS_TEXT_FRAME, payload, sizeof(payload), false, false, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0x01, (int)destination[0]);
+    ASSERT_ARE_EQUAL(int, 126, (int)destination[1]);
+    ASSERT_ARE_EQUAL(int, 0x00, (int)destination[2]);
+    ASSERT_ARE_EQUAL(int, 0x7E, (int)destination[3]);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(destination + 4, payload, sizeof(payload)));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_UWS_FRAME_ENCODER_01_061: [ If destination is NULL, uws_frame_encoder_encode_into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(uws_frame_encoder_encode_into_with_NULL_destination_fails)
+{
+    // arrange
+    unsigned char payload[] = { 0x42 };
+    int result;
+
+    // act
+    result = uws_frame_encoder_encode_into(NULL, 7, WS_BINARY_FRAME, payload, sizeof(payload), true, true, 0);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_UWS_FRAME_ENCODER_01_062: [ If length is greater than 0 and payload is NULL, then uws_frame_encoder_encode_into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(uws_frame_encoder_encode_into_with_1_length_and_NULL_payload_fails)
+{
+    // arrange
+    unsigned char destination[7];
+    int result;
+
+    // act
+    result = uws_frame_encoder_encode_into(destination, sizeof(destination), WS_BINARY_FRAME, NULL, 1, true, true, 0);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_UWS_FRAME_ENCODER_01_063: [ If destination_size is smaller than the header size returned by uws_frame_encoder_get_header_size plus length, uws_frame_encoder_encode_into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(uws_frame_encoder_encode_into_with_a_destination_1_byte_too_small_fails)
+{
+    // arrange
+    unsigned char destination[6];
+    unsigned char payload[] = { 0x42 };
+    int result;
+
+    // act
+    result = uws_frame_encoder_encode_into(destination, sizeof(destination), WS_BINARY_FRAME, payload, sizeof(payload), true, true, 0);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_UWS_FRAME_ENCODER_01_064: [ If reserved has any bits set except the lowest 3 or opcode is greater than 0x0F, uws_frame_encoder_encode_into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(uws_frame_encoder_encode_into_with_bad_reserved_bits_fails)
+{
+    // arrange
+    unsigned char destination[2];
+    int result;
+
+    // act
+    result = uws_frame_encoder_encode_into(destination, sizeof(destination), WS_BINARY_FRAME, NULL, 0, false, true, 8);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_UWS_FRAME_ENCODER_01_064: [ If reserved has any bits set except the lowest 3 or opcode is greater than 0x0F, uws_frame_encoder_encode_into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(uws_frame_encoder_encode_into_with_bad_opcode_fails)
+{
+    // arrange
+    unsigned char destination[2];
+    int result;
+
+    // act
+    result = uws_frame_encoder_encode_into(destination, sizeof(destination), (WS_FRAME_TYPE)0x10, NULL, 0, false, true, 0);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* uws_frame_encoder_mask */
+
+/* Tests_SRS_UWS_FRAME_ENCODER_01_065: [ uws_frame_encoder_mask shall write in destination each byte i of source XORed with byte i modulo 4 of masking_key. ]*/
+TEST_FUNCTION(uws_frame_encoder_mask_masks_every_length_up_to_300_bytes)
+{
+    // arrange
+    unsigned char masking_key[4] = { 0x12, 0x34, 0x56, 0x78 };
+    unsigned char source[301];
+    unsigned char destination[301];
+    size_t length;
+    size_t i;
+
+    for (i = 0; i < sizeof(source); i++)
+    {
+        source[i] = (unsigned char)(i * 7);
+    }
+
+    for (length = 0; length < sizeof(source); length++)
+    {
+        (void)memset(destination, 0xAA, sizeof(destination));
+
+        // act
+        uws_frame_encoder_mask(destination, source + 1, length, masking_key);
+
+        // assert
+        for (i = 0; i < length; i++)
+        {
+            ASSERT_ARE_EQUAL(int, (int)(source[i + 1] ^ masking_key[i % 4]), (int)destination[i]);
+        }
+        ASSERT_ARE_EQUAL(int, 0xAA, (int)destination[length]);
+    }
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_UWS_FRAME_ENCODER_01_065: [ uws_frame_encoder_mask shall write in destination each byte i of source XORed with byte i modulo 4 of masking_key. ]*/
+TEST_FUNCTION(uws_frame_encoder_mask_twice_in_place_gives_back_the_original_bytes)
+{
+    // arrange
+    unsigned char masking_key[4] = { 0x00, 0xFF, 0xAA, 0x42 };
+    unsigned char original[100];
+    unsigned char bytes[100];
+    size_t i;
+
+    for (i = 0; i < sizeof(original); i++)
+    {
+        original[i] = (unsigned char)(255 - i);
+    }
+    (void)memcpy(bytes, original, sizeof(bytes));
+
+    // act
+    uws_frame_encoder_mask(bytes, bytes, sizeof(bytes), masking_key);
+    uws_frame_encoder_mask(bytes, bytes, sizeof(bytes), masking_key);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, memcmp(original, bytes, sizeof(bytes)));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_UWS_FRAME_ENCODER_01_066: [ If length is greater than 0 and any of destination, source or masking_key is NULL, uws_frame_encoder_mask shall return without writing anything. ]*/
+TEST_FUNCTION(uws_frame_encoder_mask_with_NULL_masking_key_does_not_write_anything)
+{
+    // arrange
+    unsigned char source[] = { 0x01, 0x02 };
+    unsigned char destination[] = { 0xAA, 0xAA };
+
+    // act
+    uws_frame_encoder_mask(destination, source, sizeof(source), NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0xAA, (int)destination[0]);
+    ASSERT_ARE_EQUAL(int, 0xAA, (int)destination[1]);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(uws_frame_encoder_ut)
@@ -40,6 +40,7 @@ static const OPTIONHANDLER_HANDLE TEST_OPTIONHANDLER_HANDLE = (OPTIONHANDLER_HAN
 static const OPTIONHANDLER_HANDLE TEST_UWS_CLIENT_OPTIONHANDLER_HANDLE = (OPTIONHANDLER_HANDLE)0x4247;
 static void* TEST_UNDERLYING_IO_PARAMETERS = (void*)0x4248;
 static const IO_INTERFACE_DESCRIPTION* TEST_UNDERLYING_IO_INTERFACE = (const IO_INTERFACE_DESCRIPTION*)0x4249;
+static const CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = (CONSTBUFFER_ARRAY_HANDLE)0x4250;
 
 IMPLEMENT_UMOCK_C_ENUM_TYPE(IO_OPEN_RESULT, IO_OPEN_RESULT_VALUES);
 IMPLEMENT_UMOCK_C_ENUM_TYPE(WS_OPEN_RESULT, WS_OPEN_RESULT_VALUES);
@@ -325,6 +326,7 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(ON_WS_SEND_FRAME_COMPLETE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(OPTIONHANDLER_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_WS_PEER_CLOSED, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_ARRAY_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(pfCloneOption, void*);
     REGISTER_UMOCK_ALIAS_TYPE(pfSetOption, void*);
     REGISTER_UMOCK_ALIAS_TYPE(pfDestroyOption, void*);
@@ -1275,6 +1277,179 @@ TEST_FUNCTION(wsio_send_with_NULL_send_complete_callback_succeeds)
     wsio_get_interface_description()->concrete_io_destroy(wsio);
 }
 
+/* wsio_send_array */
+
+/* Tests_SRS_WSIO_04_004: [ wsio_send_array shall queue an entry containing the on_send_complete callback and its context by calling singlylinkedlist_add. ]*/
+/* Tests_SRS_WSIO_04_006: [ wsio_send_array shall call uws_client_send_frame_array_async, passing buffers, the frame type WS_FRAME_TYPE_BINARY and is_final set to true. ]*/
+/* Tests_SRS_WSIO_04_008: [ On success, wsio_send_array shall return 0. ]*/
+TEST_FUNCTION(wsio_send_array_calls_uws_send_frame_array)
+{
+    // arrange
+    CONCRETE_IO_HANDLE wsio;
+    int result;
+
+    wsio = wsio_get_interface_description()->concrete_io_create(&default_wsio_config);
+    (void)wsio_get_interface_description()->concrete_io_open(wsio, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    g_on_ws_open_complete(g_on_ws_open_complete_context, WS_OPEN_OK);
+    umock_c_reset_all_calls();
+
+    EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(singlylinkedlist_add(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(uws_client_send_frame_array_async(TEST_UWS_HANDLE, WS_FRAME_TYPE_BINARY, TEST_CONSTBUFFER_ARRAY_HANDLE, true, IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    result = wsio_get_interface_description()->concrete_io_send_array(wsio, TEST_CONSTBUFFER_ARRAY_HANDLE, test_on_send_complete, (void*)0x4343);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    wsio_get_interface_description()->concrete_io_destroy(wsio);
+}
+
+/* Tests_SRS_WSIO_04_001: [ If any of the arguments ws_io or buffers are NULL, wsio_send_array shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(wsio_send_array_with_NULL_wsio_fails)
+{
+    // arrange
+    int result;
+
+    // act
+    result = wsio_get_interface_description()->concrete_io_send_array(NULL, TEST_CONSTBUFFER_ARRAY_HANDLE, test_on_send_complete, (void*)0x4343);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WSIO_04_001: [ If any of the arguments ws_io or buffers are NULL, wsio_send_array shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(wsio_send_array_with_NULL_buffers_fails)
+{
+    // arrange
+    CONCRETE_IO_HANDLE wsio;
+    int result;
+
+    wsio = wsio_get_interface_description()->concrete_io_create(&default_wsio_config);
+    (void)wsio_get_interface_description()->concrete_io_open(wsio, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    g_on_ws_open_complete(g_on_ws_open_complete_context, WS_OPEN_OK);
+    umock_c_reset_all_calls();
+
+    // act
+    result = wsio_get_interface_description()->concrete_io_send_array(wsio, NULL, test_on_send_complete, (void*)0x4343);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    wsio_get_interface_description()->concrete_io_destroy(wsio);
+}
+
+/* Tests_SRS_WSIO_04_002: [ If the wsio is not OPEN then wsio_send_array shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(wsio_send_array_when_not_open_fails)
+{
+    // arrange
+    CONCRETE_IO_HANDLE wsio;
+    int result;
+
+    wsio = wsio_get_interface_description()->concrete_io_create(&default_wsio_config);
+    umock_c_reset_all_calls();
+
+    // act
+    result = wsio_get_interface_description()->concrete_io_send_array(wsio, TEST_CONSTBUFFER_ARRAY_HANDLE, test_on_send_complete, (void*)0x4343);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    wsio_get_interface_description()->concrete_io_destroy(wsio);
+}
+
+/* Tests_SRS_WSIO_04_003: [ If allocating memory for the pending IO data fails, wsio_send_array shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_allocating_memory_for_the_pending_send_fails_wsio_send_array_fails)
+{
+    // arrange
+    CONCRETE_IO_HANDLE wsio;
+    int result;
+
+    wsio = wsio_get_interface_description()->concrete_io_create(&default_wsio_config);
+    (void)wsio_get_interface_description()->concrete_io_open(wsio, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    g_on_ws_open_complete(g_on_ws_open_complete_context, WS_OPEN_OK);
+    umock_c_reset_all_calls();
+
+    EXPECTED_CALL(gballoc_malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    // act
+    result = wsio_get_interface_description()->concrete_io_send_array(wsio, TEST_CONSTBUFFER_ARRAY_HANDLE, test_on_send_complete, (void*)0x4343);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    wsio_get_interface_description()->concrete_io_destroy(wsio);
+}
+
+/* Tests_SRS_WSIO_04_005: [ If singlylinkedlist_add fails, wsio_send_array shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_adding_the_pending_item_to_the_list_fails_wsio_send_array_fails)
+{
+    // arrange
+    CONCRETE_IO_HANDLE wsio;
+    int result;
+
+    wsio = wsio_get_interface_description()->concrete_io_create(&default_wsio_config);
+    (void)wsio_get_interface_description()->concrete_io_open(wsio, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    g_on_ws_open_complete(g_on_ws_open_complete_context, WS_OPEN_OK);
+    umock_c_reset_all_calls();
+
+    EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(singlylinkedlist_add(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_ARG))
+        .SetReturn(NULL);
+    EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+
+    // act
+    result = wsio_get_interface_description()->concrete_io_send_array(wsio, TEST_CONSTBUFFER_ARRAY_HANDLE, test_on_send_complete, (void*)0x4343);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    wsio_get_interface_description()->concrete_io_destroy(wsio);
+}
+
+/* Tests_SRS_WSIO_04_007: [ If uws_client_send_frame_array_async fails, wsio_send_array shall remove the queued entry and return a non-zero value. ]*/
+TEST_FUNCTION(when_uws_client_send_frame_array_async_fails_wsio_send_array_fails)
+{
+    // arrange
+    CONCRETE_IO_HANDLE wsio;
+    int result;
+
+    wsio = wsio_get_interface_description()->concrete_io_create(&default_wsio_config);
+    (void)wsio_get_interface_description()->concrete_io_open(wsio, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    g_on_ws_open_complete(g_on_ws_open_complete_context, WS_OPEN_OK);
+    umock_c_reset_all_calls();
+
+    EXPECTED_CALL(gballoc_malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(singlylinkedlist_add(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(uws_client_send_frame_array_async(TEST_UWS_HANDLE, WS_FRAME_TYPE_BINARY, TEST_CONSTBUFFER_ARRAY_HANDLE, true, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_ARG));
+
+    // act
+    result = wsio_get_interface_description()->concrete_io_send_array(wsio, TEST_CONSTBUFFER_ARRAY_HANDLE, test_on_send_complete, (void*)0x4343);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    wsio_get_interface_description()->concrete_io_destroy(wsio);
+}
+
 /* wsio_dowork */
 
 /* Tests_SRS_WSIO_01_106: [ wsio_dowork shall call uws_client_dowork with the uws handle created in wsio_create. ]*/
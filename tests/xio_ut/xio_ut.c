@@ -29,14 +29,20 @@ static void my_gballoc_free(void* ptr)
 
 #include "umock_c/umock_c.h"
 #include "umock_c/umocktypes_charptr.h"
+#include "umock_c/umocktypes_stdint.h"
 #include "umock_c/umock_c_negative_tests.h"
 
 #define ENABLE_MOCKS
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/optionhandler.h"
+#include "azure_c_shared_utility/constbuffer.h"
+#include "azure_c_shared_utility/constbuffer_array.h"
 #undef ENABLE_MOCKS
 
 #include "azure_c_shared_utility/xio.h"
+
+#include "../real_test_files/real_constbuffer.h"
+#include "../real_test_files/real_constbuffer_array.h"
 static CONCRETE_IO_HANDLE TEST_CONCRETE_IO_HANDLE = (CONCRETE_IO_HANDLE)0x4242;
 
 #define ENABLE_MOCKS
@@ -54,6 +60,8 @@ MOCK_FUNCTION_WITH_CODE(, void, test_xio_dowork, CONCRETE_IO_HANDLE, handle)
 MOCK_FUNCTION_END()
 MOCK_FUNCTION_WITH_CODE(, int, test_xio_setoption, CONCRETE_IO_HANDLE, handle, const char*, optionName, const void*, value)
 MOCK_FUNCTION_END(0)
+MOCK_FUNCTION_WITH_CODE(, int, test_xio_send_array, CONCRETE_IO_HANDLE, handle, CONSTBUFFER_ARRAY_HANDLE, buffers, ON_SEND_COMPLETE, on_send_complete, void*, callback_context)
+MOCK_FUNCTION_END(0)
 
 #include "umock_c/umock_c_prod.h"
 /*this function will clone an option given by name and value*/
@@ -114,6 +122,37 @@ const IO_INTERFACE_DESCRIPTION test_io_description =
     test_xio_setoption
 };
 
+const IO_INTERFACE_DESCRIPTION test_io_description_with_send_array =
+{
+    test_xio_retrieveoptions,
+    test_xio_create,
+    test_xio_destroy,
+    test_xio_open,
+    test_xio_close,
+    test_xio_send,
+    test_xio_dowork,
+    test_xio_setoption,
+    test_xio_send_array
+};
+
+static const unsigned char test_bytes_1[] = { 0x42, 0x43 };
+static const unsigned char test_bytes_2[] = { 0x44, 0x45, 0x46 };
+
+static CONSTBUFFER_ARRAY_HANDLE create_test_buffers(void)
+{
+    CONSTBUFFER_HANDLE buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE result;
+    buffers[0] = real_CONSTBUFFER_Create(test_bytes_1, sizeof(test_bytes_1));
+    ASSERT_IS_NOT_NULL(buffers[0]);
+    buffers[1] = real_CONSTBUFFER_Create(test_bytes_2, sizeof(test_bytes_2));
+    ASSERT_IS_NOT_NULL(buffers[1]);
+    result = real_constbuffer_array_create(buffers, 2);
+    ASSERT_IS_NOT_NULL(result);
+    real_CONSTBUFFER_DecRef(buffers[0]);
+    real_CONSTBUFFER_DecRef(buffers[1]);
+    return result;
+}
+
 static TEST_MUTEX_HANDLE g_testByTest;
 
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
@@ -160,6 +199,8 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     result = umocktypes_charptr_register_types();
     ASSERT_ARE_EQUAL(int, 0, result);
+    result = umocktypes_stdint_register_types();
+    ASSERT_ARE_EQUAL(int, 0, result);
 
     REGISTER_UMOCK_ALIAS_TYPE(CONCRETE_IO_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(XIO_HANDLE, void*);
@@ -168,6 +209,8 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(ON_IO_OPEN_COMPLETE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_BYTES_RECEIVED, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_IO_ERROR, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_ARRAY_HANDLE, void*);
 
     REGISTER_UMOCK_ALIAS_TYPE(pfCloneOption, void*);
     REGISTER_UMOCK_ALIAS_TYPE(pfDestroyOption, void*);
@@ -176,6 +219,8 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(gballoc_malloc, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(test_xio_send, MU_FAILURE);
 
     REGISTER_GLOBAL_MOCK_HOOK(OptionHandler_Create, my_OptionHandler_Create);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(OptionHandler_Create, (OPTIONHANDLER_HANDLE)NULL);
@@ -187,6 +232,11 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(OptionHandler_AddOption, OPTIONHANDLER_ERROR);
 
     REGISTER_GLOBAL_MOCK_HOOK(OptionHandler_Destroy, my_OptionHandler_Destroy);
+
+    REGISTER_CONSTBUFFER_GLOBAL_MOCK_HOOK();
+    REGISTER_CONSTBUFFER_ARRAY_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_get_buffer_count, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_get_all_buffers_size, MU_FAILURE);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -770,6 +820,209 @@ TEST_FUNCTION(xio_send_with_non_NULL_buffer_and_zero_length_passes_the_args_down
     xio_destroy(handle);
 }
 
+/* xio_send_array */
+
+/* Tests_SRS_XIO_04_001: [If xio or buffers is NULL, xio_send_array shall return a non-zero value.] */
+TEST_FUNCTION(xio_send_array_with_NULL_handle_fails)
+{
+    // arrange
+    int result;
+    CONSTBUFFER_ARRAY_HANDLE buffers = create_test_buffers();
+    umock_c_reset_all_calls();
+
+    // act
+    result = xio_send_array(NULL, buffers, test_on_send_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/* Tests_SRS_XIO_04_001: [If xio or buffers is NULL, xio_send_array shall return a non-zero value.] */
+TEST_FUNCTION(xio_send_array_with_NULL_buffers_fails)
+{
+    // arrange
+    int result;
+    XIO_HANDLE handle = xio_create(&test_io_description_with_send_array, NULL);
+    umock_c_reset_all_calls();
+
+    // act
+    result = xio_send_array(handle, NULL, test_on_send_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    xio_destroy(handle);
+}
+
+/* Tests_SRS_XIO_04_002: [If the concrete IO implementation has a concrete_io_send_array function, xio_send_array shall call it, passing down buffers, on_send_complete and callback_context.] */
+/* Tests_SRS_XIO_04_009: [On success, xio_send_array shall return 0.] */
+TEST_FUNCTION(xio_send_array_calls_the_underlying_concrete_xio_send_array_and_succeeds)
+{
+    // arrange
+    int result;
+    CONSTBUFFER_ARRAY_HANDLE buffers = create_test_buffers();
+    XIO_HANDLE handle = xio_create(&test_io_description_with_send_array, NULL);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_xio_send_array(TEST_CONCRETE_IO_HANDLE, buffers, test_on_send_complete, (void*)0x4242));
+
+    // act
+    result = xio_send_array(handle, buffers, test_on_send_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    xio_destroy(handle);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/* Tests_SRS_XIO_04_003: [If concrete_io_send_array or concrete_io_send fails, xio_send_array shall return a non-zero value.] */
+TEST_FUNCTION(when_the_concrete_xio_send_array_fails_then_xio_send_array_fails)
+{
+    // arrange
+    int result;
+    CONSTBUFFER_ARRAY_HANDLE buffers = create_test_buffers();
+    XIO_HANDLE handle = xio_create(&test_io_description_with_send_array, NULL);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_xio_send_array(TEST_CONCRETE_IO_HANDLE, buffers, test_on_send_complete, (void*)0x4242))
+        .SetReturn(42);
+
+    // act
+    result = xio_send_array(handle, buffers, test_on_send_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    xio_destroy(handle);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+static void setup_xio_send_array_copy_expectations(CONSTBUFFER_ARRAY_HANDLE buffers)
+{
+    static const unsigned char expected_bytes[] = { 0x42, 0x43, 0x44, 0x45, 0x46 };
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(expected_bytes)));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(test_xio_send(TEST_CONCRETE_IO_HANDLE, IGNORED_ARG, sizeof(expected_bytes), test_on_send_complete, (void*)0x4242))
+        .ValidateArgumentBuffer(2, expected_bytes, sizeof(expected_bytes));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_ARG))
+        .CallCannotFail();
+}
+
+/* Tests_SRS_XIO_01_004: [If any io_interface_description member is NULL, xio_create shall return NULL.] */
+/* Tests_SRS_XIO_04_004: [Otherwise xio_send_array shall get the number of buffers and their total size by calling constbuffer_array_get_buffer_count and constbuffer_array_get_all_buffers_size.] */
+/* Tests_SRS_XIO_04_005: [xio_send_array shall allocate all_buffers_size bytes and copy the content of the buffers one after the other in them.] */
+/* Tests_SRS_XIO_04_006: [xio_send_array shall send the copied bytes by calling concrete_io_send, passing down on_send_complete and callback_context.] */
+/* Tests_SRS_XIO_04_007: [xio_send_array shall free the copied bytes.] */
+/* Tests_SRS_XIO_04_009: [On success, xio_send_array shall return 0.] */
+TEST_FUNCTION(xio_send_array_without_concrete_xio_send_array_copies_the_buffers_and_calls_concrete_xio_send)
+{
+    // arrange
+    int result;
+    CONSTBUFFER_ARRAY_HANDLE buffers = create_test_buffers();
+    XIO_HANDLE handle = xio_create(&test_io_description, NULL);
+    ASSERT_IS_NOT_NULL(handle);
+    umock_c_reset_all_calls();
+
+    setup_xio_send_array_copy_expectations(buffers);
+
+    // act
+    result = xio_send_array(handle, buffers, test_on_send_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    xio_destroy(handle);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/* Tests_SRS_XIO_04_010: [If the total size of the buffers is 0, xio_send_array shall return a non-zero value.] */
+TEST_FUNCTION(xio_send_array_without_concrete_xio_send_array_with_0_bytes_fails)
+{
+    // arrange
+    int result;
+    CONSTBUFFER_ARRAY_HANDLE buffers = real_constbuffer_array_create_empty();
+    XIO_HANDLE handle = xio_create(&test_io_description, NULL);
+    ASSERT_IS_NOT_NULL(buffers);
+    ASSERT_IS_NOT_NULL(handle);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+
+    // act
+    result = xio_send_array(handle, buffers, test_on_send_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    xio_destroy(handle);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/* Tests_SRS_XIO_04_003: [If concrete_io_send_array or concrete_io_send fails, xio_send_array shall return a non-zero value.] */
+/* Tests_SRS_XIO_04_008: [If any other operation fails, xio_send_array shall return a non-zero value.] */
+TEST_FUNCTION(when_an_operation_fails_then_xio_send_array_without_concrete_xio_send_array_fails)
+{
+    // arrange
+    size_t i;
+    CONSTBUFFER_ARRAY_HANDLE buffers = create_test_buffers();
+    XIO_HANDLE handle;
+    int negativeTestsInitResult = umock_c_negative_tests_init();
+    ASSERT_ARE_EQUAL(int, 0, negativeTestsInitResult);
+
+    handle = xio_create(&test_io_description, NULL);
+    umock_c_reset_all_calls();
+
+    setup_xio_send_array_copy_expectations(buffers);
+
+    umock_c_negative_tests_snapshot();
+
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (!umock_c_negative_tests_can_call_fail(i)) continue;
+
+        char temp_str[128];
+        int result;
+
+        umock_c_negative_tests_reset();
+        umock_c_negative_tests_fail_call(i);
+
+        (void)sprintf(temp_str, "On failed call %lu", (unsigned long)i);
+
+        // act
+        result = xio_send_array(handle, buffers, test_on_send_complete, (void*)0x4242);
+
+        // assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result, temp_str);
+    }
+
+    // cleanup
+    xio_destroy(handle);
+    real_constbuffer_array_dec_ref(buffers);
+    umock_c_negative_tests_deinit();
+}
+
 /* xio_dowork */
 
 /* Tests_SRS_XIO_01_012: [xio_dowork shall call the concrete IO implementation specified in xio_create, by calling the concrete_xio_dowork function.] */